@@ -0,0 +1,70 @@
+# Scheduler latency benchmark for the hashing/bundle nifs.
+#
+# It keeps the normal schedulers busy with a sustained zmq-like load (batches of
+# random txs hashed through Nifs.hash_and_verify at a fixed rate), while a probe
+# process measures how late its 1ms timers fire.
+#
+# run it once per nif scheduling policy and compare the reported percentiles:
+#   NIF_SCHEDULING=normal mix run --no-start bench/scheduler_latency.exs
+#   NIF_SCHEDULING=dirty mix run --no-start bench/scheduler_latency.exs
+#   NIF_SCHEDULING=yield mix run --no-start bench/scheduler_latency.exs
+defmodule Broker.Bench.SchedulerLatency do
+
+  @duration 10_000 # ms
+  @batches_per_second 200 # each batch is 64 txs (~12800 tx/s)
+  @feeders System.schedulers_online()
+  @probe_interval 1 # ms
+
+  def run() do
+    scheduling = String.to_atom(System.get_env("NIF_SCHEDULING") || "dirty")
+    # the policy is read when the Nifs module is loaded (on first call)
+    Application.put_env(:broker, :__NIF_SCHEDULING__, scheduling)
+    {txs, hashes} = batch(64)
+    Nifs.hash_and_verify(txs, hashes)
+    # start the feeders
+    feeders =
+      for _ <- 1..@feeders do
+        spawn_link(fn -> feed(txs, hashes, div(@feeders * 1000, @batches_per_second)) end)
+      end
+    # start the probe and wait for its samples
+    parent = self()
+    spawn_link(fn -> send(parent, {:samples, probe(System.monotonic_time(:millisecond) + @duration, [])}) end)
+    samples = receive do {:samples, samples} -> samples end
+    Enum.each(feeders, &Process.exit(&1, :kill))
+    report(scheduling, samples)
+  end
+
+  # random 2673-tryte txs and 81-tryte hashes
+  defp batch(tx_count) do
+    alphabet = '9ABCDEFGHIJKLMNOPQRSTUVWXYZ'
+    trytes = fn(length) -> for _ <- 1..length, into: "", do: <<Enum.random(alphabet)>> end
+    {trytes.(2673 * tx_count), trytes.(81 * tx_count)}
+  end
+
+  defp feed(txs, hashes, interval) do
+    Nifs.hash_and_verify(txs, hashes)
+    Process.sleep(interval)
+    feed(txs, hashes, interval)
+  end
+
+  defp probe(deadline, samples) do
+    start = System.monotonic_time(:microsecond)
+    Process.sleep(@probe_interval)
+    late = System.monotonic_time(:microsecond) - start - @probe_interval * 1000
+    if System.monotonic_time(:millisecond) < deadline do
+      probe(deadline, [late | samples])
+    else
+      samples
+    end
+  end
+
+  defp report(scheduling, samples) do
+    sorted = Enum.sort(samples)
+    count = length(sorted)
+    percentile = fn(p) -> Enum.at(sorted, min(count - 1, div(count * p, 100))) end
+    IO.puts("nif scheduling: #{scheduling}, #{count} samples, timer lateness (us): " <>
+      "p50=#{percentile.(50)} p99=#{percentile.(99)} max=#{List.last(sorted)}")
+  end
+end
+
+Broker.Bench.SchedulerLatency.run()
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "cclient/response/get_node_metrics.h"
+
+static UT_icd ut_node_metric_icd = {sizeof(node_metric_t), NULL, NULL, NULL};
+
+static retcode_t get_node_metrics_res_add(get_node_metrics_res_t* const res, char const* const name,
+                                          node_metric_t* const metric) {
+  if (!res || !name) {
+    return RC_NULL_PARAM;
+  }
+
+  strncpy(metric->name, name, NODE_METRIC_NAME_SIZE - 1);
+  metric->name[NODE_METRIC_NAME_SIZE - 1] = '\0';
+  utarray_push_back(res, metric);
+  return RC_OK;
+}
+
+get_node_metrics_res_t* get_node_metrics_res_new() {
+  get_node_metrics_res_t* metrics = NULL;
+  utarray_new(metrics, &ut_node_metric_icd);
+  return metrics;
+}
+
+void get_node_metrics_res_free(get_node_metrics_res_t** res) {
+  if (!res || !(*res)) {
+    return;
+  }
+
+  utarray_free(*res);
+  *res = NULL;
+}
+
+node_metric_t* get_node_metrics_res_metric_at(get_node_metrics_res_t* const res, size_t const index) {
+  if (!res || index >= utarray_len(res)) {
+    return NULL;
+  }
+  return (node_metric_t*)utarray_eltptr(res, index);
+}
+
+retcode_t get_node_metrics_res_add_value(get_node_metrics_res_t* const res, char const* const name,
+                                         node_metric_type_t const type, double const value) {
+  node_metric_t metric = {.type = type, .value = value};
+
+  if (type == NODE_METRIC_HISTOGRAM) {
+    return RC_INVALID_PARAM;
+  }
+  return get_node_metrics_res_add(res, name, &metric);
+}
+
+retcode_t get_node_metrics_res_add_histogram(get_node_metrics_res_t* const res, char const* const name,
+                                             uint64_t const count, double const mean, uint64_t const p50,
+                                             uint64_t const p90, uint64_t const p99, uint64_t const max) {
+  node_metric_t metric = {
+      .type = NODE_METRIC_HISTOGRAM, .count = count, .mean = mean, .p50 = p50, .p90 = p90, .p99 = p99, .max = max};
+
+  return get_node_metrics_res_add(res, name, &metric);
+}
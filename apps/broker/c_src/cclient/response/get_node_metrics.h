@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup response
+ *
+ * @{
+ *
+ * @file
+ * @brief
+ *
+ */
+#ifndef CCLIENT_RESPONSE_GET_NODE_METRICS_H
+#define CCLIENT_RESPONSE_GET_NODE_METRICS_H
+
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "utarray.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NODE_METRIC_NAME_SIZE 64
+
+/**
+ * @brief The kinds of node metrics.
+ *
+ */
+typedef enum node_metric_type_e {
+  NODE_METRIC_COUNTER,   /*!< A monotonic count since the node started */
+  NODE_METRIC_GAUGE,     /*!< A current value */
+  NODE_METRIC_HISTOGRAM, /*!< A distribution of values, summarized by percentiles */
+} node_metric_type_t;
+
+/**
+ * @brief The data structure of a node metric.
+ *
+ */
+typedef struct node_metric_s {
+  /**
+   * Name of the metric, as `<stage>.<metric>`.
+   */
+  char name[NODE_METRIC_NAME_SIZE];
+  node_metric_type_t type;
+  /**
+   * Value of a counter or a gauge.
+   */
+  double value;
+  /**
+   * Number of values, mean, percentiles and maximum of a histogram.
+   */
+  uint64_t count;
+  double mean;
+  uint64_t p50;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t max;
+} node_metric_t;
+
+/**
+ * @brief The data structure of get node metrics response.
+ *
+ */
+typedef UT_array get_node_metrics_res_t;
+
+/**
+ * @brief Allocates a get node metrics response object.
+ *
+ * @return A pointer to the response object.
+ */
+get_node_metrics_res_t* get_node_metrics_res_new();
+
+/**
+ * @brief Frees a get node metrics response.
+ *
+ * @param[in] res The response object.
+ */
+void get_node_metrics_res_free(get_node_metrics_res_t** res);
+
+/**
+ * @brief Gets the number of metrics in the response.
+ *
+ * @param[in] res The response object.
+ * @return The number of metrics.
+ */
+static inline size_t get_node_metrics_res_num(get_node_metrics_res_t const* const res) { return utarray_len(res); }
+
+/**
+ * @brief Gets a metric by index.
+ *
+ * @param[in] res The response object.
+ * @param[in] index An index of the metric list.
+ * @return A pointer to a metric, NULL if out of range.
+ */
+node_metric_t* get_node_metrics_res_metric_at(get_node_metrics_res_t* const res, size_t const index);
+
+/**
+ * @brief Adds a counter or a gauge to the response.
+ *
+ * @param[in] res The response object.
+ * @param[in] name The name of the metric.
+ * @param[in] type #NODE_METRIC_COUNTER or #NODE_METRIC_GAUGE.
+ * @param[in] value The value of the metric.
+ * @return #retcode_t
+ */
+retcode_t get_node_metrics_res_add_value(get_node_metrics_res_t* const res, char const* const name,
+                                         node_metric_type_t const type, double const value);
+
+/**
+ * @brief Adds a histogram summary to the response.
+ *
+ * @param[in] res The response object.
+ * @param[in] name The name of the metric.
+ * @param[in] count The number of values.
+ * @param[in] mean The mean of the values.
+ * @param[in] p50 The median.
+ * @param[in] p90 The 90th percentile.
+ * @param[in] p99 The 99th percentile.
+ * @param[in] max The maximum.
+ * @return #retcode_t
+ */
+retcode_t get_node_metrics_res_add_histogram(get_node_metrics_res_t* const res, char const* const name,
+                                             uint64_t const count, double const mean, uint64_t const p50,
+                                             uint64_t const p90, uint64_t const p99, uint64_t const max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CCLIENT_RESPONSE_GET_NODE_METRICS_H
+
+/** @} */
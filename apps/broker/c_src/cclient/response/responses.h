@@ -18,6 +18,7 @@
 #include "cclient/response/get_missing_transactions.h"
 #include "cclient/response/get_neighbors.h"
 #include "cclient/response/get_node_info.h"
+#include "cclient/response/get_node_metrics.h"
 #include "cclient/response/get_tips.h"
 #include "cclient/response/get_transactions_to_approve.h"
 #include "cclient/response/get_trytes.h"
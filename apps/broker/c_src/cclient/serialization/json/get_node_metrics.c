@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+#include "cclient/serialization/json/get_node_metrics.h"
+
+#include "cclient/serialization/json/helpers.h"
+#include "cclient/serialization/json/logger.h"
+
+static char const *node_metric_type_name(node_metric_type_t const type) {
+  switch (type) {
+    case NODE_METRIC_COUNTER:
+      return "counter";
+    case NODE_METRIC_GAUGE:
+      return "gauge";
+    case NODE_METRIC_HISTOGRAM:
+      return "histogram";
+  }
+  return "unknown";
+}
+
+static retcode_t node_metrics_utarray_to_json_array(UT_array const *const ut, cJSON *const json_root,
+                                                    char const *const obj_name) {
+  node_metric_t *metric = NULL;
+
+  if (!ut || !json_root || !obj_name) {
+    log_error(json_logger_id, "[%s:%d] %s\n", __func__, __LINE__, error_2_string(RC_NULL_PARAM));
+    return RC_NULL_PARAM;
+  }
+
+  cJSON *array_obj = cJSON_CreateArray();
+  if (array_obj == NULL) {
+    log_critical(json_logger_id, "[%s:%d] %s\n", __func__, __LINE__, STR_CCLIENT_JSON_CREATE);
+    return RC_CCLIENT_JSON_CREATE;
+  }
+
+  cJSON_AddItemToObject(json_root, obj_name, array_obj);
+
+  while ((metric = (node_metric_t *)utarray_next(ut, metric))) {
+    cJSON *json_metric = cJSON_CreateObject();
+    if (json_metric == NULL) {
+      log_critical(json_logger_id, "[%s:%d] %s\n", __func__, __LINE__, STR_CCLIENT_JSON_CREATE);
+      return RC_CCLIENT_JSON_CREATE;
+    }
+
+    cJSON_AddStringToObject(json_metric, "name", metric->name);
+    cJSON_AddStringToObject(json_metric, "type", node_metric_type_name(metric->type));
+    if (metric->type == NODE_METRIC_HISTOGRAM) {
+      cJSON_AddNumberToObject(json_metric, "count", metric->count);
+      cJSON_AddNumberToObject(json_metric, "mean", metric->mean);
+      cJSON_AddNumberToObject(json_metric, "p50", metric->p50);
+      cJSON_AddNumberToObject(json_metric, "p90", metric->p90);
+      cJSON_AddNumberToObject(json_metric, "p99", metric->p99);
+      cJSON_AddNumberToObject(json_metric, "max", metric->max);
+    } else {
+      cJSON_AddNumberToObject(json_metric, "value", metric->value);
+    }
+
+    cJSON_AddItemToArray(array_obj, json_metric);
+  }
+
+  return RC_OK;
+}
+
+retcode_t json_get_node_metrics_serialize_response(get_node_metrics_res_t const *const res, char_buffer_t *out) {
+  retcode_t ret = RC_ERROR;
+
+  if (!res || !out) {
+    log_error(json_logger_id, "[%s:%d] %s\n", __func__, __LINE__, error_2_string(RC_NULL_PARAM));
+    return RC_NULL_PARAM;
+  }
+
+  cJSON *json_root = cJSON_CreateObject();
+  if (json_root == NULL) {
+    log_critical(json_logger_id, "[%s:%d] %s\n", __func__, __LINE__, STR_CCLIENT_JSON_CREATE);
+    return RC_CCLIENT_JSON_CREATE;
+  }
+
+  ret = node_metrics_utarray_to_json_array(res, json_root, "metrics");
+  if (ret) {
+    goto err;
+  }
+
+  char const *json_text = cJSON_PrintUnformatted(json_root);
+  if (json_text) {
+    ret = char_buffer_set(out, json_text);
+    cJSON_free((void *)json_text);
+  }
+
+err:
+  cJSON_Delete(json_root);
+  return ret;
+}
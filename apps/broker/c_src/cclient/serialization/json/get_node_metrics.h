@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup serialization_json
+ *
+ * @{
+ *
+ * @file
+ * @brief
+ *
+ */
+#ifndef CCLIENT_SERIALIZATION_JSON_GET_NODE_METRICS_H
+#define CCLIENT_SERIALIZATION_JSON_GET_NODE_METRICS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "common/errors.h"
+
+#include "cclient/response/get_node_metrics.h"
+#include "cclient/serialization/serializer.h"
+
+/**
+ * @brief Converts a get node metrics response to a JSON string.
+ *
+ * @param[in] res A get node metrics response object.
+ * @param[out] out A JSON string.
+ * @return #retcode_t
+ */
+retcode_t json_get_node_metrics_serialize_response(get_node_metrics_res_t const* const res, char_buffer_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // CCLIENT_SERIALIZATION_JSON_GET_NODE_METRICS_H
+
+/** @} */
\ No newline at end of file
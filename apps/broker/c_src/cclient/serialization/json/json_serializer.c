@@ -25,6 +25,7 @@
 #include "cclient/serialization/json/get_missing_transactions.h"
 #include "cclient/serialization/json/get_neighbors.h"
 #include "cclient/serialization/json/get_node_info.h"
+#include "cclient/serialization/json/get_node_metrics.h"
 #include "cclient/serialization/json/get_tips.h"
 #include "cclient/serialization/json/get_transactions_to_approve.h"
 #include "cclient/serialization/json/get_trytes.h"
@@ -78,6 +79,8 @@ static serializer_vtable json_vtable = {
     .get_node_info_serialize_response = json_get_node_info_serialize_response,
     .get_node_info_deserialize_response = json_get_node_info_deserialize_response,
 
+    .get_node_metrics_serialize_response = json_get_node_metrics_serialize_response,
+
     .get_tips_serialize_request = json_get_tips_serialize_request,
     .get_tips_serialize_response = json_get_tips_serialize_response,
     .get_tips_deserialize_response = json_get_tips_deserialize_response,
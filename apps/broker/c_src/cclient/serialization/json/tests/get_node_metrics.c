@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "cclient/serialization/json/tests/shared.h"
+
+void test_get_node_metrics_serialize_response(void) {
+  serializer_t serializer;
+  init_json_serializer(&serializer);
+  char_buffer_t* out = char_buffer_new();
+  char const* json_text =
+      "{\"metrics\":["
+      "{\"name\":\"validator.queue_size\",\"type\":\"gauge\",\"value\":3},"
+      "{\"name\":\"validator.processed\",\"type\":\"counter\",\"value\":1024},"
+      "{\"name\":\"validator.latency_us\",\"type\":\"histogram\",\"count\":1024,\"mean\":12.5,\"p50\":10,\"p90\":20,"
+      "\"p99\":40,\"max\":95}]}";
+  get_node_metrics_res_t* res = get_node_metrics_res_new();
+
+  TEST_ASSERT(get_node_metrics_res_add_value(res, "validator.queue_size", NODE_METRIC_GAUGE, 3) == RC_OK);
+  TEST_ASSERT(get_node_metrics_res_add_value(res, "validator.processed", NODE_METRIC_COUNTER, 1024) == RC_OK);
+  TEST_ASSERT(get_node_metrics_res_add_value(res, "validator.latency_us", NODE_METRIC_HISTOGRAM, 0) ==
+              RC_INVALID_PARAM);
+  TEST_ASSERT(get_node_metrics_res_add_histogram(res, "validator.latency_us", 1024, 12.5, 10, 20, 40, 95) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, get_node_metrics_res_num(res));
+  TEST_ASSERT_EQUAL_STRING("validator.processed", get_node_metrics_res_metric_at(res, 1)->name);
+  TEST_ASSERT_NULL(get_node_metrics_res_metric_at(res, 3));
+
+  TEST_ASSERT(serializer.vtable.get_node_metrics_serialize_response(res, out) == RC_OK);
+
+  TEST_ASSERT_EQUAL_STRING(json_text, out->data);
+
+  char_buffer_free(out);
+  get_node_metrics_res_free(&res);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_get_node_metrics_serialize_response);
+
+  return UNITY_END();
+}
@@ -18,6 +18,117 @@
 
 static logger_id_t logger_id;
 
+/*
+ * Private functions
+ */
+
+static retcode_t add_stage_metrics(get_node_metrics_res_t *const res, char const *const stage,
+                                   stage_metrics_t const *const metrics, size_t const queue_size) {
+  retcode_t ret = RC_OK;
+  char name[NODE_METRIC_NAME_SIZE];
+  histogram_t const *const latency = &metrics->latency;
+
+  snprintf(name, sizeof(name), "%s.queue_size", stage);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, name, NODE_METRIC_GAUGE, queue_size), ret);
+  snprintf(name, sizeof(name), "%s.processed", stage);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, name, NODE_METRIC_COUNTER, stage_metrics_processed(metrics)),
+                  ret);
+  snprintf(name, sizeof(name), "%s.failed", stage);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, name, NODE_METRIC_COUNTER, stage_metrics_failed(metrics)), ret);
+  snprintf(name, sizeof(name), "%s.latency_us", stage);
+  return get_node_metrics_res_add_histogram(res, name, histogram_count(latency), histogram_mean(latency),
+                                            histogram_percentile(latency, 50), histogram_percentile(latency, 90),
+                                            histogram_percentile(latency, 99), histogram_max(latency));
+}
+
+static retcode_t add_hasher_metrics(get_node_metrics_res_t *const res, hasher_stage_t *const hasher) {
+  retcode_t ret = RC_OK;
+  hasher_stage_metrics_t metrics;
+
+  ERR_BIND_RETURN(hasher_stage_metrics(hasher, &metrics), ret);
+  ERR_BIND_RETURN(
+      get_node_metrics_res_add_value(res, "hasher.queue_size", NODE_METRIC_GAUGE, hasher_stage_size(hasher)), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "hasher.processed", NODE_METRIC_COUNTER, metrics.packets), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "hasher.batches", NODE_METRIC_COUNTER, metrics.batches), ret);
+  ERR_BIND_RETURN(
+      get_node_metrics_res_add_value(res, "hasher.lane_occupancy", NODE_METRIC_GAUGE, metrics.lane_occupancy), ret);
+  return get_node_metrics_res_add_histogram(res, "hasher.latency_us", metrics.batches, metrics.latency_mean_us,
+                                            metrics.latency_p50_us, metrics.latency_p90_us, metrics.latency_p99_us,
+                                            metrics.latency_max_us);
+}
+
+static retcode_t add_requester_metrics(get_node_metrics_res_t *const res, transaction_requester_t *const requester) {
+  retcode_t ret = RC_OK;
+  requester_metrics_t metrics;
+
+  ERR_BIND_RETURN(requester_metrics(requester, &metrics), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.queue_size", NODE_METRIC_GAUGE, metrics.queued), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.in_flight", NODE_METRIC_GAUGE, metrics.in_flight),
+                  ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.sent", NODE_METRIC_COUNTER, metrics.sent), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.timed_out", NODE_METRIC_COUNTER, metrics.timed_out),
+                  ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.fulfilled", NODE_METRIC_COUNTER, metrics.fulfilled),
+                  ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.dropped", NODE_METRIC_COUNTER, metrics.dropped), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "requester.abandoned", NODE_METRIC_COUNTER, metrics.abandoned),
+                  ret);
+  return get_node_metrics_res_add_histogram(res, "requester.latency_ms", metrics.fulfilled, metrics.latency_mean_ms,
+                                            metrics.latency_p50_ms, metrics.latency_p90_ms, metrics.latency_p99_ms,
+                                            metrics.latency_max_ms);
+}
+
+static retcode_t add_router_metrics(get_node_metrics_res_t *const res, router_t *const router) {
+  retcode_t ret = RC_OK;
+  router_neighbors_t const *neighbors = NULL;
+  neighbor_t *neighbor = NULL;
+  uint64_t epoch = 0;
+  size_t size = 0, paused = 0;
+  uint64_t all_txs = 0, new_txs = 0, invalid_txs = 0, stale_txs = 0, random_requests = 0, sent = 0, dropped_send = 0;
+
+  epoch = router_neighbors_enter(router);
+  neighbors = router_neighbors(router);
+  NEIGHBORS_FOREACH(neighbors, neighbor) {
+    // A paused neighbor holds packets the processor had no room for
+    paused += neighbor->read_paused ? 1 : 0;
+    all_txs += neighbor->nbr_all_txs;
+    new_txs += neighbor->nbr_new_txs;
+    invalid_txs += neighbor->nbr_invalid_txs;
+    stale_txs += neighbor->nbr_stale_txs;
+    random_requests += neighbor->nbr_random_tx_reqs;
+    sent += neighbor->nbr_sent_txs;
+    dropped_send += neighbor->nbr_dropped_send;
+  }
+  size = neighbors->size;
+  router_neighbors_exit(router, epoch);
+
+  ERR_BIND_RETURN(add_stage_metrics(res, "router", &router->metrics, paused), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.neighbors", NODE_METRIC_GAUGE, size), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.received", NODE_METRIC_COUNTER, all_txs), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.new", NODE_METRIC_COUNTER, new_txs), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.invalid", NODE_METRIC_COUNTER, invalid_txs), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.stale", NODE_METRIC_COUNTER, stale_txs), ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.random_requests", NODE_METRIC_COUNTER, random_requests),
+                  ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "router.sent", NODE_METRIC_COUNTER, sent), ret);
+  return get_node_metrics_res_add_value(res, "router.dropped_send", NODE_METRIC_COUNTER, dropped_send);
+}
+
+static retcode_t add_cache_metrics(get_node_metrics_res_t *const res, char const *const cache, size_t const size,
+                                   uint64_t const hit, uint64_t const miss, uint64_t const eviction) {
+  retcode_t ret = RC_OK;
+  char name[NODE_METRIC_NAME_SIZE];
+
+  snprintf(name, sizeof(name), "%s.size", cache);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, name, NODE_METRIC_GAUGE, size), ret);
+  snprintf(name, sizeof(name), "%s.hit", cache);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, name, NODE_METRIC_COUNTER, hit), ret);
+  snprintf(name, sizeof(name), "%s.miss", cache);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, name, NODE_METRIC_COUNTER, miss), ret);
+  snprintf(name, sizeof(name), "%s.eviction", cache);
+  return get_node_metrics_res_add_value(res, name, NODE_METRIC_COUNTER, eviction);
+}
+
 /*
  * Public functions
  */
@@ -194,6 +305,8 @@ retcode_t iota_api_find_transactions(iota_api_t const *const api, tangle_t *cons
                                      error_res_t **const error) {
   retcode_t ret = RC_OK;
   iota_stor_pack_t pack;
+  storage_cursor_t cursor;
+  size_t found = 0;
 
   if (api == NULL || req == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
@@ -207,20 +320,26 @@ retcode_t iota_api_find_transactions(iota_api_t const *const api, tangle_t *cons
   // TODO Refactor stor_pack #618
   hash_pack_init(&pack, 1024);
 
-  if ((ret = iota_tangle_transaction_find(tangle, req->bundles, req->addresses, req->tags, req->approvees, &pack)) !=
-      RC_OK) {
-    goto done;
-  }
-
-  if (pack.num_loaded > api->conf.max_find_transactions) {
-    ret = RC_API_MAX_FIND_TRANSACTIONS;
-    goto done;
-  }
+  // The matches are streamed so that hot addresses are neither loaded at once nor queried again
+  storage_cursor_init_find(&cursor, STORAGE_CURSOR_MODEL_HASH, req->bundles, req->addresses, req->tags,
+                           req->approvees);
+  while (!cursor.done) {
+    hash_pack_reset(&pack);
+    if ((ret = iota_tangle_cursor_next(tangle, &cursor, &pack)) != RC_OK) {
+      goto done;
+    }
 
-  for (size_t i = 0; i < pack.num_loaded; i++) {
-    if ((ret = hash243_queue_push(&res->hashes, (pack.models)[i])) != RC_OK) {
+    found += pack.num_loaded;
+    if (found > api->conf.max_find_transactions) {
+      ret = RC_API_MAX_FIND_TRANSACTIONS;
       goto done;
     }
+
+    for (size_t i = 0; i < pack.num_loaded; i++) {
+      if ((ret = hash243_queue_push(&res->hashes, (pack.models)[i])) != RC_OK) {
+        goto done;
+      }
+    }
   }
 
 done:
@@ -379,15 +498,18 @@ retcode_t iota_api_get_missing_transactions(iota_api_t const *const api, get_mis
 retcode_t iota_api_get_neighbors(iota_api_t const *const api, get_neighbors_res_t *const res,
                                  error_res_t **const error) {
   retcode_t ret = RC_OK;
+  router_neighbors_t const *neighbors = NULL;
   neighbor_t *neighbor = NULL;
+  uint64_t epoch = 0;
   char address[MAX_HOST_LENGTH + MAX_PORT_LENGTH + 1];
 
   if (api == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&api->core->node.router.neighbors_lock);
-  NEIGHBORS_FOREACH(api->core->node.router.neighbors, neighbor) {
+  epoch = router_neighbors_enter(&api->core->node.router);
+  neighbors = router_neighbors(&api->core->node.router);
+  NEIGHBORS_FOREACH(neighbors, neighbor) {
     snprintf(address, MAX_HOST_LENGTH + MAX_PORT_LENGTH + 1, "%s:%d", neighbor->endpoint.domain,
              neighbor->endpoint.port);
     if ((ret = get_neighbors_res_add_neighbor(res, address, neighbor->nbr_all_txs, neighbor->nbr_random_tx_reqs,
@@ -396,21 +518,24 @@ retcode_t iota_api_get_neighbors(iota_api_t const *const api, get_neighbors_res_
       break;
     }
   }
-  rw_lock_handle_unlock(&api->core->node.router.neighbors_lock);
+  router_neighbors_exit(&api->core->node.router, epoch);
 
   return ret;
 }
 
 retcode_t iota_api_get_node_info(iota_api_t const *const api, get_node_info_res_t *const res,
                                  error_res_t **const error) {
+  uint64_t latest_milestone_index = 0;
+
   if (api == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
   }
 
   char_buffer_set(res->app_name, CIRI_NAME);
   char_buffer_set(res->app_version, CIRI_VERSION);
-  memcpy(res->latest_milestone, api->core->consensus.milestone_tracker.latest_milestone, FLEX_TRIT_SIZE_243);
-  res->latest_milestone_index = api->core->consensus.milestone_tracker.latest_milestone_index;
+  iota_milestone_tracker_get_latest_milestone(&api->core->consensus.milestone_tracker, res->latest_milestone,
+                                              &latest_milestone_index);
+  res->latest_milestone_index = latest_milestone_index;
   memcpy(res->latest_solid_subtangle_milestone, api->core->consensus.milestone_tracker.latest_solid_milestone,
          FLEX_TRIT_SIZE_243);
   res->latest_solid_subtangle_milestone_index = api->core->consensus.milestone_tracker.latest_solid_milestone_index;
@@ -427,6 +552,44 @@ retcode_t iota_api_get_node_info(iota_api_t const *const api, get_node_info_res_
   return RC_OK;
 }
 
+retcode_t iota_api_get_node_metrics(iota_api_t const *const api, get_node_metrics_res_t *const res,
+                                    error_res_t **const error) {
+  retcode_t ret = RC_OK;
+  node_t *node = NULL;
+  recent_seen_bytes_cache_stats_t seen_stats;
+  transaction_bytes_cache_stats_t bytes_stats;
+
+  if (api == NULL || res == NULL || error == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  node = &api->core->node;
+
+  ERR_BIND_RETURN(add_stage_metrics(res, "processor", &node->processor.metrics, processor_stage_size(&node->processor)),
+                  ret);
+  ERR_BIND_RETURN(add_hasher_metrics(res, &node->hasher), ret);
+  ERR_BIND_RETURN(add_stage_metrics(res, "validator", &node->validator.metrics, validator_stage_size(&node->validator)),
+                  ret);
+  ERR_BIND_RETURN(get_node_metrics_res_add_value(res, "validator.stored", NODE_METRIC_COUNTER,
+                                                 atomic_load_explicit(&node->validator.stored, memory_order_relaxed)),
+                  ret);
+  ERR_BIND_RETURN(add_stage_metrics(res, "broadcaster", &node->broadcaster.metrics,
+                                    broadcaster_stage_size(&node->broadcaster)),
+                  ret);
+  ERR_BIND_RETURN(add_stage_metrics(res, "responder", &node->responder.metrics, responder_stage_size(&node->responder)),
+                  ret);
+  ERR_BIND_RETURN(add_requester_metrics(res, &node->transaction_requester), ret);
+  ERR_BIND_RETURN(add_router_metrics(res, &node->router), ret);
+
+  ERR_BIND_RETURN(recent_seen_bytes_cache_stats(&node->recent_seen_bytes, &seen_stats), ret);
+  ERR_BIND_RETURN(add_cache_metrics(res, "recent_seen_bytes_cache", seen_stats.size, seen_stats.hit, seen_stats.miss,
+                                    seen_stats.eviction),
+                  ret);
+  ERR_BIND_RETURN(transaction_bytes_cache_stats(&node->transaction_bytes, &bytes_stats), ret);
+  return add_cache_metrics(res, "transaction_bytes_cache", bytes_stats.size, bytes_stats.hit, bytes_stats.miss,
+                           bytes_stats.eviction);
+}
+
 retcode_t iota_api_get_tips(iota_api_t const *const api, get_tips_res_t *const res, error_res_t **const error) {
   if (api == NULL || res == NULL || error == NULL) {
     return RC_NULL_PARAM;
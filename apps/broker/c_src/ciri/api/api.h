@@ -236,6 +236,19 @@ retcode_t iota_api_get_neighbors(iota_api_t const *const api, get_neighbors_res_
 retcode_t iota_api_get_node_info(iota_api_t const *const api, get_node_info_res_t *const res,
                                  error_res_t **const error);
 
+/**
+ * @brief Returns the counters, queue sizes and latency histograms of the node pipeline stages, requester, router and
+ * caches.
+ *
+ * @param[in]   api   The API
+ * @param[out]  res   The response
+ * @param[out]  error An error response
+ *
+ * @return a status code
+ */
+retcode_t iota_api_get_node_metrics(iota_api_t const *const api, get_node_metrics_res_t *const res,
+                                    error_res_t **const error);
+
 /**
  * @brief Returns tips currently known by the node.
  *
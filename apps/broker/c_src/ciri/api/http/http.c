@@ -316,6 +316,30 @@ done:
   return ret;
 }
 
+static inline retcode_t process_get_node_metrics_request(iota_api_http_t *const http, char const *const payload,
+                                                         char_buffer_t *const out) {
+  retcode_t ret = RC_OK;
+  get_node_metrics_res_t *res = get_node_metrics_res_new();
+  error_res_t *error = NULL;
+  UNUSED(payload);
+
+  if (res == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+
+  if ((ret = iota_api_get_node_metrics(http->api, res, &error)) != RC_OK) {
+    error_serialize_response(http, &error, NULL, out);
+  } else {
+    ret = http->serializer.vtable.get_node_metrics_serialize_response(res, out);
+  }
+
+done:
+  get_node_metrics_res_free(&res);
+
+  return ret;
+}
+
 static inline retcode_t process_get_tips_request(iota_api_http_t *const http, char const *const payload,
                                                  char_buffer_t *const out) {
   retcode_t ret = RC_OK;
@@ -529,6 +553,8 @@ static retcode_t iota_api_http_process_request(iota_api_http_t *const http, char
     return process_get_neighbors_request(http, payload, out);
   } else if (strcmp(command, "getNodeInfo") == 0) {
     return process_get_node_info_request(http, payload, out);
+  } else if (strcmp(command, "getNodeMetrics") == 0) {
+    return process_get_node_metrics_request(http, payload, out);
   } else if (strcmp(command, "getTips") == 0) {
     return process_get_tips_request(http, payload, out);
   } else if (strcmp(command, "getTransactionsToApprove") == 0) {
@@ -31,19 +31,19 @@ void test_add_neighbors(void) {
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 4);
   TEST_ASSERT_EQUAL_INT(res->added_neighbors, 4);
 
-  neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 0);
+  neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[0];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.1");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15001);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 1);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[1];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.2");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15002);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 2);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[2];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.3");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15003);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 3);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[3];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.4");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15004);
 
@@ -69,7 +69,7 @@ void test_add_neighbors_with_already_paired(void) {
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 5);
   TEST_ASSERT_EQUAL_INT(res->added_neighbors, 1);
 
-  neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 4);
+  neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[4];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.5");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15005);
 
@@ -96,7 +96,7 @@ void test_add_neighbors_with_invalid(void) {
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 6);
   TEST_ASSERT_EQUAL_INT(res->added_neighbors, 1);
 
-  neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 5);
+  neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[5];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.6");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15006);
 
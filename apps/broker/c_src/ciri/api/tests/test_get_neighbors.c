@@ -41,7 +41,7 @@ void test_get_neighbors(void) {
 
   for (size_t i = 0; i < get_neighbors_res_num(res); i++) {
     neighbor_info_t *info = get_neighbors_res_neighbor_at(res, i);
-    neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, i);
+    neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[i];
 
     snprintf(address, MAX_HOST_LENGTH + MAX_PORT_LENGTH + 1, "%s:%d", neighbor->endpoint.domain,
              neighbor->endpoint.port);
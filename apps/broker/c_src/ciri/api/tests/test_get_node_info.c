@@ -115,9 +115,12 @@ int main(void) {
 
   // Adding requests
 
-  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[0]) == RC_OK);
-  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[1]) == RC_OK);
-  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[2]) == RC_OK);
+  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[0],
+                                  REQUESTER_NO_MILESTONE) == RC_OK);
+  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[1],
+                                  REQUESTER_NO_MILESTONE) == RC_OK);
+  TEST_ASSERT(request_transaction(&api.core->node.transaction_requester, &tangle, hashes[2],
+                                  REQUESTER_NO_MILESTONE) == RC_OK);
   // Adding broadcasts
 
   protocol_gossip_t packet;
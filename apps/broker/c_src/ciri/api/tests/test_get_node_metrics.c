@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <arpa/inet.h>
+#include <unity/unity.h>
+
+#include "ciri/api/api.h"
+#include "ciri/node/node.h"
+
+static iota_api_t api;
+static core_t core;
+static neighbor_t neighbor;
+
+static node_metric_t *find_metric(get_node_metrics_res_t *const res, char const *const name) {
+  node_metric_t *metric = NULL;
+
+  for (size_t i = 0; i < get_node_metrics_res_num(res); i++) {
+    metric = get_node_metrics_res_metric_at(res, i);
+    if (strcmp(metric->name, name) == 0) {
+      return metric;
+    }
+  }
+  TEST_FAIL_MESSAGE(name);
+
+  return NULL;
+}
+
+static void assert_metric(get_node_metrics_res_t *const res, char const *const name, node_metric_type_t const type,
+                          double const value) {
+  node_metric_t *metric = find_metric(res, name);
+
+  TEST_ASSERT_EQUAL_INT(metric->type, type);
+  TEST_ASSERT_EQUAL_DOUBLE(metric->value, value);
+}
+
+static void append_packet(uint8_t const type, uint16_t const length) {
+  protocol_header_t header;
+
+  header.type = type;
+  header.length = htons(length);
+  memcpy(neighbor.buffer + neighbor.buffer_size, &header, HEADER_BYTES_LENGTH);
+  memset(neighbor.buffer + neighbor.buffer_size + HEADER_BYTES_LENGTH, 0, length);
+  neighbor.buffer_size += HEADER_BYTES_LENGTH + length;
+}
+
+void test_get_node_metrics_empty(void) {
+  get_node_metrics_res_t *res = get_node_metrics_res_new();
+  error_res_t *error = NULL;
+  node_metric_t *metric = NULL;
+
+  TEST_ASSERT(iota_api_get_node_metrics(&api, res, &error) == RC_OK);
+  TEST_ASSERT(error == NULL);
+
+  assert_metric(res, "processor.queue_size", NODE_METRIC_GAUGE, 0);
+  assert_metric(res, "processor.processed", NODE_METRIC_COUNTER, 0);
+  assert_metric(res, "router.queue_size", NODE_METRIC_GAUGE, 0);
+  assert_metric(res, "router.processed", NODE_METRIC_COUNTER, 0);
+  assert_metric(res, "router.neighbors", NODE_METRIC_GAUGE, 1);
+  assert_metric(res, "requester.queue_size", NODE_METRIC_GAUGE, 0);
+  assert_metric(res, "transaction_bytes_cache.size", NODE_METRIC_GAUGE, 0);
+  metric = find_metric(res, "router.latency_us");
+  TEST_ASSERT_EQUAL_INT(metric->type, NODE_METRIC_HISTOGRAM);
+  TEST_ASSERT_EQUAL_UINT64(metric->count, 0);
+
+  get_node_metrics_res_free(&res);
+  error_res_free(&error);
+}
+
+void test_get_node_metrics_router_read(void) {
+  get_node_metrics_res_t *res = get_node_metrics_res_new();
+  error_res_t *error = NULL;
+  node_metric_t *metric = NULL;
+
+  // Two gossip packets handed to the processor and one too short for it
+  append_packet(PROTOCOL_GOSSIP, GOSSIP_MIN_BYTES_LENGTH);
+  append_packet(PROTOCOL_GOSSIP, GOSSIP_MAX_BYTES_LENGTH);
+  append_packet(PROTOCOL_GOSSIP, GOSSIP_MIN_BYTES_LENGTH - 1);
+  TEST_ASSERT(router_read(&api.core->node.router, &neighbor, 0) == RC_INVALID_PACKET);
+
+  TEST_ASSERT(iota_api_get_node_metrics(&api, res, &error) == RC_OK);
+  TEST_ASSERT(error == NULL);
+
+  assert_metric(res, "processor.queue_size", NODE_METRIC_GAUGE, 2);
+  assert_metric(res, "router.processed", NODE_METRIC_COUNTER, 3);
+  assert_metric(res, "router.failed", NODE_METRIC_COUNTER, 1);
+  metric = find_metric(res, "router.latency_us");
+  TEST_ASSERT_EQUAL_INT(metric->type, NODE_METRIC_HISTOGRAM);
+  TEST_ASSERT_EQUAL_UINT64(metric->count, 3);
+  TEST_ASSERT(metric->p50 <= metric->max);
+
+  get_node_metrics_res_free(&res);
+  error_res_free(&error);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  api.core = &core;
+  TEST_ASSERT(iota_node_conf_init(&api.core->node.conf) == RC_OK);
+  api.core->node.conf.requester_queue_size = 100;
+  TEST_ASSERT(router_init(&api.core->node.router, &api.core->node) == RC_OK);
+  TEST_ASSERT(processor_stage_init(&api.core->node.processor, &api.core->node) == RC_OK);
+  TEST_ASSERT(requester_init(&api.core->node.transaction_requester, &api.core->node) == RC_OK);
+  TEST_ASSERT(recent_seen_bytes_cache_init(&api.core->node.recent_seen_bytes, 100) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_init(&api.core->node.transaction_bytes, 100) == RC_OK);
+
+  TEST_ASSERT(neighbor_init_with_uri(&neighbor, "tcp://8.8.8.1:15001") == RC_OK);
+  TEST_ASSERT(router_neighbor_add(&api.core->node.router, &neighbor) == RC_OK);
+  TEST_ASSERT_NOT_NULL(neighbor.buffer = malloc(NEIGHBOR_RECEIVE_BUFFER_SIZE));
+  neighbor.buffer_size = 0;
+
+  RUN_TEST(test_get_node_metrics_empty);
+  RUN_TEST(test_get_node_metrics_router_read);
+
+  free(neighbor.buffer);
+  TEST_ASSERT(transaction_bytes_cache_destroy(&api.core->node.transaction_bytes) == RC_OK);
+  TEST_ASSERT(recent_seen_bytes_cache_destroy(&api.core->node.recent_seen_bytes) == RC_OK);
+  TEST_ASSERT(requester_destroy(&api.core->node.transaction_requester) == RC_OK);
+  TEST_ASSERT(processor_stage_destroy(&api.core->node.processor) == RC_OK);
+  TEST_ASSERT(router_destroy(&api.core->node.router) == RC_OK);
+
+  return UNITY_END();
+}
@@ -17,8 +17,13 @@ void test_remove_neighbors(void) {
   remove_neighbors_req_t *req = remove_neighbors_req_new();
   remove_neighbors_res_t *res = remove_neighbors_res_new();
   error_res_t *error = NULL;
+  router_neighbors_t const *snapshot = NULL;
+  uint64_t epoch = 0;
 
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 6);
+  epoch = router_neighbors_enter(&api.core->node.router);
+  snapshot = router_neighbors(&api.core->node.router);
+  TEST_ASSERT_NOT_NULL(router_neighbor_find_by_endpoint_values(&api.core->node.router, "8.8.8.2", 15002));
 
   TEST_ASSERT(remove_neighbors_req_add(req, "tcp://8.8.8.2:15002") == RC_OK);
   TEST_ASSERT(remove_neighbors_req_add(req, "tcp://8.8.8.4:15004") == RC_OK);
@@ -28,20 +33,28 @@ void test_remove_neighbors(void) {
 
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 4);
   TEST_ASSERT_EQUAL_INT(res->removed_neighbors, 2);
+  TEST_ASSERT_NULL(router_neighbor_find_by_endpoint_values(&api.core->node.router, "8.8.8.2", 15002));
+  TEST_ASSERT_NOT_NULL(router_neighbor_find_by_endpoint_values(&api.core->node.router, "8.8.8.3", 15003));
 
-  neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 0);
+  // A reader holding the previous snapshot still sees the removed neighbors
+  TEST_ASSERT_EQUAL_INT(snapshot->size, 6);
+  TEST_ASSERT_EQUAL_STRING(snapshot->neighbors[1]->endpoint.domain, "8.8.8.2");
+  TEST_ASSERT(router_neighbors(&api.core->node.router)->version > snapshot->version);
+  router_neighbors_exit(&api.core->node.router, epoch);
+
+  neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[0];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.1");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15001);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 1);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[1];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.3");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15003);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 2);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[2];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.5");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15005);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 3);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[3];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.6");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15006);
 
@@ -67,11 +80,11 @@ void test_remove_neighbors_with_not_paired(void) {
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 2);
   TEST_ASSERT_EQUAL_INT(res->removed_neighbors, 2);
 
-  neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 0);
+  neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[0];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.5");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15005);
 
-  neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 1);
+  neighbor = router_neighbors(&api.core->node.router)->neighbors[1];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.6");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15006);
 
@@ -98,7 +111,7 @@ void test_remove_neighbors_with_invalid(void) {
   TEST_ASSERT_EQUAL_INT(router_neighbors_count(&api.core->node.router), 1);
   TEST_ASSERT_EQUAL_INT(res->removed_neighbors, 1);
 
-  neighbor_t *neighbor = (neighbor_t *)utarray_eltptr(api.core->node.router.neighbors, 0);
+  neighbor_t *neighbor = router_neighbors(&api.core->node.router)->neighbors[0];
   TEST_ASSERT_EQUAL_STRING(neighbor->endpoint.domain, "8.8.8.5");
   TEST_ASSERT_EQUAL_INT(neighbor->endpoint.port, 15005);
 
@@ -121,6 +121,59 @@ static retcode_t get_sponge_type(char const* const input, sponge_type_t* const o
   return RC_OK;
 }
 
+static retcode_t get_storage_backend(char const* const input, storage_backend_type_t* const output) {
+  static struct storage_backend_map {
+    char* str;
+    storage_backend_type_t backend;
+  } map[] = {{"sqlite3", STORAGE_BACKEND_SQLITE3}, {"kv", STORAGE_BACKEND_KV}};
+  size_t i;
+
+  for (i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
+    if (strcmp(map[i].str, input) == 0) {
+      *output = map[i].backend;
+      return RC_OK;
+    }
+  }
+
+  return RC_CONF_INVALID_ARGUMENT;
+}
+
+static retcode_t get_storage_durability(char const* const input, storage_durability_t* const output) {
+  static struct storage_durability_map {
+    char* str;
+    storage_durability_t durability;
+  } map[] = {{"full", STORAGE_DURABILITY_FULL}, {"normal", STORAGE_DURABILITY_NORMAL}, {"off", STORAGE_DURABILITY_OFF}};
+  size_t i;
+
+  for (i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
+    if (strcmp(map[i].str, input) == 0) {
+      *output = map[i].durability;
+      return RC_OK;
+    }
+  }
+
+  return RC_CONF_INVALID_ARGUMENT;
+}
+
+static retcode_t get_storage_temp_store(char const* const input, storage_temp_store_t* const output) {
+  static struct storage_temp_store_map {
+    char* str;
+    storage_temp_store_t temp_store;
+  } map[] = {{"default", STORAGE_TEMP_STORE_DEFAULT},
+             {"file", STORAGE_TEMP_STORE_FILE},
+             {"memory", STORAGE_TEMP_STORE_MEMORY}};
+  size_t i;
+
+  for (i = 0; i < sizeof(map) / sizeof(map[0]); i++) {
+    if (strcmp(map[i].str, input) == 0) {
+      *output = map[i].temp_store;
+      return RC_OK;
+    }
+  }
+
+  return RC_CONF_INVALID_ARGUMENT;
+}
+
 static retcode_t get_probability(char const* const input, double* const output) {
   *output = atof(input);
   if (*output < 0 || *output > 1) {
@@ -200,6 +253,12 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_AUTO_TETHERING_ENABLED:  // --auto-tethering-enabled
       ret = get_true_false(value, &node_conf->auto_tethering_enabled);
       break;
+    case CONF_HASHER_BATCH_DEADLINE_US:  // --hasher-batch-deadline-us
+      node_conf->hasher_batch_deadline_us = atoi(value);
+      break;
+    case CONF_HASHER_THREADS:  // --hasher-threads
+      node_conf->hasher_threads = atoi(value);
+      break;
     case CONF_MAX_NEIGHBORS:  // --max-neighbors
       node_conf->max_neighbors = atoi(value);
       break;
@@ -237,9 +296,45 @@ static retcode_t set_conf_value(iota_ciri_conf_t* const ciri_conf, iota_consensu
     case CONF_REQUESTER_QUEUE_SIZE:  // --requester-queue-size
       node_conf->requester_queue_size = atoi(value);
       break;
+    case CONF_SEND_QUEUE_SIZE:  // --send-queue-size
+      node_conf->send_queue_size = atoi(value);
+      break;
+    case CONF_STAGE_QUEUE_SIZE:  // --stage-queue-size
+      node_conf->stage_queue_size = atoi(value);
+      break;
+    case CONF_TANGLE_DB_CACHE_SIZE:  // --tangle-db-cache-size
+      node_conf->tangle_db_cache_size = atoi(value);
+      break;
+    case CONF_TANGLE_DB_BACKEND:  // --tangle-db-backend
+      ret = get_storage_backend(value, &node_conf->tangle_db_backend);
+      break;
+    case CONF_TANGLE_DB_DURABILITY:  // --tangle-db-durability
+      ret = get_storage_durability(value, &node_conf->tangle_db_durability);
+      break;
+    case CONF_TANGLE_DB_MMAP_SIZE:  // --tangle-db-mmap-size
+      node_conf->tangle_db_mmap_size = atoi(value);
+      break;
+    case CONF_TANGLE_DB_READERS:  // --tangle-db-readers
+      node_conf->tangle_db_readers = atoi(value);
+      break;
+    case CONF_TANGLE_DB_TEMP_STORE:  // --tangle-db-temp-store
+      ret = get_storage_temp_store(value, &node_conf->tangle_db_temp_store);
+      break;
+    case CONF_TANGLE_DB_WAL_AUTOCHECKPOINT:  // --tangle-db-wal-autocheckpoint
+      node_conf->tangle_db_wal_autocheckpoint = atoi(value);
+      break;
+    case CONF_TANGLE_DB_WRITE_BATCH_SIZE:  // --tangle-db-write-batch-size
+      node_conf->tangle_db_write_batch_size = atoi(value);
+      break;
+    case CONF_TANGLE_DB_WRITE_BATCH_TIMEOUT:  // --tangle-db-write-batch-timeout
+      node_conf->tangle_db_write_batch_timeout = atoi(value);
+      break;
     case CONF_TIPS_CACHE_SIZE:  // --tips-cache-size
       node_conf->tips_cache_size = atoi(value);
       break;
+    case CONF_TRANSACTION_BYTES_CACHE_SIZE:  // --transaction-bytes-cache-size
+      node_conf->transaction_bytes_cache_size = atoi(value);
+      break;
 
     // API configuration
     case 'p':  // --http_port
@@ -207,13 +207,15 @@ static void* milestone_validator(void* arg) {
           log_info(logger_id,
                    "Latest milestone was changed from #%" PRIu64 " to #%" PRIu64 " (%d remaining candidates)\n",
                    mt->latest_milestone_index, candidate.index, hash243_queue_count(mt->candidates));
+          lock_handle_lock(&mt->latest_milestone_lock);
           mt->latest_milestone_index = candidate.index;
           memcpy(mt->latest_milestone, candidate.hash, FLEX_TRIT_SIZE_243);
+          lock_handle_unlock(&mt->latest_milestone_lock);
         }
       } else if (milestone_status == MILESTONE_INCOMPLETE) {
-        if (iota_consensus_transaction_solidifier_check_solidity(mt->transaction_solidifier, &tangle, candidate.hash,
-                                                                 MILESTONE_VALIDATION_TRANSACTIONS_LIMIT,
-                                                                 &is_solid) != RC_OK) {
+        if (iota_consensus_transaction_solidifier_check_solidity(
+                mt->transaction_solidifier, &tangle, candidate.hash, MILESTONE_VALIDATION_TRANSACTIONS_LIMIT,
+                candidate.index, &is_solid) != RC_OK) {
           log_warning(logger_id, "Quick fetching of milestone failed\n");
         }
         iota_milestone_tracker_add_candidate(mt, candidate.hash);
@@ -251,7 +253,7 @@ retcode_t update_latest_solid_milestone(milestone_tracker_t* const mt, tangle_t*
 
     if ((ret = iota_consensus_transaction_solidifier_check_solidity(mt->transaction_solidifier, tangle, milestone.hash,
                                                                     MILESTONE_SOLIDIFICATION_TRANSACTIONS_LIMIT,
-                                                                    &is_solid)) != RC_OK) {
+                                                                    milestone.index, &is_solid)) != RC_OK) {
       return ret;
     }
     if (!is_solid) {
@@ -343,6 +345,7 @@ retcode_t iota_milestone_tracker_init(milestone_tracker_t* const mt, iota_consen
   mt->transaction_solidifier = ts;
   mt->candidates = NULL;
   lock_handle_init(&mt->candidates_lock);
+  lock_handle_init(&mt->latest_milestone_lock);
   mt->milestone_start_index = conf->last_milestone;
   mt->latest_milestone_index = conf->last_milestone;
   mt->latest_solid_milestone_index = MAX(conf->last_milestone, snapshots_provider->initial_snapshot.metadata.index);
@@ -372,8 +375,10 @@ retcode_t iota_milestone_tracker_start(milestone_tracker_t* const mt, tangle_t*
     return ret;
   }
   if (pack.num_loaded != 0) {
+    lock_handle_lock(&mt->latest_milestone_lock);
     mt->latest_milestone_index = MAX(latest_milestone.index, mt->snapshots_provider->latest_snapshot.metadata.index);
     memcpy(mt->latest_milestone, latest_milestone.hash, FLEX_TRIT_SIZE_243);
+    lock_handle_unlock(&mt->latest_milestone_lock);
   }
   log_info(logger_id, "Latest milestone: #%d\n", mt->latest_milestone_index);
 
@@ -450,6 +455,7 @@ retcode_t iota_milestone_tracker_destroy(milestone_tracker_t* const mt) {
 
   hash243_queue_free(&mt->candidates);
   lock_handle_destroy(&mt->candidates_lock);
+  lock_handle_destroy(&mt->latest_milestone_lock);
   cond_handle_destroy(&mt->cond_validator);
   cond_handle_destroy(&mt->cond_solidifier);
   memset(mt, 0, sizeof(milestone_tracker_t));
@@ -458,6 +464,22 @@ retcode_t iota_milestone_tracker_destroy(milestone_tracker_t* const mt) {
   return ret;
 }
 
+retcode_t iota_milestone_tracker_get_latest_milestone(milestone_tracker_t* const mt, flex_trit_t* const hash,
+                                                      uint64_t* const index) {
+  if (mt == NULL || hash == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&mt->latest_milestone_lock);
+  memcpy(hash, mt->latest_milestone, FLEX_TRIT_SIZE_243);
+  if (index) {
+    *index = mt->latest_milestone_index;
+  }
+  lock_handle_unlock(&mt->latest_milestone_lock);
+
+  return RC_OK;
+}
+
 retcode_t iota_milestone_tracker_add_candidate(milestone_tracker_t* const mt, flex_trit_t const* const hash) {
   retcode_t ret = RC_OK;
 
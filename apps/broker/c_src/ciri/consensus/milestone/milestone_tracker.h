@@ -50,6 +50,8 @@ typedef struct milestone_tracker_s {
   cond_handle_t cond_validator;
   uint64_t latest_milestone_index;
   flex_trit_t latest_milestone[FLEX_TRIT_SIZE_243];
+  // Guards the latest milestone, read by other threads through iota_milestone_tracker_get_latest_milestone
+  lock_handle_t latest_milestone_lock;
   thread_handle_t milestone_solidifier;
   cond_handle_t cond_solidifier;
   uint64_t latest_solid_milestone_index;
@@ -112,6 +114,18 @@ retcode_t iota_milestone_tracker_destroy(milestone_tracker_t* const mt);
  */
 retcode_t iota_milestone_tracker_add_candidate(milestone_tracker_t* const mt, flex_trit_t const* const hash);
 
+/**
+ * Gets the latest milestone known to the milestone tracker
+ *
+ * @param mt The milestone tracker
+ * @param hash The latest milestone hash, null trits if none is known yet
+ * @param index The latest milestone index, may be NULL
+ *
+ * @return a status code
+ */
+retcode_t iota_milestone_tracker_get_latest_milestone(milestone_tracker_t* const mt, flex_trit_t* const hash,
+                                                      uint64_t* const index);
+
 uint64_t iota_milestone_tracker_get_milestone_index(iota_transaction_t* const tx);
 
 retcode_t iota_milestone_tracker_validate_milestone(milestone_tracker_t* const mt, tangle_t* const tangle,
@@ -12,6 +12,7 @@
 #include "utils/macros.h"
 
 #define SPENT_ADDRESSES_SERVICE_LOGGER_ID "spent_addresses_service"
+#define SPENT_ADDRESSES_SERVICE_BATCH_SIZE 8
 
 static logger_id_t logger_id;
 
@@ -118,8 +119,13 @@ retcode_t iota_spent_addresses_service_was_address_spent_from(spent_addresses_se
                                                               tangle_t const *const tangle,
                                                               flex_trit_t const *const address, bool *const spent) {
   retcode_t ret = RC_OK;
-  iota_stor_pack_t pack;
-  DECLARE_PACK_SINGLE_TX(tx, txp, tx_pack);
+  storage_cursor_t cursor;
+  iota_transaction_t *txs = NULL;
+  iota_transaction_t *txs_ptrs[SPENT_ADDRESSES_SERVICE_BATCH_SIZE];
+  iota_stor_pack_t pack = {.models = (void **)txs_ptrs,
+                           .capacity = SPENT_ADDRESSES_SERVICE_BATCH_SIZE,
+                           .num_loaded = 0,
+                           .insufficient_capacity = false};
 
   if (sas == NULL || sap == NULL || tangle == NULL || address == NULL || spent == NULL) {
     return RC_NULL_PARAM;
@@ -140,31 +146,36 @@ retcode_t iota_spent_addresses_service_was_address_spent_from(spent_addresses_se
     return RC_OK;
   }
 
-  hash_pack_init(&pack, 8);
-
-  if ((ret = iota_tangle_transaction_load_hashes_by_address(tangle, address, &pack)) != RC_OK) {
-    goto done;
+  if ((txs = (iota_transaction_t *)malloc(sizeof(iota_transaction_t) * SPENT_ADDRESSES_SERVICE_BATCH_SIZE)) == NULL) {
+    return RC_OOM;
+  }
+  for (size_t i = 0; i < SPENT_ADDRESSES_SERVICE_BATCH_SIZE; ++i) {
+    txs_ptrs[i] = &txs[i];
   }
 
   // TODO: If the hash set returned contains more than 100 000 entries, it likely will not be a spent address.
   // To avoid unnecessary overhead while processing, the loop will return false
 
-  for (size_t i = 0; i < pack.num_loaded; ++i) {
-    if ((ret = iota_tangle_transaction_load_partial(tangle, ((flex_trit_t **)(pack.models))[i], &tx_pack,
-                                                    PARTIAL_TX_MODEL_ESSENCE_METADATA)) != RC_OK) {
+  // The transactions of the address are streamed with their essence and metadata until a spending one is found
+  storage_cursor_init_hashes_by_address(&cursor, STORAGE_CURSOR_MODEL_ESSENCE_METADATA, address);
+  while (!cursor.done) {
+    hash_pack_reset(&pack);
+    if ((ret = iota_tangle_cursor_next(tangle, &cursor, &pack)) != RC_OK) {
       goto done;
     }
-    if ((ret = iota_spent_addresses_service_was_tx_spent_from(tangle, txp, ((flex_trit_t **)(pack.models))[i],
-                                                              spent)) != RC_OK) {
-      goto done;
-    }
-    if (*spent) {
-      goto done;
+    for (size_t i = 0; i < pack.num_loaded; ++i) {
+      if ((ret = iota_spent_addresses_service_was_tx_spent_from(tangle, txs_ptrs[i], transaction_hash(txs_ptrs[i]),
+                                                                spent)) != RC_OK) {
+        goto done;
+      }
+      if (*spent) {
+        goto done;
+      }
     }
   }
 
 done:
-  hash_pack_free(&pack);
+  free(txs);
 
   return ret;
 }
@@ -14,58 +14,127 @@
 
 static logger_id_t logger_id;
 
+/*
+ * Private functions
+ */
+
+// Reads go to the connection of the tangle, or through the pool of its database when there is one
+static inline storage_connection_t const *reader_get(tangle_t const *const tangle) {
+  return tangle->lease ? storage_pool_lease_read(tangle->lease) : &tangle->connection;
+}
+
+static inline void reader_done(tangle_t const *const tangle, storage_connection_t const *const connection) {
+  if (tangle->lease) {
+    storage_pool_lease_read_done(tangle->lease, connection);
+  }
+}
+
+static inline storage_connection_t const *writer_get(tangle_t const *const tangle) {
+  return tangle->lease ? storage_pool_lease_write(tangle->lease) : &tangle->connection;
+}
+
+static inline retcode_t writer_done(tangle_t const *const tangle, retcode_t const ret) {
+  return tangle->lease ? storage_pool_lease_write_done(tangle->lease, ret) : ret;
+}
+
+// Streams the hashes of a cursor into a pack, growing the pack instead of querying again when it is full
+static retcode_t cursor_load_hashes(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                    iota_stor_pack_t *const pack) {
+  retcode_t ret = RC_OK;
+
+  while (ret == RC_OK && !cursor->done) {
+    if (pack->num_loaded == pack->capacity && (ret = hash_pack_grow(pack, 2)) != RC_OK) {
+      break;
+    }
+    ret = iota_tangle_cursor_next(tangle, cursor, pack);
+  }
+  pack->insufficient_capacity = false;
+
+  return ret;
+}
+
+/*
+ * Public functions
+ */
+
 retcode_t iota_tangle_init(tangle_t *const tangle, connection_config_t const *const conf) {
+  storage_pool_t *pool = storage_pool_find(conf->db_path, STORAGE_CONNECTION_TANGLE);
+
   logger_id = logger_helper_enable(TANGLE_LOGGER_ID, LOGGER_DEBUG, true);
+  tangle->lease = NULL;
+  if (pool != NULL) {
+    return storage_pool_lease_acquire(pool, conf->write_batch_size >= 2, &tangle->lease);
+  }
   return connection_init(&tangle->connection, conf, STORAGE_CONNECTION_TANGLE);
 }
 
 retcode_t iota_tangle_destroy(tangle_t *const tangle) {
   logger_helper_release(logger_id);
+  if (tangle->lease) {
+    return storage_pool_lease_release(&tangle->lease);
+  }
   return connection_destroy(&tangle->connection);
 }
 
+retcode_t iota_tangle_flush(tangle_t const *const tangle) {
+  return tangle->lease ? storage_pool_lease_flush(tangle->lease) : connection_flush(&tangle->connection);
+}
+
+uint64_t iota_tangle_pending_batch(tangle_t const *const tangle) {
+  return tangle->lease ? tangle->lease->pending_batch : connection_pending_batch(&tangle->connection);
+}
+
 /*
  * Transaction operations
  */
 
 retcode_t iota_tangle_transaction_count(tangle_t const *const tangle, size_t *const count) {
-  return iota_stor_transaction_count(&tangle->connection, count);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_transaction_count(connection, count);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_store(tangle_t const *const tangle, iota_transaction_t const *const tx) {
-  return iota_stor_transaction_store(&tangle->connection, tx);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transaction_store(connection, tx);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle, transaction_field_t const field,
                                        flex_trit_t const *const key, iota_stor_pack_t *const tx) {
-  return iota_stor_transaction_load(&tangle->connection, field, key, tx);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_transaction_load(connection, field, key, tx);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_update_solid_state(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                      bool const state) {
-  return iota_stor_transaction_update_solid_state(&tangle->connection, hash, state);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transaction_update_solid_state(connection, hash, state);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_transactions_update_solid_state(tangle_t const *const tangle, hash243_set_t const hashes,
                                                       bool const is_solid) {
-  return iota_stor_transactions_update_solid_state(&tangle->connection, hashes, is_solid);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transactions_update_solid_state(connection, hashes, is_solid);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_transaction_load_hashes_by_address(tangle_t const *const tangle, flex_trit_t const *const address,
                                                          iota_stor_pack_t *const pack) {
+  storage_cursor_t cursor;
   retcode_t res = RC_OK;
 
-  res = iota_stor_transaction_load_hashes(&tangle->connection, TRANSACTION_FIELD_ADDRESS, address, pack);
-
-  while (res == RC_OK && pack->insufficient_capacity) {
-    res = hash_pack_resize(pack, 2);
-    if (res == RC_OK) {
-      pack->num_loaded = 0;
-      res = iota_stor_transaction_load_hashes(&tangle->connection, TRANSACTION_FIELD_ADDRESS, address, pack);
-    }
-  }
-
-  if (res != RC_OK) {
+  storage_cursor_init_hashes_by_address(&cursor, STORAGE_CURSOR_MODEL_HASH, address);
+  if ((res = cursor_load_hashes(tangle, &cursor, pack)) != RC_OK) {
     log_error(logger_id, "Failed in loading hashes, error code is: %" PRIu64 "\n", res);
   }
 
@@ -75,19 +144,11 @@ retcode_t iota_tangle_transaction_load_hashes_by_address(tangle_t const *const t
 retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const tangle,
                                                            flex_trit_t const *const approvee_hash,
                                                            iota_stor_pack_t *const pack, int64_t before_timestamp) {
+  storage_cursor_t cursor;
   retcode_t res = RC_OK;
 
-  res = iota_stor_transaction_load_hashes_of_approvers(&tangle->connection, approvee_hash, pack, before_timestamp);
-
-  while (res == RC_OK && pack->insufficient_capacity) {
-    res = hash_pack_resize(pack, 2);
-    if (res == RC_OK) {
-      pack->num_loaded = 0;
-      res = iota_stor_transaction_load_hashes_of_approvers(&tangle->connection, approvee_hash, pack, before_timestamp);
-    }
-  }
-
-  if (res != RC_OK) {
+  storage_cursor_init_hashes_of_approvers(&cursor, STORAGE_CURSOR_MODEL_HASH, approvee_hash, before_timestamp);
+  if ((res = cursor_load_hashes(tangle, &cursor, pack)) != RC_OK) {
     log_error(logger_id, "Failed in loading approvers, error code is: %" PRIu64 "\n", res);
   }
 
@@ -96,34 +157,38 @@ retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const
 
 retcode_t iota_tangle_transaction_load_partial(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask) {
+  storage_connection_t const *connection = NULL;
+  retcode_t ret = RC_OK;
+
+  if (models_mask != PARTIAL_TX_MODEL_METADATA && models_mask != PARTIAL_TX_MODEL_ESSENCE_METADATA &&
+      models_mask != PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA &&
+      models_mask != PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) {
+    return RC_CONSENSUS_NOT_IMPLEMENTED;
+  }
+
+  connection = reader_get(tangle);
   if (models_mask == PARTIAL_TX_MODEL_METADATA) {
-    return iota_stor_transaction_load_metadata(&tangle->connection, hash, pack);
+    ret = iota_stor_transaction_load_metadata(connection, hash, pack);
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_METADATA) {
-    return iota_stor_transaction_load_essence_and_metadata(&tangle->connection, hash, pack);
+    ret = iota_stor_transaction_load_essence_and_metadata(connection, hash, pack);
   } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA) {
-    return iota_stor_transaction_load_essence_attachment_and_metadata(&tangle->connection, hash, pack);
-  } else if (models_mask == PARTIAL_TX_MODEL_ESSENCE_CONSENSUS) {
-    return iota_stor_transaction_load_essence_and_consensus(&tangle->connection, hash, pack);
+    ret = iota_stor_transaction_load_essence_attachment_and_metadata(connection, hash, pack);
   } else {
-    return RC_CONSENSUS_NOT_IMPLEMENTED;
+    ret = iota_stor_transaction_load_essence_and_consensus(connection, hash, pack);
   }
+  reader_done(tangle, connection);
+
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(tangle_t const *const tangle,
                                                                       iota_stor_pack_t *const pack,
                                                                       flex_trit_t const *const coordinator) {
+  storage_cursor_t cursor;
   retcode_t res = RC_OK;
 
-  res = iota_stor_transaction_load_hashes_of_milestone_candidates(&tangle->connection, pack, coordinator);
-
-  while (res == RC_OK && pack->insufficient_capacity) {
-    if ((res = hash_pack_resize(pack, 2)) == RC_OK) {
-      pack->num_loaded = 0;
-      res = iota_stor_transaction_load_hashes_of_milestone_candidates(&tangle->connection, pack, coordinator);
-    }
-  }
-
-  if (res != RC_OK) {
+  storage_cursor_init_hashes_of_milestone_candidates(&cursor, STORAGE_CURSOR_MODEL_HASH, coordinator);
+  if ((res = cursor_load_hashes(tangle, &cursor, pack)) != RC_OK) {
     log_error(logger_id,
               "Failed in loading hashes of milestone candidates, error code "
               "is: %" PRIu64 "\n",
@@ -135,36 +200,73 @@ retcode_t iota_tangle_transaction_load_hashes_of_milestone_candidates(tangle_t c
 
 retcode_t iota_tangle_transaction_update_snapshot_index(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                         uint64_t const snapshot_index) {
-  return iota_stor_transaction_update_snapshot_index(&tangle->connection, hash, snapshot_index);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transaction_update_snapshot_index(connection, hash, snapshot_index);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_transactions_update_snapshot_index(tangle_t const *const tangle, hash243_set_t const hashes,
                                                          uint64_t const snapshot_index) {
-  return iota_stor_transactions_update_snapshot_index(&tangle->connection, hashes, snapshot_index);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transactions_update_snapshot_index(connection, hashes, snapshot_index);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_transaction_exist(tangle_t const *const tangle, transaction_field_t const field,
                                         flex_trit_t const *const key, bool *const exist) {
-  return iota_stor_transaction_exist(&tangle->connection, field, key, exist);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_transaction_exist(connection, field, key, exist);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_approvers_count(tangle_t const *const tangle, flex_trit_t const *const hash,
                                                   size_t *const count) {
-  return iota_stor_transaction_approvers_count(&tangle->connection, hash, count);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_transaction_approvers_count(connection, hash, count);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_transaction_find(tangle_t const *const tangle, hash243_queue_t const bundles,
                                        hash243_queue_t const addresses, hash81_queue_t const tags,
                                        hash243_queue_t const approvees, iota_stor_pack_t *const pack) {
-  return iota_stor_transaction_find(&tangle->connection, bundles, addresses, tags, approvees, pack);
+  storage_cursor_t cursor;
+
+  storage_cursor_init_find(&cursor, STORAGE_CURSOR_MODEL_HASH, bundles, addresses, tags, approvees);
+
+  return cursor_load_hashes(tangle, &cursor, pack);
 }
 
 retcode_t iota_tangle_transaction_metadata_clear(tangle_t const *const tangle) {
-  return iota_stor_transaction_metadata_clear(&tangle->connection);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transaction_metadata_clear(connection);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_transactions_delete(tangle_t const *const tangle, hash243_set_t const hashes) {
-  return iota_stor_transactions_delete(&tangle->connection, hashes);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_transactions_delete(connection, hashes);
+
+  return writer_done(tangle, ret);
+}
+
+/*
+ * Cursor operations
+ */
+
+retcode_t iota_tangle_cursor_next(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                  iota_stor_pack_t *const batch) {
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = storage_cursor_next(connection, cursor, batch);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 /*
@@ -173,7 +275,10 @@ retcode_t iota_tangle_transactions_delete(tangle_t const *const tangle, hash243_
 
 retcode_t iota_tangle_bundle_update_validity(tangle_t const *const tangle, bundle_transactions_t const *const bundle,
                                              bundle_status_t const status) {
-  return iota_stor_bundle_update_validity(&tangle->connection, bundle, status);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_bundle_update_validity(connection, bundle, status);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_bundle_load(tangle_t const *const tangle, flex_trit_t const *const tail_hash,
@@ -219,42 +324,75 @@ retcode_t iota_tangle_bundle_load(tangle_t const *const tangle, flex_trit_t cons
  */
 
 retcode_t iota_tangle_milestone_clear(tangle_t const *const tangle) {
-  return iota_stor_milestone_clear(&tangle->connection);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_milestone_clear(connection);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_milestone_store(tangle_t const *const tangle, iota_milestone_t const *const data_in) {
-  return iota_stor_milestone_store(&tangle->connection, data_in);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_milestone_store(connection, data_in);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_milestone_load(tangle_t const *const tangle, flex_trit_t const *const hash,
                                      iota_stor_pack_t *const pack) {
-  return iota_stor_milestone_load(&tangle->connection, hash, pack);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_milestone_load(connection, hash, pack);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_load_last(tangle_t const *const tangle, iota_stor_pack_t *const pack) {
-  return iota_stor_milestone_load_last(&tangle->connection, pack);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_milestone_load_last(connection, pack);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_load_first(tangle_t const *const tangle, iota_stor_pack_t *const pack) {
-  return iota_stor_milestone_load_first(&tangle->connection, pack);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_milestone_load_first(connection, pack);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_load_by_index(tangle_t const *const tangle, uint64_t const index,
                                               iota_stor_pack_t *const pack) {
-  return iota_stor_milestone_load_by_index(&tangle->connection, index, pack);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_milestone_load_by_index(connection, index, pack);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_load_next(tangle_t const *const tangle, uint64_t const index,
                                           iota_stor_pack_t *const pack) {
-  return iota_stor_milestone_load_next(&tangle->connection, index, pack);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_milestone_load_next(connection, index, pack);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_exist(tangle_t const *const tangle, flex_trit_t const *const hash, bool *const exist) {
-  return iota_stor_milestone_exist(&tangle->connection, hash, exist);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_milestone_exist(connection, hash, exist);
+
+  reader_done(tangle, connection);
+  return ret;
 }
 
 retcode_t iota_tangle_milestone_delete(tangle_t const *const tangle, flex_trit_t const *const hash) {
-  return iota_stor_milestone_delete(&tangle->connection, hash);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_milestone_delete(connection, hash);
+
+  return writer_done(tangle, ret);
 }
 
 /*
@@ -324,9 +462,16 @@ retcode_t iota_tangle_find_tail(tangle_t const *const tangle, flex_trit_t const
 
 retcode_t iota_tangle_state_delta_store(tangle_t const *const tangle, uint64_t const index,
                                         state_delta_t const *const delta) {
-  return iota_stor_state_delta_store(&tangle->connection, index, delta);
+  storage_connection_t const *connection = writer_get(tangle);
+  retcode_t ret = iota_stor_state_delta_store(connection, index, delta);
+
+  return writer_done(tangle, ret);
 }
 
 retcode_t iota_tangle_state_delta_load(tangle_t const *const tangle, uint64_t const index, state_delta_t *const delta) {
-  return iota_stor_state_delta_load(&tangle->connection, index, delta);
+  storage_connection_t const *connection = reader_get(tangle);
+  retcode_t ret = iota_stor_state_delta_load(connection, index, delta);
+
+  reader_done(tangle, connection);
+  return ret;
 }
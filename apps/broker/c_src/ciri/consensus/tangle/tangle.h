@@ -17,6 +17,7 @@
 #include "common/model/transaction.h"
 #include "common/storage/connection.h"
 #include "common/storage/defs.h"
+#include "common/storage/pool.h"
 #include "common/storage/storage.h"
 #include "common/trinary/flex_trit.h"
 #include "utils/containers/hash/hash243_queue.h"
@@ -29,6 +30,8 @@ extern "C" {
 
 typedef struct tangle_s {
   storage_connection_t connection;
+  // Set when the database has a connection pool, in place of the connection
+  storage_pool_lease_t *lease;
 } tangle_t;
 
 typedef enum _partial_transaction_model {
@@ -43,6 +46,12 @@ retcode_t iota_tangle_init(tangle_t *const tangle, connection_config_t const *co
 
 retcode_t iota_tangle_destroy(tangle_t *const tangle);
 
+// Commits the writes group-committed so far, see connection_config_t
+retcode_t iota_tangle_flush(tangle_t const *const tangle);
+
+// Identifies the group commit holding the writes of the tangle, only readable through it, 0 once they are committed
+uint64_t iota_tangle_pending_batch(tangle_t const *const tangle);
+
 /*
  * Transaction operations
  */
@@ -54,10 +63,29 @@ retcode_t iota_tangle_transaction_store(tangle_t const *const tangle, iota_trans
 retcode_t iota_tangle_transaction_load(tangle_t const *const tangle, transaction_field_t const field,
                                        flex_trit_t const *const key, iota_stor_pack_t *const tx);
 
+/**
+ * Loads the hashes of the approvers of a transaction after the ones already in the pack, growing it as needed
+ *
+ * @param tangle The tangle
+ * @param approvee_hash The hash of the approved transaction
+ * @param pack A pack to be filled with hashes
+ * @param before_timestamp Only the approvers arrived before this timestamp, 0 for all
+ *
+ * @return a status code
+ */
 retcode_t iota_tangle_transaction_load_hashes_of_approvers(tangle_t const *const tangle,
                                                            flex_trit_t const *const approvee_hash,
                                                            iota_stor_pack_t *const pack, int64_t before_timestamp);
 
+/**
+ * Loads the hashes of the transactions of an address after the ones already in the pack, growing it as needed
+ *
+ * @param tangle The tangle
+ * @param address The address
+ * @param pack A pack to be filled with hashes
+ *
+ * @return a status code
+ */
 retcode_t iota_tangle_transaction_load_hashes_by_address(tangle_t const *const tangle, flex_trit_t const *const address,
                                                          iota_stor_pack_t *const pack);
 
@@ -76,10 +104,11 @@ retcode_t iota_tangle_transaction_load_partial(tangle_t const *const tangle, fle
                                                iota_stor_pack_t *const pack, partial_transaction_model_e models_mask);
 
 /**
- * Loads hashes of milestone candidates
+ * Loads hashes of milestone candidates, growing the pack as needed
  *
  * @param tangle The tangle
  * @param pack A pack to be filled with hashes
+ * @param coordinator The coordinator address
  *
  * @return a status code
  */
@@ -119,7 +148,7 @@ retcode_t iota_tangle_transactions_delete(tangle_t const *const tangle, hash243_
  * @param addresses List of addresses
  * @param tags List of tags
  * @param approvees List of approvee transaction hashes
- * @param pack A pack to be filled with hashes
+ * @param pack A pack to be filled with hashes, grown as needed
  *
  * @return a status code
  */
@@ -127,6 +156,24 @@ retcode_t iota_tangle_transaction_find(tangle_t const *const tangle, hash243_que
                                        hash243_queue_t const addresses, hash81_queue_t const tags,
                                        hash243_queue_t const approvees, iota_stor_pack_t *const pack);
 
+/*
+ * Cursor operations
+ */
+
+/**
+ * Loads the next batch of a cursor through a reader of the tangle, see storage_cursor_next
+ *
+ * The reader is only held for the batch, so that large result sets can be walked without pinning it.
+ *
+ * @param tangle The tangle
+ * @param cursor The cursor
+ * @param batch A pack to be filled with the models of the cursor
+ *
+ * @return a status code
+ */
+retcode_t iota_tangle_cursor_next(tangle_t const *const tangle, storage_cursor_t *const cursor,
+                                  iota_stor_pack_t *const batch);
+
 /*
  * Bundle operations
  */
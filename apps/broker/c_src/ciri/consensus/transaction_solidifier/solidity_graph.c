@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ciri/consensus/transaction_solidifier/solidity_graph.h"
+
+/*
+ * Private functions
+ */
+
+static solidity_graph_vertex_t *solidity_graph_find(solidity_graph_t const *const graph,
+                                                    flex_trit_t const *const hash) {
+  solidity_graph_vertex_t *vertex = NULL;
+
+  HASH_FIND(hh, graph->vertices, hash, FLEX_TRIT_SIZE_243, vertex);
+
+  return vertex;
+}
+
+static solidity_graph_vertex_t *solidity_graph_find_or_add(solidity_graph_t *const graph,
+                                                           flex_trit_t const *const hash) {
+  solidity_graph_vertex_t *vertex = solidity_graph_find(graph, hash);
+
+  if (vertex == NULL && (vertex = (solidity_graph_vertex_t *)calloc(1, sizeof(solidity_graph_vertex_t))) != NULL) {
+    memcpy(vertex->hash, hash, FLEX_TRIT_SIZE_243);
+    HASH_ADD(hh, graph->vertices, hash, FLEX_TRIT_SIZE_243, vertex);
+  }
+
+  return vertex;
+}
+
+/**
+ * Unlinks a vertex from the approvers lists of the approvees it waits for
+ */
+static void solidity_graph_unlink(solidity_graph_vertex_t *const vertex) {
+  solidity_graph_edge_t **link = NULL;
+
+  for (size_t i = 0; i < 2; i++) {
+    if (vertex->approvees[i].approvee == NULL) {
+      continue;
+    }
+    link = &vertex->approvees[i].approvee->approvers;
+    while (*link != &vertex->approvees[i]) {
+      link = &(*link)->next;
+    }
+    *link = vertex->approvees[i].next;
+    vertex->approvees[i].approvee = NULL;
+  }
+  vertex->unsolid_approvees = 0;
+}
+
+static void solidity_graph_remove(solidity_graph_t *const graph, solidity_graph_vertex_t *const vertex) {
+  solidity_graph_unlink(vertex);
+  if (vertex->stored) {
+    graph->stored--;
+  }
+  HASH_DEL(graph->vertices, vertex);
+  free(vertex);
+}
+
+/**
+ * Removes a vertex that became solid and, transitively, the approvers it was the last unsolid approvee of
+ */
+static retcode_t solidity_graph_propagate(solidity_graph_t *const graph, solidity_graph_vertex_t *const vertex,
+                                          hash243_set_t *const solid) {
+  retcode_t ret = RC_OK;
+  solidity_graph_vertex_t *stack = vertex;
+  solidity_graph_vertex_t *current = NULL;
+  solidity_graph_edge_t *edge = NULL;
+  solidity_graph_edge_t *next = NULL;
+
+  vertex->next_solid = NULL;
+  while ((current = stack) != NULL) {
+    stack = current->next_solid;
+    // The vertex leaves the graph anyway so that its approvers can't wait for it forever
+    if (ret == RC_OK) {
+      ret = hash243_set_add(solid, current->hash);
+    }
+    // Approvers are only freed once popped, after this list has been walked
+    for (edge = current->approvers; edge != NULL; edge = next) {
+      next = edge->next;
+      edge->approvee = NULL;
+      if (--edge->approver->unsolid_approvees == 0) {
+        edge->approver->next_solid = stack;
+        stack = edge->approver;
+      }
+    }
+    solidity_graph_remove(graph, current);
+  }
+
+  return ret;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t solidity_graph_init(solidity_graph_t *const graph) {
+  if (graph == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  graph->vertices = NULL;
+  graph->stored = 0;
+
+  return RC_OK;
+}
+
+retcode_t solidity_graph_destroy(solidity_graph_t *const graph) {
+  solidity_graph_vertex_t *vertex = NULL;
+  solidity_graph_vertex_t *tmp = NULL;
+
+  if (graph == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  HASH_ITER(hh, graph->vertices, vertex, tmp) {
+    HASH_DEL(graph->vertices, vertex);
+    free(vertex);
+  }
+  graph->stored = 0;
+
+  return RC_OK;
+}
+
+retcode_t solidity_graph_add(solidity_graph_t *const graph, flex_trit_t const *const hash,
+                             flex_trit_t const *const trunk, bool const trunk_solid, flex_trit_t const *const branch,
+                             bool const branch_solid, hash243_set_t *const solid) {
+  solidity_graph_vertex_t *vertex = NULL;
+  solidity_graph_vertex_t *approvee = NULL;
+  flex_trit_t const *approvees[2] = {trunk, branch};
+  bool const approvees_solid[2] = {trunk_solid, branch_solid};
+
+  if (graph == NULL || hash == NULL || trunk == NULL || branch == NULL || solid == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((vertex = solidity_graph_find_or_add(graph, hash)) == NULL) {
+    return RC_OOM;
+  } else if (vertex->stored) {
+    return RC_OK;
+  }
+
+  // Approvee vertices are created before linking anything so that running out of memory leaves the graph unchanged
+  for (size_t i = 0; i < 2; i++) {
+    if (!approvees_solid[i] && solidity_graph_find_or_add(graph, approvees[i]) == NULL) {
+      if (vertex->approvers == NULL) {
+        HASH_DEL(graph->vertices, vertex);
+        free(vertex);
+      }
+      return RC_OOM;
+    }
+  }
+
+  vertex->stored = true;
+  graph->stored++;
+  for (size_t i = 0; i < 2; i++) {
+    if (!approvees_solid[i]) {
+      approvee = solidity_graph_find(graph, approvees[i]);
+      vertex->approvees[i].approver = vertex;
+      vertex->approvees[i].approvee = approvee;
+      vertex->approvees[i].next = approvee->approvers;
+      approvee->approvers = &vertex->approvees[i];
+      vertex->unsolid_approvees++;
+    }
+  }
+
+  if (vertex->unsolid_approvees == 0) {
+    return solidity_graph_propagate(graph, vertex, solid);
+  }
+
+  return RC_OK;
+}
+
+retcode_t solidity_graph_set_solid(solidity_graph_t *const graph, flex_trit_t const *const hash,
+                                   hash243_set_t *const solid) {
+  solidity_graph_vertex_t *vertex = NULL;
+
+  if (graph == NULL || hash == NULL || solid == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((vertex = solidity_graph_find(graph, hash)) == NULL) {
+    return RC_OK;
+  }
+
+  // Its approvees may never become solid in the graph, they don't hold it anymore
+  solidity_graph_unlink(vertex);
+
+  return solidity_graph_propagate(graph, vertex, solid);
+}
+
+size_t solidity_graph_evict(solidity_graph_t *const graph, size_t const max_size) {
+  solidity_graph_vertex_t *vertex = NULL;
+  solidity_graph_vertex_t *tmp = NULL;
+  size_t evicted = 0;
+
+  if (graph == NULL) {
+    return 0;
+  }
+
+  // Only the current vertex is freed while iterating, the approvees it leaves without approvers are freed afterwards
+  HASH_ITER(hh, graph->vertices, vertex, tmp) {
+    if (HASH_COUNT(graph->vertices) <= max_size) {
+      break;
+    } else if (vertex->approvers == NULL) {
+      solidity_graph_remove(graph, vertex);
+      evicted++;
+    }
+  }
+
+  HASH_ITER(hh, graph->vertices, vertex, tmp) {
+    if (!vertex->stored && vertex->approvers == NULL) {
+      solidity_graph_remove(graph, vertex);
+      evicted++;
+    }
+  }
+
+  return evicted;
+}
+
+size_t solidity_graph_unsolid_approvees(solidity_graph_t const *const graph, flex_trit_t const *const hash,
+                                        flex_trit_t approvees[][FLEX_TRIT_SIZE_243]) {
+  solidity_graph_vertex_t *vertex = NULL;
+  size_t count = 0;
+
+  if (graph == NULL || hash == NULL || (vertex = solidity_graph_find(graph, hash)) == NULL || !vertex->stored) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < 2; i++) {
+    if (vertex->approvees[i].approvee != NULL) {
+      memcpy(approvees[count++], vertex->approvees[i].approvee->hash, FLEX_TRIT_SIZE_243);
+    }
+  }
+
+  return count;
+}
+
+bool solidity_graph_contains(solidity_graph_t const *const graph, flex_trit_t const *const hash, bool *const stored) {
+  solidity_graph_vertex_t *vertex = NULL;
+
+  if (graph == NULL || hash == NULL) {
+    return false;
+  }
+
+  vertex = solidity_graph_find(graph, hash);
+  if (stored) {
+    *stored = vertex != NULL && vertex->stored;
+  }
+
+  return vertex != NULL;
+}
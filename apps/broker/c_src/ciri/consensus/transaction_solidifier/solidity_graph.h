@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __CONSENSUS_TRANSACTION_SOLIDIFIER_SOLIDITY_GRAPH_H__
+#define __CONSENSUS_TRANSACTION_SOLIDIFIER_SOLIDITY_GRAPH_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "uthash.h"
+
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/hash/hash243_set.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct solidity_graph_vertex_s solidity_graph_vertex_t;
+
+// Links an approver into the list of approvers waiting for one of its approvees
+typedef struct solidity_graph_edge_s {
+  solidity_graph_vertex_t *approver;
+  // The approvee waited for, NULL once solid
+  solidity_graph_vertex_t *approvee;
+  struct solidity_graph_edge_s *next;
+} solidity_graph_edge_t;
+
+struct solidity_graph_vertex_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  // Whether the transaction is stored, a vertex that isn't only holds the approvers waiting for it
+  bool stored;
+  // Number of edges towards approvees that aren't solid yet
+  uint8_t unsolid_approvees;
+  // Trunk and branch slots, each linked into the approvers list of its approvee while the approvee isn't solid
+  solidity_graph_edge_t approvees[2];
+  // Approvers waiting for this vertex to become solid
+  solidity_graph_edge_t *approvers;
+  // Next vertex to propagate solidity from
+  solidity_graph_vertex_t *next_solid;
+  UT_hash_handle hh;
+};
+
+/**
+ * An in-memory DAG of the transactions that are not solid yet, indexed by hash.
+ *
+ * Each stored transaction counts its approvees that are not solid yet. When a transaction becomes solid, the counters
+ * of its approvers are decremented and those reaching zero become solid in turn, so that solidification costs one step
+ * per edge instead of a database traversal. Solid transactions leave the graph. The graph is not thread safe.
+ * Vertices are kept in insertion order, the oldest ones without approvers being evicted first.
+ */
+typedef struct solidity_graph_s {
+  solidity_graph_vertex_t *vertices;
+  size_t stored;
+} solidity_graph_t;
+
+/**
+ * Initializes a solidity graph
+ *
+ * @param graph The graph
+ *
+ * @return a status code
+ */
+retcode_t solidity_graph_init(solidity_graph_t *const graph);
+
+/**
+ * Frees all vertices of a solidity graph
+ *
+ * @param graph The graph
+ *
+ * @return a status code
+ */
+retcode_t solidity_graph_destroy(solidity_graph_t *const graph);
+
+/**
+ * Adds a stored transaction that is not solid yet, waiting for those of its approvees that are not solid either.
+ * If both approvees are solid, the transaction and the approvers waiting for it become solid.
+ *
+ * @param graph         The graph
+ * @param hash          The transaction hash
+ * @param trunk         The trunk hash
+ * @param trunk_solid   Whether the trunk is solid
+ * @param branch        The branch hash
+ * @param branch_solid  Whether the branch is solid
+ * @param solid         A set the hashes of the transactions that became solid are added to
+ *
+ * @return a status code
+ */
+retcode_t solidity_graph_add(solidity_graph_t *const graph, flex_trit_t const *const hash,
+                             flex_trit_t const *const trunk, bool const trunk_solid, flex_trit_t const *const branch,
+                             bool const branch_solid, hash243_set_t *const solid);
+
+/**
+ * Marks a tracked transaction as solid, found solid outside of the graph. The transaction and the approvers waiting for
+ * it become solid.
+ *
+ * @param graph The graph
+ * @param hash  The transaction hash
+ * @param solid A set the hashes of the transactions that became solid are added to
+ *
+ * @return a status code
+ */
+retcode_t solidity_graph_set_solid(solidity_graph_t *const graph, flex_trit_t const *const hash,
+                                   hash243_set_t *const solid);
+
+/**
+ * Removes the oldest vertices that no approver waits for until the graph holds at most max_size vertices, along with
+ * the awaited approvees left without approvers. A removed transaction is linked again the next time it is solidified.
+ *
+ * @param graph     The graph
+ * @param max_size  The number of vertices to keep at most
+ *
+ * @return the number of removed vertices
+ */
+size_t solidity_graph_evict(solidity_graph_t *const graph, size_t const max_size);
+
+/**
+ * Gets the approvees a stored transaction still waits for
+ *
+ * @param graph     The graph
+ * @param hash      The transaction hash
+ * @param approvees The approvees, up to two
+ *
+ * @return the number of approvees, 0 if the transaction is not stored in the graph
+ */
+size_t solidity_graph_unsolid_approvees(solidity_graph_t const *const graph, flex_trit_t const *const hash,
+                                        flex_trit_t approvees[][FLEX_TRIT_SIZE_243]);
+
+/**
+ * Tells whether a transaction is tracked by a solidity graph, either stored or awaited by an approver
+ *
+ * @param graph   The graph
+ * @param hash    The transaction hash
+ * @param stored  Whether the transaction is stored, may be NULL
+ *
+ * @return true if the transaction is tracked
+ */
+bool solidity_graph_contains(solidity_graph_t const *const graph, flex_trit_t const *const hash, bool *const stored);
+
+/**
+ * Gives the number of vertices of a solidity graph, stored transactions and awaited approvees
+ *
+ * @param graph The graph
+ *
+ * @return the number of vertices
+ */
+static inline size_t solidity_graph_size(solidity_graph_t const *const graph) { return HASH_COUNT(graph->vertices); }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __CONSENSUS_TRANSACTION_SOLIDIFIER_SOLIDITY_GRAPH_H__
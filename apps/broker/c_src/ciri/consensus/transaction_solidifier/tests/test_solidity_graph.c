@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/transaction_solidifier/solidity_graph.h"
+
+#define HASHES_NUM 8
+
+static solidity_graph_t graph;
+static hash243_set_t solid;
+static flex_trit_t hashes[HASHES_NUM][FLEX_TRIT_SIZE_243];
+
+void setUp(void) {
+  TEST_ASSERT(solidity_graph_init(&graph) == RC_OK);
+  solid = NULL;
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    memset(hashes[i], i + 1, FLEX_TRIT_SIZE_243);
+  }
+}
+
+void tearDown(void) {
+  TEST_ASSERT(solidity_graph_destroy(&graph) == RC_OK);
+  hash243_set_free(&solid);
+}
+
+void test_solidity_graph_solid_approvees(void) {
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[0], hashes[1], true, hashes[2], true, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 1);
+  TEST_ASSERT_TRUE(hash243_set_contains(solid, hashes[0]));
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 0);
+  TEST_ASSERT_FALSE(solidity_graph_contains(&graph, hashes[0], NULL));
+}
+
+void test_solidity_graph_missing_approvee(void) {
+  bool stored = true;
+
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[0], hashes[1], false, hashes[2], true, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 0);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 2);
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[0], &stored));
+  TEST_ASSERT_TRUE(stored);
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[1], &stored));
+  TEST_ASSERT_FALSE(stored);
+
+  // Adding a stored transaction again changes nothing
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[0], hashes[1], false, hashes[2], true, &solid) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 2);
+
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[1], hashes[3], true, hashes[3], true, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 2);
+  TEST_ASSERT_TRUE(hash243_set_contains(solid, hashes[0]));
+  TEST_ASSERT_TRUE(hash243_set_contains(solid, hashes[1]));
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 0);
+  TEST_ASSERT_EQUAL_INT(graph.stored, 0);
+}
+
+void test_solidity_graph_propagation(void) {
+  // 4 approves 2 and 3 which both approve 1, 5 approves 4 twice, 6 approves 5 and the missing 7
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[4], hashes[2], false, hashes[3], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[5], hashes[4], false, hashes[4], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[6], hashes[5], false, hashes[7], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[2], hashes[1], false, hashes[0], true, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[3], hashes[0], true, hashes[1], false, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 0);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 7);
+  TEST_ASSERT_EQUAL_INT(graph.stored, 5);
+
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[1], hashes[0], true, hashes[0], true, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 5);
+  for (size_t i = 1; i <= 5; i++) {
+    TEST_ASSERT_TRUE(hash243_set_contains(solid, hashes[i]));
+  }
+  TEST_ASSERT_FALSE(hash243_set_contains(solid, hashes[6]));
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 2);
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[6], NULL));
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[7], NULL));
+
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[7], hashes[0], true, hashes[0], true, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 7);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 0);
+}
+
+void test_solidity_graph_set_solid(void) {
+  flex_trit_t approvees[2][FLEX_TRIT_SIZE_243];
+
+  // 2 approves 1 and the missing 0, 3 approves 2 and the missing 4
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[2], hashes[1], false, hashes[0], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[3], hashes[2], false, hashes[4], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[1], hashes[0], false, hashes[0], false, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(solidity_graph_unsolid_approvees(&graph, hashes[2], approvees), 2);
+  TEST_ASSERT_EQUAL_MEMORY(approvees[0], hashes[1], FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(approvees[1], hashes[0], FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_unsolid_approvees(&graph, hashes[0], approvees), 0);
+
+  // Found solid in the database while its approvee 0 is still missing in the graph
+  TEST_ASSERT(solidity_graph_set_solid(&graph, hashes[1], &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 1);
+  TEST_ASSERT_TRUE(hash243_set_contains(solid, hashes[1]));
+  TEST_ASSERT_EQUAL_INT(solidity_graph_unsolid_approvees(&graph, hashes[2], approvees), 1);
+  TEST_ASSERT_EQUAL_MEMORY(approvees[0], hashes[0], FLEX_TRIT_SIZE_243);
+
+  TEST_ASSERT(solidity_graph_set_solid(&graph, hashes[0], &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 3);
+  TEST_ASSERT_TRUE(hash243_set_contains(solid, hashes[2]));
+  TEST_ASSERT_FALSE(hash243_set_contains(solid, hashes[3]));
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 2);
+  TEST_ASSERT_EQUAL_INT(graph.stored, 1);
+
+  // Unknown transactions are ignored
+  TEST_ASSERT(solidity_graph_set_solid(&graph, hashes[5], &solid) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 2);
+}
+
+void test_solidity_graph_evict(void) {
+  // 2 approves the missing 1 twice, 3 approves 2 and the missing 0, 5 approves the missing 4 and 0
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[2], hashes[1], false, hashes[1], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[3], hashes[2], false, hashes[0], false, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[5], hashes[4], false, hashes[0], false, &solid) == RC_OK);
+
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 6);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_evict(&graph, 6), 0);
+
+  // 3 is the oldest vertex without approvers, the missing 0 is still awaited by 5
+  TEST_ASSERT_EQUAL_INT(solidity_graph_evict(&graph, 5), 1);
+  TEST_ASSERT_FALSE(solidity_graph_contains(&graph, hashes[3], NULL));
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[0], NULL));
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[2], NULL));
+
+  // Evicting 2 leaves the missing 1 without approvers
+  TEST_ASSERT_EQUAL_INT(solidity_graph_evict(&graph, 3), 2);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 3);
+  TEST_ASSERT_FALSE(solidity_graph_contains(&graph, hashes[1], NULL));
+  TEST_ASSERT_TRUE(solidity_graph_contains(&graph, hashes[5], NULL));
+
+  // Evicting 5 leaves the missing 4 and 0 without approvers
+  TEST_ASSERT_EQUAL_INT(solidity_graph_evict(&graph, 0), 3);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 0);
+  TEST_ASSERT_EQUAL_INT(graph.stored, 0);
+
+  // An evicted transaction is linked again
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[3], hashes[2], false, hashes[0], true, &solid) == RC_OK);
+  TEST_ASSERT(solidity_graph_add(&graph, hashes[2], hashes[1], true, hashes[1], true, &solid) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(hash243_set_size(solid), 2);
+  TEST_ASSERT_EQUAL_INT(solidity_graph_size(&graph), 0);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_solidity_graph_solid_approvees);
+  RUN_TEST(test_solidity_graph_missing_approvee);
+  RUN_TEST(test_solidity_graph_propagation);
+  RUN_TEST(test_solidity_graph_set_solid);
+  RUN_TEST(test_solidity_graph_evict);
+
+  return UNITY_END();
+}
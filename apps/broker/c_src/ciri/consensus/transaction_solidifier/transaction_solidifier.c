@@ -5,91 +5,259 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include "utarray.h"
+
 #include "ciri/consensus/transaction_solidifier/transaction_solidifier.h"
-#include "ciri/consensus/tangle/traversal.h"
 #include "utils/logger_helper.h"
 
 #define TRANSACTION_SOLIDIFIER_LOGGER_ID "transaction_solidifier"
-#define SOLID_PROPAGATION_INTERVAL_MS 500uLL
+#define SOLID_STATE_FLUSH_INTERVAL_MS 500uLL
+// Number of solid states waiting to be persisted that wakes the flushing thread up before its interval elapses
+#define SOLID_STATE_FLUSH_BATCH_SIZE 512
+// Transactions loaded at most to link a new transaction to the solidity graph
+#define UPDATE_STATUS_MAX_ANALYZED 50000
+// Vertices of the solidity graph beyond which the oldest ones are evicted, down to SOLIDITY_GRAPH_EVICTED_SIZE
+#define SOLIDITY_GRAPH_MAX_SIZE 500000
+#define SOLIDITY_GRAPH_EVICTED_SIZE 400000
 
 static logger_id_t logger_id;
 
 /*
- * Forward declarations
+ * Private functions
  */
 
-static retcode_t check_approvee_solid_state(transaction_solidifier_t *const ts, tangle_t *const tangle,
-                                            flex_trit_t *const approvee, bool *solid);
-
-static retcode_t check_transaction_and_update_solid_state(transaction_solidifier_t *const ts, tangle_t *const tangle,
-                                                          flex_trit_t *const transaction, bool *const is_new_solid);
+typedef struct solidity_candidate_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t trunk[FLEX_TRIT_SIZE_243];
+  flex_trit_t branch[FLEX_TRIT_SIZE_243];
+} solidity_candidate_t;
 
-static retcode_t add_new_solid_transaction(transaction_solidifier_t *const ts, flex_trit_t *const hash);
+static UT_icd solidity_candidate_icd = {sizeof(solidity_candidate_t), NULL, NULL, NULL};
 
-static retcode_t check_solidity_do_func(flex_trit_t *hash, iota_stor_pack_t *pack, void *data, bool *should_branch,
-                                        bool *should_stop);
-
-/*
- * Private functions
+/**
+ * Tells whether a transaction is known to be solid without loading it, ts->lock held
  */
+static bool is_known_solid(transaction_solidifier_t *const ts, flex_trit_t const *const hash) {
+  return memcmp(hash, ts->conf->genesis_hash, FLEX_TRIT_SIZE_243) == 0 ||
+         hash243_set_contains(ts->newly_set_solid_transactions, hash) ||
+         hash243_set_contains(ts->flushing_solid_transactions, hash) ||
+         hash243_set_contains(ts->pending_solid_transactions, hash) ||
+         hash243_set_contains(ts->committing_solid_transactions, hash) ||
+         iota_snapshot_has_solid_entry_point(&ts->snapshots_provider->initial_snapshot, hash);
+}
 
-typedef struct check_solidity_do_func_params_s {
-  transaction_solidifier_t *ts;
-  tangle_t *tangle;
-  bool is_solid;
-  hash243_set_t *solid_transactions_candidates;
-  hash243_set_t *solid_entry_points;
-  int max_analyzed;
-} check_solidity_do_func_params_t;
-
-static retcode_t propagate_solid_transactions(transaction_solidifier_t *const ts, tangle_t *const tangle) {
+/**
+ * Persists the solid states of the transactions that became solid since the last flush
+ */
+static retcode_t flush_solid_transactions(transaction_solidifier_t *const ts, tangle_t *const tangle) {
   retcode_t ret = RC_OK;
-  hash243_set_t transactions_to_propagate = NULL;
-  hash243_set_entry_t *curr_entry = NULL;
-  hash243_set_entry_t *tmp_entry = NULL;
-  flex_trit_t *approver_hash = NULL;
-  iota_stor_pack_t hash_pack;
+
+  lock_handle_lock(&ts->flush_lock);
 
   lock_handle_lock(&ts->lock);
-  transactions_to_propagate = ts->newly_set_solid_transactions;
+  ts->flushing_solid_transactions = ts->newly_set_solid_transactions;
   ts->newly_set_solid_transactions = NULL;
   lock_handle_unlock(&ts->lock);
 
-  if ((ret = hash_pack_init(&hash_pack, 32)) != RC_OK) {
-    goto done;
+  // Still readable by is_known_solid until the database is updated
+  if (ts->flushing_solid_transactions != NULL &&
+      (ret = iota_tangle_transactions_update_solid_state(tangle, ts->flushing_solid_transactions, true)) != RC_OK) {
+    log_error(logger_id, "Persisting %d solid states failed\n", hash243_set_size(ts->flushing_solid_transactions));
   }
 
-  HASH_ITER(hh, transactions_to_propagate, curr_entry, tmp_entry) {
-    if (!ts->running) {
-      break;
+  lock_handle_lock(&ts->lock);
+  if (ret != RC_OK) {
+    hash243_set_append(&ts->flushing_solid_transactions, &ts->newly_set_solid_transactions);
+  }
+  hash243_set_free(&ts->flushing_solid_transactions);
+  lock_handle_unlock(&ts->lock);
+
+  lock_handle_unlock(&ts->flush_lock);
+
+  return ret;
+}
+
+/**
+ * Loads a transaction the graph doesn't hold as stored, ts->lock not held
+ *
+ * @param ts            The transaction solidifier
+ * @param tangle        A tangle
+ * @param hash          The transaction hash
+ * @param candidates    The candidates, the transaction is added to if it is stored but not solid
+ * @param loaded_solid  The loaded transactions that are solid, the transaction is added to if it is
+ * @param walk          The transactions to walk, the approvees of the transaction are pushed to if it is a candidate
+ * @param request       Whether the transaction is requested if it is not stored
+ * @param milestone_index The index of the milestone waiting for the transaction, prioritizing its request
+ *
+ * @return a status code
+ */
+static retcode_t load_candidate(transaction_solidifier_t *const ts, tangle_t *const tangle,
+                                flex_trit_t const *const hash, UT_array *const candidates,
+                                hash243_set_t *const loaded_solid, hash243_stack_t *const walk, bool const request,
+                                uint64_t const milestone_index) {
+  retcode_t ret = RC_OK;
+  DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
+  solidity_candidate_t candidate;
+
+  if ((ret = iota_tangle_transaction_load_partial(tangle, (flex_trit_t *)hash, &pack,
+                                                  PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA)) != RC_OK) {
+    log_error(logger_id, "Loading transaction for checking its solid state failed\n");
+    return ret;
+  }
+
+  if (pack.num_loaded == 0) {
+    // Awaited by the graph until stored
+    if (request && ts->transaction_requester != NULL) {
+      return request_transaction(ts->transaction_requester, tangle, hash, milestone_index);
     }
+    return RC_OK;
+  } else if (transaction_solid(curr_tx)) {
+    return hash243_set_add(loaded_solid, hash);
+  }
+
+  memcpy(candidate.hash, hash, FLEX_TRIT_SIZE_243);
+  memcpy(candidate.trunk, transaction_trunk(curr_tx), FLEX_TRIT_SIZE_243);
+  memcpy(candidate.branch, transaction_branch(curr_tx), FLEX_TRIT_SIZE_243);
+  utarray_push_back(candidates, &candidate);
+
+  if ((ret = hash243_stack_push(walk, candidate.trunk)) != RC_OK) {
+    return ret;
+  }
+  return hash243_stack_push(walk, candidate.branch);
+}
 
-    hash_pack_reset(&hash_pack);
-    if ((ret = iota_tangle_transaction_load_hashes_of_approvers(tangle, curr_entry->hash, &hash_pack, 0)) != RC_OK) {
-      log_error(logger_id,
-                "Loading hashes of approvers while propagating "
-                "solidity failed\n");
+/**
+ * Tells whether an approvee is solid when linking a candidate, ts->lock held
+ */
+static bool is_approvee_solid(transaction_solidifier_t *const ts, flex_trit_t const *const hash,
+                              hash243_set_t const loaded_solid, hash243_set_t const solid) {
+  return hash243_set_contains(loaded_solid, hash) || hash243_set_contains(solid, hash) || is_known_solid(ts, hash);
+}
+
+/**
+ * Links a transaction and its stored ancestors that the graph doesn't hold as stored, then propagates solidity from
+ * those whose approvees are solid. Transactions are loaded without holding ts->lock, once, the first time the graph
+ * gets to know them, after which the solidification of their approvees reaches them in memory.
+ *
+ * When requesting, the walk also goes through the stored transactions the graph already holds to reach the approvees
+ * they still wait for: those are loaded again and requested while missing, so that an approvee first linked without
+ * being requested, or evicted since, doesn't hold the transaction back forever.
+ *
+ * @param ts            The transaction solidifier
+ * @param tangle        A tangle
+ * @param hash          The transaction hash
+ * @param max_analyzed  The maximum number of transactions loaded, those loaded until then are linked anyway
+ * @param request       Whether the ancestors that are not stored are requested
+ * @param milestone_index The index of the milestone waiting for the transaction, prioritizing the requests
+ * @param is_solid      Whether the transaction is solid
+ *
+ * @return a status code
+ */
+static retcode_t solidify(transaction_solidifier_t *const ts, tangle_t *const tangle, flex_trit_t const *const hash,
+                          int const max_analyzed, bool const request, uint64_t const milestone_index,
+                          bool *const is_solid) {
+  retcode_t ret = RC_OK;
+  UT_array *candidates = NULL;
+  hash243_stack_t walk = NULL;
+  hash243_set_t visited = NULL;
+  hash243_set_t loaded_solid = NULL;
+  hash243_set_t solid = NULL;
+  hash243_set_entry_t *entry = NULL;
+  hash243_set_entry_t *tmp = NULL;
+  solidity_candidate_t *candidate = NULL;
+  flex_trit_t current[FLEX_TRIT_SIZE_243];
+  flex_trit_t approvees[2][FLEX_TRIT_SIZE_243];
+  size_t approvees_count = 0;
+  bool known_solid = false;
+  bool tracked = false;
+  bool stored = false;
+  int loaded = 0;
+
+  *is_solid = false;
+  utarray_new(candidates, &solidity_candidate_icd);
+
+  if ((ret = hash243_stack_push(&walk, hash)) != RC_OK) {
+    goto done;
+  }
+
+  while (hash243_stack_count(walk) != 0) {
+    memcpy(current, hash243_stack_peek(walk), FLEX_TRIT_SIZE_243);
+    hash243_stack_pop(&walk);
+    if (hash243_set_contains(visited, current)) {
+      continue;
+    } else if ((ret = hash243_set_add(&visited, current)) != RC_OK) {
       goto done;
     }
 
-    for (size_t approver_index = 0; approver_index < hash_pack.num_loaded; ++approver_index) {
-      approver_hash = ((flex_trit_t *)hash_pack.models[approver_index]);
-      if (hash243_set_contains(transactions_to_propagate, approver_hash)) {
-        continue;
-      }
-      if ((ret = iota_consensus_transaction_solidifier_check_and_update_solid_state(ts, tangle, approver_hash)) !=
-          RC_OK) {
-        log_error(logger_id,
-                  "Checking and updating solid state while propagating "
-                  "solidity failed\n");
-        goto done;
+    lock_handle_lock(&ts->lock);
+    known_solid = is_known_solid(ts, current);
+    tracked = !known_solid && solidity_graph_contains(&ts->graph, current, &stored);
+    approvees_count = tracked && stored ? solidity_graph_unsolid_approvees(&ts->graph, current, approvees) : 0;
+    lock_handle_unlock(&ts->lock);
+
+    if (known_solid || (tracked && !request && (stored || memcmp(current, hash, FLEX_TRIT_SIZE_243) != 0))) {
+      // When not requesting, the graph already links what it tracks, except the transaction being solidified if awaited
+      continue;
+    } else if (tracked && stored) {
+      for (size_t i = 0; i < approvees_count; i++) {
+        if ((ret = hash243_stack_push(&walk, approvees[i])) != RC_OK) {
+          goto done;
+        }
       }
+    } else if (loaded >= max_analyzed) {
+      log_debug(logger_id, "Solidification stopped after loading %d transactions\n", loaded);
+      break;
+    } else if ((ret = load_candidate(ts, tangle, current, candidates, &loaded_solid, &walk, request,
+                                     milestone_index)) != RC_OK) {
+      goto done;
+    } else {
+      loaded++;
     }
   }
 
+  // Transactions may have become solid meanwhile, which is only checked now
+  lock_handle_lock(&ts->lock);
+  HASH_ITER(hh, loaded_solid, entry, tmp) {
+    if ((ret = solidity_graph_set_solid(&ts->graph, entry->hash, &solid)) != RC_OK) {
+      break;
+    }
+  }
+  for (candidate = (solidity_candidate_t *)utarray_front(candidates); candidate != NULL && ret == RC_OK;
+       candidate = (solidity_candidate_t *)utarray_next(candidates, candidate)) {
+    if ((ret = solidity_graph_add(&ts->graph, candidate->hash, candidate->trunk,
+                                  is_approvee_solid(ts, candidate->trunk, loaded_solid, solid), candidate->branch,
+                                  is_approvee_solid(ts, candidate->branch, loaded_solid, solid), &solid)) != RC_OK) {
+      log_error(logger_id, "Adding transaction to the solidity graph failed\n");
+    }
+  }
+  if (solidity_graph_size(&ts->graph) > SOLIDITY_GRAPH_MAX_SIZE) {
+    log_debug(logger_id, "Evicted %zu transactions from the solidity graph\n",
+              solidity_graph_evict(&ts->graph, SOLIDITY_GRAPH_EVICTED_SIZE));
+  }
+  *is_solid = hash243_set_contains(solid, hash) || hash243_set_contains(loaded_solid, hash) || is_known_solid(ts, hash);
+
+  if (solid != NULL && iota_tangle_pending_batch(tangle) != 0) {
+    // Loaded through the uncommitted writes of the tangle, only its writer can persist them
+    hash243_set_append(&solid, &ts->pending_solid_transactions);
+  } else if (solid != NULL) {
+    hash243_set_append(&solid, &ts->newly_set_solid_transactions);
+    if (hash243_set_size(ts->newly_set_solid_transactions) >= SOLID_STATE_FLUSH_BATCH_SIZE) {
+      cond_handle_signal(&ts->cond);
+    }
+  }
+  lock_handle_unlock(&ts->lock);
+
+  if (ts->tips != NULL) {
+    HASH_ITER(hh, solid, entry, tmp) { tips_cache_set_solid(ts->tips, entry->hash); }
+  }
+
 done:
-  hash243_set_free(&transactions_to_propagate);
-  hash_pack_free(&hash_pack);
+  hash243_set_free(&solid);
+  hash243_set_free(&loaded_solid);
+  hash243_set_free(&visited);
+  hash243_stack_free(&walk);
+  utarray_free(candidates);
+
   return ret;
 }
 
@@ -111,12 +279,14 @@ static void *spawn_solid_transactions_propagation(void *arg) {
   lock_handle_lock(&lock_cond);
 
   while (ts->running) {
-    while (hash243_set_size(ts->newly_set_solid_transactions) > 0) {
-      if (propagate_solid_transactions(ts, &tangle) != RC_OK) {
-        log_error(logger_id, "Solid transaction propagation failed\n");
-      }
+    if (hash243_set_size(ts->newly_set_solid_transactions) > 0 && flush_solid_transactions(ts, &tangle) != RC_OK) {
+      log_error(logger_id, "Solid state persistence failed\n");
     }
-    cond_handle_timedwait(&ts->cond, &lock_cond, SOLID_PROPAGATION_INTERVAL_MS);
+    cond_handle_timedwait(&ts->cond, &lock_cond, SOLID_STATE_FLUSH_INTERVAL_MS);
+  }
+
+  if (flush_solid_transactions(ts, &tangle) != RC_OK) {
+    log_error(logger_id, "Solid state persistence failed\n");
   }
 
   lock_handle_unlock(&lock_cond);
@@ -142,9 +312,15 @@ retcode_t iota_consensus_transaction_solidifier_init(transaction_solidifier_t *c
   ts->transaction_requester = transaction_requester;
   ts->running = false;
   ts->newly_set_solid_transactions = NULL;
+  ts->flushing_solid_transactions = NULL;
+  ts->pending_solid_transactions = NULL;
+  ts->committing_solid_transactions = NULL;
+  ts->committing_solid_batch = 0;
   ts->snapshots_provider = snapshots_provider;
   ts->tips = tips;
+  solidity_graph_init(&ts->graph);
   lock_handle_init(&ts->lock);
+  lock_handle_init(&ts->flush_lock);
   cond_handle_init(&ts->cond);
   logger_id = logger_helper_enable(TRANSACTION_SOLIDIFIER_LOGGER_ID, LOGGER_DEBUG, true);
   return RC_OK;
@@ -193,210 +369,92 @@ retcode_t iota_consensus_transaction_solidifier_destroy(transaction_solidifier_t
   if (ts->newly_set_solid_transactions) {
     hash243_set_free(&ts->newly_set_solid_transactions);
   }
+  hash243_set_free(&ts->pending_solid_transactions);
+  hash243_set_free(&ts->committing_solid_transactions);
+  solidity_graph_destroy(&ts->graph);
   ts->transaction_requester = NULL;
   ts->newly_set_solid_transactions = NULL;
   ts->conf = NULL;
 
   lock_handle_destroy(&ts->lock);
+  lock_handle_destroy(&ts->flush_lock);
   cond_handle_destroy(&ts->cond);
 
   logger_helper_release(logger_id);
   return RC_OK;
 }
 
-static retcode_t check_solidity_do_func(flex_trit_t *hash, iota_stor_pack_t *pack, void *data, bool *should_branch,
-                                        bool *should_stop) {
-  *should_stop = false;
-  *should_branch = false;
-  check_solidity_do_func_params_t *params = data;
-  transaction_solidifier_t *ts = params->ts;
-  tangle_t *tangle = params->tangle;
-
-  if (params->max_analyzed == 0) {
-    *should_stop = true;
-    params->is_solid = false;
-    return RC_OK;
-  }
-  params->max_analyzed--;
-
-  // Transaction is not marked solid, but it is a candidate
-  if (pack->num_loaded == 1 && !((transaction_solid((iota_transaction_t *)pack->models[0])))) {
-    *should_branch = true;
-    return hash243_set_add(params->solid_transactions_candidates, hash);
-  } else if (pack->num_loaded == 0 && !hash243_set_contains(*params->solid_entry_points, hash)) {
-    params->is_solid = false;
-    return request_transaction(ts->transaction_requester, tangle, hash);
-  }
-
-  return RC_OK;
-}
-
 retcode_t iota_consensus_transaction_solidifier_check_solidity(transaction_solidifier_t *const ts,
                                                                tangle_t *const tangle, flex_trit_t *const hash,
-                                                               int max_analyzed, bool *const is_solid) {
+                                                               int max_analyzed, uint64_t const milestone_index,
+                                                               bool *const is_solid) {
   retcode_t ret = RC_OK;
-  DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
-  hash243_set_t solid_transactions_candidates = NULL;
-  hash243_set_t analyzed_hashes = NULL;
-  hash243_set_t solid_entry_points_hashes = NULL;
 
-  ret = iota_tangle_transaction_load_partial(tangle, hash, &pack, PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA);
-  if (ret != RC_OK) {
-    log_error(logger_id, "No transactions were loaded for the provided hash\n");
-    return ret;
-  }
-
-  if (transaction_solid(curr_tx)) {
-    *is_solid = true;
-    return RC_OK;
-  }
-
-  iota_snapshot_solid_entry_points_set(&ts->snapshots_provider->initial_snapshot, &analyzed_hashes);
-  hash243_set_append(&analyzed_hashes, &solid_entry_points_hashes);
-
-  max_analyzed += hash243_set_size(solid_entry_points_hashes);
-
-  check_solidity_do_func_params_t params = {.ts = ts,
-                                            .tangle = tangle,
-                                            .is_solid = true,
-                                            .solid_transactions_candidates = &solid_transactions_candidates,
-                                            .solid_entry_points = &solid_entry_points_hashes,
-                                            .max_analyzed = max_analyzed};
-
-  if ((ret = tangle_traversal_dfs_to_past(tangle, check_solidity_do_func, hash, ts->conf->genesis_hash,
-                                          &analyzed_hashes, &params)) != RC_OK) {
+  if ((ret = solidify(ts, tangle, hash, max_analyzed, true, milestone_index, is_solid)) != RC_OK) {
     *is_solid = false;
-    goto done;
-  }
-
-  if (params.is_solid) {
-    *is_solid = true;
-    log_debug(logger_id, "In %s, updating solid state\n", __FUNCTION__);
-
-    ret = iota_tangle_transactions_update_solid_state(tangle, solid_transactions_candidates, true);
-
-    lock_handle_lock(&ts->lock);
-    hash243_set_append(&solid_transactions_candidates, &ts->newly_set_solid_transactions);
-    lock_handle_unlock(&ts->lock);
-  }
-
-done:
-  hash243_set_free(&solid_transactions_candidates);
-  hash243_set_free(&analyzed_hashes);
-  hash243_set_free(&solid_entry_points_hashes);
-  return ret;
-}
-
-static retcode_t check_transaction_and_update_solid_state(transaction_solidifier_t *const ts, tangle_t *const tangle,
-                                                          flex_trit_t *const hash, bool *const is_new_solid) {
-  retcode_t ret = RC_OK;
-  bool is_trunk_solid = false;
-  bool is_branch_solid = false;
-  DECLARE_PACK_SINGLE_TX(transaction_s, transaction, pack);
-
-  *is_new_solid = false;
-
-  if (iota_snapshot_has_solid_entry_point(&ts->snapshots_provider->initial_snapshot, hash)) {
-    return RC_OK;
-  }
-
-  ret = iota_tangle_transaction_load_partial(tangle, hash, &pack, PARTIAL_TX_MODEL_ESSENCE_ATTACHMENT_METADATA);
-  if (ret != RC_OK || pack.num_loaded == 0) {
-    log_error(logger_id, "No transactions were loaded for the provided hash\n");
     return ret;
   }
 
-  if (!transaction_solid(transaction)) {
-    if ((ret = check_approvee_solid_state(ts, tangle, transaction_trunk(transaction), &is_trunk_solid)) != RC_OK) {
-      *is_new_solid = false;
-      log_error(logger_id, "Checking solidity of trunk failed\n");
-      return ret;
-    }
-
-    if ((ret = check_approvee_solid_state(ts, tangle, transaction_branch(transaction), &is_branch_solid)) != RC_OK) {
-      *is_new_solid = false;
-      log_error(logger_id, "Checking solidity of branch failed\n");
-      return ret;
-    }
-
-    if ((*is_new_solid = is_trunk_solid && is_branch_solid)) {
-      if ((ret = iota_tangle_transaction_update_solid_state(tangle, hash, true)) != RC_OK) {
-        log_error(logger_id, "Updating solid state failed\n");
-        return ret;
-      }
-    }
+  // Callers read the solid states of the past cone from the database right after
+  if (*is_solid) {
+    ret = flush_solid_transactions(ts, tangle);
   }
 
   return ret;
 }
 
-static retcode_t check_approvee_solid_state(transaction_solidifier_t *const ts, tangle_t *const tangle,
-                                            flex_trit_t *const approvee, bool *solid) {
-  retcode_t ret = RC_OK;
-  DECLARE_PACK_SINGLE_TX(curr_tx_s, curr_tx, pack);
-
-  if (iota_snapshot_has_solid_entry_point(&ts->snapshots_provider->initial_snapshot, approvee)) {
-    *solid = true;
-    return RC_OK;
-  }
-
-  if ((ret = iota_tangle_transaction_load_partial(tangle, approvee, &pack, PARTIAL_TX_MODEL_METADATA)) != RC_OK) {
-    log_error(logger_id,
-              "Loading transaction metadata for checking approvee solid state "
-              "failed\n");
-    *solid = false;
-    return ret;
-  }
-
-  if (pack.num_loaded == 0) {
-    *solid = false;
-    return ret;
-  }
-
-  if (memcmp(approvee, ts->conf->genesis_hash, FLEX_TRIT_SIZE_243) == 0) {
-    *solid = true;
-    return ret;
-  }
-
-  *solid = transaction_solid(curr_tx);
-
-  return ret;
-}
-
 retcode_t iota_consensus_transaction_solidifier_check_and_update_solid_state(transaction_solidifier_t *const ts,
                                                                              tangle_t *const tangle,
                                                                              flex_trit_t *const hash) {
   retcode_t ret = RC_OK;
-  bool is_new_solid = false;
+  bool is_solid = false;
 
   if (ts->transaction_requester == NULL) {
     return RC_OK;
   }
 
-  if ((ret = check_transaction_and_update_solid_state(ts, tangle, hash, &is_new_solid))) {
-    log_error(logger_id, "In %s, failed check_transaction_and_update_solid_state\n", __FUNCTION__);
-    return ret;
-  }
-
-  if (is_new_solid) {
-    return add_new_solid_transaction(ts, hash);
+  if ((ret = solidify(ts, tangle, hash, UPDATE_STATUS_MAX_ANALYZED, false, REQUESTER_NO_MILESTONE, &is_solid)) !=
+      RC_OK) {
+    log_error(logger_id, "In %s, failed solidify\n", __FUNCTION__);
   }
 
   return ret;
 }
 
-static retcode_t add_new_solid_transaction(transaction_solidifier_t *const ts, flex_trit_t *const hash) {
+retcode_t iota_consensus_transaction_solidifier_flush_pending(transaction_solidifier_t *const ts,
+                                                              tangle_t *const tangle) {
   retcode_t ret = RC_OK;
+  hash243_set_t persisting = NULL;
+
+  lock_handle_lock(&ts->flush_lock);
 
   lock_handle_lock(&ts->lock);
-  ret = hash243_set_add(&ts->newly_set_solid_transactions, hash);
+  // Batch identifiers increase, the last group commit being committed means the previous ones are
+  if (ts->committing_solid_transactions != NULL && iota_tangle_pending_batch(tangle) != ts->committing_solid_batch) {
+    hash243_set_free(&ts->committing_solid_transactions);
+  }
+  persisting = ts->pending_solid_transactions;
+  ts->pending_solid_transactions = NULL;
+  // Still readable by is_known_solid until committed
+  hash243_set_append(&persisting, &ts->committing_solid_transactions);
   lock_handle_unlock(&ts->lock);
 
+  if (persisting != NULL && (ret = iota_tangle_transactions_update_solid_state(tangle, persisting, true)) != RC_OK) {
+    log_error(logger_id, "Persisting %d pending solid states failed\n", hash243_set_size(persisting));
+  }
+
+  lock_handle_lock(&ts->lock);
   if (ret != RC_OK) {
-    return ret;
+    hash243_set_append(&persisting, &ts->pending_solid_transactions);
+  } else if ((ts->committing_solid_batch = iota_tangle_pending_batch(tangle)) == 0) {
+    hash243_set_free(&ts->committing_solid_transactions);
   }
+  lock_handle_unlock(&ts->lock);
 
-  return tips_cache_set_solid(ts->tips, hash);
+  lock_handle_unlock(&ts->flush_lock);
+  hash243_set_free(&persisting);
+
+  return ret;
 }
 
 retcode_t iota_consensus_transaction_solidifier_update_status(transaction_solidifier_t *const ts,
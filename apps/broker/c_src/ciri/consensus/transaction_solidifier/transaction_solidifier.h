@@ -14,6 +14,7 @@
 #include "ciri/consensus/conf.h"
 #include "ciri/consensus/snapshot/snapshots_provider.h"
 #include "ciri/consensus/tangle/tangle.h"
+#include "ciri/consensus/transaction_solidifier/solidity_graph.h"
 #include "ciri/node/pipeline/transaction_requester.h"
 #include "ciri/node/tips_cache.h"
 #include "common/errors.h"
@@ -35,8 +36,23 @@ typedef struct transaction_solidifier_s {
   snapshots_provider_t *snapshots_provider;
   thread_handle_t thread;
   bool running;
+  // Protects the graph and the solid transactions sets
   lock_handle_t lock;
+  // Stored transactions that are not solid yet and the approvees they wait for
+  solidity_graph_t graph;
+  // Transactions that became solid and whose solid state is not persisted yet
   hash243_set_t newly_set_solid_transactions;
+  // Transactions whose solid state is being persisted
+  hash243_set_t flushing_solid_transactions;
+  // Transactions that became solid through a tangle whose writes were pending in a group commit: their rows may only be
+  // readable through that tangle, their solid state is persisted by its writer, see
+  // iota_consensus_transaction_solidifier_flush_pending
+  hash243_set_t pending_solid_transactions;
+  // Transactions whose solid state was persisted in the group commit committing_solid_batch, until it is committed
+  hash243_set_t committing_solid_transactions;
+  uint64_t committing_solid_batch;
+  // Serializes the persistence of solid states
+  lock_handle_t flush_lock;
   tips_cache_t *tips;
   cond_handle_t cond;
 } transaction_solidifier_t;
@@ -55,12 +71,26 @@ retcode_t iota_consensus_transaction_solidifier_destroy(transaction_solidifier_t
 
 retcode_t iota_consensus_transaction_solidifier_check_solidity(transaction_solidifier_t *const ts,
                                                                tangle_t *const tangle, flex_trit_t *const hash,
-                                                               int max_analyzed, bool *const is_solid);
+                                                               int max_analyzed, uint64_t const milestone_index,
+                                                               bool *const is_solid);
 
 retcode_t iota_consensus_transaction_solidifier_check_and_update_solid_state(transaction_solidifier_t *const ts,
                                                                              tangle_t *const tangle,
                                                                              flex_trit_t *const hash);
 
+/**
+ * Persists the solid states of the transactions that became solid while the writes of a tangle were pending in a group
+ * commit. Called by the writer of the tangle, whose connection reads the rows it didn't commit yet: the solid states
+ * join its group commit, committed along with or after the rows.
+ *
+ * @param ts The transaction solidifier
+ * @param tangle The tangle of the writer
+ *
+ * @return a status code
+ */
+retcode_t iota_consensus_transaction_solidifier_flush_pending(transaction_solidifier_t *const ts,
+                                                              tangle_t *const tangle);
+
 retcode_t iota_consensus_transaction_solidifier_update_status(transaction_solidifier_t *const ts,
                                                               tangle_t *const tangle, iota_transaction_t *const tx);
 
@@ -147,8 +147,24 @@ int main(int argc, char* argv[]) {
   }
 
   {
+    iota_node_conf_t const *const node_conf = &ciri_core.node.conf;
+    // Shared by the connections opened to the tangle database from now on
+    connection_config_t pool_conf = {.db_path = ciri_core.conf.tangle_db_path,
+                                     .backend = node_conf->tangle_db_backend,
+                                     .durability = node_conf->tangle_db_durability,
+                                     .write_batch_size = node_conf->tangle_db_write_batch_size,
+                                     .write_batch_timeout_ms = node_conf->tangle_db_write_batch_timeout,
+                                     .cache_size_kb = node_conf->tangle_db_cache_size,
+                                     .mmap_size_mb = node_conf->tangle_db_mmap_size,
+                                     .temp_store = node_conf->tangle_db_temp_store,
+                                     .wal_autocheckpoint = node_conf->tangle_db_wal_autocheckpoint};
     connection_config_t db_conf = {.db_path = ciri_core.conf.tangle_db_path};
 
+    if (storage_pool_open(&pool_conf, STORAGE_CONNECTION_TANGLE, node_conf->tangle_db_readers) != RC_OK) {
+      log_critical(logger_id, "Opening tangle connection pool failed\n");
+      return EXIT_FAILURE;
+    }
+
     if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
       log_critical(logger_id, "Initializing tangle connection failed\n");
       return EXIT_FAILURE;
@@ -208,6 +224,11 @@ destroy:
     ret = EXIT_FAILURE;
   }
 
+  if (storage_pool_close(ciri_core.conf.tangle_db_path) != RC_OK) {
+    log_error(logger_id, "Closing tangle connection pool failed\n");
+    ret = EXIT_FAILURE;
+  }
+
   log_info(logger_id, "Destroying storage\n");
   if (storage_destroy() != RC_OK) {
     log_error(logger_id, "Destroying storage failed\n");
@@ -15,12 +15,26 @@ retcode_t iota_node_conf_init(iota_node_conf_t* const conf) {
     return RC_NULL_PARAM;
   }
 
+  conf->hasher_batch_deadline_us = DEFAULT_HASHER_BATCH_DEADLINE_US;
+  conf->hasher_threads = DEFAULT_HASHER_THREADS;
   conf->mwm = DEFAULT_MWN;
   conf->neighbors = DEFAULT_NEIGHBORS;
   conf->p_send_milestone = DEFAULT_PROBABILITY_SEND_MILESTONE;
   conf->recent_seen_bytes_cache_size = DEFAULT_RECENT_SEEN_BYTES_CACHE_SIZE;
   conf->requester_queue_size = DEFAULT_REQUESTER_QUEUE_SIZE;
+  conf->send_queue_size = DEFAULT_SEND_QUEUE_SIZE;
+  conf->stage_queue_size = DEFAULT_STAGE_QUEUE_SIZE;
+  conf->tangle_db_cache_size = DEFAULT_TANGLE_DB_CACHE_SIZE;
+  conf->tangle_db_backend = DEFAULT_TANGLE_DB_BACKEND;
+  conf->tangle_db_durability = DEFAULT_TANGLE_DB_DURABILITY;
+  conf->tangle_db_mmap_size = DEFAULT_TANGLE_DB_MMAP_SIZE;
+  conf->tangle_db_readers = DEFAULT_TANGLE_DB_READERS;
+  conf->tangle_db_temp_store = DEFAULT_TANGLE_DB_TEMP_STORE;
+  conf->tangle_db_wal_autocheckpoint = DEFAULT_TANGLE_DB_WAL_AUTOCHECKPOINT;
+  conf->tangle_db_write_batch_size = DEFAULT_TANGLE_DB_WRITE_BATCH_SIZE;
+  conf->tangle_db_write_batch_timeout = DEFAULT_TANGLE_DB_WRITE_BATCH_TIMEOUT;
   conf->tips_cache_size = DEFAULT_TIPS_CACHE_SIZE;
+  conf->transaction_bytes_cache_size = DEFAULT_TRANSACTION_BYTES_CACHE_SIZE;
   flex_trits_from_trytes(coordinator_address, HASH_LENGTH_TRIT, (tryte_t*)COORDINATOR_ADDRESS, HASH_LENGTH_TRYTE,
                          HASH_LENGTH_TRYTE);
   flex_trits_to_bytes(conf->coordinator_address, HASH_LENGTH_TRIT, coordinator_address, HASH_LENGTH_TRIT,
@@ -12,11 +12,14 @@
 #include <stdint.h>
 
 #include "common/errors.h"
+#include "common/storage/connection.h"
 #include "common/trinary/flex_trit.h"
 #include "utils/files.h"
 
 #define DEFAULT_AUTO_TETHERING_ENABLED false
 #define DEFAULT_COORDINATOR_ADDRESS COORDINATOR_ADDRESS
+#define DEFAULT_HASHER_BATCH_DEADLINE_US 200
+#define DEFAULT_HASHER_THREADS 0
 #define DEFAULT_MAX_NEIGHBORS 5
 #define DEFAULT_MWN MWM
 #define DEFAULT_NEIGHBORING_ADDRESS "0.0.0.0"
@@ -27,7 +30,19 @@
 #define DEFAULT_RECENT_SEEN_BYTES_CACHE_SIZE 1500
 #define DEFAULT_RECONNECT_ATTEMPT_INTERVAL 60
 #define DEFAULT_REQUESTER_QUEUE_SIZE 10000
+#define DEFAULT_SEND_QUEUE_SIZE 1024
+#define DEFAULT_STAGE_QUEUE_SIZE 2048
+#define DEFAULT_TANGLE_DB_BACKEND STORAGE_BACKEND_SQLITE3
+#define DEFAULT_TANGLE_DB_CACHE_SIZE 16384
+#define DEFAULT_TANGLE_DB_DURABILITY STORAGE_DURABILITY_NORMAL
+#define DEFAULT_TANGLE_DB_MMAP_SIZE 256
+#define DEFAULT_TANGLE_DB_READERS 8
+#define DEFAULT_TANGLE_DB_TEMP_STORE STORAGE_TEMP_STORE_MEMORY
+#define DEFAULT_TANGLE_DB_WAL_AUTOCHECKPOINT 1000
+#define DEFAULT_TANGLE_DB_WRITE_BATCH_SIZE 500
+#define DEFAULT_TANGLE_DB_WRITE_BATCH_TIMEOUT 100
 #define DEFAULT_TIPS_CACHE_SIZE 5000
+#define DEFAULT_TRANSACTION_BYTES_CACHE_SIZE 10000
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,10 +62,38 @@ typedef struct iota_node_conf_s {
   size_t tips_cache_size;
   // The number of entries to keep in the network cache
   size_t recent_seen_bytes_cache_size;
+  // The number of recently stored transactions whose bytes are kept to answer requests
+  size_t transaction_bytes_cache_size;
   // Size of the requester queue
   size_t requester_queue_size;
+  // Number of packets waiting to be sent to a neighbor above which new ones are dropped
+  size_t send_queue_size;
+  // Number of packets each pipeline stage queue holds, rounded up to a power of 2
+  size_t stage_queue_size;
+  // Number of hasher threads, 0 for one per available core
+  size_t hasher_threads;
+  // Maximum time (in microseconds) a hasher thread waits for packets to fill its lanes
+  uint64_t hasher_batch_deadline_us;
   // Path of the tangle database file
   char tangle_db_path[FILE_PATH_SIZE];
+  // Storage backend of the tangle database
+  storage_backend_type_t tangle_db_backend;
+  // Page cache of each connection to the tangle database, in KiB
+  size_t tangle_db_cache_size;
+  // How much stored transactions are protected from a crash or a power loss
+  storage_durability_t tangle_db_durability;
+  // Part of the tangle database file mapped in memory, in MiB
+  size_t tangle_db_mmap_size;
+  // Number of reader connections to the tangle database kept open for the threads
+  size_t tangle_db_readers;
+  // Where temporary tables and indices of the tangle database are kept
+  storage_temp_store_t tangle_db_temp_store;
+  // Number of pages the write-ahead log of the tangle database grows to before being checkpointed
+  size_t tangle_db_wal_autocheckpoint;
+  // Number of transactions stored together in a single database transaction, 0 or 1 to store them one by one
+  size_t tangle_db_write_batch_size;
+  // Maximum time (in milliseconds) a stored transaction waits for the others of its batch before being committed
+  uint64_t tangle_db_write_batch_timeout;
   // The address of the coordinator encoded in bytes
   byte_t coordinator_address[HASH_LENGTH_BYTE];
   // The address to bind the TCP server socket to
@@ -19,6 +19,7 @@ retcode_t neighbor_init(neighbor_t *const neighbor) {
 
   memset(neighbor, 0, sizeof(neighbor_t));
   neighbor->writer = NULL;
+  neighbor->connecting = NULL;
   neighbor->endpoint.stream = NULL;
   neighbor->state = NEIGHBOR_DISCONNECTED;
   neighbor->write_queue = NULL;
@@ -33,6 +34,9 @@ retcode_t neighbor_destroy(neighbor_t *const neighbor) {
 
   neighbor_write_queue_free(neighbor);
   lock_handle_destroy(&neighbor->write_queue_lock);
+  free(neighbor->buffer);
+  neighbor->buffer = NULL;
+  neighbor->buffer_size = 0;
 
   return RC_OK;
 }
@@ -89,6 +93,7 @@ retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor, p
   void *buffer = NULL;
   size_t buffer_size = 0;
   size_t offset = 0;
+  size_t queued = 0;
 
   if (node == NULL || neighbor == NULL || neighbor->endpoint.stream == NULL || packet == NULL) {
     return RC_NULL_PARAM;
@@ -115,13 +120,25 @@ retcode_t neighbor_send_packet(node_t *const node, neighbor_t *const neighbor, p
          GOSSIP_NON_SIG_BYTES_LENGTH + GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
 
   lock_handle_lock(&neighbor->write_queue_lock);
-  neighbor_write_queue_push(neighbor, buffer, HEADER_BYTES_LENGTH + buffer_size);
+  // A neighbor not reading fast enough loses packets instead of growing its queue
+  if (neighbor->write_queue_size >= node->conf.send_queue_size) {
+    neighbor->nbr_dropped_send++;
+    ret = RC_NEIGHBOR_SEND_QUEUE_FULL;
+  } else {
+    ret = neighbor_write_queue_push(neighbor, buffer, HEADER_BYTES_LENGTH + buffer_size);
+  }
+  if (ret != RC_OK) {
+    free(buffer);
+  } else {
+    queued = neighbor->write_queue_size;
+  }
   lock_handle_unlock(&neighbor->write_queue_lock);
 
-  // TODO not here
-  neighbor->writer->data = neighbor;
-  if (uv_async_send(neighbor->writer) != 0) {
-    return RC_ASYNC_CALL_FAILED;
+  // Only a full batch wakes the event loop up, the router flushes smaller ones periodically
+  if (queued == NEIGHBOR_WRITE_BATCH_SIZE) {
+    if (uv_async_send(neighbor->writer) != 0) {
+      return RC_ASYNC_CALL_FAILED;
+    }
   }
 
   return ret;
@@ -132,7 +149,7 @@ static retcode_t neighbor_send(node_t *const node, tangle_t const *const tangle,
   retcode_t ret = RC_OK;
   flex_trit_t request[FLEX_TRIT_SIZE_243];
 
-  if ((ret = get_transaction_to_request(&node->transaction_requester, tangle, request)) != RC_OK) {
+  if ((ret = get_transaction_to_request(&node->transaction_requester, neighbor, request)) != RC_OK) {
     return ret;
   }
 
@@ -184,6 +201,7 @@ retcode_t neighbor_write_queue_push(neighbor_t *const neighbor, void *const buff
   }
   entry->buf = uv_buf_init(buffer, buffer_size);
   CDL_APPEND(neighbor->write_queue, entry);
+  neighbor->write_queue_size++;
 
   return RC_OK;
 }
@@ -198,11 +216,26 @@ uv_buf_t_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor) {
   front = neighbor->write_queue;
   if (front != NULL) {
     CDL_DELETE(neighbor->write_queue, front);
+    neighbor->write_queue_size--;
   }
 
   return front;
 }
 
+uv_buf_t_queue_t neighbor_write_queue_take(neighbor_t *const neighbor) {
+  uv_buf_t_queue_t queue = NULL;
+
+  if (neighbor == NULL) {
+    return NULL;
+  }
+
+  queue = neighbor->write_queue;
+  neighbor->write_queue = NULL;
+  neighbor->write_queue_size = 0;
+
+  return queue;
+}
+
 void neighbor_write_queue_free(neighbor_t *const neighbor) {
   uv_buf_t_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
 
@@ -216,4 +249,5 @@ void neighbor_write_queue_free(neighbor_t *const neighbor) {
     free(iter);
   }
   neighbor->write_queue = NULL;
+  neighbor->write_queue_size = 0;
 }
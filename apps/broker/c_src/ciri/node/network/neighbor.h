@@ -22,6 +22,12 @@
 extern "C" {
 #endif
 
+// Size of the buffer a neighbor receives packets in, large enough for a batch of full packets per read
+#define NEIGHBOR_RECEIVE_BUFFER_SIZE (32 * PACKET_MAX_BYTES_LENGTH)
+// Number of packets waiting to be sent to a neighbor at which the event loop is woken up to write them at once,
+// fewer ones are written by the periodic flush of the router
+#define NEIGHBOR_WRITE_BATCH_SIZE 32
+
 // Forward declarations
 typedef struct node_s node_t;
 typedef struct tangle_s tangle_t;
@@ -42,13 +48,18 @@ typedef struct uv_buf_t_queue_entry_s {
 typedef uv_buf_t_queue_entry_t *uv_buf_t_queue_t;
 
 typedef struct neighbor_s {
-  byte_t buffer[PACKET_MAX_BYTES_LENGTH];
+  // Receive buffer of NEIGHBOR_RECEIVE_BUFFER_SIZE bytes, allocated on the first read and read into directly
+  byte_t *buffer;
   size_t buffer_size;
   uv_async_t *writer;
+  // Outgoing connection until its handshake is read, only used by the event loop
+  uv_tcp_t *connecting;
   uv_buf_t_queue_t write_queue;
+  size_t write_queue_size;
   lock_handle_t write_queue_lock;
   endpoint_t endpoint;
   neighbor_state_t state;
+  bool read_paused;
   uint8_t protocol_version;
   uint64_t nbr_all_txs;
   uint64_t nbr_invalid_txs;
@@ -137,6 +148,15 @@ retcode_t neighbor_send_bytes(node_t *const node, tangle_t const *const tangle,
 
 retcode_t neighbor_write_queue_push(neighbor_t *const neighbor, void *const buffer, size_t const buffer_size);
 uv_buf_t_queue_entry_t *neighbor_write_queue_pop(neighbor_t *const neighbor);
+
+/**
+ * Takes all packets waiting to be sent to a neighbor, leaving its write queue empty
+ *
+ * @param[in,out] neighbor  The neighbor
+ *
+ * @return the packets taken, to be freed by the caller
+ */
+uv_buf_t_queue_t neighbor_write_queue_take(neighbor_t *const neighbor);
 void neighbor_write_queue_free(neighbor_t *const neighbor);
 
 #ifdef __cplusplus
@@ -7,6 +7,7 @@
 
 #include <stdlib.h>
 
+#include "utlist.h"
 #include "uv.h"
 
 #include "ciri/node/network/router.h"
@@ -15,19 +16,136 @@
 #include "utils/macros.h"
 
 #define ROUTER_LOGGER_ID "router"
+// Interval at which reading from neighbors paused by a full processor queue is attempted again
+#define ROUTER_BACKPRESSURE_INTERVAL_MS 10
+// Interval at which packets waiting to be sent to neighbors are written, whether they make a full batch or not
+#define ROUTER_WRITE_FLUSH_INTERVAL_MS 5
+// Maximum number of packets gathered in a single write, below IOV_MAX
+#define ROUTER_WRITE_MAX_BUFS 64
+
+typedef struct router_write_batch_s {
+  uv_write_t req;
+  size_t bufs_num;
+  uv_buf_t bufs[ROUTER_WRITE_MAX_BUFS];
+} router_write_batch_t;
 
-static UT_icd neighbors_icd = {sizeof(neighbor_t), 0, 0, 0};
 static logger_id_t logger_id;
 static uv_tcp_t *server = NULL;
 static uv_async_t *async = NULL;
 static uv_timer_t *reconnect_timer = NULL;
+static uv_timer_t *backpressure_timer = NULL;
+static uv_timer_t *write_timer = NULL;
+// Receives handshakes, before reads go to the buffer of the neighbor. Only used by the event loop thread.
+static byte_t handshake_buffer[PACKET_MAX_BYTES_LENGTH];
 
 static int router_neighbor_cmp(void const *const lhs, void const *const rhs) {
   if (lhs == NULL || rhs == NULL) {
     return false;
   }
 
-  return endpoint_cmp(&((neighbor_t *)lhs)->endpoint, &((neighbor_t *)rhs)->endpoint);
+  return endpoint_cmp(&(*(neighbor_t *const *)lhs)->endpoint, &(*(neighbor_t *const *)rhs)->endpoint);
+}
+
+// FNV-1a of the IP and port of an endpoint
+static size_t router_endpoint_hash(char const *ip, uint16_t const port) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  while (*ip) {
+    hash = (hash ^ (uint8_t)*ip++) * 0x100000001b3ULL;
+  }
+  hash = (hash ^ (port & 0xFF)) * 0x100000001b3ULL;
+  hash = (hash ^ (port >> 8)) * 0x100000001b3ULL;
+
+  return (size_t)hash;
+}
+
+/**
+ * Publishes a new snapshot of the neighbors of a router, the current one staying readable until the event loop
+ * reclaims it
+ *
+ * @param router    The router, its neighbors lock held
+ * @param neighbors The neighbors
+ * @param size      The number of neighbors
+ * @param removed   A neighbor of the current snapshot left out of the new one, or NULL
+ *
+ * @return a status code
+ */
+static retcode_t router_neighbors_publish(router_t *const router, neighbor_t *const *const neighbors,
+                                          size_t const size, router_removed_neighbor_t *const removed) {
+  router_neighbors_t *current = atomic_load_explicit(&router->neighbors, memory_order_relaxed);
+  router_neighbors_t *snapshot = NULL;
+  uint64_t epoch = 0;
+  size_t index_size = 8;
+  size_t slot = 0;
+
+  // Keeps the index at most half full
+  while (index_size < 2 * size) {
+    index_size <<= 1;
+  }
+
+  if ((snapshot = (router_neighbors_t *)calloc(
+           1, sizeof(router_neighbors_t) + (size + index_size) * sizeof(neighbor_t *))) == NULL) {
+    return RC_OOM;
+  }
+  snapshot->version = current ? current->version + 1 : 0;
+  snapshot->size = size;
+  snapshot->neighbors = (neighbor_t **)(snapshot + 1);
+  snapshot->index = snapshot->neighbors + size;
+  snapshot->index_mask = index_size - 1;
+
+  if (size > 0) {
+    memcpy(snapshot->neighbors, neighbors, size * sizeof(neighbor_t *));
+    qsort(snapshot->neighbors, size, sizeof(neighbor_t *), router_neighbor_cmp);
+  }
+  for (size_t i = 0; i < size; i++) {
+    slot = router_endpoint_hash(neighbors[i]->endpoint.ip, neighbors[i]->endpoint.port) & snapshot->index_mask;
+    while (snapshot->index[slot] != NULL) {
+      slot = (slot + 1) & snapshot->index_mask;
+    }
+    snapshot->index[slot] = neighbors[i];
+  }
+
+  atomic_store(&router->neighbors, snapshot);
+
+  // Retired in the epoch readers of the current snapshot may have entered in at the latest
+  epoch = atomic_load(&router->epoch);
+  if (current != NULL) {
+    current->previous = router->retired_snapshots[epoch & 1];
+    router->retired_snapshots[epoch & 1] = current;
+  }
+  if (removed != NULL) {
+    LL_PREPEND(router->retired_neighbors[epoch & 1], removed);
+  }
+
+  return RC_OK;
+}
+
+/**
+ * Gives the pipeline queue packets of a neighbor go through after the given one, in the order they are pushed to
+ */
+static ring_buffer_t *router_pipeline_queue(node_t *const node, size_t const queue) {
+  if (queue == 0) {
+    return &node->processor.queue;
+  } else if (queue <= node->hasher.workers_num) {
+    return &node->hasher.workers[queue - 1].queue;
+  } else if (queue == node->hasher.workers_num + 1) {
+    return &node->validator.queue;
+  } else if (queue == node->hasher.workers_num + 2) {
+    return &node->responder.queue;
+  }
+
+  return NULL;
+}
+
+static void router_removed_neighbors_free(router_removed_neighbor_t **const removed_neighbors) {
+  router_removed_neighbor_t *removed = NULL, *tmp = NULL;
+
+  LL_FOREACH_SAFE(*removed_neighbors, removed, tmp) {
+    LL_DELETE(*removed_neighbors, removed);
+    neighbor_destroy(removed->neighbor);
+    free(removed->neighbor);
+    free(removed);
+  }
 }
 
 static retcode_t router_neighbors_init(router_t *const router) {
@@ -60,11 +178,30 @@ static retcode_t router_neighbors_init(router_t *const router) {
  * Private functions
  */
 
+/**
+ * Reads go right after the bytes of a neighbor buffer that don't make a full packet yet, where packets are framed in
+ * place by router_read()
+ */
 static void router_alloc_buffer(uv_handle_t *const handle, size_t suggested_size, uv_buf_t *const buf) {
-  UNUSED(handle);
+  neighbor_t *neighbor = (neighbor_t *)handle->data;
+
+  UNUSED(suggested_size);
 
-  buf->base = (char *)malloc(suggested_size);
-  buf->len = suggested_size;
+  if (neighbor == NULL || neighbor->state != NEIGHBOR_READY_FOR_MESSAGES) {
+    *buf = uv_buf_init((char *)handshake_buffer, sizeof(handshake_buffer));
+    return;
+  }
+
+  if (neighbor->buffer == NULL) {
+    neighbor->buffer_size = 0;
+    if ((neighbor->buffer = (byte_t *)malloc(NEIGHBOR_RECEIVE_BUFFER_SIZE)) == NULL) {
+      // Reported as UV_ENOBUFS by the read callback
+      *buf = uv_buf_init(NULL, 0);
+      return;
+    }
+  }
+  *buf = uv_buf_init((char *)neighbor->buffer + neighbor->buffer_size,
+                     NEIGHBOR_RECEIVE_BUFFER_SIZE - neighbor->buffer_size);
 }
 
 static void router_on_close(uv_handle_t *const handle) {
@@ -93,34 +230,171 @@ static void router_on_write(uv_write_t *const req, int const status) {
   free(req);
 }
 
-static void router_on_async_write(uv_async_t *const handle) {
-  neighbor_t *neighbor = (neighbor_t *)handle->data;
-  uv_buf_t_queue_entry_t *entry = NULL;
-  uv_write_t *req = NULL;
+static void router_on_write_batch(uv_write_t *const req, int const status) {
+  router_write_batch_t *batch = (router_write_batch_t *)req;
+
+  if (status && status != UV_ECANCELED && status != UV_ECONNRESET) {
+    log_warning(logger_id, "Writing data failed: %s\n", uv_strerror(status));
+  }
+  for (size_t i = 0; i < batch->bufs_num; i++) {
+    free(batch->bufs[i].base);
+  }
+  free(batch);
+}
+
+/**
+ * Writes the packets waiting to be sent to a neighbor, gathering up to ROUTER_WRITE_MAX_BUFS of them per write.
+ * Packets stay queued while the socket of the neighbor can't take previous writes, so that a slow neighbor fills its
+ * bounded queue rather than the unbounded one of the stream.
+ */
+static void router_neighbor_flush(neighbor_t *const neighbor) {
+  uv_buf_t_queue_t queue = NULL;
+  uv_buf_t_queue_entry_t *entry = NULL, *tmp1 = NULL, *tmp2 = NULL;
+  router_write_batch_t *batch = NULL;
   int err = 0;
 
-  while (true) {
-    lock_handle_lock(&neighbor->write_queue_lock);
-    entry = neighbor_write_queue_pop(neighbor);
-    lock_handle_unlock(&neighbor->write_queue_lock);
+  if (neighbor->endpoint.stream == NULL || ((uv_stream_t *)neighbor->endpoint.stream)->write_queue_size > 0) {
+    return;
+  }
 
-    if (entry == NULL) {
-      break;
-    }
+  lock_handle_lock(&neighbor->write_queue_lock);
+  queue = neighbor_write_queue_take(neighbor);
+  lock_handle_unlock(&neighbor->write_queue_lock);
 
-    if ((req = malloc(sizeof(uv_write_t))) == NULL) {
+  CDL_FOREACH_SAFE(queue, entry, tmp1, tmp2) {
+    CDL_DELETE(queue, entry);
+    if (batch == NULL && (batch = (router_write_batch_t *)malloc(sizeof(router_write_batch_t))) != NULL) {
+      batch->bufs_num = 0;
+    }
+    if (batch == NULL) {
       log_warning(logger_id, "Allocating write request failed\n");
-      return;
+      free(entry->buf.base);
+      free(entry);
+      continue;
     }
+    batch->bufs[batch->bufs_num++] = entry->buf;
+    free(entry);
+    if (batch->bufs_num == ROUTER_WRITE_MAX_BUFS || queue == NULL) {
+      if ((err = uv_write(&batch->req, neighbor->endpoint.stream, batch->bufs, batch->bufs_num,
+                          router_on_write_batch)) != 0) {
+        log_warning(logger_id, "Writing failed: %s\n", uv_err_name(err));
+        router_on_write_batch(&batch->req, 0);
+      } else {
+        neighbor->nbr_sent_txs += batch->bufs_num;
+      }
+      batch = NULL;
+    }
+  }
+}
 
-    req->data = entry->buf.base;
-    if ((err = uv_write(req, neighbor->endpoint.stream, &entry->buf, 1, router_on_write)) != 0) {
-      log_warning(logger_id, "Writing failed: %s\n", uv_err_name(err));
-    } else {
-      neighbor->nbr_sent_txs++;
+/**
+ * Releases the receive buffer and the packets waiting to be sent of a neighbor whose connection is gone, on the event
+ * loop thread
+ */
+static void router_neighbor_release(neighbor_t *const neighbor) {
+  neighbor->read_paused = false;
+  free(neighbor->buffer);
+  neighbor->buffer = NULL;
+  neighbor->buffer_size = 0;
+  lock_handle_lock(&neighbor->write_queue_lock);
+  neighbor_write_queue_free(neighbor);
+  lock_handle_unlock(&neighbor->write_queue_lock);
+}
+
+/**
+ * Closes the connections with a neighbor removed from the router, on the event loop thread
+ */
+static void router_neighbor_disconnect(neighbor_t *const neighbor) {
+  if (neighbor->endpoint.stream != NULL) {
+    log_info(logger_id, "Closing connection with removed neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
+             neighbor->endpoint.port);
+    ((uv_handle_t *)neighbor->endpoint.stream)->data = NULL;
+    uv_close((uv_handle_t *)neighbor->endpoint.stream, router_on_close);
+    neighbor->endpoint.stream = NULL;
+  }
+  if (neighbor->connecting != NULL) {
+    // Its connect callback is cancelled
+    neighbor->connecting->data = NULL;
+    uv_close((uv_handle_t *)neighbor->connecting, router_on_close);
+    neighbor->connecting = NULL;
+  }
+  router_neighbor_release(neighbor);
+}
+
+static void router_on_async_write(uv_async_t *const handle) {
+  neighbor_t *neighbor = (neighbor_t *)handle->data;
+
+  if (neighbor->state == NEIGHBOR_MARKED_FOR_DISCONNECT) {
+    router_neighbor_disconnect(neighbor);
+  } else {
+    router_neighbor_flush(neighbor);
+  }
+}
+
+/**
+ * Reclaims the snapshots and neighbors retired two epochs ago once their readers are gone, then frees the removed
+ * neighbors whose packets left the pipeline
+ */
+static void router_reclaim(router_t *const router) {
+  router_neighbors_t *snapshot = NULL, *previous = NULL;
+  router_removed_neighbor_t *removed = NULL, *tmp = NULL;
+  ring_buffer_t *queue = NULL;
+  uint64_t epoch = 0;
+
+  lock_handle_lock(&router->neighbors_lock);
+  epoch = atomic_load(&router->epoch);
+  if ((router->retired_snapshots[(epoch + 1) & 1] != NULL || router->retired_neighbors[(epoch + 1) & 1] != NULL ||
+       router->retired_snapshots[epoch & 1] != NULL || router->retired_neighbors[epoch & 1] != NULL) &&
+      atomic_load(&router->readers[(epoch + 1) & 1]) == 0) {
+    for (snapshot = router->retired_snapshots[(epoch + 1) & 1]; snapshot != NULL; snapshot = previous) {
+      previous = snapshot->previous;
+      free(snapshot);
     }
-    free(entry);
+    router->retired_snapshots[(epoch + 1) & 1] = NULL;
+    // Their packets may still be queued, by readers that found them before they were retired
+    LL_FOREACH_SAFE(router->retired_neighbors[(epoch + 1) & 1], removed, tmp) {
+      LL_DELETE(router->retired_neighbors[(epoch + 1) & 1], removed);
+      removed->queue = 0;
+      removed->position = ring_buffer_position(router_pipeline_queue(router->node, 0));
+      LL_PREPEND(router->draining_neighbors, removed);
+    }
+    atomic_store(&router->epoch, epoch + 1);
   }
+  lock_handle_unlock(&router->neighbors_lock);
+
+  LL_FOREACH_SAFE(router->draining_neighbors, removed, tmp) {
+    // A stage only pushes packets of the neighbor to the next ones while processing its own
+    while ((queue = router_pipeline_queue(router->node, removed->queue)) != NULL &&
+           ring_buffer_consumed(queue, removed->position)) {
+      if ((queue = router_pipeline_queue(router->node, ++removed->queue)) != NULL) {
+        removed->position = ring_buffer_position(queue);
+      }
+    }
+    if (queue == NULL) {
+      LL_DELETE(router->draining_neighbors, removed);
+      router_neighbor_disconnect(removed->neighbor);
+      if (removed->neighbor->writer != NULL) {
+        uv_close((uv_handle_t *)removed->neighbor->writer, router_on_close);
+      }
+      neighbor_destroy(removed->neighbor);
+      free(removed->neighbor);
+      free(removed);
+    }
+  }
+}
+
+static void router_on_write_timer(uv_timer_t *const handle) {
+  router_t *router = &((node_t *)handle->data)->router;
+  router_neighbors_t const *neighbors = router_neighbors(router);
+  neighbor_t *neighbor = NULL;
+
+  NEIGHBORS_FOREACH(neighbors, neighbor) {
+    if (neighbor->write_queue_size > 0) {
+      router_neighbor_flush(neighbor);
+    }
+  }
+
+  router_reclaim(router);
 }
 
 static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_buf_t const *const buf) {
@@ -128,13 +402,22 @@ static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_bu
   router_t *router = &((node_t *)server->data)->router;
 
   if (nread < 0) {
+    // UV_ENOBUFS if the receive buffer of the neighbor couldn't be allocated
     if (nread != UV_EOF) {
       log_warning(logger_id, "Read error: %s\n", uv_err_name(nread));
+    }
+    if (neighbor != NULL && neighbor->connecting == (uv_tcp_t *)client) {
+      // Lost before the handshake, the neighbor may be connected through another connection
+      neighbor->connecting = NULL;
+      if (neighbor->endpoint.stream == NULL) {
+        neighbor->state = NEIGHBOR_DISCONNECTED;
+      }
     } else if (neighbor != NULL) {
       log_info(logger_id, "Connection with neighbor tcp://%s:%d lost\n", neighbor->endpoint.domain,
                neighbor->endpoint.port);
       neighbor->state = NEIGHBOR_DISCONNECTED;
       neighbor->endpoint.stream = NULL;
+      router_neighbor_release(neighbor);
     }
     uv_close((uv_handle_t *)client, router_on_close);
   } else if (nread > 0) {
@@ -145,6 +428,12 @@ static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_bu
       struct sockaddr_storage addr;
       int len = sizeof(struct sockaddr_storage);
 
+      if (neighbor != NULL && neighbor->connecting == (uv_tcp_t *)client) {
+        // The outgoing connection is either established or closed below
+        neighbor->connecting = NULL;
+        neighbor->state = NEIGHBOR_DISCONNECTED;
+      }
+
       if (uv_tcp_getpeername((uv_tcp_t *)client, (struct sockaddr *)&addr, &len) != 0 ||
           getnameinfo((struct sockaddr *)&addr, sizeof(addr), host, NI_MAXHOST, serv, NI_MAXSERV,
                       NI_NUMERICHOST | NI_NUMERICSERV) != 0) {
@@ -167,16 +456,12 @@ static void router_on_read(uv_stream_t *const client, ssize_t const nread, uv_bu
     } else {
       log_debug(logger_id, "Packet received from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
                 neighbor->endpoint.port);
-      if (router_read(router, neighbor, buf->base, nread) != RC_OK) {
+      if (router_read(router, neighbor, nread) != RC_OK) {
         log_warning(logger_id, "Read error from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
                     neighbor->endpoint.port);
       }
     }
   }
-
-  if (buf->base) {
-    free(buf->base);
-  }
 }
 
 static void router_on_new_connection(uv_stream_t *const server, int const status) {
@@ -232,8 +517,15 @@ void router_on_connect(uv_connect_t *const connection, int const status) {
   uint16_t handshake_size = 0;
 
   if (status < 0) {
-    log_warning(logger_id, "Connection to neighbor %s:%d failed: %s\n", neighbor->endpoint.domain,
-                neighbor->endpoint.port, uv_strerror(status));
+    // Cancelled if the neighbor was removed
+    if (neighbor != NULL) {
+      log_warning(logger_id, "Connection to neighbor %s:%d failed: %s\n", neighbor->endpoint.domain,
+                  neighbor->endpoint.port, uv_strerror(status));
+      neighbor->connecting = NULL;
+    }
+    if (!uv_is_closing((uv_handle_t *)client)) {
+      uv_close((uv_handle_t *)client, router_on_close);
+    }
     free(connection);
     return;
   }
@@ -256,6 +548,61 @@ void router_on_connect(uv_connect_t *const connection, int const status) {
   free(connection);
 }
 
+static void router_on_backpressure_timer(uv_timer_t *const handle) {
+  router_t *router = &((node_t *)handle->data)->router;
+  router_neighbors_t const *neighbors = NULL;
+  neighbor_t *neighbor = NULL;
+  int err = 0;
+
+  // Resumes once the processor drained half of its queue, not to pause again on the next packet
+  if (processor_stage_size(&router->node->processor) > ring_buffer_capacity(&router->node->processor.queue) / 2) {
+    return;
+  }
+  // Started again if a neighbor pauses anew
+  uv_timer_stop(handle);
+
+  neighbors = router_neighbors(router);
+  NEIGHBORS_FOREACH(neighbors, neighbor) {
+    if (neighbor->read_paused) {
+      neighbor->read_paused = false;
+      // Packets left in the buffer go first, they may fill the processor queue again
+      if (neighbor->buffer != NULL && router_read(router, neighbor, 0) != RC_OK) {
+        log_warning(logger_id, "Read error from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
+                    neighbor->endpoint.port);
+      }
+      if (!neighbor->read_paused && neighbor->endpoint.stream != NULL &&
+          (err = uv_read_start(neighbor->endpoint.stream, router_alloc_buffer, router_on_read)) != 0) {
+        log_warning(logger_id, "Resuming reading from neighbor tcp://%s:%d failed: %s\n", neighbor->endpoint.domain,
+                    neighbor->endpoint.port, uv_err_name(err));
+      }
+    }
+  }
+}
+
+/**
+ * Stops reading from a neighbor while the processor queue is full, its packets then wait in its receive buffer and in
+ * the TCP buffers instead of being dropped.
+ */
+static void router_pause_neighbor(neighbor_t *const neighbor) {
+  int err = 0;
+
+  if (neighbor->read_paused) {
+    return;
+  }
+
+  log_debug(logger_id, "Pausing reading from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
+            neighbor->endpoint.port);
+  if (neighbor->endpoint.stream != NULL && (err = uv_read_stop(neighbor->endpoint.stream)) != 0) {
+    log_warning(logger_id, "Pausing reading from neighbor failed: %s\n", uv_err_name(err));
+    return;
+  }
+  neighbor->read_paused = true;
+  if (!uv_is_active((uv_handle_t *)backpressure_timer)) {
+    uv_timer_start(backpressure_timer, router_on_backpressure_timer, ROUTER_BACKPRESSURE_INTERVAL_MS,
+                   ROUTER_BACKPRESSURE_INTERVAL_MS);
+  }
+}
+
 static void router_on_reconnect_timer(uv_timer_t *const handle) {
   if (router_reconnect_attempt(&((node_t *)handle->data)->router) != RC_OK) {
     log_warning(logger_id, "Attempt to reconnect disconnected neighbors failed\n");
@@ -287,16 +634,31 @@ retcode_t router_init(router_t *const router, node_t *const node) {
 
   if ((server = (uv_tcp_t *)malloc(sizeof(uv_tcp_t))) == NULL ||
       (async = (uv_async_t *)malloc(sizeof(uv_async_t))) == NULL ||
-      (reconnect_timer = (uv_timer_t *)malloc(sizeof(uv_timer_t))) == NULL) {
+      (reconnect_timer = (uv_timer_t *)malloc(sizeof(uv_timer_t))) == NULL ||
+      (backpressure_timer = (uv_timer_t *)malloc(sizeof(uv_timer_t))) == NULL ||
+      (write_timer = (uv_timer_t *)malloc(sizeof(uv_timer_t))) == NULL) {
     return RC_OOM;
   }
 
   router->node = node;
   router->running = false;
-  utarray_new(router->neighbors, &neighbors_icd);
-  rw_lock_handle_init(&router->neighbors_lock);
+  lock_handle_init(&router->neighbors_lock);
+  atomic_init(&router->neighbors, NULL);
+  atomic_init(&router->epoch, 0);
+  for (size_t i = 0; i < 2; i++) {
+    atomic_init(&router->readers[i], 0);
+    router->retired_snapshots[i] = NULL;
+    router->retired_neighbors[i] = NULL;
+  }
+  router->draining_neighbors = NULL;
+  stage_metrics_init(&router->metrics);
+  if ((ret = router_neighbors_publish(router, NULL, 0, NULL)) != RC_OK) {
+    return ret;
+  }
   server->data = node;
   reconnect_timer->data = node;
+  backpressure_timer->data = node;
+  write_timer->data = node;
 
   if ((ret = router_neighbors_init(router)) != RC_OK) {
     log_critical(logger_id, "Initializing neighbors failed\n");
@@ -309,7 +671,9 @@ retcode_t router_init(router_t *const router, node_t *const node) {
       (err = uv_tcp_bind(server, (const struct sockaddr *)&addr, 0)) != 0 ||
       (err = uv_listen((uv_stream_t *)server, node->conf.max_neighbors, router_on_new_connection)) != 0 ||
       (err = uv_async_init(uv_default_loop(), async, router_on_async)) != 0 ||
-      (err = uv_timer_init(uv_default_loop(), reconnect_timer)) != 0) {
+      (err = uv_timer_init(uv_default_loop(), reconnect_timer)) != 0 ||
+      (err = uv_timer_init(uv_default_loop(), backpressure_timer)) != 0 ||
+      (err = uv_timer_init(uv_default_loop(), write_timer)) != 0) {
     log_critical(logger_id, "TCP server initialization failed: %s\n", uv_err_name(err));
     return RC_TCP_SERVER_INIT;
   }
@@ -334,6 +698,10 @@ retcode_t router_start(router_t *const router) {
                             router->node->conf.reconnect_attempt_interval * 1000)) != 0) {
     log_critical(logger_id, "Starting reconnect attempt timer failed: %s\n", uv_err_name(ret));
   }
+  if ((ret = uv_timer_start(write_timer, router_on_write_timer, ROUTER_WRITE_FLUSH_INTERVAL_MS,
+                            ROUTER_WRITE_FLUSH_INTERVAL_MS)) != 0) {
+    log_critical(logger_id, "Starting write flush timer failed: %s\n", uv_err_name(ret));
+  }
 
   return RC_OK;
 }
@@ -368,6 +736,7 @@ retcode_t router_stop(router_t *const router) {
 retcode_t router_destroy(router_t *const router) {
   int err = 0;
   retcode_t ret = RC_OK;
+  router_neighbors_t *neighbors = NULL, *previous = NULL;
   neighbor_t *neighbor = NULL;
 
   if (router == NULL) {
@@ -381,9 +750,24 @@ retcode_t router_destroy(router_t *const router) {
     ret = RC_EVENT_LOOP;
   }
 
-  NEIGHBORS_FOREACH(router->neighbors, neighbor) { neighbor_destroy(neighbor); }
-  utarray_free(router->neighbors);
-  rw_lock_handle_destroy(&router->neighbors_lock);
+  neighbors = atomic_load_explicit(&router->neighbors, memory_order_relaxed);
+  NEIGHBORS_FOREACH(neighbors, neighbor) {
+    neighbor_destroy(neighbor);
+    free(neighbor);
+  }
+  free(neighbors);
+  atomic_store_explicit(&router->neighbors, NULL, memory_order_relaxed);
+  // Writers of the removed neighbors were closed with the event loop
+  for (size_t i = 0; i < 2; i++) {
+    for (neighbors = router->retired_snapshots[i]; neighbors != NULL; neighbors = previous) {
+      previous = neighbors->previous;
+      free(neighbors);
+    }
+    router->retired_snapshots[i] = NULL;
+    router_removed_neighbors_free(&router->retired_neighbors[i]);
+  }
+  router_removed_neighbors_free(&router->draining_neighbors);
+  lock_handle_destroy(&router->neighbors_lock);
 
   logger_helper_release(logger_id);
 
@@ -392,7 +776,10 @@ retcode_t router_destroy(router_t *const router) {
 
 retcode_t router_neighbor_add(router_t *const router, neighbor_t *const neighbor) {
   retcode_t ret = RC_OK;
+  router_neighbors_t const *neighbors = NULL;
+  neighbor_t **elts = NULL;
   neighbor_t *elt = NULL;
+  router_removed_neighbor_t *removed = NULL;
   int err = 0;
 
   if (router == NULL || neighbor == NULL) {
@@ -403,69 +790,122 @@ retcode_t router_neighbor_add(router_t *const router, neighbor_t *const neighbor
     return ret;
   }
 
-  rw_lock_handle_wrlock(&router->neighbors_lock);
+  lock_handle_lock(&router->neighbors_lock);
 
-  elt = utarray_find(router->neighbors, neighbor, router_neighbor_cmp);
-
-  if (elt != NULL) {
-    ret = RC_NEIGHBOR_ALREADY_PAIRED;
-  } else {
-    utarray_push_back(router->neighbors, neighbor);
-    elt = (neighbor_t *)utarray_back(router->neighbors);
-    lock_handle_init(&elt->write_queue_lock);
-    if ((elt->writer = (uv_async_t *)malloc(sizeof(uv_async_t))) == NULL) {
-      ret = RC_OOM;
+  neighbors = router_neighbors(router);
+  for (size_t i = 0; i < neighbors->size; i++) {
+    if (endpoint_cmp(&neighbors->neighbors[i]->endpoint, &neighbor->endpoint) == 0) {
+      ret = RC_NEIGHBOR_ALREADY_PAIRED;
       goto done;
     }
-    if ((err = uv_async_init(uv_default_loop(), elt->writer, router_on_async_write)) != 0) {
-      log_warning(logger_id, "Initializing async writer failed: %s\n", uv_err_name(err));
-      ret = RC_ASYNC_INIT_FAILED;
-      goto done;
-    }
-    elt->writer->data = elt;
-    utarray_sort(router->neighbors, router_neighbor_cmp);
   }
 
+  if ((elts = (neighbor_t **)malloc((neighbors->size + 1) * sizeof(neighbor_t *))) == NULL ||
+      (removed = (router_removed_neighbor_t *)malloc(sizeof(router_removed_neighbor_t))) == NULL ||
+      (elt = (neighbor_t *)malloc(sizeof(neighbor_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  *elt = *neighbor;
+  lock_handle_init(&elt->write_queue_lock);
+  if ((elt->writer = (uv_async_t *)malloc(sizeof(uv_async_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  if ((err = uv_async_init(uv_default_loop(), elt->writer, router_on_async_write)) != 0) {
+    log_warning(logger_id, "Initializing async writer failed: %s\n", uv_err_name(err));
+    free(elt->writer);
+    ret = RC_ASYNC_INIT_FAILED;
+    goto done;
+  }
+  elt->writer->data = elt;
+
+  memcpy(elts, neighbors->neighbors, neighbors->size * sizeof(neighbor_t *));
+  elts[neighbors->size] = elt;
+  if ((ret = router_neighbors_publish(router, elts, neighbors->size + 1, NULL)) != RC_OK) {
+    // The writer handle belongs to the event loop now, which frees the neighbor as a removed one
+    elt->state = NEIGHBOR_MARKED_FOR_DISCONNECT;
+    removed->neighbor = elt;
+    LL_PREPEND(router->retired_neighbors[atomic_load(&router->epoch) & 1], removed);
+    removed = NULL;
+  }
+  elt = NULL;
+
 done:
+  if (elt != NULL) {
+    lock_handle_destroy(&elt->write_queue_lock);
+    free(elt);
+  }
+  free(removed);
+  free(elts);
 
-  rw_lock_handle_unlock(&router->neighbors_lock);
+  lock_handle_unlock(&router->neighbors_lock);
 
   return ret;
 }
 
 retcode_t router_neighbor_remove(router_t *const router, neighbor_t const *const neighbor) {
   retcode_t ret = RC_OK;
+  router_neighbors_t const *neighbors = NULL;
+  neighbor_t **elts = NULL;
   neighbor_t *elt = NULL;
+  router_removed_neighbor_t *removed = NULL;
+  size_t size = 0;
 
   if (router == NULL || neighbor == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&router->neighbors_lock);
+  lock_handle_lock(&router->neighbors_lock);
 
-  elt = utarray_find(router->neighbors, neighbor, router_neighbor_cmp);
+  neighbors = router_neighbors(router);
+  if ((elts = (neighbor_t **)malloc((neighbors->size + 1) * sizeof(neighbor_t *))) == NULL ||
+      (removed = (router_removed_neighbor_t *)malloc(sizeof(router_removed_neighbor_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  for (size_t i = 0; i < neighbors->size; i++) {
+    if (elt == NULL && endpoint_cmp(&neighbors->neighbors[i]->endpoint, &neighbor->endpoint) == 0) {
+      elt = neighbors->neighbors[i];
+    } else {
+      elts[size++] = neighbors->neighbors[i];
+    }
+  }
 
   if (elt == NULL) {
     ret = RC_NEIGHBOR_NOT_PAIRED;
-  } else {
-    utarray_erase(router->neighbors, utarray_eltidx(router->neighbors, elt), 1);
+    goto done;
+  }
+  removed->neighbor = elt;
+  if ((ret = router_neighbors_publish(router, elts, size, removed)) == RC_OK) {
+    // Readers of the previous snapshot may still use the neighbor, its connection is closed by the event loop
+    removed = NULL;
+    elt->state = NEIGHBOR_MARKED_FOR_DISCONNECT;
+    if (elt->writer != NULL && uv_async_send(elt->writer) != 0) {
+      log_warning(logger_id, "Closing connection with removed neighbor failed\n");
+    }
   }
 
-  rw_lock_handle_unlock(&router->neighbors_lock);
+done:
+  free(removed);
+  free(elts);
+
+  lock_handle_unlock(&router->neighbors_lock);
 
   return ret;
 }
 
 size_t router_neighbors_count(router_t *const router) {
+  uint64_t epoch = 0;
   size_t count = 0;
 
   if (router == NULL) {
     return 0;
   }
 
-  rw_lock_handle_rdlock(&router->neighbors_lock);
-  count = router->neighbors ? utarray_len(router->neighbors) : 0;
-  rw_lock_handle_unlock(&router->neighbors_lock);
+  epoch = router_neighbors_enter(router);
+  count = router_neighbors(router)->size;
+  router_neighbors_exit(router, epoch);
 
   return count;
 }
@@ -479,20 +919,25 @@ neighbor_t *router_neighbor_find_by_endpoint(router_t *const router, endpoint_t
 }
 
 neighbor_t *router_neighbor_find_by_endpoint_values(router_t *const router, char const *const ip, uint16_t const port) {
-  neighbor_t cmp;
-  neighbor_t *elt;
+  router_neighbors_t const *neighbors = NULL;
+  neighbor_t *elt = NULL;
+  uint64_t epoch = 0;
+  size_t slot = 0;
 
-  if (router == NULL) {
+  if (router == NULL || ip == NULL) {
     return NULL;
   }
 
-  if (neighbor_init_with_values(&cmp, ip, port)) {
-    return NULL;
+  epoch = router_neighbors_enter(router);
+  neighbors = router_neighbors(router);
+  slot = router_endpoint_hash(ip, port) & neighbors->index_mask;
+  while ((elt = neighbors->index[slot]) != NULL) {
+    if (elt->endpoint.port == port && strcmp(elt->endpoint.ip, ip) == 0) {
+      break;
+    }
+    slot = (slot + 1) & neighbors->index_mask;
   }
-
-  rw_lock_handle_rdlock(&router->neighbors_lock);
-  elt = utarray_find(router->neighbors, &cmp, router_neighbor_cmp);
-  rw_lock_handle_unlock(&router->neighbors_lock);
+  router_neighbors_exit(router, epoch);
 
   return elt;
 }
@@ -576,115 +1021,102 @@ retcode_t router_read_handshake(router_t *const router, char const *const ip, ui
   return RC_OK;
 }
 
-retcode_t router_read(router_t *const router, neighbor_t *const neighbor, void const *const buffer,
-                      size_t const buffer_size) {
+retcode_t router_read(router_t *const router, neighbor_t *const neighbor, size_t const nread) {
   retcode_t ret = RC_OK;
   protocol_header_t const *header = NULL;
   uint16_t header_length = 0;
-  size_t chunk_size = 0;
+  size_t offset = 0;
+  uint64_t start_us = 0;
 
-  if (router == NULL || neighbor == NULL || buffer == NULL) {
+  if (router == NULL || neighbor == NULL || neighbor->buffer == NULL) {
     return RC_NULL_PARAM;
   }
 
-  if (buffer_size == 0) {
-    return RC_OK;
-  }
-
-  // We concatenate read data to previously read data
-  chunk_size = MIN(PACKET_MAX_BYTES_LENGTH - neighbor->buffer_size, buffer_size);
-  memcpy(neighbor->buffer + neighbor->buffer_size, buffer, chunk_size);
-  neighbor->buffer_size += chunk_size;
+  neighbor->buffer_size += nread;
 
-  // We haven't received a full header yet
-  if (neighbor->buffer_size <= HEADER_BYTES_LENGTH) {
-    return RC_OK;
-  }
+  // Packets are framed in place, their payloads passed on where they were read
+  while (neighbor->buffer_size - offset >= HEADER_BYTES_LENGTH) {
+    start_us = monotonic_timestamp_us();
+    header = (protocol_header_t const *)(neighbor->buffer + offset);
+    header_length = ntohs(header->length);
 
-  header = (protocol_header_t const *)neighbor->buffer;
-  header_length = ntohs(header->length);
+    if (header_length > PACKET_MAX_BYTES_LENGTH - HEADER_BYTES_LENGTH) {
+      log_warning(logger_id, "Invalid packet size %d from neighbor tcp://%s:%d\n", header_length,
+                  neighbor->endpoint.domain, neighbor->endpoint.port);
+      stage_metrics_record(&router->metrics, start_us, true);
+      ret = RC_INVALID_PACKET;
+      goto done;
+    }
 
-  // We haven't received the full packet yet
-  if (neighbor->buffer_size - HEADER_BYTES_LENGTH < header_length) {
-    return RC_OK;
-  }
+    // We haven't received the full packet yet
+    if (neighbor->buffer_size - offset - HEADER_BYTES_LENGTH < header_length) {
+      break;
+    }
 
-  if (header->type < PACKET_TYPES_NUM) {
     switch (header->type) {
       case PROTOCOL_HANDSHAKE:
         break;
-      case PROTOCOL_GOSSIP: {
-        protocol_gossip_t gossip;
-        void const *ptr = neighbor->buffer + HEADER_BYTES_LENGTH;
-        size_t offset = 0;
-        size_t variable_size = 0;
-
-        // Check whether the packet length matches gossip packet length
-        if (header_length < GOSSIP_MIN_BYTES_LENGTH || header_length > GOSSIP_MAX_BYTES_LENGTH) {
+      case PROTOCOL_GOSSIP:
+        if ((ret = processor_stage_add_payload(&router->node->processor,
+                                               neighbor->buffer + offset + HEADER_BYTES_LENGTH, header_length,
+                                               neighbor->endpoint.ip, neighbor->endpoint.port)) ==
+            RC_UTILS_RING_BUFFER_FULL) {
+          // The packet and the next ones wait in the buffer for the processor
+          router_pause_neighbor(neighbor);
+          ret = RC_OK;
+          goto done;
+        } else if (ret == RC_INVALID_PACKET) {
           log_warning(logger_id, "Invalid packet size %d from neighbor tcp://%s:%d\n", header_length,
                       neighbor->endpoint.domain, neighbor->endpoint.port);
-          return RC_INVALID_PACKET;
-        }
-
-        memset(&gossip, 0, sizeof(protocol_gossip_t));
-
-        variable_size = header_length - GOSSIP_NON_SIG_BYTES_LENGTH - GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
-        memcpy(gossip.content + offset, ptr, variable_size);
-        ptr += variable_size;
-        offset += variable_size;
-
-        memset(gossip.content + offset, 0, GOSSIP_SIG_MAX_BYTES_LENGTH - variable_size);
-        offset += GOSSIP_SIG_MAX_BYTES_LENGTH - variable_size;
-
-        memcpy(gossip.content + offset, ptr, GOSSIP_NON_SIG_BYTES_LENGTH);
-        ptr += GOSSIP_NON_SIG_BYTES_LENGTH;
-        offset += GOSSIP_NON_SIG_BYTES_LENGTH;
-
-        memcpy(gossip.content + offset, ptr, GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
-        ptr += GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
-        offset += GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
-
-        protocol_gossip_set_endpoint(&gossip, neighbor->endpoint.ip, neighbor->endpoint.port);
-
-        if ((ret = processor_stage_add(&router->node->processor, &gossip)) != RC_OK) {
+          stage_metrics_record(&router->metrics, start_us, true);
+          goto done;
+        } else if (ret != RC_OK) {
           log_warning(logger_id, "Pushing gossip packet from tcp://%s:%d failed\n", neighbor->endpoint.domain,
                       neighbor->endpoint.port);
+          stage_metrics_record(&router->metrics, start_us, true);
+          ret = RC_OK;
+        } else {
+          stage_metrics_record(&router->metrics, start_us, false);
         }
         break;
-      }
       default:
         log_warning(logger_id, "Invalid packet type %d from neighbor tcp://%s:%d\n", header->type,
                     neighbor->endpoint.domain, neighbor->endpoint.port);
-        return RC_INVALID_PACKET_TYPE;
-        break;
+        stage_metrics_record(&router->metrics, start_us, true);
+        ret = RC_INVALID_PACKET_TYPE;
+        goto done;
     }
-  } else {
-    log_warning(logger_id, "Invalid packet type %d from neighbor tcp://%s:%d\n", header->type,
-                neighbor->endpoint.domain, neighbor->endpoint.port);
-    return RC_INVALID_PACKET_TYPE;
+
+    offset += HEADER_BYTES_LENGTH + header_length;
   }
 
-  memmove(neighbor->buffer, neighbor->buffer + HEADER_BYTES_LENGTH + header_length,
-          PACKET_MAX_BYTES_LENGTH - (HEADER_BYTES_LENGTH + header_length));
-  neighbor->buffer_size -= (HEADER_BYTES_LENGTH + header_length);
+done:
+  if (ret != RC_OK) {
+    // The stream can't be framed anymore, what's left is dropped
+    neighbor->buffer_size = 0;
+  } else if (offset > 0) {
+    // Only the beginning of a packet is left, moved to the front for the next read to complete it
+    memmove(neighbor->buffer, neighbor->buffer + offset, neighbor->buffer_size - offset);
+    neighbor->buffer_size -= offset;
+  }
 
-  return router_read(router, neighbor, buffer + chunk_size, buffer_size - chunk_size);
+  return ret;
 }
 
 retcode_t router_reconnect_attempt(router_t *const router) {
   retcode_t ret = RC_OK;
+  router_neighbors_t const *neighbors = router_neighbors(router);
   neighbor_t *neighbor = NULL;
 
-  rw_lock_handle_wrlock(&router->neighbors_lock);
-  NEIGHBORS_FOREACH(router->neighbors, neighbor) {
-    if (neighbor->state == NEIGHBOR_DISCONNECTED && neighbor->endpoint.stream == NULL) {
+  NEIGHBORS_FOREACH(neighbors, neighbor) {
+    if (neighbor->state == NEIGHBOR_DISCONNECTED && neighbor->endpoint.stream == NULL &&
+        neighbor->connecting == NULL) {
       if ((ret = router_connect(neighbor)) != RC_OK) {
         log_warning(logger_id, "Trying to reconnect to neighbor %s:%d failed\n", neighbor->endpoint.domain,
                     neighbor->endpoint.port);
       }
     }
   }
-  rw_lock_handle_unlock(&router->neighbors_lock);
 
   return RC_OK;
 }
@@ -778,12 +1210,21 @@ retcode_t router_connect(neighbor_t *const neighbor) {
 
   client->data = neighbor;
 
-  if ((ret = uv_tcp_init(uv_default_loop(), client)) != 0 ||
-      (ret = uv_ip4_addr(neighbor->endpoint.ip, neighbor->endpoint.port, &addr)) != 0 ||
-      (ret = uv_tcp_nodelay(client, true)) != 0 ||
-      (ret = uv_tcp_connect(connection, client, (struct sockaddr *)&addr, router_on_connect)) != 0) {
+  if ((ret = uv_tcp_init(uv_default_loop(), client)) != 0) {
     log_warning(logger_id, "Connection to neighbor %s:%d failed: %s\n", neighbor->endpoint.domain,
                 neighbor->endpoint.port, uv_err_name(ret));
+    free(client);
+    free(connection);
+  } else if ((ret = uv_ip4_addr(neighbor->endpoint.ip, neighbor->endpoint.port, &addr)) != 0 ||
+             (ret = uv_tcp_nodelay(client, true)) != 0 ||
+             (ret = uv_tcp_connect(connection, client, (struct sockaddr *)&addr, router_on_connect)) != 0) {
+    log_warning(logger_id, "Connection to neighbor %s:%d failed: %s\n", neighbor->endpoint.domain,
+                neighbor->endpoint.port, uv_err_name(ret));
+    uv_close((uv_handle_t *)client, router_on_close);
+    free(connection);
+  } else {
+    // Closed if the neighbor is removed before the handshake
+    neighbor->connecting = client;
   }
 
   return RC_OK;
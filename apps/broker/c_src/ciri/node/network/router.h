@@ -8,18 +8,22 @@
 #ifndef __CIRI_NODE_NETWORK_ROUTER_H__
 #define __CIRI_NODE_NETWORK_ROUTER_H__
 
-#include "utarray.h"
+#include <stdatomic.h>
+
 #include "uv.h"
 
 #include "ciri/node/network/neighbor.h"
+#include "ciri/node/pipeline/stage_metrics.h"
 #include "ciri/node/protocol/protocol.h"
 #include "common/errors.h"
-#include "utils/handles/rw_lock.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
 
-#define NEIGHBORS_FOREACH(neighbors, neighbor)                              \
-  for (neighbor = (neighbor_t *)utarray_front(neighbors); neighbor != NULL; \
-       neighbor = (neighbor_t *)utarray_next(neighbors, neighbor))
+// Iterates over the neighbors of a snapshot given by router_neighbors
+#define NEIGHBORS_FOREACH(snapshot, neighbor)                                                                 \
+  for (size_t neighbor##_index = 0;                                                                           \
+       neighbor##_index < (snapshot)->size && ((neighbor) = (snapshot)->neighbors[neighbor##_index]) != NULL; \
+       neighbor##_index++)
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,16 +32,99 @@ extern "C" {
 // Forward declarations
 typedef struct node_s node_t;
 
+/**
+ * An immutable snapshot of the neighbors of a router. Adding or removing a neighbor publishes a new snapshot instead of
+ * modifying the current one, so that readers never lock. Replaced snapshots are freed by the event loop once no reader
+ * entered before their replacement is left, see router_neighbors_enter().
+ */
+typedef struct router_neighbors_s {
+  // Incremented by each published snapshot
+  uint64_t version;
+  size_t size;
+  // Neighbors sorted by endpoint
+  neighbor_t **neighbors;
+  // Open addressed index of the neighbors by endpoint IP and port, linear probing, NULL if free
+  neighbor_t **index;
+  size_t index_mask;
+  // Next snapshot retired in the same epoch
+  struct router_neighbors_s *previous;
+} router_neighbors_t;
+
+// A removed neighbor waiting to be freed
+typedef struct router_removed_neighbor_s {
+  neighbor_t *neighbor;
+  // Pipeline queue the packets of the neighbor may still be in, and position it has to be consumed up to
+  size_t queue;
+  size_t position;
+  struct router_removed_neighbor_s *next;
+} router_removed_neighbor_t;
+
 typedef struct router_s {
   // Metadata
   bool running;
   thread_handle_t thread;
   // Data
   node_t *node;
-  UT_array *neighbors;
-  rw_lock_handle_t neighbors_lock;
+  _Atomic(router_neighbors_t *) neighbors;
+  // Serializes the publication and the reclamation of snapshots, readers don't take it
+  lock_handle_t neighbors_lock;
+  // Readers of the snapshots by parity of the epoch they entered in
+  atomic_uint_fast64_t epoch;
+  atomic_size_t readers[2];
+  // Snapshots and neighbors replaced during an epoch, by parity of the epoch
+  router_neighbors_t *retired_snapshots[2];
+  router_removed_neighbor_t *retired_neighbors[2];
+  // Removed neighbors no reader can find anymore, freed once their packets left the pipeline. Event loop only.
+  router_removed_neighbor_t *draining_neighbors;
+  // Packets framed off the neighbors streams and handed to the processor, written by the event loop only
+  stage_metrics_t metrics;
 } router_t;
 
+/**
+ * Enters a read section of the neighbors snapshots of a router, without locking. The snapshots given by
+ * router_neighbors() and the neighbors they hold stay valid until router_neighbors_exit().
+ *
+ * @param[in,out] router  The router
+ *
+ * @return the epoch entered, to be given to router_neighbors_exit()
+ */
+static inline uint64_t router_neighbors_enter(router_t *const router) {
+  uint64_t epoch = atomic_load(&router->epoch);
+  uint64_t current = 0;
+
+  atomic_fetch_add(&router->readers[epoch & 1], 1);
+  // The reclamation of an epoch only waits for the readers counted before it moved past it
+  while ((current = atomic_load(&router->epoch)) != epoch) {
+    atomic_fetch_sub(&router->readers[epoch & 1], 1);
+    epoch = current;
+    atomic_fetch_add(&router->readers[epoch & 1], 1);
+  }
+
+  return epoch;
+}
+
+/**
+ * Exits a read section of the neighbors snapshots of a router
+ *
+ * @param[in,out] router  The router
+ * @param[in]     epoch   The epoch given by router_neighbors_enter()
+ */
+static inline void router_neighbors_exit(router_t *const router, uint64_t const epoch) {
+  atomic_fetch_sub(&router->readers[epoch & 1], 1);
+}
+
+/**
+ * Gives the current neighbors snapshot of a router, without locking. Only to be called within a read section or from
+ * the event loop of the router, which reclaims snapshots.
+ *
+ * @param[in] router  The router
+ *
+ * @return the snapshot
+ */
+static inline router_neighbors_t const *router_neighbors(router_t *const router) {
+  return atomic_load_explicit(&router->neighbors, memory_order_acquire);
+}
+
 /**
  * Initializes a router
  *
@@ -105,7 +192,9 @@ retcode_t router_neighbor_remove(router_t *const router, neighbor_t const *const
 size_t router_neighbors_count(router_t *const router);
 
 /**
- * Finds a neighbor matching given endpoint in a router
+ * Finds a neighbor matching given endpoint in a router, in constant time and without locking. A removed neighbor
+ * is only freed once the packets queued in the pipeline before its removal were processed, so that the neighbor found
+ * for a packet stays valid while the packet goes through the pipeline.
  *
  * @param[in,out] router    The router
  * @param[in]     endpoint  The endpoint
@@ -141,17 +230,15 @@ retcode_t router_read_handshake(router_t *const router, char const *const ip, ui
                                 void const *const buf, size_t const nread, neighbor_t **const neighbor);
 
 /**
- * Reads a buffer from a neighbor
+ * Frames and dispatches the complete packets of a neighbor receive buffer, once bytes were read at its end
  *
- * @param[in,out] router      The router
- * @param[in]     neighbor    The neighbor
- * @param[in]     buffer      The buffer
- * @param[in]     buffer_size The buffer size
+ * @param[in,out] router    The router
+ * @param[in,out] neighbor  The neighbor
+ * @param[in]     nread     The number of bytes read at the end of the neighbor buffer
  *
  * @return a status code
  */
-retcode_t router_read(router_t *const router, neighbor_t *const neighbor, void const *const buffer,
-                      size_t const buffer_size);
+retcode_t router_read(router_t *const router, neighbor_t *const neighbor, size_t const nread);
 
 /**
  * Writes data to a stream
@@ -85,6 +85,13 @@ retcode_t node_init(node_t* const node, core_t* const core, tangle_t* const tang
     return ret;
   }
 
+  log_info(logger_id, "Initializing transaction bytes cache\n");
+  if ((ret = transaction_bytes_cache_init(&node->transaction_bytes, node->conf.transaction_bytes_cache_size)) !=
+      RC_OK) {
+    log_critical(logger_id, "Initializing transaction bytes cache failed\n");
+    return ret;
+  }
+
   log_info(logger_id, "Initializing router\n");
   if ((ret = router_init(&node->router, node)) != RC_OK) {
     log_critical(logger_id, "Initializing router failed\n");
@@ -248,6 +255,7 @@ retcode_t node_destroy(node_t* const node) {
 
   tips_cache_destroy(&node->tips);
   recent_seen_bytes_cache_destroy(&node->recent_seen_bytes);
+  transaction_bytes_cache_destroy(&node->transaction_bytes);
   free(node->conf.neighbors);
 
   logger_helper_release(logger_id);
@@ -19,6 +19,7 @@
 #include "ciri/node/pipeline/validator.h"
 #include "ciri/node/recent_seen_bytes_cache.h"
 #include "ciri/node/tips_cache.h"
+#include "ciri/node/transaction_bytes_cache.h"
 #include "common/errors.h"
 
 #ifdef __cplusplus
@@ -42,6 +43,7 @@ typedef struct node_s {
   router_t router;
   tips_cache_t tips;
   recent_seen_bytes_cache_t recent_seen_bytes;
+  transaction_bytes_cache_t transaction_bytes;
 } iota_node_t;
 
 /**
@@ -11,6 +11,8 @@
 #include "utils/logger_helper.h"
 
 #define BROADCASTER_LOGGER_ID "broadcaster"
+// Maximum number of packets taken from the queue at once
+#define BROADCASTER_BATCH_SIZE 16
 
 static logger_id_t logger_id;
 
@@ -28,9 +30,15 @@ static logger_id_t logger_id;
  */
 static void *broadcaster_stage_routine(broadcaster_stage_t *const broadcaster) {
   tangle_t tangle;
-  lock_handle_t cond_lock;
+  router_neighbors_t const *neighbors = NULL;
   neighbor_t *neighbor = NULL;
-  protocol_gossip_queue_entry_t *entry = NULL;
+  void *entries[BROADCASTER_BATCH_SIZE];
+  protocol_gossip_t const *packet = NULL;
+  size_t count = 0;
+  uint64_t start_us = 0;
+  uint64_t epoch = 0;
+  bool failed = false;
+  retcode_t ret = RC_OK;
 
   if (broadcaster == NULL) {
     return NULL;
@@ -45,35 +53,36 @@ static void *broadcaster_stage_routine(broadcaster_stage_t *const broadcaster) {
     }
   }
 
-  lock_handle_init(&cond_lock);
-  lock_handle_lock(&cond_lock);
-
   while (broadcaster->running) {
-    lock_handle_lock(&broadcaster->lock);
-    entry = protocol_gossip_queue_pop(&broadcaster->queue);
-    lock_handle_unlock(&broadcaster->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&broadcaster->cond, &cond_lock);
+    if ((count = ring_buffer_peek(&broadcaster->queue, entries, BROADCASTER_BATCH_SIZE)) == 0) {
+      ring_buffer_wait(&broadcaster->queue);
       continue;
     }
 
-    log_debug(logger_id, "Broadcasting transaction\n");
-    rw_lock_handle_rdlock(&broadcaster->node->router.neighbors_lock);
-    NEIGHBORS_FOREACH(broadcaster->node->router.neighbors, neighbor) {
-      if (!endpoint_cmp(&entry->packet.source, &neighbor->endpoint) && neighbor->endpoint.stream != NULL) {
-        if (neighbor_send_bytes(broadcaster->node, &tangle, neighbor, entry->packet.content) != RC_OK) {
-          log_warning(logger_id, "Broadcasting transaction failed\n");
+    log_debug(logger_id, "Broadcasting %zu transactions\n", count);
+    epoch = router_neighbors_enter(&broadcaster->node->router);
+    neighbors = router_neighbors(&broadcaster->node->router);
+    for (size_t i = 0; i < count; i++) {
+      packet = (protocol_gossip_t const *)entries[i];
+      start_us = monotonic_timestamp_us();
+      failed = false;
+      NEIGHBORS_FOREACH(neighbors, neighbor) {
+        if (!endpoint_cmp(&packet->source, &neighbor->endpoint) && neighbor->endpoint.stream != NULL) {
+          // Packets are only queued here, the router writes them to each neighbor by batches
+          // Dropped packets are counted by the neighbor when its send queue is full
+          if ((ret = neighbor_send_bytes(broadcaster->node, &tangle, neighbor, packet->content)) != RC_OK &&
+              ret != RC_NEIGHBOR_SEND_QUEUE_FULL) {
+            log_warning(logger_id, "Broadcasting transaction failed\n");
+            failed = true;
+          }
         }
       }
+      stage_metrics_record(&broadcaster->metrics, start_us, failed);
     }
-    rw_lock_handle_unlock(&broadcaster->node->router.neighbors_lock);
-    free(entry);
+    router_neighbors_exit(&broadcaster->node->router, epoch);
+    ring_buffer_consume(&broadcaster->queue, count);
   }
 
-  lock_handle_unlock(&cond_lock);
-  lock_handle_destroy(&cond_lock);
-
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
   }
@@ -86,6 +95,8 @@ static void *broadcaster_stage_routine(broadcaster_stage_t *const broadcaster) {
  */
 
 retcode_t broadcaster_stage_init(broadcaster_stage_t *const broadcaster, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (broadcaster == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -94,20 +105,17 @@ retcode_t broadcaster_stage_init(broadcaster_stage_t *const broadcaster, node_t
 
   // Metadata
 
-  if (cond_handle_init(&broadcaster->cond) != 0) {
-    log_critical(logger_id, "Initializing condition variable failed\n");
-    return RC_COND_INIT;
-  }
-  if (lock_handle_init(&broadcaster->lock) != 0) {
-    log_critical(logger_id, "Initializing lock failed\n");
-    return RC_LOCK_INIT;
-  }
   broadcaster->running = false;
 
   // Data
 
   broadcaster->node = node;
-  broadcaster->queue = NULL;
+  stage_metrics_init(&broadcaster->metrics);
+  if ((ret = ring_buffer_init(&broadcaster->queue, sizeof(protocol_gossip_t), node->conf.stage_queue_size,
+                              RING_BUFFER_MULTI_PRODUCER)) != RC_OK) {
+    log_critical(logger_id, "Initializing broadcaster stage queue failed\n");
+    return ret;
+  }
 
   return RC_OK;
 }
@@ -138,10 +146,7 @@ retcode_t broadcaster_stage_stop(broadcaster_stage_t *const broadcaster) {
 
   log_info(logger_id, "Shutting down broadcaster stage thread\n");
   broadcaster->running = false;
-  if (cond_handle_signal(&broadcaster->cond) != 0) {
-    log_warning(logger_id, "Signaling condition variable failed\n");
-    ret = RC_COND_SIGNAL;
-  }
+  ring_buffer_wake(&broadcaster->queue);
   if (thread_handle_join(broadcaster->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down broadcaster stage thread failed\n");
     ret = RC_THREAD_JOIN;
@@ -159,21 +164,8 @@ retcode_t broadcaster_stage_destroy(broadcaster_stage_t *const broadcaster) {
     return RC_STILL_RUNNING;
   }
 
-  // Metadata
-
-  if (cond_handle_destroy(&broadcaster->cond) != 0) {
-    log_error(logger_id, "Destroying condition variable failed\n");
-    ret = RC_COND_DESTROY;
-  }
-  if (lock_handle_destroy(&broadcaster->lock) != 0) {
-    log_error(logger_id, "Destroying lock failed\n");
-    ret = RC_LOCK_DESTROY;
-  }
-
-  // Data
-
   broadcaster->node = NULL;
-  protocol_gossip_queue_free(&broadcaster->queue);
+  ring_buffer_destroy(&broadcaster->queue);
 
   logger_helper_release(logger_id);
 
@@ -187,30 +179,17 @@ retcode_t broadcaster_stage_add(broadcaster_stage_t *const broadcaster, protocol
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&broadcaster->lock);
-  ret = protocol_gossip_queue_push(&broadcaster->queue, packet);
-  lock_handle_unlock(&broadcaster->lock);
-
-  if (ret != RC_OK) {
+  if ((ret = ring_buffer_push(&broadcaster->queue, packet)) != RC_OK && ret != RC_UTILS_RING_BUFFER_FULL) {
     log_warning(logger_id, "Pushing packet to broadcaster stage queue failed\n");
-    return ret;
   }
 
-  cond_handle_signal(&broadcaster->cond);
-
   return ret;
 }
 
 size_t broadcaster_stage_size(broadcaster_stage_t *const broadcaster) {
-  size_t size = 0;
-
   if (broadcaster == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&broadcaster->lock);
-  size = protocol_gossip_queue_count(broadcaster->queue);
-  lock_handle_unlock(&broadcaster->lock);
-
-  return size;
+  return ring_buffer_size(&broadcaster->queue);
 }
@@ -12,8 +12,8 @@
 
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "ciri/node/pipeline/stage_metrics.h"
+#include "utils/containers/ring_buffer.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -29,13 +29,12 @@ typedef struct node_s node_t;
  */
 typedef struct broadcaster_stage_s {
   // Metadata
-  cond_handle_t cond;     /*!< Condition variable to wait/signal the broadcaster */
-  lock_handle_t lock;     /*!< Lock for the broadcaster queue */
   bool running;           /*!< State of the broadcaster */
   thread_handle_t thread; /*!< Handle for the broadcaster thread */
   // Data
-  node_t *node;                  /*!< The parent node */
-  protocol_gossip_queue_t queue; /*!< A queue of packets to be broadcasted */
+  node_t *node;        /*!< The parent node */
+  ring_buffer_t queue; /*!< A queue of packets (protocol_gossip_t) to be broadcasted */
+  stage_metrics_t metrics; /*!< Packets broadcasted and time taken to queue them to all neighbors */
 } broadcaster_stage_t;
 
 /**
@@ -5,19 +5,26 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "ciri/node/node.h"
 #include "ciri/node/pipeline/hasher.h"
-#include "common/crypto/curl-p/ptrit.h"
+#include "common/crypto/curl-p/ptrit_wide.h"
 #include "common/model/transaction.h"
 #include "common/trinary/flex_trit.h"
-#include "common/trinary/trit_byte.h"
 #include "common/trinary/trit_ptrit.h"
 #include "utils/logger_helper.h"
+#include "utils/system.h"
+#include "utils/time.h"
 
 #define HASHER_LOGGER_ID "hasher"
-#define HASHER_MAX 64
+// Time to wait for the validator when its queue is full
+#define HASHER_BACKOFF_MS 1
+// Period at which a worker checks whether its lanes filled up
+#define HASHER_FILL_POLL_US 50
+// Weight of the last batch in the arrival rate of a worker
+#define HASHER_ARRIVAL_RATE_WEIGHT 0.25
 
 static logger_id_t logger_id;
 
@@ -25,79 +32,120 @@ static logger_id_t logger_id;
  * Private functions
  */
 
-static void *hasher_stage_routine(hasher_stage_t *const hasher) {
-  hasher_payload_queue_entry_t *entries[HASHER_MAX] = {NULL};
-  lock_handle_t lock_cond;
-  size_t packets_num = 0;
-  trit_t tx[NUM_TRITS_SERIALIZED_TRANSACTION];
-  ptrit_t acc[NUM_TRITS_SERIALIZED_TRANSACTION];
-  trit_t hash[HASH_LENGTH_TRIT];
-  flex_trit_t flex_hash[FLEX_TRIT_SIZE_243];
-  PCurl curl;
+/**
+ * Updates the arrival rate of a worker with the packets queued since its previous batch
+ */
+static void hasher_worker_update_arrival_rate(hasher_worker_t *const worker, void *const *const entries,
+                                              size_t const packets_num) {
+  uint64_t const last_arrival_us = ((hasher_payload_t const *)entries[packets_num - 1])->timestamp_us;
+  size_t arrived = 0;
 
-  if (hasher == NULL) {
-    return NULL;
+  if (last_arrival_us <= worker->last_arrival_us) {
+    return;
   }
+  for (size_t i = 0; i < packets_num; i++) {
+    arrived += ((hasher_payload_t const *)entries[i])->timestamp_us > worker->last_arrival_us;
+  }
+  if (worker->last_arrival_us != 0) {
+    worker->arrival_rate += HASHER_ARRIVAL_RATE_WEIGHT *
+                            ((double)arrived / (last_arrival_us - worker->last_arrival_us) - worker->arrival_rate);
+  }
+  worker->last_arrival_us = last_arrival_us;
+}
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
-  while (hasher->running) {
-    packets_num = 0;
-    ptrit_curl_init(&curl, CURL_P_81);
-    memset(acc, 0, NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_t));
-    memset(flex_hash, FLEX_TRIT_NULL_VALUE, sizeof(flex_hash));
+/**
+ * Waits for more packets to fill the lanes of a batch, until the oldest packet has waited for the batch deadline.
+ * Doesn't wait at all when the recent arrival rate wouldn't fill the lanes in time, so that a lightly loaded node
+ * hashes packets as soon as they arrive.
+ */
+static size_t hasher_worker_fill(hasher_worker_t *const worker, void **const entries, size_t packets_num) {
+  hasher_stage_t const *const hasher = worker->hasher;
+  uint64_t const deadline_us = ((hasher_payload_t const *)entries[0])->timestamp_us + hasher->batch_deadline_us;
+  uint64_t now_us = monotonic_timestamp_us(), left_us = 0;
+
+  while (hasher->running && packets_num < hasher->lanes && now_us < deadline_us) {
+    left_us = deadline_us - now_us;
+    if (worker->arrival_rate * left_us < hasher->lanes - packets_num) {
+      break;
+    }
+    sleep_us(left_us < HASHER_FILL_POLL_US ? left_us : HASHER_FILL_POLL_US);
+    packets_num = ring_buffer_peek(&worker->queue, entries, hasher->lanes);
+    now_us = monotonic_timestamp_us();
+  }
 
-    while (hasher->running && packets_num < HASHER_MAX) {
-      lock_handle_lock(&hasher->lock);
-      entries[packets_num] = hasher_payload_queue_pop(&hasher->queue);
-      lock_handle_unlock(&hasher->lock);
+  return packets_num;
+}
 
-      if (entries[packets_num] == NULL) {
-        break;
-      }
+static void *hasher_worker_routine(hasher_worker_t *const worker) {
+  hasher_stage_t *const hasher = worker->hasher;
+  void *entries[PTRIT_WIDE_LANES] = {NULL};
+  hasher_payload_t const *payload = NULL;
+  size_t packets_num = 0, forwarded = 0;
+  byte_t const *contents[PTRIT_WIDE_LANES] = {NULL};
+  ptrit_wide_t *acc = NULL;
+  trit_t hash[HASH_LENGTH_TRIT];
+  flex_trit_t flex_hash[FLEX_TRIT_SIZE_243];
+  PCurlWide *curl = NULL;
+  uint64_t hashed_us = 0;
+  retcode_t ret = RC_OK;
 
-      bytes_to_trits(entries[packets_num]->payload.gossip->packet.content, GOSSIP_TX_BYTES_LENGTH, tx,
-                     NUM_TRITS_SERIALIZED_TRANSACTION);
-      trits_to_ptrits(tx, acc, packets_num, NUM_TRITS_SERIALIZED_TRANSACTION);
+  if ((acc = (ptrit_wide_t *)malloc(NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_wide_t))) == NULL ||
+      (curl = (PCurlWide *)malloc(sizeof(PCurlWide))) == NULL) {
+    log_critical(logger_id, "Allocating hasher worker buffers failed\n");
+    free(acc);
+    return NULL;
+  }
 
-      packets_num++;
+  while (hasher->running) {
+    // The packets are hashed in place, their slots are released once passed on to the validator
+    if ((packets_num = ring_buffer_peek(&worker->queue, entries, hasher->lanes)) == 0) {
+      ring_buffer_wait(&worker->queue);
+      continue;
     }
-
-    if (!hasher->running) {
-      break;
+    if (packets_num < hasher->lanes && hasher->batch_deadline_us > 0) {
+      packets_num = hasher_worker_fill(worker, entries, packets_num);
     }
+    hasher_worker_update_arrival_rate(worker, entries, packets_num);
 
-    if (packets_num == 0) {
-      cond_handle_wait(&hasher->cond, &lock_cond);
-      continue;
+    for (size_t j = 0; j < packets_num; j++) {
+      contents[j] = ((hasher_payload_t const *)entries[j])->gossip.content;
     }
+    memset(flex_hash, FLEX_TRIT_NULL_VALUE, sizeof(flex_hash));
 
-    ptrit_curl_absorb(&curl, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
-    ptrit_curl_squeeze(&curl, acc, HASH_LENGTH_TRIT);
+    bytes_to_ptrits_wide(contents, packets_num, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ptrit_wide_curl_init(curl, CURL_P_81, packets_num);
+    ptrit_wide_curl_absorb(curl, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ptrit_wide_curl_squeeze(curl, acc, HASH_LENGTH_TRIT);
+    hashed_us = monotonic_timestamp_us();
+    atomic_fetch_add_explicit(&worker->batches, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&worker->packets, packets_num, memory_order_relaxed);
+    if (packets_num == hasher->lanes) {
+      atomic_fetch_add_explicit(&worker->full_batches, 1, memory_order_relaxed);
+    }
 
-    for (size_t j = 0; hasher->running && j < packets_num; j++) {
-      ptrits_to_trits(acc, hash, j, HASH_LENGTH_TRIT);
+    for (forwarded = 0; hasher->running && forwarded < packets_num; forwarded++) {
+      payload = (hasher_payload_t const *)entries[forwarded];
+      ptrits_wide_to_trits(acc, hash, forwarded, HASH_LENGTH_TRIT);
       flex_trits_from_trits(flex_hash, HASH_LENGTH_TRIT, hash, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
 
-      if (validator_stage_add(&hasher->node->validator, entries[j]->payload.gossip, entries[j]->payload.digest,
-                              entries[j]->payload.neighbor, flex_hash) != RC_OK) {
-        log_warning(logger_id, "Propagating request to responder failed\n");
+      if ((ret = validator_stage_add(&hasher->node->validator, &payload->gossip, payload->digest, payload->neighbor,
+                                     flex_hash)) == RC_UTILS_RING_BUFFER_FULL) {
+        // The rest of the batch is hashed again once the validator caught up
+        break;
+      } else if (ret != RC_OK) {
+        log_warning(logger_id, "Propagating packet to validator failed\n");
       }
-
-      free(entries[j]);
-      entries[j] = NULL;
+      histogram_record(&worker->latency, hashed_us > payload->timestamp_us ? hashed_us - payload->timestamp_us : 0);
     }
-  }
 
-  for (size_t j = 0; j < HASHER_MAX; j++) {
-    if (entries[j] != NULL) {
-      free(entries[j]);
+    ring_buffer_consume(&worker->queue, forwarded);
+    if (forwarded < packets_num) {
+      sleep_ms(HASHER_BACKOFF_MS);
     }
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
+  free(acc);
+  free(curl);
 
   return NULL;
 }
@@ -107,6 +155,9 @@ static void *hasher_stage_routine(hasher_stage_t *const hasher) {
  */
 
 retcode_t hasher_stage_init(hasher_stage_t *const hasher, node_t *const node) {
+  retcode_t ret = RC_OK;
+  hasher_worker_t *worker = NULL;
+
   if (hasher == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -114,10 +165,39 @@ retcode_t hasher_stage_init(hasher_stage_t *const hasher, node_t *const node) {
   logger_id = logger_helper_enable(HASHER_LOGGER_ID, LOGGER_DEBUG, true);
 
   hasher->running = false;
-  hasher->queue = NULL;
-  lock_handle_init(&hasher->lock);
-  cond_handle_init(&hasher->cond);
+  hasher->workers_num = node->conf.hasher_threads > 0 ? node->conf.hasher_threads : system_cpu_available();
+  if (hasher->workers_num == 0) {
+    hasher->workers_num = 1;
+  }
+  hasher->next_worker = 0;
+  hasher->lanes = ptrit_wide_lanes();
+  hasher->batch_deadline_us = node->conf.hasher_batch_deadline_us;
   hasher->node = node;
+  if ((hasher->workers = (hasher_worker_t *)calloc(hasher->workers_num, sizeof(hasher_worker_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  for (size_t i = 0; i < hasher->workers_num; i++) {
+    worker = &hasher->workers[i];
+    // The processor is the only producer
+    if ((ret = ring_buffer_init(&worker->queue, sizeof(hasher_payload_t), node->conf.stage_queue_size,
+                                RING_BUFFER_SINGLE_PRODUCER)) != RC_OK) {
+      log_critical(logger_id, "Initializing hasher worker queue failed\n");
+      while (i-- > 0) {
+        ring_buffer_destroy(&hasher->workers[i].queue);
+      }
+      free(hasher->workers);
+      hasher->workers = NULL;
+      return ret;
+    }
+    worker->hasher = hasher;
+    worker->arrival_rate = 0;
+    worker->last_arrival_us = 0;
+    atomic_init(&worker->batches, 0);
+    atomic_init(&worker->packets, 0);
+    atomic_init(&worker->full_batches, 0);
+    histogram_reset(&worker->latency);
+  }
 
   return RC_OK;
 }
@@ -127,11 +207,19 @@ retcode_t hasher_stage_start(hasher_stage_t *const hasher) {
     return RC_NULL_PARAM;
   }
 
-  log_info(logger_id, "Spawning hasher stage thread\n");
+  log_info(logger_id, "Spawning %zu hasher stage threads of %zu lanes\n", hasher->workers_num, hasher->lanes);
   hasher->running = true;
-  if (thread_handle_create(&hasher->thread, (thread_routine_t)hasher_stage_routine, hasher) != 0) {
-    log_critical(logger_id, "Spawning hasher stage thread failed\n");
-    return RC_THREAD_CREATE;
+  for (size_t i = 0; i < hasher->workers_num; i++) {
+    if (thread_handle_create(&hasher->workers[i].thread, (thread_routine_t)hasher_worker_routine,
+                             &hasher->workers[i]) != 0) {
+      log_critical(logger_id, "Spawning hasher stage thread failed\n");
+      hasher->running = false;
+      while (i-- > 0) {
+        ring_buffer_wake(&hasher->workers[i].queue);
+        thread_handle_join(hasher->workers[i].thread, NULL);
+      }
+      return RC_THREAD_CREATE;
+    }
   }
 
   return RC_OK;
@@ -139,6 +227,7 @@ retcode_t hasher_stage_start(hasher_stage_t *const hasher) {
 
 retcode_t hasher_stage_stop(hasher_stage_t *const hasher) {
   retcode_t ret = RC_OK;
+  hasher_stage_metrics_t metrics;
 
   if (hasher == NULL) {
     return RC_NULL_PARAM;
@@ -146,12 +235,22 @@ retcode_t hasher_stage_stop(hasher_stage_t *const hasher) {
     return RC_OK;
   }
 
-  log_info(logger_id, "Shutting down hasher stage thread\n");
+  log_info(logger_id, "Shutting down hasher stage threads\n");
   hasher->running = false;
-  cond_handle_signal(&hasher->cond);
-  if (thread_handle_join(hasher->thread, NULL) != 0) {
-    log_error(logger_id, "Shutting down hasher stage thread failed\n");
-    ret = RC_THREAD_JOIN;
+  for (size_t i = 0; i < hasher->workers_num; i++) {
+    ring_buffer_wake(&hasher->workers[i].queue);
+    if (thread_handle_join(hasher->workers[i].thread, NULL) != 0) {
+      log_error(logger_id, "Shutting down hasher stage thread failed\n");
+      ret = RC_THREAD_JOIN;
+    }
+  }
+
+  if (hasher_stage_metrics(hasher, &metrics) == RC_OK && metrics.batches > 0) {
+    log_info(logger_id,
+             "Hashed %" PRIu64 " packets in %" PRIu64 " batches, %.1f%% lane occupancy, latency p50 %" PRIu64
+             " us p99 %" PRIu64 " us\n",
+             metrics.packets, metrics.batches, metrics.lane_occupancy * 100, metrics.latency_p50_us,
+             metrics.latency_p99_us);
   }
 
   return ret;
@@ -166,105 +265,96 @@ retcode_t hasher_stage_destroy(hasher_stage_t *const hasher) {
     return RC_STILL_RUNNING;
   }
 
-  hasher_payload_queue_free(&hasher->queue);
-  lock_handle_destroy(&hasher->lock);
-  cond_handle_destroy(&hasher->cond);
+  if (hasher->workers != NULL) {
+    for (size_t i = 0; i < hasher->workers_num; i++) {
+      ring_buffer_destroy(&hasher->workers[i].queue);
+    }
+    free(hasher->workers);
+    hasher->workers = NULL;
+  }
 
   logger_helper_release(logger_id);
 
   return ret;
 }
 
-retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_queue_entry_t *const gossip,
-                           uint64_t const digest, neighbor_t *const neighbor) {
+retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_t const *const gossip, uint64_t const digest,
+                           neighbor_t *const neighbor) {
+  hasher_payload_t payload;
+  size_t index = 0;
   retcode_t ret = RC_OK;
 
-  if (hasher == NULL) {
+  if (hasher == NULL || gossip == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&hasher->lock);
-  ret = hasher_payload_queue_push(&hasher->queue, gossip, digest, neighbor);
-  lock_handle_unlock(&hasher->lock);
-
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to hasher stage queue failed\n");
-    return ret;
-  } else {
-    cond_handle_signal(&hasher->cond);
+  memcpy(&payload.gossip, gossip, sizeof(protocol_gossip_t));
+  payload.digest = digest;
+  payload.neighbor = neighbor;
+  payload.timestamp_us = monotonic_timestamp_us();
+
+  // First pass skips the workers that already have a batch worth of packets, second pass takes any room left
+  for (size_t pass = 0; pass < 2; pass++) {
+    for (size_t i = 0; i < hasher->workers_num; i++) {
+      index = (hasher->next_worker + i) % hasher->workers_num;
+      if (pass == 0 && ring_buffer_size(&hasher->workers[index].queue) >= hasher->lanes) {
+        continue;
+      }
+      if ((ret = ring_buffer_push(&hasher->workers[index].queue, &payload)) != RC_UTILS_RING_BUFFER_FULL) {
+        hasher->next_worker = index;
+        if (ret != RC_OK) {
+          log_warning(logger_id, "Pushing packet to hasher stage queue failed\n");
+        }
+        return ret;
+      }
+    }
   }
 
-  return RC_OK;
+  return RC_UTILS_RING_BUFFER_FULL;
 }
 
 size_t hasher_stage_size(hasher_stage_t *const hasher) {
   size_t size = 0;
 
-  if (hasher == NULL) {
+  if (hasher == NULL || hasher->workers == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&hasher->lock);
-  size = hasher_payload_queue_count(hasher->queue);
-  lock_handle_unlock(&hasher->lock);
+  for (size_t i = 0; i < hasher->workers_num; i++) {
+    size += ring_buffer_size(&hasher->workers[i].queue);
+  }
 
   return size;
 }
 
-size_t hasher_payload_queue_count(hasher_payload_queue_t const queue) {
-  hasher_payload_queue_entry_t *iter = NULL;
-  size_t count = 0;
-
-  CDL_COUNT(queue, iter, count);
-
-  return count;
-}
-
-retcode_t hasher_payload_queue_push(hasher_payload_queue_t *const queue, protocol_gossip_queue_entry_t *const gossip,
-                                    uint64_t const digest, neighbor_t *const neighbor) {
-  hasher_payload_queue_entry_t *entry = NULL;
+retcode_t hasher_stage_metrics(hasher_stage_t const *const hasher, hasher_stage_metrics_t *const metrics) {
+  histogram_t latency;
+  hasher_worker_t const *worker = NULL;
 
-  if (queue == NULL || gossip == NULL) {
+  if (hasher == NULL || metrics == NULL) {
     return RC_NULL_PARAM;
   }
 
-  if ((entry = (hasher_payload_queue_entry_t *)malloc(sizeof(hasher_payload_queue_entry_t))) == NULL) {
-    return RC_OOM;
-  }
-
-  entry->payload.gossip = gossip;
-  entry->payload.digest = digest;
-  entry->payload.neighbor = neighbor;
-  CDL_APPEND(*queue, entry);
-
-  return RC_OK;
-}
-
-hasher_payload_queue_entry_t *hasher_payload_queue_pop(hasher_payload_queue_t *const queue) {
-  hasher_payload_queue_entry_t *front = NULL;
-
-  if (queue == NULL) {
-    return NULL;
-  }
-
-  front = *queue;
-  if (front != NULL) {
-    CDL_DELETE(*queue, front);
+  memset(metrics, 0, sizeof(hasher_stage_metrics_t));
+  metrics->workers = hasher->workers_num;
+  metrics->lanes = hasher->lanes;
+  histogram_reset(&latency);
+  for (size_t i = 0; hasher->workers != NULL && i < hasher->workers_num; i++) {
+    worker = &hasher->workers[i];
+    metrics->batches += atomic_load_explicit(&worker->batches, memory_order_relaxed);
+    metrics->packets += atomic_load_explicit(&worker->packets, memory_order_relaxed);
+    metrics->full_batches += atomic_load_explicit(&worker->full_batches, memory_order_relaxed);
+    histogram_merge(&latency, &worker->latency);
   }
 
-  return front;
-}
-
-void hasher_payload_queue_free(hasher_payload_queue_t *const queue) {
-  hasher_payload_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
-
-  if (queue == NULL) {
-    return;
+  if (metrics->batches > 0) {
+    metrics->lane_occupancy = (double)metrics->packets / (metrics->batches * metrics->lanes);
   }
+  metrics->latency_mean_us = histogram_mean(&latency);
+  metrics->latency_p50_us = histogram_percentile(&latency, 50);
+  metrics->latency_p90_us = histogram_percentile(&latency, 90);
+  metrics->latency_p99_us = histogram_percentile(&latency, 99);
+  metrics->latency_max_us = histogram_max(&latency);
 
-  CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
-    CDL_DELETE(*queue, iter);
-    free(iter);
-  }
-  *queue = NULL;
+  return RC_OK;
 }
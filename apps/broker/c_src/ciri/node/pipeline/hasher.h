@@ -8,43 +8,71 @@
 #ifndef __CIRI_NODE_PIPELINE_HASHER_H__
 #define __CIRI_NODE_PIPELINE_HASHER_H__
 
+#include <stdatomic.h>
 #include <stdbool.h>
 
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "utils/containers/ring_buffer.h"
 #include "utils/handles/thread.h"
+#include "utils/histogram.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 // Forward declarations
+typedef struct neighbor_s neighbor_t;
 typedef struct node_s node_t;
 
+typedef struct hasher_stage_s hasher_stage_t;
+
 typedef struct hasher_payload_s {
-  protocol_gossip_queue_entry_t *gossip;
+  protocol_gossip_t gossip;
   uint64_t digest;
   neighbor_t *neighbor;
+  uint64_t timestamp_us;  // When the payload was queued
 } hasher_payload_t;
 
-typedef struct hasher_payload_queue_entry_s {
-  hasher_payload_t payload;
-  struct hasher_payload_queue_entry_s *next;
-  struct hasher_payload_queue_entry_s *prev;
-} hasher_payload_queue_entry_t;
-
-typedef hasher_payload_queue_entry_t *hasher_payload_queue_t;
-
-typedef struct hasher_stage_s {
+/**
+ * A hasher thread, hashing the packets of its own queue by batches of up to ptrit_wide_lanes() packets.
+ * Counters are written by the thread only and may be read at any time.
+ */
+typedef struct hasher_worker_s {
   thread_handle_t thread;
+  ring_buffer_t queue;  // Of hasher_payload_t, pushed by the processor
+  hasher_stage_t *hasher;
+  double arrival_rate;      // Recent arrival rate of packets, per microsecond
+  uint64_t last_arrival_us;  // Queuing time of the last packet hashed
+  atomic_uint_fast64_t batches;
+  atomic_uint_fast64_t packets;
+  atomic_uint_fast64_t full_batches;
+  histogram_t latency;  // Time from queuing to hash, in microseconds
+} hasher_worker_t;
+
+struct hasher_stage_s {
   bool running;
-  hasher_payload_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  hasher_worker_t *workers;
+  size_t workers_num;
+  size_t next_worker;  // Worker being filled by the processor
+  size_t lanes;
+  uint64_t batch_deadline_us;
   node_t *node;
-} hasher_stage_t;
+};
+
+typedef struct hasher_stage_metrics_s {
+  size_t workers;
+  size_t lanes;
+  uint64_t batches;
+  uint64_t packets;
+  uint64_t full_batches;
+  double lane_occupancy;  // Average share of the lanes of a batch carrying a packet, in [0, 1]
+  double latency_mean_us;
+  uint64_t latency_p50_us;
+  uint64_t latency_p90_us;
+  uint64_t latency_p99_us;
+  uint64_t latency_max_us;
+} hasher_stage_metrics_t;
 
 /**
  * Initializes a hasher stage
@@ -86,64 +114,37 @@ retcode_t hasher_stage_destroy(hasher_stage_t *const hasher);
 /**
  * Adds a payload to a hasher stage queue
  *
+ * The processor keeps filling the queue of a worker until it holds a batch worth of packets, then moves on to the next
+ * one, so that batches are full under load and a single worker is busy when idle.
+ *
  * @param[in, out]  hasher    The hasher stage
- * @param[in]       gossip    A gossip packet
+ * @param[in]       gossip    A gossip packet, copied in the queue
  * @param[in]       digest    The digest of the gossip transaction
  * @param[in]       neighbor  The neighbor that sent the packet
  *
- * @return a status code
+ * @return a status code, RC_UTILS_RING_BUFFER_FULL if the queue is full
  */
-retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_queue_entry_t *const gossip,
-                           uint64_t const digest, neighbor_t *const neighbor);
+retcode_t hasher_stage_add(hasher_stage_t *const hasher, protocol_gossip_t const *const gossip, uint64_t const digest,
+                           neighbor_t *const neighbor);
 
 /**
  * Gets the size of the hasher stage queue
  *
  * @param[in, out]  hasher  The hasher stage
  *
- * @return a status code
+ * @return the number of packets queued to all workers
  */
 size_t hasher_stage_size(hasher_stage_t *const hasher);
 
 /**
- * Gets the size of a hasher payload queue
- *
- * @param[in] queue The hasher payload queue
- *
- * @return the size of the packet queue
- */
-size_t hasher_payload_queue_count(hasher_payload_queue_t const queue);
-
-/**
- * Pushes a packet to a hasher payload queue
- *
- * @param[out]  queue     The hasher payload queue
- * @param[in]   gossip    A gossip packet
- * @param[in]   digest    The digest of the gossip transaction
- * @param[in]   neighbor  The neighbor that sent the packet
- *
- * @return a status code
- */
-retcode_t hasher_payload_queue_push(hasher_payload_queue_t *const queue, protocol_gossip_queue_entry_t *const gossip,
-                                    uint64_t const digest, neighbor_t *const neighbor);
-
-/**
- * Pops a packet from a hasher payload queue
- *
- * @param[out]  queue The hasher payload queue
- *
- * @return the hasher payload
- */
-hasher_payload_queue_entry_t *hasher_payload_queue_pop(hasher_payload_queue_t *const queue);
-
-/**
- * Frees a hasher payload queue
+ * Gets the lane occupancy and hash latency of a hasher stage since it was initialized
  *
- * @param[out]  queue The hasher payload queue
+ * @param[in]   hasher  The hasher stage
+ * @param[out]  metrics The metrics
  *
  * @return a status code
  */
-void hasher_payload_queue_free(hasher_payload_queue_t *const queue);
+retcode_t hasher_stage_metrics(hasher_stage_t const *const hasher, hasher_stage_metrics_t *const metrics);
 
 #ifdef __cplusplus
 }
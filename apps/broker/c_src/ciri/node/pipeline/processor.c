@@ -10,8 +10,13 @@
 #include "ciri/node/node.h"
 #include "ciri/node/pipeline/hasher.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define PROCESSOR_LOGGER_ID "processor"
+// Maximum number of packets taken from the queue at once
+#define PROCESSOR_BATCH_SIZE 64
+// Time to wait for the hasher when its queue is full
+#define PROCESSOR_BACKOFF_MS 1
 
 static logger_id_t logger_id;
 
@@ -20,67 +25,71 @@ static logger_id_t logger_id;
  */
 
 /**
- * Continuously looks for a packet from a processor packet queue and process it.
+ * Continuously looks for packets from a processor packet queue and process them.
+ * Packets that can't be passed on to the hasher stay in the queue, backing the router off.
  *
  * @param processor The processor stage
  */
 static void *processor_stage_routine(processor_stage_t *const processor) {
-  protocol_gossip_queue_entry_t *entry = NULL;
+  void *entries[PROCESSOR_BATCH_SIZE];
+  protocol_gossip_t const *packet = NULL;
   neighbor_t *neighbor = NULL;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
   uint64_t digest = 0;
   bool cached = false;
-  lock_handle_t lock_cond;
+  size_t count = 0, processed = 0;
+  uint64_t start_us = 0;
+  retcode_t ret = RC_OK;
 
   if (processor == NULL) {
     return NULL;
   }
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
   while (processor->running) {
-    lock_handle_lock(&processor->lock);
-    entry = protocol_gossip_queue_pop(&processor->queue);
-    lock_handle_unlock(&processor->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&processor->cond, &lock_cond);
+    if ((count = ring_buffer_peek(&processor->queue, entries, PROCESSOR_BATCH_SIZE)) == 0) {
+      ring_buffer_wait(&processor->queue);
       continue;
     }
 
-    rw_lock_handle_rdlock(&processor->node->router.neighbors_lock);
-    neighbor = router_neighbor_find_by_endpoint(&processor->node->router, &entry->packet.source);
-    rw_lock_handle_unlock(&processor->node->router.neighbors_lock);
+    for (processed = 0; processed < count; processed++) {
+      packet = (protocol_gossip_t const *)entries[processed];
+      start_us = monotonic_timestamp_us();
 
-    if (neighbor) {
-      log_debug(logger_id, "Processing packet from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
-                neighbor->endpoint.port);
-      neighbor->nbr_all_txs++;
-    } else {
-      log_debug(logger_id, "Processing packet from API\n");
-    }
+      neighbor = router_neighbor_find_by_endpoint(&processor->node->router, &packet->source);
 
-    recent_seen_bytes_cache_hash(entry->packet.content, &digest);
-    recent_seen_bytes_cache_get(&processor->node->recent_seen_bytes, digest, hash, &cached);
+      recent_seen_bytes_cache_hash(packet->content, &digest);
+      recent_seen_bytes_cache_get(&processor->node->recent_seen_bytes, digest, hash, &cached);
 
-    if (cached) {
-      if (neighbor) {
-        log_debug(logger_id, "Processing request bytes\n");
-        if (responder_process_request(&processor->node->responder, neighbor, &entry->packet, hash) != RC_OK) {
-          log_warning(logger_id, "Processing request bytes failed\n");
+      if (cached) {
+        if (neighbor) {
+          log_debug(logger_id, "Processing request bytes\n");
+          if (responder_process_request(&processor->node->responder, neighbor, packet, hash) != RC_OK) {
+            log_warning(logger_id, "Processing request bytes failed\n");
+          }
         }
-      }
-      free(entry);
-    } else {
-      if (hasher_stage_add(&processor->node->hasher, entry, digest, neighbor) != RC_OK) {
+      } else if ((ret = hasher_stage_add(&processor->node->hasher, packet, digest, neighbor)) ==
+                 RC_UTILS_RING_BUFFER_FULL) {
+        // Retried once the hasher caught up
+        break;
+      } else if (ret != RC_OK) {
         log_warning(logger_id, "Sending payload to hasher stage failed\n");
       }
+
+      if (neighbor) {
+        log_debug(logger_id, "Processing packet from neighbor tcp://%s:%d\n", neighbor->endpoint.domain,
+                  neighbor->endpoint.port);
+        neighbor->nbr_all_txs++;
+      } else {
+        log_debug(logger_id, "Processing packet from API\n");
+      }
+      stage_metrics_record(&processor->metrics, start_us, false);
     }
-  }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
+    ring_buffer_consume(&processor->queue, processed);
+    if (processed < count) {
+      sleep_ms(PROCESSOR_BACKOFF_MS);
+    }
+  }
 
   return NULL;
 }
@@ -90,6 +99,8 @@ static void *processor_stage_routine(processor_stage_t *const processor) {
  */
 
 retcode_t processor_stage_init(processor_stage_t *const processor, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (processor == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -97,9 +108,12 @@ retcode_t processor_stage_init(processor_stage_t *const processor, node_t *const
   logger_id = logger_helper_enable(PROCESSOR_LOGGER_ID, LOGGER_DEBUG, true);
 
   processor->running = false;
-  processor->queue = NULL;
-  lock_handle_init(&processor->lock);
-  cond_handle_init(&processor->cond);
+  stage_metrics_init(&processor->metrics);
+  if ((ret = ring_buffer_init(&processor->queue, sizeof(protocol_gossip_t), node->conf.stage_queue_size,
+                              RING_BUFFER_MULTI_PRODUCER)) != RC_OK) {
+    log_critical(logger_id, "Initializing processor stage queue failed\n");
+    return ret;
+  }
   processor->node = node;
 
   return RC_OK;
@@ -129,7 +143,7 @@ retcode_t processor_stage_stop(processor_stage_t *const processor) {
 
   log_info(logger_id, "Shutting down processor stage thread\n");
   processor->running = false;
-  cond_handle_signal(&processor->cond);
+  ring_buffer_wake(&processor->queue);
   if (thread_handle_join(processor->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down processor stage thread failed\n");
     return RC_THREAD_JOIN;
@@ -145,9 +159,7 @@ retcode_t processor_stage_destroy(processor_stage_t *const processor) {
     return RC_STILL_RUNNING;
   }
 
-  protocol_gossip_queue_free(&processor->queue);
-  lock_handle_destroy(&processor->lock);
-  cond_handle_destroy(&processor->cond);
+  ring_buffer_destroy(&processor->queue);
   processor->node = NULL;
 
   logger_helper_release(logger_id);
@@ -162,30 +174,46 @@ retcode_t processor_stage_add(processor_stage_t *const processor, protocol_gossi
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&processor->lock);
-  ret = protocol_gossip_queue_push(&processor->queue, packet);
-  lock_handle_unlock(&processor->lock);
+  if ((ret = ring_buffer_push(&processor->queue, packet)) != RC_OK) {
+    if (ret != RC_UTILS_RING_BUFFER_FULL) {
+      log_warning(logger_id, "Pushing packet to processor stage queue failed\n");
+    }
+    return ret;
+  }
+
+  return RC_OK;
+}
+
+retcode_t processor_stage_add_payload(processor_stage_t *const processor, byte_t const *const payload,
+                                      uint16_t const length, char const *const ip, uint16_t const port) {
+  protocol_gossip_t *packet = NULL;
+  retcode_t ret = RC_OK;
 
-  if (ret != RC_OK) {
-    log_warning(logger_id, "Pushing packet to processor stage queue failed\n");
+  if (processor == NULL || payload == NULL) {
+    return RC_NULL_PARAM;
+  }
+  // Checked before reserving a slot, which can't be given back
+  if (length < GOSSIP_MIN_BYTES_LENGTH || length > GOSSIP_MAX_BYTES_LENGTH) {
+    return RC_INVALID_PACKET;
+  }
+
+  if ((ret = ring_buffer_reserve(&processor->queue, (void **)&packet)) != RC_OK) {
+    if (ret != RC_UTILS_RING_BUFFER_FULL) {
+      log_warning(logger_id, "Pushing packet to processor stage queue failed\n");
+    }
     return ret;
-  } else {
-    cond_handle_signal(&processor->cond);
   }
+  protocol_gossip_set_payload(packet, payload, length);
+  protocol_gossip_set_endpoint(packet, ip, port);
+  ring_buffer_commit(&processor->queue, packet);
 
   return RC_OK;
 }
 
 size_t processor_stage_size(processor_stage_t *const processor) {
-  size_t size = 0;
-
   if (processor == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&processor->lock);
-  size = protocol_gossip_queue_count(processor->queue);
-  lock_handle_unlock(&processor->lock);
-
-  return size;
+  return ring_buffer_size(&processor->queue);
 }
@@ -12,8 +12,8 @@
 
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "ciri/node/pipeline/stage_metrics.h"
+#include "utils/containers/ring_buffer.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -29,9 +29,8 @@ typedef struct node_s node_t;
 typedef struct processor_stage_s {
   thread_handle_t thread;
   bool running;
-  protocol_gossip_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  ring_buffer_t queue;  // Of protocol_gossip_t, pushed by the router and the API
+  stage_metrics_t metrics;
   node_t *node;
 } processor_stage_t;
 
@@ -78,10 +77,26 @@ retcode_t processor_stage_destroy(processor_stage_t *const processor);
  * @param processor The processor stage
  * @param packet The packet
  *
- * @return a status code
+ * @return a status code, RC_UTILS_RING_BUFFER_FULL if the queue is full and the packet dropped
  */
 retcode_t processor_stage_add(processor_stage_t *const processor, protocol_gossip_t const *const packet);
 
+/**
+ * Adds a gossip packet to a processor stage queue from its payload as framed in a receive buffer, the packet being
+ * built in its queue slot
+ *
+ * @param processor The processor stage
+ * @param payload The gossip payload, following the packet header
+ * @param length The payload length
+ * @param ip The IP address of the neighbor that sent the packet
+ * @param port The port of the neighbor that sent the packet
+ *
+ * @return a status code, RC_INVALID_PACKET if the length isn't one of a gossip payload, RC_UTILS_RING_BUFFER_FULL if
+ * the queue is full and the packet dropped
+ */
+retcode_t processor_stage_add_payload(processor_stage_t *const processor, byte_t const *const payload,
+                                      uint16_t const length, char const *const ip, uint16_t const port);
+
 /**
  * Gets the size of the processor stage queue
  *
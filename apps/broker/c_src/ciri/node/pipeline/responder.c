@@ -7,6 +7,7 @@
 
 #include "ciri/node/pipeline/responder.h"
 #include "ciri/consensus/tangle/tangle.h"
+#include "ciri/core.h"
 #include "ciri/node/network/neighbor.h"
 #include "ciri/node/node.h"
 #include "common/model/milestone.h"
@@ -14,6 +15,8 @@
 #include "utils/logger_helper.h"
 
 #define RESPONDER_LOGGER_ID "responder"
+// Maximum number of requests taken from the queue at once
+#define RESPONDER_BATCH_SIZE 16
 
 static logger_id_t logger_id;
 
@@ -22,41 +25,38 @@ static logger_id_t logger_id;
  */
 
 /**
- * Gets a transaction according to a request hash
+ * Gets the hash of the transaction to send according to a request hash
  * - if null hash: gets a random tip
- * - if non-null hash: gets the corresponding transaction
+ * - if non-null hash: gets the requested hash
  *
  * @param responder The responder
- * @param tangle A tangle
  * @param neighbor The requesting neighbor
  * @param hash The request hash
- * @param pack A stor pack to be filled with a transaction
+ * @param transaction The hash of the transaction to send, null if none
+ * @param respond Whether to respond to the request
  *
  * @return a status code
  */
-static retcode_t get_transaction_for_request(responder_stage_t const *const responder, tangle_t *const tangle,
-                                             neighbor_t *const neighbor, flex_trit_t const *const hash,
-                                             iota_stor_pack_t *const pack, bool *const respond) {
+static retcode_t get_transaction_for_request(responder_stage_t const *const responder, neighbor_t *const neighbor,
+                                             flex_trit_t const *const hash, flex_trit_t *const transaction,
+                                             bool *const respond) {
   retcode_t ret = RC_OK;
 
-  if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL) {
+  if (responder == NULL || neighbor == NULL || hash == NULL || transaction == NULL || respond == NULL) {
     return RC_NULL_PARAM;
   }
 
+  memset(transaction, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
+
   // If the hash is null, a random tip was requested
   if (flex_trits_are_null(hash, FLEX_TRIT_SIZE_243)) {
-    flex_trit_t tip[FLEX_TRIT_SIZE_243];
-
     // Don't reply to random tip requests if the node is synchronized
     *respond = !node_is_synced(responder->node);
-    if (respond) {
+    if (*respond) {
       log_debug(logger_id, "Responding to random tip request\n");
       neighbor->nbr_random_tx_reqs++;
-      if ((ret = tips_cache_random_tip(&responder->node->tips, tip)) != RC_OK) {
-        return ret;
-      }
-      if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, tip, pack)) != RC_OK ||
-          pack->num_loaded == 0) {
+      if ((ret = tips_cache_random_tip(&responder->node->tips, transaction)) != RC_OK) {
+        memset(transaction, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
         return ret;
       }
     }
@@ -64,15 +64,55 @@ static retcode_t get_transaction_for_request(responder_stage_t const *const resp
   // If the hash is non-null, a transaction was requested
   else {
     log_debug(logger_id, "Responding to regular transaction request\n");
-    if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, hash, pack)) != RC_OK) {
-      log_warning(logger_id, "Loading transaction failed\n");
-      return ret;
-    }
+    memcpy(transaction, hash, FLEX_TRIT_SIZE_243);
   }
 
   return ret;
 }
 
+/**
+ * Gets the gossip bytes of a transaction from the transaction bytes cache or, failing that, from the tangle, caching
+ * them
+ *
+ * @param responder The responder
+ * @param tangle A tangle
+ * @param hash The transaction hash
+ * @param pack A stor pack to load the transaction in
+ * @param bytes GOSSIP_TX_BYTES_LENGTH bytes to be filled with the transaction
+ * @param digest The digest of the bytes
+ * @param found Whether the transaction was found
+ *
+ * @return a status code
+ */
+static retcode_t get_transaction_bytes(responder_stage_t const *const responder, tangle_t *const tangle,
+                                       flex_trit_t const *const hash, iota_stor_pack_t *const pack,
+                                       byte_t *const bytes, uint64_t *const digest, bool *const found) {
+  retcode_t ret = RC_OK;
+  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
+
+  if ((ret = transaction_bytes_cache_get(&responder->node->transaction_bytes, hash, bytes, digest, found)) !=
+          RC_OK ||
+      *found) {
+    return ret;
+  }
+
+  hash_pack_reset(pack);
+  if ((ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, hash, pack)) != RC_OK) {
+    log_warning(logger_id, "Loading transaction failed\n");
+    return ret;
+  } else if (pack->num_loaded == 0) {
+    return RC_OK;
+  }
+
+  transaction_serialize_on_flex_trits(((iota_transaction_t **)(pack->models))[0], transaction_flex_trits);
+  flex_trits_to_bytes(bytes, NUM_TRITS_SERIALIZED_TRANSACTION, transaction_flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                      NUM_TRITS_SERIALIZED_TRANSACTION);
+  recent_seen_bytes_cache_hash(bytes, digest);
+  *found = true;
+
+  return transaction_bytes_cache_put(&responder->node->transaction_bytes, hash, bytes, *digest);
+}
+
 /**
  * Responds to a request by:
  * - sending a transaction to the requesting neighbor or
@@ -81,8 +121,8 @@ static retcode_t get_transaction_for_request(responder_stage_t const *const resp
  * @param responder The responder
  * @param tangle A tangle
  * @param neighbor The requesting neighbor
- * @param hash The request hash
- * @param pack A stor pack containing a transaction
+ * @param hash The hash of the transaction to send, null if none
+ * @param pack A stor pack to load transactions in
  *
  * @return a status code
  */
@@ -90,50 +130,45 @@ static retcode_t respond_to_request(responder_stage_t const *const responder, ta
                                     neighbor_t *const neighbor, flex_trit_t const *const hash,
                                     iota_stor_pack_t *const pack) {
   retcode_t ret = RC_OK;
-  flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
-  iota_transaction_t *transaction = NULL;
+  byte_t transaction_bytes[GOSSIP_MAX_BYTES_LENGTH];
+  flex_trit_t latest_milestone[FLEX_TRIT_SIZE_243];
+  uint64_t digest = 0;
+  bool found = false;
 
   if (responder == NULL || neighbor == NULL || hash == NULL || pack == NULL) {
     return RC_NULL_PARAM;
   }
 
   // Send the requested transaction back to the neighbor
-  if (pack->num_loaded != 0) {
-    byte_t transaction_bytes[GOSSIP_TX_BYTES_LENGTH];
-    uint64_t digest = 0;
-
-    transaction = ((iota_transaction_t **)(pack->models))[0];
-    transaction_serialize_on_flex_trits(transaction, transaction_flex_trits);
-    flex_trits_to_bytes(transaction_bytes, NUM_TRITS_SERIALIZED_TRANSACTION, transaction_flex_trits,
-                        NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
-    recent_seen_bytes_cache_hash(transaction_bytes, &digest);
+  if (!flex_trits_are_null(hash, FLEX_TRIT_SIZE_243) &&
+      get_transaction_bytes(responder, tangle, hash, pack, transaction_bytes, &digest, &found) == RC_OK && found) {
     recent_seen_bytes_cache_put(&responder->node->recent_seen_bytes, digest, hash);
-    if ((ret = neighbor_send_trits(responder->node, tangle, neighbor, transaction_flex_trits)) != RC_OK) {
+    if ((ret = neighbor_send_bytes(responder->node, tangle, neighbor, transaction_bytes)) != RC_OK) {
       log_warning(logger_id, "Sending transaction failed\n");
-      return ret;
     }
     return ret;
   }
 
   // we didn't have the requested transaction (random or explicit) from the neighbor but we will immediately reply
   // with the latest known milestone and a needed transaction hash, to keep up the ping-pong
-  {
-    DECLARE_PACK_SINGLE_MILESTONE(latest_milestone, latest_milestone_ptr, milestone_pack);
-
-    hash_pack_reset(pack);
-    if ((ret = iota_tangle_milestone_load_last(tangle, &milestone_pack)) != RC_OK || milestone_pack.num_loaded == 0 ||
-        (ret = iota_tangle_transaction_load(tangle, TRANSACTION_FIELD_HASH, latest_milestone.hash, pack)) != RC_OK ||
-        pack->num_loaded == 0) {
-      memset(transaction_flex_trits, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_8019);
-    } else {
-      transaction = ((iota_transaction_t **)(pack->models))[0];
-      transaction_serialize_on_flex_trits(transaction, transaction_flex_trits);
-    }
-    if ((ret = neighbor_send_trits(responder->node, tangle, neighbor, transaction_flex_trits)) != RC_OK) {
-      log_warning(logger_id, "Sending transaction failed\n");
-      return ret;
+  if (iota_milestone_tracker_get_latest_milestone(&responder->node->core->consensus.milestone_tracker,
+                                                 latest_milestone, NULL) != RC_OK ||
+      flex_trits_are_null(latest_milestone, FLEX_TRIT_SIZE_243) ||
+      get_transaction_bytes(responder, tangle, latest_milestone, pack, transaction_bytes, &digest, &found) != RC_OK ||
+      !found) {
+    DECLARE_PACK_SINGLE_MILESTONE(milestone, milestone_ptr, milestone_pack);
+
+    // The tracker may not know the latest milestone yet
+    if (iota_tangle_milestone_load_last(tangle, &milestone_pack) != RC_OK || milestone_pack.num_loaded == 0 ||
+        get_transaction_bytes(responder, tangle, milestone.hash, pack, transaction_bytes, &digest, &found) != RC_OK ||
+        !found) {
+      memset(transaction_bytes, 0, GOSSIP_TX_BYTES_LENGTH);
     }
   }
+  if ((ret = neighbor_send_bytes(responder->node, tangle, neighbor, transaction_bytes)) != RC_OK) {
+    log_warning(logger_id, "Sending transaction failed\n");
+    return ret;
+  }
 
   return RC_OK;
 }
@@ -144,11 +179,15 @@ static retcode_t respond_to_request(responder_stage_t const *const responder, ta
  * @param responder The responder stage
  */
 static void *responder_stage_routine(responder_stage_t *const responder) {
-  transaction_request_queue_entry_t *entry = NULL;
+  void *entries[RESPONDER_BATCH_SIZE];
+  transaction_request_t const *request = NULL;
+  size_t count = 0;
   DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
-  lock_handle_t lock_cond;
+  flex_trit_t transaction[FLEX_TRIT_SIZE_243];
   tangle_t tangle;
+  uint64_t start_us = 0;
   bool respond = true;
+  bool failed = false;
 
   if (responder == NULL) {
     return NULL;
@@ -163,36 +202,30 @@ static void *responder_stage_routine(responder_stage_t *const responder) {
     }
   }
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
   while (responder->running) {
-    lock_handle_lock(&responder->lock);
-    entry = transaction_request_queue_pop(&responder->queue);
-    lock_handle_unlock(&responder->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&responder->cond, &lock_cond);
+    if ((count = ring_buffer_peek(&responder->queue, entries, RESPONDER_BATCH_SIZE)) == 0) {
+      ring_buffer_wait(&responder->queue);
       continue;
     }
 
-    hash_pack_reset(&pack);
-    respond = true;
-    if (get_transaction_for_request(responder, &tangle, entry->request.neighbor, entry->request.hash, &pack,
-                                    &respond) != RC_OK) {
-      log_warning(logger_id, "Getting transaction for request failed\n");
-    }
-    if (respond) {
-      if (respond_to_request(responder, &tangle, entry->request.neighbor, entry->request.hash, &pack) != RC_OK) {
-        log_warning(logger_id, "Replying to request failed\n");
+    for (size_t i = 0; i < count; i++) {
+      request = (transaction_request_t const *)entries[i];
+      start_us = monotonic_timestamp_us();
+      respond = true;
+      failed = false;
+      if (get_transaction_for_request(responder, request->neighbor, request->hash, transaction, &respond) != RC_OK) {
+        log_warning(logger_id, "Getting transaction for request failed\n");
+      }
+      if (respond) {
+        if ((failed = respond_to_request(responder, &tangle, request->neighbor, transaction, &pack) != RC_OK)) {
+          log_warning(logger_id, "Replying to request failed\n");
+        }
       }
+      stage_metrics_record(&responder->metrics, start_us, failed);
     }
-    free(entry);
+    ring_buffer_consume(&responder->queue, count);
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
-
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
   }
@@ -205,6 +238,8 @@ static void *responder_stage_routine(responder_stage_t *const responder) {
  */
 
 retcode_t responder_stage_init(responder_stage_t *const responder, node_t *const node) {
+  retcode_t ret = RC_OK;
+
   if (responder == NULL || node == NULL) {
     return RC_NULL_PARAM;
   }
@@ -212,9 +247,12 @@ retcode_t responder_stage_init(responder_stage_t *const responder, node_t *const
   logger_id = logger_helper_enable(RESPONDER_LOGGER_ID, LOGGER_DEBUG, true);
 
   responder->running = false;
-  responder->queue = NULL;
-  lock_handle_init(&responder->lock);
-  cond_handle_init(&responder->cond);
+  stage_metrics_init(&responder->metrics);
+  if ((ret = ring_buffer_init(&responder->queue, sizeof(transaction_request_t), node->conf.stage_queue_size,
+                              RING_BUFFER_MULTI_PRODUCER)) != RC_OK) {
+    log_critical(logger_id, "Initializing responder stage queue failed\n");
+    return ret;
+  }
   responder->node = node;
 
   return RC_OK;
@@ -246,7 +284,7 @@ retcode_t responder_stage_stop(responder_stage_t *const responder) {
 
   log_info(logger_id, "Shutting down responder stage thread\n");
   responder->running = false;
-  cond_handle_signal(&responder->cond);
+  ring_buffer_wake(&responder->queue);
   if (thread_handle_join(responder->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down responder stage thread failed\n");
     ret = RC_THREAD_JOIN;
@@ -264,9 +302,7 @@ retcode_t responder_stage_destroy(responder_stage_t *const responder) {
     return RC_STILL_RUNNING;
   }
 
-  transaction_request_queue_free(&responder->queue);
-  lock_handle_destroy(&responder->lock);
-  cond_handle_destroy(&responder->cond);
+  ring_buffer_destroy(&responder->queue);
   responder->node = NULL;
 
   logger_helper_release(logger_id);
@@ -276,38 +312,29 @@ retcode_t responder_stage_destroy(responder_stage_t *const responder) {
 
 retcode_t responder_stage_add(responder_stage_t *const responder, neighbor_t *const neighbor,
                               flex_trit_t const *const hash) {
+  transaction_request_t request;
   retcode_t ret = RC_OK;
 
   if (responder == NULL || neighbor == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&responder->lock);
-  ret = transaction_request_queue_push(&responder->queue, neighbor, hash);
-  lock_handle_unlock(&responder->lock);
-
-  if (ret != RC_OK) {
+  request.neighbor = neighbor;
+  memcpy(request.hash, hash, FLEX_TRIT_SIZE_243);
+  if ((ret = ring_buffer_push(&responder->queue, &request)) != RC_OK) {
     log_warning(logger_id, "Pushing transaction_request to responder stage queue failed\n");
     return ret;
-  } else {
-    cond_handle_signal(&responder->cond);
   }
 
   return RC_OK;
 }
 
 size_t responder_stage_size(responder_stage_t *const responder) {
-  size_t size = 0;
-
   if (responder == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&responder->lock);
-  size = transaction_request_queue_count(responder->queue);
-  lock_handle_unlock(&responder->lock);
-
-  return size;
+  return ring_buffer_size(&responder->queue);
 }
 
 retcode_t responder_process_request(responder_stage_t *const responder, neighbor_t *const neighbor,
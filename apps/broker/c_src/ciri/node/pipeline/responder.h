@@ -14,8 +14,8 @@
 #include "ciri/node/protocol/transaction_request.h"
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "ciri/node/pipeline/stage_metrics.h"
+#include "utils/containers/ring_buffer.h"
 #include "utils/handles/thread.h"
 
 // Forward declarations
@@ -28,9 +28,8 @@ typedef struct node_s node_t;
 typedef struct responder_stage_s {
   thread_handle_t thread;
   bool running;
-  transaction_request_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  ring_buffer_t queue;  // Of transaction_request_t, pushed by the processor and the validator
+  stage_metrics_t metrics;
   node_t *node;
 } responder_stage_t;
 
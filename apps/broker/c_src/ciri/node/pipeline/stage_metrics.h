@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __NODE_PIPELINE_STAGE_METRICS_H__
+#define __NODE_PIPELINE_STAGE_METRICS_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils/histogram.h"
+#include "utils/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Counters and service time of a pipeline stage, written by the stage thread only and readable by any thread without
+ * locking
+ */
+typedef struct stage_metrics_s {
+  atomic_uint_fast64_t processed;  // Entries taken off the stage queue
+  atomic_uint_fast64_t failed;     // Entries whose processing failed
+  histogram_t latency;             // Processing time of an entry, in microseconds
+} stage_metrics_t;
+
+static inline void stage_metrics_init(stage_metrics_t *const metrics) {
+  atomic_init(&metrics->processed, 0);
+  atomic_init(&metrics->failed, 0);
+  histogram_reset(&metrics->latency);
+}
+
+/**
+ * Counts an entry processed since a start time
+ *
+ * @param metrics   The stage metrics
+ * @param start_us  When the processing started, from monotonic_timestamp_us
+ * @param failed    Whether the processing failed
+ */
+static inline void stage_metrics_record(stage_metrics_t *const metrics, uint64_t const start_us, bool const failed) {
+  uint64_t const end_us = monotonic_timestamp_us();
+
+  atomic_fetch_add_explicit(&metrics->processed, 1, memory_order_relaxed);
+  if (failed) {
+    atomic_fetch_add_explicit(&metrics->failed, 1, memory_order_relaxed);
+  }
+  histogram_record(&metrics->latency, end_us > start_us ? end_us - start_us : 0);
+}
+
+static inline uint64_t stage_metrics_processed(stage_metrics_t const *const metrics) {
+  return atomic_load_explicit(&metrics->processed, memory_order_relaxed);
+}
+
+static inline uint64_t stage_metrics_failed(stage_metrics_t const *const metrics) {
+  return atomic_load_explicit(&metrics->failed, memory_order_relaxed);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __NODE_PIPELINE_STAGE_METRICS_H__
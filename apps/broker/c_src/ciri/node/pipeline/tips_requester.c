@@ -23,7 +23,9 @@ static logger_id_t logger_id;
 
 static void *tips_requester_routine(tips_requester_t *const tips_requester) {
   protocol_gossip_t packet;
+  router_neighbors_t const *neighbors = NULL;
   neighbor_t *neighbor = NULL;
+  uint64_t epoch = 0;
   DECLARE_PACK_SINGLE_TX(transaction, transaction_ptr, transaction_pack);
   DECLARE_PACK_SINGLE_MILESTONE(latest_milestone, latest_milestone_ptr, milestone_pack);
   flex_trit_t transaction_flex_trits[FLEX_TRIT_SIZE_8019];
@@ -67,15 +69,16 @@ static void *tips_requester_routine(tips_requester_t *const tips_requester) {
       continue;
     }
 
-    rw_lock_handle_rdlock(&tips_requester->node->router.neighbors_lock);
-    NEIGHBORS_FOREACH(tips_requester->node->router.neighbors, neighbor) {
+    epoch = router_neighbors_enter(&tips_requester->node->router);
+    neighbors = router_neighbors(&tips_requester->node->router);
+    NEIGHBORS_FOREACH(neighbors, neighbor) {
       if (neighbor->endpoint.stream != NULL) {
         if (neighbor_send_packet(tips_requester->node, neighbor, &packet) != RC_OK) {
           log_warning(logger_id, "Sending tip request to neighbor failed\n");
         }
       }
     }
-    rw_lock_handle_unlock(&tips_requester->node->router.neighbors_lock);
+    router_neighbors_exit(&tips_requester->node->router, epoch);
   }
 
   lock_handle_unlock(&lock_cond);
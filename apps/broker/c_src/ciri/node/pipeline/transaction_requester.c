@@ -5,16 +5,165 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include "utlist.h"
+
 #include "ciri/node/pipeline/transaction_requester.h"
 #include "ciri/consensus/tangle/tangle.h"
 #include "ciri/node/node.h"
-#include "utils/handles/rand.h"
 #include "utils/logger_helper.h"
+#include "utils/time.h"
 
 #define REQUESTER_LOGGER_ID "requester"
+#define REQUESTER_QUEUE_INITIAL_CAPACITY 64
 
 static logger_id_t logger_id;
 
+/*
+ * Private functions
+ */
+
+static inline uint64_t requester_now_ms(void) { return monotonic_timestamp_us() / 1000; }
+
+// Whether a request is served before another one: lowest milestone index first, requests of no milestone last, then
+// the longest queued
+static inline bool requester_entry_before(requester_entry_t const *const lhs, requester_entry_t const *const rhs) {
+  uint64_t const lhs_index = lhs->milestone_index == REQUESTER_NO_MILESTONE ? UINT64_MAX : lhs->milestone_index;
+  uint64_t const rhs_index = rhs->milestone_index == REQUESTER_NO_MILESTONE ? UINT64_MAX : rhs->milestone_index;
+
+  return lhs_index < rhs_index || (lhs_index == rhs_index && lhs->queued_at < rhs->queued_at);
+}
+
+static inline void requester_queue_set(transaction_requester_t *const requester, size_t const index,
+                                       requester_entry_t *const entry) {
+  requester->queue[index] = entry;
+  entry->queue_index = index;
+}
+
+static void requester_queue_sift_up(transaction_requester_t *const requester, size_t index) {
+  requester_entry_t *const entry = requester->queue[index];
+  size_t parent = 0;
+
+  while (index > 0 && requester_entry_before(entry, requester->queue[parent = (index - 1) / 2])) {
+    requester_queue_set(requester, index, requester->queue[parent]);
+    index = parent;
+  }
+  requester_queue_set(requester, index, entry);
+}
+
+static void requester_queue_sift_down(transaction_requester_t *const requester, size_t index) {
+  requester_entry_t *const entry = requester->queue[index];
+  size_t child = 0;
+
+  while ((child = 2 * index + 1) < requester->queue_size) {
+    if (child + 1 < requester->queue_size &&
+        requester_entry_before(requester->queue[child + 1], requester->queue[child])) {
+      child++;
+    }
+    if (!requester_entry_before(requester->queue[child], entry)) {
+      break;
+    }
+    requester_queue_set(requester, index, requester->queue[child]);
+    index = child;
+  }
+  requester_queue_set(requester, index, entry);
+}
+
+static retcode_t requester_queue_push(transaction_requester_t *const requester, requester_entry_t *const entry) {
+  requester_entry_t **queue = NULL;
+
+  if (requester->queue_size == requester->queue_capacity) {
+    if ((queue = (requester_entry_t **)realloc(requester->queue, 2 * requester->queue_capacity *
+                                                                      sizeof(requester_entry_t *))) == NULL) {
+      return RC_OOM;
+    }
+    requester->queue = queue;
+    requester->queue_capacity *= 2;
+  }
+
+  requester_queue_set(requester, requester->queue_size++, entry);
+  requester_queue_sift_up(requester, entry->queue_index);
+
+  return RC_OK;
+}
+
+static void requester_queue_remove(transaction_requester_t *const requester, requester_entry_t *const entry) {
+  size_t const index = entry->queue_index;
+  requester_entry_t *last = requester->queue[--requester->queue_size];
+
+  entry->queue_index = REQUESTER_IN_FLIGHT;
+  if (last == entry) {
+    return;
+  }
+  requester_queue_set(requester, index, last);
+  if (index > 0 && requester_entry_before(last, requester->queue[(index - 1) / 2])) {
+    requester_queue_sift_up(requester, index);
+  } else {
+    requester_queue_sift_down(requester, index);
+  }
+}
+
+static void requester_entry_remove(transaction_requester_t *const requester, requester_entry_t *const entry) {
+  if (entry->queue_index == REQUESTER_IN_FLIGHT) {
+    DL_DELETE(requester->in_flight, entry);
+  } else {
+    requester_queue_remove(requester, entry);
+  }
+  HASH_DEL(requester->entries, entry);
+  free(entry);
+}
+
+static inline bool requester_entry_is_dead(requester_entry_t const *const entry, uint64_t const now) {
+  return entry->attempts >= REQUESTER_MAX_ATTEMPTS || now - entry->created_at >= REQUESTER_REQUEST_MAX_AGE_MS;
+}
+
+/**
+ * Queues again the requests in flight for too long, abandoning those sent too many times or for too long, requester
+ * lock held
+ */
+static void requester_expire(transaction_requester_t *const requester, uint64_t const now) {
+  requester_entry_t *entry = NULL;
+
+  // Requests are appended to the in flight list as they are sent, the oldest come first
+  while ((entry = requester->in_flight) != NULL && now - entry->sent_at >= REQUESTER_REQUEST_TIMEOUT_MS) {
+    DL_DELETE(requester->in_flight, entry);
+    requester->timed_out++;
+    if (requester_entry_is_dead(entry, now)) {
+      HASH_DEL(requester->entries, entry);
+      free(entry);
+      requester->abandoned++;
+      continue;
+    }
+    entry->queued_at = now;
+    if (requester_queue_push(requester, entry) != RC_OK) {
+      HASH_DEL(requester->entries, entry);
+      free(entry);
+      requester->dropped++;
+    }
+  }
+}
+
+/**
+ * Finds the request served last among the queued and in flight ones, requester lock held
+ */
+static requester_entry_t *requester_find_last(transaction_requester_t const *const requester) {
+  requester_entry_t *last = NULL;
+  requester_entry_t *entry = NULL;
+
+  // Among the queued requests, it is a leaf of the queue
+  for (size_t i = requester->queue_size / 2; i < requester->queue_size; i++) {
+    if (last == NULL || requester_entry_before(last, requester->queue[i])) {
+      last = requester->queue[i];
+    }
+  }
+  DL_FOREACH(requester->in_flight, entry) {
+    if (last == NULL || requester_entry_before(last, entry)) {
+      last = entry;
+    }
+  }
+
+  return last;
+}
+
 /*
  * Public functions
  */
@@ -28,25 +177,39 @@ retcode_t requester_init(transaction_requester_t *const transaction_requester, n
   memset(transaction_requester, 0, sizeof(transaction_requester_t));
   transaction_requester->node = node;
   transaction_requester->running = false;
-  transaction_requester->hashes = NULL;
-  rw_lock_handle_init(&transaction_requester->hashes_lock);
-  transaction_requester->requested_hashes = NULL;
-  rw_lock_handle_init(&transaction_requester->requested_hashes_lock);
+  transaction_requester->entries = NULL;
+  transaction_requester->in_flight = NULL;
+  if ((transaction_requester->queue = (requester_entry_t **)malloc(REQUESTER_QUEUE_INITIAL_CAPACITY *
+                                                                    sizeof(requester_entry_t *))) == NULL) {
+    return RC_OOM;
+  }
+  transaction_requester->queue_capacity = REQUESTER_QUEUE_INITIAL_CAPACITY;
+  histogram_reset(&transaction_requester->latency);
+  lock_handle_init(&transaction_requester->lock);
 
   return RC_OK;
 }
 
 retcode_t requester_destroy(transaction_requester_t *const transaction_requester) {
+  requester_entry_t *entry = NULL;
+  requester_entry_t *tmp = NULL;
+
   if (transaction_requester == NULL) {
     return RC_NULL_PARAM;
   } else if (transaction_requester->running) {
     return RC_STILL_RUNNING;
   }
 
-  hash243_set_free(&transaction_requester->hashes);
+  HASH_ITER(hh, transaction_requester->entries, entry, tmp) {
+    HASH_DEL(transaction_requester->entries, entry);
+    free(entry);
+  }
+  transaction_requester->in_flight = NULL;
+  free(transaction_requester->queue);
+  transaction_requester->queue = NULL;
+  transaction_requester->queue_size = 0;
   transaction_requester->node = NULL;
-  rw_lock_handle_destroy(&transaction_requester->hashes_lock);
-  rw_lock_handle_destroy(&transaction_requester->requested_hashes_lock);
+  lock_handle_destroy(&transaction_requester->lock);
   logger_helper_release(logger_id);
 
   return RC_OK;
@@ -55,30 +218,20 @@ retcode_t requester_destroy(transaction_requester_t *const transaction_requester
 retcode_t requester_get_requested_transactions(transaction_requester_t *const transaction_requester,
                                                hash243_stack_t *const hashes) {
   retcode_t ret = RC_OK;
-  hash243_set_entry_t *iter = NULL;
-  hash243_set_entry_t *tmp = NULL;
+  requester_entry_t *entry = NULL;
+  requester_entry_t *tmp = NULL;
 
   if (transaction_requester == NULL || hashes == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->hashes_lock);
-  HASH_SET_ITER(transaction_requester->hashes, iter, tmp) {
-    if ((ret = hash243_stack_push(hashes, iter->hash)) != RC_OK) {
+  lock_handle_lock(&transaction_requester->lock);
+  HASH_ITER(hh, transaction_requester->entries, entry, tmp) {
+    if ((ret = hash243_stack_push(hashes, entry->hash)) != RC_OK) {
       break;
     }
   }
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  if (ret != RC_OK) {
-    rw_lock_handle_rdlock(&transaction_requester->requested_hashes_lock);
-    HASH_SET_ITER(transaction_requester->requested_hashes, iter, tmp) {
-      if ((ret = hash243_stack_push(hashes, iter->hash)) != RC_OK) {
-        break;
-      }
-    }
-    rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
-  }
+  lock_handle_unlock(&transaction_requester->lock);
 
   return ret;
 }
@@ -87,66 +240,64 @@ size_t requester_size(transaction_requester_t *const transaction_requester) {
   size_t size = 0;
 
   if (transaction_requester == NULL) {
-    return RC_NULL_PARAM;
+    return 0;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->hashes_lock);
-  size = hash243_set_size(transaction_requester->hashes);
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  rw_lock_handle_rdlock(&transaction_requester->requested_hashes_lock);
-  size += hash243_set_size(transaction_requester->requested_hashes);
-  rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+  size = HASH_COUNT(transaction_requester->entries);
+  lock_handle_unlock(&transaction_requester->lock);
 
   return size;
 }
 
 bool requester_is_full(transaction_requester_t *const transaction_requester) {
-  size_t size = 0;
-
   if (transaction_requester == NULL) {
-    return RC_NULL_PARAM;
+    return false;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->hashes_lock);
-  size = hash243_set_size(transaction_requester->hashes);
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  return size >= transaction_requester->node->conf.requester_queue_size;
+  return requester_size(transaction_requester) >= transaction_requester->node->conf.requester_queue_size;
 }
 
 retcode_t requester_clear_request(transaction_requester_t *const transaction_requester, flex_trit_t const *const hash) {
+  requester_entry_t *entry = NULL;
+
   if (transaction_requester == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&transaction_requester->hashes_lock);
-  hash243_set_remove(&transaction_requester->hashes, hash);
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
-
-  rw_lock_handle_wrlock(&transaction_requester->requested_hashes_lock);
-  hash243_set_remove(&transaction_requester->requested_hashes, hash);
-  rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    transaction_requester->fulfilled++;
+    histogram_record(&transaction_requester->latency, requester_now_ms() - entry->created_at);
+    requester_entry_remove(transaction_requester, entry);
+  }
+  lock_handle_unlock(&transaction_requester->lock);
 
   return RC_OK;
 }
 
 retcode_t requester_was_requested(transaction_requester_t *const transaction_requester, flex_trit_t const *const hash,
                                   bool *const was_requested) {
+  requester_entry_t *entry = NULL;
+
   if (transaction_requester == NULL || hash == NULL || was_requested == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_rdlock(&transaction_requester->requested_hashes_lock);
-  *was_requested = hash243_set_contains(transaction_requester->requested_hashes, hash);
-  rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  *was_requested = entry != NULL && entry->attempts > 0;
+  lock_handle_unlock(&transaction_requester->lock);
 
   return RC_OK;
 }
 
 retcode_t request_transaction(transaction_requester_t *const transaction_requester, tangle_t *const tangle,
-                              flex_trit_t const *const hash) {
+                              flex_trit_t const *const hash, uint64_t const milestone_index) {
   retcode_t ret = RC_OK;
+  requester_entry_t *entry = NULL;
+  requester_entry_t *evicted = NULL;
   bool exists = false;
 
   if (transaction_requester == NULL || hash == NULL) {
@@ -164,42 +315,140 @@ retcode_t request_transaction(transaction_requester_t *const transaction_request
     return RC_OK;
   }
 
-  rw_lock_handle_wrlock(&transaction_requester->hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
 
-  if (hash243_set_size(transaction_requester->hashes) >= transaction_requester->node->conf.requester_queue_size) {
-    if ((ret = hash243_set_remove_entry(&transaction_requester->hashes, transaction_requester->hashes)) != RC_OK) {
+  HASH_FIND(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  if (entry != NULL) {
+    // Already requested, only moves closer to the head of the queue for an older milestone
+    if (milestone_index != REQUESTER_NO_MILESTONE &&
+        (entry->milestone_index == REQUESTER_NO_MILESTONE || milestone_index < entry->milestone_index)) {
+      entry->milestone_index = milestone_index;
+      if (entry->queue_index != REQUESTER_IN_FLIGHT) {
+        requester_queue_sift_up(transaction_requester, entry->queue_index);
+      }
+    }
+    goto done;
+  }
+
+  if ((entry = (requester_entry_t *)calloc(1, sizeof(requester_entry_t))) == NULL) {
+    ret = RC_OOM;
+    goto done;
+  }
+  memcpy(entry->hash, hash, FLEX_TRIT_SIZE_243);
+  entry->milestone_index = milestone_index;
+  entry->created_at = entry->queued_at = requester_now_ms();
+
+  if (HASH_COUNT(transaction_requester->entries) >= transaction_requester->node->conf.requester_queue_size) {
+    requester_expire(transaction_requester, entry->created_at);
+  }
+  if (HASH_COUNT(transaction_requester->entries) >= transaction_requester->node->conf.requester_queue_size) {
+    // A newer request of no milestone is served after all the others, otherwise it makes room by evicting the request
+    // served last, queued or in flight
+    if (milestone_index != REQUESTER_NO_MILESTONE) {
+      evicted = requester_find_last(transaction_requester);
+    }
+    transaction_requester->dropped++;
+    if (evicted == NULL || !requester_entry_before(entry, evicted)) {
+      free(entry);
       goto done;
     }
+    requester_entry_remove(transaction_requester, evicted);
   }
-  if ((ret = hash243_set_add(&transaction_requester->hashes, hash)) != RC_OK) {
+
+  if ((ret = requester_queue_push(transaction_requester, entry)) != RC_OK) {
+    free(entry);
     goto done;
   }
+  HASH_ADD(hh, transaction_requester->entries, hash, FLEX_TRIT_SIZE_243, entry);
+  transaction_requester->requested++;
 
 done:
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
+  lock_handle_unlock(&transaction_requester->lock);
 
   return ret;
 }
 
-retcode_t get_transaction_to_request(transaction_requester_t *const transaction_requester, tangle_t const *const tangle,
-                                     flex_trit_t *const hash) {
-  if (transaction_requester == NULL || tangle == NULL || hash == NULL) {
+retcode_t get_transaction_to_request(transaction_requester_t *const transaction_requester,
+                                     neighbor_t const *const neighbor, flex_trit_t *const hash) {
+  requester_entry_t *skipped[REQUESTER_NEIGHBOR_SKIP_MAX];
+  requester_entry_t *entry = NULL;
+  size_t skipped_num = 0;
+  uint64_t const now = requester_now_ms();
+
+  if (transaction_requester == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  rw_lock_handle_wrlock(&transaction_requester->hashes_lock);
+  lock_handle_lock(&transaction_requester->lock);
+
+  requester_expire(transaction_requester, now);
+
+  // A request timed out on a neighbor is sent to another one, unless only that one is left to ask
+  while (transaction_requester->queue_size > 0) {
+    entry = transaction_requester->queue[0];
+    requester_queue_remove(transaction_requester, entry);
+    if (now - entry->created_at >= REQUESTER_REQUEST_MAX_AGE_MS) {
+      HASH_DEL(transaction_requester->entries, entry);
+      free(entry);
+      transaction_requester->abandoned++;
+      entry = NULL;
+      continue;
+    } else if (entry->neighbor == NULL || entry->neighbor != neighbor || skipped_num == REQUESTER_NEIGHBOR_SKIP_MAX) {
+      break;
+    }
+    skipped[skipped_num++] = entry;
+    entry = NULL;
+  }
+  // Queue pushes can't fail here since the entries were just removed
+  for (size_t i = entry == NULL && skipped_num > 0 ? 1 : 0; i < skipped_num; i++) {
+    requester_queue_push(transaction_requester, skipped[i]);
+  }
+  if (entry == NULL && skipped_num > 0) {
+    entry = skipped[0];
+  }
 
-  if (transaction_requester->hashes != NULL) {
-    memcpy(hash, transaction_requester->hashes->hash, FLEX_TRIT_SIZE_243);
-    hash243_set_remove_entry(&transaction_requester->hashes, transaction_requester->hashes);
-    rw_lock_handle_wrlock(&transaction_requester->requested_hashes_lock);
-    hash243_set_add(&transaction_requester->requested_hashes, hash);
-    rw_lock_handle_unlock(&transaction_requester->requested_hashes_lock);
+  if (entry != NULL) {
+    memcpy(hash, entry->hash, FLEX_TRIT_SIZE_243);
+    entry->neighbor = neighbor;
+    entry->sent_at = now;
+    entry->attempts++;
+    DL_APPEND(transaction_requester->in_flight, entry);
+    transaction_requester->sent++;
   } else {
     memset(hash, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_243);
   }
 
-  rw_lock_handle_unlock(&transaction_requester->hashes_lock);
+  lock_handle_unlock(&transaction_requester->lock);
+
+  return RC_OK;
+}
+
+retcode_t requester_metrics(transaction_requester_t *const transaction_requester, requester_metrics_t *const metrics) {
+  if (transaction_requester == NULL || metrics == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(metrics, 0, sizeof(requester_metrics_t));
+
+  lock_handle_lock(&transaction_requester->lock);
+  metrics->queued = transaction_requester->queue_size;
+  metrics->in_flight = HASH_COUNT(transaction_requester->entries) - transaction_requester->queue_size;
+  metrics->requested = transaction_requester->requested;
+  metrics->sent = transaction_requester->sent;
+  metrics->timed_out = transaction_requester->timed_out;
+  metrics->fulfilled = transaction_requester->fulfilled;
+  metrics->dropped = transaction_requester->dropped;
+  metrics->abandoned = transaction_requester->abandoned;
+  lock_handle_unlock(&transaction_requester->lock);
+
+  if (metrics->requested > 0) {
+    metrics->fulfilment_rate = (double)metrics->fulfilled / metrics->requested;
+  }
+  metrics->latency_mean_ms = histogram_mean(&transaction_requester->latency);
+  metrics->latency_p50_ms = histogram_percentile(&transaction_requester->latency, 50);
+  metrics->latency_p90_ms = histogram_percentile(&transaction_requester->latency, 90);
+  metrics->latency_p99_ms = histogram_percentile(&transaction_requester->latency, 99);
+  metrics->latency_max_ms = histogram_max(&transaction_requester->latency);
 
   return RC_OK;
 }
@@ -9,27 +9,103 @@
 #define __NODE_PIPELINE_TRANSACTION_REQUESTER_H__
 
 #include <stdbool.h>
+#include <stdint.h>
+
+#include "uthash.h"
 
 #include "common/errors.h"
 #include "utils/containers/hash/hash243_set.h"
 #include "utils/containers/hash/hash243_stack.h"
-#include "utils/handles/rw_lock.h"
+#include "utils/handles/lock.h"
 #include "utils/handles/thread.h"
+#include "utils/histogram.h"
+
+// Time after which a request that wasn't answered is sent again, to another neighbor if possible
+#define REQUESTER_REQUEST_TIMEOUT_MS 2000
+// Number of times a request is sent before being abandoned, the solidifier requesting it again while still missing
+#define REQUESTER_MAX_ATTEMPTS 10
+// Time after which a request that wasn't fulfilled is abandoned
+#define REQUESTER_REQUEST_MAX_AGE_MS 120000
+// Number of queued requests looked at for one that wasn't last sent to the neighbor being served
+#define REQUESTER_NEIGHBOR_SKIP_MAX 4
+// Milestone index of the requests that no milestone solidification waits for
+#define REQUESTER_NO_MILESTONE 0
+// Queue index of the requests in flight
+#define REQUESTER_IN_FLIGHT SIZE_MAX
 
 // Forward declarations
 typedef struct tangle_s tangle_t;
 typedef struct node_s node_t;
+typedef struct neighbor_s neighbor_t;
+
+typedef struct requester_entry_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  // Lowest index of the milestones whose solidification waits for the transaction, REQUESTER_NO_MILESTONE if none
+  uint64_t milestone_index;
+  // When the request was made, in milliseconds
+  uint64_t created_at;
+  // When the request entered the queue, in milliseconds, ordering requests of the same milestone
+  uint64_t queued_at;
+  // When the request was last sent, in milliseconds
+  uint64_t sent_at;
+  // Neighbor the request was last sent to, only compared
+  neighbor_t const *neighbor;
+  uint32_t attempts;
+  // Position in the queue, or REQUESTER_IN_FLIGHT once sent
+  size_t queue_index;
+  // In flight requests, oldest first
+  struct requester_entry_s *prev;
+  struct requester_entry_s *next;
+  UT_hash_handle hh;
+} requester_entry_t;
 
+/**
+ * Requests missing transactions by piggybacking their hashes on the packets sent to neighbors.
+ *
+ * Queued requests are served by milestone proximity, the lowest milestone index first, then by age. A request sent to
+ * a neighbor stays in flight until the transaction arrives or it times out, after which it is queued again and
+ * preferably sent to another neighbor. Requests are abandoned after REQUESTER_MAX_ATTEMPTS sends or
+ * REQUESTER_REQUEST_MAX_AGE_MS, and the request served last, queued or in flight, makes room for a more urgent one
+ * when the requester is full.
+ */
 typedef struct transaction_requester_s {
   thread_handle_t thread;
   bool running;
-  hash243_set_t hashes;
-  rw_lock_handle_t hashes_lock;
-  hash243_set_t requested_hashes;
-  rw_lock_handle_t requested_hashes_lock;
+  lock_handle_t lock;
+  // Queued and in flight requests by hash
+  requester_entry_t *entries;
+  // Binary heap of the queued requests
+  requester_entry_t **queue;
+  size_t queue_size;
+  size_t queue_capacity;
+  requester_entry_t *in_flight;
+  uint64_t requested;
+  uint64_t sent;
+  uint64_t timed_out;
+  uint64_t fulfilled;
+  uint64_t dropped;
+  uint64_t abandoned;
+  histogram_t latency;  // Time from request to arrival of fulfilled requests, in milliseconds
   node_t *node;
 } transaction_requester_t;
 
+typedef struct requester_metrics_s {
+  size_t queued;
+  size_t in_flight;
+  uint64_t requested;
+  uint64_t sent;
+  uint64_t timed_out;
+  uint64_t fulfilled;
+  uint64_t dropped;
+  uint64_t abandoned;
+  double fulfilment_rate;  // Share of the requests fulfilled, in [0, 1]
+  double latency_mean_ms;
+  uint64_t latency_p50_ms;
+  uint64_t latency_p90_ms;
+  uint64_t latency_p99_ms;
+  uint64_t latency_max_ms;
+} requester_metrics_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -105,28 +181,40 @@ retcode_t requester_was_requested(transaction_requester_t *const transaction_req
                                   bool *const was_requested);
 
 /**
- * Adds a transaction to be requested by a transaction requester
+ * Adds a transaction to be requested by a transaction requester, or raises the priority of its request
  *
  * @param[out]  transaction_requester The transaction requester
  * @param[in]   tangle                A tangle
- * @param[int]  hash                  The transaction to request
+ * @param[in]   hash                  The transaction to request
+ * @param[in]   milestone_index       The index of the milestone whose solidification waits for the transaction, or
+ *                                    REQUESTER_NO_MILESTONE
  *
  * @return a status code
  */
 retcode_t request_transaction(transaction_requester_t *const transaction_requester, tangle_t *const tangle,
-                              flex_trit_t const *const hash);
+                              flex_trit_t const *const hash, uint64_t const milestone_index);
 
 /**
- * Gets a transaction to request from a transaction requester
+ * Gets a transaction to request from a neighbor, the request staying in flight until fulfilled or timed out
  *
  * @param[in, out]  transaction_requester The transaction requester
- * @param[in]       tangle                A tangle
- * @param[out]      hash                  The transaction to be requested
+ * @param[in]       neighbor              The neighbor the request is sent to
+ * @param[out]      hash                  The transaction to be requested, null if none
+ *
+ * @return a status code
+ */
+retcode_t get_transaction_to_request(transaction_requester_t *const transaction_requester,
+                                     neighbor_t const *const neighbor, flex_trit_t *const hash);
+
+/**
+ * Gets the request counters and latency of a transaction requester since it was initialized
+ *
+ * @param[in]   transaction_requester The transaction requester
+ * @param[out]  metrics               The metrics
  *
  * @return a status code
  */
-retcode_t get_transaction_to_request(transaction_requester_t *const transaction_requester, tangle_t const *const tangle,
-                                     flex_trit_t *const hash);
+retcode_t requester_metrics(transaction_requester_t *const transaction_requester, requester_metrics_t *const metrics);
 
 #ifdef __cplusplus
 }
@@ -14,6 +14,8 @@
 #include "utils/logger_helper.h"
 
 #define VALIDATOR_LOGGER_ID "validator"
+// Maximum number of payloads taken from the queue at once
+#define VALIDATOR_BATCH_SIZE 16
 
 static logger_id_t logger_id;
 
@@ -31,12 +33,13 @@ static logger_id_t logger_id;
  * @param neighbor The neighbor that sent the packet
  * @param packet The packet from which to process transaction bytes
  * @param hash The transaction hash
+ * @param digest The digest of the transaction bytes
  *
  * @return a status code
  */
-static retcode_t validate_transaction_bytes(validator_stage_t const *const validator, tangle_t *const tangle,
+static retcode_t validate_transaction_bytes(validator_stage_t *const validator, tangle_t *const tangle,
                                             neighbor_t *const neighbor, protocol_gossip_t const *const gossip,
-                                            flex_trit_t const *const hash) {
+                                            flex_trit_t const *const hash, uint64_t const digest) {
   retcode_t ret = RC_OK;
   bool exists = false;
   iota_transaction_t transaction;
@@ -85,6 +88,10 @@ static retcode_t validate_transaction_bytes(validator_stage_t const *const valid
       goto failure;
     }
 
+    // New transactions are the most requested ones, their bytes are kept to answer requests as is
+    transaction_bytes_cache_put(&validator->node->transaction_bytes, hash, gossip->content, digest);
+    atomic_fetch_add_explicit(&validator->stored, 1, memory_order_relaxed);
+
     // Updates transaction status
     if ((ret = iota_consensus_transaction_solidifier_update_status(validator->transaction_solidifier, tangle,
                                                                    &transaction)) != RC_OK) {
@@ -94,8 +101,11 @@ static retcode_t validate_transaction_bytes(validator_stage_t const *const valid
 
     // TODO Store transaction metadata
 
-    // Broadcast the new transaction
-    if ((ret = broadcaster_stage_add(&validator->node->broadcaster, gossip)) != RC_OK) {
+    // Broadcast the new transaction, dropped if the broadcaster is behind
+    if ((ret = broadcaster_stage_add(&validator->node->broadcaster, gossip)) == RC_UTILS_RING_BUFFER_FULL) {
+      log_debug(logger_id, "Broadcaster stage queue full, not propagating packet\n");
+      ret = RC_OK;
+    } else if (ret != RC_OK) {
       log_warning(logger_id, "Propagating packet to broadcaster failed\n");
       goto failure;
     }
@@ -103,6 +113,14 @@ static retcode_t validate_transaction_bytes(validator_stage_t const *const valid
     if (transaction_current_index(&transaction) == 0 &&
         memcmp(transaction_address(&transaction), validator->milestone_tracker->conf->coordinator_address,
                FLEX_TRIT_SIZE_243) == 0) {
+      // The milestone tracker loads the candidate and the solid states of its past cone from its own connection
+      if (iota_consensus_transaction_solidifier_flush_pending(validator->transaction_solidifier, tangle) != RC_OK) {
+        log_warning(logger_id, "Persisting solid states failed\n");
+      }
+      if ((ret = iota_tangle_flush(tangle)) != RC_OK) {
+        log_warning(logger_id, "Committing milestone candidate failed\n");
+        goto failure;
+      }
       ret = iota_milestone_tracker_add_candidate(validator->milestone_tracker, transaction_hash(&transaction));
     }
 
@@ -122,8 +140,11 @@ failure:
 }
 
 static void *validator_stage_routine(validator_stage_t *const validator) {
-  validator_payload_queue_entry_t *entry = NULL;
-  lock_handle_t lock_cond;
+  void *entries[VALIDATOR_BATCH_SIZE];
+  validator_payload_t const *payload = NULL;
+  size_t count = 0;
+  uint64_t start_us = 0;
+  bool failed = false;
   tangle_t tangle;
 
   if (validator == NULL) {
@@ -131,7 +152,11 @@ static void *validator_stage_routine(validator_stage_t *const validator) {
   }
 
   {
-    connection_config_t db_conf = {.db_path = validator->node->conf.tangle_db_path};
+    // The validator stores every new transaction, they are group-committed
+    connection_config_t db_conf = {.db_path = validator->node->conf.tangle_db_path,
+                                   .durability = validator->node->conf.tangle_db_durability,
+                                   .write_batch_size = validator->node->conf.tangle_db_write_batch_size,
+                                   .write_batch_timeout_ms = validator->node->conf.tangle_db_write_batch_timeout};
 
     if (iota_tangle_init(&tangle, &db_conf) != RC_OK) {
       log_critical(logger_id, "Initializing tangle connection failed\n");
@@ -139,36 +164,40 @@ static void *validator_stage_routine(validator_stage_t *const validator) {
     }
   }
 
-  lock_handle_init(&lock_cond);
-  lock_handle_lock(&lock_cond);
-
   while (validator->running) {
-    lock_handle_lock(&validator->lock);
-    entry = validator_payload_queue_pop(&validator->queue);
-    lock_handle_unlock(&validator->lock);
-
-    if (entry == NULL) {
-      cond_handle_wait(&validator->cond, &lock_cond);
+    if ((count = ring_buffer_peek(&validator->queue, entries, VALIDATOR_BATCH_SIZE)) == 0) {
+      // Nothing else to store for now, the pending transactions are made visible to the other stages
+      if (iota_tangle_flush(&tangle) != RC_OK) {
+        log_warning(logger_id, "Committing stored transactions failed\n");
+      }
+      ring_buffer_wait(&validator->queue);
       continue;
     }
 
-    if (validate_transaction_bytes(validator, &tangle, entry->payload.neighbor, &entry->payload.gossip->packet,
-                                   entry->payload.hash) != RC_OK) {
-      log_warning(logger_id, "Processing packet failed\n");
+    for (size_t i = 0; i < count; i++) {
+      payload = (validator_payload_t const *)entries[i];
+      start_us = monotonic_timestamp_us();
+      if ((failed = validate_transaction_bytes(validator, &tangle, payload->neighbor, &payload->gossip, payload->hash,
+                                               payload->digest) != RC_OK)) {
+        log_warning(logger_id, "Processing packet failed\n");
+      }
+      recent_seen_bytes_cache_put(&validator->node->recent_seen_bytes, payload->digest, payload->hash);
+      if (responder_process_request(&validator->node->responder, payload->neighbor, &payload->gossip,
+                                    payload->hash) != RC_OK) {
+        log_warning(logger_id, "Processing request bytes failed\n");
+      }
+      stage_metrics_record(&validator->metrics, start_us, failed);
     }
-    recent_seen_bytes_cache_put(&validator->node->recent_seen_bytes, entry->payload.digest, entry->payload.hash);
-    if (responder_process_request(&validator->node->responder, entry->payload.neighbor, &entry->payload.gossip->packet,
-                                  entry->payload.hash) != RC_OK) {
-      log_warning(logger_id, "Processing request bytes failed\n");
+    ring_buffer_consume(&validator->queue, count);
+    // Solid states of the transactions stored so far join their group commit
+    if (iota_consensus_transaction_solidifier_flush_pending(validator->transaction_solidifier, &tangle) != RC_OK) {
+      log_warning(logger_id, "Persisting solid states failed\n");
     }
-
-    free(entry->payload.gossip);
-    free(entry);
   }
 
-  lock_handle_unlock(&lock_cond);
-  lock_handle_destroy(&lock_cond);
-
+  if (iota_consensus_transaction_solidifier_flush_pending(validator->transaction_solidifier, &tangle) != RC_OK) {
+    log_warning(logger_id, "Persisting solid states failed\n");
+  }
   if (iota_tangle_destroy(&tangle) != RC_OK) {
     log_critical(logger_id, "Destroying tangle connection failed\n");
   }
@@ -184,6 +213,8 @@ retcode_t validator_stage_init(validator_stage_t *const validator, node_t *const
                                transaction_validator_t *const transaction_validator,
                                transaction_solidifier_t *const transaction_solidifier,
                                milestone_tracker_t *const milestone_tracker) {
+  retcode_t ret = RC_OK;
+
   if (validator == NULL || node == NULL || transaction_validator == NULL || transaction_solidifier == NULL ||
       milestone_tracker == NULL) {
     return RC_NULL_PARAM;
@@ -192,9 +223,14 @@ retcode_t validator_stage_init(validator_stage_t *const validator, node_t *const
   logger_id = logger_helper_enable(VALIDATOR_LOGGER_ID, LOGGER_DEBUG, true);
 
   validator->running = false;
-  validator->queue = NULL;
-  lock_handle_init(&validator->lock);
-  cond_handle_init(&validator->cond);
+  stage_metrics_init(&validator->metrics);
+  atomic_init(&validator->stored, 0);
+  // Pushed by every hasher worker
+  if ((ret = ring_buffer_init(&validator->queue, sizeof(validator_payload_t), node->conf.stage_queue_size,
+                              RING_BUFFER_MULTI_PRODUCER)) != RC_OK) {
+    log_critical(logger_id, "Initializing validator stage queue failed\n");
+    return ret;
+  }
   validator->node = node;
   validator->transaction_validator = transaction_validator;
   validator->transaction_solidifier = transaction_solidifier;
@@ -227,7 +263,7 @@ retcode_t validator_stage_stop(validator_stage_t *const validator) {
 
   log_info(logger_id, "Shutting down validator stage thread\n");
   validator->running = false;
-  cond_handle_signal(&validator->cond);
+  ring_buffer_wake(&validator->queue);
   if (thread_handle_join(validator->thread, NULL) != 0) {
     log_error(logger_id, "Shutting down validator stage thread failed\n");
     return RC_THREAD_JOIN;
@@ -243,9 +279,7 @@ retcode_t validator_stage_destroy(validator_stage_t *const validator) {
     return RC_STILL_RUNNING;
   }
 
-  validator_payload_queue_free(&validator->queue);
-  lock_handle_destroy(&validator->lock);
-  cond_handle_destroy(&validator->cond);
+  ring_buffer_destroy(&validator->queue);
   validator->node = NULL;
 
   logger_helper_release(logger_id);
@@ -253,99 +287,30 @@ retcode_t validator_stage_destroy(validator_stage_t *const validator) {
   return RC_OK;
 }
 
-retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_queue_entry_t *const gossip,
+retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_t const *const gossip,
                               uint64_t const digest, neighbor_t *const neighbor, flex_trit_t const *const hash) {
+  validator_payload_t payload;
   retcode_t ret = RC_OK;
 
-  if (validator == NULL) {
+  if (validator == NULL || gossip == NULL || hash == NULL) {
     return RC_NULL_PARAM;
   }
 
-  lock_handle_lock(&validator->lock);
-  ret = validator_payload_queue_push(&validator->queue, gossip, digest, neighbor, hash);
-  lock_handle_unlock(&validator->lock);
-
-  if (ret != RC_OK) {
+  memcpy(&payload.gossip, gossip, sizeof(protocol_gossip_t));
+  payload.digest = digest;
+  payload.neighbor = neighbor;
+  memcpy(payload.hash, hash, FLEX_TRIT_SIZE_243);
+  if ((ret = ring_buffer_push(&validator->queue, &payload)) != RC_OK && ret != RC_UTILS_RING_BUFFER_FULL) {
     log_warning(logger_id, "Pushing packet to validator stage queue failed\n");
-    return ret;
-  } else {
-    cond_handle_signal(&validator->cond);
   }
 
-  return RC_OK;
+  return ret;
 }
 
 size_t validator_stage_size(validator_stage_t *const validator) {
-  size_t size = 0;
-
   if (validator == NULL) {
     return 0;
   }
 
-  lock_handle_lock(&validator->lock);
-  size = validator_payload_queue_count(validator->queue);
-  lock_handle_unlock(&validator->lock);
-
-  return size;
-}
-
-size_t validator_payload_queue_count(validator_payload_queue_t const queue) {
-  validator_payload_queue_entry_t *iter = NULL;
-  size_t count = 0;
-
-  CDL_COUNT(queue, iter, count);
-
-  return count;
-}
-
-retcode_t validator_payload_queue_push(validator_payload_queue_t *const queue,
-                                       protocol_gossip_queue_entry_t *const gossip, uint64_t const digest,
-                                       neighbor_t *const neighbor, flex_trit_t const *const hash) {
-  validator_payload_queue_entry_t *entry = NULL;
-
-  if (queue == NULL || gossip == NULL) {
-    return RC_NULL_PARAM;
-  }
-
-  if ((entry = (validator_payload_queue_entry_t *)malloc(sizeof(validator_payload_queue_entry_t))) == NULL) {
-    return RC_OOM;
-  }
-
-  entry->payload.gossip = gossip;
-  entry->payload.digest = digest;
-  entry->payload.neighbor = neighbor;
-  memcpy(entry->payload.hash, hash, FLEX_TRIT_SIZE_243);
-  CDL_APPEND(*queue, entry);
-
-  return RC_OK;
-}
-
-validator_payload_queue_entry_t *validator_payload_queue_pop(validator_payload_queue_t *const queue) {
-  validator_payload_queue_entry_t *front = NULL;
-
-  if (queue == NULL) {
-    return NULL;
-  }
-
-  front = *queue;
-  if (front != NULL) {
-    CDL_DELETE(*queue, front);
-  }
-
-  return front;
-}
-
-void validator_payload_queue_free(validator_payload_queue_t *const queue) {
-  validator_payload_queue_entry_t *iter = NULL, *tmp1 = NULL, *tmp2 = NULL;
-
-  if (queue == NULL) {
-    return;
-  }
-
-  CDL_FOREACH_SAFE(*queue, iter, tmp1, tmp2) {
-    CDL_DELETE(*queue, iter);
-    free(iter->payload.gossip);
-    free(iter);
-  }
-  *queue = NULL;
+  return ring_buffer_size(&validator->queue);
 }
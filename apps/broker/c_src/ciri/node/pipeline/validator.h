@@ -13,8 +13,8 @@
 #include "ciri/node/network/neighbor.h"
 #include "ciri/node/protocol/gossip.h"
 #include "common/errors.h"
-#include "utils/handles/cond.h"
-#include "utils/handles/lock.h"
+#include "ciri/node/pipeline/stage_metrics.h"
+#include "utils/containers/ring_buffer.h"
 #include "utils/handles/thread.h"
 
 #ifdef __cplusplus
@@ -28,26 +28,18 @@ typedef struct transaction_solidifier_s transaction_solidifier_t;
 typedef struct milestone_tracker_s milestone_tracker_t;
 
 typedef struct validator_payload_s {
-  protocol_gossip_queue_entry_t *gossip;
+  protocol_gossip_t gossip;
   uint64_t digest;
   neighbor_t *neighbor;
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
 } validator_payload_t;
 
-typedef struct validator_payload_queue_entry_s {
-  validator_payload_t payload;
-  struct validator_payload_queue_entry_s *next;
-  struct validator_payload_queue_entry_s *prev;
-} validator_payload_queue_entry_t;
-
-typedef validator_payload_queue_entry_t *validator_payload_queue_t;
-
 typedef struct validator_stage_s {
   thread_handle_t thread;
   bool running;
-  validator_payload_queue_t queue;
-  lock_handle_t lock;
-  cond_handle_t cond;
+  ring_buffer_t queue;  // Of validator_payload_t, pushed by the hasher workers
+  stage_metrics_t metrics;
+  atomic_uint_fast64_t stored;  // New transactions stored
   node_t *node;
   transaction_validator_t *transaction_validator;
   transaction_solidifier_t *transaction_solidifier;
@@ -101,13 +93,14 @@ retcode_t validator_stage_destroy(validator_stage_t *const validator);
  * Adds a packet to a validator stage queue
  *
  * @param validator The validator stage
- * @param[in]       gossip    A gossip packet
+ * @param[in]       gossip    A gossip packet, copied in the queue
  * @param[in]       digest    The digest of the gossip transaction
  * @param[in]       neighbor  The neighbor that sent the packet
+ * @param[in]       hash      The transaction hash
  *
- * @return a status code
+ * @return a status code, RC_UTILS_RING_BUFFER_FULL if the queue is full
  */
-retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_queue_entry_t *const gossip,
+retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossip_t const *const gossip,
                               uint64_t const digest, neighbor_t *const neighbor, flex_trit_t const *const hash);
 
 /**
@@ -119,47 +112,6 @@ retcode_t validator_stage_add(validator_stage_t *const validator, protocol_gossi
  */
 size_t validator_stage_size(validator_stage_t *const validator);
 
-/**
- * Gets the size of a validator payload queue
- *
- * @param[in] queue The validator payload queue
- *
- * @return the size of the packet queue
- */
-size_t validator_payload_queue_count(validator_payload_queue_t const queue);
-
-/**
- * Pushes a packet to a validator payload queue
- *
- * @param[out]  queue     The validator payload queue
- * @param[in]   gossip    A gossip packet
- * @param[in]   digest    The digest of the gossip transaction
- * @param[in]   neighbor  The neighbor that sent the packet
- *
- * @return a status code
- */
-retcode_t validator_payload_queue_push(validator_payload_queue_t *const queue,
-                                       protocol_gossip_queue_entry_t *const gossip, uint64_t const digest,
-                                       neighbor_t *const neighbor, flex_trit_t const *const hash);
-
-/**
- * Pops a packet from a validator payload queue
- *
- * @param[out]  queue The validator payload queue
- *
- * @return the validator payload
- */
-validator_payload_queue_entry_t *validator_payload_queue_pop(validator_payload_queue_t *const queue);
-
-/**
- * Frees a validator payload queue
- *
- * @param[out]  queue The validator payload queue
- *
- * @return a status code
- */
-void validator_payload_queue_free(validator_payload_queue_t *const queue);
-
 #ifdef __cplusplus
 }
 #endif
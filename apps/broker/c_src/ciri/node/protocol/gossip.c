@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "ciri/node/protocol/gossip.h"
 #include "common/model/transaction.h"
@@ -51,6 +52,26 @@ retcode_t protocol_gossip_set_endpoint(protocol_gossip_t *const packet, char con
   return RC_OK;
 }
 
+retcode_t protocol_gossip_set_payload(protocol_gossip_t *const packet, byte_t const *const payload,
+                                      uint16_t const length) {
+  size_t sig_size = 0;
+
+  if (packet == NULL || payload == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (length < GOSSIP_MIN_BYTES_LENGTH || length > GOSSIP_MAX_BYTES_LENGTH) {
+    return RC_INVALID_PACKET;
+  }
+
+  sig_size = length - GOSSIP_NON_SIG_BYTES_LENGTH - GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH;
+  memcpy(packet->content, payload, sig_size);
+  memset(packet->content + sig_size, 0, GOSSIP_SIG_MAX_BYTES_LENGTH - sig_size);
+  memcpy(packet->content + GOSSIP_SIG_MAX_BYTES_LENGTH, payload + sig_size,
+         GOSSIP_NON_SIG_BYTES_LENGTH + GOSSIP_REQUESTED_TX_HASH_BYTES_LENGTH);
+
+  return RC_OK;
+}
+
 bool protocol_gossip_queue_empty(protocol_gossip_queue_t const queue) { return (queue == NULL); }
 
 size_t protocol_gossip_queue_count(protocol_gossip_queue_t const queue) {
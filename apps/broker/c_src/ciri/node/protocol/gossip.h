@@ -88,6 +88,19 @@ retcode_t protocol_gossip_set_request(protocol_gossip_t* const packet, flex_trit
  */
 retcode_t protocol_gossip_set_endpoint(protocol_gossip_t* const packet, char const* const ip, uint16_t const port);
 
+/**
+ * Sets the content of a gossip packet from its payload as sent on the wire, whose signature message fragment is
+ * stripped of its trailing zeros
+ *
+ * @param[out]  packet  The packet
+ * @param[in]   payload The payload
+ * @param[in]   length  The payload length, in [GOSSIP_MIN_BYTES_LENGTH, GOSSIP_MAX_BYTES_LENGTH]
+ *
+ * @return a status code
+ */
+retcode_t protocol_gossip_set_payload(protocol_gossip_t* const packet, byte_t const* const payload,
+                                      uint16_t const length);
+
 /**
  * Tells whether a gossip packet queue is empty or not
  *
@@ -8,26 +8,26 @@
 #ifndef __NODE_RECENT_SEEN_BYTES_CACHE_H__
 #define __NODE_RECENT_SEEN_BYTES_CACHE_H__
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include "xxhash.h"
 
 #include "ciri/node/protocol/gossip.h"
-#include "ciri/node/uint64_t_to_flex_trit_t_map.h"
 #include "common/errors.h"
 #include "common/trinary/flex_trit.h"
-#include "utils/handles/lock.h"
+#include "utils/containers/clock_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// A fixed capacity FIFO-behaving recent seen bytes cache
-typedef struct recent_seen_bytes_cache_s {
-  uint64_t_to_flex_trit_t_map_t map;
-  size_t capacity;
-  uint64_t miss;
-  uint64_t hit;
-  lock_handle_t lock;
-} recent_seen_bytes_cache_t;
+// Shards of the cache at most, see clock_cache_init()
+#define RECENT_SEEN_BYTES_CACHE_MAX_SHARDS 64
+
+// A fixed capacity cache of transaction hashes by digest of their bytes, lock striped and evicting with CLOCK
+typedef clock_cache_t recent_seen_bytes_cache_t;
+typedef clock_cache_stats_t recent_seen_bytes_cache_stats_t;
 
 retcode_t recent_seen_bytes_cache_init(recent_seen_bytes_cache_t *const cache, size_t const capacity);
 retcode_t recent_seen_bytes_cache_destroy(recent_seen_bytes_cache_t *const cache);
@@ -35,6 +35,11 @@ retcode_t recent_seen_bytes_cache_get(recent_seen_bytes_cache_t *const cache, ui
                                       flex_trit_t *const hash, bool *const found);
 retcode_t recent_seen_bytes_cache_put(recent_seen_bytes_cache_t *const cache, uint64_t const digest,
                                       flex_trit_t const *const hash);
+size_t recent_seen_bytes_cache_size(recent_seen_bytes_cache_t *const cache);
+
+// Gives the counters of the cache, see clock_cache_stats()
+retcode_t recent_seen_bytes_cache_stats(recent_seen_bytes_cache_t *const cache,
+                                        recent_seen_bytes_cache_stats_t *const stats);
 
 static inline retcode_t recent_seen_bytes_cache_hash(byte_t const *const bytes, uint64_t *const digest) {
   if (bytes == NULL || digest == NULL) {
@@ -46,16 +51,6 @@ static inline retcode_t recent_seen_bytes_cache_hash(byte_t const *const bytes,
   return RC_OK;
 }
 
-static inline size_t recent_seen_bytes_cache_size(recent_seen_bytes_cache_t *const cache) {
-  size_t size = 0;
-
-  lock_handle_lock(&cache->lock);
-  size = uint64_t_to_flex_trit_t_map_size(cache->map);
-  lock_handle_unlock(&cache->lock);
-
-  return size;
-}
-
 #ifdef __cplusplus
 }
 #endif
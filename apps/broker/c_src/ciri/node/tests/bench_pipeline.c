@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Replays gossip packets through the processing stages of the node pipeline, connected by their bounded queues, and
+ * reports the throughput and queueing latency of each stage.
+ *
+ * Router threads push the packets to the processor, which looks them up in the recent seen bytes cache and passes new
+ * ones to the hasher, which hashes them by batches of ptrit_wide_lanes() and passes them to the validator, which
+ * deserializes them and caches their hash. The work of each stage is the one of the node, minus the database.
+ *
+ * Usage: bench_pipeline [packets] [routers] [queue_size] [capture]
+ * A capture is a file of gossip packets of GOSSIP_MAX_BYTES_LENGTH bytes each, as the router rebuilds them from the
+ * wire. Without one, packets are made of random transactions, a tenth of them sent twice.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ciri/node/protocol/gossip.h"
+#include "ciri/node/recent_seen_bytes_cache.h"
+#include "common/crypto/curl-p/ptrit_wide.h"
+#include "common/model/transaction.h"
+#include "common/trinary/trit_ptrit.h"
+#include "utils/containers/ring_buffer.h"
+#include "utils/handles/thread.h"
+#include "utils/time.h"
+
+#define DEFAULT_PACKETS 100000
+#define DEFAULT_ROUTERS 2
+#define DEFAULT_QUEUE_SIZE 2048
+#define SYNTHETIC_UNIQUE_RATIO 0.9
+#define CACHE_SIZE 100000
+#define BATCH_SIZE 64
+#define BACKOFF_MS 1
+
+typedef enum stage_e { PROCESSOR, HASHER, VALIDATOR, STAGES_NUM } stage_t;
+
+static char const *const STAGE_NAMES[STAGES_NUM] = {"processor", "hasher", "validator"};
+
+typedef struct item_s {
+  uint64_t enqueued_ns;
+  uint64_t digest;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  protocol_gossip_t gossip;
+} item_t;
+
+typedef struct stage_stats_s {
+  size_t items;
+  size_t full;  // Pushes rejected because the queue of the stage was full
+  uint64_t first_ns;
+  uint64_t last_ns;
+  uint64_t *waits_ns;  // Queueing latency of each item
+} stage_stats_t;
+
+typedef struct bench_s {
+  byte_t const *packets;
+  size_t packets_num;
+  size_t replayed;
+  size_t routers_num;
+  ring_buffer_t queues[STAGES_NUM];
+  stage_stats_t stats[STAGES_NUM];
+  atomic_size_t routers_done;
+  atomic_bool done[STAGES_NUM];
+  atomic_size_t router_full;
+  size_t cached;
+  size_t invalid;
+  recent_seen_bytes_cache_t cache;
+} bench_t;
+
+typedef struct router_s {
+  bench_t *bench;
+  size_t id;
+} router_t;
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmp_u64(void const *const lhs, void const *const rhs) {
+  uint64_t const a = *(uint64_t const *)lhs, b = *(uint64_t const *)rhs;
+
+  return (a > b) - (a < b);
+}
+
+static void stats_record(stage_stats_t *const stats, uint64_t const enqueued_ns, uint64_t const now) {
+  if (stats->items == 0) {
+    stats->first_ns = now;
+  }
+  stats->last_ns = now;
+  stats->waits_ns[stats->items++] = now - enqueued_ns;
+}
+
+// Records the item as handled by its stage and pushes it to the next one, false if that is full
+static bool forward(bench_t *const bench, stage_t const stage, item_t *const item, uint64_t const now) {
+  uint64_t const enqueued_ns = item->enqueued_ns;
+
+  item->enqueued_ns = now_ns();
+  if (ring_buffer_push(&bench->queues[stage + 1], item) == RC_UTILS_RING_BUFFER_FULL) {
+    item->enqueued_ns = enqueued_ns;
+    bench->stats[stage + 1].full++;
+    return false;
+  }
+  stats_record(&bench->stats[stage], enqueued_ns, now);
+
+  return true;
+}
+
+// Waits for items, false once the previous stage is done and the queue drained
+static bool wait_items(bench_t *const bench, stage_t const stage) {
+  bool const upstream_done = stage == PROCESSOR ? atomic_load(&bench->routers_done) == bench->routers_num
+                                                : atomic_load(&bench->done[stage - 1]);
+
+  if (upstream_done && ring_buffer_size(&bench->queues[stage]) == 0) {
+    atomic_store(&bench->done[stage], true);
+    if (stage + 1 < STAGES_NUM) {
+      ring_buffer_wake(&bench->queues[stage + 1]);
+    }
+    return false;
+  }
+  ring_buffer_wait(&bench->queues[stage]);
+
+  return true;
+}
+
+static void *route(router_t *const router) {
+  bench_t *const bench = router->bench;
+  item_t item;
+
+  memset(&item, 0, sizeof(item_t));
+  for (size_t i = router->id; i < bench->replayed; i += bench->routers_num) {
+    memcpy(item.gossip.content, bench->packets + (i % bench->packets_num) * GOSSIP_MAX_BYTES_LENGTH,
+           GOSSIP_MAX_BYTES_LENGTH);
+    item.enqueued_ns = now_ns();
+    // A node stops reading from its neighbors instead
+    while (ring_buffer_push(&bench->queues[PROCESSOR], &item) == RC_UTILS_RING_BUFFER_FULL) {
+      atomic_fetch_add(&bench->router_full, 1);
+      sleep_ms(BACKOFF_MS);
+    }
+  }
+  if (atomic_fetch_add(&bench->routers_done, 1) + 1 == bench->routers_num) {
+    ring_buffer_wake(&bench->queues[PROCESSOR]);
+  }
+
+  return NULL;
+}
+
+static void *process(bench_t *const bench) {
+  void *entries[BATCH_SIZE];
+  item_t *item = NULL;
+  size_t count = 0, processed = 0;
+  bool cached = false;
+
+  while (true) {
+    if ((count = ring_buffer_peek(&bench->queues[PROCESSOR], entries, BATCH_SIZE)) == 0) {
+      if (!wait_items(bench, PROCESSOR)) {
+        break;
+      }
+      continue;
+    }
+    for (processed = 0; processed < count; processed++) {
+      item = (item_t *)entries[processed];
+      recent_seen_bytes_cache_hash(item->gossip.content, &item->digest);
+      recent_seen_bytes_cache_get(&bench->cache, item->digest, item->hash, &cached);
+      if (cached) {
+        bench->cached++;
+        stats_record(&bench->stats[PROCESSOR], item->enqueued_ns, now_ns());
+      } else if (!forward(bench, PROCESSOR, item, now_ns())) {
+        break;
+      }
+    }
+    ring_buffer_consume(&bench->queues[PROCESSOR], processed);
+    if (processed < count) {
+      sleep_ms(BACKOFF_MS);
+    }
+  }
+
+  return NULL;
+}
+
+static void *hash(bench_t *const bench) {
+  void *entries[PTRIT_WIDE_LANES];
+  byte_t const *contents[PTRIT_WIDE_LANES];
+  size_t const lanes = ptrit_wide_lanes();
+  size_t count = 0, forwarded = 0;
+  ptrit_wide_t *acc = (ptrit_wide_t *)malloc(NUM_TRITS_SERIALIZED_TRANSACTION * sizeof(ptrit_wide_t));
+  PCurlWide *curl = (PCurlWide *)malloc(sizeof(PCurlWide));
+  trit_t trits[HASH_LENGTH_TRIT];
+  item_t *item = NULL;
+  uint64_t now = 0;
+
+  while (acc != NULL && curl != NULL) {
+    if ((count = ring_buffer_peek(&bench->queues[HASHER], entries, lanes)) == 0) {
+      if (!wait_items(bench, HASHER)) {
+        break;
+      }
+      continue;
+    }
+    now = now_ns();
+    for (size_t j = 0; j < count; j++) {
+      contents[j] = ((item_t *)entries[j])->gossip.content;
+    }
+    bytes_to_ptrits_wide(contents, count, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ptrit_wide_curl_init(curl, CURL_P_81, count);
+    ptrit_wide_curl_absorb(curl, acc, NUM_TRITS_SERIALIZED_TRANSACTION);
+    ptrit_wide_curl_squeeze(curl, acc, HASH_LENGTH_TRIT);
+    for (forwarded = 0; forwarded < count; forwarded++) {
+      item = (item_t *)entries[forwarded];
+      ptrits_wide_to_trits(acc, trits, forwarded, HASH_LENGTH_TRIT);
+      flex_trits_from_trits(item->hash, HASH_LENGTH_TRIT, trits, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+      if (!forward(bench, HASHER, item, now)) {
+        break;
+      }
+    }
+    ring_buffer_consume(&bench->queues[HASHER], forwarded);
+    if (forwarded < count) {
+      sleep_ms(BACKOFF_MS);
+    }
+  }
+  free(acc);
+  free(curl);
+
+  return NULL;
+}
+
+static void *validate(bench_t *const bench) {
+  void *entries[BATCH_SIZE];
+  flex_trit_t trits[FLEX_TRIT_SIZE_8019];
+  iota_transaction_t transaction;
+  item_t const *item = NULL;
+  size_t count = 0;
+
+  while (true) {
+    if ((count = ring_buffer_peek(&bench->queues[VALIDATOR], entries, BATCH_SIZE)) == 0) {
+      if (!wait_items(bench, VALIDATOR)) {
+        break;
+      }
+      continue;
+    }
+    for (size_t i = 0; i < count; i++) {
+      item = (item_t const *)entries[i];
+      stats_record(&bench->stats[VALIDATOR], item->enqueued_ns, now_ns());
+      if (flex_trits_from_bytes(trits, NUM_TRITS_SERIALIZED_TRANSACTION, item->gossip.content,
+                                NUM_TRITS_SERIALIZED_TRANSACTION,
+                                NUM_TRITS_SERIALIZED_TRANSACTION) != NUM_TRITS_SERIALIZED_TRANSACTION ||
+          transaction_deserialize_from_trits(&transaction, trits, false) != NUM_TRITS_SERIALIZED_TRANSACTION) {
+        bench->invalid++;
+      }
+      recent_seen_bytes_cache_put(&bench->cache, item->digest, item->hash);
+    }
+    ring_buffer_consume(&bench->queues[VALIDATOR], count);
+  }
+
+  return NULL;
+}
+
+static byte_t *synthetic_packets(size_t const packets_num) {
+  byte_t *packets = (byte_t *)calloc(packets_num, GOSSIP_MAX_BYTES_LENGTH);
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  flex_trit_t flex_trits[FLEX_TRIT_SIZE_8019];
+
+  if (packets == NULL) {
+    return NULL;
+  }
+  srand(42);
+  for (size_t i = 0; i < packets_num; i++) {
+    for (size_t j = 0; j < NUM_TRITS_SERIALIZED_TRANSACTION; j++) {
+      trits[j] = (rand() % 3) - 1;
+    }
+    flex_trits_from_trits(flex_trits, NUM_TRITS_SERIALIZED_TRANSACTION, trits, NUM_TRITS_SERIALIZED_TRANSACTION,
+                          NUM_TRITS_SERIALIZED_TRANSACTION);
+    flex_trits_to_bytes(packets + i * GOSSIP_MAX_BYTES_LENGTH, NUM_TRITS_SERIALIZED_TRANSACTION, flex_trits,
+                        NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+  }
+
+  return packets;
+}
+
+static byte_t *captured_packets(char const *const path, size_t *const packets_num) {
+  FILE *file = fopen(path, "rb");
+  byte_t *packets = NULL;
+  long size = 0;
+
+  if (file == NULL || fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < GOSSIP_MAX_BYTES_LENGTH) {
+    goto done;
+  }
+  *packets_num = size / GOSSIP_MAX_BYTES_LENGTH;
+  rewind(file);
+  if ((packets = (byte_t *)malloc(*packets_num * GOSSIP_MAX_BYTES_LENGTH)) != NULL &&
+      fread(packets, GOSSIP_MAX_BYTES_LENGTH, *packets_num, file) != *packets_num) {
+    free(packets);
+    packets = NULL;
+  }
+
+done:
+  if (file) {
+    fclose(file);
+  }
+
+  return packets;
+}
+
+static void report(bench_t *const bench, double const seconds) {
+  for (size_t s = 0; s < STAGES_NUM; s++) {
+    stage_stats_t *const stats = &bench->stats[s];
+    double const busy = (stats->last_ns - stats->first_ns) / 1e9;
+    uint64_t sum = 0;
+
+    if (stats->items == 0) {
+      printf("%-10s no packets\n", STAGE_NAMES[s]);
+      continue;
+    }
+    qsort(stats->waits_ns, stats->items, sizeof(uint64_t), cmp_u64);
+    for (size_t i = 0; i < stats->items; i++) {
+      sum += stats->waits_ns[i];
+    }
+    printf("%-10s %8zu packets %10.0f pkt/s  queueing mean %8.1f us  p50 %8.1f us  p99 %8.1f us  max %8.1f us  "
+           "full %zu\n",
+           STAGE_NAMES[s], stats->items, busy > 0 ? stats->items / busy : 0, sum / 1e3 / stats->items,
+           stats->waits_ns[stats->items / 2] / 1e3, stats->waits_ns[stats->items * 99 / 100] / 1e3,
+           stats->waits_ns[stats->items - 1] / 1e3, s == PROCESSOR ? atomic_load(&bench->router_full) : stats->full);
+  }
+  printf("pipeline   %8zu packets %10.0f pkt/s  %zu cached, %zu invalid\n", bench->replayed,
+         bench->replayed / seconds, bench->cached, bench->invalid);
+}
+
+int main(int argc, char **argv) {
+  size_t const replayed = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_PACKETS;
+  size_t const routers_num = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_ROUTERS;
+  size_t const queue_size = argc > 3 ? strtoul(argv[3], NULL, 10) : DEFAULT_QUEUE_SIZE;
+  bench_t bench;
+  router_t *routers = NULL;
+  thread_handle_t *router_threads = NULL;
+  thread_handle_t threads[STAGES_NUM];
+  void *(*routines[STAGES_NUM])(bench_t *const) = {process, hash, validate};
+  uint64_t start = 0;
+  int ret = EXIT_FAILURE;
+
+  memset(&bench, 0, sizeof(bench_t));
+  if (replayed == 0 || routers_num == 0 || queue_size == 0) {
+    return EXIT_FAILURE;
+  }
+  bench.replayed = replayed;
+  bench.routers_num = routers_num;
+  if (argc > 4) {
+    bench.packets = captured_packets(argv[4], &bench.packets_num);
+  } else {
+    bench.packets_num = (size_t)(replayed * SYNTHETIC_UNIQUE_RATIO) + 1;
+    bench.packets = synthetic_packets(bench.packets_num);
+  }
+  if (bench.packets == NULL) {
+    fprintf(stderr, "Loading packets failed\n");
+    return EXIT_FAILURE;
+  }
+
+  routers = (router_t *)calloc(routers_num, sizeof(router_t));
+  router_threads = (thread_handle_t *)calloc(routers_num, sizeof(thread_handle_t));
+  if (routers == NULL || router_threads == NULL ||
+      recent_seen_bytes_cache_init(&bench.cache, CACHE_SIZE) != RC_OK) {
+    goto done;
+  }
+  for (size_t s = 0; s < STAGES_NUM; s++) {
+    if (ring_buffer_init(&bench.queues[s], sizeof(item_t), queue_size,
+                         s == PROCESSOR ? RING_BUFFER_MULTI_PRODUCER : RING_BUFFER_SINGLE_PRODUCER) != RC_OK ||
+        (bench.stats[s].waits_ns = (uint64_t *)malloc(replayed * sizeof(uint64_t))) == NULL) {
+      goto done;
+    }
+  }
+
+  start = now_ns();
+  for (size_t s = 0; s < STAGES_NUM; s++) {
+    thread_handle_create(&threads[s], (thread_routine_t)routines[s], &bench);
+  }
+  for (size_t i = 0; i < routers_num; i++) {
+    routers[i] = (router_t){.bench = &bench, .id = i};
+    thread_handle_create(&router_threads[i], (thread_routine_t)route, &routers[i]);
+  }
+  for (size_t i = 0; i < routers_num; i++) {
+    thread_handle_join(router_threads[i], NULL);
+  }
+  for (size_t s = 0; s < STAGES_NUM; s++) {
+    thread_handle_join(threads[s], NULL);
+  }
+
+  printf("packets: %zu replayed from %zu %s, %zu routers, queues of %zu, %zu hashing lanes\n", replayed,
+         bench.packets_num, argc > 4 ? "captured" : "synthetic", routers_num,
+         ring_buffer_capacity(&bench.queues[PROCESSOR]), ptrit_wide_lanes());
+  report(&bench, (now_ns() - start) / 1e9);
+  ret = bench.stats[PROCESSOR].items == replayed ? EXIT_SUCCESS : EXIT_FAILURE;
+
+done:
+  for (size_t s = 0; s < STAGES_NUM; s++) {
+    ring_buffer_destroy(&bench.queues[s]);
+    free(bench.stats[s].waits_ns);
+  }
+  recent_seen_bytes_cache_destroy(&bench.cache);
+  free((void *)bench.packets);
+  free(routers);
+  free(router_threads);
+
+  return ret;
+}
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Compares the recent seen bytes cache with the single lock FIFO map it replaced, under concurrent lookups.
+ *
+ * Each thread draws digests, looks them up and inserts the missing ones, like the processor and validator do. Half of
+ * the draws come from a hot set of half the capacity, the others from a key space four times the capacity, so that
+ * throughput and hit rate both depend on the eviction policy.
+ *
+ * Usage: bench_recent_seen_bytes_cache [entries] [threads] [operations per thread]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ciri/node/recent_seen_bytes_cache.h"
+#include "ciri/node/uint64_t_to_flex_trit_t_map.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+#define DEFAULT_ENTRIES 1000000
+#define DEFAULT_THREADS 8
+#define DEFAULT_OPERATIONS 1000000
+#define HOT_RATIO 0.5
+#define KEY_SPACE_RATIO 4
+
+// The previous implementation: a uthash map behind one lock, evicting its oldest entry
+typedef struct baseline_cache_s {
+  uint64_t_to_flex_trit_t_map_t map;
+  size_t capacity;
+  uint64_t miss;
+  uint64_t hit;
+  lock_handle_t lock;
+} baseline_cache_t;
+
+typedef struct cache_ops_s {
+  char const *name;
+  retcode_t (*get)(void *const cache, uint64_t const digest, flex_trit_t *const hash, bool *const found);
+  retcode_t (*put)(void *const cache, uint64_t const digest, flex_trit_t const *const hash);
+} cache_ops_t;
+
+typedef struct worker_s {
+  cache_ops_t const *ops;
+  void *cache;
+  size_t entries;
+  size_t operations;
+  uint64_t seed;
+  size_t hits;
+} worker_t;
+
+static retcode_t baseline_get(void *const cache, uint64_t const digest, flex_trit_t *const hash, bool *const found) {
+  baseline_cache_t *const baseline = (baseline_cache_t *)cache;
+  uint64_t_to_flex_trit_t_map_entry_t *entry = NULL;
+
+  lock_handle_lock(&baseline->lock);
+  if ((*found = uint64_t_to_flex_trit_t_map_find(baseline->map, &digest, &entry))) {
+    memcpy(hash, entry->value, FLEX_TRIT_SIZE_243);
+    baseline->hit++;
+  } else {
+    baseline->miss++;
+  }
+  lock_handle_unlock(&baseline->lock);
+
+  return RC_OK;
+}
+
+static retcode_t baseline_put(void *const cache, uint64_t const digest, flex_trit_t const *const hash) {
+  baseline_cache_t *const baseline = (baseline_cache_t *)cache;
+  uint64_t_to_flex_trit_t_map_entry_t *entry = NULL;
+  retcode_t ret = RC_OK;
+
+  lock_handle_lock(&baseline->lock);
+  if (!uint64_t_to_flex_trit_t_map_find(baseline->map, &digest, &entry)) {
+    if (uint64_t_to_flex_trit_t_map_size(baseline->map) >= baseline->capacity) {
+      if ((ret = uint64_t_to_flex_trit_t_map_remove_entry(&baseline->map, baseline->map.map)) != RC_OK) {
+        goto done;
+      }
+    }
+    ret = uint64_t_to_flex_trit_t_map_add(&baseline->map, &digest, hash);
+  }
+
+done:
+  lock_handle_unlock(&baseline->lock);
+
+  return ret;
+}
+
+static retcode_t sharded_get(void *const cache, uint64_t const digest, flex_trit_t *const hash, bool *const found) {
+  return recent_seen_bytes_cache_get((recent_seen_bytes_cache_t *)cache, digest, hash, found);
+}
+
+static retcode_t sharded_put(void *const cache, uint64_t const digest, flex_trit_t const *const hash) {
+  return recent_seen_bytes_cache_put((recent_seen_bytes_cache_t *)cache, digest, hash);
+}
+
+static cache_ops_t const BASELINE_OPS = {"single lock FIFO", baseline_get, baseline_put};
+static cache_ops_t const SHARDED_OPS = {"sharded CLOCK", sharded_get, sharded_put};
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// xorshift64*
+static inline uint64_t next_random(uint64_t *const state) {
+  *state ^= *state >> 12;
+  *state ^= *state << 25;
+  *state ^= *state >> 27;
+  return *state * 0x2545F4914F6CDD1DULL;
+}
+
+// Spreads a key over all digest bits, as XXH64 would
+static inline uint64_t digest_of(uint64_t const key) { return (key + 1) * 0x9E3779B97F4A7C15ULL; }
+
+static void *work(worker_t *const worker) {
+  uint64_t const hot = worker->entries * HOT_RATIO;
+  uint64_t const space = worker->entries * KEY_SPACE_RATIO;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint64_t random = 0, digest = 0;
+  bool found = false;
+
+  memset(hash, 0, FLEX_TRIT_SIZE_243);
+  for (size_t i = 0; i < worker->operations; i++) {
+    random = next_random(&worker->seed);
+    digest = digest_of((random & 1) ? (random >> 1) % hot : (random >> 1) % space);
+    worker->ops->get(worker->cache, digest, hash, &found);
+    if (found) {
+      worker->hits++;
+    } else {
+      memcpy(hash, &digest, sizeof(digest));
+      worker->ops->put(worker->cache, digest, hash);
+    }
+  }
+
+  return NULL;
+}
+
+static int run(cache_ops_t const *const ops, void *const cache, size_t const entries, size_t const threads_num,
+               size_t const operations) {
+  worker_t *workers = (worker_t *)calloc(threads_num, sizeof(worker_t));
+  thread_handle_t *threads = (thread_handle_t *)calloc(threads_num, sizeof(thread_handle_t));
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  uint64_t start = 0, elapsed = 0, digest = 0;
+  size_t hits = 0;
+
+  if (workers == NULL || threads == NULL) {
+    free(workers);
+    free(threads);
+    return EXIT_FAILURE;
+  }
+
+  // Warming up with the whole hot set and cold keys up to capacity
+  memset(hash, 0, FLEX_TRIT_SIZE_243);
+  for (uint64_t key = 0; key < entries; key++) {
+    digest = digest_of(key);
+    memcpy(hash, &digest, sizeof(digest));
+    ops->put(cache, digest, hash);
+  }
+
+  start = now_ns();
+  for (size_t i = 0; i < threads_num; i++) {
+    workers[i] =
+        (worker_t){.ops = ops, .cache = cache, .entries = entries, .operations = operations, .seed = 0x5EED + i};
+    thread_handle_create(&threads[i], (thread_routine_t)work, &workers[i]);
+  }
+  for (size_t i = 0; i < threads_num; i++) {
+    thread_handle_join(threads[i], NULL);
+    hits += workers[i].hits;
+  }
+  elapsed = now_ns() - start;
+
+  printf("%-18s %10.0f ops/s  %6.1f ns/op  hit rate %5.1f%%\n", ops->name,
+         threads_num * operations / (elapsed / 1e9), (double)elapsed / operations,
+         100.0 * hits / (threads_num * operations));
+
+  free(workers);
+  free(threads);
+
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char **argv) {
+  size_t const entries = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_ENTRIES;
+  size_t const threads_num = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_THREADS;
+  size_t const operations = argc > 3 ? strtoul(argv[3], NULL, 10) : DEFAULT_OPERATIONS;
+  baseline_cache_t baseline;
+  recent_seen_bytes_cache_t sharded;
+  recent_seen_bytes_cache_stats_t stats;
+  int ret = EXIT_FAILURE;
+
+  if (entries == 0 || threads_num == 0 || operations == 0) {
+    return EXIT_FAILURE;
+  }
+  printf("cache: %zu entries, %zu threads, %zu operations per thread\n", entries, threads_num, operations);
+
+  baseline.capacity = entries;
+  baseline.hit = baseline.miss = 0;
+  lock_handle_init(&baseline.lock);
+  if (uint64_t_to_flex_trit_t_map_init(&baseline.map, sizeof(uint64_t), FLEX_TRIT_SIZE_243) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  ret = run(&BASELINE_OPS, &baseline, entries, threads_num, operations);
+  uint64_t_to_flex_trit_t_map_free(&baseline.map);
+  lock_handle_destroy(&baseline.lock);
+  if (ret != EXIT_SUCCESS) {
+    return ret;
+  }
+
+  if (recent_seen_bytes_cache_init(&sharded, entries) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  if ((ret = run(&SHARDED_OPS, &sharded, entries, threads_num, operations)) == EXIT_SUCCESS &&
+      recent_seen_bytes_cache_stats(&sharded, &stats) == RC_OK) {
+    printf("%-18s %zu shards, %zu entries, %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions\n", "",
+           stats.shards, stats.size, stats.hit, stats.miss, stats.eviction);
+  }
+  recent_seen_bytes_cache_destroy(&sharded);
+
+  return ret;
+}
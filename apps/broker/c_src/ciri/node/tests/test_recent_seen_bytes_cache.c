@@ -132,10 +132,91 @@ void test_recent_seen_bytes_cache() {
   transactions_free(txs, 4);
 }
 
+void test_recent_seen_bytes_cache_second_chance() {
+  recent_seen_bytes_cache_t cache;
+  recent_seen_bytes_cache_stats_t stats;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool found = false;
+
+  TEST_ASSERT(recent_seen_bytes_cache_init(&cache, 4) == RC_OK);
+
+  for (uint64_t digest = 1; digest <= 4; digest++) {
+    memset(hash, (int)digest, FLEX_TRIT_SIZE_243);
+    TEST_ASSERT(recent_seen_bytes_cache_put(&cache, digest, hash) == RC_OK);
+  }
+
+  // Seeing 1 and 3 again gives them a second chance, so 2 then 4 get evicted
+
+  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, 1, hash, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT(recent_seen_bytes_cache_get(&cache, 3, hash, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+
+  memset(hash, 5, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(recent_seen_bytes_cache_put(&cache, 5, hash) == RC_OK);
+  memset(hash, 6, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(recent_seen_bytes_cache_put(&cache, 6, hash) == RC_OK);
+  TEST_ASSERT(recent_seen_bytes_cache_size(&cache) == 4);
+
+  for (uint64_t digest = 1; digest <= 6; digest++) {
+    TEST_ASSERT(recent_seen_bytes_cache_get(&cache, digest, hash, &found) == RC_OK);
+    TEST_ASSERT(found == (digest != 2 && digest != 4));
+    if (found) {
+      TEST_ASSERT_EQUAL_UINT8(digest, hash[0]);
+    }
+  }
+
+  TEST_ASSERT(recent_seen_bytes_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_UINT64(4, stats.size);
+  TEST_ASSERT_EQUAL_UINT64(4, stats.capacity);
+  TEST_ASSERT_EQUAL_UINT64(6, stats.hit);
+  TEST_ASSERT_EQUAL_UINT64(2, stats.miss);
+  TEST_ASSERT_EQUAL_UINT64(2, stats.eviction);
+
+  TEST_ASSERT(recent_seen_bytes_cache_destroy(&cache) == RC_OK);
+}
+
+void test_recent_seen_bytes_cache_sharded() {
+  recent_seen_bytes_cache_t cache;
+  recent_seen_bytes_cache_stats_t stats;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  bool found = false;
+  size_t const capacity = 10000;
+  size_t hits = 0;
+
+  TEST_ASSERT(recent_seen_bytes_cache_init(&cache, capacity) == RC_OK);
+  TEST_ASSERT(cache.shards_num > 1);
+
+  // Spreading digests over the shard and slot bits alike
+  for (uint64_t i = 0; i < 2 * capacity; i++) {
+    memset(hash, (int)(i % 27), FLEX_TRIT_SIZE_243);
+    TEST_ASSERT(recent_seen_bytes_cache_put(&cache, i * 0x9E3779B97F4A7C15ULL, hash) == RC_OK);
+  }
+  TEST_ASSERT(recent_seen_bytes_cache_size(&cache) <= capacity);
+
+  for (uint64_t i = 0; i < 2 * capacity; i++) {
+    TEST_ASSERT(recent_seen_bytes_cache_get(&cache, i * 0x9E3779B97F4A7C15ULL, hash, &found) == RC_OK);
+    if (found) {
+      TEST_ASSERT_EQUAL_UINT8(i % 27, hash[0]);
+      hits++;
+    }
+  }
+
+  TEST_ASSERT(recent_seen_bytes_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_UINT64(stats.size, hits);
+  TEST_ASSERT_EQUAL_UINT64(2 * capacity - stats.size, stats.eviction);
+  TEST_ASSERT_EQUAL_UINT64(hits, stats.hit);
+  TEST_ASSERT_EQUAL_UINT64(2 * capacity - hits, stats.miss);
+
+  TEST_ASSERT(recent_seen_bytes_cache_destroy(&cache) == RC_OK);
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_recent_seen_bytes_cache);
+  RUN_TEST(test_recent_seen_bytes_cache_second_chance);
+  RUN_TEST(test_recent_seen_bytes_cache_sharded);
 
   return UNITY_END();
 }
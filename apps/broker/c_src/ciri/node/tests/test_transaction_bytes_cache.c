@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/node/transaction_bytes_cache.h"
+
+#define TXS_NUM 4
+
+static transaction_bytes_cache_t cache;
+static flex_trit_t hashes[TXS_NUM][FLEX_TRIT_SIZE_243];
+static byte_t txs_bytes[TXS_NUM][GOSSIP_TX_BYTES_LENGTH];
+
+void setUp(void) {
+  for (size_t i = 0; i < TXS_NUM; i++) {
+    memset(hashes[i], i + 1, FLEX_TRIT_SIZE_243);
+    memset(txs_bytes[i], i + 1, GOSSIP_TX_BYTES_LENGTH);
+  }
+}
+
+void tearDown(void) { TEST_ASSERT(transaction_bytes_cache_destroy(&cache) == RC_OK); }
+
+void test_transaction_bytes_cache_get_put(void) {
+  byte_t bytes[GOSSIP_TX_BYTES_LENGTH];
+  uint64_t digest = 0;
+  bool found = true;
+
+  TEST_ASSERT(transaction_bytes_cache_init(&cache, 3) == RC_OK);
+
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[0], bytes, &digest, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[0], txs_bytes[0], 42) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[0], bytes, &digest, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_MEMORY(txs_bytes[0], bytes, GOSSIP_TX_BYTES_LENGTH);
+  TEST_ASSERT_EQUAL_UINT64(42, digest);
+
+  // Putting a cached transaction again changes nothing
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[0], txs_bytes[1], 43) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[0], bytes, NULL, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_MEMORY(txs_bytes[0], bytes, GOSSIP_TX_BYTES_LENGTH);
+}
+
+void test_transaction_bytes_cache_eviction(void) {
+  transaction_bytes_cache_stats_t stats;
+  byte_t bytes[GOSSIP_TX_BYTES_LENGTH];
+  bool found = false;
+
+  TEST_ASSERT(transaction_bytes_cache_init(&cache, 3) == RC_OK);
+
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[i], txs_bytes[i], i) == RC_OK);
+  }
+  // A hit protects the first transaction from the next eviction
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[0], bytes, NULL, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[3], txs_bytes[3], 3) == RC_OK);
+
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[0], bytes, NULL, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[1], bytes, NULL, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[3], bytes, NULL, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_MEMORY(txs_bytes[3], bytes, GOSSIP_TX_BYTES_LENGTH);
+
+  TEST_ASSERT(transaction_bytes_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, stats.size);
+  TEST_ASSERT_EQUAL_INT(1, stats.eviction);
+  TEST_ASSERT_EQUAL_INT(3, stats.hit);
+  TEST_ASSERT_EQUAL_INT(1, stats.miss);
+}
+
+void test_transaction_bytes_cache_disabled(void) {
+  byte_t bytes[GOSSIP_TX_BYTES_LENGTH];
+  bool found = true;
+
+  TEST_ASSERT(transaction_bytes_cache_init(&cache, 0) == RC_OK);
+
+  TEST_ASSERT(transaction_bytes_cache_put(&cache, hashes[0], txs_bytes[0], 0) == RC_OK);
+  TEST_ASSERT(transaction_bytes_cache_get(&cache, hashes[0], bytes, NULL, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_transaction_bytes_cache_get_put);
+  RUN_TEST(test_transaction_bytes_cache_eviction);
+  RUN_TEST(test_transaction_bytes_cache_disabled);
+
+  return UNITY_END();
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "ciri/consensus/test_utils/tangle.h"
+#include "ciri/node/node.h"
+#include "ciri/node/pipeline/transaction_requester.h"
+
+#define HASHES_NUM 6
+
+static char *test_db_path = "ciri/node/tests/test.db";
+static char *ciri_db_path = "ciri/node/tests/ciri.db";
+static connection_config_t config;
+static tangle_t tangle;
+static node_t node;
+static transaction_requester_t requester;
+static neighbor_t neighbors[2];
+static flex_trit_t hashes[HASHES_NUM][FLEX_TRIT_SIZE_243];
+
+static requester_entry_t *find_entry(flex_trit_t const *const hash) {
+  requester_entry_t *entry = NULL;
+
+  HASH_FIND(hh, requester.entries, hash, FLEX_TRIT_SIZE_243, entry);
+  TEST_ASSERT_NOT_NULL(entry);
+
+  return entry;
+}
+
+static void expire(flex_trit_t const *const hash) { find_entry(hash)->sent_at -= REQUESTER_REQUEST_TIMEOUT_MS; }
+
+static void assert_next_request(neighbor_t const *const neighbor, flex_trit_t const *const expected) {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+
+  TEST_ASSERT(get_transaction_to_request(&requester, neighbor, hash) == RC_OK);
+  if (expected == NULL) {
+    TEST_ASSERT_TRUE(flex_trits_are_null(hash, FLEX_TRIT_SIZE_243));
+  } else {
+    TEST_ASSERT_EQUAL_MEMORY(expected, hash, FLEX_TRIT_SIZE_243);
+  }
+}
+
+void setUp(void) {
+  TEST_ASSERT(tangle_setup(&tangle, &config, test_db_path, ciri_db_path) == RC_OK);
+  node.conf.requester_queue_size = HASHES_NUM;
+  TEST_ASSERT(requester_init(&requester, &node) == RC_OK);
+  for (size_t i = 0; i < HASHES_NUM; i++) {
+    memset(hashes[i], 'A' + i, FLEX_TRIT_SIZE_243);
+  }
+}
+
+void tearDown(void) {
+  TEST_ASSERT(requester_destroy(&requester) == RC_OK);
+  TEST_ASSERT(tangle_cleanup(&tangle, test_db_path) == RC_OK);
+}
+
+void test_requester_priority(void) {
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[0], REQUESTER_NO_MILESTONE) == RC_OK);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[1], 10) == RC_OK);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[2], 5) == RC_OK);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[3], REQUESTER_NO_MILESTONE) == RC_OK);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[4], 6) == RC_OK);
+  // Requested again for an older milestone
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[3], 7) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(requester_size(&requester), 5);
+
+  assert_next_request(&neighbors[0], hashes[2]);
+  assert_next_request(&neighbors[0], hashes[4]);
+  assert_next_request(&neighbors[0], hashes[3]);
+  assert_next_request(&neighbors[0], hashes[1]);
+  assert_next_request(&neighbors[0], hashes[0]);
+  assert_next_request(&neighbors[0], NULL);
+
+  // Fulfilled requests leave the requester
+  TEST_ASSERT(requester_clear_request(&requester, hashes[2]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(requester_size(&requester), 4);
+}
+
+void test_requester_timeout_retry(void) {
+  requester_metrics_t metrics;
+  bool was_requested = false;
+
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[0], 1) == RC_OK);
+  TEST_ASSERT(requester_was_requested(&requester, hashes[0], &was_requested) == RC_OK);
+  TEST_ASSERT_FALSE(was_requested);
+
+  assert_next_request(&neighbors[0], hashes[0]);
+  TEST_ASSERT(requester_was_requested(&requester, hashes[0], &was_requested) == RC_OK);
+  TEST_ASSERT_TRUE(was_requested);
+  // In flight until timed out
+  assert_next_request(&neighbors[1], NULL);
+
+  expire(hashes[0]);
+  assert_next_request(&neighbors[1], hashes[0]);
+  TEST_ASSERT(requester_metrics(&requester, &metrics) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(metrics.timed_out, 1);
+  TEST_ASSERT_EQUAL_INT(metrics.in_flight, 1);
+
+  // Abandoned once sent too many times
+  for (size_t i = 2; i < REQUESTER_MAX_ATTEMPTS; i++) {
+    expire(hashes[0]);
+    assert_next_request(&neighbors[i % 2], hashes[0]);
+  }
+  expire(hashes[0]);
+  assert_next_request(&neighbors[0], NULL);
+  TEST_ASSERT_EQUAL_INT(requester_size(&requester), 0);
+  TEST_ASSERT(requester_metrics(&requester, &metrics) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(metrics.sent, REQUESTER_MAX_ATTEMPTS);
+  TEST_ASSERT_EQUAL_INT(metrics.abandoned, 1);
+
+  // Abandoned once requested for too long, even if never sent
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[1], REQUESTER_NO_MILESTONE) == RC_OK);
+  find_entry(hashes[1])->created_at -= REQUESTER_REQUEST_MAX_AGE_MS;
+  assert_next_request(&neighbors[0], NULL);
+  TEST_ASSERT_EQUAL_INT(requester_size(&requester), 0);
+  TEST_ASSERT(requester_metrics(&requester, &metrics) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(metrics.abandoned, 2);
+}
+
+void test_requester_neighbor_rotation(void) {
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[0], 1) == RC_OK);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[1], 2) == RC_OK);
+
+  assert_next_request(&neighbors[0], hashes[0]);
+  assert_next_request(&neighbors[1], hashes[1]);
+  expire(hashes[0]);
+  expire(hashes[1]);
+
+  // Each timed out request goes to the other neighbor
+  assert_next_request(&neighbors[0], hashes[1]);
+  assert_next_request(&neighbors[1], hashes[0]);
+  expire(hashes[0]);
+  expire(hashes[1]);
+
+  // Unless nothing else is left to send to the neighbor it timed out on
+  assert_next_request(&neighbors[1], hashes[1]);
+  assert_next_request(&neighbors[1], hashes[0]);
+}
+
+void test_requester_full(void) {
+  requester_metrics_t metrics;
+  bool was_requested = true;
+
+  node.conf.requester_queue_size = 2;
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[0], REQUESTER_NO_MILESTONE) == RC_OK);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[1], 3) == RC_OK);
+  TEST_ASSERT_TRUE(requester_is_full(&requester));
+  assert_next_request(&neighbors[0], hashes[1]);
+  assert_next_request(&neighbors[0], hashes[0]);
+
+  // A request of no milestone is dropped
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[2], REQUESTER_NO_MILESTONE) == RC_OK);
+  TEST_ASSERT(requester_was_requested(&requester, hashes[2], &was_requested) == RC_OK);
+  TEST_ASSERT_FALSE(was_requested);
+  TEST_ASSERT_EQUAL_INT(requester_size(&requester), 2);
+
+  // A milestone request evicts the request served last, even in flight
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[3], 2) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(requester_size(&requester), 2);
+  find_entry(hashes[1]);
+  find_entry(hashes[3]);
+
+  // Timed out requests are queued again before making room, a request of a later milestone is dropped
+  expire(hashes[1]);
+  TEST_ASSERT(request_transaction(&requester, &tangle, hashes[4], 4) == RC_OK);
+  find_entry(hashes[1]);
+  find_entry(hashes[3]);
+  TEST_ASSERT(requester_metrics(&requester, &metrics) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(metrics.dropped, 3);
+  TEST_ASSERT_EQUAL_INT(metrics.queued, 2);
+  TEST_ASSERT_EQUAL_INT(metrics.in_flight, 0);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  TEST_ASSERT(storage_init() == RC_OK);
+  config.db_path = test_db_path;
+
+  RUN_TEST(test_requester_priority);
+  RUN_TEST(test_requester_timeout_retry);
+  RUN_TEST(test_requester_neighbor_rotation);
+  RUN_TEST(test_requester_full);
+
+  TEST_ASSERT(storage_destroy() == RC_OK);
+
+  return UNITY_END();
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "xxhash.h"
+
+#include "ciri/node/transaction_bytes_cache.h"
+
+typedef struct transaction_bytes_cache_value_s {
+  // Identifies the value among the ones of colliding keys
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  // Digest of the bytes, as seen by the recent seen bytes cache
+  uint64_t digest;
+  byte_t bytes[GOSSIP_TX_BYTES_LENGTH];
+} transaction_bytes_cache_value_t;
+
+static inline uint64_t key_of(flex_trit_t const *const hash) { return XXH64(hash, FLEX_TRIT_SIZE_243, 0); }
+
+retcode_t transaction_bytes_cache_init(transaction_bytes_cache_t *const cache, size_t const capacity) {
+  return clock_cache_init(cache, capacity, sizeof(transaction_bytes_cache_value_t), FLEX_TRIT_SIZE_243,
+                          TRANSACTION_BYTES_CACHE_MAX_SHARDS);
+}
+
+retcode_t transaction_bytes_cache_destroy(transaction_bytes_cache_t *const cache) {
+  return clock_cache_destroy(cache);
+}
+
+retcode_t transaction_bytes_cache_get(transaction_bytes_cache_t *const cache, flex_trit_t const *const hash,
+                                      byte_t *const bytes, uint64_t *const digest, bool *const found) {
+  retcode_t ret = RC_OK;
+  transaction_bytes_cache_value_t value;
+
+  if (hash == NULL || bytes == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((ret = clock_cache_get(cache, key_of(hash), hash, &value, found)) != RC_OK || !*found) {
+    return ret;
+  }
+  memcpy(bytes, value.bytes, GOSSIP_TX_BYTES_LENGTH);
+  if (digest) {
+    *digest = value.digest;
+  }
+
+  return RC_OK;
+}
+
+retcode_t transaction_bytes_cache_put(transaction_bytes_cache_t *const cache, flex_trit_t const *const hash,
+                                      byte_t const *const bytes, uint64_t const digest) {
+  transaction_bytes_cache_value_t value;
+
+  if (hash == NULL || bytes == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memcpy(value.hash, hash, FLEX_TRIT_SIZE_243);
+  value.digest = digest;
+  memcpy(value.bytes, bytes, GOSSIP_TX_BYTES_LENGTH);
+
+  return clock_cache_put(cache, key_of(hash), &value);
+}
+
+retcode_t transaction_bytes_cache_stats(transaction_bytes_cache_t *const cache,
+                                        transaction_bytes_cache_stats_t *const stats) {
+  return clock_cache_stats(cache, stats);
+}
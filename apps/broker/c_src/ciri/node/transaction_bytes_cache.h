@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __NODE_TRANSACTION_BYTES_CACHE_H__
+#define __NODE_TRANSACTION_BYTES_CACHE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "ciri/node/protocol/gossip.h"
+#include "common/errors.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/clock_cache.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shards of the cache at most, see clock_cache_init()
+#define TRANSACTION_BYTES_CACHE_MAX_SHARDS 16
+
+/**
+ * A fixed capacity cache of the gossip bytes of recently stored transactions by hash, so that requests are answered
+ * without loading and serializing transactions. Lock striped across shards picked by hash, evicting with CLOCK.
+ */
+typedef clock_cache_t transaction_bytes_cache_t;
+typedef clock_cache_stats_t transaction_bytes_cache_stats_t;
+
+/**
+ * Initializes a transaction bytes cache
+ *
+ * @param cache The cache
+ * @param capacity The maximum number of transactions, 0 disabling the cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_init(transaction_bytes_cache_t *const cache, size_t const capacity);
+
+/**
+ * Destroys a transaction bytes cache
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_destroy(transaction_bytes_cache_t *const cache);
+
+/**
+ * Gets the bytes of a transaction from a cache
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param bytes GOSSIP_TX_BYTES_LENGTH bytes to be filled with the transaction
+ * @param digest The digest of the bytes, may be NULL
+ * @param found Whether the transaction was in the cache
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_get(transaction_bytes_cache_t *const cache, flex_trit_t const *const hash,
+                                      byte_t *const bytes, uint64_t *const digest, bool *const found);
+
+/**
+ * Puts the bytes of a transaction in a cache, evicting another transaction if full
+ *
+ * @param cache The cache
+ * @param hash The transaction hash
+ * @param bytes The GOSSIP_TX_BYTES_LENGTH bytes of the transaction
+ * @param digest The digest of the bytes
+ *
+ * @return a status code
+ */
+retcode_t transaction_bytes_cache_put(transaction_bytes_cache_t *const cache, flex_trit_t const *const hash,
+                                      byte_t const *const bytes, uint64_t const digest);
+
+// Gives the counters of the cache, see clock_cache_stats()
+retcode_t transaction_bytes_cache_stats(transaction_bytes_cache_t *const cache,
+                                        transaction_bytes_cache_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __NODE_TRANSACTION_BYTES_CACHE_H__
@@ -22,6 +22,8 @@ typedef enum cli_arg_value_e {
   // Node configuration
 
   CONF_AUTO_TETHERING_ENABLED,
+  CONF_HASHER_BATCH_DEADLINE_US,
+  CONF_HASHER_THREADS,
   CONF_MAX_NEIGHBORS,
   CONF_MWM,
   CONF_NEIGHBORING_ADDRESS,
@@ -29,7 +31,19 @@ typedef enum cli_arg_value_e {
   CONF_RECENT_SEEN_BYTES_CACHE_SIZE,
   CONF_RECONNECT_ATTEMPT_INTERVAL,
   CONF_REQUESTER_QUEUE_SIZE,
+  CONF_SEND_QUEUE_SIZE,
+  CONF_STAGE_QUEUE_SIZE,
+  CONF_TANGLE_DB_BACKEND,
+  CONF_TANGLE_DB_CACHE_SIZE,
+  CONF_TANGLE_DB_DURABILITY,
+  CONF_TANGLE_DB_MMAP_SIZE,
+  CONF_TANGLE_DB_READERS,
+  CONF_TANGLE_DB_TEMP_STORE,
+  CONF_TANGLE_DB_WAL_AUTOCHECKPOINT,
+  CONF_TANGLE_DB_WRITE_BATCH_SIZE,
+  CONF_TANGLE_DB_WRITE_BATCH_TIMEOUT,
   CONF_TIPS_CACHE_SIZE,
+  CONF_TRANSACTION_BYTES_CACHE_SIZE,
 
   // API configuration
 
@@ -96,6 +110,11 @@ static struct cli_argument_s {
      "Whether to accept new connections from unknown neighbors (which are not defined in the config and were not added "
      "via addNeighbors).",
      REQUIRED_ARG},
+    {"hasher-batch-deadline-us", CONF_HASHER_BATCH_DEADLINE_US,
+     "Maximum time (in microseconds) a hasher thread waits for packets to fill its lanes. It only waits when packets "
+     "arrive fast enough to fill them in time.",
+     REQUIRED_ARG},
+    {"hasher-threads", CONF_HASHER_THREADS, "Number of hasher threads, 0 for one per available core.", REQUIRED_ARG},
     {"max-neighbors", CONF_MAX_NEIGHBORS, "The maximum number of neighbors allowed to be connected.", REQUIRED_ARG},
     {"mwm", CONF_MWM,
      "Number of trailing ternary 0s that must appear at the end of a "
@@ -113,10 +132,45 @@ static struct cli_argument_s {
      "The number of entries to keep in the network cache.", REQUIRED_ARG},
     {"reconnect-attempt-interval", CONF_RECONNECT_ATTEMPT_INTERVAL,
      "The interval (in seconds) at which to reconnect to neighbors.", REQUIRED_ARG},
+    {"send-queue-size", CONF_SEND_QUEUE_SIZE,
+     "Number of packets waiting to be sent to a neighbor above which new ones are dropped.", REQUIRED_ARG},
+    {"stage-queue-size", CONF_STAGE_QUEUE_SIZE,
+     "Number of packets each pipeline stage queue holds. Packets are dropped and neighbors read less when the queues "
+     "are full.",
+     REQUIRED_ARG},
+    {"tangle-db-backend", CONF_TANGLE_DB_BACKEND,
+     "Storage backend of the tangle database: \"sqlite3\" or the LMDB key-value store \"kv\".", REQUIRED_ARG},
+    {"tangle-db-cache-size", CONF_TANGLE_DB_CACHE_SIZE,
+     "Page cache (in KiB) of each connection to the tangle database.", REQUIRED_ARG},
+    {"tangle-db-durability", CONF_TANGLE_DB_DURABILITY,
+     "Durability of the stored transactions: \"full\" survives a power loss, \"normal\" a crash of the node and "
+     "\"off\" neither.",
+     REQUIRED_ARG},
+    {"tangle-db-mmap-size", CONF_TANGLE_DB_MMAP_SIZE,
+     "Part of the tangle database file (in MiB) mapped in memory, 0 to read it through the page cache only.",
+     REQUIRED_ARG},
+    {"tangle-db-readers", CONF_TANGLE_DB_READERS,
+     "Number of reader connections to the tangle database kept open. Reads never wait behind the single writer "
+     "connection.",
+     REQUIRED_ARG},
+    {"tangle-db-temp-store", CONF_TANGLE_DB_TEMP_STORE,
+     "Where temporary tables and indices of the tangle database are kept: \"default\", \"file\" or \"memory\".",
+     REQUIRED_ARG},
+    {"tangle-db-wal-autocheckpoint", CONF_TANGLE_DB_WAL_AUTOCHECKPOINT,
+     "Number of pages the write-ahead log of the tangle database grows to before being checkpointed.", REQUIRED_ARG},
+    {"tangle-db-write-batch-size", CONF_TANGLE_DB_WRITE_BATCH_SIZE,
+     "Number of transactions stored together in a single database transaction, 0 or 1 to store them one by one.",
+     REQUIRED_ARG},
+    {"tangle-db-write-batch-timeout", CONF_TANGLE_DB_WRITE_BATCH_TIMEOUT,
+     "Maximum time (in milliseconds) a stored transaction waits for the others of its batch before being committed.",
+     REQUIRED_ARG},
     {"tips-cache-size", CONF_TIPS_CACHE_SIZE,
      "Size of the tips cache. Also bounds the number of tips returned by "
      "getTips API call.",
      REQUIRED_ARG},
+    {"transaction-bytes-cache-size", CONF_TRANSACTION_BYTES_CACHE_SIZE,
+     "The number of recently stored transactions whose bytes are kept to answer requests, 0 to disable.",
+     REQUIRED_ARG},
 
     // API configuration
 
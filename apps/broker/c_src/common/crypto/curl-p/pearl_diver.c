@@ -10,6 +10,7 @@
 #include <string.h>
 
 #include "common/crypto/curl-p/ptrit.h"
+#include "common/crypto/curl-p/ptrit_wide.h"
 #include "common/crypto/curl-p/search.h"
 #include "common/trinary/ptrit_incr.h"
 #include "common/trinary/trit_ptrit.h"
@@ -19,11 +20,17 @@
 
 typedef enum { SEARCH_RUNNING, SEARCH_INTERRUPT, SEARCH_FINISHED } SearchStatus;
 
+/*
+ * Each search thread runs `curl.words` independent 64-lane searches in one wide transform, see pd_search_init_thread
+ */
 typedef struct {
   unsigned short index;
+  unsigned short threads;
   unsigned short offset;
+  unsigned short step;
   unsigned short end;
-  PCurl curl;
+  PCurlWide curl;
+  PCurl init;
   short (*test)(PCurl *, unsigned short);
   unsigned short param;
   SearchStatus *status;
@@ -31,11 +38,13 @@ typedef struct {
 } SearchInstance;
 
 void init_inst(SearchInstance *const inst, SearchStatus *const status, rw_lock_handle_t *const statusLock,
-               unsigned short const index, PCurl *const curl, unsigned short const offset, unsigned short const end,
-               unsigned short const param, short (*test)(PCurl *const, unsigned short const));
+               unsigned short const threads, unsigned short const index, PCurl *const curl, unsigned short const offset,
+               unsigned short const end, unsigned short const param,
+               short (*test)(PCurl *const, unsigned short const));
 void pt_start(thread_handle_t *const tid, SearchInstance *const inst, unsigned short const index);
 void *run_search_thread(void *const data);
-short do_pd_search(short (*test)(PCurl *const, unsigned short const), SearchInstance *const inst, PCurl *const copy);
+intptr_t do_pd_search(short (*test)(PCurl *const, unsigned short const), SearchInstance *const inst,
+                      PCurlWide *const copy);
 
 PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigned short const end,
                            short (*test)(PCurl *const, unsigned short const), unsigned short const param) {
@@ -58,7 +67,7 @@ PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigne
     trits_to_ptrits_fill(ctx->state, curl.state, STATE_LENGTH);
     ptrit_offset(&curl.state[offset], 4);
     curl.type = ctx->type;
-    init_inst(inst, &status, &statusLock, n_procs, &curl, offset + 4, end, param, test);
+    init_inst(inst, &status, &statusLock, n_procs, n_procs, &curl, offset + 4, end, param, test);
   }
 
   pt_start(tid, inst, n_procs - 1);
@@ -87,7 +96,7 @@ PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigne
 
   rw_lock_handle_destroy(&statusLock);
 
-  ptrits_to_trits(&inst[found_thread].curl.state[offset], &ctx->state[offset], found_index, end - offset);
+  ptrits_wide_to_trits(&inst[found_thread].curl.state[offset], &ctx->state[offset], found_index, end - offset);
 
   free(inst);
   free(tid);
@@ -96,20 +105,22 @@ PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigne
 }
 
 void init_inst(SearchInstance *const inst, SearchStatus *const status, rw_lock_handle_t *const statusLock,
-               unsigned short const index, PCurl *const curl, unsigned short const offset, unsigned short const end,
-               unsigned short const param, short (*test)(PCurl *const, unsigned short const)) {
+               unsigned short const threads, unsigned short const index, PCurl *const curl, unsigned short const offset,
+               unsigned short const end, unsigned short const param,
+               short (*test)(PCurl *const, unsigned short const)) {
   if (index == 0) {
     return;
   }
   *inst = (SearchInstance){.index = index - 1,
+                           .threads = threads,
                            .offset = offset,
                            .end = end,
                            .param = param,
                            .status = status,
                            .statusLock = statusLock,
                            .test = test};
-  memcpy(&(inst->curl), curl, sizeof(PCurl));
-  init_inst(&inst[1], status, statusLock, index - 1, curl, offset, end, param, test);
+  memcpy(&(inst->init), curl, sizeof(PCurl));
+  init_inst(&inst[1], status, statusLock, threads, index - 1, curl, offset, end, param, test);
 }
 
 void pt_start(thread_handle_t *const tid, SearchInstance *const inst, unsigned short const index) {
@@ -122,36 +133,67 @@ void pt_start(thread_handle_t *const tid, SearchInstance *const inst, unsigned s
   pt_start(tid, inst, index - 1);
 }
 
+unsigned short pd_search_init_thread(PCurlWide *const curl, PCurl *const init, unsigned short const offset,
+                                     size_t const thread, size_t const threads) {
+  size_t i, w, streams, span;
+  unsigned short step = offset;
+
+  ptrit_wide_curl_init(curl, init->type, ptrit_wide_lanes());
+  for (i = 0; i < thread * curl->words; i++) {
+    ptrit_increment(init->state, offset, HASH_LENGTH_TRIT);
+  }
+  for (w = 0; w < curl->words; w++) {
+    ptrit_wide_curl_set_word(curl, w, init);
+    ptrit_increment(init->state, offset, HASH_LENGTH_TRIT);
+  }
+  // The starting points only differ in the trits below the step, so a step never lands on another word's nonces
+  streams = threads * curl->words;
+  for (span = 1; span < streams; span *= 3) {
+    step++;
+  }
+  return step;
+}
+
 void *run_search_thread(void *const data) {
-  unsigned short i;
-  PCurl copy;
+  PCurlWide *copy;
 
   SearchInstance *inst = ((SearchInstance *)data);
 
-  for (i = 0; i < inst->index; i++) {
-    ptrit_increment(inst->curl.state, inst->offset, HASH_LENGTH_TRIT);
-  }
+  inst->step = pd_search_init_thread(&inst->curl, &inst->init, inst->offset, inst->index, inst->threads);
 
-  intptr_t ret = do_pd_search(inst->test, inst, &copy);
+  if ((copy = (PCurlWide *)malloc(sizeof(PCurlWide))) == NULL) {
+    return (void *)(intptr_t)-1;
+  }
+  intptr_t ret = do_pd_search(inst->test, inst, copy);
+  free(copy);
   return (void *)ret;
 }
 
-short do_pd_search(short (*test)(PCurl *const, unsigned short const), SearchInstance *const inst, PCurl *const copy) {
+intptr_t do_pd_search(short (*test)(PCurl *const, unsigned short const), SearchInstance *const inst,
+                      PCurlWide *const copy) {
   short index;
+  size_t w;
 
   SearchStatus status = SEARCH_RUNNING;
   while (status == SEARCH_RUNNING) {
-    memcpy(copy, &inst->curl, sizeof(PCurl));
-    ptrit_transform(copy);
-    index = test(copy, inst->param);
-    if (index >= 0) {
-      rw_lock_handle_wrlock(inst->statusLock);
-      *inst->status = SEARCH_FINISHED;
-      rw_lock_handle_unlock(inst->statusLock);
-
-      return index;
+    memcpy(copy->state, inst->curl.state, sizeof(copy->state));
+    copy->type = inst->curl.type;
+    copy->width = inst->curl.width;
+    copy->words = inst->curl.words;
+    ptrit_wide_transform(copy);
+    for (w = 0; w < copy->words; w++) {
+      // the test functions check one 64-lane word at a time
+      ptrit_wide_curl_get_word(copy, w, &inst->init);
+      index = test(&inst->init, inst->param);
+      if (index >= 0) {
+        rw_lock_handle_wrlock(inst->statusLock);
+        *inst->status = SEARCH_FINISHED;
+        rw_lock_handle_unlock(inst->statusLock);
+
+        return w * 64 + index;
+      }
     }
-    ptrit_increment(inst->curl.state, inst->offset + 1, HASH_LENGTH_TRIT);
+    ptrit_wide_increment(inst->curl.state, inst->step, HASH_LENGTH_TRIT);
 
     rw_lock_handle_rdlock(inst->statusLock);
     status = *inst->status;
@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "common/crypto/curl-p/ptrit_wide.h"
+#include "utils/forced_inline.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define PTRIT_WIDE_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * CURL_INDEX[i + 1] == (CURL_INDEX[i] + 364) % STATE_LENGTH, the kernels walk the state with this recurrence instead
+ * of gathering through the index table
+ */
+#define NEXT_INDEX(p) ((p) < STATE_LENGTH - 364 ? (p) + 364 : (p) - (STATE_LENGTH - 364))
+
+typedef enum { KERNEL_PORTABLE = 1, KERNEL_AVX2 = 4, KERNEL_AVX512 = 8 } kernel_t;
+
+static kernel_t ptrit_wide_kernel(void) {
+#ifdef PTRIT_WIDE_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return KERNEL_AVX512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return KERNEL_AVX2;
+  }
+#endif
+  return KERNEL_PORTABLE;
+}
+
+static void ptrit_wide_sbox_portable(ptrit_wide_t *const c, ptrit_wide_t const *const s, size_t const words) {
+  ptrit_s alpha, beta, delta;
+  size_t i = 0, w, p = 0, q;
+
+  for (; i < STATE_LENGTH; ++i) {
+    q = NEXT_INDEX(p);
+    for (w = 0; w < words; ++w) {
+      alpha = s[p].low[w];
+      beta = s[p].high[w];
+      delta = alpha & (s[q].low[w] ^ beta);
+
+      c[i].low[w] = ~delta;
+      c[i].high[w] = (alpha ^ s[q].high[w]) | delta;
+    }
+    p = q;
+  }
+}
+
+#ifdef PTRIT_WIDE_X86
+
+__attribute__((target("avx2"))) static void ptrit_wide_sbox_avx2(ptrit_wide_t *const c, ptrit_wide_t const *const s,
+                                                                 size_t const words) {
+  __m256i const ones = _mm256_set1_epi64x(-1);
+  __m256i alpha, beta, delta;
+  size_t i = 0, w, p = 0, q;
+
+  for (; i < STATE_LENGTH; ++i) {
+    q = NEXT_INDEX(p);
+    for (w = 0; w < words; w += 4) {
+      alpha = _mm256_loadu_si256((__m256i const *)&s[p].low[w]);
+      beta = _mm256_loadu_si256((__m256i const *)&s[p].high[w]);
+      delta = _mm256_and_si256(alpha, _mm256_xor_si256(_mm256_loadu_si256((__m256i const *)&s[q].low[w]), beta));
+
+      _mm256_storeu_si256((__m256i *)&c[i].low[w], _mm256_xor_si256(delta, ones));
+      _mm256_storeu_si256(
+          (__m256i *)&c[i].high[w],
+          _mm256_or_si256(_mm256_xor_si256(alpha, _mm256_loadu_si256((__m256i const *)&s[q].high[w])), delta));
+    }
+    p = q;
+  }
+}
+
+__attribute__((target("avx512f"))) static void ptrit_wide_sbox_avx512(ptrit_wide_t *const c,
+                                                                      ptrit_wide_t const *const s) {
+  __m512i const ones = _mm512_set1_epi64(-1);
+  __m512i alpha, beta, delta;
+  size_t i = 0, p = 0, q;
+
+  for (; i < STATE_LENGTH; ++i) {
+    q = NEXT_INDEX(p);
+    alpha = _mm512_loadu_si512(s[p].low);
+    beta = _mm512_loadu_si512(s[p].high);
+    delta = _mm512_and_si512(alpha, _mm512_xor_si512(_mm512_loadu_si512(s[q].low), beta));
+
+    _mm512_storeu_si512(c[i].low, _mm512_xor_si512(delta, ones));
+    _mm512_storeu_si512(c[i].high, _mm512_or_si512(_mm512_xor_si512(alpha, _mm512_loadu_si512(s[q].high)), delta));
+    p = q;
+  }
+}
+
+#endif
+
+static FORCED_INLINE void ptrit_wide_sbox(PCurlWide const *const ctx, ptrit_wide_t *const c,
+                                          ptrit_wide_t const *const s) {
+#ifdef PTRIT_WIDE_X86
+  if (ctx->width == KERNEL_AVX512) {
+    ptrit_wide_sbox_avx512(c, s);
+    return;
+  }
+  if (ctx->width == KERNEL_AVX2) {
+    ptrit_wide_sbox_avx2(c, s, ctx->words);
+    return;
+  }
+#endif
+  ptrit_wide_sbox_portable(c, s, ctx->words);
+}
+
+size_t ptrit_wide_lanes(void) { return ptrit_wide_kernel() * 64; }
+
+void ptrit_wide_curl_init(PCurlWide *const ctx, CurlType type, size_t lanes) {
+  size_t width = ptrit_wide_kernel();
+  size_t words = (lanes + 63) / 64;
+
+  // The narrowest kernel holding the lanes, a wider one would transform words that carry nothing
+  if (words <= KERNEL_PORTABLE) {
+    width = KERNEL_PORTABLE;
+  } else if (words <= KERNEL_AVX2 && width == KERNEL_AVX512) {
+    width = KERNEL_AVX2;
+  }
+  words = ((words + width - 1) / width) * width;
+  ctx->width = width;
+  ctx->words = words == 0 ? width : (words > PTRIT_WIDE_WORDS ? PTRIT_WIDE_WORDS : words);
+  ptrit_wide_curl_reset(ctx);
+  ctx->type = type;
+}
+
+void ptrit_wide_curl_absorb(PCurlWide *const ctx, ptrit_wide_t const *const trits, size_t length) {
+  size_t num_chunks = length / HASH_LENGTH_TRIT + ((length % HASH_LENGTH_TRIT) ? 1 : 0);
+  size_t i = 0;
+
+  for (; i < num_chunks; ++i) {
+    memcpy(ctx->state, trits + i * HASH_LENGTH_TRIT,
+           (length < HASH_LENGTH_TRIT ? length : HASH_LENGTH_TRIT) * sizeof(ptrit_wide_t));
+    ptrit_wide_transform(ctx);
+    length = length < HASH_LENGTH_TRIT ? 0 : length - HASH_LENGTH_TRIT;
+  }
+}
+
+void ptrit_wide_curl_squeeze(PCurlWide *const ctx, ptrit_wide_t *const trits, size_t length) {
+  size_t num_chunks = length / HASH_LENGTH_TRIT + ((length % HASH_LENGTH_TRIT) ? 1 : 0);
+  size_t i = 0;
+
+  for (; i < num_chunks; ++i) {
+    memcpy(trits + i * HASH_LENGTH_TRIT, ctx->state,
+           (length < HASH_LENGTH_TRIT ? length : HASH_LENGTH_TRIT) * sizeof(ptrit_wide_t));
+    ptrit_wide_transform(ctx);
+    length = length < HASH_LENGTH_TRIT ? 0 : length - HASH_LENGTH_TRIT;
+  }
+}
+
+void ptrit_wide_transform(PCurlWide *const ctx) {
+  size_t round = 0;
+  ptrit_wide_t *lhs, *rhs;
+
+  for (; round < ctx->type; ++round) {
+    if (round & 1) {
+      lhs = ctx->state;
+      rhs = ctx->scratch;
+    } else {
+      lhs = ctx->scratch;
+      rhs = ctx->state;
+    }
+    ptrit_wide_sbox(ctx, lhs, rhs);
+  }
+
+  if (round & 1) memcpy(ctx->state, ctx->scratch, sizeof(ctx->state));
+}
+
+void ptrit_wide_curl_reset(PCurlWide *const ctx) { memset(ctx->state, 0xFF, sizeof(ctx->state)); }
+
+void ptrit_wide_curl_set_word(PCurlWide *const ctx, size_t word, PCurl const *const curl) {
+  size_t i = 0;
+
+  for (; i < STATE_LENGTH; ++i) {
+    ctx->state[i].low[word] = curl->state[i].low;
+    ctx->state[i].high[word] = curl->state[i].high;
+  }
+}
+
+void ptrit_wide_curl_get_word(PCurlWide const *const ctx, size_t word, PCurl *const curl) {
+  size_t i = 0;
+
+  for (; i < STATE_LENGTH; ++i) {
+    curl->state[i].low = ctx->state[i].low[word];
+    curl->state[i].high = ctx->state[i].high[word];
+  }
+  curl->type = ctx->type;
+}
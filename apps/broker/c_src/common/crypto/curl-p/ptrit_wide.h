@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_CURL_P_PTRIT_WIDE_H_
+#define __COMMON_CURL_P_PTRIT_WIDE_H_
+
+#include "common/crypto/curl-p/const.h"
+#include "common/crypto/curl-p/ptrit.h"
+#include "common/trinary/ptrit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Curl-P over up to PTRIT_WIDE_LANES lanes.
+ * The transform is computed with AVX-512 or AVX2 when the CPU supports it (detected at runtime) and with portable
+ * 64-bit operations otherwise. Only the first `words` 64-lane words of the state are transformed.
+ */
+typedef struct {
+  ptrit_wide_t state[STATE_LENGTH];
+  ptrit_wide_t scratch[STATE_LENGTH];
+  CurlType type;
+  size_t width;  // words transformed at once by the selected kernel
+  size_t words;  // words in use, a multiple of width
+} PCurlWide;
+
+/**
+ * Number of lanes transformed at once by the fastest kernel available on this CPU (512, 256 or 64)
+ */
+size_t ptrit_wide_lanes(void);
+
+/**
+ * Initializes a context for at least `lanes` lanes on the narrowest available kernel holding them, rounded up to the
+ * width of that kernel
+ */
+void ptrit_wide_curl_init(PCurlWide* const ctx, CurlType type, size_t lanes);
+void ptrit_wide_curl_absorb(PCurlWide* const ctx, ptrit_wide_t const* const trits, size_t length);
+void ptrit_wide_curl_squeeze(PCurlWide* const ctx, ptrit_wide_t* const trits, size_t length);
+void ptrit_wide_transform(PCurlWide* const ctx);
+void ptrit_wide_curl_reset(PCurlWide* const ctx);
+
+/**
+ * Copies the 64 lanes of a regular ptrit context from/to the word `word` of a wide context
+ */
+void ptrit_wide_curl_set_word(PCurlWide* const ctx, size_t word, PCurl const* const curl);
+void ptrit_wide_curl_get_word(PCurlWide const* const ctx, size_t word, PCurl* const curl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_CURL_P_PTRIT_WIDE_H_
@@ -10,6 +10,7 @@
 
 #include "common/crypto/curl-p/pearl_diver.h"
 #include "common/crypto/curl-p/ptrit.h"
+#include "common/crypto/curl-p/ptrit_wide.h"
 #include "common/crypto/curl-p/trit.h"
 
 #ifdef __cplusplus
@@ -19,6 +20,14 @@ extern "C" {
 PearlDiverStatus pd_search(Curl *const ctx, unsigned short const offset, unsigned short const end,
                            short (*test)(PCurl *const, unsigned short const), unsigned short const param);
 
+/**
+ * Sets the starting points of the words of search thread `thread` out of `threads`, `init` holding the initial state.
+ * Word `w` starts `thread * curl->words + w` increments at `offset` away from it, the returned offset is the lowest
+ * trit above all of these starting points and is the one each search must be stepped at
+ */
+unsigned short pd_search_init_thread(PCurlWide *const curl, PCurl *const init, unsigned short const offset,
+                                     size_t const thread, size_t const threads);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/crypto/curl-p/ptrit.h"
+#include "common/crypto/curl-p/ptrit_wide.h"
+#include "common/trinary/trit_ptrit.h"
+
+#define MESSAGE_LENGTH (2 * HASH_LENGTH_TRIT)
+
+static ptrit_wide_t wide_in[MESSAGE_LENGTH];
+static ptrit_wide_t wide_hash[HASH_LENGTH_TRIT];
+static trit_t exp_hashes[PTRIT_WIDE_LANES][HASH_LENGTH_TRIT];
+static PCurlWide wide_curl;
+
+static void random_trits(trit_t *const trits, size_t const length) {
+  for (size_t i = 0; i < length; i++) {
+    trits[i] = (rand() % 3) - 1;
+  }
+}
+
+static void run_curl_p_wide_test(CurlType curl_type, size_t const lanes) {
+  trit_t trits[MESSAGE_LENGTH];
+  trit_t hash[HASH_LENGTH_TRIT];
+  ptrit_t in[MESSAGE_LENGTH];
+  ptrit_t out[HASH_LENGTH_TRIT];
+  PCurl curl;
+
+  ptrit_wide_curl_init(&wide_curl, curl_type, lanes);
+  TEST_ASSERT_TRUE(wide_curl.words * 64 >= lanes);
+  TEST_ASSERT_TRUE(wide_curl.words <= PTRIT_WIDE_WORDS);
+
+  // expected hashes are computed 64 lanes at a time with the regular ptrit curl
+  memset(wide_in, 0, sizeof(wide_in));
+  for (size_t word = 0; word < wide_curl.words; word++) {
+    memset(in, 0, sizeof(in));
+    for (size_t lane = 0; lane < 64; lane++) {
+      random_trits(trits, MESSAGE_LENGTH);
+      trits_to_ptrits(trits, in, lane, MESSAGE_LENGTH);
+      trits_to_ptrits_wide(trits, wide_in, word * 64 + lane, MESSAGE_LENGTH);
+    }
+    ptrit_curl_init(&curl, curl_type);
+    ptrit_curl_absorb(&curl, in, MESSAGE_LENGTH);
+    ptrit_curl_squeeze(&curl, out, HASH_LENGTH_TRIT);
+    for (size_t lane = 0; lane < 64; lane++) {
+      ptrits_to_trits(out, exp_hashes[word * 64 + lane], lane, HASH_LENGTH_TRIT);
+    }
+  }
+
+  ptrit_wide_curl_absorb(&wide_curl, wide_in, MESSAGE_LENGTH);
+  ptrit_wide_curl_squeeze(&wide_curl, wide_hash, HASH_LENGTH_TRIT);
+  for (size_t lane = 0; lane < wide_curl.words * 64; lane++) {
+    ptrits_wide_to_trits(wide_hash, hash, lane, HASH_LENGTH_TRIT);
+    TEST_ASSERT_EQUAL_MEMORY(exp_hashes[lane], hash, sizeof(hash));
+  }
+}
+
+void test_curl_p_27_wide(void) {
+  run_curl_p_wide_test(CURL_P_27, 64);
+  run_curl_p_wide_test(CURL_P_27, PTRIT_WIDE_LANES);
+}
+
+void test_curl_p_81_wide(void) {
+  run_curl_p_wide_test(CURL_P_81, 1);
+  run_curl_p_wide_test(CURL_P_81, 200);
+  run_curl_p_wide_test(CURL_P_81, ptrit_wide_lanes());
+  run_curl_p_wide_test(CURL_P_81, PTRIT_WIDE_LANES);
+}
+
+void test_curl_p_wide_words(void) {
+  PCurl curl, word_curl;
+  trit_t trits[STATE_LENGTH];
+
+  ptrit_curl_init(&curl, CURL_P_81);
+  for (size_t lane = 0; lane < 64; lane++) {
+    random_trits(trits, STATE_LENGTH);
+    trits_to_ptrits(trits, curl.state, lane, STATE_LENGTH);
+  }
+
+  ptrit_wide_curl_init(&wide_curl, CURL_P_81, PTRIT_WIDE_LANES);
+  for (size_t word = 0; word < wide_curl.words; word++) {
+    ptrit_wide_curl_set_word(&wide_curl, word, &curl);
+  }
+  ptrit_wide_transform(&wide_curl);
+  ptrit_transform(&curl);
+  for (size_t word = 0; word < wide_curl.words; word++) {
+    ptrit_wide_curl_get_word(&wide_curl, word, &word_curl);
+    TEST_ASSERT_EQUAL_MEMORY(curl.state, word_curl.state, sizeof(curl.state));
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_curl_p_27_wide);
+  RUN_TEST(test_curl_p_81_wide);
+  RUN_TEST(test_curl_p_wide_words);
+
+  return UNITY_END();
+}
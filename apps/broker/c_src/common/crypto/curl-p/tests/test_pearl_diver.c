@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/crypto/curl-p/search.h"
+#include "common/trinary/ptrit_incr.h"
+#include "common/trinary/trit_ptrit.h"
+
+#define OFFSET 4
+#define THREADS 3
+#define STEPS 12
+#define NONCE_LENGTH 27
+
+static PCurlWide curls[THREADS];
+static trit_t nonces[THREADS * PTRIT_WIDE_WORDS * STEPS][NONCE_LENGTH];
+
+void test_search_words_never_overlap(void) {
+  PCurl init, word;
+  unsigned short step = 0;
+  size_t t, s, w, i, j, count = 0;
+
+  for (t = 0; t < THREADS; t++) {
+    ptrit_curl_init(&init, CURL_P_81);
+    ptrit_offset(init.state, 4);
+    step = pd_search_init_thread(&curls[t], &init, OFFSET, t, THREADS);
+    TEST_ASSERT_TRUE(step > OFFSET);
+  }
+
+  for (s = 0; s < STEPS; s++) {
+    for (t = 0; t < THREADS; t++) {
+      for (w = 0; w < curls[t].words; w++) {
+        ptrit_wide_curl_get_word(&curls[t], w, &word);
+        // Lane 0 stands for every lane, all words share the lane offsets set by ptrit_offset
+        ptrits_to_trits(&word.state[OFFSET], nonces[count++], 0, NONCE_LENGTH);
+      }
+      ptrit_wide_increment(curls[t].state, step, HASH_LENGTH_TRIT);
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    for (j = i + 1; j < count; j++) {
+      TEST_ASSERT_TRUE(memcmp(nonces[i], nonces[j], NONCE_LENGTH) != 0);
+    }
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_search_words_never_overlap);
+
+  return UNITY_END();
+}
@@ -7,11 +7,14 @@
 
 #include "common/crypto/iss/v1/iss_kerl.h"
 #include "common/crypto/kerl/kerl.h"
+#include "common/crypto/kerl/kerl_lanes.h"
 
 #define HASH_PREFIX kerl
 #define HASH_STATE Kerl
+#define HASH_CHAINS kerl_hash_chains
 
 #include "iss.c.inc"
 
 #undef HASH_PREFIX
 #undef HASH_STATE
+#undef HASH_CHAINS
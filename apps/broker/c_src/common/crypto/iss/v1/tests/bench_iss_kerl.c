@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Compares the signature fragment digest of iss_kerl, which runs the hash chains side by side, with the same digest
+ * computed by one kerl absorb/squeeze/reset at a time.
+ *
+ * Usage: bench_iss_kerl [fragments]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/crypto/iss/v1/iss_kerl.h"
+#include "common/crypto/kerl/kerl.h"
+#include "common/defs.h"
+
+#define DEFAULT_FRAGMENTS 200
+
+static void sig_digest_scalar(trit_t *const dig, trit_t const *const hash, trit_t *const sig, Kerl *const kerl) {
+  for (size_t i = 0; i < ISS_FRAGMENTS; i++) {
+    trit_t const *const t = &hash[i * TRYTE_WIDTH];
+    int const rounds = t[0] + t[1] * 3 + t[2] * 9 - TRYTE_VALUE_MIN;
+
+    for (int j = 0; j < rounds; j++) {
+      kerl_absorb(kerl, &sig[i * HASH_LENGTH_TRIT], HASH_LENGTH_TRIT);
+      kerl_squeeze(kerl, &sig[i * HASH_LENGTH_TRIT], HASH_LENGTH_TRIT);
+      kerl_reset(kerl);
+    }
+  }
+  kerl_absorb(kerl, sig, ISS_KEY_LENGTH);
+  kerl_squeeze(kerl, dig, HASH_LENGTH_TRIT);
+  kerl_reset(kerl);
+}
+
+static double elapsed_us(struct timespec const *const start) {
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) * 1e6 + (end.tv_nsec - start->tv_nsec) / 1e3;
+}
+
+int main(int argc, char **argv) {
+  size_t const fragments = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_FRAGMENTS;
+  trit_t *sigs = NULL, *copies = NULL;
+  trit_t hash[HASH_LENGTH_TRIT], scalar[HASH_LENGTH_TRIT], lanes[HASH_LENGTH_TRIT];
+  double scalar_us = 0, lanes_us = 0;
+  struct timespec start;
+  Kerl kerl;
+
+  if (fragments == 0 || (sigs = (trit_t *)malloc(fragments * ISS_KEY_LENGTH)) == NULL ||
+      (copies = (trit_t *)malloc(fragments * ISS_KEY_LENGTH)) == NULL) {
+    free(sigs);
+    return EXIT_FAILURE;
+  }
+
+  srand(42);
+  for (size_t i = 0; i < fragments * ISS_KEY_LENGTH; i++) {
+    sigs[i] = rand() % 3 - 1;
+  }
+  for (size_t i = 0; i < HASH_LENGTH_TRIT; i++) {
+    hash[i] = rand() % 3 - 1;
+  }
+  kerl_init(&kerl);
+
+  for (size_t i = 0; i < fragments; i++) {
+    trit_t *const sig = &copies[i * ISS_KEY_LENGTH];
+
+    memcpy(sig, &sigs[i * ISS_KEY_LENGTH], ISS_KEY_LENGTH);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    sig_digest_scalar(scalar, hash, sig, &kerl);
+    scalar_us += elapsed_us(&start);
+
+    memcpy(sig, &sigs[i * ISS_KEY_LENGTH], ISS_KEY_LENGTH);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    iss_kerl_sig_digest(lanes, hash, sig, ISS_KEY_LENGTH, &kerl);
+    lanes_us += elapsed_us(&start);
+
+    if (memcmp(scalar, lanes, HASH_LENGTH_TRIT) != 0) {
+      fprintf(stderr, "Digest mismatch on fragment %zu\n", i);
+      free(sigs);
+      free(copies);
+      return EXIT_FAILURE;
+    }
+  }
+
+  printf("fragments: %zu\n", fragments);
+  printf("scalar kerl: %.1f us/fragment\n", scalar_us / fragments);
+  printf("kerl lanes:  %.1f us/fragment (x%.2f)\n", lanes_us / fragments, scalar_us / lanes_us);
+
+  free(sigs);
+  free(copies);
+
+  return EXIT_SUCCESS;
+}
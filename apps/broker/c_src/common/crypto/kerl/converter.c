@@ -16,12 +16,21 @@
 #define BYTE_LEN 48
 #define BYTE_LEN_2 24
 #define TRIT_LEN 243
+// The trits are converted TRITS_PER_WORD at a time, in radix RADIX_WORD
+#define TRITS_PER_WORD 20
+#define RADIX_WORD 3486784401uLL
 
 static const uint32_t HALF_3[] = {
     0xa5ce8964, 0x9f007669, 0x1484504f, 0x3ade00d9, 0x0c24486e, 0x50979d57,
     0x79a4c702, 0x48bbae36, 0xa9f6808b, 0xaa06a805, 0xa87fabdf, 0x5e69ebef,
 };
 
+// 3^242 = 2 * HALF_3 + 1
+static const uint32_t FULL_3[] = {
+    0x4b9d12c9, 0x3e00ecd3, 0x2908a09f, 0x75bc01b2, 0x184890dc, 0xa12f3aae,
+    0xf3498e04, 0x91775c6c, 0x53ed0116, 0x540d500b, 0x50ff57bf, 0xbcd3d7df,
+};
+
 uint8_t is_null(uint32_t const *const base) {
   size_t i = 0;
   for (; i < INT_LEN; i++) {
@@ -45,14 +54,14 @@ void space_reverse(uint8_t *const bytes) {
 }
 
 void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes) {
-  size_t i = 0, j = 0;
-  size_t sz = 1, size = 1;
+  size_t i = 0, j = 0, k = 0;
+  size_t size = 0;
   uint8_t all_minus_1 = 1;
-  uint32_t carry;
+  uint32_t carry, radix;
   uint32_t *base = (uint32_t *)bytes;
   uint64_t v;
 
-  memset(base, 0, INT_LEN);
+  memset(base, 0, INT_LEN * sizeof(uint32_t));
 
   for (i = 0; i < TRIT_LEN - 1; i++) {
     if (trits[i] != -1) {
@@ -66,31 +75,25 @@ void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes) {
     bigint_not(base, INT_LEN);
     bigint_add_small(base, 1);
   } else {
-    for (i = (TRIT_LEN - 1); i-- > 0;) {
-      // multiply by radix
-      {
-        sz = size;
-        carry = 0;
-
-        for (j = 0; j < sz; j++) {
-          v = ((uint64_t)base[j]) * ((uint64_t)RADIX) + ((uint64_t)carry);
-          carry = (v >> 32uLL);
-          base[j] = (uint32_t)(v & 0xFFFFFFFFuLL);
-        }
-
-        if (carry) {
-          base[sz] = carry;
-          size++;
-        }
+    // Horner's scheme from the most significant trit, a word of trits at a time
+    for (i = TRIT_LEN - 1; i > 0; i = k) {
+      k = (i % TRITS_PER_WORD) ? i - i % TRITS_PER_WORD : i - TRITS_PER_WORD;
+      carry = 0;
+      radix = 1;
+      for (j = i; j-- > k;) {
+        carry = carry * RADIX + (uint32_t)(trits[j] + 1);
+        radix *= RADIX;
       }
 
-      // addition
-      {
-        sz = bigint_add_small(base, trits[i] + 1);
+      // base = base * radix + carry
+      for (j = 0; j < size; j++) {
+        v = ((uint64_t)base[j]) * ((uint64_t)radix) + ((uint64_t)carry);
+        carry = (v >> 32uLL);
+        base[j] = (uint32_t)(v & 0xFFFFFFFFuLL);
+      }
 
-        if (sz > size) {
-          size = sz;
-        }
+      if (carry) {
+        base[size++] = carry;
       }
     }
 
@@ -114,19 +117,13 @@ void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes) {
   space_reverse(bytes);
 }
 
-void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
-  size_t i = 0, j = 0;
-  uint8_t flip_trits = 0;
-  uint64_t lhs, rem;
-  uint64_t rhs = RADIX;
+/*
+ * Moves the signed integer in `bytes` into unsigned space as convert_bytes_to_trits does, returns whether the trits
+ * have to be flipped
+ */
+static uint8_t bytes_to_unsigned(uint8_t *const bytes) {
   uint32_t *base = (uint32_t *)bytes;
 
-  if (is_null(base)) {
-    memset_safe(trits, TRIT_LEN, 0, TRIT_LEN);
-    return;
-  }
-
-  trits[TRIT_LEN - 1] = 0;
   space_reverse(bytes);
 
   if (!(base[INT_LEN - 1] >> 31)) {
@@ -138,7 +135,7 @@ void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
     bigint_not(base, INT_LEN);
     if (bigint_cmp(base, HALF_3, INT_LEN) > 0) {
       bigint_sub(base, HALF_3, INT_LEN);
-      flip_trits = 1;
+      return 1;
     } else {
       bigint_add_small(base, 1);
       uint32_t tmp[INT_LEN] = {0};
@@ -148,14 +145,35 @@ void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
     }
   }
 
-  for (; i < TRIT_LEN - 1; i++) {
+  return 0;
+}
+
+void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
+  size_t i = 0, j = 0, k = 0;
+  uint8_t flip_trits = 0;
+  uint64_t lhs, rem;
+  uint32_t *base = (uint32_t *)bytes;
+
+  if (is_null(base)) {
+    memset_safe(trits, TRIT_LEN, 0, TRIT_LEN);
+    return;
+  }
+
+  trits[TRIT_LEN - 1] = 0;
+  flip_trits = bytes_to_unsigned(bytes);
+
+  // Only the TRIT_LEN - 1 least significant trits are kept, a word of trits at a time
+  for (; i < TRIT_LEN - 1; i = k) {
+    k = (i + TRITS_PER_WORD < TRIT_LEN - 1) ? i + TRITS_PER_WORD : TRIT_LEN - 1;
     rem = 0;
     for (j = INT_LEN; j-- > 0;) {
       lhs = (rem << 32) | base[j];
-      base[j] = (uint32_t)(lhs / rhs);
-      rem = (uint32_t)(lhs % rhs);
+      base[j] = (uint32_t)(lhs / RADIX_WORD);
+      rem = lhs % RADIX_WORD;
+    }
+    for (j = i; j < k; j++, rem /= RADIX) {
+      trits[j] = ((uint8_t)(rem % RADIX)) - 1;
     }
-    trits[i] = ((uint8_t)rem) - 1;
   }
 
   if (flip_trits) {
@@ -165,7 +183,45 @@ void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits) {
   }
 }
 
+// base = lh - rh in two's complement
+static void signed_sub(uint32_t *const base, uint32_t const *const lh, uint32_t const *const rh) {
+  if (bigint_cmp(lh, rh, INT_LEN) >= 0) {
+    memcpy(base, lh, INT_LEN * sizeof(uint32_t));
+    bigint_sub(base, rh, INT_LEN);
+  } else {
+    memcpy(base, rh, INT_LEN * sizeof(uint32_t));
+    bigint_sub(base, lh, INT_LEN);
+    bigint_not(base, INT_LEN);
+    bigint_add_small(base, 1);
+  }
+}
+
+void convert_bytes_reduce(uint8_t *const bytes) {
+  uint8_t flip_trits = 0;
+  uint32_t *base = (uint32_t *)bytes;
+  uint32_t tmp[INT_LEN];
+
+  flip_trits = bytes_to_unsigned(bytes);
+
+  // Keeps the TRIT_LEN - 1 least significant trits, base < 2 * FULL_3
+  if (bigint_cmp(base, FULL_3, INT_LEN) >= 0) {
+    bigint_sub(base, FULL_3, INT_LEN);
+  }
+
+  // Back to signed space, flipping the trits negates the integer
+  memcpy(tmp, base, INT_LEN * sizeof(uint32_t));
+  if (flip_trits) {
+    signed_sub(base, HALF_3, tmp);
+  } else {
+    signed_sub(base, tmp, HALF_3);
+  }
+
+  space_reverse(bytes);
+}
+
 #undef INT_LEN
 #undef BYTE_LEN
 #undef TRIT_LEN
+#undef TRITS_PER_WORD
+#undef RADIX_WORD
 #undef RADIX
@@ -21,6 +21,9 @@ void convert_trits_to_bytes(trit_t const *const trits, uint8_t *const bytes);
 // This method consumes the input bytes.
 void convert_bytes_to_trits(uint8_t *const bytes, trit_t *const trits);
 
+// Same as convert_bytes_to_trits followed by convert_trits_to_bytes, without going through trits.
+void convert_bytes_reduce(uint8_t *const bytes);
+
 #ifdef __cplusplus
 }
 #endif
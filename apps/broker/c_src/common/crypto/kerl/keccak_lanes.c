@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "common/crypto/kerl/keccak_lanes.h"
+#include "utils/forced_inline.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define KECCAK_LANES_VECTOR
+#if defined(__x86_64__) || defined(__i386__)
+#define KECCAK_LANES_X86
+#endif
+#endif
+
+#define ROUNDS 24
+#define ROL(a, n) (((a) << (n)) | ((a) >> (64 - (n))))
+
+static uint64_t const ROUND_CONSTANTS[ROUNDS] = {
+    0x0000000000000001uLL, 0x0000000000008082uLL, 0x800000000000808auLL, 0x8000000080008000uLL,
+    0x000000000000808buLL, 0x0000000080000001uLL, 0x8000000080008081uLL, 0x8000000000008009uLL,
+    0x000000000000008auLL, 0x0000000000000088uLL, 0x0000000080008009uLL, 0x000000008000000auLL,
+    0x000000008000808buLL, 0x800000000000008buLL, 0x8000000000008089uLL, 0x8000000000008003uLL,
+    0x8000000000008002uLL, 0x8000000000000080uLL, 0x000000000000800auLL, 0x800000008000000auLL,
+    0x8000000080008081uLL, 0x8000000000008080uLL, 0x0000000080000001uLL, 0x8000000080008008uLL,
+};
+
+// Rotation offsets of the rho step, by word index x + 5 * y
+static unsigned const RHO[KECCAK_STATE_WORDS] = {0,  1,  62, 28, 27, 36, 44, 6,  55, 20, 3,  10, 43,
+                                                 25, 39, 41, 45, 15, 21, 8,  18, 2,  61, 56, 14};
+
+// Destination of each word in the pi step, (x, y) -> (y, 2 * x + 3 * y)
+static unsigned const PI[KECCAK_STATE_WORDS] = {0,  10, 20, 5,  15, 16, 1,  11, 21, 6,  7,  17, 2,
+                                                12, 22, 23, 8,  18, 3,  13, 14, 24, 9,  19, 4};
+
+/*
+ * The rounds are written once over a word type `T`, a scalar uint64_t or a vector holding a word of every lane
+ */
+#define KECCAK_F1600(T, a)                                                                 \
+  do {                                                                                     \
+    T c[5], d[5], b[KECCAK_STATE_WORDS];                                                   \
+    size_t r, x, y;                                                                        \
+                                                                                           \
+    for (r = 0; r < ROUNDS; ++r) {                                                         \
+      /* theta */                                                                          \
+      for (x = 0; x < 5; ++x) {                                                            \
+        c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];                        \
+      }                                                                                    \
+      for (x = 0; x < 5; ++x) {                                                            \
+        d[x] = c[(x + 4) % 5] ^ ROL(c[(x + 1) % 5], 1);                                    \
+      }                                                                                    \
+      /* rho and pi */                                                                     \
+      b[0] = a[0] ^ d[0];                                                                  \
+      for (x = 1; x < KECCAK_STATE_WORDS; ++x) {                                           \
+        b[PI[x]] = ROL(a[x] ^ d[x % 5], RHO[x]);                                           \
+      }                                                                                    \
+      /* chi */                                                                            \
+      for (y = 0; y < KECCAK_STATE_WORDS; y += 5) {                                        \
+        for (x = 0; x < 5; ++x) {                                                          \
+          a[y + x] = b[y + x] ^ (~b[y + (x + 1) % 5] & b[y + (x + 2) % 5]);                \
+        }                                                                                  \
+      }                                                                                    \
+      /* iota */                                                                           \
+      a[0] ^= ROUND_CONSTANTS[r];                                                          \
+    }                                                                                      \
+  } while (0)
+
+#ifdef KECCAK_LANES_VECTOR
+
+typedef uint64_t keccak_word_t __attribute__((vector_size(KECCAK_LANES * sizeof(uint64_t))));
+
+static FORCED_INLINE void keccak_lanes_permute_vector(keccak_lanes_t *const state) {
+  keccak_word_t a[KECCAK_STATE_WORDS];
+
+  memcpy(a, state->words, sizeof(a));
+  KECCAK_F1600(keccak_word_t, a);
+  memcpy(state->words, a, sizeof(a));
+}
+
+static void keccak_lanes_permute_generic(keccak_lanes_t *const state) { keccak_lanes_permute_vector(state); }
+
+#ifdef KECCAK_LANES_X86
+
+__attribute__((target("avx2"))) static void keccak_lanes_permute_avx2(keccak_lanes_t *const state) {
+  keccak_lanes_permute_vector(state);
+}
+
+__attribute__((target("avx512f"))) static void keccak_lanes_permute_avx512(keccak_lanes_t *const state) {
+  keccak_lanes_permute_vector(state);
+}
+
+#endif  // KECCAK_LANES_X86
+
+#else
+
+static void keccak_lanes_permute_generic(keccak_lanes_t *const state) {
+  uint64_t a[KECCAK_STATE_WORDS];
+
+  for (size_t lane = 0; lane < KECCAK_LANES; ++lane) {
+    for (size_t i = 0; i < KECCAK_STATE_WORDS; ++i) {
+      a[i] = state->words[i][lane];
+    }
+    KECCAK_F1600(uint64_t, a);
+    for (size_t i = 0; i < KECCAK_STATE_WORDS; ++i) {
+      state->words[i][lane] = a[i];
+    }
+  }
+}
+
+#endif  // KECCAK_LANES_VECTOR
+
+typedef void (*keccak_lanes_kernel_t)(keccak_lanes_t *const state);
+
+static keccak_lanes_kernel_t keccak_lanes_kernel(void) {
+#ifdef KECCAK_LANES_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return keccak_lanes_permute_avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return keccak_lanes_permute_avx2;
+  }
+#endif
+  return keccak_lanes_permute_generic;
+}
+
+void keccak_lanes_permute(keccak_lanes_t *const state) {
+  static keccak_lanes_kernel_t kernel = NULL;
+
+  if (kernel == NULL) {
+    kernel = keccak_lanes_kernel();
+  }
+  kernel(state);
+}
+
+#undef KECCAK_F1600
+#undef ROL
+#undef ROUNDS
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_CRYPTO_KERL_KECCAK_LANES_H__
+#define __COMMON_CRYPTO_KERL_KECCAK_LANES_H__
+
+#include "common/stdint.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KECCAK_LANES 8
+#define KECCAK_STATE_WORDS 25
+
+/**
+ * KECCAK_LANES independent Keccak-f[1600] states, interleaved word by word.
+ * The permutation is computed with AVX-512 or AVX2 when the CPU supports it (detected at runtime) and with the
+ * portable vector extensions of the compiler otherwise.
+ */
+typedef struct {
+  uint64_t words[KECCAK_STATE_WORDS][KECCAK_LANES];
+} keccak_lanes_t;
+
+/**
+ * Applies Keccak-f[1600] to every lane of the state
+ */
+void keccak_lanes_permute(keccak_lanes_t* const state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_CRYPTO_KERL_KECCAK_LANES_H__
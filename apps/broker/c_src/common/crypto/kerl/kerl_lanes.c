@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "common/crypto/kerl/converter.h"
+#include "common/crypto/kerl/keccak_lanes.h"
+#include "common/crypto/kerl/kerl_lanes.h"
+
+#define HASH_BYTE_LEN 48
+#define HASH_WORD_LEN (HASH_BYTE_LEN / 8)
+// Keccak-384 padding of a single 48 bytes block: suffix 0x01 at byte 48 and final bit at byte 103 of the rate
+#define PAD_FIRST_WORD 6
+#define PAD_FIRST 0x01uLL
+#define PAD_LAST_WORD 12
+#define PAD_LAST 0x8000000000000000uLL
+
+void kerl_hash_chains(trit_t *const *const chunks, size_t const *const rounds, size_t const count) {
+  keccak_lanes_t state;
+  uint8_t bytes[KECCAK_LANES][HASH_BYTE_LEN];
+  size_t chunk[KECCAK_LANES];
+  size_t left[KECCAK_LANES] = {0};
+  size_t next = 0, active = 0, lane, i, b;
+  uint64_t word;
+
+  while (true) {
+    // Idle lanes pick up the next chunks, the hash chain is followed in the byte domain
+    for (lane = 0; lane < KECCAK_LANES; lane++) {
+      if (left[lane] > 0) {
+        continue;
+      }
+      for (; next < count && rounds[next] == 0; next++)
+        ;
+      if (next < count) {
+        chunk[lane] = next;
+        left[lane] = rounds[next];
+        convert_trits_to_bytes(chunks[next], bytes[lane]);
+        next++;
+        active++;
+      }
+    }
+
+    if (active == 0) {
+      break;
+    }
+
+    memset(&state, 0, sizeof(keccak_lanes_t));
+    for (lane = 0; lane < KECCAK_LANES; lane++) {
+      if (left[lane] == 0) {
+        continue;
+      }
+      for (i = 0; i < HASH_WORD_LEN; i++) {
+        for (word = 0, b = 0; b < 8; b++) {
+          word |= (uint64_t)bytes[lane][i * 8 + b] << (b * 8);
+        }
+        state.words[i][lane] = word;
+      }
+      state.words[PAD_FIRST_WORD][lane] = PAD_FIRST;
+      state.words[PAD_LAST_WORD][lane] = PAD_LAST;
+    }
+
+    keccak_lanes_permute(&state);
+
+    for (lane = 0; lane < KECCAK_LANES; lane++) {
+      if (left[lane] == 0) {
+        continue;
+      }
+      for (i = 0; i < HASH_WORD_LEN; i++) {
+        for (word = state.words[i][lane], b = 0; b < 8; b++) {
+          bytes[lane][i * 8 + b] = (uint8_t)(word >> (b * 8));
+        }
+      }
+      if (--left[lane] > 0) {
+        convert_bytes_reduce(bytes[lane]);
+      } else {
+        convert_bytes_to_trits(bytes[lane], chunks[chunk[lane]]);
+        active--;
+      }
+    }
+  }
+}
+
+#undef PAD_LAST
+#undef PAD_LAST_WORD
+#undef PAD_FIRST
+#undef PAD_FIRST_WORD
+#undef HASH_WORD_LEN
+#undef HASH_BYTE_LEN
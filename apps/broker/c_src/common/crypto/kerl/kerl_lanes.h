@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_CRYPTO_KERL_KERL_LANES_H__
+#define __COMMON_CRYPTO_KERL_KERL_LANES_H__
+
+#include <stddef.h>
+
+#include "common/trinary/trits.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Hashes each of `count` chunks of HASH_LENGTH_TRIT trits `rounds[i]` times in place, each round being a kerl
+ * absorb/squeeze/reset of the chunk. Up to KECCAK_LANES chunks are hashed side by side.
+ *
+ * @param chunks The chunks
+ * @param rounds The number of rounds of each chunk
+ * @param count The number of chunks
+ */
+void kerl_hash_chains(trit_t *const *const chunks, size_t const *const rounds, size_t const count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_CRYPTO_KERL_KERL_LANES_H__
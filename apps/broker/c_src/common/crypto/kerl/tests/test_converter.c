@@ -6,6 +6,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unity/unity.h>
 
@@ -121,12 +122,34 @@ void test_bytes_trits(void) {
      "99999999");
 }
 
+void test_bytes_reduce(void) {
+  uint8_t bytes[HASH_LENGTH_BYTE], reduced[HASH_LENGTH_BYTE], expected[HASH_LENGTH_BYTE];
+  trit_t trits[HASH_LENGTH_TRIT];
+  uint8_t const fills[] = {0, 1, 32, 127, 128, 220, 254, 255};
+
+  for (size_t i = 0; i < 1000 + sizeof(fills); i++) {
+    if (i < sizeof(fills)) {
+      memset(bytes, fills[i], HASH_LENGTH_BYTE - 1);
+    } else {
+      for (size_t j = 0; j < HASH_LENGTH_BYTE - 1; j++) {
+        bytes[j] = rand();
+      }
+    }
+    memcpy(reduced, bytes, HASH_LENGTH_BYTE - 1);
+    convert_bytes_reduce(reduced);
+    convert_bytes_to_trits(bytes, trits);
+    convert_trits_to_bytes(trits, expected);
+    TEST_ASSERT_EQUAL_MEMORY(expected, reduced, HASH_LENGTH_BYTE - 1);
+  }
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_trits_all_bytes);
   RUN_TEST(test_trits_bytes_trits);
   RUN_TEST(test_bytes_trits);
+  RUN_TEST(test_bytes_reduce);
 
   return UNITY_END();
 }
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unity/unity.h>
+
+#include "common/crypto/kerl/kerl.h"
+#include "common/crypto/kerl/kerl_lanes.h"
+#include "common/defs.h"
+
+#define CHUNKS_MAX 30
+#define ROUNDS_MAX 26
+
+static void random_trits(trit_t *const trits, size_t const length) {
+  for (size_t i = 0; i < length; i++) {
+    trits[i] = rand() % 3 - 1;
+  }
+}
+
+static void hash_chain(trit_t *const chunk, size_t const rounds) {
+  Kerl kerl;
+
+  kerl_init(&kerl);
+  for (size_t i = 0; i < rounds; i++) {
+    kerl_absorb(&kerl, chunk, HASH_LENGTH_TRIT);
+    kerl_squeeze(&kerl, chunk, HASH_LENGTH_TRIT);
+    kerl_reset(&kerl);
+  }
+}
+
+void test_hash_chains(void) {
+  trit_t actual[CHUNKS_MAX][HASH_LENGTH_TRIT], expected[CHUNKS_MAX][HASH_LENGTH_TRIT];
+  trit_t *chunks[CHUNKS_MAX];
+  size_t rounds[CHUNKS_MAX];
+
+  for (size_t count = 1; count <= CHUNKS_MAX; count++) {
+    for (size_t i = 0; i < count; i++) {
+      random_trits(actual[i], HASH_LENGTH_TRIT);
+      memcpy(expected[i], actual[i], sizeof(actual[i]));
+      chunks[i] = actual[i];
+      rounds[i] = rand() % (ROUNDS_MAX + 1);
+      hash_chain(expected[i], rounds[i]);
+    }
+    kerl_hash_chains(chunks, rounds, count);
+    for (size_t i = 0; i < count; i++) {
+      TEST_ASSERT_EQUAL_MEMORY(expected[i], actual[i], sizeof(actual[i]));
+    }
+  }
+}
+
+void test_hash_chains_no_round(void) {
+  trit_t chunk[HASH_LENGTH_TRIT], copy[HASH_LENGTH_TRIT];
+  trit_t *chunks[1] = {chunk};
+  size_t rounds[1] = {0};
+
+  random_trits(chunk, HASH_LENGTH_TRIT);
+  memcpy(copy, chunk, sizeof(chunk));
+  kerl_hash_chains(chunks, rounds, 1);
+  TEST_ASSERT_EQUAL_MEMORY(copy, chunk, sizeof(chunk));
+  kerl_hash_chains(chunks, rounds, 0);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_hash_chains);
+  RUN_TEST(test_hash_chains_no_round);
+
+  return UNITY_END();
+}
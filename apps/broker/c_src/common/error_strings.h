@@ -74,6 +74,7 @@ extern "C" {
 #define STR_UTILS_SOCKET_CONNECT "Socket connect error"
 #define STR_UTILS_SOCKET_RECV "Socket receive error"
 #define STR_UTILS_SOCKET_SEND "Socket send error"
+#define STR_UTILS_RING_BUFFER_FULL "Ring buffer full"
 /** @} */
 
 #ifdef __cplusplus
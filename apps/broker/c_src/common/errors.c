@@ -101,6 +101,8 @@ const char* error_2_string(retcode_t err) {
       return STR_UTILS_SOCKET_RECV;
     case RC_UTILS_SOCKET_SEND:
       return STR_UTILS_SOCKET_SEND;
+    case RC_UTILS_RING_BUFFER_FULL:
+      return STR_UTILS_RING_BUFFER_FULL;
 
     // Processor component module
     case RC_PROCESSOR_INVALID_TRANSACTION:
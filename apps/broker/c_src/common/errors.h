@@ -83,6 +83,7 @@ extern "C" {
 #define RC_MODULE_COMMON (0x14 << RC_MODULE_SHIFT)
 #define RC_MODULE_HANDLE (0x15 << RC_MODULE_SHIFT)
 #define RC_MODULE_NETWORK (0x16 << RC_MODULE_SHIFT)
+#define RC_MODULE_KV (0x17 << RC_MODULE_SHIFT)
 
 /** @} */
 
@@ -150,6 +151,7 @@ enum retcode_t {
   RC_SQLITE3_FAILED_CONFIG = 0x0C | RC_MODULE_SQLITE3 | RC_SEVERITY_FATAL,
   RC_SQLITE3_FAILED_INITIALIZE = 0x0D | RC_MODULE_SQLITE3 | RC_SEVERITY_FATAL,
   RC_SQLITE3_FAILED_SHUTDOWN = 0x0E | RC_MODULE_SQLITE3 | RC_SEVERITY_FATAL,
+  RC_SQLITE3_SCHEMA_VERSION_MISMATCH = 0x0F | RC_MODULE_SQLITE3 | RC_SEVERITY_FATAL,
 
   // Neighbor Module
   RC_NEIGHBOR_FAILED_URI_PARSING = 0x01 | RC_MODULE_NEIGHBOR | RC_SEVERITY_MAJOR,
@@ -160,6 +162,7 @@ enum retcode_t {
   RC_NEIGHBOR_FAILED_ENDPOINT_DESTROY = 0x06 | RC_MODULE_NEIGHBOR | RC_SEVERITY_FATAL,
   RC_NEIGHBOR_ALREADY_PAIRED = 0x07 | RC_MODULE_NEIGHBOR | RC_SEVERITY_MODERATE,
   RC_NEIGHBOR_NOT_PAIRED = 0x08 | RC_MODULE_NEIGHBOR | RC_SEVERITY_MODERATE,
+  RC_NEIGHBOR_SEND_QUEUE_FULL = 0x09 | RC_MODULE_NEIGHBOR | RC_SEVERITY_MINOR,
 
   // Cclient Module
   RC_CCLIENT_JSON_CREATE = 0x01 | RC_MODULE_CCLIENT | RC_SEVERITY_FATAL, /**< json create object error, might OOM. */
@@ -250,6 +253,7 @@ enum retcode_t {
   RC_UTILS_SOCKET_CONNECT = 0x14 | RC_MODULE_UTILS | RC_SEVERITY_MAJOR,
   RC_UTILS_SOCKET_RECV = 0x15 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
   RC_UTILS_SOCKET_SEND = 0x16 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
+  RC_UTILS_RING_BUFFER_FULL = 0x17 | RC_MODULE_UTILS | RC_SEVERITY_MINOR,
 
   // Processor component Module
   RC_PROCESSOR_INVALID_TRANSACTION = 0x01 | RC_MODULE_PROCESSOR | RC_SEVERITY_MODERATE,
@@ -339,6 +343,16 @@ enum retcode_t {
   RC_WRITE_TCP_FAILED = 0x07 | RC_MODULE_NETWORK | RC_SEVERITY_FATAL,
   RC_ASYNC_INIT_FAILED = 0x08 | RC_MODULE_NETWORK | RC_SEVERITY_FATAL,
   RC_ASYNC_CALL_FAILED = 0x09 | RC_MODULE_NETWORK | RC_SEVERITY_FATAL,
+
+  // Storage KV Module
+  RC_KV_FAILED_OPEN_DB = 0x01 | RC_MODULE_KV | RC_SEVERITY_FATAL,
+  RC_KV_FAILED_CONFIG = 0x02 | RC_MODULE_KV | RC_SEVERITY_FATAL,
+  RC_KV_FAILED_READ = 0x03 | RC_MODULE_KV | RC_SEVERITY_MAJOR,
+  RC_KV_FAILED_WRITE = 0x04 | RC_MODULE_KV | RC_SEVERITY_MAJOR,
+  RC_KV_KEY_EXISTS = 0x05 | RC_MODULE_KV | RC_SEVERITY_MODERATE,
+  RC_KV_CORRUPTED_VALUE = 0x06 | RC_MODULE_KV | RC_SEVERITY_MAJOR,
+  RC_KV_NO_PATH_FOR_DB_SPECIFIED = 0x07 | RC_MODULE_KV | RC_SEVERITY_FATAL,
+  RC_KV_FAILED_NOT_IMPLEMENTED = 0x08 | RC_MODULE_KV | RC_SEVERITY_MAJOR,
 };
 
 typedef enum retcode_t retcode_t;
@@ -9,6 +9,7 @@
 #include "common/crypto/iss/v1/iss_kerl.h"
 #include "common/helpers/sign.h"
 #include "common/trinary/trit_long.h"
+#include "common/trinary/trit_tryte.h"
 #include "common/trinary/tryte_long.h"
 
 static UT_icd bundle_transactions_icd = {sizeof(iota_transaction_t), 0, 0, 0};
@@ -163,28 +164,30 @@ void bundle_finalize(bundle_transactions_t *bundle, Kerl *const kerl) {
   }
 }
 
-retcode_t bundle_validate(bundle_transactions_t *const bundle, bundle_status_t *const status) {
-  retcode_t res = RC_OK;
+retcode_t bundle_validate_essence(bundle_transactions_t *const bundle, Kerl *const kerl, bundle_status_t *const status,
+                                  trit_t *const normalized_bundle) {
   iota_transaction_t *curr_tx = NULL;
   uint64_t current_index = 0, last_index = 0;
   int64_t bundle_value = 0, tx_value = 0;
   flex_trit_t bundle_hash[FLEX_TRIT_SIZE_243];
-  bool valid_sig = false;
-  Kerl shared_kerl1, shared_kerl2;
   flex_trit_t bundle_hash_calculated[FLEX_TRIT_SIZE_243];
-  trit_t normalized_bundle[HASH_LENGTH_TRIT];
 
   if (bundle == NULL) {
     *status = BUNDLE_NOT_INITIALIZED;
     return RC_NULL_PARAM;
   }
 
+  if (utarray_len(bundle) == 0) {
+    *status = BUNDLE_EMPTY;
+    return RC_OK;
+  }
+
   curr_tx = (iota_transaction_t *)utarray_eltptr(bundle, 0);
   last_index = transaction_last_index(curr_tx);
 
   if (utarray_len(bundle) != last_index + 1) {
     *status = BUNDLE_INCOMPLETE;
-    return res;
+    return RC_OK;
   }
 
   memcpy(bundle_hash, transaction_bundle(curr_tx), FLEX_TRIT_SIZE_243);
@@ -219,21 +222,111 @@ retcode_t bundle_validate(bundle_transactions_t *const bundle, bundle_status_t *
         break;
       }
 
-      bundle_calculate_hash(bundle, &shared_kerl1, bundle_hash_calculated);
+      bundle_calculate_hash(bundle, kerl, bundle_hash_calculated);
       if (memcmp(bundle_hash, bundle_hash_calculated, FLEX_TRIT_SIZE_243) != 0) {
         *status = BUNDLE_INVALID_HASH;
         break;
       }
 
       normalize_flex_hash_to_trits(bundle_hash_calculated, normalized_bundle);
+    }
+    *status = BUNDLE_VALID;
+  }
+  return RC_OK;
+}
 
-      res = validate_signatures(bundle, normalized_bundle, &shared_kerl1, &shared_kerl2, &valid_sig);
-      if (res != RC_OK || !valid_sig) {
-        *status = BUNDLE_INVALID_SIGNATURE;
-        break;
+retcode_t bundle_view_validate_essence(bundle_view_t const *const bundle, Kerl *const kerl,
+                                       bundle_status_t *const status, trit_t *const normalized_bundle) {
+  iota_transaction_view_t curr_tx;
+  uint64_t last_index = 0;
+  int64_t bundle_value = 0, tx_value = 0;
+  trit_t essence_trits[NUM_TRITS_ESSENCE];
+  trit_t bundle_hash_trits[NUM_TRITS_HASH];
+  trit_t last_address_trits[NUMBER_OF_TRITS_IN_A_TRYTE];
+  tryte_t bundle_hash[NUM_TRYTES_BUNDLE];
+
+  if (bundle == NULL) {
+    *status = BUNDLE_NOT_INITIALIZED;
+    return RC_NULL_PARAM;
+  }
+
+  if (bundle->size == 0) {
+    *status = BUNDLE_EMPTY;
+    return RC_OK;
+  }
+
+  last_index = transaction_view_last_index(bundle_view_at(bundle, 0));
+
+  if (bundle->size != last_index + 1) {
+    *status = BUNDLE_INCOMPLETE;
+    return RC_OK;
+  }
+
+  kerl_init(kerl);
+  for (size_t i = 0; i < bundle->size; i++) {
+    curr_tx = bundle_view_at(bundle, i);
+    tx_value = transaction_view_value(curr_tx);
+    if (llabs(tx_value) > MAX_IOTA_SUPPLY) {
+      *status = BUNDLE_INVALID_VALUE;
+      return RC_OK;
+    }
+
+    bundle_value += tx_value;
+    if (llabs(bundle_value) > MAX_IOTA_SUPPLY) {
+      *status = BUNDLE_INVALID_VALUE;
+      return RC_OK;
+    }
+
+    if (transaction_view_current_index(curr_tx) != i || transaction_view_last_index(curr_tx) != last_index) {
+      *status = BUNDLE_INVALID_TX;
+      return RC_OK;
+    }
+
+    if (tx_value != 0) {
+      trytes_to_trits(&transaction_view_address(curr_tx)[NUM_TRYTES_ADDRESS - 1], last_address_trits, 1);
+      if (last_address_trits[NUMBER_OF_TRITS_IN_A_TRYTE - 1] != 0) {
+        *status = BUNDLE_INVALID_INPUT_ADDRESS;
+        return RC_OK;
       }
     }
-    *status = BUNDLE_VALID;
+
+    // The essence trits are absorbed as they are serialized
+    trytes_to_trits(transaction_view_essence(curr_tx), essence_trits, NUM_TRYTES_ESSENCE);
+    kerl_absorb(kerl, essence_trits, NUM_TRITS_ESSENCE);
+  }
+
+  if (bundle_value != 0) {
+    *status = BUNDLE_INVALID_VALUE;
+    return RC_OK;
+  }
+
+  kerl_squeeze(kerl, bundle_hash_trits, NUM_TRITS_HASH);
+  trits_to_trytes(bundle_hash_trits, bundle_hash, NUM_TRITS_HASH);
+  if (memcmp(bundle_hash, transaction_view_bundle(bundle_view_at(bundle, 0)), NUM_TRYTES_BUNDLE) != 0) {
+    *status = BUNDLE_INVALID_HASH;
+    return RC_OK;
+  }
+
+  normalize_hash_to_trits(bundle_hash_trits, normalized_bundle);
+  *status = BUNDLE_VALID;
+
+  return RC_OK;
+}
+
+retcode_t bundle_validate(bundle_transactions_t *const bundle, bundle_status_t *const status) {
+  retcode_t res = RC_OK;
+  bool valid_sig = false;
+  Kerl shared_kerl1, shared_kerl2;
+  trit_t normalized_bundle[HASH_LENGTH_TRIT];
+
+  if ((res = bundle_validate_essence(bundle, &shared_kerl1, status, normalized_bundle)) != RC_OK ||
+      *status != BUNDLE_VALID) {
+    return res;
+  }
+
+  res = validate_signatures(bundle, normalized_bundle, &shared_kerl1, &shared_kerl2, &valid_sig);
+  if (res != RC_OK || !valid_sig) {
+    *status = BUNDLE_INVALID_SIGNATURE;
   }
   return RC_OK;
 }
@@ -22,6 +22,7 @@
 #include "common/errors.h"
 #include "common/model/inputs.h"
 #include "common/model/transaction.h"
+#include "common/model/transaction_view.h"
 #include "common/model/transfer.h"
 #include "common/trinary/flex_trit.h"
 #include "utarray.h"
@@ -128,6 +129,33 @@ void bundle_calculate_hash(bundle_transactions_t *bundle, Kerl *const kerl, flex
  */
 void bundle_finalize(bundle_transactions_t *bundle, Kerl *const kerl);
 
+/**
+ * @brief Validates a bundle except for the signatures of its inputs.
+ *
+ * Checks indexes, values, input addresses and the bundle hash. The signatures can then be verified against the
+ * normalized bundle hash, by bundle_validate() or in parallel by a bundle validation pool.
+ *
+ * @param[in] bundle A bundle object.
+ * @param[in] kerl A Kerl object.
+ * @param[out] status The status of the bundle, #BUNDLE_VALID if only the signatures are left to check.
+ * @param[out] normalized_bundle The normalized bundle hash, set if status is #BUNDLE_VALID.
+ * @return #retcode_t
+ */
+retcode_t bundle_validate_essence(bundle_transactions_t *const bundle, Kerl *const kerl, bundle_status_t *const status,
+                                  trit_t *const normalized_bundle);
+
+/**
+ * @brief Same as bundle_validate_essence() on a bundle read in place from its serialized trytes.
+ *
+ * @param[in] bundle A bundle view.
+ * @param[in] kerl A Kerl object.
+ * @param[out] status The status of the bundle, #BUNDLE_VALID if only the signatures are left to check.
+ * @param[out] normalized_bundle The normalized bundle hash, set if status is #BUNDLE_VALID.
+ * @return #retcode_t
+ */
+retcode_t bundle_view_validate_essence(bundle_view_t const *const bundle, Kerl *const kerl,
+                                       bundle_status_t *const status, trit_t *const normalized_bundle);
+
 /**
  * @brief Validates a bundle.
  *
@@ -0,0 +1,405 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/crypto/iss/v1/iss_kerl.h"
+#include "common/model/bundle_validation_pool.h"
+#include "common/trinary/trit_tryte.h"
+#include "utlist.h"
+
+// The digest of one signature fragment, i.e. of one transaction of an input
+struct sig_fragment_task_s {
+  void const *signature;  // Flex trits, or trytes when validating bundle views
+  trit_t const *normalized_fragment;
+  trit_t digest[NUM_TRITS_ADDRESS];
+};
+
+// The signature fragments of an input address, digested by consecutive tasks
+struct input_group_s {
+  size_t bundle_index;
+  void const *address;  // Flex trits, or trytes when validating bundle views
+  size_t first_task;
+  size_t tasks_num;
+};
+
+struct bundle_validation_batch_s {
+  sig_fragment_task_t *tasks;
+  size_t tasks_num;
+  size_t claimed;  // Number of tasks picked up by a thread
+  size_t pending;  // Number of tasks not done yet
+  bool views;      // Signatures are read from bundle views
+  struct bundle_validation_batch_s *prev;
+  struct bundle_validation_batch_s *next;
+};
+
+/**
+ * Private functions
+ */
+
+static void sig_fragment_task_run(sig_fragment_task_t *const task, bool const views, Kerl *const kerl,
+                                  trit_t *const key) {
+  kerl_init(kerl);
+  if (views) {
+    trytes_to_trits((tryte_t const *)task->signature, key, NUM_TRYTES_SIGNATURE);
+  } else {
+    flex_trits_to_trits(key, NUM_TRITS_SIGNATURE, (flex_trit_t const *)task->signature, NUM_TRITS_SIGNATURE,
+                        NUM_TRITS_SIGNATURE);
+  }
+  iss_kerl_sig_digest(task->digest, task->normalized_fragment, key, NUM_TRITS_SIGNATURE, kerl);
+}
+
+// Must be called with the pool lock held, releases it while the task runs
+static void batch_run_next_task(bundle_validation_pool_t *const pool, bundle_validation_batch_t *const batch,
+                                Kerl *const kerl, trit_t *const key) {
+  sig_fragment_task_t *task = &batch->tasks[batch->claimed++];
+
+  lock_handle_unlock(&pool->lock);
+  sig_fragment_task_run(task, batch->views, kerl, key);
+  lock_handle_lock(&pool->lock);
+
+  if (--batch->pending == 0) {
+    cond_handle_broadcast(&pool->done_cond);
+  }
+}
+
+static void *bundle_validation_pool_routine(bundle_validation_pool_t *const pool) {
+  bundle_validation_batch_t *batch = NULL;
+  Kerl kerl;
+  trit_t key[NUM_TRITS_SIGNATURE];
+
+  lock_handle_lock(&pool->lock);
+  while (pool->running) {
+    DL_FOREACH(pool->batches, batch) {
+      if (batch->claimed < batch->tasks_num) {
+        break;
+      }
+    }
+    if (batch == NULL) {
+      cond_handle_wait(&pool->work_cond, &pool->lock);
+      continue;
+    }
+    batch_run_next_task(pool, batch, &kerl, key);
+  }
+  lock_handle_unlock(&pool->lock);
+
+  return NULL;
+}
+
+static void pool_run_batch(bundle_validation_pool_t *const pool, bundle_validation_batch_t *const batch) {
+  Kerl kerl;
+  trit_t key[NUM_TRITS_SIGNATURE];
+
+  lock_handle_lock(&pool->lock);
+  DL_APPEND(pool->batches, batch);
+  cond_handle_broadcast(&pool->work_cond);
+  while (batch->claimed < batch->tasks_num) {
+    batch_run_next_task(pool, batch, &kerl, key);
+  }
+  while (batch->pending > 0) {
+    cond_handle_wait(&pool->done_cond, &pool->lock);
+  }
+  DL_DELETE(pool->batches, batch);
+  lock_handle_unlock(&pool->lock);
+}
+
+// Splits the inputs of a bundle into signature fragment tasks, the same way validate_signatures walks them
+static void bundle_add_tasks(bundle_transactions_t const *const bundle, size_t const bundle_index,
+                             trit_t const *const normalized_bundle, sig_fragment_task_t *const tasks,
+                             size_t *const tasks_num, input_group_t *const groups, size_t *const groups_num) {
+  iota_transaction_t *curr_tx = NULL, *curr_inp_tx = NULL;
+  input_group_t *group = NULL;
+  sig_fragment_task_t *task = NULL;
+
+  for (curr_tx = (iota_transaction_t *)utarray_eltptr(bundle, 0); curr_tx != NULL;) {
+    if (transaction_value(curr_tx) >= 0) {
+      curr_tx = (iota_transaction_t *)utarray_next(bundle, curr_tx);
+      continue;
+    }
+    group = &groups[(*groups_num)++];
+    group->bundle_index = bundle_index;
+    group->address = transaction_address(curr_tx);
+    group->first_task = *tasks_num;
+    group->tasks_num = 0;
+    curr_inp_tx = curr_tx;
+    do {
+      task = &tasks[(*tasks_num)++];
+      task->signature = transaction_signature(curr_inp_tx);
+      task->normalized_fragment = &normalized_bundle[(group->tasks_num * ISS_FRAGMENTS * RADIX) % NUM_TRITS_HASH];
+      group->tasks_num++;
+      curr_inp_tx = (iota_transaction_t *)utarray_next(bundle, curr_inp_tx);
+    } while (curr_inp_tx != NULL &&
+             memcmp(transaction_address(curr_inp_tx), transaction_address(curr_tx), FLEX_TRIT_SIZE_243) == 0 &&
+             transaction_value(curr_inp_tx) == 0);
+    curr_tx = curr_inp_tx;
+  }
+}
+
+// Same as bundle_add_tasks on a bundle view, signatures and addresses are referenced in place
+static void bundle_view_add_tasks(bundle_view_t const *const bundle, size_t const bundle_index,
+                                  trit_t const *const normalized_bundle, sig_fragment_task_t *const tasks,
+                                  size_t *const tasks_num, input_group_t *const groups, size_t *const groups_num) {
+  iota_transaction_view_t curr_tx, curr_inp_tx;
+  input_group_t *group = NULL;
+  sig_fragment_task_t *task = NULL;
+  size_t i = 0, j = 0;
+
+  while (i < bundle->size) {
+    curr_tx = bundle_view_at(bundle, i);
+    if (transaction_view_value(curr_tx) >= 0) {
+      i++;
+      continue;
+    }
+    group = &groups[(*groups_num)++];
+    group->bundle_index = bundle_index;
+    group->address = transaction_view_address(curr_tx);
+    group->first_task = *tasks_num;
+    group->tasks_num = 0;
+    j = i;
+    do {
+      curr_inp_tx = bundle_view_at(bundle, j);
+      task = &tasks[(*tasks_num)++];
+      task->signature = transaction_view_signature(curr_inp_tx);
+      task->normalized_fragment = &normalized_bundle[(group->tasks_num * ISS_FRAGMENTS * RADIX) % NUM_TRITS_HASH];
+      group->tasks_num++;
+      j++;
+    } while (j < bundle->size &&
+             memcmp(transaction_view_address(bundle_view_at(bundle, j)), transaction_view_address(curr_tx),
+                    NUM_TRYTES_ADDRESS) == 0 &&
+             transaction_view_value(bundle_view_at(bundle, j)) == 0);
+    i = j;
+  }
+}
+
+// Grows the buffers to hold bundles_num bundles of txs_num transactions in total
+static retcode_t scratch_reserve(bundle_validation_scratch_t *const scratch, size_t const bundles_num,
+                                 size_t const txs_num) {
+  void *buffer = NULL;
+
+  if (bundles_num > scratch->bundles_capacity) {
+    if ((buffer = realloc(scratch->normalized_bundles, bundles_num * HASH_LENGTH_TRIT * sizeof(trit_t))) == NULL) {
+      return RC_OOM;
+    }
+    scratch->normalized_bundles = (trit_t *)buffer;
+    scratch->bundles_capacity = bundles_num;
+    scratch->grows++;
+  }
+
+  // Every tx is at most one task and one group
+  if (txs_num > scratch->txs_capacity) {
+    if ((buffer = realloc(scratch->tasks, txs_num * sizeof(sig_fragment_task_t))) == NULL) {
+      return RC_OOM;
+    }
+    scratch->tasks = (sig_fragment_task_t *)buffer;
+    if ((buffer = realloc(scratch->groups, txs_num * sizeof(input_group_t))) == NULL) {
+      return RC_OOM;
+    }
+    scratch->groups = (input_group_t *)buffer;
+    scratch->txs_capacity = txs_num;
+    scratch->grows++;
+  }
+
+  return RC_OK;
+}
+
+// Validates either bundles or bundle views, the other one is NULL
+static retcode_t pool_validate(bundle_validation_pool_t *const pool, bundle_transactions_t *const *const bundles,
+                               bundle_view_t const *const views, size_t const bundles_num,
+                               bundle_status_t *const statuses, bundle_validation_scratch_t *scratch) {
+  retcode_t ret = RC_OK;
+  size_t txs_num = 0, tasks_num = 0, groups_num = 0;
+  trit_t *normalized_bundles = NULL;
+  sig_fragment_task_t *tasks = NULL;
+  input_group_t *groups = NULL;
+  bundle_validation_scratch_t local_scratch;
+  bundle_validation_batch_t batch;
+  Kerl kerl;
+  trit_t digested_address[NUM_TRITS_ADDRESS];
+  flex_trit_t digest[FLEX_TRIT_SIZE_243];
+  tryte_t digest_trytes[NUM_TRYTES_ADDRESS];
+
+  for (size_t i = 0; i < bundles_num; i++) {
+    if (views != NULL) {
+      txs_num += views[i].size;
+    } else if (bundles[i] != NULL) {
+      txs_num += bundle_transactions_size(bundles[i]);
+    }
+  }
+
+  if (txs_num == 0) {
+    for (size_t i = 0; i < bundles_num; i++) {
+      statuses[i] = views == NULL && bundles[i] == NULL ? BUNDLE_NOT_INITIALIZED : BUNDLE_EMPTY;
+    }
+    return RC_OK;
+  }
+
+  if (scratch == NULL) {
+    bundle_validation_scratch_init(&local_scratch);
+    scratch = &local_scratch;
+  }
+  if ((ret = scratch_reserve(scratch, bundles_num, txs_num)) != RC_OK) {
+    goto done;
+  }
+  normalized_bundles = scratch->normalized_bundles;
+  tasks = scratch->tasks;
+  groups = scratch->groups;
+
+  for (size_t i = 0; i < bundles_num; i++) {
+    if (views != NULL) {
+      bundle_view_validate_essence(&views[i], &kerl, &statuses[i], &normalized_bundles[i * HASH_LENGTH_TRIT]);
+      if (statuses[i] == BUNDLE_VALID) {
+        bundle_view_add_tasks(&views[i], i, &normalized_bundles[i * HASH_LENGTH_TRIT], tasks, &tasks_num, groups,
+                              &groups_num);
+      }
+      continue;
+    }
+    if (bundles[i] == NULL) {
+      statuses[i] = BUNDLE_NOT_INITIALIZED;
+      continue;
+    }
+    bundle_validate_essence(bundles[i], &kerl, &statuses[i], &normalized_bundles[i * HASH_LENGTH_TRIT]);
+    if (statuses[i] == BUNDLE_VALID) {
+      bundle_add_tasks(bundles[i], i, &normalized_bundles[i * HASH_LENGTH_TRIT], tasks, &tasks_num, groups,
+                       &groups_num);
+    }
+  }
+
+  if (tasks_num > 0) {
+    memset(&batch, 0, sizeof(bundle_validation_batch_t));
+    batch.tasks = tasks;
+    batch.tasks_num = tasks_num;
+    batch.pending = tasks_num;
+    batch.views = views != NULL;
+    pool_run_batch(pool, &batch);
+  }
+
+  for (size_t i = 0; i < groups_num; i++) {
+    if (statuses[groups[i].bundle_index] != BUNDLE_VALID) {
+      continue;
+    }
+    kerl_init(&kerl);
+    for (size_t j = groups[i].first_task; j < groups[i].first_task + groups[i].tasks_num; j++) {
+      kerl_absorb(&kerl, tasks[j].digest, NUM_TRITS_ADDRESS);
+    }
+    kerl_squeeze(&kerl, digested_address, NUM_TRITS_ADDRESS);
+    if (views != NULL) {
+      trits_to_trytes(digested_address, digest_trytes, NUM_TRITS_ADDRESS);
+      if (memcmp(digest_trytes, groups[i].address, NUM_TRYTES_ADDRESS) != 0) {
+        statuses[groups[i].bundle_index] = BUNDLE_INVALID_SIGNATURE;
+      }
+    } else {
+      flex_trits_from_trits(digest, NUM_TRITS_HASH, digested_address, NUM_TRITS_ADDRESS, NUM_TRITS_ADDRESS);
+      if (memcmp(digest, groups[i].address, FLEX_TRIT_SIZE_243) != 0) {
+        statuses[groups[i].bundle_index] = BUNDLE_INVALID_SIGNATURE;
+      }
+    }
+  }
+
+done:
+  if (scratch == &local_scratch) {
+    bundle_validation_scratch_destroy(&local_scratch);
+  }
+
+  return ret;
+}
+
+/**
+ * Public functions
+ */
+
+retcode_t bundle_validation_pool_init(bundle_validation_pool_t *const pool, size_t const threads_num) {
+  if (pool == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(pool, 0, sizeof(bundle_validation_pool_t));
+  lock_handle_init(&pool->lock);
+  cond_handle_init(&pool->work_cond);
+  cond_handle_init(&pool->done_cond);
+  pool->running = true;
+
+  if (threads_num > 0 && (pool->threads = (thread_handle_t *)calloc(threads_num, sizeof(thread_handle_t))) == NULL) {
+    bundle_validation_pool_destroy(pool);
+    return RC_OOM;
+  }
+
+  for (; pool->threads_num < threads_num; pool->threads_num++) {
+    if (thread_handle_create(&pool->threads[pool->threads_num], (thread_routine_t)bundle_validation_pool_routine,
+                             pool) != 0) {
+      bundle_validation_pool_destroy(pool);
+      return RC_THREAD_CREATE;
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t bundle_validation_pool_destroy(bundle_validation_pool_t *const pool) {
+  retcode_t ret = RC_OK;
+
+  if (pool == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&pool->lock);
+  pool->running = false;
+  cond_handle_broadcast(&pool->work_cond);
+  lock_handle_unlock(&pool->lock);
+
+  for (size_t i = 0; i < pool->threads_num; i++) {
+    if (thread_handle_join(pool->threads[i], NULL) != 0) {
+      ret = RC_THREAD_JOIN;
+    }
+  }
+  free(pool->threads);
+  pool->threads = NULL;
+  pool->threads_num = 0;
+
+  cond_handle_destroy(&pool->done_cond);
+  cond_handle_destroy(&pool->work_cond);
+  lock_handle_destroy(&pool->lock);
+
+  return ret;
+}
+
+retcode_t bundle_validation_pool_validate(bundle_validation_pool_t *const pool,
+                                          bundle_transactions_t *const *const bundles, size_t const bundles_num,
+                                          bundle_status_t *const statuses, bundle_validation_scratch_t *const scratch) {
+  if (pool == NULL || bundles == NULL || statuses == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return pool_validate(pool, bundles, NULL, bundles_num, statuses, scratch);
+}
+
+retcode_t bundle_validation_pool_validate_views(bundle_validation_pool_t *const pool,
+                                                bundle_view_t const *const bundles, size_t const bundles_num,
+                                                bundle_status_t *const statuses,
+                                                bundle_validation_scratch_t *const scratch) {
+  if (pool == NULL || bundles == NULL || statuses == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return pool_validate(pool, NULL, bundles, bundles_num, statuses, scratch);
+}
+
+void bundle_validation_scratch_init(bundle_validation_scratch_t *const scratch) {
+  memset(scratch, 0, sizeof(bundle_validation_scratch_t));
+}
+
+void bundle_validation_scratch_destroy(bundle_validation_scratch_t *const scratch) {
+  free(scratch->normalized_bundles);
+  free(scratch->tasks);
+  free(scratch->groups);
+  bundle_validation_scratch_init(scratch);
+}
+
+size_t bundle_validation_scratch_size(bundle_validation_scratch_t const *const scratch) {
+  return scratch->bundles_capacity * HASH_LENGTH_TRIT * sizeof(trit_t) +
+         scratch->txs_capacity * (sizeof(sig_fragment_task_t) + sizeof(input_group_t));
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup common_model
+ *
+ * @{
+ *
+ * @file
+ * @brief Validates many bundles at once, spreading the signature fragment digests over a fixed pool of threads.
+ *
+ */
+#ifndef __COMMON_MODEL_BUNDLE_VALIDATION_POOL_H__
+#define __COMMON_MODEL_BUNDLE_VALIDATION_POOL_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common/errors.h"
+#include "common/model/bundle.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declarations
+typedef struct bundle_validation_batch_s bundle_validation_batch_t;
+typedef struct sig_fragment_task_s sig_fragment_task_t;
+typedef struct input_group_s input_group_t;
+
+/**
+ * @brief Working buffers of a validation, kept by a caller to reuse them across validations.
+ *
+ * Buffers only grow, a caller validating batches of similar sizes stops allocating after the first ones.
+ */
+typedef struct bundle_validation_scratch_s {
+  trit_t *normalized_bundles;
+  size_t bundles_capacity;
+  sig_fragment_task_t *tasks;
+  input_group_t *groups;
+  size_t txs_capacity;
+  size_t grows;  // Number of times the buffers were (re)allocated
+} bundle_validation_scratch_t;
+
+/**
+ * @brief A fixed pool of threads computing the signature fragment digests of the submitted bundles.
+ *
+ * Several callers can submit batches concurrently, each caller also works on its own batch while waiting for it.
+ */
+typedef struct bundle_validation_pool_s {
+  thread_handle_t *threads;
+  size_t threads_num;
+  bool running;
+  lock_handle_t lock;
+  cond_handle_t work_cond;  // Signaled when a batch is submitted or the pool stops
+  cond_handle_t done_cond;  // Signaled when the last task of a batch is done
+  bundle_validation_batch_t *batches;
+} bundle_validation_pool_t;
+
+/**
+ * @brief Initializes a bundle validation pool and starts its threads.
+ *
+ * @param[out] pool The pool.
+ * @param[in] threads_num The number of worker threads, with 0 the callers do all the work.
+ * @return #retcode_t
+ */
+retcode_t bundle_validation_pool_init(bundle_validation_pool_t *const pool, size_t const threads_num);
+
+/**
+ * @brief Stops the threads of a bundle validation pool and releases its resources.
+ *
+ * No batch must be in flight.
+ *
+ * @param[in, out] pool The pool.
+ * @return #retcode_t
+ */
+retcode_t bundle_validation_pool_destroy(bundle_validation_pool_t *const pool);
+
+/**
+ * @brief Validates bundles, with the same outcome as bundle_validate() on each of them.
+ *
+ * @param[in] pool The pool.
+ * @param[in] bundles The bundles.
+ * @param[in] bundles_num The number of bundles.
+ * @param[out] statuses The status of each bundle.
+ * @param[in, out] scratch Buffers of the caller, or NULL to allocate them for this validation only.
+ * @return #retcode_t
+ */
+retcode_t bundle_validation_pool_validate(bundle_validation_pool_t *const pool,
+                                          bundle_transactions_t *const *const bundles, size_t const bundles_num,
+                                          bundle_status_t *const statuses, bundle_validation_scratch_t *const scratch);
+
+/**
+ * @brief Validates bundles read in place from their serialized trytes, nothing is copied per transaction.
+ *
+ * @param[in] pool The pool.
+ * @param[in] bundles The bundle views.
+ * @param[in] bundles_num The number of bundles.
+ * @param[out] statuses The status of each bundle.
+ * @param[in, out] scratch Buffers of the caller, or NULL to allocate them for this validation only.
+ * @return #retcode_t
+ */
+retcode_t bundle_validation_pool_validate_views(bundle_validation_pool_t *const pool,
+                                                bundle_view_t const *const bundles, size_t const bundles_num,
+                                                bundle_status_t *const statuses,
+                                                bundle_validation_scratch_t *const scratch);
+
+/**
+ * @brief Initializes empty validation buffers.
+ *
+ * @param[out] scratch The buffers.
+ */
+void bundle_validation_scratch_init(bundle_validation_scratch_t *const scratch);
+
+/**
+ * @brief Releases validation buffers.
+ *
+ * @param[in, out] scratch The buffers.
+ */
+void bundle_validation_scratch_destroy(bundle_validation_scratch_t *const scratch);
+
+/**
+ * @brief Gives the memory held by validation buffers.
+ *
+ * @param[in] scratch The buffers.
+ * @return The size in bytes.
+ */
+size_t bundle_validation_scratch_size(bundle_validation_scratch_t const *const scratch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_MODEL_BUNDLE_VALIDATION_POOL_H__
+
+/** @} */
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "common/model/dmp_reader.h"
+#include "common/trinary/trit_ptrit.h"
+
+/*
+ * Private functions
+ */
+
+static inline bool is_bundle_end(iota_transaction_view_t const tx) {
+  // A malformed current index past the last one also ends the bundle, it would never end otherwise
+  return transaction_view_current_index(tx) >= transaction_view_last_index(tx);
+}
+
+// Gives the length of the line starting at `line`, end of line included, or 0 if it is malformed
+static size_t line_length(char const *const line, size_t const remaining, int64_t *const snapshot_index) {
+  size_t i = DMP_LINE_MIN_LENGTH;
+  size_t digits = 0;
+  int64_t index = -1;
+
+  // The hash and the trytes are separated by a comma
+  if (remaining < DMP_LINE_MIN_LENGTH || line[NUM_TRYTES_HASH] != ',') {
+    return 0;
+  }
+
+  if (i < remaining && line[i] != '\n') {
+    // Separator and snapshot index
+    for (index = 0, i++; i < remaining && line[i] >= '0' && line[i] <= '9'; i++, digits++) {
+      index = index * 10 + (line[i] - '0');
+    }
+    if (digits == 0) {
+      return 0;
+    }
+  }
+
+  if (i < remaining) {
+    if (line[i] != '\n') {
+      return 0;
+    }
+    i++;
+  }
+
+  if (snapshot_index) {
+    *snapshot_index = index;
+  }
+
+  return i;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t dmp_reader_open(dmp_reader_t *const reader, char const *const path) {
+  int fd = -1;
+  struct stat st;
+  void *data = NULL;
+
+  if (reader == NULL || path == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((fd = open(path, O_RDONLY)) < 0) {
+    return RC_UTILS_FAILED_TO_OPEN_FILE;
+  }
+
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return RC_UTILS_FAILED_READ_FILE;
+  }
+
+  if (st.st_size > 0) {
+    if ((data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)) == MAP_FAILED) {
+      close(fd);
+      return RC_UTILS_FAILED_READ_FILE;
+    }
+    // Chunks are split in order, let the kernel read ahead
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+  }
+  // The mapping outlives the descriptor
+  close(fd);
+
+  dmp_reader_init(reader, data, st.st_size);
+  reader->mapped = data != NULL;
+
+  return RC_OK;
+}
+
+void dmp_reader_init(dmp_reader_t *const reader, char const *const data, size_t const size) {
+  reader->data = data;
+  reader->size = size;
+  reader->offset = 0;
+  reader->mapped = false;
+}
+
+retcode_t dmp_reader_close(dmp_reader_t *const reader) {
+  if (reader == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if (reader->mapped && munmap((void *)reader->data, reader->size) != 0) {
+    return RC_UTILS_FAILED_CLOSE_FILE;
+  }
+  dmp_reader_init(reader, NULL, 0);
+
+  return RC_OK;
+}
+
+retcode_t dmp_reader_next_chunk(dmp_reader_t *const reader, size_t const max_txs, char const **const chunk,
+                                size_t *const length, size_t *const txs_count) {
+  size_t offset = 0, line = 0, count = 0;
+  iota_transaction_view_t tx;
+
+  if (reader == NULL || chunk == NULL || length == NULL || txs_count == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  offset = reader->offset;
+  while (offset < reader->size) {
+    if ((line = line_length(reader->data + offset, reader->size - offset, NULL)) == 0) {
+      if (count == 0) {
+        return RC_INVALID_PARAM;
+      }
+      // The lines before are given, the next call fails on this one
+      break;
+    }
+    tx.trytes = (tryte_t const *)(reader->data + offset + DMP_LINE_OFFSET_TRYTES);
+    offset += line;
+    if (++count >= max_txs && is_bundle_end(tx)) {
+      break;
+    }
+  }
+
+  *chunk = reader->data + reader->offset;
+  *length = offset - reader->offset;
+  *txs_count = count;
+  reader->offset = offset;
+
+  return RC_OK;
+}
+
+retcode_t dmp_chunk_parse(char const *const chunk, size_t const length, dmp_tx_t *const txs, size_t const capacity,
+                          size_t *const count) {
+  size_t offset = 0, line = 0;
+
+  if ((chunk == NULL && length > 0) || txs == NULL || count == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  for (*count = 0; offset < length; ++*count, offset += line) {
+    if (*count == capacity ||
+        (line = line_length(chunk + offset, length - offset, &txs[*count].snapshot_index)) == 0) {
+      return RC_INVALID_PARAM;
+    }
+    txs[*count].hash = (tryte_t const *)(chunk + offset);
+    txs[*count].tx.trytes = (tryte_t const *)(chunk + offset + DMP_LINE_OFFSET_TRYTES);
+    txs[*count].valid = false;
+  }
+
+  return RC_OK;
+}
+
+void dmp_txs_verify(dmp_hasher_t *const hasher, dmp_tx_t *const txs, size_t const count) {
+  tryte_t const *chunks[PTRIT_WIDE_LANES];
+  tryte_t *hashes[PTRIT_WIDE_LANES];
+  size_t batch = 0;
+
+  for (size_t i = 0; i < PTRIT_WIDE_LANES; i++) {
+    hashes[i] = hasher->hashes[i];
+  }
+
+  for (size_t first = 0; first < count; first += batch) {
+    batch = count - first < PTRIT_WIDE_LANES ? count - first : PTRIT_WIDE_LANES;
+    ptrit_wide_curl_init(&hasher->curl, CURL_P_81, batch);
+    // Absorbs the same chunk of all the transactions of the batch at once
+    for (size_t offset = 0; offset < NUM_TRYTES_SERIALIZED_TRANSACTION; offset += NUM_TRYTES_HASH) {
+      for (size_t i = 0; i < batch; i++) {
+        chunks[i] = txs[first + i].tx.trytes + offset;
+      }
+      trytes_to_ptrits_wide(chunks, batch, hasher->acc, NUM_TRYTES_HASH);
+      ptrit_wide_curl_absorb(&hasher->curl, hasher->acc, HASH_LENGTH_TRIT);
+    }
+    ptrit_wide_curl_squeeze(&hasher->curl, hasher->acc, HASH_LENGTH_TRIT);
+    ptrits_wide_to_trytes(hasher->acc, hashes, batch, NUM_TRYTES_HASH);
+    for (size_t i = 0; i < batch; i++) {
+      txs[first + i].valid = memcmp(hasher->hashes[i], txs[first + i].hash, NUM_TRYTES_HASH) == 0;
+    }
+  }
+}
+
+size_t dmp_txs_bundle_size(dmp_tx_t const *const txs, size_t const count) {
+  for (size_t i = 0; i < count; i++) {
+    if (is_bundle_end(txs[i].tx)) {
+      return i + 1;
+    }
+  }
+
+  return count;
+}
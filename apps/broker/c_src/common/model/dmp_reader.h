@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup common_model
+ *
+ * @{
+ *
+ * @file
+ * @brief Streams the transactions of historical dump (dmp) files.
+ *
+ * A dump holds a line per transaction, `hash,trytes[,snapshot_index]` with the hash and the serialized trytes of the
+ * transaction. The transactions of a bundle are on consecutive lines, up to the one whose current index is the last
+ * index. A reader maps the file in memory and splits it in chunks of whole bundles, the chunks are then parsed and
+ * their hashes verified independently, on as many threads as wanted.
+ *
+ */
+#ifndef __COMMON_MODEL_DMP_READER_H__
+#define __COMMON_MODEL_DMP_READER_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common/crypto/curl-p/ptrit_wide.h"
+#include "common/errors.h"
+#include "common/model/transaction_view.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DMP_LINE_OFFSET_TRYTES (NUM_TRYTES_HASH + 1)
+// Hash, separator and trytes, the end of line is optional on the last line
+#define DMP_LINE_MIN_LENGTH (DMP_LINE_OFFSET_TRYTES + NUM_TRYTES_SERIALIZED_TRANSACTION)
+
+/**
+ * @brief A dump mapped in memory, or any buffer holding dump lines.
+ */
+typedef struct dmp_reader_s {
+  char const *data;
+  size_t size;
+  size_t offset;  // Start of the next chunk
+  bool mapped;
+} dmp_reader_t;
+
+/**
+ * @brief A transaction parsed in place from its dump line.
+ */
+typedef struct dmp_tx_s {
+  tryte_t const *hash;
+  iota_transaction_view_t tx;
+  int64_t snapshot_index;  // -1 when the line has none
+  bool valid;              // The hash of the trytes matches the hash of the line, set by dmp_txs_verify()
+} dmp_tx_t;
+
+/**
+ * @brief State of the hash verification, too large for a thread stack.
+ */
+typedef struct dmp_hasher_s {
+  PCurlWide curl;
+  ptrit_wide_t acc[HASH_LENGTH_TRIT];
+  tryte_t hashes[PTRIT_WIDE_LANES][NUM_TRYTES_HASH];
+} dmp_hasher_t;
+
+/**
+ * @brief Maps a dump file in memory.
+ *
+ * @param[out] reader The reader.
+ * @param[in] path The path of the dump.
+ * @return #retcode_t
+ */
+retcode_t dmp_reader_open(dmp_reader_t *const reader, char const *const path);
+
+/**
+ * @brief Initializes a reader over dump lines already in memory.
+ *
+ * @param[out] reader The reader.
+ * @param[in] data The lines, must outlive the reader.
+ * @param[in] size The size of the lines.
+ */
+void dmp_reader_init(dmp_reader_t *const reader, char const *const data, size_t const size);
+
+/**
+ * @brief Unmaps the dump of a reader.
+ *
+ * @param[in, out] reader The reader.
+ * @return #retcode_t
+ */
+retcode_t dmp_reader_close(dmp_reader_t *const reader);
+
+/**
+ * @brief Splits the next chunk of whole bundles.
+ *
+ * A chunk holds at least a bundle and stops at the first bundle end from max_txs transactions on. The last bundle of
+ * a dump may be incomplete.
+ *
+ * @param[in, out] reader The reader.
+ * @param[in] max_txs The number of transactions from which the chunk stops at a bundle end.
+ * @param[out] chunk The first line of the chunk.
+ * @param[out] length The length of the chunk, 0 at the end of the dump.
+ * @param[out] txs_count The number of transactions of the chunk.
+ * @return #retcode_t RC_INVALID_PARAM on a malformed line, the reader then stays on it.
+ */
+retcode_t dmp_reader_next_chunk(dmp_reader_t *const reader, size_t const max_txs, char const **const chunk,
+                                size_t *const length, size_t *const txs_count);
+
+/**
+ * @brief Parses the lines of a chunk.
+ *
+ * @param[in] chunk The lines.
+ * @param[in] length The length of the lines.
+ * @param[out] txs The transactions, they point into the chunk.
+ * @param[in] capacity The number of transactions txs can hold.
+ * @param[out] count The number of transactions.
+ * @return #retcode_t RC_INVALID_PARAM on a malformed line or more than capacity lines.
+ */
+retcode_t dmp_chunk_parse(char const *const chunk, size_t const length, dmp_tx_t *const txs, size_t const capacity,
+                          size_t *const count);
+
+/**
+ * @brief Hashes transactions by batches of PTRIT_WIDE_LANES and checks the hashes of their lines.
+ *
+ * @param[in] hasher The hashing state.
+ * @param[in, out] txs The transactions, their valid flag is set.
+ * @param[in] count The number of transactions.
+ */
+void dmp_txs_verify(dmp_hasher_t *const hasher, dmp_tx_t *const txs, size_t const count);
+
+/**
+ * @brief Gives the size of the bundle at the head of transactions.
+ *
+ * @param[in] txs The transactions.
+ * @param[in] count The number of transactions.
+ * @return The number of transactions up to the last one of the bundle, count if the bundle doesn't end.
+ */
+size_t dmp_txs_bundle_size(dmp_tx_t const *const txs, size_t const count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_MODEL_DMP_READER_H__
+
+/** @} */
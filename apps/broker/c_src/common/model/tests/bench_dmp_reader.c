@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Measures the import throughput of a synthetic dump: threads take chunks of whole bundles from the mapped file,
+ * parse them and verify the hashes of their transactions, as the importer NIFs do.
+ *
+ * Usage: bench_dmp_reader [transactions] [threads] [path]
+ * 1000000 transactions make a dump of about 2.8 GB.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "common/crypto/curl-p/digest.h"
+#include "common/model/dmp_reader.h"
+#include "common/trinary/trit_tryte.h"
+#include "common/trinary/tryte_long.h"
+#include "utils/handles/lock.h"
+#include "utils/handles/thread.h"
+
+#define DEFAULT_TXS 100000
+#define DEFAULT_PATH "/tmp/bench_dmp_reader.dmp"
+#define BUNDLE_SIZE 4
+#define TEMPLATES (16 * BUNDLE_SIZE)
+#define CHUNK_TXS 2048
+#define SNAPSHOT_INDEX 242662
+
+typedef struct bench_s {
+  dmp_reader_t reader;
+  lock_handle_t lock;
+  size_t parsed;
+  size_t valid;
+  size_t bundles;
+  bool failed;
+} bench_t;
+
+static double elapsed_s(struct timespec const *const start) {
+  struct timespec end;
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Writes the dump from a few template lines with valid hashes, in bundles of BUNDLE_SIZE transactions
+static bool write_dump(char const *const path, size_t const txs) {
+  static char lines[TEMPLATES][DMP_LINE_MIN_LENGTH];
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  trit_t hash[NUM_TRITS_HASH];
+  FILE *file = NULL;
+  Curl curl;
+
+  srand(42);
+  for (size_t t = 0; t < TEMPLATES; t++) {
+    tryte_t *const trytes = (tryte_t *)lines[t] + DMP_LINE_OFFSET_TRYTES;
+
+    for (size_t i = 0; i < NUM_TRYTES_SERIALIZED_TRANSACTION; i++) {
+      trytes[i] = TRYTE_ALPHABET[rand() % TRYTE_SPACE_SIZE];
+    }
+    memset(&trytes[TRANSACTION_VIEW_OFFSET_CURRENT_INDEX], '9', NUM_TRYTES_CURRENT_INDEX + NUM_TRYTES_LAST_INDEX);
+    long_to_trytes(t % BUNDLE_SIZE, &trytes[TRANSACTION_VIEW_OFFSET_CURRENT_INDEX]);
+    long_to_trytes(BUNDLE_SIZE - 1, &trytes[TRANSACTION_VIEW_OFFSET_LAST_INDEX]);
+    curl_init(&curl);
+    curl.type = CURL_P_81;
+    trytes_to_trits(trytes, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+    curl_digest(trits, NUM_TRITS_SERIALIZED_TRANSACTION, hash, &curl);
+    trits_to_trytes(hash, (tryte_t *)lines[t], NUM_TRITS_HASH);
+    lines[t][NUM_TRYTES_HASH] = ',';
+  }
+
+  if ((file = fopen(path, "w")) == NULL) {
+    return false;
+  }
+  for (size_t i = 0; i < txs; i++) {
+    fwrite(lines[i % TEMPLATES], 1, DMP_LINE_MIN_LENGTH, file);
+    fprintf(file, ",%d\n", SNAPSHOT_INDEX);
+  }
+
+  return fclose(file) == 0;
+}
+
+static void *import_chunks(void *arg) {
+  bench_t *const bench = (bench_t *)arg;
+  dmp_hasher_t *const hasher = (dmp_hasher_t *)malloc(sizeof(dmp_hasher_t));
+  dmp_tx_t *const txs = (dmp_tx_t *)malloc((CHUNK_TXS + BUNDLE_SIZE) * sizeof(dmp_tx_t));
+  char const *chunk = NULL;
+  size_t length = 0, txs_count = 0, count = 0, parsed = 0, valid = 0, bundles = 0;
+  retcode_t ret = RC_OK;
+
+  while (hasher != NULL && txs != NULL) {
+    lock_handle_lock(&bench->lock);
+    ret = dmp_reader_next_chunk(&bench->reader, CHUNK_TXS, &chunk, &length, &txs_count);
+    lock_handle_unlock(&bench->lock);
+    if (ret != RC_OK || length == 0 ||
+        (ret = dmp_chunk_parse(chunk, length, txs, CHUNK_TXS + BUNDLE_SIZE, &count)) != RC_OK) {
+      break;
+    }
+    parsed += count;
+    dmp_txs_verify(hasher, txs, count);
+    for (size_t i = 0, size = 0; i < count; i += size, bundles++) {
+      size = dmp_txs_bundle_size(&txs[i], count - i);
+    }
+    for (size_t i = 0; i < count; i++) {
+      valid += txs[i].valid;
+    }
+  }
+
+  lock_handle_lock(&bench->lock);
+  bench->parsed += parsed;
+  bench->valid += valid;
+  bench->bundles += bundles;
+  bench->failed |= ret != RC_OK || hasher == NULL || txs == NULL;
+  lock_handle_unlock(&bench->lock);
+  free(hasher);
+  free(txs);
+
+  return NULL;
+}
+
+int main(int argc, char **argv) {
+  size_t const txs = argc > 1 ? strtoul(argv[1], NULL, 10) : DEFAULT_TXS;
+  long const cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  size_t const threads_num = argc > 2 ? strtoul(argv[2], NULL, 10) : (cpus > 0 ? (size_t)cpus : 1);
+  char const *const path = argc > 3 ? argv[3] : DEFAULT_PATH;
+  thread_handle_t *threads = NULL;
+  bench_t bench = {.parsed = 0, .valid = 0, .bundles = 0, .failed = false};
+  struct timespec start;
+  double seconds = 0;
+
+  if (txs == 0 || threads_num == 0 ||
+      (threads = (thread_handle_t *)calloc(threads_num, sizeof(thread_handle_t))) == NULL) {
+    return EXIT_FAILURE;
+  }
+  if (!write_dump(path, txs)) {
+    fprintf(stderr, "Failed to write %s\n", path);
+    free(threads);
+    return EXIT_FAILURE;
+  }
+
+  lock_handle_init(&bench.lock);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (dmp_reader_open(&bench.reader, path) != RC_OK) {
+    fprintf(stderr, "Failed to open %s\n", path);
+    free(threads);
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < threads_num; i++) {
+    thread_handle_create(&threads[i], (thread_routine_t)import_chunks, &bench);
+  }
+  for (size_t i = 0; i < threads_num; i++) {
+    thread_handle_join(threads[i], NULL);
+  }
+  seconds = elapsed_s(&start);
+
+  printf("dump: %zu transactions, %.1f MB\n", txs, bench.reader.size / 1e6);
+  printf("threads: %zu\n", threads_num);
+  printf("parsed: %zu transactions in %zu bundles, %zu valid%s\n", bench.parsed, bench.bundles, bench.valid,
+         bench.failed ? " (failed)" : "");
+  printf("throughput: %.0f tx/s, %.1f MB/s\n", bench.parsed / seconds, bench.reader.size / 1e6 / seconds);
+
+  dmp_reader_close(&bench.reader);
+  lock_handle_destroy(&bench.lock);
+  remove(path);
+  free(threads);
+
+  return bench.failed || bench.valid != txs ? EXIT_FAILURE : EXIT_SUCCESS;
+}
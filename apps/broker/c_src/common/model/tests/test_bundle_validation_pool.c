@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <unity/unity.h>
+
+#include "common/helpers/sign.h"
+#include "common/model/bundle_validation_pool.h"
+#include "common/trinary/flex_trit.h"
+
+#define BUNDLES_NUM 4
+
+static tryte_t const *const SEED =
+    (tryte_t *)"ABCDEFGHIJKLMNOPQRSTUVWXYZ9ABCDEFGHIJKLMNOPQRSTUVWXYZ9ABCDEFGHIJKLMNOPQRSTUVWXYZ9";
+
+static bundle_transactions_t *bundles[BUNDLES_NUM];
+
+// Builds a bundle moving 100i from an input of the given security level to the next address of the seed
+static bundle_transactions_t *signed_bundle(uint64_t const key_index, uint8_t const security) {
+  bundle_transactions_t *bundle = NULL;
+  iota_transaction_t tx;
+  flex_trit_t seed[FLEX_TRIT_SIZE_243];
+  flex_trit_t *inp_address = NULL, *out_address = NULL;
+  input_t input = {.balance = 100, .key_index = key_index, .security = security};
+  inputs_t inputs = {};
+  Kerl kerl;
+
+  flex_trits_from_trytes(seed, NUM_TRITS_HASH, SEED, NUM_TRYTES_HASH, NUM_TRYTES_HASH);
+  inp_address = iota_sign_address_gen_flex_trits(seed, key_index, security);
+  out_address = iota_sign_address_gen_flex_trits(seed, key_index + 1, security);
+  TEST_ASSERT_NOT_NULL(inp_address);
+  TEST_ASSERT_NOT_NULL(out_address);
+  memcpy(input.address, inp_address, FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(inputs_append(&inputs, &input) == RC_OK);
+
+  bundle_transactions_new(&bundle);
+  transaction_reset(&tx);
+  transaction_set_timestamp(&tx, 1560000000 + key_index);
+  tx.loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
+
+  transaction_set_address(&tx, out_address);
+  transaction_set_value(&tx, 100);
+  bundle_transactions_add(bundle, &tx);
+  transaction_set_address(&tx, inp_address);
+  for (uint8_t i = 0; i < security; i++) {
+    transaction_set_value(&tx, i == 0 ? -100 : 0);
+    bundle_transactions_add(bundle, &tx);
+  }
+
+  TEST_ASSERT(bundle_sign(bundle, seed, &inputs, &kerl) == RC_OK);
+
+  inputs_clear(&inputs);
+  free(inp_address);
+  free(out_address);
+
+  return bundle;
+}
+
+static void test_statuses(size_t const threads_num) {
+  bundle_validation_pool_t pool;
+  bundle_status_t expected = BUNDLE_NOT_INITIALIZED;
+  bundle_status_t statuses[BUNDLES_NUM];
+
+  TEST_ASSERT(bundle_validation_pool_init(&pool, threads_num) == RC_OK);
+  TEST_ASSERT(bundle_validation_pool_validate(&pool, bundles, BUNDLES_NUM, statuses, NULL) == RC_OK);
+  for (size_t i = 0; i < BUNDLES_NUM; i++) {
+    TEST_ASSERT(bundle_validate(bundles[i], &expected) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(expected, statuses[i]);
+  }
+  TEST_ASSERT_EQUAL_INT(BUNDLE_VALID, statuses[0]);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_VALID, statuses[1]);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_VALID, statuses[2]);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_INVALID_SIGNATURE, statuses[3]);
+  TEST_ASSERT(bundle_validation_pool_destroy(&pool) == RC_OK);
+}
+
+void test_validate_no_thread(void) { test_statuses(0); }
+
+void test_validate_threads(void) { test_statuses(3); }
+
+// Serializes a bundle as the collector receives it, the trytes of its transactions one after the other
+static tryte_t *bundle_trytes(bundle_transactions_t *const bundle) {
+  size_t const size = bundle_transactions_size(bundle);
+  tryte_t *trytes = (tryte_t *)malloc(size * NUM_TRYTES_SERIALIZED_TRANSACTION);
+  flex_trit_t serialized[FLEX_TRIT_SIZE_8019];
+
+  TEST_ASSERT_NOT_NULL(trytes);
+  for (size_t i = 0; i < size; i++) {
+    TEST_ASSERT(transaction_serialize_on_flex_trits(bundle_at(bundle, i), serialized) != 0);
+    flex_trits_to_trytes(&trytes[i * NUM_TRYTES_SERIALIZED_TRANSACTION], NUM_TRYTES_SERIALIZED_TRANSACTION,
+                         serialized, NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRITS_SERIALIZED_TRANSACTION);
+  }
+
+  return trytes;
+}
+
+void test_transaction_view(void) {
+  tryte_t *trytes = bundle_trytes(bundles[1]);
+  size_t const size = bundle_transactions_size(bundles[1]);
+  bundle_view_t view;
+  iota_transaction_t *tx = NULL;
+  iota_transaction_view_t tx_view;
+  flex_trit_t field[FLEX_TRIT_SIZE_243];
+
+  TEST_ASSERT(bundle_view_init(&view, trytes, NUM_TRYTES_SERIALIZED_TRANSACTION - 1) == RC_INVALID_PARAM);
+  TEST_ASSERT(bundle_view_init(&view, trytes, size * NUM_TRYTES_SERIALIZED_TRANSACTION) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(size, view.size);
+
+  for (size_t i = 0; i < view.size; i++) {
+    tx = bundle_at(bundles[1], i);
+    tx_view = bundle_view_at(&view, i);
+    TEST_ASSERT_EQUAL_INT64(transaction_value(tx), transaction_view_value(tx_view));
+    TEST_ASSERT_EQUAL_UINT64(transaction_timestamp(tx), transaction_view_timestamp(tx_view));
+    TEST_ASSERT_EQUAL_UINT64(transaction_current_index(tx), transaction_view_current_index(tx_view));
+    TEST_ASSERT_EQUAL_UINT64(transaction_last_index(tx), transaction_view_last_index(tx_view));
+    flex_trits_from_trytes(field, NUM_TRITS_ADDRESS, transaction_view_address(tx_view), NUM_TRYTES_ADDRESS,
+                           NUM_TRYTES_ADDRESS);
+    TEST_ASSERT_EQUAL_MEMORY(transaction_address(tx), field, FLEX_TRIT_SIZE_243);
+    flex_trits_from_trytes(field, NUM_TRITS_BUNDLE, transaction_view_bundle(tx_view), NUM_TRYTES_BUNDLE,
+                           NUM_TRYTES_BUNDLE);
+    TEST_ASSERT_EQUAL_MEMORY(transaction_bundle(tx), field, FLEX_TRIT_SIZE_243);
+  }
+
+  free(trytes);
+}
+
+void test_validate_views(void) {
+  bundle_validation_pool_t pool;
+  bundle_view_t views[BUNDLES_NUM + 1];
+  tryte_t *trytes[BUNDLES_NUM];
+  bundle_status_t statuses[BUNDLES_NUM + 1];
+  bundle_status_t expected[BUNDLES_NUM];
+  bundle_validation_scratch_t scratch;
+
+  TEST_ASSERT(bundle_validation_pool_init(&pool, 2) == RC_OK);
+  TEST_ASSERT(bundle_validation_pool_validate(&pool, bundles, BUNDLES_NUM, expected, NULL) == RC_OK);
+  for (size_t i = 0; i < BUNDLES_NUM; i++) {
+    trytes[i] = bundle_trytes(bundles[i]);
+    TEST_ASSERT(bundle_view_init(&views[i], trytes[i],
+                                 bundle_transactions_size(bundles[i]) * NUM_TRYTES_SERIALIZED_TRANSACTION) == RC_OK);
+  }
+  TEST_ASSERT(bundle_view_init(&views[BUNDLES_NUM], NULL, 0) == RC_OK);
+
+  // The buffers of the first validation are reused by the next ones
+  bundle_validation_scratch_init(&scratch);
+  for (size_t round = 0; round < 2; round++) {
+    TEST_ASSERT(bundle_validation_pool_validate_views(&pool, views, BUNDLES_NUM + 1, statuses, &scratch) == RC_OK);
+    for (size_t i = 0; i < BUNDLES_NUM; i++) {
+      TEST_ASSERT_EQUAL_INT(expected[i], statuses[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(BUNDLE_EMPTY, statuses[BUNDLES_NUM]);
+    TEST_ASSERT_EQUAL_INT(2, scratch.grows);
+  }
+  TEST_ASSERT(bundle_validation_scratch_size(&scratch) > 0);
+
+  // Incomplete bundle
+  views[1].size--;
+  TEST_ASSERT(bundle_validation_pool_validate_views(&pool, &views[1], 1, statuses, &scratch) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_INCOMPLETE, statuses[0]);
+  TEST_ASSERT_EQUAL_INT(2, scratch.grows);
+
+  bundle_validation_scratch_destroy(&scratch);
+  TEST_ASSERT_EQUAL_INT(0, bundle_validation_scratch_size(&scratch));
+  TEST_ASSERT(bundle_validation_pool_destroy(&pool) == RC_OK);
+  for (size_t i = 0; i < BUNDLES_NUM; i++) {
+    free(trytes[i]);
+  }
+}
+
+void test_validate_empty(void) {
+  bundle_validation_pool_t pool;
+  bundle_transactions_t *empty[2] = {NULL, NULL};
+  bundle_status_t statuses[2];
+
+  bundle_transactions_new(&empty[1]);
+  TEST_ASSERT(bundle_validation_pool_init(&pool, 2) == RC_OK);
+  TEST_ASSERT(bundle_validation_pool_validate(&pool, empty, 2, statuses, NULL) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_NOT_INITIALIZED, statuses[0]);
+  TEST_ASSERT_EQUAL_INT(BUNDLE_EMPTY, statuses[1]);
+  TEST_ASSERT(bundle_validation_pool_destroy(&pool) == RC_OK);
+  bundle_transactions_free(&empty[1]);
+}
+
+int main(void) {
+  trit_t trit = 0;
+  iota_transaction_t *tx = NULL;
+
+  UNITY_BEGIN();
+
+  bundles[0] = signed_bundle(0, 1);
+  bundles[1] = signed_bundle(2, 2);
+  bundles[2] = signed_bundle(4, 3);
+  // Same as the second one with a tampered signature fragment
+  bundles[3] = signed_bundle(2, 2);
+  tx = bundle_at(bundles[3], 2);
+  trit = flex_trits_at(transaction_signature(tx), NUM_TRITS_SIGNATURE, 42);
+  flex_trits_set_at(transaction_signature(tx), NUM_TRITS_SIGNATURE, 42, trit == 1 ? 0 : trit + 1);
+
+  RUN_TEST(test_validate_no_thread);
+  RUN_TEST(test_validate_threads);
+  RUN_TEST(test_validate_empty);
+  RUN_TEST(test_transaction_view);
+  RUN_TEST(test_validate_views);
+
+  for (size_t i = 0; i < BUNDLES_NUM; i++) {
+    bundle_transactions_free(&bundles[i]);
+  }
+
+  return UNITY_END();
+}
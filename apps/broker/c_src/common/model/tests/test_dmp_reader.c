@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity/unity.h>
+
+#include "common/crypto/curl-p/digest.h"
+#include "common/model/dmp_reader.h"
+#include "common/trinary/trit_tryte.h"
+#include "common/trinary/tryte_long.h"
+
+#define BUNDLES_NUM 4
+#define TXS_NUM 7
+#define LINE_MAX_LENGTH (DMP_LINE_MIN_LENGTH + 16)
+
+static size_t const BUNDLE_SIZES[BUNDLES_NUM] = {1, 3, 2, 1};
+static char dump[TXS_NUM * LINE_MAX_LENGTH];
+static size_t dump_size = 0;
+
+static void set_index(tryte_t *const field, int64_t const index) {
+  memset(field, '9', NUM_TRYTES_CURRENT_INDEX);
+  long_to_trytes(index, field);
+}
+
+// Appends a line with a pseudo random transaction, the snapshot index is skipped when negative
+static void append_line(size_t const current_index, size_t const last_index, int64_t const snapshot_index) {
+  char *const line = dump + dump_size;
+  tryte_t *const trytes = (tryte_t *)line + DMP_LINE_OFFSET_TRYTES;
+  trit_t trits[NUM_TRITS_SERIALIZED_TRANSACTION];
+  trit_t hash[NUM_TRITS_HASH];
+  Curl curl;
+
+  for (size_t i = 0; i < NUM_TRYTES_SERIALIZED_TRANSACTION; i++) {
+    trytes[i] = TRYTE_ALPHABET[rand() % TRYTE_SPACE_SIZE];
+  }
+  set_index(&trytes[TRANSACTION_VIEW_OFFSET_CURRENT_INDEX], current_index);
+  set_index(&trytes[TRANSACTION_VIEW_OFFSET_LAST_INDEX], last_index);
+
+  curl_init(&curl);
+  curl.type = CURL_P_81;
+  trytes_to_trits(trytes, trits, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  curl_digest(trits, NUM_TRITS_SERIALIZED_TRANSACTION, hash, &curl);
+  trits_to_trytes(hash, (tryte_t *)line, NUM_TRITS_HASH);
+  line[NUM_TRYTES_HASH] = ',';
+
+  dump_size += DMP_LINE_MIN_LENGTH;
+  if (snapshot_index >= 0) {
+    dump_size += sprintf(dump + dump_size, ",%ld", (long)snapshot_index);
+  }
+  dump[dump_size++] = '\n';
+}
+
+void test_chunks(void) {
+  dmp_reader_t reader;
+  char const *chunk = NULL;
+  size_t length = 0, txs_count = 0;
+
+  dmp_reader_init(&reader, dump, dump_size);
+
+  // Whole bundles only, even when max_txs falls in the middle of one
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 2, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_PTR(dump, chunk);
+  TEST_ASSERT_EQUAL_INT(4, txs_count);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 1, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, txs_count);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, txs_count);
+  TEST_ASSERT_EQUAL_PTR(dump + dump_size, chunk + length);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, length);
+  TEST_ASSERT_EQUAL_INT(0, txs_count);
+}
+
+void test_parse_and_verify(void) {
+  dmp_reader_t reader;
+  dmp_tx_t txs[TXS_NUM];
+  dmp_hasher_t *hasher = (dmp_hasher_t *)malloc(sizeof(dmp_hasher_t));
+  char const *chunk = NULL;
+  size_t length = 0, txs_count = 0, count = 0, bundle = 0;
+  char *tampered = NULL;
+
+  TEST_ASSERT_NOT_NULL(hasher);
+  dmp_reader_init(&reader, dump, dump_size);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, TXS_NUM, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TXS_NUM, txs_count);
+
+  TEST_ASSERT(dmp_chunk_parse(chunk, length, txs, TXS_NUM - 1, &count) == RC_INVALID_PARAM);
+  TEST_ASSERT(dmp_chunk_parse(chunk, length, txs, TXS_NUM, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TXS_NUM, count);
+  TEST_ASSERT_EQUAL_INT64(-1, txs[0].snapshot_index);
+  TEST_ASSERT_EQUAL_INT64(1234, txs[1].snapshot_index);
+
+  // Tampers the trytes of the 4th transaction
+  tampered = (char *)txs[3].tx.trytes + 5;
+  *tampered = *tampered == 'A' ? 'B' : 'A';
+  dmp_txs_verify(hasher, txs, count);
+  *tampered = *tampered == 'A' ? 'B' : 'A';
+  for (size_t i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL(i != 3, txs[i].valid);
+  }
+
+  for (size_t b = 0, i = 0; b < BUNDLES_NUM; b++, i += bundle) {
+    bundle = dmp_txs_bundle_size(&txs[i], count - i);
+    TEST_ASSERT_EQUAL_INT(BUNDLE_SIZES[b], bundle);
+  }
+
+  free(hasher);
+}
+
+void test_malformed(void) {
+  dmp_reader_t reader;
+  char const *chunk = NULL;
+  size_t length = 0, txs_count = 0;
+  // First digit of the snapshot index of the second line
+  size_t const digit = DMP_LINE_MIN_LENGTH + 1 + DMP_LINE_MIN_LENGTH + 1;
+  char saved = dump[digit];
+
+  // The chunk stops before the malformed line, which then fails
+  dump[digit] = 'X';
+  dmp_reader_init(&reader, dump, dump_size);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, txs_count);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_INVALID_PARAM);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_INVALID_PARAM);
+  dump[digit] = saved;
+}
+
+void test_malformed_separator(void) {
+  dmp_reader_t reader;
+  char const *chunk = NULL;
+  size_t length = 0, txs_count = 0;
+  // Separator between the hash and the trytes of the second line
+  size_t const separator = DMP_LINE_MIN_LENGTH + 1 + NUM_TRYTES_HASH;
+  char saved = dump[separator];
+
+  dump[separator] = 'A';
+  dmp_reader_init(&reader, dump, dump_size);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, txs_count);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, 100, &chunk, &length, &txs_count) == RC_INVALID_PARAM);
+  dump[separator] = saved;
+}
+
+void test_open(void) {
+  dmp_reader_t reader;
+  char path[] = "/tmp/test_dmp_reader_XXXXXX";
+  int fd = mkstemp(path);
+  FILE *file = NULL;
+  char const *chunk = NULL;
+  size_t length = 0, txs_count = 0;
+
+  TEST_ASSERT(fd >= 0);
+  TEST_ASSERT_NOT_NULL(file = fdopen(fd, "w"));
+  TEST_ASSERT_EQUAL_INT(dump_size, fwrite(dump, 1, dump_size, file));
+  fclose(file);
+
+  TEST_ASSERT(dmp_reader_open(&reader, "/nonexistent/dump.dmp") == RC_UTILS_FAILED_TO_OPEN_FILE);
+  TEST_ASSERT(dmp_reader_open(&reader, path) == RC_OK);
+  TEST_ASSERT(dmp_reader_next_chunk(&reader, TXS_NUM, &chunk, &length, &txs_count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(TXS_NUM, txs_count);
+  TEST_ASSERT_EQUAL_MEMORY(dump, chunk, dump_size);
+  TEST_ASSERT(dmp_reader_close(&reader) == RC_OK);
+  remove(path);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  srand(42);
+  for (size_t b = 0; b < BUNDLES_NUM; b++) {
+    for (size_t i = 0; i < BUNDLE_SIZES[b]; i++) {
+      append_line(i, BUNDLE_SIZES[b] - 1, b == 0 ? -1 : 1234);
+    }
+  }
+  // The last line has no end of line
+  dump_size--;
+
+  RUN_TEST(test_chunks);
+  RUN_TEST(test_parse_and_verify);
+  RUN_TEST(test_malformed);
+  RUN_TEST(test_malformed_separator);
+  RUN_TEST(test_open);
+
+  return UNITY_END();
+}
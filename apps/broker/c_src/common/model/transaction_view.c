@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "common/model/transaction_view.h"
+
+int64_t transaction_view_long(tryte_t const *const trytes, size_t const length) {
+  // Unsigned so that malformed fields wrap around instead of overflowing
+  uint64_t value = 0;
+  int64_t tryte = 0;
+
+  for (size_t i = length; i-- > 0;) {
+    tryte = INDEX_OF_TRYTE(trytes[i]);
+    if (tryte > TRYTE_VALUE_MAX) {
+      tryte -= TRYTE_SPACE_SIZE;
+    }
+    value = value * TRYTE_SPACE_SIZE + (uint64_t)tryte;
+  }
+
+  return (int64_t)value;
+}
+
+retcode_t bundle_view_init(bundle_view_t *const bundle, tryte_t const *const trytes, size_t const length) {
+  if (bundle == NULL || (trytes == NULL && length > 0)) {
+    return RC_NULL_PARAM;
+  }
+
+  if (length % NUM_TRYTES_SERIALIZED_TRANSACTION != 0) {
+    return RC_INVALID_PARAM;
+  }
+
+  bundle->trytes = trytes;
+  bundle->size = length / NUM_TRYTES_SERIALIZED_TRANSACTION;
+
+  return RC_OK;
+}
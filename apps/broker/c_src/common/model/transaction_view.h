@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup common_model
+ *
+ * @{
+ *
+ * @file
+ * @brief Read-only views over serialized transaction trytes.
+ *
+ * A view does not own nor copy the trytes, fields are located in place and numeric fields are only decoded when
+ * they are read.
+ *
+ */
+#ifndef __COMMON_MODEL_TRANSACTION_VIEW_H__
+#define __COMMON_MODEL_TRANSACTION_VIEW_H__
+
+#include <stddef.h>
+
+#include "common/defs.h"
+#include "common/errors.h"
+#include "common/model/transaction.h"
+#include "common/trinary/tryte.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TRANSACTION_VIEW_OFFSET_SIGNATURE 0
+#define TRANSACTION_VIEW_OFFSET_ADDRESS (TRANSACTION_VIEW_OFFSET_SIGNATURE + NUM_TRYTES_SIGNATURE)
+#define TRANSACTION_VIEW_OFFSET_VALUE (TRANSACTION_VIEW_OFFSET_ADDRESS + NUM_TRYTES_ADDRESS)
+#define TRANSACTION_VIEW_OFFSET_OBSOLETE_TAG (TRANSACTION_VIEW_OFFSET_VALUE + NUM_TRYTES_VALUE)
+#define TRANSACTION_VIEW_OFFSET_TIMESTAMP (TRANSACTION_VIEW_OFFSET_OBSOLETE_TAG + NUM_TRYTES_OBSOLETE_TAG)
+#define TRANSACTION_VIEW_OFFSET_CURRENT_INDEX (TRANSACTION_VIEW_OFFSET_TIMESTAMP + NUM_TRYTES_TIMESTAMP)
+#define TRANSACTION_VIEW_OFFSET_LAST_INDEX (TRANSACTION_VIEW_OFFSET_CURRENT_INDEX + NUM_TRYTES_CURRENT_INDEX)
+#define TRANSACTION_VIEW_OFFSET_BUNDLE (TRANSACTION_VIEW_OFFSET_LAST_INDEX + NUM_TRYTES_LAST_INDEX)
+#define TRANSACTION_VIEW_OFFSET_TRUNK (TRANSACTION_VIEW_OFFSET_BUNDLE + NUM_TRYTES_BUNDLE)
+#define TRANSACTION_VIEW_OFFSET_BRANCH (TRANSACTION_VIEW_OFFSET_TRUNK + NUM_TRYTES_TRUNK)
+#define TRANSACTION_VIEW_OFFSET_TAG (TRANSACTION_VIEW_OFFSET_BRANCH + NUM_TRYTES_BRANCH)
+#define TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP (TRANSACTION_VIEW_OFFSET_TAG + NUM_TRYTES_TAG)
+#define TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_LOWER \
+  (TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP + NUM_TRYTES_ATTACHMENT_TIMESTAMP)
+#define TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_UPPER \
+  (TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_LOWER + NUM_TRYTES_ATTACHMENT_TIMESTAMP_LOWER)
+#define TRANSACTION_VIEW_OFFSET_NONCE \
+  (TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_UPPER + NUM_TRYTES_ATTACHMENT_TIMESTAMP_UPPER)
+
+// The essence (address, value, obsolete tag, timestamp, current and last indexes) is contiguous
+#define TRANSACTION_VIEW_OFFSET_ESSENCE TRANSACTION_VIEW_OFFSET_ADDRESS
+#define NUM_TRYTES_ESSENCE (NUM_TRITS_ESSENCE / NUMBER_OF_TRITS_IN_A_TRYTE)
+
+/**
+ * @brief A transaction read in place from its NUM_TRYTES_SERIALIZED_TRANSACTION serialized trytes.
+ */
+typedef struct iota_transaction_view_s {
+  tryte_t const *trytes;
+} iota_transaction_view_t;
+
+/**
+ * @brief A bundle read in place from the serialized trytes of its transactions, laid out one after the other.
+ */
+typedef struct bundle_view_s {
+  tryte_t const *trytes;
+  size_t size;  // Number of transactions
+} bundle_view_t;
+
+/**
+ * @brief Decodes a numeric field.
+ *
+ * @param[in] trytes The trytes of the field.
+ * @param[in] length The number of trytes of the field.
+ * @return The value, with the same wrap around as trits_to_long() on malformed fields.
+ */
+int64_t transaction_view_long(tryte_t const *const trytes, size_t const length);
+
+/**
+ * @brief Initializes a bundle view.
+ *
+ * @param[out] bundle The view.
+ * @param[in] trytes The serialized transactions, must outlive the view.
+ * @param[in] length The number of trytes, a multiple of NUM_TRYTES_SERIALIZED_TRANSACTION.
+ * @return #retcode_t
+ */
+retcode_t bundle_view_init(bundle_view_t *const bundle, tryte_t const *const trytes, size_t const length);
+
+static inline iota_transaction_view_t bundle_view_at(bundle_view_t const *const bundle, size_t const index) {
+  iota_transaction_view_t tx = {&bundle->trytes[index * NUM_TRYTES_SERIALIZED_TRANSACTION]};
+  return tx;
+}
+
+static inline tryte_t const *transaction_view_signature(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_SIGNATURE];
+}
+
+static inline tryte_t const *transaction_view_address(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_ADDRESS];
+}
+
+static inline int64_t transaction_view_value(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_VALUE], NUM_TRYTES_VALUE);
+}
+
+static inline tryte_t const *transaction_view_obsolete_tag(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_OBSOLETE_TAG];
+}
+
+static inline uint64_t transaction_view_timestamp(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_TIMESTAMP], NUM_TRYTES_TIMESTAMP);
+}
+
+static inline uint64_t transaction_view_current_index(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_CURRENT_INDEX], NUM_TRYTES_CURRENT_INDEX);
+}
+
+static inline uint64_t transaction_view_last_index(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_LAST_INDEX], NUM_TRYTES_LAST_INDEX);
+}
+
+static inline tryte_t const *transaction_view_bundle(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_BUNDLE];
+}
+
+static inline tryte_t const *transaction_view_trunk(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_TRUNK];
+}
+
+static inline tryte_t const *transaction_view_branch(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_BRANCH];
+}
+
+static inline tryte_t const *transaction_view_tag(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_TAG];
+}
+
+static inline uint64_t transaction_view_attachment_timestamp(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP],
+                               NUM_TRYTES_ATTACHMENT_TIMESTAMP);
+}
+
+static inline uint64_t transaction_view_attachment_timestamp_lower(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_LOWER],
+                               NUM_TRYTES_ATTACHMENT_TIMESTAMP_LOWER);
+}
+
+static inline uint64_t transaction_view_attachment_timestamp_upper(iota_transaction_view_t const tx) {
+  return transaction_view_long(&tx.trytes[TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_UPPER],
+                               NUM_TRYTES_ATTACHMENT_TIMESTAMP_UPPER);
+}
+
+static inline tryte_t const *transaction_view_nonce(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_NONCE];
+}
+
+static inline tryte_t const *transaction_view_essence(iota_transaction_view_t const tx) {
+  return &tx.trytes[TRANSACTION_VIEW_OFFSET_ESSENCE];
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_MODEL_TRANSACTION_VIEW_H__
+
+/** @} */
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_BACKEND_H__
+#define __COMMON_STORAGE_BACKEND_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/storage/connection.h"
+#include "common/storage/storage.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Operations of a storage backend, the functions of storage.h and connection.h dispatch to the backend of the
+ * connection they are given. See storage.h for their description.
+ */
+struct storage_backend_s {
+  char const* name;
+
+  retcode_t (*init)();
+  retcode_t (*destroy)();
+
+  /*
+   * Connection operations
+   */
+
+  retcode_t (*connection_init)(storage_connection_t* const connection, connection_config_t const* const config,
+                               storage_connection_type_t const type);
+  retcode_t (*connection_destroy)(storage_connection_t* const connection);
+  retcode_t (*connection_flush)(storage_connection_t const* const connection);
+  uint64_t (*connection_pending_batch)(storage_connection_t const* const connection);
+
+  /*
+   * Transaction operations
+   */
+
+  retcode_t (*transaction_count)(storage_connection_t const* const connection, size_t* const count);
+  retcode_t (*transaction_store)(storage_connection_t const* const connection, iota_transaction_t const* const data_in);
+  retcode_t (*transaction_load)(storage_connection_t const* const connection, transaction_field_t const field,
+                                flex_trit_t const* const key, iota_stor_pack_t* const pack);
+  retcode_t (*transaction_load_essence_and_metadata)(storage_connection_t const* const connection,
+                                                     flex_trit_t const* const hash, iota_stor_pack_t* const pack);
+  retcode_t (*transaction_load_essence_attachment_and_metadata)(storage_connection_t const* const connection,
+                                                                flex_trit_t const* const hash,
+                                                                iota_stor_pack_t* const pack);
+  retcode_t (*transaction_load_essence_and_consensus)(storage_connection_t const* const connection,
+                                                      flex_trit_t const* const hash, iota_stor_pack_t* const pack);
+  retcode_t (*transaction_load_metadata)(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                         iota_stor_pack_t* const pack);
+  retcode_t (*transaction_exist)(storage_connection_t const* const connection, transaction_field_t const field,
+                                 flex_trit_t const* const key, bool* const exist);
+  retcode_t (*transaction_update_snapshot_index)(storage_connection_t const* const connection,
+                                                 flex_trit_t const* const hash, uint64_t const snapshot_index);
+  retcode_t (*transactions_update_snapshot_index)(storage_connection_t const* const connection,
+                                                  hash243_set_t const hashes, uint64_t const snapshot_index);
+  retcode_t (*transaction_update_solid_state)(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, bool const is_solid);
+  retcode_t (*transactions_update_solid_state)(storage_connection_t const* const connection,
+                                               hash243_set_t const hashes, bool const is_solid);
+  retcode_t (*transaction_load_hashes)(storage_connection_t const* const connection, transaction_field_t const field,
+                                       flex_trit_t const* const key, iota_stor_pack_t* const pack);
+  retcode_t (*transaction_load_hashes_of_approvers)(storage_connection_t const* const connection,
+                                                    flex_trit_t const* const approvee_hash,
+                                                    iota_stor_pack_t* const pack, int64_t before_timestamp);
+  retcode_t (*transaction_load_hashes_of_milestone_candidates)(storage_connection_t const* const connection,
+                                                               iota_stor_pack_t* const pack,
+                                                               flex_trit_t const* const coordinator);
+  retcode_t (*transaction_approvers_count)(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                           size_t* const count);
+  retcode_t (*transaction_find)(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                hash243_queue_t const addresses, hash81_queue_t const tags,
+                                hash243_queue_t const approvees, iota_stor_pack_t* const pack);
+  retcode_t (*cursor_next)(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                           iota_stor_pack_t* const batch);
+  retcode_t (*transaction_metadata_clear)(storage_connection_t const* const connection);
+  retcode_t (*transactions_delete)(storage_connection_t const* const connection, hash243_set_t const hashes);
+
+  /*
+   * Bundle operations
+   */
+
+  retcode_t (*bundle_update_validity)(storage_connection_t const* const connection,
+                                      bundle_transactions_t const* const bundle, bundle_status_t const status);
+
+  /*
+   * Milestone operations
+   */
+
+  retcode_t (*milestone_clear)(storage_connection_t const* const connection);
+  retcode_t (*milestone_store)(storage_connection_t const* const connection, iota_milestone_t const* const data_in);
+  retcode_t (*milestone_load)(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                              iota_stor_pack_t* const pack);
+  retcode_t (*milestone_load_last)(storage_connection_t const* const connection, iota_stor_pack_t* const pack);
+  retcode_t (*milestone_load_first)(storage_connection_t const* const connection, iota_stor_pack_t* const pack);
+  retcode_t (*milestone_load_by_index)(storage_connection_t const* const connection, uint64_t const index,
+                                       iota_stor_pack_t* const pack);
+  retcode_t (*milestone_load_next)(storage_connection_t const* const connection, uint64_t const index,
+                                   iota_stor_pack_t* const pack);
+  retcode_t (*milestone_exist)(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                               bool* const exist);
+  retcode_t (*milestone_delete)(storage_connection_t const* const connection, flex_trit_t const* const hash);
+
+  /*
+   * State delta operations
+   */
+
+  retcode_t (*state_delta_store)(storage_connection_t const* const connection, uint64_t const index,
+                                 state_delta_t const* const delta);
+  retcode_t (*state_delta_load)(storage_connection_t const* const connection, uint64_t const index,
+                                state_delta_t* const delta);
+
+  /*
+   * Spent address operations
+   */
+
+  retcode_t (*spent_address_store)(storage_connection_t const* const connection, flex_trit_t const* const address);
+  retcode_t (*spent_addresses_store)(storage_connection_t const* const connection, hash243_set_t const addresses);
+  retcode_t (*spent_address_exist)(storage_connection_t const* const connection, flex_trit_t const* const address,
+                                   bool* const exist);
+};
+
+// Backends linked in, selected by storage_backend_type_t
+extern storage_backend_t const sqlite3_storage_backend;
+extern storage_backend_t const kv_storage_backend;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_BACKEND_H__
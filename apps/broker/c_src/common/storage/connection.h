@@ -8,6 +8,10 @@
 #ifndef __COMMON_STORAGE_CONNECTION_H__
 #define __COMMON_STORAGE_CONNECTION_H__
 
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
 #include "common/errors.h"
 
 #ifdef __cplusplus
@@ -19,19 +23,82 @@ typedef enum storage_connection_type_e {
   STORAGE_CONNECTION_SPENT_ADDRESSES,
 } storage_connection_type_t;
 
+// Implementations of the storage operations, a connection is opened to a database of one of them
+typedef enum storage_backend_type_e {
+  STORAGE_BACKEND_SQLITE3,  // Relational tables, the transactions indexed by their fields
+  STORAGE_BACKEND_KV,       // Column families of an LMDB key-value store, the transactions indexed by prefix keys
+  STORAGE_BACKEND_COUNT,
+} storage_backend_type_t;
+
+typedef struct storage_backend_s storage_backend_t;
+
 typedef struct storage_connection_s {
   void* actual;
   storage_connection_type_t type;
+  storage_backend_t const* backend;
 } storage_connection_t;
 
+typedef enum storage_durability_e {
+  STORAGE_DURABILITY_FULL,    // Commits are durable, even across a power loss
+  STORAGE_DURABILITY_NORMAL,  // Commits survive a crash of the process but the last ones may roll back on power loss
+  STORAGE_DURABILITY_OFF,     // Commits are handed to the operating system without waiting for the disk
+} storage_durability_t;
+
+typedef enum storage_temp_store_e {
+  STORAGE_TEMP_STORE_DEFAULT,  // As the database library was built
+  STORAGE_TEMP_STORE_FILE,     // Temporary tables and indices are kept in files
+  STORAGE_TEMP_STORE_MEMORY,   // Temporary tables and indices are kept in memory
+} storage_temp_store_t;
+
 typedef struct connection_config_t {
   char const* db_path;
+  storage_backend_type_t backend;
+  // The connection only reads, it never holds a write lock on the database
+  bool read_only;
+  storage_durability_t durability;
+  // Writes are group-committed in a single transaction of up to write_batch_size rows, committed after at most
+  // write_batch_timeout_ms. A size of 0 or 1 commits every write on its own.
+  size_t write_batch_size;
+  uint64_t write_batch_timeout_ms;
+  // Memory sizing of the connection, 0 keeps the defaults of the database library
+  size_t cache_size_kb;  // Page cache
+  size_t mmap_size_mb;   // Part of the database file mapped in memory
+  storage_temp_store_t temp_store;
+  // Number of pages the write-ahead log grows to before being checkpointed, 0 keeps the default
+  size_t wal_autocheckpoint;
 } connection_config_t;
 
+/**
+ * Opens a connection to a database through the backend of the configuration
+ *
+ * @param connection The connection
+ * @param config The configuration of the connection
+ * @param type The type of the connection
+ *
+ * @return a status code
+ */
 extern retcode_t connection_init(storage_connection_t* const connection, connection_config_t const* const config,
                                  storage_connection_type_t const type);
 extern retcode_t connection_destroy(storage_connection_t* const connection);
 
+/**
+ * Commits the writes group-committed so far, making them visible to the other connections
+ *
+ * @param connection The connection
+ *
+ * @return a status code
+ */
+extern retcode_t connection_flush(storage_connection_t const* const connection);
+
+/**
+ * Identifies the group commit pending on a connection, so that a writer can tell whether its writes are committed
+ *
+ * @param connection The connection
+ *
+ * @return an identifier of the group commit pending, 0 if none is
+ */
+extern uint64_t connection_pending_batch(storage_connection_t const* const connection);
+
 #ifdef __cplusplus
 }
 #endif
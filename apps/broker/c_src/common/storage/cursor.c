@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+
+#include "common/storage/cursor.h"
+
+static void cursor_init(storage_cursor_t* const cursor, storage_cursor_type_t const type,
+                        storage_cursor_model_t const model, flex_trit_t const* const key) {
+  memset(cursor, 0, sizeof(storage_cursor_t));
+  cursor->type = type;
+  cursor->model = model;
+  if (key != NULL) {
+    memcpy(cursor->key, key, FLEX_TRIT_SIZE_243);
+  }
+}
+
+void storage_cursor_init_hashes_by_address(storage_cursor_t* const cursor, storage_cursor_model_t const model,
+                                           flex_trit_t const* const address) {
+  cursor_init(cursor, STORAGE_CURSOR_HASHES_BY_ADDRESS, model, address);
+}
+
+void storage_cursor_init_hashes_of_approvers(storage_cursor_t* const cursor, storage_cursor_model_t const model,
+                                             flex_trit_t const* const approvee, int64_t const before_timestamp) {
+  cursor_init(cursor, STORAGE_CURSOR_HASHES_OF_APPROVERS, model, approvee);
+  cursor->before_timestamp = before_timestamp;
+}
+
+void storage_cursor_init_hashes_of_milestone_candidates(storage_cursor_t* const cursor,
+                                                        storage_cursor_model_t const model,
+                                                        flex_trit_t const* const coordinator) {
+  cursor_init(cursor, STORAGE_CURSOR_HASHES_OF_MILESTONE_CANDIDATES, model, coordinator);
+}
+
+void storage_cursor_init_find(storage_cursor_t* const cursor, storage_cursor_model_t const model,
+                              hash243_queue_t const bundles, hash243_queue_t const addresses, hash81_queue_t const tags,
+                              hash243_queue_t const approvees) {
+  cursor_init(cursor, STORAGE_CURSOR_FIND, model, NULL);
+  cursor->bundles = bundles;
+  cursor->addresses = addresses;
+  cursor->tags = tags;
+  cursor->approvees = approvees;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_CURSOR_H__
+#define __COMMON_STORAGE_CURSOR_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "common/trinary/bytes.h"
+#include "common/trinary/flex_trit.h"
+#include "utils/containers/hash/hash243_queue.h"
+#include "utils/containers/hash/hash81_queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Room for the position of any backend
+#define STORAGE_CURSOR_POSITION_SIZE 64
+
+typedef enum storage_cursor_type_e {
+  STORAGE_CURSOR_HASHES_BY_ADDRESS,
+  STORAGE_CURSOR_HASHES_OF_APPROVERS,
+  STORAGE_CURSOR_HASHES_OF_MILESTONE_CANDIDATES,
+  STORAGE_CURSOR_FIND,
+} storage_cursor_type_t;
+
+typedef enum storage_cursor_model_e {
+  STORAGE_CURSOR_MODEL_HASH,              // Models are flex_trit_t[FLEX_TRIT_SIZE_243]
+  STORAGE_CURSOR_MODEL_ESSENCE_METADATA,  // Models are iota_transaction_t, their hash included
+} storage_cursor_model_t;
+
+/**
+ * Walks the transactions selected by a query in batches, see storage_cursor_next.
+ *
+ * A cursor holds no connection nor statement: each batch is a bounded query resuming after the position where the
+ * previous one stopped, so that a batch can be read through any connection of the database and writes are not held
+ * back between batches. Transactions stored or deleted during the walk may or may not be returned.
+ */
+typedef struct storage_cursor_s {
+  storage_cursor_type_t type;
+  storage_cursor_model_t model;
+  flex_trit_t key[FLEX_TRIT_SIZE_243];  // Address, approvee or coordinator
+  int64_t before_timestamp;             // Only the approvers arrived earlier, 0 for all
+  // Lists of a find, not owned by the cursor
+  hash243_queue_t bundles;
+  hash243_queue_t addresses;
+  hash81_queue_t tags;
+  hash243_queue_t approvees;
+  // Where the next batch resumes, set by the backend
+  byte_t position[STORAGE_CURSOR_POSITION_SIZE];
+  size_t position_size;
+  bool done;
+} storage_cursor_t;
+
+/**
+ * Initializes a cursor on the transactions of an address
+ *
+ * @param cursor The cursor
+ * @param model The model loaded for each transaction
+ * @param address The address
+ */
+void storage_cursor_init_hashes_by_address(storage_cursor_t* const cursor, storage_cursor_model_t const model,
+                                           flex_trit_t const* const address);
+
+/**
+ * Initializes a cursor on the approvers of a transaction
+ *
+ * @param cursor The cursor
+ * @param model The model loaded for each transaction
+ * @param approvee The hash of the approved transaction
+ * @param before_timestamp Only the approvers arrived before this timestamp, 0 for all
+ */
+void storage_cursor_init_hashes_of_approvers(storage_cursor_t* const cursor, storage_cursor_model_t const model,
+                                             flex_trit_t const* const approvee, int64_t const before_timestamp);
+
+/**
+ * Initializes a cursor on the tails sent from the coordinator address that are not yet known as milestones
+ *
+ * @param cursor The cursor
+ * @param model The model loaded for each transaction
+ * @param coordinator The coordinator address
+ */
+void storage_cursor_init_hashes_of_milestone_candidates(storage_cursor_t* const cursor,
+                                                        storage_cursor_model_t const model,
+                                                        flex_trit_t const* const coordinator);
+
+/**
+ * Initializes a cursor on the transactions matching any field of every non empty list
+ *
+ * @param cursor The cursor
+ * @param model The model loaded for each transaction
+ * @param bundles Bundles, must outlive the cursor
+ * @param addresses Addresses, must outlive the cursor
+ * @param tags Tags, must outlive the cursor
+ * @param approvees Approvees, must outlive the cursor
+ */
+void storage_cursor_init_find(storage_cursor_t* const cursor, storage_cursor_model_t const model,
+                              hash243_queue_t const bundles, hash243_queue_t const addresses, hash81_queue_t const tags,
+                              hash243_queue_t const approvees);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_CURSOR_H__
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_GROUP_COMMIT_H__
+#define __COMMON_STORAGE_GROUP_COMMIT_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/storage/connection.h"
+#include "utils/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Bookkeeping of the group commit of the writes of a connection, the policy deciding when to commit being shared. A
+ * backend commits the group itself and reports it here: the sqlite3 one holds a database transaction open across the
+ * group, the LMDB one commits every write and syncs the file once at the end of the group.
+ */
+typedef struct storage_group_commit_s {
+  size_t size;  // Rows committed together, group commit is disabled below 2
+  uint64_t timeout_us;
+  bool open;
+  uint64_t id;  // Identifier of the open transaction, increasing
+  size_t rows;
+  uint64_t begin_us;
+} storage_group_commit_t;
+
+static inline void storage_group_commit_init(storage_group_commit_t *const group,
+                                             connection_config_t const *const config) {
+  group->size = config->write_batch_size;
+  group->timeout_us = config->write_batch_timeout_ms * 1000;
+  group->open = false;
+  group->id = 0;
+  group->rows = 0;
+  group->begin_us = 0;
+}
+
+/**
+ * Tells whether a write has to begin a transaction before joining the group commit
+ */
+static inline bool storage_group_commit_needs_begin(storage_group_commit_t const *const group) {
+  return group->size >= 2 && !group->open;
+}
+
+/**
+ * Records that the transaction of a group commit began
+ */
+static inline void storage_group_commit_begun(storage_group_commit_t *const group) {
+  group->open = true;
+  group->id++;
+  group->rows = 0;
+  group->begin_us = monotonic_timestamp_us();
+}
+
+/**
+ * Counts the rows of a write that joined a group commit
+ *
+ * @return whether the group commit is full or expired and has to be committed
+ */
+static inline bool storage_group_commit_add(storage_group_commit_t *const group, size_t const rows) {
+  group->rows += rows;
+  return group->rows >= group->size || monotonic_timestamp_us() - group->begin_us >= group->timeout_us;
+}
+
+/**
+ * Records that the transaction of a group commit is over, committed or rolled back
+ */
+static inline void storage_group_commit_ended(storage_group_commit_t *const group) {
+  group->open = false;
+  group->rows = 0;
+}
+
+/**
+ * Identifies the group commit pending, see connection_pending_batch()
+ */
+static inline uint64_t storage_group_commit_pending(storage_group_commit_t const *const group) {
+  return group->open ? group->id : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_GROUP_COMMIT_H__
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+
+#include "common/storage/kv/connection.h"
+#include "utils/logger_helper.h"
+
+#define KV_LOGGER_ID "kv"
+
+static logger_id_t logger_id;
+
+static char const* const tangle_column_families[KV_TANGLE_CF_COUNT] = {
+    [KV_CF_TRANSACTION] = "transaction",         [KV_CF_METADATA] = "metadata",
+    [KV_CF_ADDRESS] = "address",                 [KV_CF_BUNDLE] = "bundle",
+    [KV_CF_TAG] = "tag",                         [KV_CF_APPROVEE] = "approvee",
+    [KV_CF_MILESTONE] = "milestone",             [KV_CF_MILESTONE_HASH] = "milestone_hash",
+    [KV_CF_STATE_DELTA] = "state_delta",
+};
+
+static char const* const spent_addresses_column_families[KV_SPENT_ADDRESSES_CF_COUNT] = {
+    [KV_CF_SPENT_ADDRESS] = "spent_address",
+};
+
+retcode_t kv_connection_init(storage_connection_t* const connection, connection_config_t const* const config,
+                             storage_connection_type_t const type) {
+  retcode_t ret = RC_OK;
+
+  if (connection == NULL || config == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  logger_id = logger_helper_enable(KV_LOGGER_ID, LOGGER_DEBUG, true);
+
+  connection->type = type;
+  if (type == STORAGE_CONNECTION_TANGLE) {
+    ret = kv_db_open((kv_db_t**)&connection->actual, config, tangle_column_families, KV_TANGLE_CF_COUNT);
+  } else if (type == STORAGE_CONNECTION_SPENT_ADDRESSES) {
+    ret = kv_db_open((kv_db_t**)&connection->actual, config, spent_addresses_column_families,
+                     KV_SPENT_ADDRESSES_CF_COUNT);
+  } else {
+    return RC_INVALID_PARAM;
+  }
+
+  if (ret != RC_OK) {
+    log_critical(logger_id, "Failed to open db on path: %s\n", config->db_path);
+  }
+
+  return ret;
+}
+
+retcode_t kv_connection_destroy(storage_connection_t* const connection) {
+  retcode_t ret = RC_OK;
+
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  ret = kv_db_close((kv_db_t*)connection->actual);
+  connection->actual = NULL;
+
+  return ret;
+}
+
+retcode_t kv_connection_flush(storage_connection_t const* const connection) {
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return kv_db_flush((kv_db_t*)connection->actual);
+}
+
+uint64_t kv_connection_pending_batch(storage_connection_t const* const connection) {
+  if (connection == NULL) {
+    return 0;
+  }
+
+  return kv_db_pending_group_commit((kv_db_t const*)connection->actual);
+}
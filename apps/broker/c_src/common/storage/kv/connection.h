@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_KV_CONNECTION_H__
+#define __COMMON_STORAGE_KV_CONNECTION_H__
+
+#include <stdint.h>
+
+#include "common/storage/connection.h"
+#include "common/storage/kv/engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Column families of a tangle database, hashes and trits are packed 5 trits per byte and integers are big-endian so
+ * that keys sort as their values
+ */
+typedef enum kv_tangle_column_family_e {
+  KV_CF_TRANSACTION,     // hash -> serialized transaction
+  KV_CF_METADATA,        // hash -> snapshot index, solid, validity, arrival timestamp
+  KV_CF_ADDRESS,         // address, hash -> current index
+  KV_CF_BUNDLE,          // bundle, hash
+  KV_CF_TAG,             // tag, hash
+  KV_CF_APPROVEE,        // trunk or branch, hash -> arrival timestamp
+  KV_CF_MILESTONE,       // index -> hash
+  KV_CF_MILESTONE_HASH,  // hash -> index
+  KV_CF_STATE_DELTA,     // index -> serialized state delta
+  KV_TANGLE_CF_COUNT,
+} kv_tangle_column_family_t;
+
+typedef enum kv_spent_addresses_column_family_e {
+  KV_CF_SPENT_ADDRESS,  // address
+  KV_SPENT_ADDRESSES_CF_COUNT,
+} kv_spent_addresses_column_family_t;
+
+// Connection operations of the backend, see common/storage/connection.h
+retcode_t kv_connection_init(storage_connection_t* const connection, connection_config_t const* const config,
+                             storage_connection_type_t const type);
+retcode_t kv_connection_destroy(storage_connection_t* const connection);
+retcode_t kv_connection_flush(storage_connection_t const* const connection);
+uint64_t kv_connection_pending_batch(storage_connection_t const* const connection);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_KV_CONNECTION_H__
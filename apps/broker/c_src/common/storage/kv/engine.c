@@ -0,0 +1,586 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "common/storage/kv/engine.h"
+#include "utils/handles/lock.h"
+#include "utils/logger_helper.h"
+
+#define KV_ENGINE_LOGGER_ID "kv_engine"
+// Upper bound on the size of a database, LMDB reserves it in the address space and grows the file as needed
+#define KV_MAP_SIZE ((size_t)1 << (sizeof(size_t) > 4 ? 40 : 30))
+#define KV_FILE_MODE 0644
+#define KV_WRITE_BATCH_MIN_CAPACITY 16
+
+struct kv_env_s {
+  char* path;
+  MDB_env* env;
+  bool read_only;
+  MDB_dbi column_families[KV_MAX_COLUMN_FAMILIES];
+  size_t num_column_families;
+  size_t connections;
+  struct kv_env_s* next;
+};
+
+static logger_id_t logger_id;
+
+// LMDB breaks the locks of a file opened twice by a process, its connections share a single environment
+static kv_env_t* envs = NULL;
+static lock_handle_t envs_lock;
+
+retcode_t kv_engine_init() {
+  logger_id = logger_helper_enable(KV_ENGINE_LOGGER_ID, LOGGER_DEBUG, true);
+  lock_handle_init(&envs_lock);
+
+  return RC_OK;
+}
+
+retcode_t kv_engine_destroy() {
+  lock_handle_destroy(&envs_lock);
+  logger_helper_release(logger_id);
+
+  return RC_OK;
+}
+
+static void env_free(kv_env_t* const env) {
+  if (env->env != NULL) {
+    mdb_env_close(env->env);
+  }
+  free(env->path);
+  free(env);
+}
+
+static retcode_t env_create(kv_env_t** const env, connection_config_t const* const config,
+                            char const* const* const column_families, size_t const num_column_families) {
+  retcode_t ret = RC_OK;
+  kv_env_t* kv_env = NULL;
+  MDB_txn* txn = NULL;
+  int rc = MDB_SUCCESS;
+
+  if ((kv_env = (kv_env_t*)calloc(1, sizeof(kv_env_t))) == NULL ||
+      (kv_env->path = strdup(config->db_path)) == NULL) {
+    free(kv_env);
+    return RC_OOM;
+  }
+  kv_env->read_only = config->read_only;
+  kv_env->num_column_families = num_column_families;
+
+  if ((rc = mdb_env_create(&kv_env->env)) != MDB_SUCCESS) {
+    kv_env->env = NULL;
+    ret = RC_KV_FAILED_CONFIG;
+    goto done;
+  }
+  if ((rc = mdb_env_set_maxdbs(kv_env->env, num_column_families)) != MDB_SUCCESS ||
+      (rc = mdb_env_set_mapsize(kv_env->env, KV_MAP_SIZE)) != MDB_SUCCESS) {
+    ret = RC_KV_FAILED_CONFIG;
+    goto done;
+  }
+
+  // Read transactions belong to connections, which move between threads, rather than to threads, and the writers sync
+  // the file themselves, see sync_env()
+  if ((rc = mdb_env_open(kv_env->env, config->db_path,
+                         MDB_NOSUBDIR | MDB_NOTLS | (config->read_only ? MDB_RDONLY : MDB_NOSYNC), KV_FILE_MODE)) !=
+      MDB_SUCCESS) {
+    ret = RC_KV_FAILED_OPEN_DB;
+    goto done;
+  }
+
+  if ((rc = mdb_txn_begin(kv_env->env, NULL, config->read_only ? MDB_RDONLY : 0, &txn)) != MDB_SUCCESS) {
+    ret = RC_KV_FAILED_OPEN_DB;
+    goto done;
+  }
+  for (size_t i = 0; i < num_column_families && rc == MDB_SUCCESS; i++) {
+    rc = mdb_dbi_open(txn, column_families[i], config->read_only ? 0 : MDB_CREATE, &kv_env->column_families[i]);
+  }
+  if (rc != MDB_SUCCESS) {
+    mdb_txn_abort(txn);
+    ret = RC_KV_FAILED_OPEN_DB;
+    goto done;
+  }
+  if ((rc = mdb_txn_commit(txn)) != MDB_SUCCESS) {
+    ret = RC_KV_FAILED_OPEN_DB;
+  }
+
+done:
+  if (ret != RC_OK) {
+    log_critical(logger_id, "Failed to open db on path %s: %s\n", config->db_path, mdb_strerror(rc));
+    env_free(kv_env);
+    kv_env = NULL;
+  }
+  *env = kv_env;
+
+  return ret;
+}
+
+static retcode_t env_acquire(kv_env_t** const env, connection_config_t const* const config,
+                             char const* const* const column_families, size_t const num_column_families) {
+  retcode_t ret = RC_OK;
+  kv_env_t* iter = NULL;
+
+  lock_handle_lock(&envs_lock);
+
+  for (iter = envs; iter != NULL && strcmp(iter->path, config->db_path) != 0; iter = iter->next) {
+  }
+
+  if (iter == NULL) {
+    if ((ret = env_create(&iter, config, column_families, num_column_families)) == RC_OK) {
+      iter->next = envs;
+      envs = iter;
+    }
+  } else if (iter->num_column_families != num_column_families || (iter->read_only && !config->read_only)) {
+    log_critical(logger_id, "Db on path %s is already open with other column families or read only\n",
+                 config->db_path);
+    ret = RC_KV_FAILED_OPEN_DB;
+  }
+
+  if (ret == RC_OK) {
+    iter->connections++;
+    *env = iter;
+  }
+
+  lock_handle_unlock(&envs_lock);
+
+  return ret;
+}
+
+static void env_release(kv_env_t* const env) {
+  kv_env_t** iter = NULL;
+
+  lock_handle_lock(&envs_lock);
+
+  if (--env->connections == 0) {
+    for (iter = &envs; *iter != env; iter = &(*iter)->next) {
+    }
+    *iter = env->next;
+    env_free(env);
+  }
+
+  lock_handle_unlock(&envs_lock);
+}
+
+retcode_t kv_db_open(kv_db_t** const db, connection_config_t const* const config,
+                     char const* const* const column_families, size_t const num_column_families) {
+  retcode_t ret = RC_OK;
+  kv_db_t* kv = NULL;
+
+  if (db == NULL || config == NULL || column_families == NULL) {
+    return RC_NULL_PARAM;
+  } else if (num_column_families > KV_MAX_COLUMN_FAMILIES) {
+    return RC_INVALID_PARAM;
+  } else if (config->db_path == NULL) {
+    return RC_KV_NO_PATH_FOR_DB_SPECIFIED;
+  }
+
+  *db = NULL;
+  if ((kv = (kv_db_t*)calloc(1, sizeof(kv_db_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = env_acquire(&kv->env, config, column_families, num_column_families)) != RC_OK) {
+    free(kv);
+    return ret;
+  }
+
+  memcpy(kv->column_families, kv->env->column_families, num_column_families * sizeof(MDB_dbi));
+  kv->num_column_families = num_column_families;
+  kv->durability = config->durability;
+  storage_group_commit_init(&kv->group_commit, config);
+  *db = kv;
+
+  return RC_OK;
+}
+
+retcode_t kv_db_close(kv_db_t* const db) {
+  retcode_t ret = RC_OK;
+
+  if (db == NULL) {
+    return RC_OK;
+  }
+
+  ret = kv_db_flush(db);
+  if (db->read_txn != NULL) {
+    mdb_txn_abort(db->read_txn);
+  }
+  env_release(db->env);
+  free(db);
+
+  return ret;
+}
+
+/*
+ * Reads
+ */
+
+// Renews the read transaction of the connection, unless the read is nested in another one
+static retcode_t read_begin(kv_db_t* const db, MDB_txn** const txn) {
+  int rc = MDB_SUCCESS;
+
+  if (db->read_depth == 0) {
+    rc = db->read_txn != NULL ? mdb_txn_renew(db->read_txn)
+                              : mdb_txn_begin(db->env->env, NULL, MDB_RDONLY, &db->read_txn);
+    if (rc != MDB_SUCCESS) {
+      log_error(logger_id, "Beginning read transaction failed: %s\n", mdb_strerror(rc));
+      return RC_KV_FAILED_READ;
+    }
+  }
+  db->read_depth++;
+  *txn = db->read_txn;
+
+  return RC_OK;
+}
+
+// Resets the read transaction once the outermost read is over, releasing its snapshot
+static void read_end(kv_db_t* const db) {
+  if (--db->read_depth == 0) {
+    mdb_txn_reset(db->read_txn);
+  }
+}
+
+// Positions a cursor on the first key not less than a key, LMDB has no empty key
+static int cursor_seek(MDB_cursor* const cursor, byte_t const* const key, size_t const key_size, MDB_val* const k,
+                       MDB_val* const v) {
+  if (key_size == 0) {
+    return mdb_cursor_get(cursor, k, v, MDB_FIRST);
+  }
+  k->mv_size = key_size;
+  k->mv_data = (void*)key;
+
+  return mdb_cursor_get(cursor, k, v, MDB_SET_RANGE);
+}
+
+retcode_t kv_db_get(kv_db_t* const db, size_t const column_family, byte_t const* const key, size_t const key_size,
+                    kv_entry_func const func, void* const arg, bool* const found) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_val k = {.mv_size = key_size, .mv_data = (void*)key};
+  MDB_val v;
+  int rc = MDB_NOTFOUND;
+
+  *found = false;
+  if ((ret = read_begin(db, &txn)) != RC_OK) {
+    return ret;
+  }
+
+  if (key_size != 0 && (rc = mdb_get(txn, db->column_families[column_family], &k, &v)) == MDB_SUCCESS) {
+    *found = true;
+    if (func) {
+      func(arg, key, key_size, (byte_t const*)v.mv_data, v.mv_size);
+    }
+  }
+  read_end(db);
+
+  return rc == MDB_SUCCESS || rc == MDB_NOTFOUND ? RC_OK : RC_KV_FAILED_READ;
+}
+
+retcode_t kv_db_exist(kv_db_t* const db, size_t const column_family, byte_t const* const key, size_t const key_size,
+                      bool* const exist) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_cursor* cursor = NULL;
+  MDB_val k, v;
+  int rc = MDB_SUCCESS;
+
+  if (key != NULL) {
+    return kv_db_get(db, column_family, key, key_size, NULL, NULL, exist);
+  }
+
+  *exist = false;
+  if ((ret = read_begin(db, &txn)) != RC_OK) {
+    return ret;
+  }
+  if ((rc = mdb_cursor_open(txn, db->column_families[column_family], &cursor)) == MDB_SUCCESS) {
+    rc = mdb_cursor_get(cursor, &k, &v, MDB_FIRST);
+    *exist = rc == MDB_SUCCESS;
+    mdb_cursor_close(cursor);
+  }
+  read_end(db);
+
+  return rc == MDB_SUCCESS || rc == MDB_NOTFOUND ? RC_OK : RC_KV_FAILED_READ;
+}
+
+retcode_t kv_db_scan(kv_db_t* const db, size_t const column_family, byte_t const* const begin,
+                     size_t const begin_size, byte_t const* const end, size_t const end_size, bool const reverse,
+                     kv_entry_func const func, void* const arg) {
+  retcode_t ret = RC_OK;
+  MDB_dbi const dbi = db->column_families[column_family];
+  MDB_txn* txn = NULL;
+  MDB_cursor* cursor = NULL;
+  MDB_val const first = {.mv_size = begin_size, .mv_data = (void*)begin};
+  MDB_val const last = {.mv_size = end_size, .mv_data = (void*)end};
+  MDB_val k, v;
+  int rc = MDB_SUCCESS;
+
+  // No key is less than the empty one
+  if (end != NULL && end_size == 0) {
+    return RC_OK;
+  }
+
+  if ((ret = read_begin(db, &txn)) != RC_OK) {
+    return ret;
+  }
+  if ((rc = mdb_cursor_open(txn, dbi, &cursor)) != MDB_SUCCESS) {
+    goto done;
+  }
+
+  if (!reverse) {
+    for (rc = cursor_seek(cursor, begin, begin_size, &k, &v);
+         rc == MDB_SUCCESS && (end == NULL || mdb_cmp(txn, dbi, &k, &last) < 0);
+         rc = mdb_cursor_get(cursor, &k, &v, MDB_NEXT)) {
+      if (!func(arg, (byte_t const*)k.mv_data, k.mv_size, (byte_t const*)v.mv_data, v.mv_size)) {
+        break;
+      }
+    }
+  } else {
+    // From the last key before the end one
+    if (end == NULL) {
+      rc = mdb_cursor_get(cursor, &k, &v, MDB_LAST);
+    } else if ((rc = cursor_seek(cursor, end, end_size, &k, &v)) == MDB_SUCCESS) {
+      rc = mdb_cursor_get(cursor, &k, &v, MDB_PREV);
+    } else if (rc == MDB_NOTFOUND) {
+      rc = mdb_cursor_get(cursor, &k, &v, MDB_LAST);
+    }
+    for (; rc == MDB_SUCCESS && mdb_cmp(txn, dbi, &k, &first) >= 0; rc = mdb_cursor_get(cursor, &k, &v, MDB_PREV)) {
+      if (!func(arg, (byte_t const*)k.mv_data, k.mv_size, (byte_t const*)v.mv_data, v.mv_size)) {
+        break;
+      }
+    }
+  }
+  mdb_cursor_close(cursor);
+
+done:
+  read_end(db);
+  if (rc != MDB_SUCCESS && rc != MDB_NOTFOUND) {
+    log_error(logger_id, "Scanning column family %zu failed: %s\n", column_family, mdb_strerror(rc));
+    return RC_KV_FAILED_READ;
+  }
+
+  return RC_OK;
+}
+
+static retcode_t scan_prefix(kv_db_t* const db, size_t const column_family, byte_t const* const prefix,
+                             size_t const prefix_size, byte_t const* const begin, size_t const begin_size,
+                             bool const reverse, kv_entry_func const func, void* const arg) {
+  byte_t end[prefix_size + 1];
+  ssize_t i = prefix_size - 1;
+
+  // The keys of the prefix end before the prefix incremented as a big-endian number, there is no such key when every
+  // byte of the prefix is 0xFF
+  if (prefix_size != 0) {
+    memcpy(end, prefix, prefix_size);
+  }
+  for (; i >= 0 && (uint8_t)end[i] == 0xFF; i--) {
+    end[i] = 0;
+  }
+  if (i < 0) {
+    return kv_db_scan(db, column_family, begin, begin_size, NULL, 0, reverse, func, arg);
+  }
+  end[i] = (byte_t)((uint8_t)end[i] + 1);
+
+  return kv_db_scan(db, column_family, begin, begin_size, end, i + 1, reverse, func, arg);
+}
+
+retcode_t kv_db_scan_prefix(kv_db_t* const db, size_t const column_family, byte_t const* const prefix,
+                            size_t const prefix_size, bool const reverse, kv_entry_func const func, void* const arg) {
+  return scan_prefix(db, column_family, prefix, prefix_size, prefix, prefix_size, reverse, func, arg);
+}
+
+retcode_t kv_db_scan_prefix_from(kv_db_t* const db, size_t const column_family, byte_t const* const prefix,
+                                 size_t const prefix_size, byte_t const* const begin, size_t const begin_size,
+                                 kv_entry_func const func, void* const arg) {
+  return scan_prefix(db, column_family, prefix, prefix_size, begin, begin_size, false, func, arg);
+}
+
+retcode_t kv_db_count(kv_db_t* const db, size_t const column_family, size_t* const count) {
+  retcode_t ret = RC_OK;
+  MDB_txn* txn = NULL;
+  MDB_stat stat;
+  int rc = MDB_SUCCESS;
+
+  *count = 0;
+  if ((ret = read_begin(db, &txn)) != RC_OK) {
+    return ret;
+  }
+  if ((rc = mdb_stat(txn, db->column_families[column_family], &stat)) == MDB_SUCCESS) {
+    *count = stat.ms_entries;
+  }
+  read_end(db);
+
+  return rc == MDB_SUCCESS ? RC_OK : RC_KV_FAILED_READ;
+}
+
+/*
+ * Writes
+ */
+
+// The environment is opened without syncing on commit, the full and normal durabilities both sync the whole file
+static retcode_t sync_env(kv_db_t* const db) {
+  int rc = MDB_SUCCESS;
+
+  if (db->durability == STORAGE_DURABILITY_OFF) {
+    return RC_OK;
+  }
+
+  if ((rc = mdb_env_sync(db->env->env, 1)) != MDB_SUCCESS) {
+    log_error(logger_id, "Syncing db on path %s failed: %s\n", db->env->path, mdb_strerror(rc));
+    return RC_KV_FAILED_WRITE;
+  }
+
+  return RC_OK;
+}
+
+// A group commit is the run of write transactions committed since the last sync, a write out of any is synced alone
+static retcode_t group_commit_end(kv_db_t* const db, size_t const rows) {
+  storage_group_commit_t* const group = &db->group_commit;
+
+  if (storage_group_commit_needs_begin(group)) {
+    storage_group_commit_begun(group);
+  }
+  if (!group->open) {
+    return sync_env(db);
+  }
+
+  return storage_group_commit_add(group, rows) ? kv_db_flush(db) : RC_OK;
+}
+
+static int apply(kv_db_t const* const db, MDB_txn* const txn, kv_write_t const* const write) {
+  MDB_dbi const dbi = db->column_families[write->column_family];
+  MDB_val key = {.mv_size = write->key_size, .mv_data = write->key};
+  MDB_val value = {.mv_size = write->value_size, .mv_data = write->value};
+  int rc = MDB_SUCCESS;
+
+  switch (write->type) {
+    case KV_WRITE_PUT:
+      return mdb_put(txn, dbi, &key, &value, 0);
+    case KV_WRITE_DELETE:
+      rc = mdb_del(txn, dbi, &key, NULL);
+      return rc == MDB_NOTFOUND ? MDB_SUCCESS : rc;
+    case KV_WRITE_CLEAR:
+      return mdb_drop(txn, dbi, 0);
+  }
+
+  return MDB_SUCCESS;
+}
+
+retcode_t kv_db_write(kv_db_t* const db, kv_write_batch_t const* const batch, size_t const rows) {
+  MDB_txn* txn = NULL;
+  int rc = MDB_SUCCESS;
+
+  if (db == NULL || batch == NULL) {
+    return RC_NULL_PARAM;
+  } else if (batch->size == 0) {
+    return RC_OK;
+  }
+
+  // A write transaction per batch makes it atomic, and is never left open across calls as LMDB ties it to its thread
+  if ((rc = mdb_txn_begin(db->env->env, NULL, 0, &txn)) != MDB_SUCCESS) {
+    log_error(logger_id, "Beginning write transaction failed: %s\n", mdb_strerror(rc));
+    return RC_KV_FAILED_WRITE;
+  }
+  for (size_t i = 0; i < batch->size && rc == MDB_SUCCESS; i++) {
+    rc = apply(db, txn, &batch->writes[i]);
+  }
+  if (rc != MDB_SUCCESS) {
+    log_error(logger_id, "Writing batch of %zu writes failed: %s\n", batch->size, mdb_strerror(rc));
+    mdb_txn_abort(txn);
+    return RC_KV_FAILED_WRITE;
+  }
+  if ((rc = mdb_txn_commit(txn)) != MDB_SUCCESS) {
+    log_error(logger_id, "Committing batch of %zu writes failed: %s\n", batch->size, mdb_strerror(rc));
+    return RC_KV_FAILED_WRITE;
+  }
+
+  return group_commit_end(db, rows);
+}
+
+retcode_t kv_db_flush(kv_db_t* const db) {
+  retcode_t ret = RC_OK;
+  storage_group_commit_t* const group = &db->group_commit;
+
+  if (!group->open) {
+    return RC_OK;
+  }
+
+  // Left open on failure, the next flush retries
+  if ((ret = sync_env(db)) != RC_OK) {
+    log_error(logger_id, "Syncing group commit of %zu rows failed\n", group->rows);
+    return ret;
+  }
+  storage_group_commit_ended(group);
+
+  return RC_OK;
+}
+
+uint64_t kv_db_pending_group_commit(kv_db_t const* const db) { return storage_group_commit_pending(&db->group_commit); }
+
+void kv_write_batch_init(kv_write_batch_t* const batch) { memset(batch, 0, sizeof(kv_write_batch_t)); }
+
+static retcode_t write_batch_add(kv_write_batch_t* const batch, kv_write_type_t const type,
+                                 size_t const column_family, byte_t const* const key, size_t const key_size,
+                                 byte_t const* const value, size_t const value_size) {
+  kv_write_t* write = NULL;
+
+  if (batch->size == batch->capacity) {
+    size_t const capacity = batch->capacity ? 2 * batch->capacity : KV_WRITE_BATCH_MIN_CAPACITY;
+    kv_write_t* const writes = (kv_write_t*)realloc(batch->writes, capacity * sizeof(kv_write_t));
+
+    if (writes == NULL) {
+      return RC_OOM;
+    }
+    batch->writes = writes;
+    batch->capacity = capacity;
+  }
+
+  write = &batch->writes[batch->size];
+  write->type = type;
+  write->column_family = column_family;
+  write->key = NULL;
+  write->key_size = key_size;
+  write->value_size = value_size;
+  if (key_size + value_size != 0 && (write->key = (byte_t*)malloc(key_size + value_size)) == NULL) {
+    return RC_OOM;
+  }
+  if (key_size != 0) {
+    memcpy(write->key, key, key_size);
+  }
+  write->value = write->key + key_size;
+  if (value_size != 0) {
+    memcpy(write->value, value, value_size);
+  }
+  batch->size++;
+
+  return RC_OK;
+}
+
+retcode_t kv_write_batch_put(kv_write_batch_t* const batch, size_t const column_family, byte_t const* const key,
+                             size_t const key_size, byte_t const* const value, size_t const value_size) {
+  return write_batch_add(batch, KV_WRITE_PUT, column_family, key, key_size, value, value_size);
+}
+
+retcode_t kv_write_batch_delete(kv_write_batch_t* const batch, size_t const column_family, byte_t const* const key,
+                                size_t const key_size) {
+  return write_batch_add(batch, KV_WRITE_DELETE, column_family, key, key_size, NULL, 0);
+}
+
+retcode_t kv_write_batch_clear(kv_write_batch_t* const batch, size_t const column_family) {
+  return write_batch_add(batch, KV_WRITE_CLEAR, column_family, NULL, 0, NULL, 0);
+}
+
+void kv_write_batch_reset(kv_write_batch_t* const batch) {
+  for (size_t i = 0; i < batch->size; i++) {
+    free(batch->writes[i].key);
+  }
+  batch->size = 0;
+}
+
+void kv_write_batch_destroy(kv_write_batch_t* const batch) {
+  kv_write_batch_reset(batch);
+  free(batch->writes);
+  kv_write_batch_init(batch);
+}
@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Ordered key-value store with column families, prefix scans and atomic write batches
+ *
+ * A database is an LMDB environment whose named databases are the column families, B-trees of unique binary keys
+ * sorted bytewise. Indices are built by the caller as composite keys and read back with prefix scans.
+ */
+
+#ifndef __COMMON_STORAGE_KV_ENGINE_H__
+#define __COMMON_STORAGE_KV_ENGINE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <lmdb.h>
+
+#include "common/errors.h"
+#include "common/storage/connection.h"
+#include "common/storage/group_commit.h"
+#include "common/trinary/bytes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Maximum number of column families of a database
+#define KV_MAX_COLUMN_FAMILIES 16
+
+// LMDB environment of a database file, shared by the connections of the process to it
+typedef struct kv_env_s kv_env_t;
+
+/**
+ * Connection to a database. Write batches are committed as they are written, the group commit defers the sync of the
+ * file to the end of the group so that they share a single flush to the disk.
+ */
+typedef struct kv_db_s {
+  kv_env_t* env;
+  MDB_dbi column_families[KV_MAX_COLUMN_FAMILIES];
+  size_t num_column_families;
+  // Read transaction of the connection, reset between reads and shared by the reads nested in a scan
+  MDB_txn* read_txn;
+  size_t read_depth;
+  storage_durability_t durability;
+  storage_group_commit_t group_commit;
+} kv_db_t;
+
+typedef enum kv_write_type_e {
+  KV_WRITE_PUT,
+  KV_WRITE_DELETE,
+  KV_WRITE_CLEAR,  // Deletes every key of the column family
+} kv_write_type_t;
+
+typedef struct kv_write_s {
+  kv_write_type_t type;
+  size_t column_family;
+  byte_t* key;  // The value follows the key in the same allocation
+  size_t key_size;
+  byte_t* value;
+  size_t value_size;
+} kv_write_t;
+
+// Writes applied atomically by kv_db_write, the keys and values are copied when added
+typedef struct kv_write_batch_s {
+  kv_write_t* writes;
+  size_t size;
+  size_t capacity;
+} kv_write_batch_t;
+
+/**
+ * Called on each entry read, the key and value are only valid during the call
+ *
+ * @return true to read the next entry, false to stop
+ */
+typedef bool (*kv_entry_func)(void* const arg, byte_t const* const key, size_t const key_size,
+                              byte_t const* const value, size_t const value_size);
+
+/**
+ * Initializes the engine, before any database is opened
+ *
+ * @return a status code
+ */
+retcode_t kv_engine_init();
+
+/**
+ * Destroys the engine, once every database is closed
+ *
+ * @return a status code
+ */
+retcode_t kv_engine_destroy();
+
+/**
+ * Opens a database, creating its file and column families if they do not exist unless the configuration is read only
+ *
+ * The page cache, memory mapping, temporary store and write-ahead log settings of the configuration are not used.
+ *
+ * @param db The database
+ * @param config The configuration of the connection
+ * @param column_families The names of the column families, identified by their index afterwards
+ * @param num_column_families The number of column families
+ *
+ * @return a status code
+ */
+retcode_t kv_db_open(kv_db_t** const db, connection_config_t const* const config,
+                     char const* const* const column_families, size_t const num_column_families);
+
+/**
+ * Ends the group commit if one is open and closes a database
+ *
+ * @param db The database
+ *
+ * @return a status code
+ */
+retcode_t kv_db_close(kv_db_t* const db);
+
+/**
+ * Reads the value of a key
+ *
+ * @param db The database
+ * @param column_family The column family
+ * @param key The key
+ * @param key_size The size of the key
+ * @param func Called with the entry if the key exists
+ * @param arg Argument of the function
+ * @param found Whether the key exists
+ *
+ * @return a status code
+ */
+retcode_t kv_db_get(kv_db_t* const db, size_t const column_family, byte_t const* const key, size_t const key_size,
+                    kv_entry_func const func, void* const arg, bool* const found);
+
+/**
+ * Checks whether a key exists
+ *
+ * @param db The database
+ * @param column_family The column family
+ * @param key The key, NULL for any key
+ * @param key_size The size of the key
+ * @param exist Whether the key exists
+ *
+ * @return a status code
+ */
+retcode_t kv_db_exist(kv_db_t* const db, size_t const column_family, byte_t const* const key, size_t const key_size,
+                      bool* const exist);
+
+/**
+ * Reads the entries of the keys in [begin, end) in key order, or in reverse order
+ *
+ * The function may read the database, from the same snapshot as the scan, but must not write it
+ *
+ * @param db The database
+ * @param column_family The column family
+ * @param begin The first key
+ * @param begin_size The size of the first key
+ * @param end The key after the last one, NULL to scan up to the last key
+ * @param end_size The size of the key after the last one
+ * @param reverse Whether to scan from the last key
+ * @param func Called on each entry
+ * @param arg Argument of the function
+ *
+ * @return a status code
+ */
+retcode_t kv_db_scan(kv_db_t* const db, size_t const column_family, byte_t const* const begin,
+                     size_t const begin_size, byte_t const* const end, size_t const end_size, bool const reverse,
+                     kv_entry_func const func, void* const arg);
+
+/**
+ * Reads the entries of the keys starting with a prefix in key order, or in reverse order
+ *
+ * @param db The database
+ * @param column_family The column family
+ * @param prefix The prefix
+ * @param prefix_size The size of the prefix
+ * @param reverse Whether to scan from the last key
+ * @param func Called on each entry
+ * @param arg Argument of the function
+ *
+ * @return a status code
+ */
+retcode_t kv_db_scan_prefix(kv_db_t* const db, size_t const column_family, byte_t const* const prefix,
+                            size_t const prefix_size, bool const reverse, kv_entry_func const func, void* const arg);
+
+/**
+ * Reads the entries of the keys starting with a prefix in key order, from a key of the prefix on. Appending a 0x00
+ * byte to the last key read resumes a scan right after it.
+ *
+ * @param db The database
+ * @param column_family The column family
+ * @param prefix The prefix
+ * @param prefix_size The size of the prefix
+ * @param begin The first key, starting with the prefix
+ * @param begin_size The size of the first key
+ * @param func Called on each entry
+ * @param arg Argument of the function
+ *
+ * @return a status code
+ */
+retcode_t kv_db_scan_prefix_from(kv_db_t* const db, size_t const column_family, byte_t const* const prefix,
+                                 size_t const prefix_size, byte_t const* const begin, size_t const begin_size,
+                                 kv_entry_func const func, void* const arg);
+
+/**
+ * Counts the keys of a column family
+ *
+ * @param db The database
+ * @param column_family The column family
+ * @param count The number of keys
+ *
+ * @return a status code
+ */
+retcode_t kv_db_count(kv_db_t* const db, size_t const column_family, size_t* const count);
+
+/**
+ * Applies a write batch atomically in a write transaction, in the group commit if one is configured
+ *
+ * @param db The database
+ * @param batch The write batch, left unchanged
+ * @param rows The number of rows written, counted by the group commit
+ *
+ * @return a status code
+ */
+retcode_t kv_db_write(kv_db_t* const db, kv_write_batch_t const* const batch, size_t const rows);
+
+/**
+ * Ends the group commit if one is open, syncing its writes to the disk as the durability of the connection requires
+ *
+ * @param db The database
+ *
+ * @return a status code
+ */
+retcode_t kv_db_flush(kv_db_t* const db);
+
+/**
+ * Identifies the group commit pending on a database
+ *
+ * @param db The database
+ *
+ * @return an identifier of the group commit pending, 0 if none is
+ */
+uint64_t kv_db_pending_group_commit(kv_db_t const* const db);
+
+void kv_write_batch_init(kv_write_batch_t* const batch);
+retcode_t kv_write_batch_put(kv_write_batch_t* const batch, size_t const column_family, byte_t const* const key,
+                             size_t const key_size, byte_t const* const value, size_t const value_size);
+retcode_t kv_write_batch_delete(kv_write_batch_t* const batch, size_t const column_family, byte_t const* const key,
+                                size_t const key_size);
+retcode_t kv_write_batch_clear(kv_write_batch_t* const batch, size_t const column_family);
+// Removes the writes of a batch, keeping its memory for the next ones
+void kv_write_batch_reset(kv_write_batch_t* const batch);
+void kv_write_batch_destroy(kv_write_batch_t* const batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_KV_ENGINE_H__
@@ -0,0 +1,1463 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/model/milestone.h"
+#include "common/model/transaction.h"
+#include "common/storage/backend.h"
+#include "common/storage/kv/connection.h"
+#include "common/storage/kv/engine.h"
+#include "common/storage/storage.h"
+#include "common/trinary/trit_byte.h"
+#include "uthash.h"
+#include "utils/logger_helper.h"
+#include "utils/macros.h"
+#include "utils/time.h"
+
+#define KV_LOGGER_ID "kv"
+
+#define KV_HASH_SIZE MIN_BYTES(NUM_TRITS_HASH)
+#define KV_TAG_SIZE MIN_BYTES(NUM_TRITS_TAG)
+#define KV_TRANSACTION_SIZE MIN_BYTES(NUM_TRITS_SERIALIZED_TRANSACTION)
+#define KV_UINT64_SIZE 8
+#define KV_METADATA_SIZE (2 * KV_UINT64_SIZE + 2)
+// Index keys are a field followed by the hash of the transaction
+#define KV_INDEX_KEY_MAX_SIZE (2 * KV_HASH_SIZE)
+// Number of transactions whose metadata are cleared by each write
+#define KV_METADATA_CLEAR_CHUNK_SIZE 1024
+
+static logger_id_t logger_id;
+
+static retcode_t kv_storage_init() {
+  logger_id = logger_helper_enable(KV_LOGGER_ID, LOGGER_DEBUG, true);
+
+  return kv_engine_init();
+}
+
+static retcode_t kv_storage_destroy() {
+  logger_helper_release(logger_id);
+
+  return kv_engine_destroy();
+}
+
+/*
+ * Encoding
+ */
+
+static void pack_trits(byte_t* const bytes, flex_trit_t const* const flex_trits, size_t const num_trits) {
+  flex_trits_to_bytes(bytes, num_trits, flex_trits, num_trits, num_trits);
+}
+
+static void unpack_trits(flex_trit_t* const flex_trits, byte_t const* const bytes, size_t const num_trits) {
+  flex_trits_from_bytes(flex_trits, num_trits, bytes, num_trits, num_trits);
+}
+
+static void encode_uint64(byte_t* const bytes, uint64_t const value) {
+  for (size_t i = 0; i < KV_UINT64_SIZE; i++) {
+    bytes[i] = (byte_t)(value >> (8 * (KV_UINT64_SIZE - 1 - i)));
+  }
+}
+
+static uint64_t decode_uint64(byte_t const* const bytes) {
+  uint64_t value = 0;
+
+  for (size_t i = 0; i < KV_UINT64_SIZE; i++) {
+    value = (value << 8) | (uint8_t)bytes[i];
+  }
+
+  return value;
+}
+
+// Builds the key of an index, a field followed by the packed hash, returns its size
+static size_t index_key(byte_t* const key, flex_trit_t const* const field, size_t const num_trits,
+                        byte_t const* const hash) {
+  pack_trits(key, field, num_trits);
+  memcpy(key + MIN_BYTES(num_trits), hash, KV_HASH_SIZE);
+  return MIN_BYTES(num_trits) + KV_HASH_SIZE;
+}
+
+typedef struct kv_metadata_s {
+  uint64_t snapshot_index;
+  bool solid;
+  uint8_t validity;
+  uint64_t arrival_timestamp;
+} kv_metadata_t;
+
+static void metadata_encode(byte_t* const bytes, kv_metadata_t const* const metadata) {
+  encode_uint64(bytes, metadata->snapshot_index);
+  bytes[KV_UINT64_SIZE] = metadata->solid;
+  bytes[KV_UINT64_SIZE + 1] = metadata->validity;
+  encode_uint64(bytes + KV_UINT64_SIZE + 2, metadata->arrival_timestamp);
+}
+
+static void metadata_decode(kv_metadata_t* const metadata, byte_t const* const bytes) {
+  metadata->snapshot_index = decode_uint64(bytes);
+  metadata->solid = bytes[KV_UINT64_SIZE];
+  metadata->validity = bytes[KV_UINT64_SIZE + 1];
+  metadata->arrival_timestamp = decode_uint64(bytes + KV_UINT64_SIZE + 2);
+}
+
+/*
+ * Generic functions
+ */
+
+typedef struct value_buffer_s {
+  byte_t* bytes;
+  size_t capacity;
+  size_t size;
+} value_buffer_t;
+
+static bool copy_value_func(void* const arg, byte_t const* const key, size_t const key_size,
+                            byte_t const* const value, size_t const value_size) {
+  value_buffer_t* const buffer = (value_buffer_t*)arg;
+
+  UNUSED(key);
+  UNUSED(key_size);
+  buffer->size = value_size;
+  if (value_size <= buffer->capacity && value_size != 0) {
+    memcpy(buffer->bytes, value, value_size);
+  }
+
+  return false;
+}
+
+// Reads a value of a known size
+static retcode_t get_value(kv_db_t* const db, size_t const column_family, byte_t const* const key,
+                           size_t const key_size, byte_t* const value, size_t const value_size, bool* const found) {
+  retcode_t ret = RC_OK;
+  value_buffer_t buffer = {.bytes = value, .capacity = value_size, .size = 0};
+
+  if ((ret = kv_db_get(db, column_family, key, key_size, copy_value_func, &buffer, found)) != RC_OK) {
+    return ret;
+  }
+  if (*found && buffer.size != value_size) {
+    log_error(logger_id, "Value of %zu bytes in column family %zu instead of %zu\n", buffer.size, column_family,
+              value_size);
+    return RC_KV_CORRUPTED_VALUE;
+  }
+
+  return RC_OK;
+}
+
+// Returns the next model of a pack, NULL if the pack is full
+static void* pack_next(iota_stor_pack_t* const pack) {
+  if (pack->num_loaded == pack->capacity) {
+    pack->insufficient_capacity = true;
+    return NULL;
+  }
+  return pack->models[pack->num_loaded++];
+}
+
+typedef struct hash_scan_s {
+  size_t offset;             // Offset of the hash in the keys
+  int64_t before_timestamp;  // Only the entries whose value is an earlier timestamp, 0 for all
+  iota_stor_pack_t* pack;    // Hashes loaded into the pack if not NULL
+  hash243_set_t* set;        // Added to the set otherwise
+  retcode_t ret;
+} hash_scan_t;
+
+static bool hash_scan_func(void* const arg, byte_t const* const key, size_t const key_size,
+                           byte_t const* const value, size_t const value_size) {
+  hash_scan_t* const scan = (hash_scan_t*)arg;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t* model = NULL;
+
+  if (key_size != scan->offset + KV_HASH_SIZE) {
+    scan->ret = RC_KV_CORRUPTED_VALUE;
+    return false;
+  }
+
+  if (scan->before_timestamp != 0) {
+    if (value_size != KV_UINT64_SIZE) {
+      scan->ret = RC_KV_CORRUPTED_VALUE;
+      return false;
+    } else if ((int64_t)decode_uint64(value) >= scan->before_timestamp) {
+      return true;
+    }
+  }
+
+  if (scan->pack != NULL) {
+    if ((model = (flex_trit_t*)pack_next(scan->pack)) == NULL) {
+      return false;
+    }
+    unpack_trits(model, key + scan->offset, NUM_TRITS_HASH);
+  } else {
+    unpack_trits(hash, key + scan->offset, NUM_TRITS_HASH);
+    if ((scan->ret = hash243_set_add(scan->set, hash)) != RC_OK) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static retcode_t scan_hashes(kv_db_t* const db, size_t const column_family, byte_t const* const prefix,
+                             size_t const prefix_size, hash_scan_t* const scan) {
+  retcode_t ret = RC_OK;
+
+  scan->offset = prefix_size;
+  scan->ret = RC_OK;
+  if ((ret = kv_db_scan_prefix(db, column_family, prefix, prefix_size, false, hash_scan_func, scan)) != RC_OK) {
+    return ret;
+  }
+
+  return scan->ret;
+}
+
+/*
+ * Transaction operations
+ */
+
+enum load_model {
+  MODEL_TRANSACTION,
+  MODEL_TRANSACTION_ESSENCE_METADATA,
+  MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA,
+  MODEL_TRANSACTION_ESSENCE_CONSENSUS,
+  MODEL_TRANSACTION_METADATA,
+};
+
+static retcode_t load_transaction(kv_db_t* const db, byte_t const* const key, iota_transaction_t* const tx,
+                                  bool* const found) {
+  retcode_t ret = RC_OK;
+  byte_t bytes[KV_TRANSACTION_SIZE];
+  flex_trit_t trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+
+  if ((ret = get_value(db, KV_CF_TRANSACTION, key, KV_HASH_SIZE, bytes, KV_TRANSACTION_SIZE, found)) != RC_OK ||
+      !*found) {
+    return ret;
+  }
+  unpack_trits(trits, bytes, NUM_TRITS_SERIALIZED_TRANSACTION);
+  if (transaction_deserialize_from_trits(tx, trits, false) == 0) {
+    return RC_KV_CORRUPTED_VALUE;
+  }
+
+  return RC_OK;
+}
+
+static retcode_t load_metadata(kv_db_t* const db, byte_t const* const key, kv_metadata_t* const metadata,
+                               bool* const found) {
+  retcode_t ret = RC_OK;
+  byte_t bytes[KV_METADATA_SIZE];
+
+  if ((ret = get_value(db, KV_CF_METADATA, key, KV_HASH_SIZE, bytes, KV_METADATA_SIZE, found)) != RC_OK || !*found) {
+    return ret;
+  }
+  metadata_decode(metadata, bytes);
+
+  return RC_OK;
+}
+
+static void populate_essence(iota_transaction_t* const tx, iota_transaction_t const* const stored) {
+  transaction_set_address(tx, stored->essence.address);
+  transaction_set_value(tx, stored->essence.value);
+  transaction_set_obsolete_tag(tx, stored->essence.obsolete_tag);
+  transaction_set_timestamp(tx, stored->essence.timestamp);
+  transaction_set_current_index(tx, stored->essence.current_index);
+  transaction_set_last_index(tx, stored->essence.last_index);
+  transaction_set_bundle(tx, stored->essence.bundle);
+}
+
+static void populate_attachment(iota_transaction_t* const tx, iota_transaction_t const* const stored) {
+  transaction_set_trunk(tx, stored->attachment.trunk);
+  transaction_set_branch(tx, stored->attachment.branch);
+  transaction_set_attachment_timestamp(tx, stored->attachment.attachment_timestamp);
+  transaction_set_attachment_timestamp_lower(tx, stored->attachment.attachment_timestamp_lower);
+  transaction_set_attachment_timestamp_upper(tx, stored->attachment.attachment_timestamp_upper);
+  transaction_set_nonce(tx, stored->attachment.nonce);
+  transaction_set_tag(tx, stored->attachment.tag);
+}
+
+static void populate_metadata(iota_transaction_t* const tx, kv_metadata_t const* const metadata) {
+  transaction_set_snapshot_index(tx, metadata->snapshot_index);
+  transaction_set_solid(tx, metadata->solid);
+  transaction_set_validity(tx, metadata->validity);
+  transaction_set_arrival_timestamp(tx, metadata->arrival_timestamp);
+}
+
+static retcode_t load_transaction_model(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                        iota_stor_pack_t* const pack, enum load_model const model) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  byte_t key[KV_HASH_SIZE];
+  iota_transaction_t stored;
+  iota_transaction_t* tx = NULL;
+  kv_metadata_t metadata;
+  bool found = false;
+
+  pack->insufficient_capacity = false;
+  pack_trits(key, hash, NUM_TRITS_HASH);
+
+  if (model != MODEL_TRANSACTION_METADATA && ((ret = load_transaction(db, key, &stored, &found)) != RC_OK || !found)) {
+    return ret;
+  }
+  if (model != MODEL_TRANSACTION && model != MODEL_TRANSACTION_ESSENCE_CONSENSUS &&
+      ((ret = load_metadata(db, key, &metadata, &found)) != RC_OK || !found)) {
+    return ret;
+  }
+  if ((tx = (iota_transaction_t*)pack_next(pack)) == NULL) {
+    return RC_OK;
+  }
+
+  switch (model) {
+    case MODEL_TRANSACTION:
+      populate_essence(tx, &stored);
+      populate_attachment(tx, &stored);
+      transaction_set_hash(tx, hash);
+      transaction_set_signature(tx, stored.data.signature_or_message);
+      break;
+    case MODEL_TRANSACTION_ESSENCE_METADATA:
+      populate_essence(tx, &stored);
+      populate_metadata(tx, &metadata);
+      break;
+    case MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA:
+      populate_essence(tx, &stored);
+      populate_attachment(tx, &stored);
+      populate_metadata(tx, &metadata);
+      break;
+    case MODEL_TRANSACTION_ESSENCE_CONSENSUS:
+      populate_essence(tx, &stored);
+      transaction_set_hash(tx, hash);
+      break;
+    case MODEL_TRANSACTION_METADATA:
+      populate_metadata(tx, &metadata);
+      break;
+  }
+
+  return RC_OK;
+}
+
+static retcode_t kv_stor_transaction_count(storage_connection_t const* const connection, size_t* const count) {
+  return kv_db_count((kv_db_t*)connection->actual, KV_CF_TRANSACTION, count);
+}
+
+static retcode_t kv_stor_transaction_store(storage_connection_t const* const connection,
+                                           iota_transaction_t const* const tx) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+  flex_trit_t trits[NUM_FLEX_TRITS_SERIALIZED_TRANSACTION];
+  byte_t hash[KV_HASH_SIZE];
+  byte_t bytes[KV_TRANSACTION_SIZE];
+  byte_t key[KV_INDEX_KEY_MAX_SIZE];
+  byte_t value[KV_METADATA_SIZE];
+  kv_metadata_t metadata = {.arrival_timestamp = current_timestamp_ms()};
+  bool exist = false;
+  size_t size = 0;
+
+  pack_trits(hash, tx->consensus.hash, NUM_TRITS_HASH);
+  // Every transaction has metadata, a much smaller value than the transaction itself
+  if ((ret = kv_db_exist(db, KV_CF_METADATA, hash, KV_HASH_SIZE, &exist)) != RC_OK) {
+    return ret;
+  } else if (exist) {
+    return RC_KV_KEY_EXISTS;
+  }
+
+  kv_write_batch_init(&batch);
+
+  transaction_serialize_on_flex_trits(tx, trits);
+  pack_trits(bytes, trits, NUM_TRITS_SERIALIZED_TRANSACTION);
+  ret = kv_write_batch_put(&batch, KV_CF_TRANSACTION, hash, KV_HASH_SIZE, bytes, KV_TRANSACTION_SIZE);
+  metadata_encode(value, &metadata);
+  ret |= kv_write_batch_put(&batch, KV_CF_METADATA, hash, KV_HASH_SIZE, value, KV_METADATA_SIZE);
+
+  size = index_key(key, tx->essence.address, NUM_TRITS_ADDRESS, hash);
+  encode_uint64(value, tx->essence.current_index);
+  ret |= kv_write_batch_put(&batch, KV_CF_ADDRESS, key, size, value, KV_UINT64_SIZE);
+  size = index_key(key, tx->essence.bundle, NUM_TRITS_BUNDLE, hash);
+  ret |= kv_write_batch_put(&batch, KV_CF_BUNDLE, key, size, NULL, 0);
+  size = index_key(key, tx->attachment.tag, NUM_TRITS_TAG, hash);
+  ret |= kv_write_batch_put(&batch, KV_CF_TAG, key, size, NULL, 0);
+
+  // Approvers are found before a timestamp without reading their metadata
+  encode_uint64(value, metadata.arrival_timestamp);
+  size = index_key(key, tx->attachment.trunk, NUM_TRITS_TRUNK, hash);
+  ret |= kv_write_batch_put(&batch, KV_CF_APPROVEE, key, size, value, KV_UINT64_SIZE);
+  if (memcmp(tx->attachment.trunk, tx->attachment.branch, FLEX_TRIT_SIZE_243) != 0) {
+    size = index_key(key, tx->attachment.branch, NUM_TRITS_BRANCH, hash);
+    ret |= kv_write_batch_put(&batch, KV_CF_APPROVEE, key, size, value, KV_UINT64_SIZE);
+  }
+
+  if (ret == RC_OK) {
+    ret = kv_db_write(db, &batch, 1);
+  }
+  kv_write_batch_destroy(&batch);
+
+  return ret;
+}
+
+static retcode_t kv_stor_transaction_load(storage_connection_t const* const connection,
+                                          transaction_field_t const field, flex_trit_t const* const key,
+                                          iota_stor_pack_t* const pack) {
+  if (field != TRANSACTION_FIELD_HASH) {
+    return RC_KV_FAILED_NOT_IMPLEMENTED;
+  }
+
+  return load_transaction_model(connection, key, pack, MODEL_TRANSACTION);
+}
+
+static retcode_t kv_stor_transaction_load_essence_and_metadata(storage_connection_t const* const connection,
+                                                               flex_trit_t const* const hash,
+                                                               iota_stor_pack_t* const pack) {
+  return load_transaction_model(connection, hash, pack, MODEL_TRANSACTION_ESSENCE_METADATA);
+}
+
+static retcode_t kv_stor_transaction_load_essence_attachment_and_metadata(storage_connection_t const* const connection,
+                                                                          flex_trit_t const* const hash,
+                                                                          iota_stor_pack_t* const pack) {
+  return load_transaction_model(connection, hash, pack, MODEL_TRANSACTION_ESSENCE_ATTACHMENT_METADATA);
+}
+
+static retcode_t kv_stor_transaction_load_essence_and_consensus(storage_connection_t const* const connection,
+                                                                flex_trit_t const* const hash,
+                                                                iota_stor_pack_t* const pack) {
+  return load_transaction_model(connection, hash, pack, MODEL_TRANSACTION_ESSENCE_CONSENSUS);
+}
+
+static retcode_t kv_stor_transaction_load_metadata(storage_connection_t const* const connection,
+                                                   flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return load_transaction_model(connection, hash, pack, MODEL_TRANSACTION_METADATA);
+}
+
+static retcode_t kv_stor_transaction_exist(storage_connection_t const* const connection,
+                                           transaction_field_t const field, flex_trit_t const* const key,
+                                           bool* const exist) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  byte_t hash[KV_HASH_SIZE];
+
+  switch (field) {
+    case TRANSACTION_FIELD_NONE:
+      return kv_db_exist(db, KV_CF_METADATA, NULL, 0, exist);
+    case TRANSACTION_FIELD_HASH:
+      pack_trits(hash, key, NUM_TRITS_HASH);
+      return kv_db_exist(db, KV_CF_METADATA, hash, KV_HASH_SIZE, exist);
+    default:
+      return RC_KV_FAILED_NOT_IMPLEMENTED;
+  }
+}
+
+enum metadata_field {
+  METADATA_SNAPSHOT_INDEX,
+  METADATA_SOLID,
+  METADATA_VALIDITY,
+};
+
+typedef struct metadata_update_s {
+  kv_db_t* db;
+  kv_write_batch_t batch;
+  enum metadata_field field;
+  uint64_t value;
+} metadata_update_t;
+
+// Adds the update of the metadata of a transaction to the batch, nothing is written if there is no such transaction
+static retcode_t metadata_update_func(metadata_update_t* const update, flex_trit_t const* const hash) {
+  retcode_t ret = RC_OK;
+  byte_t key[KV_HASH_SIZE];
+  byte_t value[KV_METADATA_SIZE];
+  kv_metadata_t metadata;
+  bool found = false;
+
+  pack_trits(key, hash, NUM_TRITS_HASH);
+  if ((ret = load_metadata(update->db, key, &metadata, &found)) != RC_OK || !found) {
+    return ret;
+  }
+
+  switch (update->field) {
+    case METADATA_SNAPSHOT_INDEX:
+      metadata.snapshot_index = update->value;
+      break;
+    case METADATA_SOLID:
+      metadata.solid = update->value;
+      break;
+    case METADATA_VALIDITY:
+      metadata.validity = update->value;
+      break;
+  }
+  metadata_encode(value, &metadata);
+
+  return kv_write_batch_put(&update->batch, KV_CF_METADATA, key, KV_HASH_SIZE, value, KV_METADATA_SIZE);
+}
+
+static retcode_t update_transactions(storage_connection_t const* const connection, hash243_set_t const hashes,
+                                     flex_trit_t const* const hash, enum metadata_field const field,
+                                     uint64_t const value) {
+  retcode_t ret = RC_OK;
+  metadata_update_t update = {.db = (kv_db_t*)connection->actual, .field = field, .value = value};
+
+  kv_write_batch_init(&update.batch);
+
+  if (hash != NULL) {
+    ret = metadata_update_func(&update, hash);
+  } else {
+    ret = hash243_set_for_each(hashes, (hash243_on_container_func)metadata_update_func, &update);
+  }
+  if (ret == RC_OK) {
+    ret = kv_db_write(update.db, &update.batch, hash != NULL ? 1 : hash243_set_size(hashes));
+  }
+
+  kv_write_batch_destroy(&update.batch);
+
+  return ret;
+}
+
+static retcode_t kv_stor_transaction_update_snapshot_index(storage_connection_t const* const connection,
+                                                           flex_trit_t const* const hash,
+                                                           uint64_t const snapshot_index) {
+  return update_transactions(connection, NULL, hash, METADATA_SNAPSHOT_INDEX, snapshot_index);
+}
+
+static retcode_t kv_stor_transactions_update_snapshot_index(storage_connection_t const* const connection,
+                                                            hash243_set_t const hashes,
+                                                            uint64_t const snapshot_index) {
+  return update_transactions(connection, hashes, NULL, METADATA_SNAPSHOT_INDEX, snapshot_index);
+}
+
+static retcode_t kv_stor_transaction_update_solid_state(storage_connection_t const* const connection,
+                                                        flex_trit_t const* const hash, bool const is_solid) {
+  return update_transactions(connection, NULL, hash, METADATA_SOLID, is_solid);
+}
+
+static retcode_t kv_stor_transactions_update_solid_state(storage_connection_t const* const connection,
+                                                         hash243_set_t const hashes, bool const is_solid) {
+  return update_transactions(connection, hashes, NULL, METADATA_SOLID, is_solid);
+}
+
+static retcode_t kv_stor_transaction_load_hashes(storage_connection_t const* const connection,
+                                                 transaction_field_t const field, flex_trit_t const* const key,
+                                                 iota_stor_pack_t* const pack) {
+  byte_t prefix[KV_HASH_SIZE];
+  hash_scan_t scan = {.pack = pack};
+
+  if (field != TRANSACTION_FIELD_ADDRESS) {
+    return RC_KV_FAILED_NOT_IMPLEMENTED;
+  }
+
+  pack->insufficient_capacity = false;
+  pack_trits(prefix, key, NUM_TRITS_ADDRESS);
+
+  return scan_hashes((kv_db_t*)connection->actual, KV_CF_ADDRESS, prefix, KV_HASH_SIZE, &scan);
+}
+
+static retcode_t kv_stor_transaction_load_hashes_of_approvers(storage_connection_t const* const connection,
+                                                              flex_trit_t const* const approvee_hash,
+                                                              iota_stor_pack_t* const pack,
+                                                              int64_t before_timestamp) {
+  byte_t prefix[KV_HASH_SIZE];
+  hash_scan_t scan = {.before_timestamp = before_timestamp, .pack = pack};
+
+  pack->insufficient_capacity = false;
+  pack_trits(prefix, approvee_hash, NUM_TRITS_HASH);
+
+  return scan_hashes((kv_db_t*)connection->actual, KV_CF_APPROVEE, prefix, KV_HASH_SIZE, &scan);
+}
+
+typedef struct candidate_scan_s {
+  kv_db_t* db;
+  iota_stor_pack_t* pack;
+  retcode_t ret;
+} candidate_scan_t;
+
+// Loads the hashes of the tails not already known to be milestones
+static bool candidate_scan_func(void* const arg, byte_t const* const key, size_t const key_size,
+                                byte_t const* const value, size_t const value_size) {
+  candidate_scan_t* const scan = (candidate_scan_t*)arg;
+  byte_t const* const hash = key + KV_HASH_SIZE;
+  flex_trit_t* model = NULL;
+  bool exist = false;
+
+  if (key_size != 2 * KV_HASH_SIZE || value_size != KV_UINT64_SIZE) {
+    scan->ret = RC_KV_CORRUPTED_VALUE;
+    return false;
+  } else if (decode_uint64(value) != 0) {
+    return true;
+  }
+
+  if ((scan->ret = kv_db_exist(scan->db, KV_CF_MILESTONE_HASH, hash, KV_HASH_SIZE, &exist)) != RC_OK) {
+    return false;
+  } else if (exist) {
+    return true;
+  }
+
+  if ((model = (flex_trit_t*)pack_next(scan->pack)) == NULL) {
+    return false;
+  }
+  unpack_trits(model, hash, NUM_TRITS_HASH);
+
+  return true;
+}
+
+static retcode_t kv_stor_transaction_load_hashes_of_milestone_candidates(storage_connection_t const* const connection,
+                                                                         iota_stor_pack_t* const pack,
+                                                                         flex_trit_t const* const coordinator) {
+  retcode_t ret = RC_OK;
+  byte_t prefix[KV_HASH_SIZE];
+  candidate_scan_t scan = {.db = (kv_db_t*)connection->actual, .pack = pack, .ret = RC_OK};
+
+  pack->insufficient_capacity = false;
+  pack_trits(prefix, coordinator, NUM_TRITS_ADDRESS);
+  if ((ret = kv_db_scan_prefix(scan.db, KV_CF_ADDRESS, prefix, KV_HASH_SIZE, false, candidate_scan_func, &scan)) !=
+      RC_OK) {
+    return ret;
+  }
+
+  return scan.ret;
+}
+
+static bool count_func(void* const arg, byte_t const* const key, size_t const key_size, byte_t const* const value,
+                       size_t const value_size) {
+  UNUSED(key);
+  UNUSED(key_size);
+  UNUSED(value);
+  UNUSED(value_size);
+  (*(size_t*)arg)++;
+
+  return true;
+}
+
+static retcode_t kv_stor_transaction_approvers_count(storage_connection_t const* const connection,
+                                                     flex_trit_t const* const hash, size_t* const count) {
+  byte_t prefix[KV_HASH_SIZE];
+
+  *count = 0;
+  pack_trits(prefix, hash, NUM_TRITS_HASH);
+
+  return kv_db_scan_prefix((kv_db_t*)connection->actual, KV_CF_APPROVEE, prefix, KV_HASH_SIZE, false, count_func,
+                           count);
+}
+
+typedef struct find_list_s {
+  kv_tangle_column_family_t column_family;
+  size_t field_size;
+  byte_t* fields;  // Packed fields, one after the other
+  size_t count;
+} find_list_t;
+
+static retcode_t find_list_init_243(find_list_t* const list, kv_tangle_column_family_t const column_family,
+                                    hash243_queue_t const queue) {
+  hash243_queue_entry_t* iter = NULL;
+  size_t i = 0;
+
+  list->column_family = column_family;
+  list->field_size = KV_HASH_SIZE;
+  list->count = hash243_queue_count(queue);
+  if (list->count != 0 && (list->fields = (byte_t*)malloc(list->count * list->field_size)) == NULL) {
+    return RC_OOM;
+  }
+  CDL_FOREACH(queue, iter) { pack_trits(list->fields + list->field_size * i++, iter->hash, NUM_TRITS_HASH); }
+
+  return RC_OK;
+}
+
+static retcode_t find_list_init_81(find_list_t* const list, kv_tangle_column_family_t const column_family,
+                                   hash81_queue_t const queue) {
+  hash81_queue_entry_t* iter = NULL;
+  size_t i = 0;
+
+  list->column_family = column_family;
+  list->field_size = KV_TAG_SIZE;
+  list->count = hash81_queue_count(queue);
+  if (list->count != 0 && (list->fields = (byte_t*)malloc(list->count * list->field_size)) == NULL) {
+    return RC_OOM;
+  }
+  CDL_FOREACH(queue, iter) { pack_trits(list->fields + list->field_size * i++, iter->hash, NUM_TRITS_TAG); }
+
+  return RC_OK;
+}
+
+// Tells whether a packed hash is indexed by any of the first fields of the list
+static retcode_t find_list_match(kv_db_t* const db, find_list_t const* const list, size_t const count,
+                                 byte_t const* const hash, bool* const match) {
+  retcode_t ret = RC_OK;
+  byte_t key[KV_INDEX_KEY_MAX_SIZE];
+
+  *match = false;
+  memcpy(key + list->field_size, hash, KV_HASH_SIZE);
+  for (size_t i = 0; i < count && !*match; i++) {
+    memcpy(key, list->fields + list->field_size * i, list->field_size);
+    if ((ret = kv_db_exist(db, list->column_family, key, list->field_size + KV_HASH_SIZE, match)) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
+// Keeps the hashes of the set indexed by any field of the list
+static retcode_t find_list_filter(kv_db_t* const db, find_list_t const* const list, hash243_set_t* const set) {
+  retcode_t ret = RC_OK;
+  hash243_set_entry_t *entry = NULL, *tmp = NULL;
+  byte_t hash[KV_HASH_SIZE];
+  bool exist = false;
+
+  HASH_ITER(hh, *set, entry, tmp) {
+    pack_trits(hash, entry->hash, NUM_TRITS_HASH);
+    if ((ret = find_list_match(db, list, list->count, hash, &exist)) != RC_OK) {
+      return ret;
+    }
+    if (!exist) {
+      hash243_set_remove_entry(set, entry);
+    }
+  }
+
+  return RC_OK;
+}
+
+static retcode_t kv_stor_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                          hash243_queue_t const addresses, hash81_queue_t const tags,
+                                          hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  find_list_t lists[4];
+  find_list_t const* first = NULL;
+  hash243_set_t found = NULL;
+  hash243_set_entry_t *entry = NULL, *tmp = NULL;
+  hash_scan_t scan = {.set = &found};
+
+  memset(lists, 0, sizeof(lists));
+  pack->insufficient_capacity = false;
+
+  if ((ret = find_list_init_243(&lists[0], KV_CF_BUNDLE, bundles)) != RC_OK ||
+      (ret = find_list_init_243(&lists[1], KV_CF_ADDRESS, addresses)) != RC_OK ||
+      (ret = find_list_init_81(&lists[2], KV_CF_TAG, tags)) != RC_OK ||
+      (ret = find_list_init_243(&lists[3], KV_CF_APPROVEE, approvees)) != RC_OK) {
+    goto done;
+  }
+
+  for (size_t i = 0; i < 4 && first == NULL; i++) {
+    if (lists[i].count != 0) {
+      first = &lists[i];
+    }
+  }
+
+  // Every transaction matches empty lists
+  if (first == NULL) {
+    scan.set = NULL;
+    scan.pack = pack;
+    ret = scan_hashes(db, KV_CF_METADATA, NULL, 0, &scan);
+    goto done;
+  }
+
+  // The transactions indexed by the first list are scanned, the others are checked against them
+  for (size_t i = 0; i < first->count; i++) {
+    if ((ret = scan_hashes(db, first->column_family, first->fields + first->field_size * i, first->field_size,
+                           &scan)) != RC_OK) {
+      goto done;
+    }
+  }
+  for (find_list_t const* list = first + 1; list < lists + 4; list++) {
+    if (list->count != 0 && (ret = find_list_filter(db, list, &found)) != RC_OK) {
+      goto done;
+    }
+  }
+
+  HASH_ITER(hh, found, entry, tmp) {
+    flex_trit_t* const model = (flex_trit_t*)pack_next(pack);
+
+    if (model == NULL) {
+      break;
+    }
+    memcpy(model, entry->hash, FLEX_TRIT_SIZE_243);
+  }
+
+done:
+  for (size_t i = 0; i < 4; i++) {
+    free(lists[i].fields);
+  }
+  hash243_set_free(&found);
+
+  return ret;
+}
+
+/*
+ * Cursor operations
+ *
+ * A cursor scans the index entries prefixed by each field of a list in turn, its position being the field scanned and
+ * the hash of the last transaction loaded from it, if any.
+ */
+
+#define KV_CURSOR_POSITION_SIZE (KV_UINT64_SIZE + KV_HASH_SIZE)
+
+typedef struct cursor_scan_s {
+  storage_connection_t const* connection;
+  storage_cursor_t* cursor;
+  iota_stor_pack_t* batch;
+  find_list_t const* lists;  // Lists of a find, NULL otherwise
+  find_list_t const* first;  // List whose fields are scanned
+  size_t field;              // Field being scanned
+  bool has_last;             // A transaction was loaded from the field, its hash being in the position
+  bool more;                 // The batch is full and more transactions are left
+  retcode_t ret;
+} cursor_scan_t;
+
+// Tells whether the transaction of an index entry is selected by the cursor
+static retcode_t cursor_select(cursor_scan_t const* const scan, byte_t const* const hash, byte_t const* const value,
+                               size_t const value_size, bool* const selected) {
+  kv_db_t* const db = (kv_db_t*)scan->connection->actual;
+  storage_cursor_t const* const cursor = scan->cursor;
+  retcode_t ret = RC_OK;
+  bool match = false;
+
+  *selected = false;
+  switch (cursor->type) {
+    case STORAGE_CURSOR_HASHES_BY_ADDRESS:
+      break;
+    case STORAGE_CURSOR_HASHES_OF_APPROVERS:
+      if (value_size != KV_UINT64_SIZE) {
+        return RC_KV_CORRUPTED_VALUE;
+      } else if (cursor->before_timestamp != 0 && (int64_t)decode_uint64(value) >= cursor->before_timestamp) {
+        return RC_OK;
+      }
+      break;
+    case STORAGE_CURSOR_HASHES_OF_MILESTONE_CANDIDATES:
+      if (value_size != KV_UINT64_SIZE) {
+        return RC_KV_CORRUPTED_VALUE;
+      } else if (decode_uint64(value) != 0) {
+        return RC_OK;
+      } else if ((ret = kv_db_exist(db, KV_CF_MILESTONE_HASH, hash, KV_HASH_SIZE, &match)) != RC_OK || match) {
+        return ret;
+      }
+      break;
+    case STORAGE_CURSOR_FIND:
+      if (scan->lists == NULL) {
+        break;
+      }
+      // Transactions indexed by an earlier field of the scanned list have already been loaded
+      if ((ret = find_list_match(db, scan->first, scan->field, hash, &match)) != RC_OK || match) {
+        return ret;
+      }
+      for (size_t i = 0; i < 4; i++) {
+        find_list_t const* const list = &scan->lists[i];
+
+        if (list != scan->first && list->count != 0 &&
+            ((ret = find_list_match(db, list, list->count, hash, &match)) != RC_OK || !match)) {
+          return ret;
+        }
+      }
+      break;
+  }
+  *selected = true;
+
+  return RC_OK;
+}
+
+static bool cursor_scan_func(void* const arg, byte_t const* const key, size_t const key_size,
+                             byte_t const* const value, size_t const value_size) {
+  cursor_scan_t* const scan = (cursor_scan_t*)arg;
+  iota_stor_pack_t* const batch = scan->batch;
+  byte_t const* const hash = key + scan->first->field_size;
+  flex_trit_t flex_hash[FLEX_TRIT_SIZE_243];
+  iota_stor_pack_t tx_pack;
+  bool selected = false;
+
+  if (key_size != scan->first->field_size + KV_HASH_SIZE) {
+    scan->ret = RC_KV_CORRUPTED_VALUE;
+    return false;
+  }
+  if ((scan->ret = cursor_select(scan, hash, value, value_size, &selected)) != RC_OK) {
+    return false;
+  } else if (!selected) {
+    return true;
+  }
+
+  if (batch->num_loaded == batch->capacity) {
+    scan->more = true;
+    return false;
+  }
+
+  if (scan->cursor->model == STORAGE_CURSOR_MODEL_HASH) {
+    unpack_trits((flex_trit_t*)batch->models[batch->num_loaded++], hash, NUM_TRITS_HASH);
+  } else {
+    tx_pack = (iota_stor_pack_t){.models = batch->models + batch->num_loaded, .capacity = 1, .num_loaded = 0};
+    unpack_trits(flex_hash, hash, NUM_TRITS_HASH);
+    if ((scan->ret = load_transaction_model(scan->connection, flex_hash, &tx_pack,
+                                            MODEL_TRANSACTION_ESSENCE_METADATA)) != RC_OK) {
+      return false;
+    }
+    // Indexed but not stored transactions are skipped
+    if (tx_pack.num_loaded == 1) {
+      transaction_set_hash((iota_transaction_t*)batch->models[batch->num_loaded++], flex_hash);
+    }
+  }
+  memcpy(scan->cursor->position + KV_UINT64_SIZE, hash, KV_HASH_SIZE);
+  scan->has_last = true;
+
+  return true;
+}
+
+static retcode_t kv_stor_cursor_next(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                     iota_stor_pack_t* const batch) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  find_list_t lists[4];
+  find_list_t key_list;
+  byte_t key[KV_HASH_SIZE];
+  byte_t begin[KV_INDEX_KEY_MAX_SIZE + 1];
+  size_t begin_size = 0;
+  cursor_scan_t scan = {.connection = connection, .cursor = cursor, .batch = batch, .ret = RC_OK};
+
+  memset(lists, 0, sizeof(lists));
+  batch->insufficient_capacity = false;
+
+  // A single field list for the cursors on an index key
+  pack_trits(key, cursor->key, NUM_TRITS_HASH);
+  key_list = (find_list_t){.field_size = KV_HASH_SIZE, .fields = key, .count = 1};
+  scan.first = &key_list;
+
+  switch (cursor->type) {
+    case STORAGE_CURSOR_HASHES_BY_ADDRESS:
+    case STORAGE_CURSOR_HASHES_OF_MILESTONE_CANDIDATES:
+      key_list.column_family = KV_CF_ADDRESS;
+      break;
+    case STORAGE_CURSOR_HASHES_OF_APPROVERS:
+      key_list.column_family = KV_CF_APPROVEE;
+      break;
+    case STORAGE_CURSOR_FIND:
+      if ((ret = find_list_init_243(&lists[0], KV_CF_BUNDLE, cursor->bundles)) != RC_OK ||
+          (ret = find_list_init_243(&lists[1], KV_CF_ADDRESS, cursor->addresses)) != RC_OK ||
+          (ret = find_list_init_81(&lists[2], KV_CF_TAG, cursor->tags)) != RC_OK ||
+          (ret = find_list_init_243(&lists[3], KV_CF_APPROVEE, cursor->approvees)) != RC_OK) {
+        goto done;
+      }
+      for (size_t i = 0; i < 4 && scan.lists == NULL; i++) {
+        if (lists[i].count != 0) {
+          scan.lists = lists;
+          scan.first = &lists[i];
+        }
+      }
+      // Every transaction matches empty lists
+      if (scan.lists == NULL) {
+        key_list = (find_list_t){.column_family = KV_CF_METADATA, .field_size = 0, .fields = key, .count = 1};
+      }
+      break;
+  }
+
+  if (cursor->position_size == KV_UINT64_SIZE || cursor->position_size == KV_CURSOR_POSITION_SIZE) {
+    scan.field = decode_uint64(cursor->position);
+    scan.has_last = cursor->position_size == KV_CURSOR_POSITION_SIZE;
+  }
+
+  for (; scan.field < scan.first->count; scan.field++, scan.has_last = false) {
+    byte_t const* const prefix = scan.first->fields + scan.first->field_size * scan.field;
+
+    // Resumes right after the last transaction loaded from the field
+    memcpy(begin, prefix, scan.first->field_size);
+    begin_size = scan.first->field_size;
+    if (scan.has_last) {
+      memcpy(begin + begin_size, cursor->position + KV_UINT64_SIZE, KV_HASH_SIZE);
+      begin_size += KV_HASH_SIZE;
+      begin[begin_size++] = 0;
+    }
+    if ((ret = kv_db_scan_prefix_from(db, scan.first->column_family, prefix, scan.first->field_size, begin,
+                                      begin_size, cursor_scan_func, &scan)) != RC_OK ||
+        (ret = scan.ret) != RC_OK || scan.more) {
+      break;
+    }
+  }
+
+  if (ret == RC_OK) {
+    encode_uint64(cursor->position, scan.field);
+    cursor->position_size = scan.has_last ? KV_CURSOR_POSITION_SIZE : KV_UINT64_SIZE;
+    cursor->done = !scan.more;
+  }
+
+done:
+  for (size_t i = 0; i < 4; i++) {
+    free(lists[i].fields);
+  }
+
+  return ret;
+}
+
+typedef struct metadata_clear_scan_s {
+  kv_write_batch_t batch;
+  byte_t next[KV_HASH_SIZE + 1];  // Smallest key after the last one cleared
+  size_t next_size;
+  size_t count;
+  retcode_t ret;
+} metadata_clear_scan_t;
+
+static bool metadata_clear_func(void* const arg, byte_t const* const key, size_t const key_size,
+                                byte_t const* const value, size_t const value_size) {
+  metadata_clear_scan_t* const scan = (metadata_clear_scan_t*)arg;
+  byte_t bytes[KV_METADATA_SIZE];
+  kv_metadata_t metadata;
+
+  if (key_size != KV_HASH_SIZE || value_size != KV_METADATA_SIZE) {
+    scan->ret = RC_KV_CORRUPTED_VALUE;
+    return false;
+  }
+
+  metadata_decode(&metadata, value);
+  metadata.snapshot_index = 0;
+  metadata.solid = false;
+  metadata.validity = 0;
+  metadata_encode(bytes, &metadata);
+  if ((scan->ret = kv_write_batch_put(&scan->batch, KV_CF_METADATA, key, key_size, bytes, KV_METADATA_SIZE)) !=
+      RC_OK) {
+    return false;
+  }
+
+  memcpy(scan->next, key, key_size);
+  scan->next[key_size] = 0;
+  scan->next_size = key_size + 1;
+
+  return ++scan->count < KV_METADATA_CLEAR_CHUNK_SIZE;
+}
+
+static retcode_t kv_stor_transaction_metadata_clear(storage_connection_t const* const connection) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  metadata_clear_scan_t scan = {.next_size = 0, .ret = RC_OK};
+
+  // The metadata are rewritten by chunks as a scan can't write the column family it reads
+  kv_write_batch_init(&scan.batch);
+  do {
+    kv_write_batch_reset(&scan.batch);
+    scan.count = 0;
+    if ((ret = kv_db_scan(db, KV_CF_METADATA, scan.next, scan.next_size, NULL, 0, false, metadata_clear_func,
+                          &scan)) != RC_OK ||
+        (ret = scan.ret) != RC_OK || (ret = kv_db_write(db, &scan.batch, scan.count)) != RC_OK) {
+      break;
+    }
+  } while (scan.count == KV_METADATA_CLEAR_CHUNK_SIZE);
+  kv_write_batch_destroy(&scan.batch);
+
+  return ret;
+}
+
+typedef struct delete_params_s {
+  kv_db_t* db;
+  kv_write_batch_t batch;
+} delete_params_t;
+
+static retcode_t delete_transaction_func(delete_params_t* const params, flex_trit_t const* const hash) {
+  retcode_t ret = RC_OK;
+  byte_t key[KV_INDEX_KEY_MAX_SIZE];
+  byte_t packed_hash[KV_HASH_SIZE];
+  iota_transaction_t tx;
+  size_t size = 0;
+  bool found = false;
+
+  pack_trits(packed_hash, hash, NUM_TRITS_HASH);
+  if ((ret = load_transaction(params->db, packed_hash, &tx, &found)) != RC_OK || !found) {
+    return ret;
+  }
+
+  ret = kv_write_batch_delete(&params->batch, KV_CF_TRANSACTION, packed_hash, KV_HASH_SIZE);
+  ret |= kv_write_batch_delete(&params->batch, KV_CF_METADATA, packed_hash, KV_HASH_SIZE);
+  size = index_key(key, tx.essence.address, NUM_TRITS_ADDRESS, packed_hash);
+  ret |= kv_write_batch_delete(&params->batch, KV_CF_ADDRESS, key, size);
+  size = index_key(key, tx.essence.bundle, NUM_TRITS_BUNDLE, packed_hash);
+  ret |= kv_write_batch_delete(&params->batch, KV_CF_BUNDLE, key, size);
+  size = index_key(key, tx.attachment.tag, NUM_TRITS_TAG, packed_hash);
+  ret |= kv_write_batch_delete(&params->batch, KV_CF_TAG, key, size);
+  size = index_key(key, tx.attachment.trunk, NUM_TRITS_TRUNK, packed_hash);
+  ret |= kv_write_batch_delete(&params->batch, KV_CF_APPROVEE, key, size);
+  size = index_key(key, tx.attachment.branch, NUM_TRITS_BRANCH, packed_hash);
+  ret |= kv_write_batch_delete(&params->batch, KV_CF_APPROVEE, key, size);
+
+  return ret;
+}
+
+static retcode_t kv_stor_transactions_delete(storage_connection_t const* const connection,
+                                             hash243_set_t const hashes) {
+  retcode_t ret = RC_OK;
+  delete_params_t params = {.db = (kv_db_t*)connection->actual};
+
+  kv_write_batch_init(&params.batch);
+  if ((ret = hash243_set_for_each(hashes, (hash243_on_container_func)delete_transaction_func, &params)) == RC_OK) {
+    ret = kv_db_write(params.db, &params.batch, hash243_set_size(hashes));
+  }
+  kv_write_batch_destroy(&params.batch);
+
+  return ret;
+}
+
+/*
+ * Bundle operations
+ */
+
+static retcode_t kv_stor_bundle_update_validity(storage_connection_t const* const connection,
+                                                bundle_transactions_t const* const bundle,
+                                                bundle_status_t const status) {
+  retcode_t ret = RC_OK;
+  metadata_update_t update = {.db = (kv_db_t*)connection->actual, .field = METADATA_VALIDITY, .value = status};
+  iota_transaction_t* tx = NULL;
+
+  kv_write_batch_init(&update.batch);
+  BUNDLE_FOREACH(bundle, tx) {
+    if ((ret = metadata_update_func(&update, transaction_hash(tx))) != RC_OK) {
+      goto done;
+    }
+  }
+  ret = kv_db_write(update.db, &update.batch, bundle_transactions_size(bundle));
+
+done:
+  kv_write_batch_destroy(&update.batch);
+
+  return ret;
+}
+
+/*
+ * Milestone operations
+ */
+
+typedef struct milestone_scan_s {
+  iota_stor_pack_t* pack;
+  retcode_t ret;
+} milestone_scan_t;
+
+// Loads the first milestone scanned
+static bool milestone_scan_func(void* const arg, byte_t const* const key, size_t const key_size,
+                                byte_t const* const value, size_t const value_size) {
+  milestone_scan_t* const scan = (milestone_scan_t*)arg;
+  iota_milestone_t* milestone = NULL;
+
+  if (key_size != KV_UINT64_SIZE || value_size != KV_HASH_SIZE) {
+    scan->ret = RC_KV_CORRUPTED_VALUE;
+  } else if ((milestone = (iota_milestone_t*)pack_next(scan->pack)) != NULL) {
+    milestone->index = decode_uint64(key);
+    unpack_trits(milestone->hash, value, NUM_TRITS_HASH);
+  }
+
+  return false;
+}
+
+static retcode_t milestone_scan(storage_connection_t const* const connection, byte_t const* const begin,
+                                size_t const begin_size, bool const reverse, iota_stor_pack_t* const pack) {
+  retcode_t ret = RC_OK;
+  milestone_scan_t scan = {.pack = pack, .ret = RC_OK};
+
+  pack->insufficient_capacity = false;
+  if ((ret = kv_db_scan((kv_db_t*)connection->actual, KV_CF_MILESTONE, begin, begin_size, NULL, 0, reverse,
+                        milestone_scan_func, &scan)) != RC_OK) {
+    return ret;
+  }
+
+  return scan.ret;
+}
+
+static retcode_t kv_stor_milestone_clear(storage_connection_t const* const connection) {
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+
+  kv_write_batch_init(&batch);
+  ret = kv_write_batch_clear(&batch, KV_CF_MILESTONE);
+  ret |= kv_write_batch_clear(&batch, KV_CF_MILESTONE_HASH);
+  ret |= kv_write_batch_clear(&batch, KV_CF_STATE_DELTA);
+  if (ret == RC_OK) {
+    ret = kv_db_write((kv_db_t*)connection->actual, &batch, 0);
+  }
+  kv_write_batch_destroy(&batch);
+
+  return ret;
+}
+
+static retcode_t kv_stor_milestone_store(storage_connection_t const* const connection,
+                                         iota_milestone_t const* const milestone) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+  byte_t index[KV_UINT64_SIZE];
+  byte_t hash[KV_HASH_SIZE];
+  bool index_exist = false, hash_exist = false;
+
+  encode_uint64(index, milestone->index);
+  pack_trits(hash, milestone->hash, NUM_TRITS_HASH);
+  if ((ret = kv_db_exist(db, KV_CF_MILESTONE, index, KV_UINT64_SIZE, &index_exist)) != RC_OK ||
+      (ret = kv_db_exist(db, KV_CF_MILESTONE_HASH, hash, KV_HASH_SIZE, &hash_exist)) != RC_OK) {
+    return ret;
+  } else if (index_exist || hash_exist) {
+    return RC_KV_KEY_EXISTS;
+  }
+
+  kv_write_batch_init(&batch);
+  ret = kv_write_batch_put(&batch, KV_CF_MILESTONE, index, KV_UINT64_SIZE, hash, KV_HASH_SIZE);
+  ret |= kv_write_batch_put(&batch, KV_CF_MILESTONE_HASH, hash, KV_HASH_SIZE, index, KV_UINT64_SIZE);
+  if (ret == RC_OK) {
+    ret = kv_db_write(db, &batch, 1);
+  }
+  kv_write_batch_destroy(&batch);
+
+  return ret;
+}
+
+static retcode_t kv_stor_milestone_load(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                        iota_stor_pack_t* const pack) {
+  retcode_t ret = RC_OK;
+  byte_t key[KV_HASH_SIZE];
+  byte_t index[KV_UINT64_SIZE];
+  iota_milestone_t* milestone = NULL;
+  bool found = false;
+
+  pack->insufficient_capacity = false;
+  pack_trits(key, hash, NUM_TRITS_HASH);
+  if ((ret = get_value((kv_db_t*)connection->actual, KV_CF_MILESTONE_HASH, key, KV_HASH_SIZE, index, KV_UINT64_SIZE,
+                       &found)) != RC_OK ||
+      !found) {
+    return ret;
+  }
+
+  if ((milestone = (iota_milestone_t*)pack_next(pack)) != NULL) {
+    milestone->index = decode_uint64(index);
+    memcpy(milestone->hash, hash, FLEX_TRIT_SIZE_243);
+  }
+
+  return RC_OK;
+}
+
+static retcode_t kv_stor_milestone_load_last(storage_connection_t const* const connection,
+                                             iota_stor_pack_t* const pack) {
+  return milestone_scan(connection, NULL, 0, true, pack);
+}
+
+static retcode_t kv_stor_milestone_load_first(storage_connection_t const* const connection,
+                                              iota_stor_pack_t* const pack) {
+  return milestone_scan(connection, NULL, 0, false, pack);
+}
+
+static retcode_t kv_stor_milestone_load_by_index(storage_connection_t const* const connection, uint64_t const index,
+                                                 iota_stor_pack_t* const pack) {
+  retcode_t ret = RC_OK;
+  byte_t key[KV_UINT64_SIZE];
+  byte_t hash[KV_HASH_SIZE];
+  iota_milestone_t* milestone = NULL;
+  bool found = false;
+
+  pack->insufficient_capacity = false;
+  encode_uint64(key, index);
+  if ((ret = get_value((kv_db_t*)connection->actual, KV_CF_MILESTONE, key, KV_UINT64_SIZE, hash, KV_HASH_SIZE,
+                       &found)) != RC_OK ||
+      !found) {
+    return ret;
+  }
+
+  if ((milestone = (iota_milestone_t*)pack_next(pack)) != NULL) {
+    milestone->index = index;
+    unpack_trits(milestone->hash, hash, NUM_TRITS_HASH);
+  }
+
+  return RC_OK;
+}
+
+static retcode_t kv_stor_milestone_load_next(storage_connection_t const* const connection, uint64_t const index,
+                                             iota_stor_pack_t* const pack) {
+  byte_t key[KV_UINT64_SIZE];
+
+  if (index == UINT64_MAX) {
+    pack->insufficient_capacity = false;
+    return RC_OK;
+  }
+  encode_uint64(key, index + 1);
+
+  return milestone_scan(connection, key, KV_UINT64_SIZE, false, pack);
+}
+
+static retcode_t kv_stor_milestone_exist(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                         bool* const exist) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  byte_t key[KV_HASH_SIZE];
+
+  if (hash == NULL) {
+    return kv_db_exist(db, KV_CF_MILESTONE, NULL, 0, exist);
+  }
+  pack_trits(key, hash, NUM_TRITS_HASH);
+
+  return kv_db_exist(db, KV_CF_MILESTONE_HASH, key, KV_HASH_SIZE, exist);
+}
+
+static retcode_t kv_stor_milestone_delete(storage_connection_t const* const connection,
+                                          flex_trit_t const* const hash) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+  byte_t key[KV_HASH_SIZE];
+  byte_t index[KV_UINT64_SIZE];
+  bool found = false;
+
+  pack_trits(key, hash, NUM_TRITS_HASH);
+  if ((ret = get_value(db, KV_CF_MILESTONE_HASH, key, KV_HASH_SIZE, index, KV_UINT64_SIZE, &found)) != RC_OK ||
+      !found) {
+    return ret;
+  }
+
+  kv_write_batch_init(&batch);
+  ret = kv_write_batch_delete(&batch, KV_CF_MILESTONE_HASH, key, KV_HASH_SIZE);
+  ret |= kv_write_batch_delete(&batch, KV_CF_MILESTONE, index, KV_UINT64_SIZE);
+  ret |= kv_write_batch_delete(&batch, KV_CF_STATE_DELTA, index, KV_UINT64_SIZE);
+  if (ret == RC_OK) {
+    ret = kv_db_write(db, &batch, 1);
+  }
+  kv_write_batch_destroy(&batch);
+
+  return ret;
+}
+
+/*
+ * State delta operations
+ */
+
+static retcode_t kv_stor_state_delta_store(storage_connection_t const* const connection, uint64_t const index,
+                                           state_delta_t const* const delta) {
+  kv_db_t* const db = (kv_db_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+  byte_t key[KV_UINT64_SIZE];
+  byte_t* bytes = NULL;
+  size_t size = 0;
+  bool exist = false;
+
+  // A state delta is stored along an existing milestone
+  encode_uint64(key, index);
+  if ((ret = kv_db_exist(db, KV_CF_MILESTONE, key, KV_UINT64_SIZE, &exist)) != RC_OK || !exist) {
+    return ret;
+  }
+
+  size = state_delta_serialized_size(delta);
+  if ((bytes = (byte_t*)calloc(size + 1, sizeof(byte_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  kv_write_batch_init(&batch);
+  if ((ret = state_delta_serialize(delta, bytes)) == RC_OK &&
+      (ret = kv_write_batch_put(&batch, KV_CF_STATE_DELTA, key, KV_UINT64_SIZE, bytes, size)) == RC_OK) {
+    ret = kv_db_write(db, &batch, 1);
+  }
+  kv_write_batch_destroy(&batch);
+  free(bytes);
+
+  return ret;
+}
+
+typedef struct state_delta_load_s {
+  state_delta_t* delta;
+  retcode_t ret;
+} state_delta_load_t;
+
+static bool state_delta_load_func(void* const arg, byte_t const* const key, size_t const key_size,
+                                  byte_t const* const value, size_t const value_size) {
+  state_delta_load_t* const load = (state_delta_load_t*)arg;
+
+  UNUSED(key);
+  UNUSED(key_size);
+  load->ret = state_delta_deserialize(value, value_size, load->delta);
+
+  return false;
+}
+
+static retcode_t kv_stor_state_delta_load(storage_connection_t const* const connection, uint64_t const index,
+                                          state_delta_t* const delta) {
+  retcode_t ret = RC_OK;
+  byte_t key[KV_UINT64_SIZE];
+  state_delta_load_t load = {.delta = delta, .ret = RC_OK};
+  bool found = false;
+
+  *delta = NULL;
+  encode_uint64(key, index);
+  if ((ret = kv_db_get((kv_db_t*)connection->actual, KV_CF_STATE_DELTA, key, KV_UINT64_SIZE, state_delta_load_func,
+                       &load, &found)) != RC_OK) {
+    return ret;
+  }
+
+  return load.ret;
+}
+
+/*
+ * Spent address operations
+ */
+
+static retcode_t spent_address_put_func(kv_write_batch_t* const batch, flex_trit_t const* const address) {
+  byte_t key[KV_HASH_SIZE];
+
+  pack_trits(key, address, NUM_TRITS_ADDRESS);
+
+  return kv_write_batch_put(batch, KV_CF_SPENT_ADDRESS, key, KV_HASH_SIZE, NULL, 0);
+}
+
+static retcode_t kv_stor_spent_address_store(storage_connection_t const* const connection,
+                                             flex_trit_t const* const address) {
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+
+  kv_write_batch_init(&batch);
+  if ((ret = spent_address_put_func(&batch, address)) == RC_OK) {
+    ret = kv_db_write((kv_db_t*)connection->actual, &batch, 1);
+  }
+  kv_write_batch_destroy(&batch);
+
+  return ret;
+}
+
+static retcode_t kv_stor_spent_addresses_store(storage_connection_t const* const connection,
+                                               hash243_set_t const addresses) {
+  retcode_t ret = RC_OK;
+  kv_write_batch_t batch;
+
+  kv_write_batch_init(&batch);
+  if ((ret = hash243_set_for_each(addresses, (hash243_on_container_func)spent_address_put_func, &batch)) == RC_OK) {
+    ret = kv_db_write((kv_db_t*)connection->actual, &batch, hash243_set_size(addresses));
+  }
+  kv_write_batch_destroy(&batch);
+
+  return ret;
+}
+
+static retcode_t kv_stor_spent_address_exist(storage_connection_t const* const connection,
+                                             flex_trit_t const* const address, bool* const exist) {
+  byte_t key[KV_HASH_SIZE];
+
+  pack_trits(key, address, NUM_TRITS_ADDRESS);
+
+  return kv_db_exist((kv_db_t*)connection->actual, KV_CF_SPENT_ADDRESS, key, KV_HASH_SIZE, exist);
+}
+
+storage_backend_t const kv_storage_backend = {
+    .name = "kv",
+    .init = kv_storage_init,
+    .destroy = kv_storage_destroy,
+    .connection_init = kv_connection_init,
+    .connection_destroy = kv_connection_destroy,
+    .connection_flush = kv_connection_flush,
+    .connection_pending_batch = kv_connection_pending_batch,
+    .transaction_count = kv_stor_transaction_count,
+    .transaction_store = kv_stor_transaction_store,
+    .transaction_load = kv_stor_transaction_load,
+    .transaction_load_essence_and_metadata = kv_stor_transaction_load_essence_and_metadata,
+    .transaction_load_essence_attachment_and_metadata = kv_stor_transaction_load_essence_attachment_and_metadata,
+    .transaction_load_essence_and_consensus = kv_stor_transaction_load_essence_and_consensus,
+    .transaction_load_metadata = kv_stor_transaction_load_metadata,
+    .transaction_exist = kv_stor_transaction_exist,
+    .transaction_update_snapshot_index = kv_stor_transaction_update_snapshot_index,
+    .transactions_update_snapshot_index = kv_stor_transactions_update_snapshot_index,
+    .transaction_update_solid_state = kv_stor_transaction_update_solid_state,
+    .transactions_update_solid_state = kv_stor_transactions_update_solid_state,
+    .transaction_load_hashes = kv_stor_transaction_load_hashes,
+    .transaction_load_hashes_of_approvers = kv_stor_transaction_load_hashes_of_approvers,
+    .transaction_load_hashes_of_milestone_candidates = kv_stor_transaction_load_hashes_of_milestone_candidates,
+    .transaction_approvers_count = kv_stor_transaction_approvers_count,
+    .transaction_find = kv_stor_transaction_find,
+    .cursor_next = kv_stor_cursor_next,
+    .transaction_metadata_clear = kv_stor_transaction_metadata_clear,
+    .transactions_delete = kv_stor_transactions_delete,
+    .bundle_update_validity = kv_stor_bundle_update_validity,
+    .milestone_clear = kv_stor_milestone_clear,
+    .milestone_store = kv_stor_milestone_store,
+    .milestone_load = kv_stor_milestone_load,
+    .milestone_load_last = kv_stor_milestone_load_last,
+    .milestone_load_first = kv_stor_milestone_load_first,
+    .milestone_load_by_index = kv_stor_milestone_load_by_index,
+    .milestone_load_next = kv_stor_milestone_load_next,
+    .milestone_exist = kv_stor_milestone_exist,
+    .milestone_delete = kv_stor_milestone_delete,
+    .state_delta_store = kv_stor_state_delta_store,
+    .state_delta_load = kv_stor_state_delta_load,
+    .spent_address_store = kv_stor_spent_address_store,
+    .spent_addresses_store = kv_stor_spent_addresses_store,
+    .spent_address_exist = kv_stor_spent_address_exist,
+};
@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity/unity.h>
+
+#include "common/helpers/digest.h"
+#include "common/model/milestone.h"
+#include "common/model/transaction.h"
+#include "common/storage/kv/connection.h"
+#include "common/storage/kv/engine.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/defs.h"
+#include "utils/containers/hash/hash243_queue.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/containers/hash/hash81_queue.h"
+
+#define HASH_LENGTH 243
+
+static char *test_db_path = "common/storage/kv/tests/test.db";
+static char *engine_db_path = "common/storage/kv/tests/engine.db";
+
+static storage_connection_t connection;
+static iota_transaction_t *test_tx;
+static iota_transaction_t txs[3];
+
+static void remove_db(char const *const path) {
+  char file[128];
+
+  remove(path);
+  snprintf(file, sizeof(file), "%s-lock", path);
+  remove(file);
+}
+
+static void load_test_transactions(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  test_tx = transaction_deserialize(tx_test_trits, true);
+
+  // A bundle of three transactions, the second and third ones approving the first one
+  for (int i = 0; i < 3; i++) {
+    txs[i] = *test_tx;
+    flex_trits_set_at(txs[i].consensus.hash, FLEX_TRIT_SIZE_243, 4, i - 1);
+    flex_trits_set_at(txs[i].consensus.hash, FLEX_TRIT_SIZE_243, 5, 1);
+    transaction_set_current_index(&txs[i], i);
+    transaction_set_last_index(&txs[i], 2);
+    if (i != 0) {
+      transaction_set_trunk(&txs[i], transaction_hash(&txs[0]));
+    }
+  }
+  flex_trits_set_at(txs[2].essence.address, FLEX_TRIT_SIZE_243, 0, 1);
+  flex_trits_set_at(txs[2].essence.address, FLEX_TRIT_SIZE_243, 1, 1);
+}
+
+static bool collect_key_func(void *const arg, byte_t const *const key, size_t const key_size,
+                             byte_t const *const value, size_t const value_size) {
+  size_t *const count = (size_t *)arg;
+
+  TEST_ASSERT_EQUAL_INT(2, key_size);
+  TEST_ASSERT_EQUAL_INT(1, value_size);
+  TEST_ASSERT_EQUAL_INT(key[1], value[0]);
+  (*count)++;
+
+  return true;
+}
+
+void test_engine(void) {
+  char const *column_families[] = {"a", "b"};
+  connection_config_t config = {.db_path = engine_db_path};
+  kv_db_t *db = NULL;
+  kv_write_batch_t batch;
+  byte_t key[2], value[1];
+  byte_t const prefix[] = {(byte_t)0xFF};
+  size_t count = 0;
+  bool exist = false;
+
+  remove_db(engine_db_path);
+  TEST_ASSERT(kv_db_open(&db, &config, column_families, 2) == RC_OK);
+  kv_write_batch_init(&batch);
+
+  // Keys sort bytewise, a prefix of 0xFF scans up to the last key
+  for (int i = 0; i < 256; i++) {
+    key[0] = (byte_t)(i % 2 ? 0xFF : 0x7F);
+    key[1] = value[0] = (byte_t)i;
+    TEST_ASSERT(kv_write_batch_put(&batch, 0, key, 2, value, 1) == RC_OK);
+  }
+  TEST_ASSERT(kv_db_write(db, &batch, batch.size) == RC_OK);
+  TEST_ASSERT(kv_db_count(db, 0, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(256, count);
+
+  count = 0;
+  TEST_ASSERT(kv_db_scan_prefix(db, 0, prefix, 1, false, collect_key_func, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(128, count);
+
+  // Column families are distinct key spaces
+  TEST_ASSERT(kv_db_exist(db, 1, NULL, 0, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  // Writes of a batch apply in order
+  kv_write_batch_reset(&batch);
+  TEST_ASSERT(kv_write_batch_clear(&batch, 0) == RC_OK);
+  TEST_ASSERT(kv_write_batch_put(&batch, 0, key, 2, value, 1) == RC_OK);
+  TEST_ASSERT(kv_write_batch_put(&batch, 1, key, 2, value, 1) == RC_OK);
+  TEST_ASSERT(kv_write_batch_delete(&batch, 1, key, 2) == RC_OK);
+  TEST_ASSERT(kv_db_write(db, &batch, batch.size) == RC_OK);
+  TEST_ASSERT(kv_db_count(db, 0, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, count);
+  TEST_ASSERT(kv_db_exist(db, 1, NULL, 0, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  kv_write_batch_destroy(&batch);
+  TEST_ASSERT(kv_db_close(db) == RC_OK);
+
+  // A file that is not an LMDB database is refused
+  TEST_ASSERT(kv_db_open(&db, &config, column_families, 2) == RC_OK);
+  TEST_ASSERT(kv_db_close(db) == RC_OK);
+  config.db_path = "common/storage/sql/sqlite3/tests/ciri.db";
+  TEST_ASSERT(kv_db_open(&db, &config, column_families, 2) == RC_KV_FAILED_OPEN_DB);
+  remove_db(engine_db_path);
+}
+
+void test_init_connection(void) {
+  connection_config_t config = {.db_path = test_db_path, .backend = STORAGE_BACKEND_KV};
+
+  remove_db(test_db_path);
+  TEST_ASSERT(connection_init(&connection, &config, STORAGE_CONNECTION_TANGLE) == RC_OK);
+}
+
+void test_destroy_connection(void) {
+  TEST_ASSERT(connection_destroy(&connection) == RC_OK);
+  remove_db(test_db_path);
+}
+
+void test_stored_transaction(void) {
+  iota_transaction_t *loaded[2];
+  iota_stor_pack_t pack = {.models = (void **)loaded, .capacity = 2, .num_loaded = 0, .insufficient_capacity = false};
+  size_t count = 0;
+  bool exist = false;
+
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_NONE, NULL, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  for (int i = 0; i < 3; i++) {
+    TEST_ASSERT(iota_stor_transaction_store(&connection, &txs[i]) == RC_OK);
+  }
+  TEST_ASSERT(iota_stor_transaction_store(&connection, &txs[0]) == RC_KV_KEY_EXISTS);
+  TEST_ASSERT(iota_stor_transaction_count(&connection, &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, count);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&txs[1]), &exist) ==
+              RC_OK);
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &exist) ==
+              RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  loaded[0] = transaction_new();
+  loaded[1] = transaction_new();
+  TEST_ASSERT(iota_stor_transaction_load(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&txs[1]), &pack) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_signature(loaded[0]), transaction_signature(&txs[1]), FLEX_TRIT_SIZE_6561);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_address(loaded[0]), transaction_address(&txs[1]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_trunk(loaded[0]), transaction_hash(&txs[0]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_branch(loaded[0]), transaction_branch(&txs[1]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_tag(loaded[0]), transaction_tag(&txs[1]), FLEX_TRIT_SIZE_81);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_nonce(loaded[0]), transaction_nonce(&txs[1]), FLEX_TRIT_SIZE_81);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(loaded[0]), transaction_hash(&txs[1]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_INT(transaction_value(loaded[0]), transaction_value(&txs[1]));
+  TEST_ASSERT_EQUAL_INT(transaction_timestamp(loaded[0]), transaction_timestamp(&txs[1]));
+  TEST_ASSERT_EQUAL_INT(1, transaction_current_index(loaded[0]));
+  TEST_ASSERT_EQUAL_INT(transaction_attachment_timestamp(loaded[0]), transaction_attachment_timestamp(&txs[1]));
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_essence_and_metadata(&connection, transaction_hash(&txs[2]), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(2, transaction_current_index(loaded[0]));
+  TEST_ASSERT_EQUAL_INT(0, transaction_snapshot_index(loaded[0]));
+  TEST_ASSERT(transaction_arrival_timestamp(loaded[0]) > 0);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(test_tx), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  transaction_free(loaded[0]);
+  transaction_free(loaded[1]);
+}
+
+void test_load_hashes(void) {
+  flex_trit_t hashes[2][FLEX_TRIT_SIZE_243];
+  flex_trit_t *models[2] = {hashes[0], hashes[1]};
+  iota_stor_pack_t pack = {.models = (void **)models, .capacity = 2, .num_loaded = 0, .insufficient_capacity = false};
+  size_t count = 0;
+
+  TEST_ASSERT(iota_stor_transaction_load_hashes(&connection, TRANSACTION_FIELD_ADDRESS, transaction_address(&txs[0]),
+                                                &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, pack.num_loaded);
+  TEST_ASSERT_FALSE(pack.insufficient_capacity);
+
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_approvers(&connection, transaction_hash(&txs[0]), &pack, 0) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, pack.num_loaded);
+  TEST_ASSERT(iota_stor_transaction_approvers_count(&connection, transaction_hash(&txs[0]), &count) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, count);
+
+  // Only the approvers arrived before the timestamp
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_approvers(&connection, transaction_hash(&txs[0]), &pack, 1) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  // A full pack reports its insufficient capacity
+  pack.capacity = 1;
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_approvers(&connection, transaction_hash(&txs[0]), &pack, 0) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(pack.insufficient_capacity);
+
+  // The tails of the coordinator address not yet known as milestones
+  pack.capacity = 2;
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_hashes_of_milestone_candidates(&connection, &pack,
+                                                                        transaction_address(&txs[0])) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[0]), hashes[0], FLEX_TRIT_SIZE_243);
+}
+
+void test_find(void) {
+  flex_trit_t hashes[4][FLEX_TRIT_SIZE_243];
+  flex_trit_t *models[4] = {hashes[0], hashes[1], hashes[2], hashes[3]};
+  iota_stor_pack_t pack = {.models = (void **)models, .capacity = 4, .num_loaded = 0, .insufficient_capacity = false};
+  hash243_queue_t bundles = NULL, addresses = NULL, approvees = NULL;
+  hash81_queue_t tags = NULL;
+
+  // Every transaction matches empty lists
+  TEST_ASSERT(iota_stor_transaction_find(&connection, bundles, addresses, tags, approvees, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, pack.num_loaded);
+
+  hash243_queue_push(&bundles, transaction_bundle(&txs[0]));
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_find(&connection, bundles, addresses, tags, approvees, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, pack.num_loaded);
+
+  // The lists are intersected
+  hash243_queue_push(&addresses, transaction_address(&txs[2]));
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_find(&connection, bundles, addresses, tags, approvees, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[2]), hashes[0], FLEX_TRIT_SIZE_243);
+
+  hash243_queue_push(&addresses, transaction_address(&txs[0]));
+  hash243_queue_push(&approvees, transaction_hash(&txs[0]));
+  hash81_queue_push(&tags, transaction_tag(&txs[0]));
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_find(&connection, bundles, addresses, tags, approvees, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, pack.num_loaded);
+
+  hash243_queue_free(&bundles);
+  hash243_queue_free(&addresses);
+  hash243_queue_free(&approvees);
+  hash81_queue_free(&tags);
+}
+
+void test_cursor(void) {
+  flex_trit_t hashes[2][FLEX_TRIT_SIZE_243];
+  flex_trit_t *models[2] = {hashes[0], hashes[1]};
+  iota_stor_pack_t pack = {.models = (void **)models, .capacity = 1, .num_loaded = 0, .insufficient_capacity = false};
+  iota_transaction_t loaded;
+  iota_transaction_t *loaded_ptr = &loaded;
+  iota_stor_pack_t tx_pack = {
+      .models = (void **)&loaded_ptr, .capacity = 1, .num_loaded = 0, .insufficient_capacity = false};
+  hash243_queue_t approvees = NULL;
+  hash243_set_t found = NULL;
+  storage_cursor_t cursor;
+
+  // Batches of one, the cursor being done with the last transaction
+  storage_cursor_init_hashes_by_address(&cursor, STORAGE_CURSOR_MODEL_HASH, transaction_address(&txs[0]));
+  TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_FALSE(cursor.done);
+  hash243_set_add(&found, hashes[0]);
+  hash_pack_reset(&pack);
+  TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(cursor.done);
+  hash243_set_add(&found, hashes[0]);
+  TEST_ASSERT_EQUAL_INT(2, hash243_set_size(found));
+  TEST_ASSERT_TRUE(hash243_set_contains(found, transaction_hash(&txs[0])));
+  TEST_ASSERT_TRUE(hash243_set_contains(found, transaction_hash(&txs[1])));
+  hash243_set_free(&found);
+
+  // Transactions are loaded with their hash
+  storage_cursor_init_hashes_of_approvers(&cursor, STORAGE_CURSOR_MODEL_ESSENCE_METADATA, transaction_hash(&txs[0]),
+                                          0);
+  while (!cursor.done) {
+    hash_pack_reset(&tx_pack);
+    TEST_ASSERT(storage_cursor_next(&connection, &cursor, &tx_pack) == RC_OK);
+    if (tx_pack.num_loaded == 1) {
+      TEST_ASSERT(transaction_current_index(&loaded) == 1 || transaction_current_index(&loaded) == 2);
+      TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[transaction_current_index(&loaded)]), transaction_hash(&loaded),
+                               FLEX_TRIT_SIZE_243);
+      hash243_set_add(&found, transaction_hash(&loaded));
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(2, hash243_set_size(found));
+  hash243_set_free(&found);
+
+  storage_cursor_init_hashes_of_milestone_candidates(&cursor, STORAGE_CURSOR_MODEL_HASH, transaction_address(&txs[0]));
+  pack.capacity = 2;
+  hash_pack_reset(&pack);
+  TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(cursor.done);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[0]), hashes[0], FLEX_TRIT_SIZE_243);
+
+  // Transactions matching several fields of a list are loaded once
+  hash243_queue_push(&approvees, transaction_hash(&txs[0]));
+  hash243_queue_push(&approvees, transaction_branch(&txs[0]));
+  storage_cursor_init_find(&cursor, STORAGE_CURSOR_MODEL_HASH, NULL, NULL, NULL, approvees);
+  pack.capacity = 1;
+  while (!cursor.done) {
+    hash_pack_reset(&pack);
+    TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+    if (pack.num_loaded == 1) {
+      TEST_ASSERT_FALSE(hash243_set_contains(found, hashes[0]));
+      hash243_set_add(&found, hashes[0]);
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(3, hash243_set_size(found));
+
+  hash243_queue_free(&approvees);
+  hash243_set_free(&found);
+}
+
+void test_update_metadata(void) {
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+  hash243_set_t hashes = NULL;
+
+  hash243_set_add(&hashes, transaction_hash(&txs[0]));
+  hash243_set_add(&hashes, transaction_hash(&txs[1]));
+  hash243_set_add(&hashes, transaction_hash(test_tx));
+  TEST_ASSERT(iota_stor_transactions_update_solid_state(&connection, hashes, true) == RC_OK);
+  TEST_ASSERT(iota_stor_transactions_update_snapshot_index(&connection, hashes, 42) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_update_snapshot_index(&connection, transaction_hash(&txs[1]), 43) == RC_OK);
+
+  TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(&txs[0]), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(transaction_solid(&tx));
+  TEST_ASSERT_EQUAL_INT(42, transaction_snapshot_index(&tx));
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(&txs[1]), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(43, transaction_snapshot_index(&tx));
+
+  // Clearing the metadata keeps the arrival timestamps
+  TEST_ASSERT(iota_stor_transaction_metadata_clear(&connection) == RC_OK);
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(&txs[1]), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_FALSE(transaction_solid(&tx));
+  TEST_ASSERT_EQUAL_INT(0, transaction_snapshot_index(&tx));
+  TEST_ASSERT(transaction_arrival_timestamp(&tx) > 0);
+
+  hash243_set_free(&hashes);
+}
+
+void test_milestones(void) {
+  iota_milestone_t milestone = {.index = 42};
+  state_delta_t state_delta1 = NULL, state_delta2 = NULL;
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t *hashed_hash = NULL;
+  trit_t trits[HASH_LENGTH] = {1};
+  bool exist = false;
+  DECLARE_PACK_SINGLE_MILESTONE(ms, ms_ptr, ms_pack);
+
+  memcpy(milestone.hash, transaction_hash(&txs[0]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_stor_milestone_exist(&connection, NULL, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_OK);
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_KV_KEY_EXISTS);
+  milestone.index = 44;
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_KV_KEY_EXISTS);
+  memcpy(milestone.hash, transaction_hash(&txs[1]), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_OK);
+
+  TEST_ASSERT(iota_stor_milestone_load_last(&connection, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(44, ms.index);
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_first(&connection, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(42, ms.index);
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_next(&connection, 42, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
+  TEST_ASSERT_EQUAL_INT(44, ms.index);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[1]), ms.hash, FLEX_TRIT_SIZE_243);
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_next(&connection, 44, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, ms_pack.num_loaded);
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load_by_index(&connection, 42, &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[0]), ms.hash, FLEX_TRIT_SIZE_243);
+  hash_pack_reset(&ms_pack);
+  TEST_ASSERT(iota_stor_milestone_load(&connection, transaction_hash(&txs[0]), &ms_pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(42, ms.index);
+
+  // A state delta is only stored along its milestone
+  flex_trits_from_trits(hash, HASH_LENGTH, trits, HASH_LENGTH, HASH_LENGTH);
+  for (int64_t i = -100; i <= 100; i++) {
+    hashed_hash = iota_flex_digest(hash, HASH_LENGTH);
+    memcpy(hash, hashed_hash, FLEX_TRIT_SIZE_243);
+    free(hashed_hash);
+    TEST_ASSERT(state_delta_add(&state_delta1, hash, i) == RC_OK);
+  }
+  TEST_ASSERT(iota_stor_state_delta_store(&connection, 43, &state_delta1) == RC_OK);
+  TEST_ASSERT(iota_stor_state_delta_load(&connection, 43, &state_delta2) == RC_OK);
+  TEST_ASSERT(state_delta2 == NULL);
+  TEST_ASSERT(iota_stor_state_delta_store(&connection, 42, &state_delta1) == RC_OK);
+  TEST_ASSERT(iota_stor_state_delta_load(&connection, 42, &state_delta2) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(HASH_COUNT(state_delta1), HASH_COUNT(state_delta2));
+  state_delta_destroy(&state_delta2);
+
+  // Deleting a milestone deletes its state delta
+  TEST_ASSERT(iota_stor_milestone_delete(&connection, transaction_hash(&txs[0])) == RC_OK);
+  TEST_ASSERT(iota_stor_milestone_exist(&connection, transaction_hash(&txs[0]), &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+  TEST_ASSERT(iota_stor_state_delta_load(&connection, 42, &state_delta2) == RC_OK);
+  TEST_ASSERT(state_delta2 == NULL);
+
+  TEST_ASSERT(iota_stor_milestone_clear(&connection) == RC_OK);
+  TEST_ASSERT(iota_stor_milestone_exist(&connection, NULL, &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  state_delta_destroy(&state_delta1);
+}
+
+void test_write_batch(void) {
+  connection_config_t config = {.db_path = test_db_path,
+                                .backend = STORAGE_BACKEND_KV,
+                                .durability = STORAGE_DURABILITY_NORMAL,
+                                .write_batch_size = 3,
+                                .write_batch_timeout_ms = 60000};
+  storage_connection_t writer;
+  iota_transaction_t tx = *test_tx;
+  hash243_set_t hashes = NULL;
+  bool exist = false;
+
+  TEST_ASSERT(connection_init(&writer, &config, STORAGE_CONNECTION_TANGLE) == RC_OK);
+
+  // Group-committed writes are visible once written, only their sync waits for the end of the group
+  TEST_ASSERT(iota_stor_transaction_store(&writer, &tx) == RC_OK);
+  TEST_ASSERT(connection_pending_batch(&writer) != 0);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&tx), &exist) ==
+              RC_OK);
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT(connection_flush(&writer) == RC_OK);
+  TEST_ASSERT(connection_pending_batch(&writer) == 0);
+
+  // Deleting a transaction deletes its index keys, destroying the connection commits it
+  hash243_set_add(&hashes, transaction_hash(&tx));
+  hash243_set_add(&hashes, transaction_hash(&txs[1]));
+  TEST_ASSERT(iota_stor_transactions_delete(&writer, hashes) == RC_OK);
+  TEST_ASSERT(connection_destroy(&writer) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&tx), &exist) ==
+              RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  {
+    flex_trit_t hash[FLEX_TRIT_SIZE_243];
+    flex_trit_t *models[1] = {hash};
+    iota_stor_pack_t pack = {.models = (void **)models, .capacity = 1, .num_loaded = 0};
+    size_t count = 0;
+
+    TEST_ASSERT(iota_stor_transaction_approvers_count(&connection, transaction_hash(&txs[0]), &count) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, count);
+    TEST_ASSERT(iota_stor_transaction_load_hashes(&connection, TRANSACTION_FIELD_ADDRESS, transaction_address(&txs[0]),
+                                                  &pack) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+    TEST_ASSERT_FALSE(pack.insufficient_capacity);
+  }
+
+  hash243_set_free(&hashes);
+}
+
+void test_spent_addresses(void) {
+  connection_config_t config = {.db_path = test_db_path, .backend = STORAGE_BACKEND_KV};
+  storage_connection_t spent_addresses;
+  hash243_set_t addresses = NULL;
+  bool exist = false;
+
+  remove_db(engine_db_path);
+  config.db_path = engine_db_path;
+  TEST_ASSERT(connection_init(&spent_addresses, &config, STORAGE_CONNECTION_SPENT_ADDRESSES) == RC_OK);
+
+  TEST_ASSERT(iota_stor_spent_address_store(&spent_addresses, transaction_address(&txs[0])) == RC_OK);
+  TEST_ASSERT(iota_stor_spent_address_store(&spent_addresses, transaction_address(&txs[0])) == RC_OK);
+  hash243_set_add(&addresses, transaction_address(&txs[0]));
+  hash243_set_add(&addresses, transaction_address(&txs[2]));
+  TEST_ASSERT(iota_stor_spent_addresses_store(&spent_addresses, addresses) == RC_OK);
+  TEST_ASSERT(iota_stor_spent_address_exist(&spent_addresses, transaction_address(&txs[2]), &exist) == RC_OK);
+  TEST_ASSERT_TRUE(exist);
+  TEST_ASSERT(iota_stor_spent_address_exist(&spent_addresses, transaction_hash(&txs[2]), &exist) == RC_OK);
+  TEST_ASSERT_FALSE(exist);
+
+  TEST_ASSERT(connection_destroy(&spent_addresses) == RC_OK);
+  hash243_set_free(&addresses);
+  remove_db(engine_db_path);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  TEST_ASSERT(storage_init() == RC_OK);
+  load_test_transactions();
+
+  RUN_TEST(test_engine);
+  RUN_TEST(test_init_connection);
+  RUN_TEST(test_stored_transaction);
+  RUN_TEST(test_load_hashes);
+  RUN_TEST(test_find);
+  RUN_TEST(test_cursor);
+  RUN_TEST(test_update_metadata);
+  RUN_TEST(test_milestones);
+  RUN_TEST(test_write_batch);
+  RUN_TEST(test_spent_addresses);
+  RUN_TEST(test_destroy_connection);
+
+  transaction_free(test_tx);
+  TEST_ASSERT(storage_destroy() == RC_OK);
+  return UNITY_END();
+}
@@ -36,6 +36,31 @@ retcode_t hash_pack_resize(iota_stor_pack_t *pack, size_t resize_factor) {
   return RC_OK;
 }
 
+retcode_t hash_pack_grow(iota_stor_pack_t *pack, size_t grow_factor) {
+  size_t const capacity = pack->capacity == 0 ? grow_factor : pack->capacity * grow_factor;
+  void **models = NULL;
+
+  if (grow_factor < 2) {
+    return RC_OK;
+  }
+
+  pack->insufficient_capacity = false;
+
+  if ((models = realloc(pack->models, sizeof(flex_trit_t *) * capacity)) == NULL) {
+    return RC_OOM;
+  }
+  pack->models = models;
+
+  for (; pack->capacity < capacity; ++pack->capacity) {
+    pack->models[pack->capacity] = malloc(FLEX_TRIT_SIZE_243);
+    if (pack->models[pack->capacity] == NULL) {
+      return RC_OOM;
+    }
+  }
+
+  return RC_OK;
+}
+
 retcode_t hash_pack_init(iota_stor_pack_t *pack, size_t size) {
   pack->capacity = size;
   pack->num_loaded = 0;
@@ -37,6 +37,8 @@ extern "C" {
 #endif
 
 retcode_t hash_pack_resize(iota_stor_pack_t *pack, size_t resize_factor);
+// Unlike hash_pack_resize, keeps the hashes already loaded
+retcode_t hash_pack_grow(iota_stor_pack_t *pack, size_t grow_factor);
 retcode_t hash_pack_init(iota_stor_pack_t *pack, size_t size);
 retcode_t hash_pack_reset(iota_stor_pack_t *pack);
 retcode_t hash_pack_free(iota_stor_pack_t *pack);
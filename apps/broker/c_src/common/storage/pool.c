@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/storage/pool.h"
+#include "utlist.h"
+
+// Opened and closed while no connection leases from them, then only read
+static storage_pool_t *pools = NULL;
+
+static void lease_free(storage_pool_lease_t *const lease) {
+  if (lease->reader.actual != NULL) {
+    connection_destroy(&lease->reader);
+  }
+  free(lease);
+}
+
+retcode_t storage_pool_open(connection_config_t const *const config, storage_connection_type_t const type,
+                            size_t const max_idle_readers) {
+  retcode_t ret = RC_OK;
+  storage_pool_t *pool = NULL;
+
+  if (config == NULL || config->db_path == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (storage_pool_find(config->db_path, type) != NULL) {
+    return RC_INVALID_PARAM;
+  }
+
+  if ((pool = (storage_pool_t *)calloc(1, sizeof(storage_pool_t))) == NULL ||
+      (pool->db_path = strdup(config->db_path)) == NULL) {
+    free(pool);
+    return RC_OOM;
+  }
+  pool->type = type;
+  pool->max_idle_readers = max_idle_readers;
+
+  // Opened first, it sets the journal mode up for the readers
+  if ((ret = connection_init(&pool->writer, config, type)) != RC_OK) {
+    if (pool->writer.actual != NULL) {
+      connection_destroy(&pool->writer);
+    }
+    free(pool->db_path);
+    free(pool);
+    return ret;
+  }
+
+  pool->reader_config = *config;
+  pool->reader_config.db_path = pool->db_path;
+  pool->reader_config.read_only = true;
+  pool->reader_config.write_batch_size = 0;
+  pool->reader_config.write_batch_timeout_ms = 0;
+
+  lock_handle_init(&pool->writer_lock);
+  lock_handle_init(&pool->readers_lock);
+  LL_PREPEND(pools, pool);
+
+  return RC_OK;
+}
+
+retcode_t storage_pool_close(char const *const db_path) {
+  retcode_t ret = RC_OK;
+  storage_pool_t *pool = NULL, *tmp = NULL;
+  storage_pool_lease_t *lease = NULL, *lease_tmp = NULL;
+
+  if (db_path == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  LL_FOREACH_SAFE(pools, pool, tmp) {
+    if (strcmp(pool->db_path, db_path) != 0) {
+      continue;
+    }
+    LL_DELETE(pools, pool);
+    LL_FOREACH_SAFE(pool->idle_readers, lease, lease_tmp) {
+      LL_DELETE(pool->idle_readers, lease);
+      lease_free(lease);
+    }
+    ret |= connection_destroy(&pool->writer);
+    lock_handle_destroy(&pool->writer_lock);
+    lock_handle_destroy(&pool->readers_lock);
+    free(pool->db_path);
+    free(pool);
+  }
+
+  return ret;
+}
+
+storage_pool_t *storage_pool_find(char const *const db_path, storage_connection_type_t const type) {
+  storage_pool_t *pool = NULL;
+
+  if (db_path == NULL) {
+    return NULL;
+  }
+
+  LL_FOREACH(pools, pool) {
+    if (pool->type == type && strcmp(pool->db_path, db_path) == 0) {
+      return pool;
+    }
+  }
+
+  return NULL;
+}
+
+retcode_t storage_pool_lease_acquire(storage_pool_t *const pool, bool const group_commit,
+                                     storage_pool_lease_t **const lease) {
+  retcode_t ret = RC_OK;
+
+  if (pool == NULL || lease == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  lock_handle_lock(&pool->readers_lock);
+  if ((*lease = pool->idle_readers) != NULL) {
+    LL_DELETE(pool->idle_readers, *lease);
+    pool->idle_readers_count--;
+  }
+  lock_handle_unlock(&pool->readers_lock);
+
+  if (*lease == NULL) {
+    if ((*lease = (storage_pool_lease_t *)calloc(1, sizeof(storage_pool_lease_t))) == NULL) {
+      return RC_OOM;
+    }
+    if ((ret = connection_init(&(*lease)->reader, &pool->reader_config, pool->type)) != RC_OK) {
+      lease_free(*lease);
+      *lease = NULL;
+      return ret;
+    }
+  }
+
+  (*lease)->pool = pool;
+  (*lease)->group_commit = group_commit;
+  (*lease)->pending_batch = 0;
+  (*lease)->next = NULL;
+
+  return RC_OK;
+}
+
+retcode_t storage_pool_lease_release(storage_pool_lease_t **const lease) {
+  retcode_t ret = RC_OK;
+  storage_pool_t *pool = NULL;
+
+  if (lease == NULL || *lease == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  pool = (*lease)->pool;
+  if ((*lease)->pending_batch != 0) {
+    lock_handle_lock(&pool->writer_lock);
+    if (connection_pending_batch(&pool->writer) == (*lease)->pending_batch) {
+      ret = connection_flush(&pool->writer);
+    }
+    lock_handle_unlock(&pool->writer_lock);
+  }
+
+  lock_handle_lock(&pool->readers_lock);
+  if (pool->idle_readers_count < pool->max_idle_readers) {
+    LL_PREPEND(pool->idle_readers, *lease);
+    pool->idle_readers_count++;
+    *lease = NULL;
+  }
+  lock_handle_unlock(&pool->readers_lock);
+
+  if (*lease != NULL) {
+    lease_free(*lease);
+    *lease = NULL;
+  }
+
+  return ret;
+}
+
+storage_connection_t const *storage_pool_lease_read(storage_pool_lease_t *const lease) {
+  storage_pool_t *const pool = lease->pool;
+
+  if (lease->pending_batch == 0) {
+    return &lease->reader;
+  }
+
+  lock_handle_lock(&pool->writer_lock);
+  if (connection_pending_batch(&pool->writer) == lease->pending_batch) {
+    return &pool->writer;
+  }
+  lease->pending_batch = 0;
+  lock_handle_unlock(&pool->writer_lock);
+
+  return &lease->reader;
+}
+
+void storage_pool_lease_read_done(storage_pool_lease_t *const lease, storage_connection_t const *const connection) {
+  if (connection == &lease->pool->writer) {
+    lock_handle_unlock(&lease->pool->writer_lock);
+  }
+}
+
+storage_connection_t const *storage_pool_lease_write(storage_pool_lease_t *const lease) {
+  lock_handle_lock(&lease->pool->writer_lock);
+  return &lease->pool->writer;
+}
+
+retcode_t storage_pool_lease_write_done(storage_pool_lease_t *const lease, retcode_t const ret) {
+  storage_pool_t *const pool = lease->pool;
+  retcode_t flush_ret = RC_OK;
+
+  // A failed write doesn't abort the group commit, the writes of the other leases are still committed
+  if (lease->group_commit) {
+    lease->pending_batch = connection_pending_batch(&pool->writer);
+  } else {
+    flush_ret = connection_flush(&pool->writer);
+  }
+  lock_handle_unlock(&pool->writer_lock);
+
+  return ret != RC_OK ? ret : flush_ret;
+}
+
+retcode_t storage_pool_lease_flush(storage_pool_lease_t *const lease) {
+  retcode_t ret = RC_OK;
+
+  lock_handle_lock(&lease->pool->writer_lock);
+  ret = connection_flush(&lease->pool->writer);
+  lock_handle_unlock(&lease->pool->writer_lock);
+  if (ret == RC_OK) {
+    lease->pending_batch = 0;
+  }
+
+  return ret;
+}
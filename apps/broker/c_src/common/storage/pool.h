@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_POOL_H__
+#define __COMMON_STORAGE_POOL_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "common/storage/connection.h"
+#include "utils/handles/lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct storage_pool_s storage_pool_t;
+
+/**
+ * A reader connection leased to a single thread, and how its writes go through the writer connection of the pool
+ */
+typedef struct storage_pool_lease_s {
+  storage_pool_t *pool;
+  storage_connection_t reader;
+  // Writes join the group commit of the writer instead of being committed right away
+  bool group_commit;
+  // Group commit of the writer holding writes of the lease, 0 once they are committed
+  uint64_t pending_batch;
+  struct storage_pool_lease_s *next;
+} storage_pool_lease_t;
+
+/**
+ * Connections to a database shared by the threads of the process: a single writer connection, serialized by a lock,
+ * and read-only connections leased to a thread at a time. Readers never wait behind the writer, and returned readers
+ * are kept open with their prepared statements for the next lease.
+ */
+struct storage_pool_s {
+  char *db_path;
+  storage_connection_type_t type;
+  connection_config_t reader_config;
+  storage_connection_t writer;
+  lock_handle_t writer_lock;
+  // Readers returned to the pool, at most max_idle_readers of them
+  storage_pool_lease_t *idle_readers;
+  size_t idle_readers_count;
+  size_t max_idle_readers;
+  lock_handle_t readers_lock;
+  struct storage_pool_s *next;
+};
+
+/**
+ * Opens a pool of connections to a database, leased from by the connections opened to it afterwards
+ *
+ * Pools are opened before and closed after all the connections leasing from them.
+ *
+ * @param config The configuration of the connections, the group commit applies to the writer only
+ * @param type The type of the connections
+ * @param max_idle_readers Number of reader connections kept open once returned
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_open(connection_config_t const *const config, storage_connection_type_t const type,
+                            size_t const max_idle_readers);
+
+/**
+ * Closes the pool of connections to a database
+ *
+ * @param db_path The path of the database
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_close(char const *const db_path);
+
+/**
+ * Finds the pool of connections to a database
+ *
+ * @param db_path The path of the database
+ * @param type The type of the connections
+ *
+ * @return the pool, NULL if none is open
+ */
+storage_pool_t *storage_pool_find(char const *const db_path, storage_connection_type_t const type);
+
+/**
+ * Leases a reader connection, opening one if none is idle
+ *
+ * @param pool The pool
+ * @param group_commit Whether the writes of the lease join the group commit of the writer
+ * @param lease The lease
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_lease_acquire(storage_pool_t *const pool, bool const group_commit,
+                                     storage_pool_lease_t **const lease);
+
+/**
+ * Returns a leased reader connection to its pool, committing the pending writes of the lease
+ *
+ * @param lease The lease
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_lease_release(storage_pool_lease_t **const lease);
+
+/**
+ * Gets the connection to read from: the reader of the lease, or the writer, locked, while the writes of the lease are
+ * pending so that they can be read back
+ *
+ * @param lease The lease
+ *
+ * @return the connection, handed back with storage_pool_lease_read_done
+ */
+storage_connection_t const *storage_pool_lease_read(storage_pool_lease_t *const lease);
+
+// Hands back a connection got from storage_pool_lease_read
+void storage_pool_lease_read_done(storage_pool_lease_t *const lease, storage_connection_t const *const connection);
+
+/**
+ * Gets the writer connection, locked
+ *
+ * @param lease The lease
+ *
+ * @return the connection, handed back with storage_pool_lease_write_done
+ */
+storage_connection_t const *storage_pool_lease_write(storage_pool_lease_t *const lease);
+
+/**
+ * Hands the writer connection back, committing the writes unless the lease group-commits them
+ *
+ * @param lease The lease
+ * @param ret The status of the writes
+ *
+ * @return the status of the writes, or of their commit
+ */
+retcode_t storage_pool_lease_write_done(storage_pool_lease_t *const lease, retcode_t const ret);
+
+/**
+ * Commits the group commit of the writer
+ *
+ * @param lease The lease
+ *
+ * @return a status code
+ */
+retcode_t storage_pool_lease_flush(storage_pool_lease_t *const lease);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_POOL_H__
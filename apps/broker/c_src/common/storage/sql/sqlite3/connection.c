@@ -5,6 +5,8 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <inttypes.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -16,6 +18,9 @@
 #include "utils/logger_helper.h"
 
 #define SQLITE3_LOGGER_ID "sqlite3"
+// Statements built at run time kept prepared per connection, the cache is emptied when full
+#define STATEMENT_CACHE_MAX_SIZE 64
+#define PRAGMA_MAX_SIZE 64
 
 static logger_id_t logger_id;
 
@@ -169,8 +174,183 @@ static retcode_t finalize_spent_addresses_statements(sqlite3_spent_addresses_con
   return ret;
 }
 
-retcode_t connection_init(storage_connection_t* const connection, connection_config_t const* const config,
-                          storage_connection_type_t const type) {
+static void statement_cache_clear(sqlite3_tangle_connection_t* const connection) {
+  sqlite3_statement_cache_entry_t *entry = NULL, *tmp = NULL;
+
+  HASH_ITER(hh, connection->statement_cache, entry, tmp) {
+    HASH_DEL(connection->statement_cache, entry);
+    finalize_statement(entry->statement);
+    free(entry->text);
+    free(entry);
+  }
+}
+
+retcode_t statement_cache_get(sqlite3_tangle_connection_t* const connection, char const* const text,
+                              sqlite3_stmt** const statement) {
+  retcode_t ret = RC_OK;
+  sqlite3_statement_cache_entry_t* entry = NULL;
+
+  HASH_FIND_STR(connection->statement_cache, text, entry);
+  if (entry != NULL) {
+    *statement = entry->statement;
+    return RC_OK;
+  }
+
+  if ((ret = prepare_statement(connection->db, statement, text)) != RC_OK) {
+    return ret;
+  }
+
+  if (HASH_COUNT(connection->statement_cache) >= STATEMENT_CACHE_MAX_SIZE) {
+    statement_cache_clear(connection);
+  }
+  if ((entry = (sqlite3_statement_cache_entry_t*)malloc(sizeof(sqlite3_statement_cache_entry_t))) == NULL ||
+      (entry->text = strdup(text)) == NULL) {
+    free(entry);
+    finalize_statement(*statement);
+    *statement = NULL;
+    return RC_OOM;
+  }
+  entry->statement = *statement;
+  HASH_ADD_KEYPTR(hh, connection->statement_cache, entry->text, strlen(entry->text), entry);
+
+  return RC_OK;
+}
+
+static char const* synchronous_pragma(storage_durability_t const durability) {
+  switch (durability) {
+    case STORAGE_DURABILITY_NORMAL:
+      return "PRAGMA synchronous = NORMAL";
+    case STORAGE_DURABILITY_OFF:
+      return "PRAGMA synchronous = OFF";
+    default:
+      return "PRAGMA synchronous = FULL";
+  }
+}
+
+static retcode_t sizing_pragmas(sqlite3* const db, connection_config_t const* const config) {
+  char pragma[PRAGMA_MAX_SIZE];
+
+  if (config->cache_size_kb != 0) {
+    // A negative size is in KiB rather than in pages
+    snprintf(pragma, PRAGMA_MAX_SIZE, "PRAGMA cache_size = -%zu", config->cache_size_kb);
+    if (sqlite3_exec(db, pragma, NULL, NULL, NULL) != SQLITE_OK) {
+      return RC_SQLITE3_FAILED_CONFIG;
+    }
+  }
+
+  if (config->mmap_size_mb != 0) {
+    snprintf(pragma, PRAGMA_MAX_SIZE, "PRAGMA mmap_size = %" PRIu64, (uint64_t)config->mmap_size_mb * 1024 * 1024);
+    if (sqlite3_exec(db, pragma, NULL, NULL, NULL) != SQLITE_OK) {
+      return RC_SQLITE3_FAILED_CONFIG;
+    }
+  }
+
+  if (config->temp_store != STORAGE_TEMP_STORE_DEFAULT &&
+      sqlite3_exec(db,
+                   config->temp_store == STORAGE_TEMP_STORE_MEMORY ? "PRAGMA temp_store = MEMORY"
+                                                                   : "PRAGMA temp_store = FILE",
+                   NULL, NULL, NULL) != SQLITE_OK) {
+    return RC_SQLITE3_FAILED_CONFIG;
+  }
+
+  if (!config->read_only && config->wal_autocheckpoint != 0) {
+    snprintf(pragma, PRAGMA_MAX_SIZE, "PRAGMA wal_autocheckpoint = %zu", config->wal_autocheckpoint);
+    if (sqlite3_exec(db, pragma, NULL, NULL, NULL) != SQLITE_OK) {
+      return RC_SQLITE3_FAILED_CONFIG;
+    }
+  }
+
+  return RC_OK;
+}
+
+static retcode_t check_schema_version(sqlite3* const db, char const* const db_path) {
+  sqlite3_stmt* statement = NULL;
+  int version = -1;
+
+  if (prepare_statement(db, &statement, "PRAGMA user_version") != RC_OK) {
+    return RC_SQLITE3_FAILED_PREPARED_STATEMENT;
+  }
+  if (sqlite3_step(statement) == SQLITE_ROW) {
+    version = sqlite3_column_int(statement, 0);
+  }
+  finalize_statement(statement);
+
+  if (version != SQLITE3_SCHEMA_VERSION) {
+    log_critical(logger_id, "Db on path %s has schema version %d instead of %d, it needs to be migrated\n", db_path,
+                 version, SQLITE3_SCHEMA_VERSION);
+    return RC_SQLITE3_SCHEMA_VERSION_MISMATCH;
+  }
+
+  return RC_OK;
+}
+
+/**
+ * SQLite rolls the open transaction back by itself on some errors (SQLITE_FULL, SQLITE_IOERR, SQLITE_NOMEM,
+ * SQLITE_INTERRUPT...), the group commit is then over and its rows are lost
+ */
+static bool write_batch_rolled_back(sqlite3_tangle_connection_t* const connection) {
+  storage_group_commit_t* const batch = &connection->write_batch;
+
+  if (!batch->open || !sqlite3_get_autocommit(connection->db)) {
+    return false;
+  }
+  log_error(logger_id, "Group commit of %zu rows was rolled back\n", batch->rows);
+  storage_group_commit_ended(batch);
+
+  return true;
+}
+
+retcode_t write_batch_begin(sqlite3_tangle_connection_t* const connection) {
+  retcode_t ret = RC_OK;
+  storage_group_commit_t* const batch = &connection->write_batch;
+
+  write_batch_rolled_back(connection);
+  if (!storage_group_commit_needs_begin(batch)) {
+    return RC_OK;
+  }
+
+  if ((ret = begin_transaction(connection->db)) != RC_OK) {
+    log_error(logger_id, "Beginning group commit failed\n");
+    return ret;
+  }
+  storage_group_commit_begun(batch);
+
+  return RC_OK;
+}
+
+retcode_t write_batch_end(sqlite3_tangle_connection_t* const connection, size_t const rows) {
+  storage_group_commit_t* const batch = &connection->write_batch;
+
+  if (!batch->open) {
+    return RC_OK;
+  } else if (write_batch_rolled_back(connection)) {
+    return RC_SQLITE3_FAILED_END;
+  }
+
+  return storage_group_commit_add(batch, rows) ? write_batch_commit(connection) : RC_OK;
+}
+
+retcode_t write_batch_commit(sqlite3_tangle_connection_t* const connection) {
+  retcode_t ret = RC_OK;
+  storage_group_commit_t* const batch = &connection->write_batch;
+
+  if (!batch->open) {
+    return RC_OK;
+  }
+
+  // Left open on failure for the next commit to retry, unless SQLite rolled it back
+  if ((ret = end_transaction(connection->db)) != RC_OK) {
+    log_error(logger_id, "Committing group commit of %zu rows failed\n", batch->rows);
+    write_batch_rolled_back(connection);
+    return ret;
+  }
+  storage_group_commit_ended(batch);
+
+  return RC_OK;
+}
+
+retcode_t sqlite3_connection_init(storage_connection_t* const connection, connection_config_t const* const config,
+                                  storage_connection_type_t const type) {
   retcode_t ret = RC_OK;
   sqlite3** db = NULL;
   char* err_msg = NULL;
@@ -201,7 +381,9 @@ retcode_t connection_init(storage_connection_t* const connection, connection_con
     return RC_SQLITE3_NO_PATH_FOR_DB_SPECIFIED;
   }
 
-  if ((rc = sqlite3_open_v2(config->db_path, db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX, NULL)) != SQLITE_OK) {
+  if ((rc = sqlite3_open_v2(config->db_path, db,
+                            (config->read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE) | SQLITE_OPEN_NOMUTEX,
+                            NULL)) != SQLITE_OK) {
     log_critical(logger_id, "Failed to open db on path: %s\n", config->db_path);
     return RC_SQLITE3_FAILED_OPEN_DB;
   }
@@ -210,14 +392,30 @@ retcode_t connection_init(storage_connection_t* const connection, connection_con
     return RC_SQLITE3_FAILED_CONFIG;
   }
 
-  sql = "PRAGMA journal_mode = WAL;PRAGMA foreign_keys = ON";
+  if ((ret = check_schema_version(*db, config->db_path)) != RC_OK) {
+    return ret;
+  }
+
+  // The journal mode is persistent, set by the writers
+  sql = config->read_only ? "PRAGMA foreign_keys = ON" : "PRAGMA journal_mode = WAL;PRAGMA foreign_keys = ON";
 
   if ((rc = sqlite3_exec(*db, sql, NULL, NULL, &err_msg)) != SQLITE_OK) {
     sqlite3_free(err_msg);
     return RC_SQLITE3_FAILED_INSERT_DB;
   }
 
+  if ((rc = sqlite3_exec(*db, synchronous_pragma(config->durability), NULL, NULL, &err_msg)) != SQLITE_OK) {
+    sqlite3_free(err_msg);
+    return RC_SQLITE3_FAILED_CONFIG;
+  }
+
+  if ((ret = sizing_pragmas(*db, config)) != RC_OK) {
+    log_critical(logger_id, "Failed to configure db on path: %s\n", config->db_path);
+    return ret;
+  }
+
   if (type == STORAGE_CONNECTION_TANGLE) {
+    storage_group_commit_init(&((sqlite3_tangle_connection_t*)connection->actual)->write_batch, config);
     ret = prepare_tangle_statements(connection->actual);
   } else if (type == STORAGE_CONNECTION_SPENT_ADDRESSES) {
     ret = prepare_spent_addresses_statements(connection->actual);
@@ -226,7 +424,7 @@ retcode_t connection_init(storage_connection_t* const connection, connection_con
   return ret;
 }
 
-retcode_t connection_destroy(storage_connection_t* const connection) {
+retcode_t sqlite3_connection_destroy(storage_connection_t* const connection) {
   retcode_t ret = RC_OK;
 
   if (connection == NULL) {
@@ -236,7 +434,9 @@ retcode_t connection_destroy(storage_connection_t* const connection) {
   if (connection->type == STORAGE_CONNECTION_TANGLE) {
     sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
 
-    ret = finalize_tangle_statements(sqlite3_connection);
+    ret = write_batch_commit(sqlite3_connection);
+    statement_cache_clear(sqlite3_connection);
+    ret |= finalize_tangle_statements(sqlite3_connection);
     sqlite3_close(sqlite3_connection->db);
     sqlite3_connection->db = NULL;
   } else if (connection->type == STORAGE_CONNECTION_SPENT_ADDRESSES) {
@@ -252,3 +452,29 @@ retcode_t connection_destroy(storage_connection_t* const connection) {
 
   return ret;
 }
+
+retcode_t sqlite3_connection_flush(storage_connection_t const* const connection) {
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  } else if (connection->type != STORAGE_CONNECTION_TANGLE) {
+    return RC_OK;
+  }
+
+  return write_batch_commit((sqlite3_tangle_connection_t*)connection->actual);
+}
+
+uint64_t sqlite3_connection_pending_batch(storage_connection_t const* const connection) {
+  sqlite3_tangle_connection_t const* sqlite3_connection = NULL;
+
+  if (connection == NULL || connection->type != STORAGE_CONNECTION_TANGLE) {
+    return 0;
+  }
+
+  sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  // A group commit rolled back by SQLite holds no write anymore
+  if (sqlite3_get_autocommit(sqlite3_connection->db)) {
+    return 0;
+  }
+
+  return storage_group_commit_pending(&sqlite3_connection->write_batch);
+}
@@ -8,18 +8,35 @@
 #ifndef __COMMON_STORAGE_SQL_SQLITE3_CONNECTION_H__
 #define __COMMON_STORAGE_SQL_SQLITE3_CONNECTION_H__
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <sqlite3.h>
 
 #include "common/storage/connection.h"
+#include "common/storage/group_commit.h"
 #include "common/storage/sql/statements.h"
+#include "uthash.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// Version of the schemas, stored as user_version: trit columns packed 5 trits per byte
+#define SQLITE3_SCHEMA_VERSION 1
+
+// Statement built at run time, kept prepared by its text
+typedef struct sqlite3_statement_cache_entry_s {
+  char* text;
+  sqlite3_stmt* statement;
+  UT_hash_handle hh;
+} sqlite3_statement_cache_entry_t;
+
 typedef struct sqlite3_tangle_connection_s {
   sqlite3* db;
   tangle_statements_t statements;
+  sqlite3_statement_cache_entry_t* statement_cache;
+  storage_group_commit_t write_batch;
 } sqlite3_tangle_connection_t;
 
 typedef struct sqlite3_spent_addresses_connection_s {
@@ -27,6 +44,53 @@ typedef struct sqlite3_spent_addresses_connection_s {
   spent_addresses_statements_t statements;
 } sqlite3_spent_addresses_connection_t;
 
+// Connection operations of the backend, see common/storage/connection.h
+retcode_t sqlite3_connection_init(storage_connection_t* const connection, connection_config_t const* const config,
+                                  storage_connection_type_t const type);
+retcode_t sqlite3_connection_destroy(storage_connection_t* const connection);
+retcode_t sqlite3_connection_flush(storage_connection_t const* const connection);
+uint64_t sqlite3_connection_pending_batch(storage_connection_t const* const connection);
+
+/**
+ * Joins the group commit before a write, beginning its transaction if none is open
+ *
+ * @param connection The connection
+ *
+ * @return a status code
+ */
+retcode_t write_batch_begin(sqlite3_tangle_connection_t* const connection);
+
+/**
+ * Counts the rows of a write, committing the group commit if it is full or expired
+ *
+ * @param connection The connection
+ * @param rows The number of rows written
+ *
+ * @return a status code
+ */
+retcode_t write_batch_end(sqlite3_tangle_connection_t* const connection, size_t const rows);
+
+/**
+ * Commits the group commit if one is open
+ *
+ * @param connection The connection
+ *
+ * @return a status code
+ */
+retcode_t write_batch_commit(sqlite3_tangle_connection_t* const connection);
+
+/**
+ * Gets a statement built at run time, prepared once per connection and reset by the caller after use
+ *
+ * @param connection The connection
+ * @param text The text of the statement
+ * @param statement The prepared statement
+ *
+ * @return a status code
+ */
+retcode_t statement_cache_get(sqlite3_tangle_connection_t* const connection, char const* const text,
+                              sqlite3_stmt** const statement);
+
 #ifdef __cplusplus
 }
 #endif
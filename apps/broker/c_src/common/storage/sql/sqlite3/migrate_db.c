@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Migrates a database written before the schema version 1, where trit columns hold the flex trits of the build, to
+ * the schema version 1, where they are packed 5 trits per byte.
+ *
+ * The new database is created from the schema beforehand, the rows of the old one are copied into it. The tool has to
+ * be built with the flex encoding of the node that wrote the old database. It then reports the size of both databases
+ * and the time of lookups by hash and by address in both.
+ *
+ * Usage: migrate_db <tangle|spent-addresses> <old database> <new database> [lookups]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sqlite3.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/sql/sqlite3/connection.h"
+#include "common/storage/sql/sqlite3/wrappers.h"
+#include "common/trinary/trit_byte.h"
+#include "utils/macros.h"
+#include "utils/time.h"
+
+#define DEFAULT_LOOKUPS 10000
+
+static char const *const MIGRATE_TANGLE =
+    "INSERT INTO main.iota_transaction(signature_or_message,address,value,obsolete_tag,timestamp,current_index,"
+    "last_index,bundle,trunk,branch,tag,attachment_timestamp,attachment_timestamp_lower,attachment_timestamp_upper,"
+    "nonce,hash,snapshot_index,solid,validity,arrival_timestamp) SELECT pack_trits(signature_or_message,6561),"
+    "pack_trits(address,243),value,pack_trits(obsolete_tag,81),timestamp,current_index,last_index,"
+    "pack_trits(bundle,243),pack_trits(trunk,243),pack_trits(branch,243),pack_trits(tag,81),attachment_timestamp,"
+    "attachment_timestamp_lower,attachment_timestamp_upper,pack_trits(nonce,81),pack_trits(hash,243),snapshot_index,"
+    "solid,validity,arrival_timestamp FROM old.iota_transaction;"
+    "INSERT INTO main.iota_milestone(id,hash,delta) SELECT id,pack_trits(hash,243),pack_delta(delta) FROM "
+    "old.iota_milestone";
+
+static char const *const MIGRATE_SPENT_ADDRESSES =
+    "INSERT INTO main.iota_spent_address(hash) SELECT pack_trits(hash,243) FROM old.iota_spent_address";
+
+typedef struct lookup_sample_s {
+  flex_trit_t hash[FLEX_TRIT_SIZE_243];
+  flex_trit_t address[FLEX_TRIT_SIZE_243];
+} lookup_sample_t;
+
+// Loads a column as written before the schema version 1: flex trits with their trailing nulls trimmed
+static void column_load_flex_trits(sqlite3_stmt *const statement, int const index, flex_trit_t *const flex_trits,
+                                   size_t const num_bytes) {
+  void const *const buffer = sqlite3_column_blob(statement, index);
+  size_t const column_size = buffer ? MIN((size_t)sqlite3_column_bytes(statement, index), num_bytes) : 0;
+
+  if (column_size) {
+    memcpy(flex_trits, buffer, column_size);
+  }
+  memset(flex_trits + column_size, FLEX_TRIT_NULL_VALUE, num_bytes - column_size);
+}
+
+static int column_bind_flex_trits(sqlite3_stmt *const statement, int const index, flex_trit_t const *const flex_trits,
+                                  size_t const num_bytes) {
+  ssize_t i = num_bytes - 1;
+
+  for (; i >= 0 && flex_trits[i] == FLEX_TRIT_NULL_VALUE; --i)
+    ;
+  return sqlite3_bind_blob(statement, index, flex_trits, i + 1, SQLITE_STATIC);
+}
+
+// pack_trits(column, number of trits): repacks a column written before the schema version 1
+static void pack_trits(sqlite3_context *const context, int const argc, sqlite3_value **const argv) {
+  flex_trit_t flex_trits[FLEX_TRIT_SIZE_6561];
+  byte_t bytes[MIN_BYTES(COLUMN_MAX_NUM_TRITS)];
+  void const *const buffer = sqlite3_value_blob(argv[0]);
+  size_t const num_trits = sqlite3_value_int(argv[1]);
+  size_t const num_bytes = NUM_FLEX_TRITS_FOR_TRITS(num_trits);
+  size_t column_size = 0;
+
+  (void)argc;
+  if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+    sqlite3_result_null(context);
+    return;
+  }
+  if (num_trits == 0 || num_trits > COLUMN_MAX_NUM_TRITS || (column_size = sqlite3_value_bytes(argv[0])) > num_bytes) {
+    sqlite3_result_error(context, "Unexpected column size", -1);
+    return;
+  }
+
+  if (column_size) {
+    memcpy(flex_trits, buffer, column_size);
+  }
+  memset(flex_trits + column_size, FLEX_TRIT_NULL_VALUE, num_bytes - column_size);
+  sqlite3_result_blob(context, bytes, column_pack_trits(bytes, flex_trits, num_trits), SQLITE_TRANSIENT);
+}
+
+// pack_delta(column): repacks the addresses of a state delta column written before the schema version 1
+static void pack_delta(sqlite3_context *const context, int const argc, sqlite3_value **const argv) {
+  void const *const buffer = sqlite3_value_blob(argv[0]);
+  size_t const size = sqlite3_value_bytes(argv[0]);
+  byte_t *packed = NULL;
+
+  (void)argc;
+  if (sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+    sqlite3_result_null(context);
+    return;
+  }
+  if (size % COLUMN_DELTA_SERIALIZED_ENTRY_SIZE != 0) {
+    sqlite3_result_error(context, "Unexpected delta size", -1);
+    return;
+  }
+  if ((packed = (byte_t *)malloc(size + 1)) == NULL) {
+    sqlite3_result_error_nomem(context);
+    return;
+  }
+  sqlite3_result_blob(context, packed, column_pack_delta(packed, buffer, size), SQLITE_TRANSIENT);
+  free(packed);
+}
+
+static int user_version(sqlite3 *const db, char const *const schema) {
+  char pragma[64];
+  sqlite3_stmt *statement = NULL;
+  int version = -1;
+
+  snprintf(pragma, sizeof(pragma), "PRAGMA %s.user_version", schema);
+  if (sqlite3_prepare_v2(db, pragma, -1, &statement, NULL) == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    version = sqlite3_column_int(statement, 0);
+  }
+  sqlite3_finalize(statement);
+
+  return version;
+}
+
+static int64_t pragma_int64(sqlite3 *const db, char const *const schema, char const *const name) {
+  char pragma[64];
+  sqlite3_stmt *statement = NULL;
+  int64_t value = 0;
+
+  snprintf(pragma, sizeof(pragma), "PRAGMA %s.%s", schema, name);
+  if (sqlite3_prepare_v2(db, pragma, -1, &statement, NULL) == SQLITE_OK && sqlite3_step(statement) == SQLITE_ROW) {
+    value = sqlite3_column_int64(statement, 0);
+  }
+  sqlite3_finalize(statement);
+
+  return value;
+}
+
+static double database_size_mib(sqlite3 *const db, char const *const schema) {
+  return pragma_int64(db, schema, "page_count") * pragma_int64(db, schema, "page_size") / (1024.0 * 1024.0);
+}
+
+// Times the lookups of the sampled keys in us per lookup, packed or as written before the schema version 1, -1 when
+// keys are missing
+static double lookup_time_us(sqlite3 *const db, char const *const query, lookup_sample_t const *const samples,
+                             size_t const num_samples, bool const by_address, bool const packed) {
+  sqlite3_stmt *statement = NULL;
+  uint64_t start = 0;
+  size_t rows = 0;
+
+  if (num_samples == 0 || sqlite3_prepare_v2(db, query, -1, &statement, NULL) != SQLITE_OK) {
+    return 0;
+  }
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < num_samples; i++) {
+    flex_trit_t const *const key = by_address ? samples[i].address : samples[i].hash;
+
+    if (packed) {
+      column_compress_bind(statement, 1, key, NUM_TRITS_HASH);
+    } else {
+      column_bind_flex_trits(statement, 1, key, FLEX_TRIT_SIZE_243);
+    }
+    while (sqlite3_step(statement) == SQLITE_ROW) {
+      rows++;
+    }
+    sqlite3_reset(statement);
+  }
+  start = monotonic_timestamp_us() - start;
+  sqlite3_finalize(statement);
+
+  return rows >= num_samples ? (double)start / num_samples : -1;
+}
+
+static size_t load_samples(sqlite3 *const db, bool const tangle, lookup_sample_t *const samples,
+                           size_t const max_samples) {
+  sqlite3_stmt *statement = NULL;
+  size_t num_samples = 0;
+
+  if (sqlite3_prepare_v2(db,
+                         tangle ? "SELECT hash,address FROM old.iota_transaction ORDER BY random() LIMIT ?"
+                                : "SELECT hash,hash FROM old.iota_spent_address ORDER BY random() LIMIT ?",
+                         -1, &statement, NULL) != SQLITE_OK ||
+      sqlite3_bind_int64(statement, 1, max_samples) != SQLITE_OK) {
+    sqlite3_finalize(statement);
+    return 0;
+  }
+  while (num_samples < max_samples && sqlite3_step(statement) == SQLITE_ROW) {
+    column_load_flex_trits(statement, 0, samples[num_samples].hash, FLEX_TRIT_SIZE_243);
+    column_load_flex_trits(statement, 1, samples[num_samples].address, FLEX_TRIT_SIZE_243);
+    num_samples++;
+  }
+  sqlite3_finalize(statement);
+
+  return num_samples;
+}
+
+static void report(sqlite3 *const db, bool const tangle, size_t const max_samples) {
+  char const *const by_hash[] = {"SELECT 1 FROM old.iota_transaction WHERE hash=?",
+                                 "SELECT 1 FROM main.iota_transaction WHERE hash=?",
+                                 "SELECT 1 FROM old.iota_spent_address WHERE hash=?",
+                                 "SELECT 1 FROM main.iota_spent_address WHERE hash=?"};
+  char const *const by_address[] = {"SELECT hash FROM old.iota_transaction WHERE address=?",
+                                    "SELECT hash FROM main.iota_transaction WHERE address=?"};
+  lookup_sample_t *samples = NULL;
+  size_t num_samples = 0;
+  size_t const offset = tangle ? 0 : 2;
+
+  printf("size: %.2f MiB -> %.2f MiB\n", database_size_mib(db, "old"), database_size_mib(db, "main"));
+
+  if ((samples = (lookup_sample_t *)malloc(max_samples * sizeof(lookup_sample_t))) == NULL ||
+      (num_samples = load_samples(db, tangle, samples, max_samples)) == 0) {
+    free(samples);
+    return;
+  }
+
+  printf("lookup by hash, %zu keys: %.2f us -> %.2f us\n", num_samples,
+         lookup_time_us(db, by_hash[offset], samples, num_samples, false, false),
+         lookup_time_us(db, by_hash[offset + 1], samples, num_samples, false, true));
+  if (tangle) {
+    printf("lookup by address, %zu keys: %.2f us -> %.2f us\n", num_samples,
+           lookup_time_us(db, by_address[0], samples, num_samples, true, false),
+           lookup_time_us(db, by_address[1], samples, num_samples, true, true));
+  }
+  free(samples);
+}
+
+int main(int argc, char **argv) {
+  sqlite3 *db = NULL;
+  sqlite3_stmt *statement = NULL;
+  bool tangle = false;
+  size_t const max_samples = argc > 4 ? strtoul(argv[4], NULL, 10) : DEFAULT_LOOKUPS;
+  uint64_t start = 0;
+  int ret = EXIT_FAILURE;
+
+  if (argc < 4 || (!(tangle = strcmp(argv[1], "tangle") == 0) && strcmp(argv[1], "spent-addresses") != 0)) {
+    fprintf(stderr, "Usage: %s <tangle|spent-addresses> <old database> <new database> [lookups]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (sqlite3_open_v2(argv[3], &db, SQLITE_OPEN_READWRITE, NULL) != SQLITE_OK ||
+      sqlite3_prepare_v2(db, "ATTACH DATABASE ? AS old", -1, &statement, NULL) != SQLITE_OK ||
+      sqlite3_bind_text(statement, 1, argv[2], -1, SQLITE_STATIC) != SQLITE_OK ||
+      sqlite3_step(statement) != SQLITE_DONE) {
+    fprintf(stderr, "Opening the databases failed: %s\n", sqlite3_errmsg(db));
+    goto done;
+  }
+  sqlite3_finalize(statement);
+  statement = NULL;
+  if (user_version(db, "old") != 0) {
+    fprintf(stderr, "%s is not a database written before the schema version 1\n", argv[2]);
+    goto done;
+  }
+  if (user_version(db, "main") != SQLITE3_SCHEMA_VERSION) {
+    fprintf(stderr, "%s is not a database created from the schema version %d\n", argv[3], SQLITE3_SCHEMA_VERSION);
+    goto done;
+  }
+  if (sqlite3_create_function(db, "pack_trits", 2, SQLITE_UTF8 | SQLITE_DETERMINISTIC, NULL, pack_trits, NULL,
+                              NULL) != SQLITE_OK ||
+      sqlite3_create_function(db, "pack_delta", 1, SQLITE_UTF8 | SQLITE_DETERMINISTIC, NULL, pack_delta, NULL,
+                              NULL) != SQLITE_OK) {
+    goto done;
+  }
+
+  start = monotonic_timestamp_us();
+  if (begin_transaction(db) != RC_OK ||
+      sqlite3_exec(db, tangle ? MIGRATE_TANGLE : MIGRATE_SPENT_ADDRESSES, NULL, NULL, NULL) != SQLITE_OK) {
+    fprintf(stderr, "Migrating failed: %s\n", sqlite3_errmsg(db));
+    rollback_transaction(db);
+    goto done;
+  }
+  // The node reads in WAL mode, the lookups are timed in it
+  if (end_transaction(db) != RC_OK ||
+      sqlite3_exec(db, "PRAGMA main.journal_mode = WAL", NULL, NULL, NULL) != SQLITE_OK) {
+    goto done;
+  }
+  printf("migrated %" PRId64 " rows in %.2f s\n", (int64_t)sqlite3_total_changes(db),
+         (monotonic_timestamp_us() - start) / 1e6);
+
+  report(db, tangle, max_samples);
+  ret = EXIT_SUCCESS;
+
+done:
+  sqlite3_finalize(statement);
+  sqlite3_close(db);
+
+  return ret;
+}
@@ -9,11 +9,13 @@
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <sqlite3.h>
 
 #include "common/model/milestone.h"
 #include "common/model/transaction.h"
+#include "common/storage/backend.h"
 #include "common/storage/sql/sqlite3/connection.h"
 #include "common/storage/sql/sqlite3/wrappers.h"
 #include "common/storage/sql/statements.h"
@@ -32,7 +34,7 @@ static void error_log_callback(void* const arg, int const err_code, char const*
   log_error(logger_id, "Failed with error code %d: %s\n", err_code, message);
 }
 
-retcode_t storage_init() {
+static retcode_t sqlite3_storage_init() {
   logger_id = logger_helper_enable(SQLITE3_LOGGER_ID, LOGGER_DEBUG, true);
 
   if (sqlite3_config(SQLITE_CONFIG_LOG, error_log_callback, NULL) != SQLITE_OK) {
@@ -56,7 +58,7 @@ retcode_t storage_init() {
   return RC_OK;
 }
 
-retcode_t storage_destroy() {
+static retcode_t sqlite3_storage_destroy() {
   logger_helper_release(logger_id);
 
   if (sqlite3_shutdown() != SQLITE_OK) {
@@ -117,7 +119,7 @@ static retcode_t execute_statement_load_gen(sqlite3_stmt* const sqlite_statement
       break;
     }
     if (model == MODEL_HASH) {
-      column_decompress_load(sqlite_statement, 0, ((flex_trit_t*)pack->models[pack->num_loaded]), FLEX_TRIT_SIZE_243);
+      column_decompress_load(sqlite_statement, 0, ((flex_trit_t*)pack->models[pack->num_loaded]), NUM_TRITS_HASH);
       pack->num_loaded++;
     } else if (model == MODEL_MILESTONE) {
       select_milestones_populate_from_row(sqlite_statement, pack->models[pack->num_loaded]);
@@ -186,12 +188,13 @@ enum value_type {
 static retcode_t update_transactions(storage_connection_t const* const connection, hash243_set_t const hashes,
                                      void const* const value, sqlite3_stmt* const sqlite_statement,
                                      enum value_type const type) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   retcode_t ret_rollback;
   bool should_rollback_if_failed = false;
 
-  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = write_batch_begin(sqlite3_connection)) != RC_OK ||
+      (ret = begin_savepoint(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
@@ -220,16 +223,16 @@ static retcode_t update_transactions(storage_connection_t const* const connectio
 done:
   sqlite3_reset(sqlite_statement);
   if (ret != RC_OK && should_rollback_if_failed) {
-    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
+    if ((ret_rollback = rollback_savepoint(sqlite3_connection->db)) != RC_OK) {
       return ret_rollback;
     }
     return ret;
   }
-  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = release_savepoint(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
-  return ret;
+  return write_batch_end(sqlite3_connection, hash243_set_size(hashes));
 }
 
 /*
@@ -243,7 +246,7 @@ static retcode_t bind_execute_hash_do_func(bind_execute_hash_params_t* const par
     return RC_SQLITE3_FAILED_BINDING;
   }
 
-  if (column_compress_bind(params->sqlite_statement, params->hash_index, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(params->sqlite_statement, params->hash_index, hash, NUM_TRITS_HASH) != RC_OK) {
     return RC_SQLITE3_FAILED_BINDING;
   }
 
@@ -282,42 +285,42 @@ static retcode_t execute_statement_load_transaction_metadata(sqlite3_stmt* const
 
 static void select_transactions_populate_essence(sqlite3_stmt* const statement, iota_transaction_t* const tx,
                                                  size_t* const index) {
-  column_decompress_load(statement, (*index)++, tx->essence.address, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, (*index)++, tx->essence.address, NUM_TRITS_ADDRESS);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_ADDRESS;
   transaction_set_value(tx, sqlite3_column_int64(statement, (*index)++));
-  column_decompress_load(statement, (*index)++, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, (*index)++, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_OBSOLETE_TAG;
   transaction_set_timestamp(tx, sqlite3_column_int64(statement, (*index)++));
   transaction_set_current_index(tx, sqlite3_column_int64(statement, (*index)++));
   transaction_set_last_index(tx, sqlite3_column_int64(statement, (*index)++));
-  column_decompress_load(statement, (*index)++, tx->essence.bundle, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, (*index)++, tx->essence.bundle, NUM_TRITS_BUNDLE);
   tx->loaded_columns_mask.essence |= MASK_ESSENCE_BUNDLE;
 }
 
 static void select_transactions_populate_attachment(sqlite3_stmt* const statement, iota_transaction_t* const tx,
                                                     size_t* const index) {
-  column_decompress_load(statement, (*index)++, tx->attachment.trunk, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, (*index)++, tx->attachment.trunk, NUM_TRITS_TRUNK);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TRUNK;
-  column_decompress_load(statement, (*index)++, tx->attachment.branch, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, (*index)++, tx->attachment.branch, NUM_TRITS_BRANCH);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_BRANCH;
   transaction_set_attachment_timestamp(tx, sqlite3_column_int64(statement, (*index)++));
   transaction_set_attachment_timestamp_lower(tx, sqlite3_column_int64(statement, (*index)++));
   transaction_set_attachment_timestamp_upper(tx, sqlite3_column_int64(statement, (*index)++));
-  column_decompress_load(statement, (*index)++, tx->attachment.nonce, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, (*index)++, tx->attachment.nonce, NUM_TRITS_NONCE);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_NONCE;
-  column_decompress_load(statement, (*index)++, tx->attachment.tag, FLEX_TRIT_SIZE_81);
+  column_decompress_load(statement, (*index)++, tx->attachment.tag, NUM_TRITS_TAG);
   tx->loaded_columns_mask.attachment |= MASK_ATTACHMENT_TAG;
 }
 
 static void select_transactions_populate_consensus(sqlite3_stmt* const statement, iota_transaction_t* const tx,
                                                    size_t* const index) {
-  column_decompress_load(statement, (*index)++, tx->consensus.hash, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, (*index)++, tx->consensus.hash, NUM_TRITS_HASH);
   tx->loaded_columns_mask.consensus |= MASK_CONSENSUS_HASH;
 }
 
 static void select_transactions_populate_data(sqlite3_stmt* const statement, iota_transaction_t* const tx,
                                               size_t* const index) {
-  column_decompress_load(statement, (*index)++, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561);
+  column_decompress_load(statement, (*index)++, tx->data.signature_or_message, NUM_TRITS_SIGNATURE);
   tx->loaded_columns_mask.data |= MASK_DATA_SIG_OR_MSG;
 }
 
@@ -329,7 +332,7 @@ static void select_transactions_populate_metadata(sqlite3_stmt* const statement,
   transaction_set_arrival_timestamp(tx, sqlite3_column_int64(statement, (*index)++));
 }
 
-retcode_t iota_stor_transaction_count(storage_connection_t const* const connection, size_t* const count) {
+static retcode_t sqlite3_stor_transaction_count(storage_connection_t const* const connection, size_t* const count) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_count;
@@ -347,28 +350,32 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_store(storage_connection_t const* const connection,
-                                      iota_transaction_t const* const tx) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t sqlite3_stor_transaction_store(storage_connection_t const* const connection,
+                                                iota_transaction_t const* const tx) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_insert;
 
-  if (column_compress_bind(sqlite_statement, 1, tx->data.signature_or_message, FLEX_TRIT_SIZE_6561) != RC_OK ||
-      column_compress_bind(sqlite_statement, 2, tx->essence.address, FLEX_TRIT_SIZE_243) != RC_OK ||
+  if ((ret = write_batch_begin(sqlite3_connection)) != RC_OK) {
+    return ret;
+  }
+
+  if (column_compress_bind(sqlite_statement, 1, tx->data.signature_or_message, NUM_TRITS_SIGNATURE) != RC_OK ||
+      column_compress_bind(sqlite_statement, 2, tx->essence.address, NUM_TRITS_ADDRESS) != RC_OK ||
       sqlite3_bind_int64(sqlite_statement, 3, tx->essence.value) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 4, tx->essence.obsolete_tag, FLEX_TRIT_SIZE_81) != RC_OK ||
+      column_compress_bind(sqlite_statement, 4, tx->essence.obsolete_tag, NUM_TRITS_OBSOLETE_TAG) != RC_OK ||
       sqlite3_bind_int64(sqlite_statement, 5, tx->essence.timestamp) != SQLITE_OK ||
       sqlite3_bind_int64(sqlite_statement, 6, tx->essence.current_index) != SQLITE_OK ||
       sqlite3_bind_int64(sqlite_statement, 7, tx->essence.last_index) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 8, tx->essence.bundle, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 9, tx->attachment.trunk, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 10, tx->attachment.branch, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 11, tx->attachment.tag, FLEX_TRIT_SIZE_81) != RC_OK ||
+      column_compress_bind(sqlite_statement, 8, tx->essence.bundle, NUM_TRITS_BUNDLE) != RC_OK ||
+      column_compress_bind(sqlite_statement, 9, tx->attachment.trunk, NUM_TRITS_TRUNK) != RC_OK ||
+      column_compress_bind(sqlite_statement, 10, tx->attachment.branch, NUM_TRITS_BRANCH) != RC_OK ||
+      column_compress_bind(sqlite_statement, 11, tx->attachment.tag, NUM_TRITS_TAG) != RC_OK ||
       sqlite3_bind_int64(sqlite_statement, 12, tx->attachment.attachment_timestamp) != SQLITE_OK ||
       sqlite3_bind_int64(sqlite_statement, 13, tx->attachment.attachment_timestamp_upper) != SQLITE_OK ||
       sqlite3_bind_int64(sqlite_statement, 14, tx->attachment.attachment_timestamp_lower) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 15, tx->attachment.nonce, FLEX_TRIT_SIZE_81) != RC_OK ||
-      column_compress_bind(sqlite_statement, 16, tx->consensus.hash, FLEX_TRIT_SIZE_243) != RC_OK ||
+      column_compress_bind(sqlite_statement, 15, tx->attachment.nonce, NUM_TRITS_NONCE) != RC_OK ||
+      column_compress_bind(sqlite_statement, 16, tx->consensus.hash, NUM_TRITS_HASH) != RC_OK ||
       sqlite3_bind_int64(sqlite_statement, 17, current_timestamp_ms()) != SQLITE_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
@@ -380,26 +387,31 @@ retcode_t iota_stor_transaction_store(storage_connection_t const* const connecti
 
 done:
   sqlite3_reset(sqlite_statement);
-  return ret;
+  // A failed statement doesn't abort the group commit, it holds the other writes
+  if (ret != RC_OK) {
+    return ret;
+  }
+  return write_batch_end(sqlite3_connection, 1);
 }
 
-retcode_t iota_stor_transaction_load(storage_connection_t const* const connection, transaction_field_t const field,
-                                     flex_trit_t const* const key, iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_transaction_load(storage_connection_t const* const connection,
+                                               transaction_field_t const field, flex_trit_t const* const key,
+                                               iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
-  size_t num_key_bytes;
+  size_t num_key_trits;
 
   switch (field) {
     case TRANSACTION_FIELD_HASH:
       sqlite_statement = sqlite3_connection->statements.transaction_select_by_hash;
-      num_key_bytes = FLEX_TRIT_SIZE_243;
+      num_key_trits = NUM_TRITS_HASH;
       break;
     default:
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
   }
 
-  if (column_compress_bind(sqlite_statement, 1, key, num_key_bytes) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, key, num_key_trits) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -413,13 +425,14 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_essence_and_metadata(storage_connection_t const* const connection,
-                                                          flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_transaction_load_essence_and_metadata(storage_connection_t const* const connection,
+                                                                    flex_trit_t const* const hash,
+                                                                    iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_essence_and_metadata;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -433,14 +446,13 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_essence_attachment_and_metadata(storage_connection_t const* const connection,
-                                                                     flex_trit_t const* const hash,
-                                                                     iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_transaction_load_essence_attachment_and_metadata(
+    storage_connection_t const* const connection, flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_essence_attachment_and_metadata;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -454,14 +466,14 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_essence_and_consensus(storage_connection_t const* const connection,
-                                                           flex_trit_t const* const hash,
-                                                           iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_transaction_load_essence_and_consensus(storage_connection_t const* const connection,
+                                                                     flex_trit_t const* const hash,
+                                                                     iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_essence_and_consensus;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -475,13 +487,13 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_metadata(storage_connection_t const* const connection,
-                                              flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_transaction_load_metadata(storage_connection_t const* const connection,
+                                                        flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_metadata;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -495,24 +507,24 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_hashes(storage_connection_t const* const connection,
-                                            transaction_field_t const field, flex_trit_t const* const key,
-                                            iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_transaction_load_hashes(storage_connection_t const* const connection,
+                                                      transaction_field_t const field, flex_trit_t const* const key,
+                                                      iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
-  size_t num_bytes_key;
+  size_t num_key_trits;
   sqlite3_stmt* sqlite_statement = NULL;
 
   switch (field) {
     case TRANSACTION_FIELD_ADDRESS:
       sqlite_statement = sqlite3_connection->statements.transaction_select_hashes_by_address;
-      num_bytes_key = FLEX_TRIT_SIZE_243;
+      num_key_trits = NUM_TRITS_HASH;
       break;
     default:
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
   }
 
-  if (column_compress_bind(sqlite_statement, 1, key, num_bytes_key) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, key, num_key_trits) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -526,17 +538,18 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_hashes_of_approvers(storage_connection_t const* const connection,
-                                                         flex_trit_t const* const approvee_hash,
-                                                         iota_stor_pack_t* const pack, int64_t before_timestamp) {
+static retcode_t sqlite3_stor_transaction_load_hashes_of_approvers(storage_connection_t const* const connection,
+                                                                   flex_trit_t const* const approvee_hash,
+                                                                   iota_stor_pack_t* const pack,
+                                                                   int64_t before_timestamp) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement =
       before_timestamp != 0 ? sqlite3_connection->statements.transaction_select_hashes_of_approvers_before_date
                             : sqlite3_connection->statements.transaction_select_hashes_of_approvers;
 
-  if (column_compress_bind(sqlite_statement, 1, approvee_hash, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 2, approvee_hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, approvee_hash, NUM_TRITS_HASH) != RC_OK ||
+      column_compress_bind(sqlite_statement, 2, approvee_hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -555,14 +568,13 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_load_hashes_of_milestone_candidates(storage_connection_t const* const connection,
-                                                                    iota_stor_pack_t* const pack,
-                                                                    flex_trit_t const* const coordinator) {
+static retcode_t sqlite3_stor_transaction_load_hashes_of_milestone_candidates(
+    storage_connection_t const* const connection, iota_stor_pack_t* const pack, flex_trit_t const* const coordinator) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_select_hashes_of_milestone_candidates;
 
-  if (column_compress_bind(sqlite_statement, 1, coordinator, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, coordinator, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -576,14 +588,18 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_update_solid_state(storage_connection_t const* const connection,
-                                                   flex_trit_t const* const hash, bool const is_solid) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t sqlite3_stor_transaction_update_solid_state(storage_connection_t const* const connection,
+                                                             flex_trit_t const* const hash, bool const is_solid) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_update_solid_state;
 
+  if ((ret = write_batch_begin(sqlite3_connection)) != RC_OK) {
+    return ret;
+  }
+
   if (sqlite3_bind_int(sqlite_statement, 1, (int)is_solid) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      column_compress_bind(sqlite_statement, 2, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -594,31 +610,40 @@ retcode_t iota_stor_transaction_update_solid_state(storage_connection_t const* c
 
 done:
   sqlite3_reset(sqlite_statement);
-  return ret;
+  if (ret != RC_OK) {
+    return ret;
+  }
+  return write_batch_end(sqlite3_connection, 1);
 }
 
-retcode_t iota_stor_transactions_update_solid_state(storage_connection_t const* const connection,
-                                                    hash243_set_t const hashes, bool const is_solid) {
+static retcode_t sqlite3_stor_transactions_update_solid_state(storage_connection_t const* const connection,
+                                                              hash243_set_t const hashes, bool const is_solid) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   return update_transactions(connection, hashes, &is_solid,
                              sqlite3_connection->statements.transaction_update_solid_state, BOOLEAN);
 }
 
-retcode_t iota_stor_transactions_update_snapshot_index(storage_connection_t const* const connection,
-                                                       hash243_set_t const hashes, uint64_t const snapshot_index) {
+static retcode_t sqlite3_stor_transactions_update_snapshot_index(storage_connection_t const* const connection,
+                                                                 hash243_set_t const hashes,
+                                                                 uint64_t const snapshot_index) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   return update_transactions(connection, hashes, &snapshot_index,
                              sqlite3_connection->statements.transaction_update_snapshot_index, INT64);
 }
 
-retcode_t iota_stor_transaction_update_snapshot_index(storage_connection_t const* const connection,
-                                                      flex_trit_t const* const hash, uint64_t const snapshot_index) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t sqlite3_stor_transaction_update_snapshot_index(storage_connection_t const* const connection,
+                                                                flex_trit_t const* const hash,
+                                                                uint64_t const snapshot_index) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_update_snapshot_index;
 
+  if ((ret = write_batch_begin(sqlite3_connection)) != RC_OK) {
+    return ret;
+  }
+
   if (sqlite3_bind_int64(sqlite_statement, 1, snapshot_index) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      column_compress_bind(sqlite_statement, 2, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -629,15 +654,19 @@ retcode_t iota_stor_transaction_update_snapshot_index(storage_connection_t const
 
 done:
   sqlite3_reset(sqlite_statement);
-  return ret;
+  if (ret != RC_OK) {
+    return ret;
+  }
+  return write_batch_end(sqlite3_connection, 1);
 }
 
-retcode_t iota_stor_transaction_exist(storage_connection_t const* const connection, transaction_field_t const field,
-                                      flex_trit_t const* const key, bool* const exist) {
+static retcode_t sqlite3_stor_transaction_exist(storage_connection_t const* const connection,
+                                                transaction_field_t const field, flex_trit_t const* const key,
+                                                bool* const exist) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
-  size_t num_bytes_key;
+  size_t num_key_trits;
 
   switch (field) {
     case TRANSACTION_FIELD_NONE:
@@ -645,14 +674,14 @@ retcode_t iota_stor_transaction_exist(storage_connection_t const* const connecti
       break;
     case TRANSACTION_FIELD_HASH:
       sqlite_statement = sqlite3_connection->statements.transaction_exist_by_hash;
-      num_bytes_key = FLEX_TRIT_SIZE_243;
+      num_key_trits = NUM_TRITS_HASH;
       break;
     default:
       return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
   }
 
   if (field != TRANSACTION_FIELD_NONE && key) {
-    if (column_compress_bind(sqlite_statement, 1, (void*)key, num_bytes_key) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, 1, (void*)key, num_key_trits) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -667,15 +696,15 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_approvers_count(storage_connection_t const* const connection,
-                                                flex_trit_t const* const hash, size_t* const count) {
+static retcode_t sqlite3_stor_transaction_approvers_count(storage_connection_t const* const connection,
+                                                          flex_trit_t const* const hash, size_t* const count) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   int rc = 0;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_approvers_count;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK ||
-      column_compress_bind(sqlite_statement, 2, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK ||
+      column_compress_bind(sqlite_statement, 2, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -693,10 +722,11 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
-                                     hash243_queue_t const addresses, hash81_queue_t const tags,
-                                     hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t sqlite3_stor_transaction_find(storage_connection_t const* const connection,
+                                               hash243_queue_t const bundles, hash243_queue_t const addresses,
+                                               hash81_queue_t const tags, hash243_queue_t const approvees,
+                                               iota_stor_pack_t* const pack) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
   size_t bundles_count = hash243_queue_count(bundles);
@@ -709,7 +739,11 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
 
   char* statement = iota_statement_transaction_find_build(bundles_count, addresses_count, tags_count, approvees_count);
 
-  if ((ret = prepare_statement(sqlite3_connection->db, &sqlite_statement, statement)) != RC_OK) {
+  if (statement == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = statement_cache_get(sqlite3_connection, statement, &sqlite_statement)) != RC_OK) {
     goto done;
   }
 
@@ -719,7 +753,7 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(bundles, iter243) {
-    if (column_compress_bind(sqlite_statement, column++, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column++, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -731,7 +765,7 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(addresses, iter243) {
-    if (column_compress_bind(sqlite_statement, column++, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column++, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -743,7 +777,7 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(tags, iter81) {
-    if (column_compress_bind(sqlite_statement, column++, iter81->hash, FLEX_TRIT_SIZE_81) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column++, iter81->hash, NUM_TRITS_TAG) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -755,11 +789,11 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
   CDL_FOREACH(approvees, iter243) {
-    if (column_compress_bind(sqlite_statement, column, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
-    if (column_compress_bind(sqlite_statement, column + approvees_count, iter243->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, column + approvees_count, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -771,12 +805,156 @@ retcode_t iota_stor_transaction_find(storage_connection_t const* const connectio
   }
 
 done:
-  finalize_statement(sqlite_statement);
+  // Kept prepared in the cache of the connection, without bindings to the caller's hashes
+  if (sqlite_statement != NULL) {
+    sqlite3_reset(sqlite_statement);
+    sqlite3_clear_bindings(sqlite_statement);
+  }
   free(statement);
   return ret;
 }
 
-retcode_t iota_stor_transaction_metadata_clear(storage_connection_t const* const connection) {
+static retcode_t cursor_bind(sqlite3_stmt* const sqlite_statement, storage_cursor_t const* const cursor,
+                             size_t* const column) {
+  hash243_queue_entry_t* iter243 = NULL;
+  hash81_queue_entry_t* iter81 = NULL;
+  size_t const approvees_count = hash243_queue_count(cursor->approvees);
+
+  switch (cursor->type) {
+    case STORAGE_CURSOR_HASHES_BY_ADDRESS:
+    case STORAGE_CURSOR_HASHES_OF_MILESTONE_CANDIDATES:
+      return column_compress_bind(sqlite_statement, (*column)++, cursor->key, NUM_TRITS_ADDRESS);
+    case STORAGE_CURSOR_HASHES_OF_APPROVERS:
+      if (column_compress_bind(sqlite_statement, (*column)++, cursor->key, NUM_TRITS_HASH) != RC_OK ||
+          column_compress_bind(sqlite_statement, (*column)++, cursor->key, NUM_TRITS_HASH) != RC_OK ||
+          sqlite3_bind_int64(sqlite_statement, (*column)++,
+                             cursor->before_timestamp != 0 ? cursor->before_timestamp : INT64_MAX) != SQLITE_OK) {
+        return RC_SQLITE3_FAILED_BINDING;
+      }
+      return RC_OK;
+    case STORAGE_CURSOR_FIND:
+      CDL_FOREACH(cursor->bundles, iter243) {
+        if (column_compress_bind(sqlite_statement, (*column)++, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
+          return RC_SQLITE3_FAILED_BINDING;
+        }
+      }
+      CDL_FOREACH(cursor->addresses, iter243) {
+        if (column_compress_bind(sqlite_statement, (*column)++, iter243->hash, NUM_TRITS_HASH) != RC_OK) {
+          return RC_SQLITE3_FAILED_BINDING;
+        }
+      }
+      CDL_FOREACH(cursor->tags, iter81) {
+        if (column_compress_bind(sqlite_statement, (*column)++, iter81->hash, NUM_TRITS_TAG) != RC_OK) {
+          return RC_SQLITE3_FAILED_BINDING;
+        }
+      }
+      // Once in the branch list, once in the trunk one
+      CDL_FOREACH(cursor->approvees, iter243) {
+        if (column_compress_bind(sqlite_statement, *column, iter243->hash, NUM_TRITS_HASH) != RC_OK ||
+            column_compress_bind(sqlite_statement, *column + approvees_count, iter243->hash, NUM_TRITS_HASH) !=
+                RC_OK) {
+          return RC_SQLITE3_FAILED_BINDING;
+        }
+        (*column)++;
+      }
+      *column += approvees_count;
+      return RC_OK;
+  }
+
+  return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
+}
+
+static retcode_t sqlite3_stor_cursor_next(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                          iota_stor_pack_t* const batch) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+  retcode_t ret = RC_OK;
+  sqlite3_stmt* sqlite_statement = NULL;
+  bool const essence_and_metadata = cursor->model == STORAGE_CURSOR_MODEL_ESSENCE_METADATA;
+  char* statement = NULL;
+  size_t column = 1;
+  size_t index = 0;
+  int64_t rowid = 0;
+  int rc = 0;
+
+  batch->insufficient_capacity = false;
+  if (batch->num_loaded == batch->capacity) {
+    return RC_OK;
+  }
+
+  switch (cursor->type) {
+    case STORAGE_CURSOR_HASHES_BY_ADDRESS:
+      statement =
+          iota_statement_transaction_cursor_build(iota_statement_cursor_hashes_by_address, essence_and_metadata);
+      break;
+    case STORAGE_CURSOR_HASHES_OF_APPROVERS:
+      statement =
+          iota_statement_transaction_cursor_build(iota_statement_cursor_hashes_of_approvers, essence_and_metadata);
+      break;
+    case STORAGE_CURSOR_HASHES_OF_MILESTONE_CANDIDATES:
+      statement = iota_statement_transaction_cursor_build(iota_statement_cursor_hashes_of_milestone_candidates,
+                                                          essence_and_metadata);
+      break;
+    case STORAGE_CURSOR_FIND:
+      statement = iota_statement_cursor_find_build(
+          hash243_queue_count(cursor->bundles), hash243_queue_count(cursor->addresses),
+          hash81_queue_count(cursor->tags), hash243_queue_count(cursor->approvees), essence_and_metadata);
+      break;
+    default:
+      return RC_SQLITE3_FAILED_NOT_IMPLEMENTED;
+  }
+
+  if (statement == NULL) {
+    return RC_OOM;
+  }
+
+  if ((ret = statement_cache_get(sqlite3_connection, statement, &sqlite_statement)) != RC_OK) {
+    goto done;
+  }
+
+  // The position is the rowid of the last transaction loaded, one more row than the batch holds tells whether the
+  // cursor is done
+  if (cursor->position_size == sizeof(int64_t)) {
+    memcpy(&rowid, cursor->position, sizeof(int64_t));
+  }
+  if (sqlite3_bind_int64(sqlite_statement, column++, rowid) != SQLITE_OK ||
+      (ret = cursor_bind(sqlite_statement, cursor, &column)) != RC_OK ||
+      sqlite3_bind_int64(sqlite_statement, column, batch->capacity - batch->num_loaded + 1) != SQLITE_OK) {
+    ret = RC_SQLITE3_FAILED_BINDING;
+    goto done;
+  }
+
+  while ((rc = sqlite3_step(sqlite_statement)) == SQLITE_ROW && batch->num_loaded < batch->capacity) {
+    rowid = sqlite3_column_int64(sqlite_statement, 0);
+    if (essence_and_metadata) {
+      index = 1;
+      select_transactions_populate_consensus(sqlite_statement, batch->models[batch->num_loaded], &index);
+      select_transactions_populate_essence(sqlite_statement, batch->models[batch->num_loaded], &index);
+      select_transactions_populate_metadata(sqlite_statement, batch->models[batch->num_loaded], &index);
+    } else {
+      column_decompress_load(sqlite_statement, 1, (flex_trit_t*)batch->models[batch->num_loaded], NUM_TRITS_HASH);
+    }
+    batch->num_loaded++;
+  }
+  if (rc != SQLITE_ROW && rc != SQLITE_DONE) {
+    ret = RC_SQLITE3_FAILED_STEP;
+    goto done;
+  }
+
+  cursor->done = rc == SQLITE_DONE;
+  memcpy(cursor->position, &rowid, sizeof(int64_t));
+  cursor->position_size = sizeof(int64_t);
+
+done:
+  // Kept prepared in the cache of the connection, without bindings to the caller's hashes
+  if (sqlite_statement != NULL) {
+    sqlite3_reset(sqlite_statement);
+    sqlite3_clear_bindings(sqlite_statement);
+  }
+  free(statement);
+  return ret;
+}
+
+static retcode_t sqlite3_stor_transaction_metadata_clear(storage_connection_t const* const connection) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_metadata_clear;
@@ -790,14 +968,16 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_transactions_delete(storage_connection_t const* const connection, hash243_set_t const hashes) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t sqlite3_stor_transactions_delete(storage_connection_t const* const connection,
+                                                  hash243_set_t const hashes) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   retcode_t ret_rollback;
   bool should_rollback_if_failed = false;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_delete;
 
-  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = write_batch_begin(sqlite3_connection)) != RC_OK ||
+      (ret = begin_savepoint(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
@@ -814,31 +994,33 @@ retcode_t iota_stor_transactions_delete(storage_connection_t const* const connec
 done:
   sqlite3_reset(sqlite_statement);
   if (ret != RC_OK && should_rollback_if_failed) {
-    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
+    if ((ret_rollback = rollback_savepoint(sqlite3_connection->db)) != RC_OK) {
       return ret_rollback;
     }
     return ret;
   }
-  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = release_savepoint(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
-  return ret;
+  return write_batch_end(sqlite3_connection, hash243_set_size(hashes));
 }
 
 /*
  * Bundle operations
  */
 
-retcode_t iota_stor_bundle_update_validity(storage_connection_t const* const connection,
-                                           bundle_transactions_t const* const bundle, bundle_status_t const status) {
-  sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
+static retcode_t sqlite3_stor_bundle_update_validity(storage_connection_t const* const connection,
+                                                     bundle_transactions_t const* const bundle,
+                                                     bundle_status_t const status) {
+  sqlite3_tangle_connection_t* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   retcode_t ret_rollback;
   bool should_rollback_if_failed = true;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.transaction_update_validity;
 
-  if ((ret = begin_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = write_batch_begin(sqlite3_connection)) != RC_OK ||
+      (ret = begin_savepoint(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
@@ -861,16 +1043,16 @@ retcode_t iota_stor_bundle_update_validity(storage_connection_t const* const con
 done:
   sqlite3_reset(sqlite_statement);
   if (ret != RC_OK && should_rollback_if_failed) {
-    if ((ret_rollback = rollback_transaction(sqlite3_connection->db)) != RC_OK) {
+    if ((ret_rollback = rollback_savepoint(sqlite3_connection->db)) != RC_OK) {
       return ret_rollback;
     }
     return ret;
   }
-  if ((ret = end_transaction(sqlite3_connection->db)) != RC_OK) {
+  if ((ret = release_savepoint(sqlite3_connection->db)) != RC_OK) {
     return ret;
   }
 
-  return ret;
+  return write_batch_end(sqlite3_connection, bundle_transactions_size(bundle));
 }
 
 /*
@@ -884,10 +1066,10 @@ static retcode_t execute_statement_load_milestones(sqlite3_stmt* const sqlite_st
 
 static void select_milestones_populate_from_row(sqlite3_stmt* const statement, iota_milestone_t* const milestone) {
   milestone->index = sqlite3_column_int64(statement, 0);
-  column_decompress_load(statement, 1, milestone->hash, FLEX_TRIT_SIZE_243);
+  column_decompress_load(statement, 1, milestone->hash, NUM_TRITS_HASH);
 }
 
-retcode_t iota_stor_milestone_clear(storage_connection_t const* const connection) {
+static retcode_t sqlite3_stor_milestone_clear(storage_connection_t const* const connection) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_clear;
@@ -901,15 +1083,15 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_store(storage_connection_t const* const connection,
-                                    iota_milestone_t const* const milestone) {
+static retcode_t sqlite3_stor_milestone_store(storage_connection_t const* const connection,
+                                              iota_milestone_t const* const milestone) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   assert(milestone);
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_insert;
 
   if (sqlite3_bind_int64(sqlite_statement, 1, milestone->index) != SQLITE_OK ||
-      column_compress_bind(sqlite_statement, 2, (flex_trit_t*)milestone->hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+      column_compress_bind(sqlite_statement, 2, (flex_trit_t*)milestone->hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -923,13 +1105,13 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_load(storage_connection_t const* const connection, flex_trit_t const* const hash,
-                                   iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_milestone_load(storage_connection_t const* const connection,
+                                             flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_select_by_hash;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -943,7 +1125,8 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_load_last(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_milestone_load_last(storage_connection_t const* const connection,
+                                                  iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_select_last;
@@ -957,7 +1140,8 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_load_first(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_milestone_load_first(storage_connection_t const* const connection,
+                                                   iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_select_first;
@@ -971,8 +1155,8 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_load_by_index(storage_connection_t const* const connection, uint64_t const index,
-                                            iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_milestone_load_by_index(storage_connection_t const* const connection,
+                                                      uint64_t const index, iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_select_by_index;
@@ -991,8 +1175,8 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_load_next(storage_connection_t const* const connection, uint64_t const index,
-                                        iota_stor_pack_t* const pack) {
+static retcode_t sqlite3_stor_milestone_load_next(storage_connection_t const* const connection, uint64_t const index,
+                                                  iota_stor_pack_t* const pack) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.milestone_select_next;
@@ -1011,8 +1195,8 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_exist(storage_connection_t const* const connection, flex_trit_t const* const hash,
-                                    bool* const exist) {
+static retcode_t sqlite3_stor_milestone_exist(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, bool* const exist) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
@@ -1024,7 +1208,7 @@ retcode_t iota_stor_milestone_exist(storage_connection_t const* const connection
   }
 
   if (hash) {
-    if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+    if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
       ret = RC_SQLITE3_FAILED_BINDING;
       goto done;
     }
@@ -1039,14 +1223,15 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_milestone_delete(storage_connection_t const* const connection, flex_trit_t const* const hash) {
+static retcode_t sqlite3_stor_milestone_delete(storage_connection_t const* const connection,
+                                               flex_trit_t const* const hash) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   sqlite3_stmt* sqlite_statement = NULL;
 
   sqlite_statement = sqlite3_connection->statements.milestone_delete_by_hash;
 
-  if (column_compress_bind(sqlite_statement, 1, hash, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, hash, NUM_TRITS_HASH) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -1064,16 +1249,18 @@ done:
  * State delta operations
  */
 
-retcode_t iota_stor_state_delta_store(storage_connection_t const* const connection, uint64_t const index,
-                                      state_delta_t const* const delta) {
+static retcode_t sqlite3_stor_state_delta_store(storage_connection_t const* const connection, uint64_t const index,
+                                                state_delta_t const* const delta) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
   size_t size = 0;
   byte_t* bytes = NULL;
+  byte_t* packed = NULL;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.state_delta_store;
 
   size = state_delta_serialized_size(delta);
-  if ((bytes = (byte_t*)calloc(size, sizeof(byte_t))) == NULL) {
+  if ((bytes = (byte_t*)calloc(size, sizeof(byte_t))) == NULL ||
+      (packed = (byte_t*)calloc(size, sizeof(byte_t))) == NULL) {
     ret = RC_OOM;
     goto done;
   }
@@ -1081,8 +1268,10 @@ retcode_t iota_stor_state_delta_store(storage_connection_t const* const connecti
   if ((ret = state_delta_serialize(delta, bytes)) != RC_OK) {
     goto done;
   }
+  // A packed entry is never larger than a serialized one
+  size = column_pack_delta(packed, bytes, size);
 
-  if (sqlite3_bind_blob(sqlite_statement, 1, bytes, size, NULL) != SQLITE_OK ||
+  if (sqlite3_bind_blob(sqlite_statement, 1, packed, size, NULL) != SQLITE_OK ||
       sqlite3_bind_int(sqlite_statement, 2, index) != SQLITE_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
@@ -1097,13 +1286,17 @@ done:
   if (bytes) {
     free(bytes);
   }
+  if (packed) {
+    free(packed);
+  }
   return ret;
 }
 
-retcode_t iota_stor_state_delta_load(storage_connection_t const* const connection, uint64_t const index,
-                                     state_delta_t* const delta) {
+static retcode_t sqlite3_stor_state_delta_load(storage_connection_t const* const connection, uint64_t const index,
+                                               state_delta_t* const delta) {
   sqlite3_tangle_connection_t const* sqlite3_connection = (sqlite3_tangle_connection_t*)connection->actual;
   retcode_t ret = RC_OK;
+  byte_t const* packed = NULL;
   byte_t* bytes = NULL;
   size_t size = 0;
   int rc = 0;
@@ -1118,8 +1311,13 @@ retcode_t iota_stor_state_delta_load(storage_connection_t const* const connectio
 
   rc = sqlite3_step(sqlite_statement);
   if (rc == SQLITE_ROW) {
-    bytes = (byte_t*)sqlite3_column_blob(sqlite_statement, 0);
-    size = sqlite3_column_bytes(sqlite_statement, 0);
+    packed = (byte_t const*)sqlite3_column_blob(sqlite_statement, 0);
+    size = sqlite3_column_bytes(sqlite_statement, 0) / COLUMN_DELTA_ENTRY_SIZE;
+    if ((bytes = (byte_t*)malloc(size * COLUMN_DELTA_SERIALIZED_ENTRY_SIZE + 1)) == NULL) {
+      ret = RC_OOM;
+      goto done;
+    }
+    size = column_unpack_delta(bytes, packed, size * COLUMN_DELTA_ENTRY_SIZE);
     if ((ret = state_delta_deserialize(bytes, size, delta)) != RC_OK) {
       goto done;
     }
@@ -1129,6 +1327,9 @@ retcode_t iota_stor_state_delta_load(storage_connection_t const* const connectio
 
 done:
   sqlite3_reset(sqlite_statement);
+  if (bytes) {
+    free(bytes);
+  }
   return ret;
 }
 
@@ -1136,14 +1337,14 @@ done:
  * Spent address operations
  */
 
-retcode_t iota_stor_spent_address_store(storage_connection_t const* const connection,
-                                        flex_trit_t const* const address) {
+static retcode_t sqlite3_stor_spent_address_store(storage_connection_t const* const connection,
+                                                  flex_trit_t const* const address) {
   retcode_t ret = RC_OK;
   sqlite3_spent_addresses_connection_t const* sqlite3_connection =
       (sqlite3_spent_addresses_connection_t*)connection->actual;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.spent_address_insert;
 
-  if (column_compress_bind(sqlite_statement, 1, address, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, address, NUM_TRITS_ADDRESS) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -1157,7 +1358,8 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_spent_addresses_store(storage_connection_t const* const connection, hash243_set_t const addresses) {
+static retcode_t sqlite3_stor_spent_addresses_store(storage_connection_t const* const connection,
+                                                    hash243_set_t const addresses) {
   retcode_t ret = RC_OK;
   sqlite3_spent_addresses_connection_t const* sqlite3_connection =
       (sqlite3_spent_addresses_connection_t*)connection->actual;
@@ -1193,14 +1395,14 @@ done:
   return ret;
 }
 
-retcode_t iota_stor_spent_address_exist(storage_connection_t const* const connection, flex_trit_t const* const address,
-                                        bool* const exist) {
+static retcode_t sqlite3_stor_spent_address_exist(storage_connection_t const* const connection,
+                                                  flex_trit_t const* const address, bool* const exist) {
   retcode_t ret = RC_OK;
   sqlite3_spent_addresses_connection_t const* sqlite3_connection =
       (sqlite3_spent_addresses_connection_t*)connection->actual;
   sqlite3_stmt* sqlite_statement = sqlite3_connection->statements.spent_address_exist;
 
-  if (column_compress_bind(sqlite_statement, 1, address, FLEX_TRIT_SIZE_243) != RC_OK) {
+  if (column_compress_bind(sqlite_statement, 1, address, NUM_TRITS_ADDRESS) != RC_OK) {
     ret = RC_SQLITE3_FAILED_BINDING;
     goto done;
   }
@@ -1213,3 +1415,48 @@ done:
   sqlite3_reset(sqlite_statement);
   return ret;
 }
+
+storage_backend_t const sqlite3_storage_backend = {
+    .name = "sqlite3",
+    .init = sqlite3_storage_init,
+    .destroy = sqlite3_storage_destroy,
+    .connection_init = sqlite3_connection_init,
+    .connection_destroy = sqlite3_connection_destroy,
+    .connection_flush = sqlite3_connection_flush,
+    .connection_pending_batch = sqlite3_connection_pending_batch,
+    .transaction_count = sqlite3_stor_transaction_count,
+    .transaction_store = sqlite3_stor_transaction_store,
+    .transaction_load = sqlite3_stor_transaction_load,
+    .transaction_load_essence_and_metadata = sqlite3_stor_transaction_load_essence_and_metadata,
+    .transaction_load_essence_attachment_and_metadata = sqlite3_stor_transaction_load_essence_attachment_and_metadata,
+    .transaction_load_essence_and_consensus = sqlite3_stor_transaction_load_essence_and_consensus,
+    .transaction_load_metadata = sqlite3_stor_transaction_load_metadata,
+    .transaction_load_hashes = sqlite3_stor_transaction_load_hashes,
+    .transaction_load_hashes_of_approvers = sqlite3_stor_transaction_load_hashes_of_approvers,
+    .transaction_load_hashes_of_milestone_candidates = sqlite3_stor_transaction_load_hashes_of_milestone_candidates,
+    .transaction_update_solid_state = sqlite3_stor_transaction_update_solid_state,
+    .transactions_update_solid_state = sqlite3_stor_transactions_update_solid_state,
+    .transactions_update_snapshot_index = sqlite3_stor_transactions_update_snapshot_index,
+    .transaction_update_snapshot_index = sqlite3_stor_transaction_update_snapshot_index,
+    .transaction_exist = sqlite3_stor_transaction_exist,
+    .transaction_approvers_count = sqlite3_stor_transaction_approvers_count,
+    .transaction_find = sqlite3_stor_transaction_find,
+    .cursor_next = sqlite3_stor_cursor_next,
+    .transaction_metadata_clear = sqlite3_stor_transaction_metadata_clear,
+    .transactions_delete = sqlite3_stor_transactions_delete,
+    .bundle_update_validity = sqlite3_stor_bundle_update_validity,
+    .milestone_clear = sqlite3_stor_milestone_clear,
+    .milestone_store = sqlite3_stor_milestone_store,
+    .milestone_load = sqlite3_stor_milestone_load,
+    .milestone_load_last = sqlite3_stor_milestone_load_last,
+    .milestone_load_first = sqlite3_stor_milestone_load_first,
+    .milestone_load_by_index = sqlite3_stor_milestone_load_by_index,
+    .milestone_load_next = sqlite3_stor_milestone_load_next,
+    .milestone_exist = sqlite3_stor_milestone_exist,
+    .milestone_delete = sqlite3_stor_milestone_delete,
+    .state_delta_store = sqlite3_stor_state_delta_store,
+    .state_delta_load = sqlite3_stor_state_delta_load,
+    .spent_address_store = sqlite3_stor_spent_address_store,
+    .spent_addresses_store = sqlite3_stor_spent_addresses_store,
+    .spent_address_exist = sqlite3_stor_spent_address_exist,
+};
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Measures the insertion rate of iota_stor_transaction_store, one autocommitted transaction per store against group
+ * commits, at every durability level.
+ *
+ * Each run stores synthetic transactions with distinct hashes, addresses, bundles and approvees into a fresh copy of
+ * the schema database, then flushes the connection so that the pending batch is accounted for.
+ *
+ * Usage: bench_transaction_store [schema database] [transactions] [batch size] [batch timeout in ms]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/connection.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/helpers.h"
+#include "utils/files.h"
+#include "utils/time.h"
+
+#define DEFAULT_SCHEMA_DB_PATH "common/storage/sql/sqlite3/tests/ciri.db"
+#define BENCH_DB_PATH "common/storage/sql/sqlite3/tests/bench.db"
+#define DEFAULT_TRANSACTIONS 1000000
+#define DEFAULT_BATCH_SIZE 500
+#define DEFAULT_BATCH_TIMEOUT_MS 100
+
+static char const *const DURABILITY_NAMES[] = {"full", "normal", "off"};
+
+static int run(char const *const schema_db_path, size_t const transactions, storage_durability_t const durability,
+               size_t const batch_size, uint64_t const batch_timeout_ms) {
+  connection_config_t config = {.db_path = BENCH_DB_PATH,
+                                .durability = durability,
+                                .write_batch_size = batch_size,
+                                .write_batch_timeout_ms = batch_timeout_ms};
+  storage_connection_t connection;
+  iota_transaction_t *tx = transaction_new();
+  flex_trit_t field[FLEX_TRIT_SIZE_6561];
+  uint64_t start = 0, elapsed = 0;
+  int ret = EXIT_FAILURE;
+
+  if (tx == NULL) {
+    return EXIT_FAILURE;
+  }
+  remove(BENCH_DB_PATH "-wal");
+  remove(BENCH_DB_PATH "-shm");
+  if (iota_utils_copy_file(BENCH_DB_PATH, schema_db_path) != RC_OK ||
+      connection_init(&connection, &config, STORAGE_CONNECTION_TANGLE) != RC_OK) {
+    transaction_free(tx);
+    return EXIT_FAILURE;
+  }
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i++) {
+    fill_field(field, NUM_TRITS_HASH, i, 0);
+    transaction_set_hash(tx, field);
+    fill_field(field, NUM_TRITS_ADDRESS, i, 1);
+    transaction_set_address(tx, field);
+    fill_field(field, NUM_TRITS_BUNDLE, i / 4, 2);
+    transaction_set_bundle(tx, field);
+    fill_field(field, NUM_TRITS_TRUNK, i / 2, 0);
+    transaction_set_trunk(tx, field);
+    fill_field(field, NUM_TRITS_BRANCH, i / 3, 0);
+    transaction_set_branch(tx, field);
+    // Half of the transactions carry a signature or a message
+    memset(field, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_6561);
+    if (i % 2 == 0) {
+      fill_field(field, NUM_TRITS_SIGNATURE, i, 3);
+    }
+    transaction_set_signature(tx, field);
+    transaction_set_current_index(tx, i % 4);
+    transaction_set_last_index(tx, 3);
+    transaction_set_arrival_timestamp(tx, i);
+    if (iota_stor_transaction_store(&connection, tx) != RC_OK) {
+      fprintf(stderr, "Storing transaction %zu failed\n", i);
+      goto done;
+    }
+  }
+  if (connection_flush(&connection) != RC_OK) {
+    goto done;
+  }
+  elapsed = monotonic_timestamp_us() - start;
+
+  printf("%-10s %-8s %10.0f inserts/s  %8.2f us/insert\n", batch_size >= 2 ? "batched" : "autocommit",
+         DURABILITY_NAMES[durability], transactions / (elapsed / 1e6), (double)elapsed / transactions);
+  ret = EXIT_SUCCESS;
+
+done:
+  connection_destroy(&connection);
+  transaction_free(tx);
+  remove(BENCH_DB_PATH);
+  remove(BENCH_DB_PATH "-wal");
+  remove(BENCH_DB_PATH "-shm");
+
+  return ret;
+}
+
+int main(int argc, char **argv) {
+  char const *const schema_db_path = argc > 1 ? argv[1] : DEFAULT_SCHEMA_DB_PATH;
+  size_t const transactions = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_TRANSACTIONS;
+  size_t const batch_size = argc > 3 ? strtoul(argv[3], NULL, 10) : DEFAULT_BATCH_SIZE;
+  uint64_t const batch_timeout_ms = argc > 4 ? strtoull(argv[4], NULL, 10) : DEFAULT_BATCH_TIMEOUT_MS;
+  int ret = EXIT_SUCCESS;
+
+  if (transactions == 0 || storage_init() != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  printf("store: %zu transactions, batches of %zu or %" PRIu64 " ms\n", transactions, batch_size, batch_timeout_ms);
+
+  for (storage_durability_t durability = STORAGE_DURABILITY_FULL;
+       durability <= STORAGE_DURABILITY_OFF && ret == EXIT_SUCCESS; durability++) {
+    if ((ret = run(schema_db_path, transactions, durability, 0, 0)) == EXIT_SUCCESS) {
+      ret = run(schema_db_path, transactions, durability, batch_size, batch_timeout_ms);
+    }
+  }
+
+  storage_destroy();
+
+  return ret;
+}
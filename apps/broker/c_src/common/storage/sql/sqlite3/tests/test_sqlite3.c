@@ -13,7 +13,9 @@
 #include "common/helpers/digest.h"
 #include "common/model/milestone.h"
 #include "common/model/transaction.h"
+#include "common/storage/pool.h"
 #include "common/storage/sql/sqlite3/connection.h"
+#include "common/storage/sql/sqlite3/wrappers.h"
 #include "common/storage/storage.h"
 #include "common/storage/tests/helpers/defs.h"
 #include "utils/containers/hash/hash243_set.h"
@@ -21,6 +23,7 @@
 
 static char *test_db_path = "common/storage/sql/sqlite3/tests/test.db";
 static char *ciri_db_path = "common/storage/sql/sqlite3/tests/ciri.db";
+static char *unversioned_db_path = "common/storage/sql/sqlite3/tests/unversioned.db";
 // TODO Remove after "Common definitions #329" is merged
 #define HASH_LENGTH 243
 
@@ -56,8 +59,7 @@ const flex_trit_t HASH[] = {
 static storage_connection_t connection;
 
 void test_init_connection(void) {
-  connection_config_t config;
-  config.db_path = test_db_path;
+  connection_config_t config = {.db_path = test_db_path};
   TEST_ASSERT(connection_init(&connection, &config, STORAGE_CONNECTION_TANGLE) == RC_OK);
 }
 
@@ -147,7 +149,7 @@ void test_stored_milestone(void) {
   TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_SQLITE3_FAILED_STEP);
 
   // Test get last
-  milestone.hash[0]++;
+  milestone.hash[1]++;
   TEST_ASSERT(iota_stor_milestone_store(&connection, &milestone) == RC_OK);
 
   DECLARE_PACK_SINGLE_MILESTONE(ms, ms_ptr, ms_pack);
@@ -156,7 +158,7 @@ void test_stored_milestone(void) {
   TEST_ASSERT_EQUAL_INT(1, ms_pack.num_loaded);
   TEST_ASSERT_EQUAL_INT(ms.index, milestone.index);
   TEST_ASSERT_EQUAL_MEMORY(ms.hash, milestone.hash, FLEX_TRIT_SIZE_243);
-  milestone.hash[0]--;
+  milestone.hash[1]--;
   milestone.index--;
 
   bool exist = false;
@@ -259,6 +261,8 @@ void test_milestone_state_delta(void) {
   trit_t trits[HASH_LENGTH] = {1};
   flex_trit_t hash[FLEX_TRIT_SIZE_243];
   flex_trit_t *hashed_hash;
+  sqlite3 *db = ((sqlite3_tangle_connection_t *)connection.actual)->db;
+  sqlite3_stmt *statement = NULL;
 
   flex_trits_from_trits(hash, HASH_LENGTH, trits, HASH_LENGTH, HASH_LENGTH);
   for (int64_t i = -1000; i <= 1000; i++) {
@@ -270,6 +274,13 @@ void test_milestone_state_delta(void) {
 
   TEST_ASSERT(iota_stor_state_delta_store(&connection, 42, &state_delta1) == RC_OK);
 
+  // Addresses of the delta are stored packed 5 trits per byte whatever the flex encoding
+  TEST_ASSERT(sqlite3_prepare_v2(db, "SELECT length(delta) FROM iota_milestone WHERE id=42", -1, &statement, NULL) ==
+              SQLITE_OK);
+  TEST_ASSERT(sqlite3_step(statement) == SQLITE_ROW);
+  TEST_ASSERT_EQUAL_INT(2001 * COLUMN_DELTA_ENTRY_SIZE, sqlite3_column_int(statement, 0));
+  sqlite3_finalize(statement);
+
   TEST_ASSERT(iota_stor_state_delta_load(&connection, 43, &state_delta2) == RC_OK);
   TEST_ASSERT(state_delta2 == NULL);
 
@@ -438,6 +449,304 @@ void test_transactions_delete_two_transactions(void) {
   transaction_free(test_tx);
 }
 
+void test_write_batch(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  iota_transaction_t txs[3];
+  connection_config_t config = {.db_path = test_db_path,
+                                .durability = STORAGE_DURABILITY_NORMAL,
+                                .write_batch_size = 3,
+                                .write_batch_timeout_ms = 60000};
+  storage_connection_t writer;
+  hash243_set_t hashes = NULL;
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+  bool exist = false;
+
+  // Make them distinguishable
+  for (int i = 0; i < 3; i++) {
+    txs[i] = *test_tx;
+    flex_trits_set_at(txs[i].consensus.hash, FLEX_TRIT_SIZE_243, 4, i - 1);
+    flex_trits_set_at(txs[i].consensus.hash, FLEX_TRIT_SIZE_243, 5, 1);
+    hash243_set_add(&hashes, transaction_hash(&txs[i]));
+  }
+
+  TEST_ASSERT(connection_init(&writer, &config, STORAGE_CONNECTION_TANGLE) == RC_OK);
+
+  // Group-committed writes are visible to their connection only until committed
+  TEST_ASSERT(iota_stor_transaction_store(&writer, &txs[0]) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_store(&writer, &txs[0]) == RC_SQLITE3_FAILED_STEP);
+  TEST_ASSERT(iota_stor_transaction_exist(&writer, TRANSACTION_FIELD_HASH, transaction_hash(&txs[0]), &exist) ==
+              RC_OK);
+  TEST_ASSERT(exist == true);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&txs[0]), &exist) ==
+              RC_OK);
+  TEST_ASSERT(exist == false);
+
+  TEST_ASSERT(connection_flush(&writer) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&txs[0]), &exist) ==
+              RC_OK);
+  TEST_ASSERT(exist == true);
+
+  // The third row of the batch commits it, multi-row updates included
+  TEST_ASSERT(iota_stor_transaction_store(&writer, &txs[1]) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_store(&writer, &txs[2]) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&txs[2]), &exist) ==
+              RC_OK);
+  TEST_ASSERT(exist == false);
+  TEST_ASSERT(iota_stor_transactions_update_solid_state(&writer, hashes, true) == RC_OK);
+  for (int i = 0; i < 3; i++) {
+    hash_pack_reset(&pack);
+    TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(&txs[i]), &pack) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+    TEST_ASSERT(transaction_solid(&tx));
+  }
+
+  // A group commit rolled back by SQLite itself is over, the next writes start a new one
+  TEST_ASSERT(iota_stor_transaction_update_solid_state(&writer, transaction_hash(&txs[0]), false) == RC_OK);
+  TEST_ASSERT(connection_pending_batch(&writer) != 0);
+  TEST_ASSERT(sqlite3_exec(((sqlite3_tangle_connection_t *)writer.actual)->db, "ROLLBACK", NULL, NULL, NULL) ==
+              SQLITE_OK);
+  TEST_ASSERT(connection_pending_batch(&writer) == 0);
+  TEST_ASSERT(connection_flush(&writer) == RC_SQLITE3_FAILED_END);
+  TEST_ASSERT(connection_flush(&writer) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_update_solid_state(&writer, transaction_hash(&txs[0]), false) == RC_OK);
+  TEST_ASSERT(connection_flush(&writer) == RC_OK);
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_load_metadata(&connection, transaction_hash(&txs[0]), &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT(!transaction_solid(&tx));
+
+  // Destroying the connection commits its last writes
+  TEST_ASSERT(iota_stor_transactions_delete(&writer, hashes) == RC_OK);
+  TEST_ASSERT(connection_destroy(&writer) == RC_OK);
+  TEST_ASSERT(iota_stor_transaction_exist(&connection, TRANSACTION_FIELD_HASH, transaction_hash(&txs[1]), &exist) ==
+              RC_OK);
+  TEST_ASSERT(exist == false);
+
+  hash243_set_free(&hashes);
+  transaction_free(test_tx);
+}
+
+void test_pool(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  connection_config_t config = {.db_path = test_db_path,
+                                .durability = STORAGE_DURABILITY_NORMAL,
+                                .write_batch_size = 3,
+                                .write_batch_timeout_ms = 60000,
+                                .cache_size_kb = 1024,
+                                .mmap_size_mb = 16,
+                                .temp_store = STORAGE_TEMP_STORE_MEMORY,
+                                .wal_autocheckpoint = 100};
+  storage_pool_t *pool = NULL;
+  storage_pool_lease_t *batching = NULL, *committing = NULL;
+  storage_connection_t const *conn = NULL;
+  hash243_set_t hashes = NULL;
+  hash243_queue_t bundles = NULL;
+  iota_stor_pack_t pack;
+  size_t found = 0;
+  bool exist = false;
+
+  hash243_set_add(&hashes, transaction_hash(test_tx));
+  hash243_queue_push(&bundles, transaction_bundle(test_tx));
+  TEST_ASSERT(hash_pack_init(&pack, 4) == RC_OK);
+
+  TEST_ASSERT(storage_pool_open(&config, STORAGE_CONNECTION_TANGLE, 1) == RC_OK);
+  TEST_ASSERT_NOT_NULL((pool = storage_pool_find(test_db_path, STORAGE_CONNECTION_TANGLE)));
+  TEST_ASSERT_NULL(storage_pool_find(test_db_path, STORAGE_CONNECTION_SPENT_ADDRESSES));
+  TEST_ASSERT(storage_pool_lease_acquire(pool, true, &batching) == RC_OK);
+  TEST_ASSERT(storage_pool_lease_acquire(pool, false, &committing) == RC_OK);
+
+  // Readers don't write
+  TEST_ASSERT(iota_stor_transaction_store(&committing->reader, test_tx) != RC_OK);
+
+  // Group-committed writes are read back through the writer until committed
+  conn = storage_pool_lease_write(batching);
+  TEST_ASSERT(storage_pool_lease_write_done(batching, iota_stor_transaction_store(conn, test_tx)) == RC_OK);
+  TEST_ASSERT(batching->pending_batch != 0);
+  conn = storage_pool_lease_read(batching);
+  TEST_ASSERT(conn == &pool->writer);
+  TEST_ASSERT(iota_stor_transaction_exist(conn, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &exist) == RC_OK);
+  storage_pool_lease_read_done(batching, conn);
+  TEST_ASSERT(exist == true);
+  conn = storage_pool_lease_read(committing);
+  TEST_ASSERT(conn == &committing->reader);
+  TEST_ASSERT(iota_stor_transaction_exist(conn, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &exist) == RC_OK);
+  storage_pool_lease_read_done(committing, conn);
+  TEST_ASSERT(exist == false);
+
+  // Other writes are committed right away, with the pending ones
+  conn = storage_pool_lease_write(committing);
+  TEST_ASSERT(storage_pool_lease_write_done(committing, iota_stor_transactions_update_solid_state(conn, hashes,
+                                                                                                  true)) == RC_OK);
+  conn = storage_pool_lease_read(batching);
+  TEST_ASSERT(conn == &batching->reader);
+  TEST_ASSERT(batching->pending_batch == 0);
+  storage_pool_lease_read_done(batching, conn);
+
+  // Statements built at run time are reused
+  TEST_ASSERT(iota_stor_transaction_find(&committing->reader, bundles, NULL, NULL, NULL, &pack) == RC_OK);
+  found = pack.num_loaded;
+  TEST_ASSERT(found > 0);
+  hash_pack_reset(&pack);
+  TEST_ASSERT(iota_stor_transaction_find(&committing->reader, bundles, NULL, NULL, NULL, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(found, pack.num_loaded);
+
+  // Releasing a lease commits its pending writes
+  conn = storage_pool_lease_write(batching);
+  TEST_ASSERT(storage_pool_lease_write_done(batching, iota_stor_transactions_delete(conn, hashes)) == RC_OK);
+  TEST_ASSERT(storage_pool_lease_release(&batching) == RC_OK);
+  TEST_ASSERT_NULL(batching);
+  TEST_ASSERT(iota_stor_transaction_exist(&committing->reader, TRANSACTION_FIELD_HASH, transaction_hash(test_tx),
+                                          &exist) == RC_OK);
+  TEST_ASSERT(exist == false);
+
+  // Returned readers are kept open up to the limit
+  TEST_ASSERT(storage_pool_lease_release(&committing) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pool->idle_readers_count);
+  TEST_ASSERT(storage_pool_close(test_db_path) == RC_OK);
+  TEST_ASSERT_NULL(storage_pool_find(test_db_path, STORAGE_CONNECTION_TANGLE));
+
+  hash_pack_free(&pack);
+  hash243_queue_free(&bundles);
+  hash243_set_free(&hashes);
+  transaction_free(test_tx);
+}
+
+void test_packed_columns(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  sqlite3 *db = ((sqlite3_tangle_connection_t *)connection.actual)->db;
+  sqlite3_stmt *statement = NULL;
+  connection_config_t config = {.db_path = unversioned_db_path};
+  storage_connection_t unversioned;
+  hash243_set_t hashes = NULL;
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, pack);
+
+  TEST_ASSERT(iota_stor_transaction_store(&connection, test_tx) == RC_OK);
+
+  // Trits are stored packed 5 per byte whatever the flex encoding
+  TEST_ASSERT(sqlite3_prepare_v2(db, "SELECT length(hash),length(address) FROM iota_transaction WHERE hash=?", -1,
+                                 &statement, NULL) == SQLITE_OK);
+  TEST_ASSERT(column_compress_bind(statement, 1, transaction_hash(test_tx), NUM_TRITS_HASH) == RC_OK);
+  TEST_ASSERT(sqlite3_step(statement) == SQLITE_ROW);
+  TEST_ASSERT(sqlite3_column_int(statement, 0) > 0 && sqlite3_column_int(statement, 0) <= 49);
+  TEST_ASSERT(sqlite3_column_int(statement, 1) > 0 && sqlite3_column_int(statement, 1) <= 49);
+  sqlite3_finalize(statement);
+
+  TEST_ASSERT(iota_stor_transaction_load(&connection, TRANSACTION_FIELD_HASH, transaction_hash(test_tx), &pack) ==
+              RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_address(&tx), transaction_address(test_tx), FLEX_TRIT_SIZE_243);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_signature(&tx), transaction_signature(test_tx), FLEX_TRIT_SIZE_6561);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_tag(&tx), transaction_tag(test_tx), FLEX_TRIT_SIZE_81);
+
+  hash243_set_add(&hashes, transaction_hash(test_tx));
+  TEST_ASSERT(iota_stor_transactions_delete(&connection, hashes) == RC_OK);
+
+  // Databases written before the packed columns are refused
+  TEST_ASSERT(iota_utils_copy_file(unversioned_db_path, ciri_db_path) == RC_OK);
+  TEST_ASSERT(sqlite3_open(unversioned_db_path, &db) == SQLITE_OK);
+  TEST_ASSERT(sqlite3_exec(db, "PRAGMA user_version = 0", NULL, NULL, NULL) == SQLITE_OK);
+  sqlite3_close(db);
+  TEST_ASSERT(connection_init(&unversioned, &config, STORAGE_CONNECTION_TANGLE) == RC_SQLITE3_SCHEMA_VERSION_MISMATCH);
+  connection_destroy(&unversioned);
+  remove(unversioned_db_path);
+
+  hash243_set_free(&hashes);
+  transaction_free(test_tx);
+}
+
+void test_cursor(void) {
+  flex_trit_t tx_test_trits[FLEX_TRIT_SIZE_8019];
+  flex_trits_from_trytes(tx_test_trits, NUM_TRITS_SERIALIZED_TRANSACTION, TEST_TX_TRYTES,
+                         NUM_TRITS_SERIALIZED_TRANSACTION, NUM_TRYTES_SERIALIZED_TRANSACTION);
+  iota_transaction_t *test_tx = transaction_deserialize(tx_test_trits, true);
+  iota_transaction_t txs[3];
+  flex_trit_t hashes[2][FLEX_TRIT_SIZE_243];
+  flex_trit_t *models[2] = {hashes[0], hashes[1]};
+  iota_stor_pack_t pack = {.models = (void **)models, .capacity = 1, .num_loaded = 0, .insufficient_capacity = false};
+  hash243_queue_t addresses = NULL, approvees = NULL;
+  hash243_set_t found = NULL;
+  storage_cursor_t cursor;
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, tx_pack);
+
+  // Three transactions of an address of their own, the last two approving the first one
+  flex_trits_set_at(test_tx->essence.address, FLEX_TRIT_SIZE_243, 2, 1);
+  flex_trits_set_at(test_tx->essence.address, FLEX_TRIT_SIZE_243, 3, -1);
+  for (int i = 0; i < 3; i++) {
+    txs[i] = *test_tx;
+    flex_trits_set_at(txs[i].consensus.hash, FLEX_TRIT_SIZE_243, 4, i - 1);
+    flex_trits_set_at(txs[i].consensus.hash, FLEX_TRIT_SIZE_243, 5, 1);
+    transaction_set_current_index(&txs[i], i);
+    if (i != 0) {
+      transaction_set_trunk(&txs[i], transaction_hash(&txs[0]));
+    }
+    TEST_ASSERT(iota_stor_transaction_store(&connection, &txs[i]) == RC_OK);
+    hash243_set_add(&found, transaction_hash(&txs[i]));
+  }
+
+  // Batches of one, the cursor being done with the last transaction
+  storage_cursor_init_hashes_by_address(&cursor, STORAGE_CURSOR_MODEL_HASH, transaction_address(test_tx));
+  for (int i = 0; i < 3; i++) {
+    hash_pack_reset(&pack);
+    TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+    TEST_ASSERT_EQUAL_INT(i == 2, cursor.done);
+    TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[i]), hashes[0], FLEX_TRIT_SIZE_243);
+  }
+  hash_pack_reset(&pack);
+  TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(0, pack.num_loaded);
+
+  // Transactions are loaded with their hash
+  storage_cursor_init_hashes_of_approvers(&cursor, STORAGE_CURSOR_MODEL_ESSENCE_METADATA, transaction_hash(&txs[0]),
+                                          0);
+  for (int i = 1; i < 3; i++) {
+    TEST_ASSERT_FALSE(cursor.done);
+    hash_pack_reset(&tx_pack);
+    TEST_ASSERT(storage_cursor_next(&connection, &cursor, &tx_pack) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, tx_pack.num_loaded);
+    TEST_ASSERT_EQUAL_INT(i, transaction_current_index(&tx));
+    TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[i]), transaction_hash(&tx), FLEX_TRIT_SIZE_243);
+  }
+  TEST_ASSERT_TRUE(cursor.done);
+
+  storage_cursor_init_hashes_of_milestone_candidates(&cursor, STORAGE_CURSOR_MODEL_HASH, transaction_address(test_tx));
+  pack.capacity = 2;
+  hash_pack_reset(&pack);
+  TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+  TEST_ASSERT_TRUE(cursor.done);
+  TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[0]), hashes[0], FLEX_TRIT_SIZE_243);
+
+  // Lists are intersected and transactions matching several fields of a list are loaded once
+  hash243_queue_push(&addresses, transaction_address(test_tx));
+  hash243_queue_push(&approvees, transaction_hash(&txs[0]));
+  hash243_queue_push(&approvees, transaction_branch(test_tx));
+  storage_cursor_init_find(&cursor, STORAGE_CURSOR_MODEL_HASH, NULL, addresses, NULL, approvees);
+  pack.capacity = 1;
+  for (int i = 0; i < 3; i++) {
+    hash_pack_reset(&pack);
+    TEST_ASSERT(storage_cursor_next(&connection, &cursor, &pack) == RC_OK);
+    TEST_ASSERT_EQUAL_INT(1, pack.num_loaded);
+    TEST_ASSERT_EQUAL_INT(i == 2, cursor.done);
+    TEST_ASSERT_EQUAL_MEMORY(transaction_hash(&txs[i]), hashes[0], FLEX_TRIT_SIZE_243);
+  }
+
+  TEST_ASSERT(iota_stor_transactions_delete(&connection, found) == RC_OK);
+  hash243_queue_free(&addresses);
+  hash243_queue_free(&approvees);
+  hash243_set_free(&found);
+  transaction_free(test_tx);
+}
+
 int main(void) {
   UNITY_BEGIN();
   TEST_ASSERT(storage_init() == RC_OK);
@@ -459,6 +768,10 @@ int main(void) {
   RUN_TEST(test_transactions_update_solid_states_two_transaction);
   RUN_TEST(test_transactions_arrival_time);
   RUN_TEST(test_transactions_delete_two_transactions);
+  RUN_TEST(test_write_batch);
+  RUN_TEST(test_pool);
+  RUN_TEST(test_packed_columns);
+  RUN_TEST(test_cursor);
   RUN_TEST(test_destroy_connection);
 
   TEST_ASSERT(storage_destroy() == RC_OK);
@@ -5,7 +5,11 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <string.h>
+
 #include "common/storage/sql/sqlite3/wrappers.h"
+#include "common/trinary/trit_byte.h"
+#include "utils/macros.h"
 
 retcode_t prepare_statement(sqlite3* const db, sqlite3_stmt** const sqlite_statement, char const* const statement) {
   if (sqlite3_prepare_v2(db, statement, -1, sqlite_statement, NULL) != SQLITE_OK) {
@@ -48,29 +52,92 @@ retcode_t rollback_transaction(sqlite3* const db) {
   return RC_OK;
 }
 
-retcode_t column_compress_bind(sqlite3_stmt* const statement, size_t const index, flex_trit_t const* const flex_trits,
-                               size_t const num_bytes) {
-  ssize_t i = num_bytes - 1;
-  int rc = 0;
+retcode_t begin_savepoint(sqlite3* const db) {
+  if (sqlite3_exec(db, "SAVEPOINT write;", NULL, NULL, NULL) != SQLITE_OK) {
+    return RC_SQLITE3_FAILED_BEGIN;
+  }
+  return RC_OK;
+}
+
+retcode_t release_savepoint(sqlite3* const db) {
+  if (sqlite3_exec(db, "RELEASE SAVEPOINT write;", NULL, NULL, NULL) != SQLITE_OK) {
+    return RC_SQLITE3_FAILED_END;
+  }
+  return RC_OK;
+}
+
+retcode_t rollback_savepoint(sqlite3* const db) {
+  if (sqlite3_exec(db, "ROLLBACK TRANSACTION TO SAVEPOINT write; RELEASE SAVEPOINT write;", NULL, NULL, NULL) !=
+      SQLITE_OK) {
+    return RC_SQLITE3_FAILED_ROLLBACK;
+  }
+  return RC_OK;
+}
+
+size_t column_pack_trits(byte_t* const bytes, flex_trit_t const* const flex_trits, size_t const num_trits) {
+  ssize_t i = MIN_BYTES(num_trits) - 1;
 
-  for (; i >= 0 && flex_trits[i] == FLEX_TRIT_NULL_VALUE; --i)
+  if (num_trits > COLUMN_MAX_NUM_TRITS ||
+      flex_trits_to_bytes(bytes, num_trits, flex_trits, num_trits, num_trits) == 0) {
+    return 0;
+  }
+  for (; i >= 0 && bytes[i] == 0; --i)
     ;
-  if ((rc = sqlite3_bind_blob(statement, index, flex_trits, i + 1, NULL)) != SQLITE_OK) {
+  return i + 1;
+}
+
+retcode_t column_compress_bind(sqlite3_stmt* const statement, size_t const index, flex_trit_t const* const flex_trits,
+                               size_t const num_trits) {
+  byte_t bytes[MIN_BYTES(COLUMN_MAX_NUM_TRITS)];
+
+  if (num_trits > COLUMN_MAX_NUM_TRITS ||
+      sqlite3_bind_blob(statement, index, bytes, column_pack_trits(bytes, flex_trits, num_trits), SQLITE_TRANSIENT) !=
+          SQLITE_OK) {
     return RC_SQLITE3_FAILED_BINDING;
   }
   return RC_OK;
 }
 
 void column_decompress_load(sqlite3_stmt* const statement, size_t const index, flex_trit_t* const flex_trits,
-                            size_t const num_bytes) {
+                            size_t const num_trits) {
+  byte_t bytes[MIN_BYTES(COLUMN_MAX_NUM_TRITS)];
+  size_t const num_bytes = MIN_BYTES(MIN(num_trits, COLUMN_MAX_NUM_TRITS));
   char const* buffer = NULL;
   size_t column_size = 0;
 
   if ((buffer = sqlite3_column_blob(statement, index))) {
-    column_size = sqlite3_column_bytes(statement, index);
-    memcpy(flex_trits, buffer, column_size);
-    memset(flex_trits + column_size, FLEX_TRIT_NULL_VALUE, num_bytes - column_size);
-  } else {
-    memset(flex_trits, FLEX_TRIT_NULL_VALUE, num_bytes);
+    column_size = MIN((size_t)sqlite3_column_bytes(statement, index), num_bytes);
+    memcpy(bytes, buffer, column_size);
+  }
+  memset(bytes + column_size, 0, num_bytes - column_size);
+  flex_trits_from_bytes(flex_trits, num_trits, bytes, num_trits, num_trits);
+}
+
+size_t column_pack_delta(byte_t* const packed, byte_t const* const bytes, size_t const size) {
+  size_t const num_entries = size / COLUMN_DELTA_SERIALIZED_ENTRY_SIZE;
+  byte_t const* entry = bytes;
+  byte_t* packed_entry = packed;
+
+  for (size_t i = 0; i < num_entries; i++) {
+    memset(packed_entry, 0, MIN_BYTES(HASH_LENGTH_TRIT));
+    flex_trits_to_bytes(packed_entry, HASH_LENGTH_TRIT, entry, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+    memcpy(packed_entry + MIN_BYTES(HASH_LENGTH_TRIT), entry + FLEX_TRIT_SIZE_243, sizeof(int64_t));
+    entry += COLUMN_DELTA_SERIALIZED_ENTRY_SIZE;
+    packed_entry += COLUMN_DELTA_ENTRY_SIZE;
+  }
+  return num_entries * COLUMN_DELTA_ENTRY_SIZE;
+}
+
+size_t column_unpack_delta(byte_t* const bytes, byte_t const* const packed, size_t const size) {
+  size_t const num_entries = size / COLUMN_DELTA_ENTRY_SIZE;
+  byte_t const* packed_entry = packed;
+  byte_t* entry = bytes;
+
+  for (size_t i = 0; i < num_entries; i++) {
+    flex_trits_from_bytes(entry, HASH_LENGTH_TRIT, packed_entry, HASH_LENGTH_TRIT, HASH_LENGTH_TRIT);
+    memcpy(entry + FLEX_TRIT_SIZE_243, packed_entry + MIN_BYTES(HASH_LENGTH_TRIT), sizeof(int64_t));
+    packed_entry += COLUMN_DELTA_ENTRY_SIZE;
+    entry += COLUMN_DELTA_SERIALIZED_ENTRY_SIZE;
   }
+  return num_entries * COLUMN_DELTA_SERIALIZED_ENTRY_SIZE;
 }
@@ -10,8 +10,11 @@
 
 #include <sqlite3.h>
 
+#include "common/defs.h"
 #include "common/errors.h"
+#include "common/trinary/bytes.h"
 #include "common/trinary/flex_trit.h"
+#include "common/trinary/trit_byte.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,10 +27,36 @@ retcode_t begin_transaction(sqlite3* const db);
 retcode_t end_transaction(sqlite3* const db);
 retcode_t rollback_transaction(sqlite3* const db);
 
+// Savepoints nest in an open transaction or start one when there is none, committed when released
+retcode_t begin_savepoint(sqlite3* const db);
+retcode_t release_savepoint(sqlite3* const db);
+retcode_t rollback_savepoint(sqlite3* const db);
+
+/**
+ * Trit columns are stored packed 5 trits per byte, whatever the flex encoding of the build, with their trailing null
+ * bytes trimmed: a hash is a key of at most 49 bytes, a signature a blob of at most 1313 bytes
+ */
+#define COLUMN_MAX_NUM_TRITS 6561
+
+// Packs trits as stored in a column, returns the number of bytes once trimmed
+size_t column_pack_trits(byte_t* const bytes, flex_trit_t const* const flex_trits, size_t const num_trits);
+
 retcode_t column_compress_bind(sqlite3_stmt* const statement, size_t const index, flex_trit_t const* const flex_trits,
-                               size_t const num_bytes);
+                               size_t const num_trits);
 void column_decompress_load(sqlite3_stmt* const statement, size_t const index, flex_trit_t* const flex_trits,
-                            size_t const num_bytes);
+                            size_t const num_trits);
+
+/**
+ * A state delta column holds the entries serialized by state_delta_serialize with their addresses packed: an entry is
+ * a 49 bytes address followed by its 8 bytes value
+ */
+#define COLUMN_DELTA_ENTRY_SIZE (MIN_BYTES(HASH_LENGTH_TRIT) + sizeof(int64_t))
+#define COLUMN_DELTA_SERIALIZED_ENTRY_SIZE (FLEX_TRIT_SIZE_243 + sizeof(int64_t))
+
+// Packs the entries of a serialized state delta of `size` bytes, returns the number of bytes of the column
+size_t column_pack_delta(byte_t* const packed, byte_t const* const bytes, size_t const size);
+// Unpacks the entries of a state delta column of `size` bytes, returns the number of bytes of the serialized delta
+size_t column_unpack_delta(byte_t* const bytes, byte_t const* const packed, size_t const size);
 
 #ifdef __cplusplus
 }
@@ -6,6 +6,7 @@
  */
 
 #include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -163,6 +164,98 @@ char *iota_statement_transaction_find_build(size_t const bundles_count, size_t c
   return statement;
 }
 
+/*
+ * Cursor statements
+ */
+
+char *iota_statement_cursor_hashes_by_address = TRANSACTION_COL_ADDRESS "=?";
+
+// The unary + keeps the planner off the arrival index, the approvers are found through the trunk and branch ones
+char *iota_statement_cursor_hashes_of_approvers = "(" TRANSACTION_COL_BRANCH "=? OR " TRANSACTION_COL_TRUNK
+                                                  "=?) AND +" TRANSACTION_COL_ARRIVAL_TIME "<?";
+
+char *iota_statement_cursor_hashes_of_milestone_candidates =
+    TRANSACTION_COL_ADDRESS "=? AND " TRANSACTION_COL_CURRENT_INDEX "=0 AND " TRANSACTION_COL_HASH
+                            " NOT IN(SELECT " MILESTONE_COL_HASH " FROM " MILESTONE_TABLE_NAME ")";
+
+/*
+ * Cursor statement builders
+ */
+
+// Batches resume after the rowid of the last transaction of the previous one. Indices store the rowid after their
+// column, so that a batch of a cursor on a single key of an indexed column is a range search of the index, not a sort
+// of the results. With several keys, IN lists of more than one value or the trunk and branch OR of the approvers, each
+// key is still a range search but their matches after the resume point are sorted in a temporary B-tree before the
+// limit applies, so each batch costs a sort of the remaining matches.
+char *iota_statement_transaction_cursor_build(char const *const condition, bool const essence_and_metadata) {
+  char const *const format =
+      "SELECT rowid," TRANSACTION_COL_HASH "%s FROM " TRANSACTION_TABLE_NAME
+      " WHERE rowid>? AND (%s) ORDER BY rowid LIMIT ?";
+  char const *const columns = essence_and_metadata
+                                  ? "," TRANSACTION_COL_ADDRESS "," TRANSACTION_COL_VALUE
+                                    "," TRANSACTION_COL_OBSOLETE_TAG "," TRANSACTION_COL_TIMESTAMP
+                                    "," TRANSACTION_COL_CURRENT_INDEX "," TRANSACTION_COL_LAST_INDEX
+                                    "," TRANSACTION_COL_BUNDLE "," TRANSACTION_COL_SNAPSHOT_INDEX
+                                    "," TRANSACTION_COL_SOLID "," TRANSACTION_COL_VALIDITY
+                                    "," TRANSACTION_COL_ARRIVAL_TIME
+                                  : "";
+  size_t const statement_size = strlen(format) + strlen(columns) + strlen(condition) + 1;
+  char *statement = (char *)malloc(statement_size);
+
+  if (statement != NULL) {
+    snprintf(statement, statement_size, format, columns, condition);
+  }
+
+  return statement;
+}
+
+// Only the non empty lists are part of the condition, the indices of their columns can be searched
+char *iota_statement_cursor_find_build(size_t const bundles_count, size_t const addresses_count,
+                                       size_t const tags_count, size_t const approvees_count,
+                                       bool const essence_and_metadata) {
+  struct {
+    char const *format;
+    size_t count;
+  } const lists[] = {{TRANSACTION_COL_BUNDLE " IN(%s)", bundles_count},
+                     {TRANSACTION_COL_ADDRESS " IN(%s)", addresses_count},
+                     {TRANSACTION_COL_TAG " IN(%s)", tags_count},
+                     {"(" TRANSACTION_COL_BRANCH " IN(%s) OR " TRANSACTION_COL_TRUNK " IN(%s))", approvees_count}};
+  size_t condition_size = 2;
+  size_t offset = 0;
+  char *condition = NULL;
+  char *in_clause = NULL;
+  char *statement = NULL;
+
+  for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+    condition_size += strlen(lists[i].format) + 4 * lists[i].count + 5;
+  }
+  if ((condition = (char *)malloc(condition_size)) == NULL) {
+    return NULL;
+  }
+
+  // Every transaction matches empty lists
+  strcpy(condition, "1");
+  for (size_t i = 0; i < sizeof(lists) / sizeof(lists[0]); i++) {
+    if (lists[i].count == 0) {
+      continue;
+    }
+    if ((in_clause = iota_statement_in_clause_build(lists[i].count)) == NULL) {
+      free(condition);
+      return NULL;
+    }
+    if (offset != 0) {
+      offset += sprintf(condition + offset, " AND ");
+    }
+    offset += sprintf(condition + offset, lists[i].format, in_clause, in_clause);
+    free(in_clause);
+  }
+
+  statement = iota_statement_transaction_cursor_build(condition, essence_and_metadata);
+  free(condition);
+
+  return statement;
+}
+
 /*
  * Milestone statements
  */
@@ -9,6 +9,7 @@
 #define __COMMON_STORAGE_SQL_STATEMENTS_H__
 
 #include <inttypes.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -96,6 +97,23 @@ extern char* iota_statement_transaction_select_metadata;
 extern char* iota_statement_transaction_find_build(size_t const bundles_count, size_t const addresses_count,
                                                    size_t const tags_count, size_t const approvees_count);
 
+/*
+ * Cursor statements, conditions of iota_statement_transaction_cursor_build
+ */
+
+extern char* iota_statement_cursor_hashes_by_address;
+extern char* iota_statement_cursor_hashes_of_approvers;
+extern char* iota_statement_cursor_hashes_of_milestone_candidates;
+
+/*
+ * Cursor statement builders
+ */
+
+extern char* iota_statement_transaction_cursor_build(char const* const condition, bool const essence_and_metadata);
+extern char* iota_statement_cursor_find_build(size_t const bundles_count, size_t const addresses_count,
+                                              size_t const tags_count, size_t const approvees_count,
+                                              bool const essence_and_metadata);
+
 /*
  * Milestone statements
  */
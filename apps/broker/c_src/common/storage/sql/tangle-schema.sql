@@ -1,3 +1,5 @@
+PRAGMA user_version = 1;
+
 CREATE TABLE IF NOT EXISTS iota_transaction (
   signature_or_message BLOB NOT NULL,
   address BLOB NOT NULL,
@@ -26,7 +28,6 @@ CREATE INDEX IF NOT EXISTS bundle_index ON iota_transaction(bundle);
 CREATE INDEX IF NOT EXISTS trunk_index ON iota_transaction(trunk);
 CREATE INDEX IF NOT EXISTS branch_index ON iota_transaction(branch);
 CREATE INDEX IF NOT EXISTS tag_index ON iota_transaction(tag);
-CREATE INDEX IF NOT EXISTS transaction_hash_index ON iota_transaction(hash);
 CREATE INDEX IF NOT EXISTS arrival_time_index ON iota_transaction(arrival_timestamp);
 
 CREATE TABLE IF NOT EXISTS iota_milestone (
@@ -34,5 +35,3 @@ CREATE TABLE IF NOT EXISTS iota_milestone (
   hash BLOB NOT NULL UNIQUE,
   delta BLOB
 );
-
-CREATE INDEX IF NOT EXISTS milestone_hash_index ON iota_milestone(hash);
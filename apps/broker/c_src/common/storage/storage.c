@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "common/storage/backend.h"
+#include "common/storage/connection.h"
+#include "common/storage/storage.h"
+
+static storage_backend_t const* const backends[STORAGE_BACKEND_COUNT] = {
+    [STORAGE_BACKEND_SQLITE3] = &sqlite3_storage_backend,
+    [STORAGE_BACKEND_KV] = &kv_storage_backend,
+};
+
+retcode_t storage_init() {
+  retcode_t ret = RC_OK;
+
+  for (size_t i = 0; i < STORAGE_BACKEND_COUNT; i++) {
+    if ((ret = backends[i]->init()) != RC_OK) {
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t storage_destroy() {
+  retcode_t ret = RC_OK;
+
+  for (size_t i = STORAGE_BACKEND_COUNT; i > 0; i--) {
+    ret |= backends[i - 1]->destroy();
+  }
+
+  return ret;
+}
+
+/*
+ * Connection operations
+ */
+
+retcode_t connection_init(storage_connection_t* const connection, connection_config_t const* const config,
+                          storage_connection_type_t const type) {
+  if (connection == NULL || config == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (config->backend >= STORAGE_BACKEND_COUNT) {
+    return RC_INVALID_PARAM;
+  }
+
+  connection->actual = NULL;
+  connection->backend = backends[config->backend];
+  return connection->backend->connection_init(connection, config, type);
+}
+
+retcode_t connection_destroy(storage_connection_t* const connection) {
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return connection->backend->connection_destroy(connection);
+}
+
+retcode_t connection_flush(storage_connection_t const* const connection) {
+  if (connection == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  return connection->backend->connection_flush(connection);
+}
+
+uint64_t connection_pending_batch(storage_connection_t const* const connection) {
+  if (connection == NULL) {
+    return 0;
+  }
+
+  return connection->backend->connection_pending_batch(connection);
+}
+
+/*
+ * Transaction operations
+ */
+
+retcode_t iota_stor_transaction_count(storage_connection_t const* const connection, size_t* const count) {
+  return connection->backend->transaction_count(connection, count);
+}
+
+retcode_t iota_stor_transaction_store(storage_connection_t const* const connection,
+                                      iota_transaction_t const* const data_in) {
+  return connection->backend->transaction_store(connection, data_in);
+}
+
+retcode_t iota_stor_transaction_load(storage_connection_t const* const connection, transaction_field_t const field,
+                                     flex_trit_t const* const key, iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_load(connection, field, key, pack);
+}
+
+retcode_t iota_stor_transaction_load_essence_and_metadata(storage_connection_t const* const connection,
+                                                          flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_load_essence_and_metadata(connection, hash, pack);
+}
+
+retcode_t iota_stor_transaction_load_essence_attachment_and_metadata(storage_connection_t const* const connection,
+                                                                     flex_trit_t const* const hash,
+                                                                     iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_load_essence_attachment_and_metadata(connection, hash, pack);
+}
+
+retcode_t iota_stor_transaction_load_essence_and_consensus(storage_connection_t const* const connection,
+                                                           flex_trit_t const* const hash,
+                                                           iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_load_essence_and_consensus(connection, hash, pack);
+}
+
+retcode_t iota_stor_transaction_load_metadata(storage_connection_t const* const connection,
+                                              flex_trit_t const* const hash, iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_load_metadata(connection, hash, pack);
+}
+
+retcode_t iota_stor_transaction_exist(storage_connection_t const* const connection, transaction_field_t const field,
+                                      flex_trit_t const* const key, bool* const exist) {
+  return connection->backend->transaction_exist(connection, field, key, exist);
+}
+
+retcode_t iota_stor_transaction_update_snapshot_index(storage_connection_t const* const connection,
+                                                      flex_trit_t const* const hash, uint64_t const snapshot_index) {
+  return connection->backend->transaction_update_snapshot_index(connection, hash, snapshot_index);
+}
+
+retcode_t iota_stor_transactions_update_snapshot_index(storage_connection_t const* const connection,
+                                                       hash243_set_t const hashes, uint64_t const snapshot_index) {
+  return connection->backend->transactions_update_snapshot_index(connection, hashes, snapshot_index);
+}
+
+retcode_t iota_stor_transaction_update_solid_state(storage_connection_t const* const connection,
+                                                   flex_trit_t const* const hash, bool const is_solid) {
+  return connection->backend->transaction_update_solid_state(connection, hash, is_solid);
+}
+
+retcode_t iota_stor_transactions_update_solid_state(storage_connection_t const* const connection,
+                                                    hash243_set_t const hashes, bool const is_solid) {
+  return connection->backend->transactions_update_solid_state(connection, hashes, is_solid);
+}
+
+retcode_t iota_stor_transaction_load_hashes(storage_connection_t const* const connection,
+                                            transaction_field_t const field, flex_trit_t const* const key,
+                                            iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_load_hashes(connection, field, key, pack);
+}
+
+retcode_t iota_stor_transaction_load_hashes_of_approvers(storage_connection_t const* const connection,
+                                                         flex_trit_t const* const approvee_hash,
+                                                         iota_stor_pack_t* const pack, int64_t before_timestamp) {
+  return connection->backend->transaction_load_hashes_of_approvers(connection, approvee_hash, pack, before_timestamp);
+}
+
+retcode_t iota_stor_transaction_load_hashes_of_milestone_candidates(storage_connection_t const* const connection,
+                                                                    iota_stor_pack_t* const pack,
+                                                                    flex_trit_t const* const coordinator) {
+  return connection->backend->transaction_load_hashes_of_milestone_candidates(connection, pack, coordinator);
+}
+
+retcode_t iota_stor_transaction_approvers_count(storage_connection_t const* const connection,
+                                                flex_trit_t const* const hash, size_t* const count) {
+  return connection->backend->transaction_approvers_count(connection, hash, count);
+}
+
+retcode_t iota_stor_transaction_find(storage_connection_t const* const connection, hash243_queue_t const bundles,
+                                     hash243_queue_t const addresses, hash81_queue_t const tags,
+                                     hash243_queue_t const approvees, iota_stor_pack_t* const pack) {
+  return connection->backend->transaction_find(connection, bundles, addresses, tags, approvees, pack);
+}
+
+retcode_t storage_cursor_next(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                              iota_stor_pack_t* const batch) {
+  if (cursor->done) {
+    return RC_OK;
+  }
+  return connection->backend->cursor_next(connection, cursor, batch);
+}
+
+retcode_t iota_stor_transaction_metadata_clear(storage_connection_t const* const connection) {
+  return connection->backend->transaction_metadata_clear(connection);
+}
+
+retcode_t iota_stor_transactions_delete(storage_connection_t const* const connection, hash243_set_t const hashes) {
+  return connection->backend->transactions_delete(connection, hashes);
+}
+
+/*
+ * Bundle operations
+ */
+
+retcode_t iota_stor_bundle_update_validity(storage_connection_t const* const connection,
+                                           bundle_transactions_t const* const bundle, bundle_status_t const status) {
+  return connection->backend->bundle_update_validity(connection, bundle, status);
+}
+
+/*
+ * Milestone operations
+ */
+
+retcode_t iota_stor_milestone_clear(storage_connection_t const* const connection) {
+  return connection->backend->milestone_clear(connection);
+}
+
+retcode_t iota_stor_milestone_store(storage_connection_t const* const connection,
+                                    iota_milestone_t const* const data_in) {
+  return connection->backend->milestone_store(connection, data_in);
+}
+
+retcode_t iota_stor_milestone_load(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                   iota_stor_pack_t* const pack) {
+  return connection->backend->milestone_load(connection, hash, pack);
+}
+
+retcode_t iota_stor_milestone_load_last(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+  return connection->backend->milestone_load_last(connection, pack);
+}
+
+retcode_t iota_stor_milestone_load_first(storage_connection_t const* const connection, iota_stor_pack_t* const pack) {
+  return connection->backend->milestone_load_first(connection, pack);
+}
+
+retcode_t iota_stor_milestone_load_by_index(storage_connection_t const* const connection, uint64_t const index,
+                                            iota_stor_pack_t* const pack) {
+  return connection->backend->milestone_load_by_index(connection, index, pack);
+}
+
+retcode_t iota_stor_milestone_load_next(storage_connection_t const* const connection, uint64_t const index,
+                                        iota_stor_pack_t* const pack) {
+  return connection->backend->milestone_load_next(connection, index, pack);
+}
+
+retcode_t iota_stor_milestone_exist(storage_connection_t const* const connection, flex_trit_t const* const hash,
+                                    bool* const exist) {
+  return connection->backend->milestone_exist(connection, hash, exist);
+}
+
+retcode_t iota_stor_milestone_delete(storage_connection_t const* const connection, flex_trit_t const* const hash) {
+  return connection->backend->milestone_delete(connection, hash);
+}
+
+/*
+ * State delta operations
+ */
+
+retcode_t iota_stor_state_delta_store(storage_connection_t const* const connection, uint64_t const index,
+                                      state_delta_t const* const delta) {
+  return connection->backend->state_delta_store(connection, index, delta);
+}
+
+retcode_t iota_stor_state_delta_load(storage_connection_t const* const connection, uint64_t const index,
+                                     state_delta_t* const delta) {
+  return connection->backend->state_delta_load(connection, index, delta);
+}
+
+/*
+ * Spent address operations
+ */
+
+retcode_t iota_stor_spent_address_store(storage_connection_t const* const connection,
+                                        flex_trit_t const* const address) {
+  return connection->backend->spent_address_store(connection, address);
+}
+
+retcode_t iota_stor_spent_addresses_store(storage_connection_t const* const connection, hash243_set_t const addresses) {
+  return connection->backend->spent_addresses_store(connection, addresses);
+}
+
+retcode_t iota_stor_spent_address_exist(storage_connection_t const* const connection, flex_trit_t const* const address,
+                                        bool* const exist) {
+  return connection->backend->spent_address_exist(connection, address, exist);
+}
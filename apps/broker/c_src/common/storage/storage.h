@@ -14,6 +14,7 @@
 #include "common/errors.h"
 #include "common/model/bundle.h"
 #include "common/storage/connection.h"
+#include "common/storage/cursor.h"
 #include "common/storage/defs.h"
 #include "common/storage/pack.h"
 #include "common/trinary/flex_trit.h"
@@ -115,6 +116,20 @@ extern retcode_t iota_stor_transaction_find(storage_connection_t const* const co
                                             hash243_queue_t const addresses, hash81_queue_t const tags,
                                             hash243_queue_t const approvees, iota_stor_pack_t* const pack);
 
+/**
+ * Loads the next batch of a cursor into the free models of a batch pack, as many as it can hold. Unlike the pack
+ * loads above, a walk never queries a transaction twice whatever the size of the batches: the cursor is done once
+ * every transaction has been loaded, at the latest with a batch that is not filled.
+ *
+ * @param connection A connection to the database
+ * @param cursor The cursor
+ * @param batch Preallocated models of the cursor model, from num_loaded up to capacity
+ *
+ * @return a status code
+ */
+extern retcode_t storage_cursor_next(storage_connection_t const* const connection, storage_cursor_t* const cursor,
+                                     iota_stor_pack_t* const batch);
+
 extern retcode_t iota_stor_transaction_metadata_clear(storage_connection_t const* const connection);
 
 extern retcode_t iota_stor_transactions_delete(storage_connection_t const* const connection,
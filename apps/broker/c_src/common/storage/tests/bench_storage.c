@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * Compares the storage backends on the operations of the consensus hot paths: group-committed stores, lookups of
+ * transactions and of their metadata, index scans by address, approvee and bundle, cursor walks in batches smaller than
+ * their result sets, and batched metadata updates.
+ *
+ * Every backend runs the same workload through the iota_stor_* interface on a fresh database, the sqlite3 one being a
+ * copy of the schema database and the LMDB one being created on open.
+ *
+ * Usage: bench_storage [schema database] [transactions]
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common/model/transaction.h"
+#include "common/storage/connection.h"
+#include "common/storage/storage.h"
+#include "common/storage/tests/helpers/helpers.h"
+#include "utils/containers/hash/hash243_queue.h"
+#include "utils/containers/hash/hash243_set.h"
+#include "utils/files.h"
+#include "utils/time.h"
+
+#define DEFAULT_SCHEMA_DB_PATH "common/storage/sql/sqlite3/tests/ciri.db"
+#define BENCH_DB_PATH "common/storage/tests/bench.db"
+#define DEFAULT_TRANSACTIONS 100000
+#define BATCH_SIZE 500
+#define BATCH_TIMEOUT_MS 100
+#define HASHES_CAPACITY 16
+#define CURSOR_BATCH_SIZE 3
+#define UPDATE_SET_SIZE 100
+
+static char const *const BACKEND_NAMES[STORAGE_BACKEND_COUNT] = {[STORAGE_BACKEND_SQLITE3] = "sqlite3",
+                                                                 [STORAGE_BACKEND_KV] = "kv"};
+
+static void report(storage_backend_type_t const backend, char const *const operation, size_t const operations,
+                   uint64_t const elapsed) {
+  printf("%-8s %-22s %10.0f ops/s  %8.2f us/op\n", BACKEND_NAMES[backend], operation, operations / (elapsed / 1e6),
+         (double)elapsed / operations);
+}
+
+static retcode_t bench_store(storage_connection_t *const connection, storage_backend_type_t const backend,
+                             size_t const transactions) {
+  retcode_t ret = RC_OK;
+  iota_transaction_t *tx = transaction_new();
+  flex_trit_t field[FLEX_TRIT_SIZE_6561];
+  uint64_t start = 0;
+
+  if (tx == NULL) {
+    return RC_OOM;
+  }
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i++) {
+    fill_field(field, NUM_TRITS_HASH, i, 0);
+    transaction_set_hash(tx, field);
+    fill_field(field, NUM_TRITS_ADDRESS, i / 8, 1);
+    transaction_set_address(tx, field);
+    fill_field(field, NUM_TRITS_BUNDLE, i / 4, 2);
+    transaction_set_bundle(tx, field);
+    fill_field(field, NUM_TRITS_TRUNK, i / 2, 0);
+    transaction_set_trunk(tx, field);
+    fill_field(field, NUM_TRITS_BRANCH, i / 3, 0);
+    transaction_set_branch(tx, field);
+    memset(field, FLEX_TRIT_NULL_VALUE, FLEX_TRIT_SIZE_6561);
+    if (i % 2 == 0) {
+      fill_field(field, NUM_TRITS_SIGNATURE, i, 3);
+    }
+    transaction_set_signature(tx, field);
+    transaction_set_current_index(tx, i % 4);
+    transaction_set_last_index(tx, 3);
+    if ((ret = iota_stor_transaction_store(connection, tx)) != RC_OK) {
+      fprintf(stderr, "Storing transaction %zu failed\n", i);
+      goto done;
+    }
+  }
+  if ((ret = connection_flush(connection)) != RC_OK) {
+    goto done;
+  }
+  report(backend, "store", transactions, monotonic_timestamp_us() - start);
+
+done:
+  transaction_free(tx);
+  return ret;
+}
+
+static retcode_t bench_reads(storage_connection_t *const connection, storage_backend_type_t const backend,
+                             size_t const transactions) {
+  retcode_t ret = RC_OK;
+  flex_trit_t field[FLEX_TRIT_SIZE_243];
+  flex_trit_t hashes[HASHES_CAPACITY][FLEX_TRIT_SIZE_243];
+  flex_trit_t *hash_models[HASHES_CAPACITY];
+  iota_stor_pack_t hash_pack = {
+      .models = (void **)hash_models, .capacity = HASHES_CAPACITY, .num_loaded = 0, .insufficient_capacity = false};
+  iota_stor_pack_t cursor_pack = {
+      .models = (void **)hash_models, .capacity = CURSOR_BATCH_SIZE, .num_loaded = 0, .insufficient_capacity = false};
+  storage_cursor_t cursor;
+  hash243_queue_t bundles = NULL;
+  bool exist = false;
+  uint64_t start = 0;
+  DECLARE_PACK_SINGLE_TX(tx, tx_ptr, tx_pack);
+
+  for (size_t i = 0; i < HASHES_CAPACITY; i++) {
+    hash_models[i] = hashes[i];
+  }
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i++) {
+    fill_field(field, NUM_TRITS_HASH, i, 0);
+    if ((ret = iota_stor_transaction_exist(connection, TRANSACTION_FIELD_HASH, field, &exist)) != RC_OK || !exist) {
+      return ret == RC_OK ? RC_ERROR : ret;
+    }
+  }
+  report(backend, "exist", transactions, monotonic_timestamp_us() - start);
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i++) {
+    fill_field(field, NUM_TRITS_HASH, i, 0);
+    hash_pack_reset(&tx_pack);
+    if ((ret = iota_stor_transaction_load_essence_and_metadata(connection, field, &tx_pack)) != RC_OK) {
+      return ret;
+    }
+  }
+  report(backend, "load essence+metadata", transactions, monotonic_timestamp_us() - start);
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i += 8) {
+    fill_field(field, NUM_TRITS_ADDRESS, i / 8, 1);
+    hash_pack_reset(&hash_pack);
+    if ((ret = iota_stor_transaction_load_hashes(connection, TRANSACTION_FIELD_ADDRESS, field, &hash_pack)) !=
+        RC_OK) {
+      return ret;
+    }
+  }
+  report(backend, "hashes by address", transactions / 8, monotonic_timestamp_us() - start);
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i += 8) {
+    fill_field(field, NUM_TRITS_ADDRESS, i / 8, 1);
+    storage_cursor_init_hashes_by_address(&cursor, STORAGE_CURSOR_MODEL_HASH, field);
+    while (!cursor.done) {
+      hash_pack_reset(&cursor_pack);
+      if ((ret = storage_cursor_next(connection, &cursor, &cursor_pack)) != RC_OK) {
+        return ret;
+      }
+    }
+  }
+  report(backend, "cursor by address", transactions / 8, monotonic_timestamp_us() - start);
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i++) {
+    fill_field(field, NUM_TRITS_HASH, i, 0);
+    hash_pack_reset(&hash_pack);
+    if ((ret = iota_stor_transaction_load_hashes_of_approvers(connection, field, &hash_pack, 0)) != RC_OK) {
+      return ret;
+    }
+  }
+  report(backend, "approvers", transactions, monotonic_timestamp_us() - start);
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i += 4) {
+    fill_field(field, NUM_TRITS_BUNDLE, i / 4, 2);
+    hash243_queue_push(&bundles, field);
+    hash_pack_reset(&hash_pack);
+    ret = iota_stor_transaction_find(connection, bundles, NULL, NULL, NULL, &hash_pack);
+    hash243_queue_free(&bundles);
+    if (ret != RC_OK) {
+      return ret;
+    }
+  }
+  report(backend, "find by bundle", transactions / 4, monotonic_timestamp_us() - start);
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions; i += 4) {
+    fill_field(field, NUM_TRITS_BUNDLE, i / 4, 2);
+    hash243_queue_push(&bundles, field);
+    storage_cursor_init_find(&cursor, STORAGE_CURSOR_MODEL_HASH, bundles, NULL, NULL, NULL);
+    while (ret == RC_OK && !cursor.done) {
+      hash_pack_reset(&cursor_pack);
+      ret = storage_cursor_next(connection, &cursor, &cursor_pack);
+    }
+    hash243_queue_free(&bundles);
+    if (ret != RC_OK) {
+      return ret;
+    }
+  }
+  report(backend, "cursor find by bundle", transactions / 4, monotonic_timestamp_us() - start);
+
+  return RC_OK;
+}
+
+static retcode_t bench_updates(storage_connection_t *const connection, storage_backend_type_t const backend,
+                               size_t const transactions) {
+  retcode_t ret = RC_OK;
+  flex_trit_t field[FLEX_TRIT_SIZE_243];
+  hash243_set_t hashes = NULL;
+  uint64_t start = 0;
+
+  start = monotonic_timestamp_us();
+  for (size_t i = 0; i < transactions && ret == RC_OK; i++) {
+    fill_field(field, NUM_TRITS_HASH, i, 0);
+    hash243_set_add(&hashes, field);
+    if (hash243_set_size(hashes) == UPDATE_SET_SIZE || i + 1 == transactions) {
+      ret = iota_stor_transactions_update_solid_state(connection, hashes, true);
+      hash243_set_free(&hashes);
+    }
+  }
+  if (ret != RC_OK || (ret = connection_flush(connection)) != RC_OK) {
+    return ret;
+  }
+  report(backend, "update solid state", transactions, monotonic_timestamp_us() - start);
+
+  return RC_OK;
+}
+
+// Removes the files of both backends, LMDB keeps its lock table next to the database
+static void remove_bench_db(void) {
+  remove(BENCH_DB_PATH);
+  remove(BENCH_DB_PATH "-wal");
+  remove(BENCH_DB_PATH "-shm");
+  remove(BENCH_DB_PATH "-lock");
+}
+
+static int run(char const *const schema_db_path, storage_backend_type_t const backend, size_t const transactions) {
+  connection_config_t config = {.db_path = BENCH_DB_PATH,
+                                .backend = backend,
+                                .durability = STORAGE_DURABILITY_NORMAL,
+                                .write_batch_size = BATCH_SIZE,
+                                .write_batch_timeout_ms = BATCH_TIMEOUT_MS};
+  storage_connection_t connection;
+  int ret = EXIT_FAILURE;
+
+  remove_bench_db();
+  if ((backend == STORAGE_BACKEND_SQLITE3 && iota_utils_copy_file(BENCH_DB_PATH, schema_db_path) != RC_OK) ||
+      connection_init(&connection, &config, STORAGE_CONNECTION_TANGLE) != RC_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (bench_store(&connection, backend, transactions) == RC_OK &&
+      bench_reads(&connection, backend, transactions) == RC_OK &&
+      bench_updates(&connection, backend, transactions) == RC_OK) {
+    ret = EXIT_SUCCESS;
+  }
+
+  connection_destroy(&connection);
+  remove_bench_db();
+
+  return ret;
+}
+
+int main(int argc, char **argv) {
+  char const *const schema_db_path = argc > 1 ? argv[1] : DEFAULT_SCHEMA_DB_PATH;
+  size_t const transactions = argc > 2 ? strtoul(argv[2], NULL, 10) : DEFAULT_TRANSACTIONS;
+  int ret = EXIT_SUCCESS;
+
+  if (transactions == 0 || storage_init() != RC_OK) {
+    return EXIT_FAILURE;
+  }
+  printf("storage: %zu transactions, batches of %d or %d ms\n", transactions, BATCH_SIZE, BATCH_TIMEOUT_MS);
+
+  for (storage_backend_type_t backend = STORAGE_BACKEND_SQLITE3; backend < STORAGE_BACKEND_COUNT && ret == EXIT_SUCCESS;
+       backend++) {
+    ret = run(schema_db_path, backend, transactions);
+  }
+
+  storage_destroy();
+
+  return ret;
+}
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include "common/storage/tests/helpers/helpers.h"
+
+void fill_field(flex_trit_t *const field, size_t const num_trits, uint64_t const number, uint8_t const salt) {
+  uint64_t state = (number + 1) * 0x9E3779B97F4A7C15ULL ^ salt;
+
+  for (size_t i = 0; i < num_trits; i++) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    flex_trits_set_at(field, num_trits, i, (trit_t)(((state * 0x2545F4914F6CDD1DULL) >> 32) % 3) - 1);
+  }
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __COMMON_STORAGE_TESTS_HELPERS_HELPERS_H__
+#define __COMMON_STORAGE_TESTS_HELPERS_HELPERS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/trinary/flex_trit.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Derives distinct trits from a transaction number and a field number, so that benchmarks store transactions with
+ * distinct hashes, addresses, bundles and approvees
+ *
+ * @param field The field
+ * @param num_trits The number of trits of the field
+ * @param number The transaction number
+ * @param salt The field number
+ */
+void fill_field(flex_trit_t *const field, size_t const num_trits, uint64_t const number, uint8_t const salt);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __COMMON_STORAGE_TESTS_HELPERS_HELPERS_H__
@@ -20,4 +20,13 @@ typedef struct {
   ptrit_s high;
 } ptrit_t;
 
+// Number of 64-lane words of a wide ptrit, 512 lanes fill one AVX-512 register
+#define PTRIT_WIDE_WORDS 8
+#define PTRIT_WIDE_LANES (PTRIT_WIDE_WORDS * 64)
+
+typedef struct {
+  ptrit_s low[PTRIT_WIDE_WORDS];
+  ptrit_s high[PTRIT_WIDE_WORDS];
+} ptrit_wide_t;
+
 #endif
@@ -45,3 +45,19 @@ void ptrit_increment(ptrit_t *const trits, size_t const offset, size_t const end
     carry = copy.high & (~copy.low);
   }
 }
+
+void ptrit_wide_increment(ptrit_wide_t *const trits, size_t const offset, size_t const end) {
+  size_t i, w;
+  ptrit_s carry, copy_low, copy_high;
+
+  for (w = 0; w < PTRIT_WIDE_WORDS; w++) {
+    carry = 1;
+    for (i = offset; i < end && carry != 0; i++) {
+      copy_low = trits[i].low[w];
+      copy_high = trits[i].high[w];
+      trits[i].low[w] = copy_high ^ copy_low;
+      trits[i].high[w] = copy_low;
+      carry = copy_high & (~copy_low);
+    }
+  }
+}
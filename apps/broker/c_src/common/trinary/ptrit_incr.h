@@ -16,6 +16,7 @@ extern "C" {
 
 void ptrit_offset(ptrit_t *const trits, size_t const length);
 void ptrit_increment(ptrit_t *const trits, size_t const offset, size_t const end);
+void ptrit_wide_increment(ptrit_wide_t *const trits, size_t const offset, size_t const end);
 
 #endif
 #ifdef __cplusplus
@@ -5,9 +5,18 @@
  * Refer to the LICENSE file for licensing information
  */
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <unity/unity.h>
 
+#include "common/trinary/trit_byte.h"
 #include "common/trinary/trit_ptrit.h"
+#include "common/trinary/trit_tryte.h"
+
+#define TRYTES_LENGTH 27
+#define BYTES_NUM_TRITS 23
+#define BYTES_LENGTH 5
 
 #define TRITS_IN -1, 0, 1
 #define ptrit_EXP \
@@ -31,10 +40,97 @@ void test_trit_to_ptrit(void) {
   TEST_ASSERT_EQUAL_MEMORY(exp, ptrit, sizeof(exp));
 }
 
+static tryte_t trytes[PTRIT_WIDE_LANES][TRYTES_LENGTH];
+static tryte_t trytes_o[PTRIT_WIDE_LANES][TRYTES_LENGTH];
+static tryte_t *trytes_p[PTRIT_WIDE_LANES];
+static tryte_t *trytes_o_p[PTRIT_WIDE_LANES];
+static ptrit_wide_t ptrit_wide[TRYTES_LENGTH * 3];
+static ptrit_wide_t ptrit_wide_exp[TRYTES_LENGTH * 3];
+
+static void random_trytes(size_t const count) {
+  for (size_t i = 0; i < count; i++) {
+    for (size_t j = 0; j < TRYTES_LENGTH; j++) {
+      trytes[i][j] = TRYTE_ALPHABET[rand() % TRYTE_SPACE_SIZE];
+    }
+    trytes_p[i] = trytes[i];
+    trytes_o_p[i] = trytes_o[i];
+  }
+}
+
+void test_trytes_to_ptrits(void) {
+  size_t const counts[] = {1, 13, 64};
+  trit_t trits[TRYTES_LENGTH * 3];
+  ptrit_t ptrit[TRYTES_LENGTH * 3];
+  ptrit_t ptrit_exp[TRYTES_LENGTH * 3];
+
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    random_trytes(counts[c]);
+    memset(ptrit_exp, 0, sizeof(ptrit_exp));
+    for (size_t i = 0; i < counts[c]; i++) {
+      trytes_to_trits(trytes[i], trits, TRYTES_LENGTH);
+      trits_to_ptrits(trits, ptrit_exp, i, TRYTES_LENGTH * 3);
+    }
+    memset(ptrit, 0xFF, sizeof(ptrit));
+    trytes_to_ptrits((tryte_t const *const *)trytes_p, counts[c], ptrit, TRYTES_LENGTH);
+    TEST_ASSERT_EQUAL_MEMORY(ptrit_exp, ptrit, sizeof(ptrit));
+
+    ptrits_to_trytes(ptrit, trytes_o_p, counts[c], TRYTES_LENGTH);
+    TEST_ASSERT_EQUAL_MEMORY(trytes, trytes_o, counts[c] * TRYTES_LENGTH);
+  }
+}
+
+void test_trytes_to_ptrits_wide(void) {
+  size_t const counts[] = {1, 100, PTRIT_WIDE_LANES};
+  trit_t trits[TRYTES_LENGTH * 3];
+
+  for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+    random_trytes(counts[c]);
+    memset(ptrit_wide_exp, 0, sizeof(ptrit_wide_exp));
+    for (size_t i = 0; i < counts[c]; i++) {
+      trytes_to_trits(trytes[i], trits, TRYTES_LENGTH);
+      trits_to_ptrits_wide(trits, ptrit_wide_exp, i, TRYTES_LENGTH * 3);
+    }
+    memset(ptrit_wide, 0xFF, sizeof(ptrit_wide));
+    trytes_to_ptrits_wide((tryte_t const *const *)trytes_p, counts[c], ptrit_wide, TRYTES_LENGTH);
+    TEST_ASSERT_EQUAL_MEMORY(ptrit_wide_exp, ptrit_wide, sizeof(ptrit_wide));
+
+    ptrits_wide_to_trytes(ptrit_wide, trytes_o_p, counts[c], TRYTES_LENGTH);
+    TEST_ASSERT_EQUAL_MEMORY(trytes, trytes_o, counts[c] * TRYTES_LENGTH);
+  }
+}
+
+void test_bytes_to_ptrits(void) {
+  byte_t bytes[64][BYTES_LENGTH];
+  byte_t const *bytes_p[64];
+  trit_t trits[BYTES_NUM_TRITS];
+  ptrit_t ptrit[BYTES_NUM_TRITS];
+  ptrit_t ptrit_exp[BYTES_NUM_TRITS];
+
+  memset(ptrit_exp, 0, sizeof(ptrit_exp));
+  memset(ptrit_wide_exp, 0, sizeof(ptrit_wide_exp));
+  for (size_t i = 0; i < 64; i++) {
+    for (size_t j = 0; j < BYTES_LENGTH; j++) {
+      bytes[i][j] = (rand() % BYTE_SPACE_SIZE) + BYTE_VALUE_MIN;
+    }
+    bytes_p[i] = bytes[i];
+    bytes_to_trits(bytes[i], BYTES_LENGTH, trits, BYTES_NUM_TRITS);
+    trits_to_ptrits(trits, ptrit_exp, i, BYTES_NUM_TRITS);
+    trits_to_ptrits_wide(trits, ptrit_wide_exp, i, BYTES_NUM_TRITS);
+  }
+
+  bytes_to_ptrits(bytes_p, 64, ptrit, BYTES_NUM_TRITS);
+  TEST_ASSERT_EQUAL_MEMORY(ptrit_exp, ptrit, sizeof(ptrit));
+  bytes_to_ptrits_wide(bytes_p, 64, ptrit_wide, BYTES_NUM_TRITS);
+  TEST_ASSERT_EQUAL_MEMORY(ptrit_wide_exp, ptrit_wide, BYTES_NUM_TRITS * sizeof(ptrit_wide_t));
+}
+
 int main(void) {
   UNITY_BEGIN();
 
   RUN_TEST(test_trit_to_ptrit);
+  RUN_TEST(test_trytes_to_ptrits);
+  RUN_TEST(test_trytes_to_ptrits_wide);
+  RUN_TEST(test_bytes_to_ptrits);
 
   return UNITY_END();
 }
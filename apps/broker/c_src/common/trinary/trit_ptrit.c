@@ -6,6 +6,154 @@
  */
 
 #include "common/trinary/trit_ptrit.h"
+#include "common/defs.h"
+
+// Low trits masks in bits 0-2 and high trits masks in bits 3-5, indexed by tryte character (invalid ones are '9')
+static uint8_t const TRYTE_PTRIT_MASKS[256] = {
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3E, 0x35, 0x3D, 0x3C, 0x23, 0x2B, 0x2A, 0x33, 0x3B, 0x3A, 0x31, 0x39, 0x38, 0x07, 0x0F,
+    0x0E, 0x17, 0x1F, 0x1E, 0x15, 0x1D, 0x1C, 0x27, 0x2F, 0x2E, 0x37, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+    0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F, 0x3F,
+};
+
+// Low trits masks in bits 0-4 and high trits masks in bits 5-9, ordered like BYTES_TRITS_LUT
+static uint16_t const BYTE_PTRIT_MASKS[BYTE_SPACE_SIZE] = {
+    0x3FF, 0x3FE, 0x3DD, 0x3FD, 0x3FC, 0x39B, 0x3BB, 0x3BA, 0x3DB, 0x3FB, 0x3FA, 0x3D9,
+    0x3F9, 0x3F8, 0x317, 0x337, 0x336, 0x357, 0x377, 0x376, 0x355, 0x375, 0x374, 0x397,
+    0x3B7, 0x3B6, 0x3D7, 0x3F7, 0x3F6, 0x3D5, 0x3F5, 0x3F4, 0x393, 0x3B3, 0x3B2, 0x3D3,
+    0x3F3, 0x3F2, 0x3D1, 0x3F1, 0x3F0, 0x20F, 0x22F, 0x22E, 0x24F, 0x26F, 0x26E, 0x24D,
+    0x26D, 0x26C, 0x28F, 0x2AF, 0x2AE, 0x2CF, 0x2EF, 0x2EE, 0x2CD, 0x2ED, 0x2EC, 0x28B,
+    0x2AB, 0x2AA, 0x2CB, 0x2EB, 0x2EA, 0x2C9, 0x2E9, 0x2E8, 0x30F, 0x32F, 0x32E, 0x34F,
+    0x36F, 0x36E, 0x34D, 0x36D, 0x36C, 0x38F, 0x3AF, 0x3AE, 0x3CF, 0x3EF, 0x3EE, 0x3CD,
+    0x3ED, 0x3EC, 0x38B, 0x3AB, 0x3AA, 0x3CB, 0x3EB, 0x3EA, 0x3C9, 0x3E9, 0x3E8, 0x307,
+    0x327, 0x326, 0x347, 0x367, 0x366, 0x345, 0x365, 0x364, 0x387, 0x3A7, 0x3A6, 0x3C7,
+    0x3E7, 0x3E6, 0x3C5, 0x3E5, 0x3E4, 0x383, 0x3A3, 0x3A2, 0x3C3, 0x3E3, 0x3E2, 0x3C1,
+    0x3E1, 0x3E0, 0x01F, 0x03F, 0x03E, 0x05F, 0x07F, 0x07E, 0x05D, 0x07D, 0x07C, 0x09F,
+    0x0BF, 0x0BE, 0x0DF, 0x0FF, 0x0FE, 0x0DD, 0x0FD, 0x0FC, 0x09B, 0x0BB, 0x0BA, 0x0DB,
+    0x0FB, 0x0FA, 0x0D9, 0x0F9, 0x0F8, 0x11F, 0x13F, 0x13E, 0x15F, 0x17F, 0x17E, 0x15D,
+    0x17D, 0x17C, 0x19F, 0x1BF, 0x1BE, 0x1DF, 0x1FF, 0x1FE, 0x1DD, 0x1FD, 0x1FC, 0x19B,
+    0x1BB, 0x1BA, 0x1DB, 0x1FB, 0x1FA, 0x1D9, 0x1F9, 0x1F8, 0x117, 0x137, 0x136, 0x157,
+    0x177, 0x176, 0x155, 0x175, 0x174, 0x197, 0x1B7, 0x1B6, 0x1D7, 0x1F7, 0x1F6, 0x1D5,
+    0x1F5, 0x1F4, 0x193, 0x1B3, 0x1B2, 0x1D3, 0x1F3, 0x1F2, 0x1D1, 0x1F1, 0x1F0, 0x21F,
+    0x23F, 0x23E, 0x25F, 0x27F, 0x27E, 0x25D, 0x27D, 0x27C, 0x29F, 0x2BF, 0x2BE, 0x2DF,
+    0x2FF, 0x2FE, 0x2DD, 0x2FD, 0x2FC, 0x29B, 0x2BB, 0x2BA, 0x2DB, 0x2FB, 0x2FA, 0x2D9,
+    0x2F9, 0x2F8, 0x31F, 0x33F, 0x33E, 0x35F, 0x37F, 0x37E, 0x35D, 0x37D, 0x37C, 0x39F,
+    0x3BF, 0x3BE, 0x3DF,
+};
+
+// Trytes of the low (bits 0-2) and high (bits 3-5) trits masks
+static tryte_t const PTRIT_MASKS_TRYTE[64] = {
+    'M', 'K', 'G', 'E', 'V', 'T', 'P', 'N', 'M', 'L', 'G', 'F', 'V', 'U', 'P', 'O',
+    'M', 'K', 'J', 'H', 'V', 'T', 'S', 'Q', 'M', 'L', 'J', 'I', 'V', 'U', 'S', 'R',
+    'M', 'K', 'G', 'E', 'D', 'B', 'Y', 'W', 'M', 'L', 'G', 'F', 'D', 'C', 'Y', 'X',
+    'M', 'K', 'J', 'H', 'D', 'B', 'A', 'Z', 'M', 'L', 'J', 'I', 'D', 'C', 'A', '9',
+};
+
+// Transposes the 8x8 bit matrix whose rows are the bytes of x
+static inline uint64_t transpose_8x8(uint64_t x) {
+  uint64_t t;
+
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAuLL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCuLL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0uLL;
+  x = x ^ t ^ (t << 28);
+  return x;
+}
+
+/*
+ * Sets `width` consecutive ptrits of a 64-lane word from the trits masks of `count` inputs, lane i being input i.
+ * `bits` is the position of the high trits masks and `stride` the distance between two ptrits, in ptrit_s
+ */
+static void masks_to_word(uint16_t const *const masks, size_t const count, size_t const bits, size_t const width,
+                          ptrit_s *const low, ptrit_s *const high, size_t const stride) {
+  uint64_t x_low, x_high;
+  size_t g, t, k;
+
+  for (k = 0; k < width; k++) {
+    low[k * stride] = 0;
+    high[k * stride] = 0;
+  }
+  for (g = 0; g * 8 < count; g++) {
+    x_low = x_high = 0;
+    for (t = 0; t < 8 && g * 8 + t < count; t++) {
+      x_low |= (uint64_t)(masks[g * 8 + t] & ((1 << bits) - 1)) << (8 * t);
+      x_high |= (uint64_t)(masks[g * 8 + t] >> bits) << (8 * t);
+    }
+    x_low = transpose_8x8(x_low);
+    x_high = transpose_8x8(x_high);
+    for (k = 0; k < width; k++) {
+      low[k * stride] |= ((x_low >> (8 * k)) & 0xFF) << (8 * g);
+      high[k * stride] |= ((x_high >> (8 * k)) & 0xFF) << (8 * g);
+    }
+  }
+}
+
+static void trytes_to_word(tryte_t const *const *const trytes, size_t const count, ptrit_s *const low,
+                           ptrit_s *const high, size_t const stride, size_t const length) {
+  uint16_t masks[64];
+
+  for (size_t j = 0; j < length; j++) {
+    for (size_t i = 0; i < count; i++) {
+      masks[i] = TRYTE_PTRIT_MASKS[(uint8_t)trytes[i][j]];
+    }
+    masks_to_word(masks, count, NUMBER_OF_TRITS_IN_A_TRYTE, NUMBER_OF_TRITS_IN_A_TRYTE,
+                  low + j * NUMBER_OF_TRITS_IN_A_TRYTE * stride, high + j * NUMBER_OF_TRITS_IN_A_TRYTE * stride,
+                  stride);
+  }
+}
+
+static void bytes_to_word(byte_t const *const *const bytes, size_t const count, ptrit_s *const low,
+                          ptrit_s *const high, size_t const stride, size_t const num_trits) {
+  uint16_t masks[64];
+
+  for (size_t j = 0, k = 0; k < num_trits; j++, k += NUMBER_OF_TRITS_IN_A_BYTE) {
+    for (size_t i = 0; i < count; i++) {
+      masks[i] = BYTE_PTRIT_MASKS[bytes[i][j] < 0 ? bytes[i][j] + BYTE_SPACE_SIZE : bytes[i][j]];
+    }
+    masks_to_word(masks, count, NUMBER_OF_TRITS_IN_A_BYTE,
+                  num_trits - k < NUMBER_OF_TRITS_IN_A_BYTE ? num_trits - k : NUMBER_OF_TRITS_IN_A_BYTE,
+                  low + k * stride, high + k * stride, stride);
+  }
+}
+
+static void word_to_trytes(ptrit_s const *const low, ptrit_s const *const high, size_t const stride,
+                           tryte_t *const *const trytes, size_t const count, size_t const length) {
+  uint64_t x_low, x_high;
+  size_t j, g, t, k;
+
+  for (j = 0; j < length; j++) {
+    for (g = 0; g * 8 < count; g++) {
+      x_low = x_high = 0;
+      for (k = 0; k < NUMBER_OF_TRITS_IN_A_TRYTE; k++) {
+        x_low |= ((low[(j * NUMBER_OF_TRITS_IN_A_TRYTE + k) * stride] >> (8 * g)) & 0xFF) << (8 * k);
+        x_high |= ((high[(j * NUMBER_OF_TRITS_IN_A_TRYTE + k) * stride] >> (8 * g)) & 0xFF) << (8 * k);
+      }
+      x_low = transpose_8x8(x_low);
+      x_high = transpose_8x8(x_high);
+      for (t = 0; t < 8 && g * 8 + t < count; t++) {
+        trytes[g * 8 + t][j] = PTRIT_MASKS_TRYTE[((x_low >> (8 * t)) & 0x07) | (((x_high >> (8 * t)) & 0x07) << 3)];
+      }
+    }
+  }
+}
+
+#define PTRIT_STRIDE (sizeof(ptrit_t) / sizeof(ptrit_s))
+#define PTRIT_WIDE_STRIDE (sizeof(ptrit_wide_t) / sizeof(ptrit_s))
+#define WORD_COUNT(count, w) ((count) > (w)*64 ? ((count) - (w)*64 > 64 ? 64 : (count) - (w)*64) : 0)
 
 void trits_to_ptrits(trit_t const *const trits, ptrit_t *const ptrits, size_t const index, size_t const length) {
   size_t j = 0;
@@ -65,3 +213,78 @@ void ptrits_to_trits(ptrit_t const *const ptrits, trit_t *const trits, size_t co
     trits[j] = l ? (h ? 0 : -1) : 1;
   }
 }
+
+void trits_to_ptrits_wide(trit_t const *const trits, ptrit_wide_t *const ptrits, size_t const index,
+                          size_t const length) {
+  size_t j = 0;
+  size_t const word = index / 64;
+  ptrit_s const bit = 1uLL << (index % 64);
+
+  for (; j < length; j++) {
+    switch (trits[j]) {
+      case 0:
+        ptrits[j].low[word] |= bit;
+        ptrits[j].high[word] |= bit;
+        break;
+      case 1:
+        ptrits[j].high[word] |= bit;
+        break;
+      default:
+        ptrits[j].low[word] |= bit;
+        break;
+    }
+  }
+}
+
+void ptrits_wide_to_trits(ptrit_wide_t const *const ptrits, trit_t *const trits, size_t const index,
+                          size_t const length) {
+  size_t j = 0;
+  size_t const word = index / 64;
+  size_t const shift = index % 64;
+
+  for (; j < length; j++) {
+    int h = (ptrits[j].high[word] >> shift) & 1;
+    int l = (ptrits[j].low[word] >> shift) & 1;
+
+    trits[j] = l ? (h ? 0 : -1) : 1;
+  }
+}
+
+void trytes_to_ptrits(tryte_t const *const *const trytes, size_t const count, ptrit_t *const ptrits,
+                      size_t const length) {
+  trytes_to_word(trytes, count, &ptrits->low, &ptrits->high, PTRIT_STRIDE, length);
+}
+
+void trytes_to_ptrits_wide(tryte_t const *const *const trytes, size_t const count, ptrit_wide_t *const ptrits,
+                           size_t const length) {
+  for (size_t w = 0; w < PTRIT_WIDE_WORDS; w++) {
+    trytes_to_word(trytes + w * 64, WORD_COUNT(count, w), &ptrits->low[w], &ptrits->high[w], PTRIT_WIDE_STRIDE,
+                   length);
+  }
+}
+
+void bytes_to_ptrits(byte_t const *const *const bytes, size_t const count, ptrit_t *const ptrits,
+                     size_t const num_trits) {
+  bytes_to_word(bytes, count, &ptrits->low, &ptrits->high, PTRIT_STRIDE, num_trits);
+}
+
+void bytes_to_ptrits_wide(byte_t const *const *const bytes, size_t const count, ptrit_wide_t *const ptrits,
+                          size_t const num_trits) {
+  for (size_t w = 0; w < PTRIT_WIDE_WORDS; w++) {
+    bytes_to_word(bytes + w * 64, WORD_COUNT(count, w), &ptrits->low[w], &ptrits->high[w], PTRIT_WIDE_STRIDE,
+                  num_trits);
+  }
+}
+
+void ptrits_to_trytes(ptrit_t const *const ptrits, tryte_t *const *const trytes, size_t const count,
+                      size_t const length) {
+  word_to_trytes(&ptrits->low, &ptrits->high, PTRIT_STRIDE, trytes, count, length);
+}
+
+void ptrits_wide_to_trytes(ptrit_wide_t const *const ptrits, tryte_t *const *const trytes, size_t const count,
+                           size_t const length) {
+  for (size_t w = 0; w * 64 < count; w++) {
+    word_to_trytes(&ptrits->low[w], &ptrits->high[w], PTRIT_WIDE_STRIDE, trytes + w * 64, WORD_COUNT(count, w),
+                   length);
+  }
+}
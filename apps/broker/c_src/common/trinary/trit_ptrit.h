@@ -9,8 +9,10 @@
 #define __COMMON_TRINARY_TRIT_PTRIT_H_
 
 #include "common/stdint.h"
+#include "common/trinary/bytes.h"
 #include "common/trinary/ptrit_incr.h"
 #include "common/trinary/trits.h"
+#include "common/trinary/tryte.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -19,6 +21,28 @@ extern "C" {
 void trits_to_ptrits(trit_t const *const trits, ptrit_t *const ptrits, size_t const index, size_t const length);
 void trits_to_ptrits_fill(trit_t const *const trits, ptrit_t *const ptrits, size_t const length);
 void ptrits_to_trits(ptrit_t const *const ptrits, trit_t *const trits, size_t const index, size_t const length);
+void trits_to_ptrits_wide(trit_t const *const trits, ptrit_wide_t *const ptrits, size_t const index,
+                          size_t const length);
+void ptrits_wide_to_trits(ptrit_wide_t const *const ptrits, trit_t *const trits, size_t const index,
+                          size_t const length);
+
+/*
+ * Bulk conversions: input/output i (trytes[i] or bytes[i]) is lane i of the ptrits, `count` is at most 64 (or
+ * PTRIT_WIDE_LANES for the wide variants) and lanes without input are cleared.
+ * `length` is a number of trytes, `num_trits` a number of trits.
+ */
+void trytes_to_ptrits(tryte_t const *const *const trytes, size_t const count, ptrit_t *const ptrits,
+                      size_t const length);
+void trytes_to_ptrits_wide(tryte_t const *const *const trytes, size_t const count, ptrit_wide_t *const ptrits,
+                           size_t const length);
+void bytes_to_ptrits(byte_t const *const *const bytes, size_t const count, ptrit_t *const ptrits,
+                     size_t const num_trits);
+void bytes_to_ptrits_wide(byte_t const *const *const bytes, size_t const count, ptrit_wide_t *const ptrits,
+                          size_t const num_trits);
+void ptrits_to_trytes(ptrit_t const *const ptrits, tryte_t *const *const trytes, size_t const count,
+                      size_t const length);
+void ptrits_wide_to_trytes(ptrit_wide_t const *const ptrits, tryte_t *const *const trytes, size_t const count,
+                           size_t const length);
 
 #ifdef __cplusplus
 }
@@ -1,9 +1,15 @@
 #include "erl_nif.h"
 
 #include "common/crypto/curl-p/ptrit.h" // ptrit_curl impl
-#include "common/trinary/trit_ptrit.h" // trits <-> ptrits conversion
+#include "common/crypto/curl-p/ptrit_wide.h" // wide (avx2/avx-512) ptrit_curl impl
+#include "common/trinary/trit_ptrit.h" // trits/trytes <-> ptrits conversion
 #include "common/trinary/trit_tryte.h" // trits <-> trytes conversion
 #include "common/model/bundle.h" // bundle header
+#include "common/model/bundle_validation_pool.h" // parallel signatures validation
+#include "common/model/dmp_reader.h" // historical dumps streaming
+#include "common/model/transaction_view.h" // in place transaction/bundle views
+#include <limits.h>
+#include <stdio.h>
 #include <string.h>
 
 #define DEBUG 3
@@ -15,20 +21,210 @@
  #define DEBUG_PRINT(fmt, args...) /* Don't do anything in release builds */
 #endif
 
+// upper bound (in microseconds) of a nif call on a normal scheduler
+#define NIF_TIMESLICE_USEC 1000
+// longest list decode_transactions runs on a normal scheduler, ~1us per tx
+#define DECODE_NORMAL_MAX_TXS 256
+
 typedef struct PECurl_s {
   PCurl curl; // curl state
   ptrit_t acc[243]; // accumulator for the current tx chunks
 } PECurl;
 
+// state of a hash_and_verify call, kept between reschedules when yielding
+// batches of up to 64 txs (the validator demand) are hashed on the 64-lane curl, whose
+// compact state transforms faster than the smallest wide one, larger batches on the wide curl
+typedef struct PEHashJob_s {
+  PECurl narrow; // 64-lane curl state and accumulator, batches of up to 64 txs
+  PCurlWide curl; // wide curl state, larger batches
+  ptrit_wide_t acc[HASH_LENGTH_TRIT]; // accumulator for the current tx chunks
+  tryte_t hashes[PTRIT_WIDE_LANES][NUM_TRYTES_HASH]; // calculated tx hashes
+  size_t offset; // offset (in trytes) of the next chunk to absorb
+  bool wide; // the batch is hashed on the wide curl
+} PEHashJob;
+
+// scratch of the thread (normal or dirty scheduler) running a nif, reused by all its calls
+typedef struct NifContext_s {
+  PEHashJob hash_job; // hash_and_verify state when it runs in one go
+  bundle_validation_scratch_t bundle_scratch; // signatures validation buffers
+  bundle_view_t *bundles; // validate_bundles args
+  bundle_status_t *statuses; // validate_bundles statuses
+  ERL_NIF_TERM *results; // validate_bundles results
+  size_t bundles_capacity; // size of the three arrays above
+  dmp_hasher_t *dmp_hasher; // dmp_decode hashes verification state, allocated on first use
+  dmp_tx_t *dmp_txs; // dmp_decode parsed lines
+  ERL_NIF_TERM *dmp_terms; // dmp_decode txs rows, then bundles
+  size_t dmp_capacity; // size of the two arrays above
+  uint64_t calls; // nif calls served, only written by the thread
+  struct NifContext_s *next; // all the contexts, to report and release them
+} NifContext;
+
+// states referenced by resources, they can be used by any scheduler so they are
+// recycled through a free list shared by all of them instead of a thread context
+typedef struct NifPool_s {
+  const char* name; // name in the stats
+  size_t block_size; // size of a state
+  void* free; // free states, chained through their first word
+  uint64_t blocks; // allocated states
+  uint64_t in_use; // states referenced by a live resource
+  uint64_t reuses; // states taken from the free list
+} NifPool;
+
+// a resource only holds a pooled state, given back to its pool by the destructor
+typedef struct PooledRes_s {
+  void* state;
+} PooledRes;
+
+// a mapped dump, chunks are split under the lock and are binaries referencing the
+// resource, so the mapping lives as long as the last chunk taken from it
+typedef struct DmpRes_s {
+  dmp_reader_t reader;
+  ErlNifMutex* lock;
+} DmpRes;
+
+// scheduling policy of the cpu heavy nifs, set through load_info:
+// :normal => run on the calling (normal) scheduler
+// :dirty => reschedule on a dirty cpu scheduler
+// :yield => hash_and_verify yields its timeslice between chunks, validate_bundle(s) run dirty
+typedef enum {
+  NIF_SCHEDULING_NORMAL,
+  NIF_SCHEDULING_DIRTY,
+  NIF_SCHEDULING_YIELD,
+} nif_scheduling_t;
+
 ErlNifResourceType* RES_TYPE;
+ErlNifResourceType* JOB_RES_TYPE;
+ErlNifResourceType* DMP_RES_TYPE;
+// per thread contexts and resource state pools, the lock protects the pools and the contexts list
+ErlNifTSDKey context_key;
+ErlNifMutex* context_lock = NULL;
+NifContext* contexts = NULL;
+uint64_t contexts_count = 0;
+NifPool curl_pool = {"curl", sizeof(PECurl), NULL, 0, 0, 0};
+NifPool job_pool = {"hash_job", sizeof(PEHashJob), NULL, 0, 0, 0};
+nif_scheduling_t nif_scheduling = NIF_SCHEDULING_DIRTY;
+// threads validating the bundles signatures, shared by all the bundle nifs
+bundle_validation_pool_t bundle_pool;
+bool bundle_pool_running = false;
 ERL_NIF_TERM atom_ok;
 ERL_NIF_TERM atom_true;
 ERL_NIF_TERM atom_false;
+ERL_NIF_TERM atom_nil;
+ERL_NIF_TERM atom_error;
+ERL_NIF_TERM atom_eof;
+
+// take a state from the pool, allocate a new one when the free list is empty
+static void*
+pool_acquire(NifPool* pool)
+{
+    void* state;
+    enif_mutex_lock(context_lock);
+    if((state = pool->free) != NULL)
+    {
+      pool->free = *(void**)state;
+      pool->reuses++;
+      pool->in_use++;
+    }
+    enif_mutex_unlock(context_lock);
+    if(state != NULL)
+    {
+      return state;
+    }
+    if((state = enif_alloc(pool->block_size)) == NULL)
+    {
+      return NULL;
+    }
+    enif_mutex_lock(context_lock);
+    pool->blocks++;
+    pool->in_use++;
+    enif_mutex_unlock(context_lock);
+    return state;
+}
 
+static void
+pool_release(NifPool* pool, void* state)
+{
+    enif_mutex_lock(context_lock);
+    *(void**)state = pool->free;
+    pool->free = state;
+    pool->in_use--;
+    enif_mutex_unlock(context_lock);
+}
+
+static void
+pool_destroy(NifPool* pool)
+{
+    void* state;
+    while((state = pool->free) != NULL)
+    {
+      pool->free = *(void**)state;
+      enif_free(state);
+      pool->blocks--;
+    }
+}
+
+// allocate a resource holding a state of pool, NULL if out of memory
+static PooledRes*
+alloc_pooled_res(ErlNifResourceType* type, NifPool* pool)
+{
+    PooledRes* res;
+    if((res = enif_alloc_resource(type, sizeof(PooledRes))) == NULL)
+    {
+      return NULL;
+    }
+    if((res->state = pool_acquire(pool)) == NULL)
+    {
+      enif_release_resource(res); // the destructor skips the missing state
+      return NULL;
+    }
+    return res;
+}
+
+// give the curl_p state of a collected resource back to the pool
 void
 free_res(ErlNifEnv* env, void* obj)
 {
-  // free curl_p resource
+    PooledRes* res = (PooledRes*)obj;
+    if(res->state != NULL)
+    {
+      pool_release(&curl_pool, res->state);
+    }
+}
+
+// give the hash job of a collected resource back to the pool
+static void
+free_job_res(ErlNifEnv* env, void* obj)
+{
+    PooledRes* res = (PooledRes*)obj;
+    if(res->state != NULL)
+    {
+      pool_release(&job_pool, res->state);
+    }
+}
+
+// unmap the dump of a collected reader
+static void
+free_dmp_res(ErlNifEnv* env, void* obj)
+{
+    DmpRes* res = (DmpRes*)obj;
+    dmp_reader_close(&res->reader);
+    if(res->lock != NULL)
+    {
+      enif_mutex_destroy(res->lock);
+    }
+}
+
+// get the curl_p state of a resource term
+static int
+get_pecurl(ErlNifEnv* env, ERL_NIF_TERM term, PECurl** pecurl)
+{
+    PooledRes* res;
+    if(!enif_get_resource(env, term, RES_TYPE, (void**) &res))
+    {
+      return 0;
+    }
+    *pecurl = (PECurl*)res->state;
+    return 1;
 }
 
 static int
@@ -37,19 +233,212 @@ open_resource(ErlNifEnv* env)
     const char* mod = "Elixir.Nifs";
     const char* name = "PECurl";
     int flags = ERL_NIF_RT_CREATE | ERL_NIF_RT_TAKEOVER;
-    RES_TYPE = enif_open_resource_type(env, mod, name, NULL, flags, NULL);
+    RES_TYPE = enif_open_resource_type(env, mod, name, free_res, flags, NULL);
     if(RES_TYPE == NULL) return -1;
+    JOB_RES_TYPE = enif_open_resource_type(env, mod, "PEHashJob", free_job_res, flags, NULL);
+    if(JOB_RES_TYPE == NULL) return -1;
+    DMP_RES_TYPE = enif_open_resource_type(env, mod, "DmpReader", free_dmp_res, flags, NULL);
+    if(DMP_RES_TYPE == NULL) return -1;
+    return 0;
+}
+
+// create the thread contexts key and the pools lock, once per loaded library
+static int
+load_contexts(void)
+{
+    if(context_lock != NULL)
+    {
+      return 0;
+    }
+    if(enif_tsd_key_create("nifs_context", &context_key) != 0)
+    {
+      return -1;
+    }
+    if((context_lock = enif_mutex_create("nifs_context_lock")) == NULL)
+    {
+      enif_tsd_key_destroy(context_key);
+      return -1;
+    }
+    return 0;
+}
+
+// context of the calling thread, created by its first nif call
+static NifContext*
+get_context(void)
+{
+    NifContext* ctx = (NifContext*)enif_tsd_get(context_key);
+    if(ctx == NULL)
+    {
+      if((ctx = enif_alloc(sizeof(NifContext))) == NULL)
+      {
+        return NULL;
+      }
+      bundle_validation_scratch_init(&ctx->bundle_scratch);
+      ctx->bundles = NULL;
+      ctx->statuses = NULL;
+      ctx->results = NULL;
+      ctx->bundles_capacity = 0;
+      ctx->dmp_hasher = NULL;
+      ctx->dmp_txs = NULL;
+      ctx->dmp_terms = NULL;
+      ctx->dmp_capacity = 0;
+      ctx->calls = 0;
+      enif_mutex_lock(context_lock);
+      ctx->next = contexts;
+      contexts = ctx;
+      contexts_count++;
+      enif_mutex_unlock(context_lock);
+      enif_tsd_set(context_key, ctx);
+    }
+    ctx->calls++;
+    return ctx;
+}
+
+// grow the validate_bundles arrays of a context to hold count bundles
+static int
+context_reserve_bundles(NifContext* ctx, size_t count)
+{
+    void* array;
+    if(count <= ctx->bundles_capacity)
+    {
+      return 1;
+    }
+    if((array = enif_realloc(ctx->bundles, count * sizeof(bundle_view_t))) == NULL) return 0;
+    ctx->bundles = array;
+    if((array = enif_realloc(ctx->statuses, count * sizeof(bundle_status_t))) == NULL) return 0;
+    ctx->statuses = array;
+    if((array = enif_realloc(ctx->results, count * sizeof(ERL_NIF_TERM))) == NULL) return 0;
+    ctx->results = array;
+    ctx->bundles_capacity = count;
+    return 1;
+}
+
+// allocate the dmp_decode hasher of ctx and grow its arrays to count txs, 0 if out of memory
+static int
+context_reserve_dmp(NifContext* ctx, size_t count)
+{
+    void* array;
+    if(ctx->dmp_hasher == NULL && (ctx->dmp_hasher = enif_alloc(sizeof(dmp_hasher_t))) == NULL)
+    {
+      return 0;
+    }
+    if(count <= ctx->dmp_capacity)
+    {
+      return 1;
+    }
+    if((array = enif_realloc(ctx->dmp_txs, count * sizeof(dmp_tx_t))) == NULL) return 0;
+    ctx->dmp_txs = array;
+    if((array = enif_realloc(ctx->dmp_terms, count * sizeof(ERL_NIF_TERM))) == NULL) return 0;
+    ctx->dmp_terms = array;
+    ctx->dmp_capacity = count;
+    return 1;
+}
+
+// release the contexts and the pooled states, erts only unloads the library
+// once all its resources have been collected
+static void
+unload_contexts(void)
+{
+    NifContext* ctx;
+    if(context_lock == NULL)
+    {
+      return;
+    }
+    while((ctx = contexts) != NULL)
+    {
+      contexts = ctx->next;
+      bundle_validation_scratch_destroy(&ctx->bundle_scratch);
+      enif_free(ctx->bundles);
+      enif_free(ctx->statuses);
+      enif_free(ctx->results);
+      enif_free(ctx->dmp_hasher);
+      enif_free(ctx->dmp_txs);
+      enif_free(ctx->dmp_terms);
+      enif_free(ctx);
+    }
+    contexts_count = 0;
+    pool_destroy(&curl_pool);
+    pool_destroy(&job_pool);
+    enif_tsd_key_destroy(context_key);
+    enif_mutex_destroy(context_lock);
+    context_lock = NULL;
+}
+
+// load_info is a map: %{scheduling: atom, bundle_threads: integer}
+// a missing or invalid scheduling keeps the default (dirty)
+static void
+load_scheduling(ErlNifEnv* env, ERL_NIF_TERM load_info)
+{
+    char policy[16];
+    ERL_NIF_TERM value;
+    if(!enif_get_map_value(env, load_info, enif_make_atom(env, "scheduling"), &value) ||
+        !enif_get_atom(env, value, policy, sizeof(policy), ERL_NIF_LATIN1))
+    {
+        return;
+    }
+    if(strcmp(policy, "normal") == 0)
+    {
+        nif_scheduling = NIF_SCHEDULING_NORMAL;
+    } else if(strcmp(policy, "yield") == 0)
+    {
+        nif_scheduling = NIF_SCHEDULING_YIELD;
+    } else
+    {
+        nif_scheduling = NIF_SCHEDULING_DIRTY;
+    }
+}
+
+// start the bundle validation pool with load_info bundle_threads (default 0)
+// threads, the nif callers always take part in the validation
+static int
+load_bundle_pool(ErlNifEnv* env, ERL_NIF_TERM load_info)
+{
+    unsigned int threads = 0;
+    ERL_NIF_TERM value;
+    if(bundle_pool_running)
+    {
+        return 0;
+    }
+    if(enif_get_map_value(env, load_info, enif_make_atom(env, "bundle_threads"), &value) &&
+        !enif_get_uint(env, value, &threads))
+    {
+        return -1;
+    }
+    if(bundle_validation_pool_init(&bundle_pool, threads) != RC_OK)
+    {
+        return -1;
+    }
+    bundle_pool_running = true;
     return 0;
 }
+
+// run fptr according to the scheduling policy, yield policy falls back to dirty
+// for nifs which can't be split in smaller units of work
+static ERL_NIF_TERM
+schedule(ErlNifEnv* env, const char* name,
+    ERL_NIF_TERM (*fptr)(ErlNifEnv*, int, const ERL_NIF_TERM[]), int argc, const ERL_NIF_TERM argv[])
+{
+    if(nif_scheduling == NIF_SCHEDULING_NORMAL)
+    {
+        return fptr(env, argc, argv);
+    }
+    return enif_schedule_nif(env, name, ERL_NIF_DIRTY_JOB_CPU_BOUND, fptr, argc, argv);
+}
 // erlang nif related functions
 static int
 load(ErlNifEnv* env, void** priv, ERL_NIF_TERM load_info)
 {
     if(open_resource(env) == -1) return -1;
+    if(load_contexts() == -1) return -1;
+    load_scheduling(env, load_info);
+    if(load_bundle_pool(env, load_info) == -1) return -1;
 
     atom_ok = enif_make_atom(env, "ok");
     atom_true = enif_make_atom(env, "true");
     atom_false = enif_make_atom(env, "false");
+    atom_nil = enif_make_atom(env, "nil");
+    atom_error = enif_make_atom(env, "error");
+    atom_eof = enif_make_atom(env, "eof");
     return 0;
 }
 
@@ -58,6 +447,9 @@ static int
 reload(ErlNifEnv* env, void** priv, ERL_NIF_TERM load_info)
 {
     if(open_resource(env) == -1) return -1;
+    if(load_contexts() == -1) return -1;
+    load_scheduling(env, load_info);
+    if(load_bundle_pool(env, load_info) == -1) return -1;
     return 0;
 }
 
@@ -65,13 +457,28 @@ static int
 upgrade(ErlNifEnv* env, void** priv, void** old_priv, ERL_NIF_TERM load_info)
 {
     if(open_resource(env) == -1) return -1;
+    if(load_contexts() == -1) return -1;
+    load_scheduling(env, load_info);
+    if(load_bundle_pool(env, load_info) == -1) return -1;
     return 0;
 }
 
+static void
+unload(ErlNifEnv* env, void* priv)
+{
+    if(bundle_pool_running)
+    {
+        bundle_validation_pool_destroy(&bundle_pool);
+        bundle_pool_running = false;
+    }
+    unload_contexts();
+}
+
 // curl_p_81_init_nif function which alloc resource and return pointer to
 static ERL_NIF_TERM
 curl_p_81_init_nif(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 {
+    PooledRes* res;
     PECurl* pecurl;
     ERL_NIF_TERM ret;
 
@@ -80,12 +487,13 @@ curl_p_81_init_nif(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
         return enif_make_badarg(env);
     }
 
-    // alloc memory resource with sizeof(PECurl) typestruct
-    pecurl = enif_alloc_resource(RES_TYPE, sizeof(PECurl));
-    // if pecurl == NULL return bad argument.
-    if(pecurl == NULL) return enif_make_badarg(env);
-    ret = enif_make_resource(env, pecurl);
-    enif_release_resource(pecurl);
+    // alloc the resource, its curl_p state is recycled from collected ones
+    res = alloc_pooled_res(RES_TYPE, &curl_pool);
+    // if res == NULL return bad argument.
+    if(res == NULL) return enif_make_badarg(env);
+    ret = enif_make_resource(env, res);
+    enif_release_resource(res);
+    pecurl = (PECurl*)res->state;
     // init curl_p
     pecurl->curl.type = CURL_P_81;
     ptrit_curl_init(&pecurl->curl, CURL_P_81);
@@ -95,7 +503,7 @@ curl_p_81_init_nif(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 
 // args: PECurl *pecurl
 static ERL_NIF_TERM
-absorb(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+absorb_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 {
     PECurl *pecurl;
     if(argc != 1)
@@ -103,7 +511,7 @@ absorb(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
         return enif_make_badarg(env);
     }
 
-    if(!enif_get_resource(env, argv[0], RES_TYPE, (void**) &pecurl))
+    if(!get_pecurl(env, argv[0], &pecurl))
     {
 	return enif_make_badarg(env);
     }
@@ -115,7 +523,7 @@ absorb(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 
 // args: PECurl *pecurl
 static ERL_NIF_TERM
-squeeze(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+squeeze_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 {
     PECurl *pecurl;
     if(argc != 1)
@@ -123,7 +531,7 @@ squeeze(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
       return enif_make_badarg(env);
     }
 
-    if(!enif_get_resource(env, argv[0], RES_TYPE, (void**) &pecurl))
+    if(!get_pecurl(env, argv[0], &pecurl))
     {
     	return enif_make_badarg(env);
     }
@@ -145,30 +553,27 @@ add_trytes(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
         return enif_make_badarg(env);
     }
     // get res pointer to get the resource
-    if(!enif_get_resource(env, argv[0], RES_TYPE, (void**) &pecurl))
+    if(!get_pecurl(env, argv[0], &pecurl))
     {
 	     return enif_make_badarg(env);
     }
-    // clear acc in resource
-    memset(pecurl->acc, 0, sizeof(pecurl->acc));
     // get tx_count
-    if(!enif_get_int(env, argv[1], &tx_count))
+    if(!enif_get_int(env, argv[1], &tx_count) || tx_count < 0 || tx_count > 64)
     {
        return enif_make_badarg(env);
     }
     // get trytes as binary
-    if(!enif_inspect_binary(env, argv[2], &in))
+    if(!enif_inspect_binary(env, argv[2], &in) || in.size < (size_t)tx_count * 81)
     {
       return enif_make_badarg(env);
     }
-    // add trytes
-    tryte_t const *tx_chunk = (tryte_t const *)in.data;
-    for(int tx_index = 0; tx_index < tx_count; ++tx_index, tx_chunk += 81)
+    // add trytes, lanes without a tx are cleared
+    tryte_t const *tx_chunks[64];
+    for(int tx_index = 0; tx_index < tx_count; ++tx_index)
     {
-      trit_t trits[243];
-      trytes_to_trits(tx_chunk, trits, 81); // `length` argument is the length of trytes
-      trits_to_ptrits(trits, pecurl->acc, tx_index, 243);
+      tx_chunks[tx_index] = (tryte_t const *)in.data + tx_index * 81;
     }
+    trytes_to_ptrits(tx_chunks, tx_count, pecurl->acc, 81); // `length` argument is the length of trytes
 
     return atom_ok;
 }
@@ -185,30 +590,33 @@ get_trytes_and_cmp_hashes(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
         return enif_make_badarg(env);
     }
     // get res pointer to get the resource
-    if(!enif_get_resource(env, argv[0], RES_TYPE, (void**) &pecurl))
+    if(!get_pecurl(env, argv[0], &pecurl))
     {
 	     return enif_make_badarg(env);
     }
     // get tx_count of the chunk
-    if(!enif_get_int(env, argv[1], &tx_count))
+    if(!enif_get_int(env, argv[1], &tx_count) || tx_count < 0 || tx_count > 64)
     {
        return enif_make_badarg(env);
     }
     // get tx_hashes line
-    if(!enif_inspect_binary(env, argv[2], &in))
+    if(!enif_inspect_binary(env, argv[2], &in) || in.size < (size_t)tx_count * 81)
       return enif_make_badarg(env);
 
     // get trytes
     tryte_t const *tx_hash = (tryte_t const *)in.data;
-    ERL_NIF_TERM result [tx_count];
+    tryte_t calculated_hashes[64][81];
+    tryte_t *calculated_hash_ptrs[64];
+    ERL_NIF_TERM result [64];
 
+    for(int tx_index = 0; tx_index < tx_count; ++tx_index)
+    {
+      calculated_hash_ptrs[tx_index] = calculated_hashes[tx_index];
+    }
+    ptrits_to_trytes(pecurl->acc, calculated_hash_ptrs, tx_count, 81); // `length` argument is the length of trytes
     for(int tx_index = 0; tx_index < tx_count; ++tx_index, tx_hash += 81)
     {
-      trit_t trits[243];
-      tryte_t calculated_hash[81];
-      ptrits_to_trits(pecurl->acc, trits, tx_index, 243);
-      trits_to_trytes(trits ,calculated_hash, 243); // `length` argument is the length of the trits, not trytes
-      if (0 == memcmp(calculated_hash, tx_hash, 81)) {
+      if (0 == memcmp(calculated_hashes[tx_index], tx_hash, 81)) {
         result[tx_index] = atom_true;
       } else {
         result[tx_index] = atom_false;
@@ -218,12 +626,190 @@ get_trytes_and_cmp_hashes(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 }
 
 
+// get txs trytes, hashes trytes and tx_count of hash_and_verify args
+static int
+get_hash_and_verify_args(ErlNifEnv* env, const ERL_NIF_TERM argv[],
+    ErlNifBinary* txs, ErlNifBinary* hashes, size_t* tx_count)
+{
+    if(!enif_inspect_binary(env, argv[0], txs) || !enif_inspect_binary(env, argv[1], hashes))
+    {
+        return 0;
+    }
+    // tx_count is implied by the hashes line and must fit in the ptrit lanes
+    *tx_count = hashes->size / NUM_TRYTES_HASH;
+    return hashes->size % NUM_TRYTES_HASH == 0 && *tx_count <= PTRIT_WIDE_LANES &&
+        txs->size == *tx_count * NUM_TRYTES_SERIALIZED_TRANSACTION;
+}
+
+// start hashing a batch of tx_count txs on the narrowest curl holding it
+static void
+hash_job_init(PEHashJob* job, size_t tx_count)
+{
+    job->wide = tx_count > 64;
+    if(job->wide)
+    {
+      ptrit_wide_curl_init(&job->curl, CURL_P_81, tx_count);
+    }
+    else
+    {
+      ptrit_curl_init(&job->narrow.curl, CURL_P_81);
+    }
+    job->offset = 0;
+}
+
+// absorb the chunk (81 trytes) at job->offset of all txs
+static void
+absorb_txs_chunk(PEHashJob* job, ErlNifBinary const* txs, size_t tx_count)
+{
+    tryte_t const *tx_chunks[PTRIT_WIDE_LANES];
+    for(size_t tx_index = 0; tx_index < tx_count; ++tx_index)
+    {
+      tx_chunks[tx_index] = (tryte_t const *)txs->data + tx_index * NUM_TRYTES_SERIALIZED_TRANSACTION + job->offset;
+    }
+    // lanes without a tx are cleared
+    if(job->wide)
+    {
+      trytes_to_ptrits_wide(tx_chunks, tx_count, job->acc, NUM_TRYTES_HASH);
+      ptrit_wide_curl_absorb(&job->curl, job->acc, HASH_LENGTH_TRIT);
+    }
+    else
+    {
+      trytes_to_ptrits(tx_chunks, tx_count, job->narrow.acc, NUM_TRYTES_HASH);
+      ptrit_curl_absorb(&job->narrow.curl, job->narrow.acc, HASH_LENGTH_TRIT);
+    }
+    job->offset += NUM_TRYTES_HASH;
+}
+
+// squeeze the hashes and compare them with the given ones, returns [bool]
 static ERL_NIF_TERM
-validate_bundle(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+squeeze_and_cmp_hashes(ErlNifEnv* env, PEHashJob* job, ErlNifBinary const* hashes, size_t tx_count)
+{
+    tryte_t const *tx_hash = (tryte_t const *)hashes->data;
+    tryte_t *calculated_hashes[PTRIT_WIDE_LANES];
+    ERL_NIF_TERM result[PTRIT_WIDE_LANES];
+
+    for(size_t tx_index = 0; tx_index < tx_count; ++tx_index)
+    {
+      calculated_hashes[tx_index] = job->hashes[tx_index];
+    }
+    if(job->wide)
+    {
+      ptrit_wide_curl_squeeze(&job->curl, job->acc, HASH_LENGTH_TRIT);
+      ptrits_wide_to_trytes(job->acc, calculated_hashes, tx_count, NUM_TRYTES_HASH);
+    }
+    else
+    {
+      ptrit_curl_squeeze(&job->narrow.curl, job->narrow.acc, HASH_LENGTH_TRIT);
+      ptrits_to_trytes(job->narrow.acc, calculated_hashes, tx_count, NUM_TRYTES_HASH);
+    }
+    for(size_t tx_index = 0; tx_index < tx_count; ++tx_index, tx_hash += NUM_TRYTES_HASH)
+    {
+      result[tx_index] = (0 == memcmp(job->hashes[tx_index], tx_hash, NUM_TRYTES_HASH)) ? atom_true : atom_false;
+    }
+    return enif_make_list_from_array(env, result, tx_count);
+}
+
+// args: tryte_t const tx_trytes[2673 * tx_count], tryte_t const tx_hashes[81 * tx_count]
+// hashes all the txs in one go
+static ERL_NIF_TERM
+hash_and_verify_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    NifContext *ctx;
+    PEHashJob *job;
+    size_t tx_count; // number of txs
+    ErlNifBinary txs; // txs.data(trytes) of the whole transactions
+    ErlNifBinary hashes; // hashes.data(trytes) of the tx hashes
+    if(argc != 2 || !get_hash_and_verify_args(env, argv, &txs, &hashes, &tx_count))
+    {
+        return enif_make_badarg(env);
+    }
+
+    // the wide curl state is too large for the scheduler stack, it lives in the thread context
+    if((ctx = get_context()) == NULL) return enif_make_badarg(env);
+    job = &ctx->hash_job;
+    hash_job_init(job, tx_count);
+    // absorb the 33 chunks (81 trytes each) of all txs
+    while(job->offset < NUM_TRYTES_SERIALIZED_TRANSACTION)
+    {
+      absorb_txs_chunk(job, &txs, tx_count);
+    }
+    return squeeze_and_cmp_hashes(env, job, &hashes, tx_count);
+}
+
+// args: tryte_t const tx_trytes[2673 * tx_count], tryte_t const tx_hashes[81 * tx_count], PEHashJob *job
+// absorbs chunks until the timeslice is consumed, then reschedules itself
+static ERL_NIF_TERM
+hash_and_verify_yield(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    PooledRes *res;
+    PEHashJob *job;
+    size_t tx_count; // number of txs
+    ErlNifBinary txs; // txs.data(trytes) of the whole transactions
+    ErlNifBinary hashes; // hashes.data(trytes) of the tx hashes
+    if(argc != 3 || !get_hash_and_verify_args(env, argv, &txs, &hashes, &tx_count) ||
+        !enif_get_resource(env, argv[2], JOB_RES_TYPE, (void**) &res))
+    {
+        return enif_make_badarg(env);
+    }
+    job = (PEHashJob*)res->state;
+
+    ErlNifTime start = enif_monotonic_time(ERL_NIF_USEC);
+    while(job->offset < NUM_TRYTES_SERIALIZED_TRANSACTION)
+    {
+      absorb_txs_chunk(job, &txs, tx_count);
+      // report the consumed percentage of the timeslice
+      ErlNifTime now = enif_monotonic_time(ERL_NIF_USEC);
+      int percent = (int)((now - start) * 100 / NIF_TIMESLICE_USEC);
+      start = now;
+      if(enif_consume_timeslice(env, percent < 1 ? 1 : (percent > 100 ? 100 : percent)) &&
+          job->offset < NUM_TRYTES_SERIALIZED_TRANSACTION)
+      {
+        return enif_schedule_nif(env, "hash_and_verify", 0, hash_and_verify_yield, argc, argv);
+      }
+    }
+    return squeeze_and_cmp_hashes(env, job, &hashes, tx_count);
+}
+
+// args: tryte_t const tx_trytes[2673 * tx_count], tryte_t const tx_hashes[81 * tx_count]
+// hashes up to 512 whole transactions in a single call and returns [bool] (hash matches)
+static ERL_NIF_TERM
+hash_and_verify(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    PooledRes *res;
+    PEHashJob *job;
+    ERL_NIF_TERM yield_argv[3];
+    size_t tx_count; // number of txs
+    ErlNifBinary txs; // txs.data(trytes) of the whole transactions
+    ErlNifBinary hashes; // hashes.data(trytes) of the tx hashes
+    // validated before any job is taken from the pool
+    if(argc != 2 || !get_hash_and_verify_args(env, argv, &txs, &hashes, &tx_count))
+    {
+        return enif_make_badarg(env);
+    }
+    if(nif_scheduling != NIF_SCHEDULING_YIELD)
+    {
+        return schedule(env, "hash_and_verify", hash_and_verify_run, argc, argv);
+    }
+    // alloc the job resource which carries the curl state between reschedules,
+    // the state itself is recycled from collected jobs
+    res = alloc_pooled_res(JOB_RES_TYPE, &job_pool);
+    if(res == NULL) return enif_make_badarg(env);
+    job = (PEHashJob*)res->state;
+    hash_job_init(job, tx_count);
+    yield_argv[0] = argv[0];
+    yield_argv[1] = argv[1];
+    yield_argv[2] = enif_make_resource(env, res);
+    enif_release_resource(res);
+    return hash_and_verify_yield(env, 3, yield_argv);
+}
+
+// args: int tx_count, tryte_t const bundle_trytes[2673 * tx_count]
+static ERL_NIF_TERM
+validate_bundle_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
 {
-    retcode_t res = RC_OK;
     int tx_count; // tx_count of the chunk
-    bundle_transactions_t *bundle = NULL; // bundle var
+    NifContext *ctx; // scratch buffers of the thread
+    bundle_view_t bundle; // reads the txs in place from the binary
     bundle_status_t bundle_status = BUNDLE_NOT_INITIALIZED;
     ErlNifBinary in; // in.data(trytes) of the chunk
     if(argc != 2)
@@ -231,42 +817,424 @@ validate_bundle(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
         return enif_make_badarg(env);
     }
     // get tx_count of the chunk
-    if(!enif_get_int(env, argv[0], &tx_count))
+    if(!enif_get_int(env, argv[0], &tx_count) || tx_count < 0)
     {
        return enif_make_badarg(env);
     }
-
     // get bundle_trytes line
     if(!enif_inspect_binary(env, argv[1], &in))
       return enif_make_badarg(env);
-    // get bundle_trytes
-    tryte_t const *bundle_trytes = (tryte_t const *)in.data;
-      bundle_transactions_new(&bundle);
-    for(int tx_index = 0; tx_index < tx_count; ++tx_index, bundle_trytes += 2673)
+    if(bundle_view_init(&bundle, (tryte_t const *)in.data, in.size) != RC_OK || bundle.size != (size_t)tx_count)
+      return enif_make_badarg(env);
+
+    // validate bundle, the signature fragments are spread over the pool
+    if((ctx = get_context()) == NULL ||
+        bundle_validation_pool_validate_views(&bundle_pool, &bundle, 1, &bundle_status, &ctx->bundle_scratch) != RC_OK)
+    {
+      bundle_status = BUNDLE_NOT_INITIALIZED;
+    }
+    return bundle_status == BUNDLE_VALID ? atom_true : atom_false;
+}
+
+// args: [tryte_t const bundle_trytes[2673 * tx_count]], returns [bool]
+// validates all the bundles in one go, the signature fragments of all of them are spread over the pool
+static ERL_NIF_TERM
+validate_bundles_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    unsigned int bundles_count;
+    ERL_NIF_TERM list, head;
+    ErlNifBinary in;
+    NifContext *ctx; // the arrays and scratch buffers are reused across calls
+    size_t bundle_index = 0, views_count = 0;
+    if(argc != 1 || !enif_get_list_length(env, argv[0], &bundles_count))
+    {
+        return enif_make_badarg(env);
+    }
+    if(bundles_count == 0)
+    {
+        return enif_make_list(env, 0);
+    }
+    if((ctx = get_context()) == NULL || !context_reserve_bundles(ctx, bundles_count))
+    {
+        return enif_make_badarg(env);
+    }
+    // view the well-formed bundles in place, packed at the front of ctx->bundles,
+    // a malformed one is false without failing the others
+    for(list = argv[0]; enif_get_list_cell(env, list, &head, &list); ++bundle_index)
+    {
+      if(enif_inspect_binary(env, head, &in) &&
+          bundle_view_init(&ctx->bundles[views_count], (tryte_t const *)in.data, in.size) == RC_OK)
+      {
+        ctx->results[bundle_index] = atom_true; // replaced by the status of its view below
+        views_count++;
+      }
+      else
+      {
+        ctx->results[bundle_index] = atom_false;
+      }
+    }
+    if(views_count > 0 && bundle_validation_pool_validate_views(&bundle_pool, ctx->bundles, views_count,
+        ctx->statuses, &ctx->bundle_scratch) != RC_OK)
+    {
+      memset(ctx->statuses, 0, views_count * sizeof(bundle_status_t)); // BUNDLE_NOT_INITIALIZED
+    }
+    views_count = 0;
+    for(size_t i = 0; i < bundles_count; ++i)
+    {
+      if(ctx->results[i] == atom_true)
+      {
+        ctx->results[i] = ctx->statuses[views_count++] == BUNDLE_VALID ? atom_true : atom_false;
+      }
+    }
+    return enif_make_list_from_array(env, ctx->results, bundles_count);
+}
+
+// numeric fields with more significant trytes may not fit an int64 (27^13 / 2 < 2^63)
+#define FIELD_LONG_MAX_TRYTES 13
+// fields of a decoded transaction, in serialized order
+#define TX_FIELDS_COUNT 15
+
+// decode the balanced numeric field trytes[length], nil when it doesn't fit an
+// int64 (only a malformed value can), 0 when it holds a non tryte char
+static int
+make_field_long(ErlNifEnv* env, tryte_t const* trytes, size_t length, ERL_NIF_TERM* field)
+{
+    size_t significant = length;
+    for(size_t i = 0; i < length; ++i)
+    {
+      if(trytes[i] != '9' && (trytes[i] < 'A' || trytes[i] > 'Z'))
+      {
+        return 0;
+      }
+    }
+    while(significant > 0 && trytes[significant - 1] == '9')
+    {
+      significant--;
+    }
+    *field = significant > FIELD_LONG_MAX_TRYTES ?
+        atom_nil : enif_make_int64(env, transaction_view_long(trytes, significant));
+    return 1;
+}
+
+// decode the 2673 trytes at offset of bin (in) into a tuple of its fields, the trytes
+// fields are sub binaries of bin (no copy) and the numeric ones integers, 0 if malformed
+static int
+make_tx_fields_at(ErlNifEnv* env, ERL_NIF_TERM bin, ErlNifBinary const* in, size_t offset, ERL_NIF_TERM* tuple)
+{
+    iota_transaction_view_t tx;
+    ERL_NIF_TERM fields[TX_FIELDS_COUNT];
+    if(offset + NUM_TRYTES_SERIALIZED_TRANSACTION > in->size)
+    {
+      return 0;
+    }
+    tx.trytes = (tryte_t const *)in->data + offset;
+    fields[0] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_SIGNATURE, NUM_TRYTES_SIGNATURE);
+    fields[1] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_ADDRESS, NUM_TRYTES_ADDRESS);
+    fields[3] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_OBSOLETE_TAG, NUM_TRYTES_OBSOLETE_TAG);
+    fields[7] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_BUNDLE, NUM_TRYTES_BUNDLE);
+    fields[8] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_TRUNK, NUM_TRYTES_TRUNK);
+    fields[9] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_BRANCH, NUM_TRYTES_BRANCH);
+    fields[10] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_TAG, NUM_TRYTES_TAG);
+    fields[14] = enif_make_sub_binary(env, bin, offset + TRANSACTION_VIEW_OFFSET_NONCE, NUM_TRYTES_NONCE);
+    if(!(make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_VALUE], NUM_TRYTES_VALUE, &fields[2]) &&
+        make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_TIMESTAMP], NUM_TRYTES_TIMESTAMP, &fields[4]) &&
+        make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_CURRENT_INDEX], NUM_TRYTES_CURRENT_INDEX,
+            &fields[5]) &&
+        make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_LAST_INDEX], NUM_TRYTES_LAST_INDEX, &fields[6]) &&
+        make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP],
+            NUM_TRYTES_ATTACHMENT_TIMESTAMP, &fields[11]) &&
+        make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_LOWER],
+            NUM_TRYTES_ATTACHMENT_TIMESTAMP_LOWER, &fields[12]) &&
+        make_field_long(env, &tx.trytes[TRANSACTION_VIEW_OFFSET_ATTACHMENT_TIMESTAMP_UPPER],
+            NUM_TRYTES_ATTACHMENT_TIMESTAMP_UPPER, &fields[13])))
+    {
+      return 0;
+    }
+    *tuple = enif_make_tuple_from_array(env, fields, TX_FIELDS_COUNT);
+    return 1;
+}
+
+// decode a binary of exactly 2673 trytes
+static int
+make_tx_fields(ErlNifEnv* env, ERL_NIF_TERM bin, ERL_NIF_TERM* tuple)
+{
+    ErlNifBinary in;
+    return enif_inspect_binary(env, bin, &in) && in.size == NUM_TRYTES_SERIALIZED_TRANSACTION &&
+        make_tx_fields_at(env, bin, &in, 0, tuple);
+}
+
+// args: tryte_t const tx_trytes[2673], returns the tuple of its fields
+// cheap enough (about a microsecond) to always run on the calling scheduler
+static ERL_NIF_TERM
+decode_transaction(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    ERL_NIF_TERM tuple;
+    if(argc != 1 || !make_tx_fields(env, argv[0], &tuple))
+    {
+        return enif_make_badarg(env);
+    }
+    return tuple;
+}
+
+// args: [tryte_t const tx_trytes[2673]], returns [fields tuple] in the same order
+static ERL_NIF_TERM
+decode_transactions_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    unsigned int txs_count;
+    ERL_NIF_TERM list, head, tail = enif_make_list(env, 0), tuple;
+    ERL_NIF_TERM *tuples;
+    size_t tx_index = 0;
+    if(argc != 1 || !enif_get_list_length(env, argv[0], &txs_count))
+    {
+        return enif_make_badarg(env);
+    }
+    if(txs_count == 0)
+    {
+        return tail;
+    }
+    if((tuples = enif_alloc(txs_count * sizeof(ERL_NIF_TERM))) == NULL)
+    {
+        return enif_make_badarg(env);
+    }
+    for(list = argv[0]; enif_get_list_cell(env, list, &head, &list); ++tx_index)
+    {
+      if(!make_tx_fields(env, head, &tuple))
+      {
+        enif_free(tuples);
+        return enif_make_badarg(env);
+      }
+      tuples[tx_index] = tuple;
+    }
+    tail = enif_make_list_from_array(env, tuples, txs_count);
+    enif_free(tuples);
+    return tail;
+}
+
+// args: binary path, returns {:ok, reader} | {:error, retcode}
+// maps the dump in memory, its pages are only read when chunks are taken
+static ERL_NIF_TERM
+dmp_open(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    ErlNifBinary in;
+    char path[PATH_MAX];
+    DmpRes* res;
+    ERL_NIF_TERM term;
+    retcode_t ret;
+    if(argc != 1 || !enif_inspect_binary(env, argv[0], &in) || in.size >= sizeof(path))
+    {
+        return enif_make_badarg(env);
+    }
+    memcpy(path, in.data, in.size);
+    path[in.size] = '\0';
+    if((res = enif_alloc_resource(DMP_RES_TYPE, sizeof(DmpRes))) == NULL)
+    {
+        return enif_make_badarg(env);
+    }
+    dmp_reader_init(&res->reader, NULL, 0);
+    if((res->lock = enif_mutex_create("nifs_dmp_reader_lock")) == NULL)
     {
-          
-      flex_trit_t trits[FLEX_TRIT_SIZE_8019];
-  flex_trits_from_trytes(trits, NUM_TRITS_SERIALIZED_TRANSACTION, (tryte_t *)bundle_trytes, NUM_TRITS_SERIALIZED_TRANSACTION,
-    NUM_TRYTES_SERIALIZED_TRANSACTION);
-      iota_transaction_t *tx = transaction_deserialize(trits, false); 
-     
-      bundle_transactions_add(bundle,tx); // add tx into bundle
+        enif_release_resource(res);
+        return enif_make_badarg(env);
+    }
+    if((ret = dmp_reader_open(&res->reader, path)) != RC_OK)
+    {
+        enif_release_resource(res);
+        return enif_make_tuple2(env, atom_error, enif_make_int(env, ret));
+    }
+    term = enif_make_resource(env, res);
+    enif_release_resource(res);
+    return enif_make_tuple2(env, atom_ok, term);
+}
+
+// args: DmpRes reader, int max_txs, returns {chunk, txs_count} | :eof | {:error, retcode}
+// the chunk holds whole bundles and is a binary over the mapped dump (no copy),
+// callers can take chunks concurrently and decode them in parallel
+static ERL_NIF_TERM
+dmp_next_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    DmpRes* res;
+    unsigned int max_txs;
+    char const* chunk;
+    size_t length, txs_count;
+    retcode_t ret;
+    if(argc != 2 || !enif_get_resource(env, argv[0], DMP_RES_TYPE, (void**) &res) ||
+        !enif_get_uint(env, argv[1], &max_txs))
+    {
+        return enif_make_badarg(env);
+    }
+    enif_mutex_lock(res->lock);
+    ret = dmp_reader_next_chunk(&res->reader, max_txs, &chunk, &length, &txs_count);
+    enif_mutex_unlock(res->lock);
+    if(ret != RC_OK)
+    {
+        return enif_make_tuple2(env, atom_error, enif_make_int(env, ret));
+    }
+    if(length == 0)
+    {
+        return atom_eof;
+    }
+    return enif_make_tuple2(env, enif_make_resource_binary(env, res, chunk, length),
+        enif_make_uint64(env, txs_count));
+}
+
+// args: chunk of dmp_next, returns [{valid, [{hash, trytes, fields, snapshot_index}]}],
+// a tuple per bundle, valid when the hashes of all its txs match, fields as decode_transaction
+// and snapshot_index nil when the lines have none. the hashes are verified in wide ptrit batches
+static ERL_NIF_TERM
+dmp_decode_run(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    ErlNifBinary in;
+    NifContext* ctx;
+    dmp_tx_t const* tx;
+    ERL_NIF_TERM fields, snapshot_index;
+    size_t count, capacity, size, offset, bundles = 0;
+    bool valid;
+    if(argc != 1 || !enif_inspect_binary(env, argv[0], &in))
+    {
+        return enif_make_badarg(env);
+    }
+    // a line is at least DMP_LINE_MIN_LENGTH long
+    capacity = in.size / DMP_LINE_MIN_LENGTH;
+    if((ctx = get_context()) == NULL || !context_reserve_dmp(ctx, capacity) ||
+        dmp_chunk_parse((char const *)in.data, in.size, ctx->dmp_txs, capacity, &count) != RC_OK)
+    {
+        return enif_make_badarg(env);
+    }
+    dmp_txs_verify(ctx->dmp_hasher, ctx->dmp_txs, count);
+    // the rows of a bundle are listed, then the bundle takes the place of an
+    // already listed row (there are fewer bundles than txs)
+    for(size_t i = 0; i < count; i += size)
+    {
+      size = dmp_txs_bundle_size(&ctx->dmp_txs[i], count - i);
+      valid = true;
+      for(size_t j = i; j < i + size; ++j)
+      {
+        tx = &ctx->dmp_txs[j];
+        offset = (unsigned char const *)tx->hash - in.data;
+        if(!make_tx_fields_at(env, argv[0], &in, offset + DMP_LINE_OFFSET_TRYTES, &fields))
+        {
+          return enif_make_badarg(env);
+        }
+        snapshot_index = tx->snapshot_index < 0 ? atom_nil : enif_make_int64(env, tx->snapshot_index);
+        ctx->dmp_terms[j] = enif_make_tuple4(env, enif_make_sub_binary(env, argv[0], offset, NUM_TRYTES_HASH),
+            enif_make_sub_binary(env, argv[0], offset + DMP_LINE_OFFSET_TRYTES, NUM_TRYTES_SERIALIZED_TRANSACTION),
+            fields, snapshot_index);
+        valid = valid && tx->valid;
+      }
+      ctx->dmp_terms[bundles++] = enif_make_tuple2(env, valid ? atom_true : atom_false,
+          enif_make_list_from_array(env, &ctx->dmp_terms[i], size));
+    }
+    return enif_make_list_from_array(env, ctx->dmp_terms, bundles);
+}
+
+// put key => value in map
+static ERL_NIF_TERM
+map_put_uint64(ErlNifEnv* env, ERL_NIF_TERM map, const char* key, uint64_t value)
+{
+    ERL_NIF_TERM out = map;
+    enif_make_map_put(env, map, enif_make_atom(env, key), enif_make_uint64(env, value), &out);
+    return out;
+}
 
-      transaction_free(tx); // free transaction
+// put the counters of a resource state pool in map, keys are prefixed with its name
+static ERL_NIF_TERM
+map_put_pool(ErlNifEnv* env, ERL_NIF_TERM map, NifPool const* pool)
+{
+    char key[32];
+    snprintf(key, sizeof(key), "%s_states", pool->name);
+    map = map_put_uint64(env, map, key, pool->blocks);
+    snprintf(key, sizeof(key), "%s_in_use", pool->name);
+    map = map_put_uint64(env, map, key, pool->in_use);
+    snprintf(key, sizeof(key), "%s_reuses", pool->name);
+    return map_put_uint64(env, map, key, pool->reuses);
+}
 
+// returns the contexts and pools counters as a map, the per thread counters
+// are read while their threads may update them so they are approximate
+static ERL_NIF_TERM
+context_stats(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    ERL_NIF_TERM map = enif_make_new_map(env);
+    NifContext const* ctx;
+    uint64_t calls = 0, scratch_bytes = 0, scratch_grows = 0;
+    if(argc != 0)
+    {
+        return enif_make_badarg(env);
+    }
+    enif_mutex_lock(context_lock);
+    for(ctx = contexts; ctx != NULL; ctx = ctx->next)
+    {
+      calls += ctx->calls;
+      scratch_bytes += sizeof(NifContext) + bundle_validation_scratch_size(&ctx->bundle_scratch) +
+          ctx->bundles_capacity * (sizeof(bundle_view_t) + sizeof(bundle_status_t) + sizeof(ERL_NIF_TERM)) +
+          (ctx->dmp_hasher != NULL ? sizeof(dmp_hasher_t) : 0) +
+          ctx->dmp_capacity * (sizeof(dmp_tx_t) + sizeof(ERL_NIF_TERM));
+      scratch_grows += ctx->bundle_scratch.grows;
     }
+    map = map_put_uint64(env, map, "contexts", contexts_count);
+    map = map_put_uint64(env, map, "context_calls", calls);
+    map = map_put_uint64(env, map, "context_bytes", scratch_bytes);
+    map = map_put_uint64(env, map, "bundle_scratch_grows", scratch_grows);
+    map = map_put_pool(env, map, &curl_pool);
+    map = map_put_pool(env, map, &job_pool);
+    enif_mutex_unlock(context_lock);
+    return map;
+}
 
-	//validate bundle
-    if ((res = bundle_validate(bundle, &bundle_status)) == RC_OK && bundle_status == BUNDLE_VALID) {
-      bundle_transactions_free(&bundle); // free bundle
-      return atom_true;
-    } else {
-      bundle_transactions_free(&bundle); // free bundle
-      return atom_false;
+// args: PECurl *pecurl
+static ERL_NIF_TERM
+absorb(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    return schedule(env, "absorb", absorb_run, argc, argv);
 }
-	
+
+// args: PECurl *pecurl
+static ERL_NIF_TERM
+squeeze(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    return schedule(env, "squeeze", squeeze_run, argc, argv);
 }
 
+// args: int tx_count, tryte_t const bundle_trytes[2673 * tx_count]
+static ERL_NIF_TERM
+validate_bundle(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    return schedule(env, "validate_bundle", validate_bundle_run, argc, argv);
+}
+
+// args: [tryte_t const bundle_trytes[2673 * tx_count]]
+static ERL_NIF_TERM
+validate_bundles(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    return schedule(env, "validate_bundles", validate_bundles_run, argc, argv);
+}
+
+// args: [tryte_t const tx_trytes[2673]], short lists are decoded on the calling scheduler
+static ERL_NIF_TERM
+decode_transactions(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    unsigned int txs_count;
+    if(argc == 1 && enif_get_list_length(env, argv[0], &txs_count) && txs_count <= DECODE_NORMAL_MAX_TXS)
+    {
+        return decode_transactions_run(env, argc, argv);
+    }
+    return schedule(env, "decode_transactions", decode_transactions_run, argc, argv);
+}
+
+// args: DmpRes reader, int max_txs
+// the first read of the pages of a chunk may wait for the disk, it runs on a dirty io scheduler
+static ERL_NIF_TERM
+dmp_next(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    return enif_schedule_nif(env, "dmp_next", ERL_NIF_DIRTY_JOB_IO_BOUND, dmp_next_run, argc, argv);
+}
+
+// args: chunk of dmp_next
+static ERL_NIF_TERM
+dmp_decode(ErlNifEnv* env, int argc, const ERL_NIF_TERM argv[])
+{
+    return schedule(env, "dmp_decode", dmp_decode_run, argc, argv);
+}
 
 static ErlNifFunc nif_funcs[] = {
     {"curl_p_init", 0, curl_p_81_init_nif},
@@ -274,7 +1242,15 @@ static ErlNifFunc nif_funcs[] = {
     {"squeeze", 1, squeeze},
     {"add_trytes", 3, add_trytes},
     {"validate_bundle",2, validate_bundle},
-    {"get_status", 3, get_trytes_and_cmp_hashes}
+    {"get_status", 3, get_trytes_and_cmp_hashes},
+    {"hash_and_verify", 2, hash_and_verify},
+    {"validate_bundles", 1, validate_bundles},
+    {"context_stats", 0, context_stats},
+    {"decode_transaction", 1, decode_transaction},
+    {"decode_transactions", 1, decode_transactions},
+    {"dmp_open", 1, dmp_open},
+    {"dmp_next", 2, dmp_next},
+    {"dmp_decode", 1, dmp_decode}
 };
 
-ERL_NIF_INIT(Elixir.Nifs, nif_funcs, &load, &reload, &upgrade, NULL);
+ERL_NIF_INIT(Elixir.Nifs, nif_funcs, &load, &reload, &upgrade, &unload);
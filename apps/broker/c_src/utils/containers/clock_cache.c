@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/containers/clock_cache.h"
+
+// Shard picked by the high bits of a key so that they don't correlate with the slot picked by the low bits
+#define SHARD_SHIFT 48
+
+/*
+ * Private functions
+ */
+
+static inline clock_cache_shard_t *shard_of(clock_cache_t const *const cache, uint64_t const key) {
+  return &cache->shards[(key >> SHARD_SHIFT) & (cache->shards_num - 1)];
+}
+
+static inline clock_cache_entry_t *entry_at(clock_cache_t const *const cache, clock_cache_shard_t const *const shard,
+                                            size_t const index) {
+  return (clock_cache_entry_t *)(shard->entries + index * cache->stride);
+}
+
+static inline void *value_of(clock_cache_entry_t *const entry) { return (char *)entry + sizeof(clock_cache_entry_t); }
+
+static retcode_t shard_init(clock_cache_t const *const cache, clock_cache_shard_t *const shard,
+                            size_t const capacity) {
+  size_t slots_num = 1;
+
+  // Keeps the index at most half full
+  while (slots_num < 2 * capacity) {
+    slots_num <<= 1;
+  }
+
+  memset(shard, 0, sizeof(clock_cache_shard_t));
+  if ((shard->entries = calloc(capacity == 0 ? 1 : capacity, cache->stride)) == NULL ||
+      (shard->slots = calloc(slots_num, sizeof(uint32_t))) == NULL) {
+    free(shard->entries);
+    return RC_OOM;
+  }
+  shard->slots_mask = slots_num - 1;
+  shard->capacity = capacity;
+  lock_handle_init(&shard->lock);
+
+  return RC_OK;
+}
+
+static void shard_destroy(clock_cache_shard_t *const shard) {
+  lock_handle_destroy(&shard->lock);
+  free(shard->entries);
+  free(shard->slots);
+}
+
+/**
+ * Finds the slot of a key and id, or the free slot ending its probe sequence
+ */
+static inline size_t shard_find_slot(clock_cache_t const *const cache, clock_cache_shard_t const *const shard,
+                                     uint64_t const key, void const *const id) {
+  size_t slot = key & shard->slots_mask;
+  clock_cache_entry_t *entry = NULL;
+
+  while (shard->slots[slot] != 0) {
+    entry = entry_at(cache, shard, shard->slots[slot] - 1);
+    if (entry->key == key && (cache->id_size == 0 || memcmp(value_of(entry), id, cache->id_size) == 0)) {
+      break;
+    }
+    slot = (slot + 1) & shard->slots_mask;
+  }
+
+  return slot;
+}
+
+/**
+ * Frees the slot of an entry, shifting back the following entries of the probe sequence so that no tombstone is needed
+ */
+static void shard_remove_slot(clock_cache_t const *const cache, clock_cache_shard_t *const shard,
+                              clock_cache_entry_t *const entry) {
+  size_t hole = shard_find_slot(cache, shard, entry->key, value_of(entry));
+  size_t slot = hole;
+  size_t home = 0;
+
+  for (;;) {
+    slot = (slot + 1) & shard->slots_mask;
+    if (shard->slots[slot] == 0) {
+      break;
+    }
+    home = entry_at(cache, shard, shard->slots[slot] - 1)->key & shard->slots_mask;
+    // The entry may move back unless its home lies cyclically in (hole, slot]
+    if (hole <= slot ? (home <= hole || home > slot) : (home <= hole && home > slot)) {
+      shard->slots[hole] = shard->slots[slot];
+      hole = slot;
+    }
+  }
+  shard->slots[hole] = 0;
+}
+
+/**
+ * Advances the CLOCK hand past referenced entries, clearing their bit, and returns the first unreferenced one
+ */
+static size_t shard_evict(clock_cache_t const *const cache, clock_cache_shard_t *const shard) {
+  clock_cache_entry_t *entry = NULL;
+  size_t victim = 0;
+
+  while ((entry = entry_at(cache, shard, shard->hand))->referenced) {
+    entry->referenced = false;
+    shard->hand = (shard->hand + 1) % shard->capacity;
+  }
+  victim = shard->hand;
+  shard->hand = (shard->hand + 1) % shard->capacity;
+  shard_remove_slot(cache, shard, entry);
+  shard->eviction++;
+
+  return victim;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t clock_cache_init(clock_cache_t *const cache, size_t const capacity, size_t const value_size,
+                           size_t const id_size, size_t const max_shards) {
+  retcode_t ret = RC_OK;
+
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  } else if (id_size > value_size || max_shards == 0) {
+    return RC_INVALID_PARAM;
+  }
+
+  cache->capacity = capacity;
+  cache->value_size = value_size;
+  cache->id_size = id_size;
+  cache->stride = (sizeof(clock_cache_entry_t) + value_size + sizeof(uint64_t) - 1) & ~(sizeof(uint64_t) - 1);
+  cache->shards_num = 1;
+  while (cache->shards_num < max_shards && capacity / (cache->shards_num * 2) >= CLOCK_CACHE_MIN_SHARD_CAPACITY) {
+    cache->shards_num <<= 1;
+  }
+
+  if ((cache->shards = calloc(cache->shards_num, sizeof(clock_cache_shard_t))) == NULL) {
+    return RC_OOM;
+  }
+
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    if ((ret = shard_init(cache, &cache->shards[i],
+                          capacity / cache->shards_num + (i < capacity % cache->shards_num ? 1 : 0))) != RC_OK) {
+      while (i-- > 0) {
+        shard_destroy(&cache->shards[i]);
+      }
+      free(cache->shards);
+      cache->shards = NULL;
+      return ret;
+    }
+  }
+
+  return RC_OK;
+}
+
+retcode_t clock_cache_destroy(clock_cache_t *const cache) {
+  if (cache == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  for (size_t i = 0; i < cache->shards_num && cache->shards; i++) {
+    shard_destroy(&cache->shards[i]);
+  }
+  free(cache->shards);
+  cache->shards = NULL;
+  cache->shards_num = 0;
+
+  return RC_OK;
+}
+
+retcode_t clock_cache_get(clock_cache_t *const cache, uint64_t const key, void const *const id, void *const value,
+                          bool *const found) {
+  clock_cache_shard_t *shard = NULL;
+  clock_cache_entry_t *entry = NULL;
+  size_t slot = 0;
+
+  if (cache == NULL || (id == NULL && cache->id_size != 0) || value == NULL || found == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  shard = shard_of(cache, key);
+  lock_handle_lock(&shard->lock);
+
+  slot = shard_find_slot(cache, shard, key, id);
+  if ((*found = shard->slots[slot] != 0)) {
+    entry = entry_at(cache, shard, shard->slots[slot] - 1);
+    memcpy(value, value_of(entry), cache->value_size);
+    entry->referenced = true;
+    shard->hit++;
+  } else {
+    shard->miss++;
+  }
+
+  lock_handle_unlock(&shard->lock);
+
+  return RC_OK;
+}
+
+retcode_t clock_cache_put(clock_cache_t *const cache, uint64_t const key, void const *const value) {
+  clock_cache_shard_t *shard = NULL;
+  clock_cache_entry_t *entry = NULL;
+  size_t index = 0;
+
+  if (cache == NULL || value == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  shard = shard_of(cache, key);
+  lock_handle_lock(&shard->lock);
+
+  if (shard->capacity == 0 || shard->slots[shard_find_slot(cache, shard, key, value)] != 0) {
+    goto done;
+  }
+
+  index = shard->size < shard->capacity ? shard->size++ : shard_evict(cache, shard);
+  entry = entry_at(cache, shard, index);
+  entry->key = key;
+  entry->referenced = false;
+  memcpy(value_of(entry), value, cache->value_size);
+  // Probing again as an eviction may have shifted the probe sequence
+  shard->slots[shard_find_slot(cache, shard, key, value)] = index + 1;
+
+done:
+  lock_handle_unlock(&shard->lock);
+
+  return RC_OK;
+}
+
+size_t clock_cache_size(clock_cache_t *const cache) {
+  size_t size = 0;
+
+  if (cache == NULL) {
+    return 0;
+  }
+
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    lock_handle_lock(&cache->shards[i].lock);
+    size += cache->shards[i].size;
+    lock_handle_unlock(&cache->shards[i].lock);
+  }
+
+  return size;
+}
+
+retcode_t clock_cache_stats(clock_cache_t *const cache, clock_cache_stats_t *const stats) {
+  clock_cache_shard_t *shard = NULL;
+
+  if (cache == NULL || stats == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  memset(stats, 0, sizeof(clock_cache_stats_t));
+  stats->capacity = cache->capacity;
+  stats->shards = cache->shards_num;
+  for (size_t i = 0; i < cache->shards_num; i++) {
+    shard = &cache->shards[i];
+    lock_handle_lock(&shard->lock);
+    stats->size += shard->size;
+    stats->hit += shard->hit;
+    stats->miss += shard->miss;
+    stats->eviction += shard->eviction;
+    lock_handle_unlock(&shard->lock);
+  }
+
+  return RC_OK;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifndef __UTILS_CONTAINERS_CLOCK_CACHE_H__
+#define __UTILS_CONTAINERS_CLOCK_CACHE_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "common/errors.h"
+#include "utils/handles/lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A cache only gets sharded as long as every shard keeps at least this many entries
+#define CLOCK_CACHE_MIN_SHARD_CAPACITY 64
+#define CLOCK_CACHE_CACHE_LINE 64
+
+typedef struct clock_cache_entry_s {
+  uint64_t key;
+  // CLOCK reference bit, set by hits and cleared by the passing hand
+  bool referenced;
+  // Followed by the value
+} clock_cache_entry_t;
+
+typedef struct clock_cache_shard_s {
+  lock_handle_t lock;
+  // Entries in insertion slots, swept by the CLOCK hand once full
+  char *entries;
+  // Open addressed index of the entries by key, linear probing, holding entry index + 1 or 0 if free
+  uint32_t *slots;
+  size_t slots_mask;
+  size_t capacity;
+  size_t size;
+  size_t hand;
+  uint64_t hit;
+  uint64_t miss;
+  uint64_t eviction;
+  // Keeps neighbouring shard locks off each other's cache line
+  char pad[CLOCK_CACHE_CACHE_LINE];
+} clock_cache_shard_t;
+
+/**
+ * A fixed capacity cache of values by 64 bits key, lock striped across shards picked by key and evicting with CLOCK.
+ * Values are copied in and out. Entries of colliding keys are told apart by the first id_size bytes of their values.
+ */
+typedef struct clock_cache_s {
+  clock_cache_shard_t *shards;
+  size_t shards_num;
+  size_t capacity;
+  size_t value_size;
+  size_t id_size;
+  // Size of an entry and its value, rounded up to keep entries aligned
+  size_t stride;
+} clock_cache_t;
+
+typedef struct clock_cache_stats_s {
+  size_t size;
+  size_t capacity;
+  size_t shards;
+  uint64_t hit;
+  uint64_t miss;
+  uint64_t eviction;
+} clock_cache_stats_t;
+
+/**
+ * Initializes a cache
+ *
+ * @param cache The cache
+ * @param capacity The maximum number of values, 0 disabling the cache
+ * @param value_size The size of a value
+ * @param id_size The size of the prefix of a value identifying it among the values of the same key, 0 if keys are
+ * unique
+ * @param max_shards Upper bound on the number of shards, a power of 2
+ *
+ * @return a status code
+ */
+retcode_t clock_cache_init(clock_cache_t *const cache, size_t const capacity, size_t const value_size,
+                           size_t const id_size, size_t const max_shards);
+
+/**
+ * Destroys a cache
+ *
+ * @param cache The cache
+ *
+ * @return a status code
+ */
+retcode_t clock_cache_destroy(clock_cache_t *const cache);
+
+/**
+ * Gets a value from a cache
+ *
+ * @param cache The cache
+ * @param key The key
+ * @param id The id_size bytes identifying the value, may be NULL if id_size is 0
+ * @param value To be filled with the value
+ * @param found Whether the value was in the cache
+ *
+ * @return a status code
+ */
+retcode_t clock_cache_get(clock_cache_t *const cache, uint64_t const key, void const *const id, void *const value,
+                          bool *const found);
+
+/**
+ * Puts a value in a cache if it isn't in yet, evicting another value if full
+ *
+ * @param cache The cache
+ * @param key The key
+ * @param value The value, starting with the id_size bytes identifying it
+ *
+ * @return a status code
+ */
+retcode_t clock_cache_put(clock_cache_t *const cache, uint64_t const key, void const *const value);
+
+/**
+ * Gives the number of values in a cache
+ *
+ * @param cache The cache
+ *
+ * @return the number of values
+ */
+size_t clock_cache_size(clock_cache_t *const cache);
+
+/**
+ * Sums the counters of all shards of a cache
+ *
+ * @param cache The cache
+ * @param stats The counters
+ *
+ * @return a status code
+ */
+retcode_t clock_cache_stats(clock_cache_t *const cache, clock_cache_stats_t *const stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_CONTAINERS_CLOCK_CACHE_H__
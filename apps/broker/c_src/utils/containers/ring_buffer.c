@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/containers/ring_buffer.h"
+
+// A slot starts with its sequence number and its position while reserved, the element follows aligned on 16 bytes
+#define RING_BUFFER_SLOT_HEADER 16
+
+/*
+ * Private functions
+ */
+
+static inline char *slot_at(ring_buffer_t const *const ring, size_t const pos) {
+  return ring->slots + (pos & ring->mask) * ring->stride;
+}
+
+static inline atomic_size_t *slot_sequence(char *const slot) { return (atomic_size_t *)slot; }
+
+static inline size_t *slot_position(char *const slot) { return (size_t *)(slot + sizeof(atomic_size_t)); }
+
+static inline bool head_ready(ring_buffer_t *const ring) {
+  size_t const pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+
+  return atomic_load_explicit(slot_sequence(slot_at(ring, pos)), memory_order_acquire) == pos + 1;
+}
+
+/*
+ * Public functions
+ */
+
+retcode_t ring_buffer_init(ring_buffer_t *const ring, size_t const element_size, size_t const capacity,
+                           ring_buffer_producers_t const producers) {
+  size_t size = 2;
+
+  if (ring == NULL) {
+    return RC_NULL_PARAM;
+  }
+  if (element_size == 0 || capacity == 0) {
+    return RC_INVALID_PARAM;
+  }
+
+  while (size < capacity) {
+    size <<= 1;
+  }
+  ring->mask = size - 1;
+  ring->element_size = element_size;
+  ring->stride = RING_BUFFER_SLOT_HEADER + ((element_size + 15) & ~(size_t)15);
+  ring->producers = producers;
+  if ((ring->slots = (char *)malloc(size * ring->stride)) == NULL) {
+    return RC_OOM;
+  }
+  // The slot of position i is free for the producer of position i
+  for (size_t i = 0; i < size; i++) {
+    atomic_init(slot_sequence(slot_at(ring, i)), i);
+  }
+  atomic_init(&ring->enqueue_pos, 0);
+  atomic_init(&ring->dequeue_pos, 0);
+
+  atomic_init(&ring->sleeping, false);
+  ring->woken = false;
+  lock_handle_init(&ring->lock);
+  cond_handle_init(&ring->cond);
+
+  return RC_OK;
+}
+
+void ring_buffer_destroy(ring_buffer_t *const ring) {
+  if (ring == NULL || ring->slots == NULL) {
+    return;
+  }
+
+  free(ring->slots);
+  ring->slots = NULL;
+  lock_handle_destroy(&ring->lock);
+  cond_handle_destroy(&ring->cond);
+}
+
+retcode_t ring_buffer_reserve(ring_buffer_t *const ring, void **const element) {
+  size_t pos = 0;
+  char *slot = NULL;
+  intptr_t diff = 0;
+
+  if (ring == NULL || element == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+  while (true) {
+    slot = slot_at(ring, pos);
+    diff = (intptr_t)atomic_load_explicit(slot_sequence(slot), memory_order_acquire) - (intptr_t)pos;
+    if (diff == 0) {
+      if (ring->producers == RING_BUFFER_SINGLE_PRODUCER) {
+        atomic_store_explicit(&ring->enqueue_pos, pos + 1, memory_order_relaxed);
+        break;
+      } else if (atomic_compare_exchange_weak_explicit(&ring->enqueue_pos, &pos, pos + 1, memory_order_relaxed,
+                                                       memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      // The slot still holds the element of the previous lap
+      return RC_UTILS_RING_BUFFER_FULL;
+    } else {
+      pos = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+    }
+  }
+
+  *slot_position(slot) = pos;
+  *element = slot + RING_BUFFER_SLOT_HEADER;
+
+  return RC_OK;
+}
+
+void ring_buffer_commit(ring_buffer_t *const ring, void *const element) {
+  char *const slot = (char *)element - RING_BUFFER_SLOT_HEADER;
+
+  atomic_store_explicit(slot_sequence(slot), *slot_position(slot) + 1, memory_order_release);
+
+  // Pairs with the fence of ring_buffer_wait(): either the consumer sees the element or we see it sleeping
+  atomic_thread_fence(memory_order_seq_cst);
+  if (atomic_load_explicit(&ring->sleeping, memory_order_relaxed)) {
+    lock_handle_lock(&ring->lock);
+    cond_handle_signal(&ring->cond);
+    lock_handle_unlock(&ring->lock);
+  }
+}
+
+retcode_t ring_buffer_push(ring_buffer_t *const ring, void const *const element) {
+  void *slot = NULL;
+  retcode_t ret = RC_OK;
+
+  if (element == NULL) {
+    return RC_NULL_PARAM;
+  }
+
+  if ((ret = ring_buffer_reserve(ring, &slot)) != RC_OK) {
+    return ret;
+  }
+  memcpy(slot, element, ring->element_size);
+  ring_buffer_commit(ring, slot);
+
+  return RC_OK;
+}
+
+size_t ring_buffer_peek(ring_buffer_t *const ring, void **const elements, size_t const max) {
+  size_t pos = 0, count = 0;
+  char *slot = NULL;
+
+  if (ring == NULL || elements == NULL) {
+    return 0;
+  }
+
+  pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+  for (count = 0; count < max; count++) {
+    slot = slot_at(ring, pos + count);
+    if (atomic_load_explicit(slot_sequence(slot), memory_order_acquire) != pos + count + 1) {
+      break;
+    }
+    elements[count] = slot + RING_BUFFER_SLOT_HEADER;
+  }
+
+  return count;
+}
+
+void ring_buffer_consume(ring_buffer_t *const ring, size_t const count) {
+  size_t pos = 0;
+
+  if (ring == NULL || count == 0) {
+    return;
+  }
+
+  pos = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+  for (size_t i = 0; i < count; i++) {
+    // The slot becomes free for the producer of the next lap
+    atomic_store_explicit(slot_sequence(slot_at(ring, pos + i)), pos + i + ring->mask + 1, memory_order_release);
+  }
+  // Released for ring_buffer_consumed(), the elements having been processed
+  atomic_store_explicit(&ring->dequeue_pos, pos + count, memory_order_release);
+}
+
+size_t ring_buffer_pop(ring_buffer_t *const ring, void *const elements, size_t const max) {
+  void *slots[64];
+  size_t count = 0, batch = 0;
+
+  if (ring == NULL || elements == NULL) {
+    return 0;
+  }
+
+  do {
+    batch = ring_buffer_peek(ring, slots, max - count < 64 ? max - count : 64);
+    for (size_t i = 0; i < batch; i++) {
+      memcpy((char *)elements + (count + i) * ring->element_size, slots[i], ring->element_size);
+    }
+    ring_buffer_consume(ring, batch);
+    count += batch;
+  } while (batch == 64 && count < max);
+
+  return count;
+}
+
+size_t ring_buffer_position(ring_buffer_t *const ring) {
+  if (ring == NULL) {
+    return 0;
+  }
+
+  return atomic_load_explicit(&ring->enqueue_pos, memory_order_acquire);
+}
+
+bool ring_buffer_consumed(ring_buffer_t *const ring, size_t const position) {
+  if (ring == NULL) {
+    return true;
+  }
+
+  // Positions wrap around
+  return (ptrdiff_t)(atomic_load_explicit(&ring->dequeue_pos, memory_order_acquire) - position) >= 0;
+}
+
+size_t ring_buffer_size(ring_buffer_t *const ring) {
+  size_t enqueued = 0, dequeued = 0;
+
+  if (ring == NULL) {
+    return 0;
+  }
+
+  dequeued = atomic_load_explicit(&ring->dequeue_pos, memory_order_relaxed);
+  enqueued = atomic_load_explicit(&ring->enqueue_pos, memory_order_relaxed);
+  if (enqueued <= dequeued) {
+    return 0;
+  }
+
+  return enqueued - dequeued > ring->mask + 1 ? ring->mask + 1 : enqueued - dequeued;
+}
+
+void ring_buffer_wait(ring_buffer_t *const ring) {
+  if (ring == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&ring->lock);
+  atomic_store_explicit(&ring->sleeping, true, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  // Producers signal under the lock, no push can slip between this check and the wait
+  if (!ring->woken && !head_ready(ring)) {
+    cond_handle_wait(&ring->cond, &ring->lock);
+  }
+  atomic_store_explicit(&ring->sleeping, false, memory_order_relaxed);
+  ring->woken = false;
+  lock_handle_unlock(&ring->lock);
+}
+
+void ring_buffer_wake(ring_buffer_t *const ring) {
+  if (ring == NULL) {
+    return;
+  }
+
+  lock_handle_lock(&ring->lock);
+  ring->woken = true;
+  cond_handle_signal(&ring->cond);
+  lock_handle_unlock(&ring->lock);
+}
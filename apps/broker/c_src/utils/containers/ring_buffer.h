@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup utils_containers
+ *
+ * @{
+ *
+ * @file
+ * @brief A bounded lock-free queue of fixed size elements for a single consumer.
+ *
+ * Slots are allocated once at initialization and carry a sequence number telling whether they are free for the
+ * producer of a given position or ready for the consumer, so that pushing and popping never lock. Producers may be
+ * many (MPSC) or a single one (SPSC), which spares the compare-and-swap of the push. A full ring rejects pushes
+ * instead of growing, it's up to the producer to back off.
+ *
+ * The consumer may sleep when the ring is empty: producers only signal it when it actually sleeps.
+ */
+#ifndef __UTILS_CONTAINERS_RING_BUFFER_H__
+#define __UTILS_CONTAINERS_RING_BUFFER_H__
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "common/errors.h"
+#include "utils/handles/cond.h"
+#include "utils/handles/lock.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RING_BUFFER_CACHE_LINE 64
+
+typedef enum ring_buffer_producers_e {
+  RING_BUFFER_MULTI_PRODUCER,
+  RING_BUFFER_SINGLE_PRODUCER,
+} ring_buffer_producers_t;
+
+typedef struct ring_buffer_s {
+  // Producers and consumer positions on their own cache lines
+  atomic_size_t enqueue_pos;
+  char enqueue_pad[RING_BUFFER_CACHE_LINE - sizeof(atomic_size_t)];
+  atomic_size_t dequeue_pos;
+  char dequeue_pad[RING_BUFFER_CACHE_LINE - sizeof(atomic_size_t)];
+  char *slots;
+  size_t mask;
+  size_t stride;
+  size_t element_size;
+  ring_buffer_producers_t producers;
+  // Consumer sleep
+  atomic_bool sleeping;
+  bool woken;
+  lock_handle_t lock;
+  cond_handle_t cond;
+} ring_buffer_t;
+
+/**
+ * @brief Initializes a ring buffer and allocates its slots.
+ *
+ * @param[out] ring The ring buffer.
+ * @param[in] element_size The size of an element.
+ * @param[in] capacity The number of elements, rounded up to a power of 2.
+ * @param[in] producers Whether the ring has one or many producers.
+ * @return #retcode_t
+ */
+retcode_t ring_buffer_init(ring_buffer_t *const ring, size_t const element_size, size_t const capacity,
+                           ring_buffer_producers_t const producers);
+
+/**
+ * @brief Frees the slots of a ring buffer, its elements are dropped.
+ *
+ * @param[in, out] ring The ring buffer.
+ */
+void ring_buffer_destroy(ring_buffer_t *const ring);
+
+/**
+ * @brief Copies an element at the tail of a ring buffer and wakes the consumer if it sleeps.
+ *
+ * @param[in, out] ring The ring buffer.
+ * @param[in] element The element.
+ * @return #retcode_t RC_UTILS_RING_BUFFER_FULL if there is no free slot.
+ */
+retcode_t ring_buffer_push(ring_buffer_t *const ring, void const *const element);
+
+/**
+ * @brief Takes the slot at the tail of a ring buffer for the element to be built in place.
+ *
+ * The consumer doesn't see the element until ring_buffer_commit() is called, which must happen even if building it
+ * failed: a reserved slot can't be given back.
+ *
+ * @param[in, out] ring The ring buffer.
+ * @param[out] element The slot of the element.
+ * @return #retcode_t RC_UTILS_RING_BUFFER_FULL if there is no free slot.
+ */
+retcode_t ring_buffer_reserve(ring_buffer_t *const ring, void **const element);
+
+/**
+ * @brief Publishes an element built in a slot given by ring_buffer_reserve() and wakes the consumer if it sleeps.
+ *
+ * @param[in, out] ring The ring buffer.
+ * @param[in] element The slot of the element.
+ */
+void ring_buffer_commit(ring_buffer_t *const ring, void *const element);
+
+/**
+ * @brief Gives the elements at the head of a ring buffer in place, without removing them. Consumer only.
+ *
+ * The slots stay owned by the consumer until ring_buffer_consume() releases them.
+ *
+ * @param[in] ring The ring buffer.
+ * @param[out] elements The elements.
+ * @param[in] max The maximum number of elements.
+ * @return The number of elements.
+ */
+size_t ring_buffer_peek(ring_buffer_t *const ring, void **const elements, size_t const max);
+
+/**
+ * @brief Releases the slots of elements given by ring_buffer_peek(). Consumer only.
+ *
+ * @param[in, out] ring The ring buffer.
+ * @param[in] count The number of elements, at most the number peeked.
+ */
+void ring_buffer_consume(ring_buffer_t *const ring, size_t const count);
+
+/**
+ * @brief Copies out and removes the elements at the head of a ring buffer. Consumer only.
+ *
+ * @param[in, out] ring The ring buffer.
+ * @param[out] elements Room for max elements.
+ * @param[in] max The maximum number of elements.
+ * @return The number of elements.
+ */
+size_t ring_buffer_pop(ring_buffer_t *const ring, void *const elements, size_t const max);
+
+/**
+ * @brief Gives the position past the elements enqueued so far, including the ones reserved and not committed yet.
+ *
+ * @param[in] ring The ring buffer.
+ * @return The position, to be given to ring_buffer_consumed().
+ */
+size_t ring_buffer_position(ring_buffer_t *const ring);
+
+/**
+ * @brief Tells whether the consumer released all the elements enqueued before a position.
+ *
+ * @param[in] ring The ring buffer.
+ * @param[in] position A position given by ring_buffer_position().
+ * @return true if all the elements before the position were consumed, false otherwise.
+ */
+bool ring_buffer_consumed(ring_buffer_t *const ring, size_t const position);
+
+/**
+ * @brief Gives the number of elements of a ring buffer, exact when producers and consumer are idle.
+ *
+ * @param[in] ring The ring buffer.
+ * @return The number of elements.
+ */
+size_t ring_buffer_size(ring_buffer_t *const ring);
+
+/**
+ * @brief Gives the number of slots of a ring buffer.
+ *
+ * @param[in] ring The ring buffer.
+ * @return The capacity.
+ */
+static inline size_t ring_buffer_capacity(ring_buffer_t const *const ring) { return ring->mask + 1; }
+
+/**
+ * @brief Puts the consumer to sleep until an element is pushed or ring_buffer_wake() is called. Consumer only.
+ *
+ * Returns at once if the ring isn't empty.
+ *
+ * @param[in, out] ring The ring buffer.
+ */
+void ring_buffer_wait(ring_buffer_t *const ring);
+
+/**
+ * @brief Wakes the consumer, e.g. to have it notice a shutdown.
+ *
+ * @param[in, out] ring The ring buffer.
+ */
+void ring_buffer_wake(ring_buffer_t *const ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_CONTAINERS_RING_BUFFER_H__
+
+/** @} */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <string.h>
+#include <unity/unity.h>
+
+#include "utils/containers/clock_cache.h"
+
+typedef struct value_s {
+  char id[8];
+  uint32_t data;
+} value_t;
+
+static clock_cache_t cache;
+
+void setUp(void) {}
+
+void tearDown(void) { TEST_ASSERT(clock_cache_destroy(&cache) == RC_OK); }
+
+void test_clock_cache_init(void) {
+  clock_cache_stats_t stats;
+
+  TEST_ASSERT(clock_cache_init(NULL, 8, sizeof(value_t), 0, 4) == RC_NULL_PARAM);
+  TEST_ASSERT(clock_cache_init(&cache, 8, sizeof(value_t), sizeof(value_t) + 1, 4) == RC_INVALID_PARAM);
+
+  // Only sharded as long as shards hold enough entries
+  TEST_ASSERT(clock_cache_init(&cache, 4 * CLOCK_CACHE_MIN_SHARD_CAPACITY, sizeof(value_t), 0, 16) == RC_OK);
+  TEST_ASSERT(clock_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(4, stats.shards);
+  TEST_ASSERT_EQUAL_INT(4 * CLOCK_CACHE_MIN_SHARD_CAPACITY, stats.capacity);
+  TEST_ASSERT_EQUAL_INT(0, stats.size);
+}
+
+void test_clock_cache_colliding_keys(void) {
+  value_t values[2] = {{.id = "first", .data = 1}, {.id = "second", .data = 2}};
+  char const other[8] = "third";
+  value_t value;
+  bool found = false;
+
+  TEST_ASSERT(clock_cache_init(&cache, 4, sizeof(value_t), sizeof(values[0].id), 1) == RC_OK);
+
+  TEST_ASSERT(clock_cache_put(&cache, 42, &values[0]) == RC_OK);
+  TEST_ASSERT(clock_cache_put(&cache, 42, &values[1]) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(2, clock_cache_size(&cache));
+
+  TEST_ASSERT(clock_cache_get(&cache, 42, values[1].id, &value, &found) == RC_OK);
+  TEST_ASSERT_TRUE(found);
+  TEST_ASSERT_EQUAL_INT(2, value.data);
+  TEST_ASSERT(clock_cache_get(&cache, 42, other, &value, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  TEST_ASSERT(clock_cache_get(&cache, 43, values[0].id, &value, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+}
+
+void test_clock_cache_eviction(void) {
+  value_t value = {.id = "", .data = 0};
+  clock_cache_stats_t stats;
+  bool found = false;
+
+  TEST_ASSERT(clock_cache_init(&cache, 3, sizeof(value_t), 0, 1) == RC_OK);
+
+  for (uint64_t key = 0; key < 3; key++) {
+    value.data = key;
+    TEST_ASSERT(clock_cache_put(&cache, key, &value) == RC_OK);
+  }
+  // Referenced entries are passed over by the hand, the first unreferenced one is evicted
+  TEST_ASSERT(clock_cache_get(&cache, 0, NULL, &value, &found) == RC_OK);
+  TEST_ASSERT(clock_cache_get(&cache, 1, NULL, &value, &found) == RC_OK);
+  value.data = 3;
+  TEST_ASSERT(clock_cache_put(&cache, 3, &value) == RC_OK);
+  TEST_ASSERT(clock_cache_get(&cache, 2, NULL, &value, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+
+  // Their bits were cleared on the way
+  value.data = 4;
+  TEST_ASSERT(clock_cache_put(&cache, 4, &value) == RC_OK);
+  TEST_ASSERT(clock_cache_get(&cache, 0, NULL, &value, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  for (uint64_t key = 1; key < 5; key += key == 1 ? 2 : 1) {
+    TEST_ASSERT(clock_cache_get(&cache, key, NULL, &value, &found) == RC_OK);
+    TEST_ASSERT_TRUE(found);
+    TEST_ASSERT_EQUAL_INT(key, value.data);
+  }
+
+  TEST_ASSERT(clock_cache_stats(&cache, &stats) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(3, stats.size);
+  TEST_ASSERT_EQUAL_INT(2, stats.eviction);
+}
+
+void test_clock_cache_disabled(void) {
+  value_t value = {.id = "", .data = 1};
+  bool found = true;
+
+  TEST_ASSERT(clock_cache_init(&cache, 0, sizeof(value_t), 0, 4) == RC_OK);
+
+  TEST_ASSERT(clock_cache_put(&cache, 1, &value) == RC_OK);
+  TEST_ASSERT(clock_cache_get(&cache, 1, NULL, &value, &found) == RC_OK);
+  TEST_ASSERT_FALSE(found);
+  TEST_ASSERT_EQUAL_INT(0, clock_cache_size(&cache));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_clock_cache_init);
+  RUN_TEST(test_clock_cache_colliding_keys);
+  RUN_TEST(test_clock_cache_eviction);
+  RUN_TEST(test_clock_cache_disabled);
+
+  return UNITY_END();
+}
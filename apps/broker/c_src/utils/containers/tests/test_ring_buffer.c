@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <stdint.h>
+#include <unity/unity.h>
+
+#include "utils/containers/ring_buffer.h"
+#include "utils/handles/thread.h"
+#include "utils/time.h"
+
+#define PRODUCERS_NUM 4
+#define ELEMENTS_NUM 100000
+
+typedef struct element_s {
+  uint32_t producer;
+  uint32_t index;
+  char padding[24];
+} element_t;
+
+typedef struct producer_s {
+  ring_buffer_t *ring;
+  uint32_t id;
+  size_t full;
+} producer_t;
+
+void test_init(void) {
+  ring_buffer_t ring;
+
+  TEST_ASSERT(ring_buffer_init(NULL, sizeof(element_t), 8, RING_BUFFER_MULTI_PRODUCER) == RC_NULL_PARAM);
+  TEST_ASSERT(ring_buffer_init(&ring, 0, 8, RING_BUFFER_MULTI_PRODUCER) == RC_INVALID_PARAM);
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 0, RING_BUFFER_MULTI_PRODUCER) == RC_INVALID_PARAM);
+
+  // Rounded up to a power of 2
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 5, RING_BUFFER_MULTI_PRODUCER) == RC_OK);
+  TEST_ASSERT_EQUAL_INT(8, ring_buffer_capacity(&ring));
+  TEST_ASSERT_EQUAL_INT(0, ring_buffer_size(&ring));
+  ring_buffer_destroy(&ring);
+}
+
+void test_full_and_wrap(void) {
+  ring_buffer_t ring;
+  element_t element = {.producer = 0};
+  element_t popped[8];
+  void *slots[8];
+
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 4, RING_BUFFER_SINGLE_PRODUCER) == RC_OK);
+
+  for (uint32_t lap = 0; lap < 3; lap++) {
+    for (uint32_t i = 0; i < 4; i++) {
+      element.index = lap * 4 + i;
+      TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_OK);
+    }
+    TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_UTILS_RING_BUFFER_FULL);
+    TEST_ASSERT_EQUAL_INT(4, ring_buffer_size(&ring));
+
+    // Peeked slots stay taken until consumed
+    TEST_ASSERT_EQUAL_INT(3, ring_buffer_peek(&ring, slots, 3));
+    TEST_ASSERT_EQUAL_INT(lap * 4, ((element_t *)slots[0])->index);
+    TEST_ASSERT_EQUAL_INT(lap * 4 + 2, ((element_t *)slots[2])->index);
+    ring_buffer_consume(&ring, 1);
+    TEST_ASSERT_EQUAL_INT(3, ring_buffer_size(&ring));
+    TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_OK);
+    TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_UTILS_RING_BUFFER_FULL);
+
+    TEST_ASSERT_EQUAL_INT(4, ring_buffer_pop(&ring, popped, 8));
+    TEST_ASSERT_EQUAL_INT(lap * 4 + 1, popped[0].index);
+    TEST_ASSERT_EQUAL_INT(lap * 4 + 3, popped[2].index);
+    TEST_ASSERT_EQUAL_INT(0, ring_buffer_size(&ring));
+    TEST_ASSERT_EQUAL_INT(0, ring_buffer_pop(&ring, popped, 8));
+  }
+
+  ring_buffer_destroy(&ring);
+}
+
+void test_reserve_commit(void) {
+  ring_buffer_t ring;
+  element_t *reserved[2] = {NULL};
+  element_t popped;
+
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 2, RING_BUFFER_MULTI_PRODUCER) == RC_OK);
+
+  TEST_ASSERT(ring_buffer_reserve(&ring, (void **)&reserved[0]) == RC_OK);
+  TEST_ASSERT(ring_buffer_reserve(&ring, (void **)&reserved[1]) == RC_OK);
+  TEST_ASSERT(ring_buffer_reserve(&ring, (void **)&reserved[1]) == RC_UTILS_RING_BUFFER_FULL);
+
+  // Elements are only seen once committed, in the order of their slots
+  reserved[1]->index = 2;
+  ring_buffer_commit(&ring, reserved[1]);
+  TEST_ASSERT_EQUAL_INT(0, ring_buffer_pop(&ring, &popped, 1));
+  reserved[0]->index = 1;
+  ring_buffer_commit(&ring, reserved[0]);
+  TEST_ASSERT_EQUAL_INT(1, ring_buffer_pop(&ring, &popped, 1));
+  TEST_ASSERT_EQUAL_INT(1, popped.index);
+  TEST_ASSERT_EQUAL_INT(1, ring_buffer_pop(&ring, &popped, 1));
+  TEST_ASSERT_EQUAL_INT(2, popped.index);
+
+  ring_buffer_destroy(&ring);
+}
+
+void test_consumed(void) {
+  ring_buffer_t ring;
+  element_t element = {.producer = 0};
+  void *slots[2];
+  size_t position = 0;
+
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 4, RING_BUFFER_SINGLE_PRODUCER) == RC_OK);
+  TEST_ASSERT_TRUE(ring_buffer_consumed(&ring, ring_buffer_position(&ring)));
+
+  TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_OK);
+  TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_OK);
+  position = ring_buffer_position(&ring);
+  TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_OK);
+  TEST_ASSERT_FALSE(ring_buffer_consumed(&ring, position));
+
+  // Peeked elements are still being processed
+  TEST_ASSERT_EQUAL_INT(2, ring_buffer_peek(&ring, slots, 2));
+  TEST_ASSERT_FALSE(ring_buffer_consumed(&ring, position));
+  ring_buffer_consume(&ring, 1);
+  TEST_ASSERT_FALSE(ring_buffer_consumed(&ring, position));
+  ring_buffer_consume(&ring, 1);
+  TEST_ASSERT_TRUE(ring_buffer_consumed(&ring, position));
+  TEST_ASSERT_FALSE(ring_buffer_consumed(&ring, ring_buffer_position(&ring)));
+
+  ring_buffer_destroy(&ring);
+}
+
+static void *produce(producer_t *const producer) {
+  element_t element = {.producer = producer->id};
+
+  for (element.index = 0; element.index < ELEMENTS_NUM;) {
+    if (ring_buffer_push(producer->ring, &element) == RC_OK) {
+      element.index++;
+    } else {
+      producer->full++;
+    }
+  }
+
+  return NULL;
+}
+
+void test_multi_producer(void) {
+  ring_buffer_t ring;
+  producer_t producers[PRODUCERS_NUM];
+  thread_handle_t threads[PRODUCERS_NUM];
+  uint32_t next[PRODUCERS_NUM] = {0};
+  element_t popped[32];
+  size_t received = 0, count = 0;
+
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 256, RING_BUFFER_MULTI_PRODUCER) == RC_OK);
+  for (uint32_t i = 0; i < PRODUCERS_NUM; i++) {
+    producers[i] = (producer_t){.ring = &ring, .id = i, .full = 0};
+    thread_handle_create(&threads[i], (thread_routine_t)produce, &producers[i]);
+  }
+
+  // Elements of a producer come out in the order it pushed them, none is lost or duplicated
+  while (received < PRODUCERS_NUM * ELEMENTS_NUM) {
+    if ((count = ring_buffer_pop(&ring, popped, 32)) == 0) {
+      ring_buffer_wait(&ring);
+      continue;
+    }
+    for (size_t i = 0; i < count; i++) {
+      TEST_ASSERT(popped[i].producer < PRODUCERS_NUM);
+      TEST_ASSERT_EQUAL_UINT32(next[popped[i].producer], popped[i].index);
+      next[popped[i].producer]++;
+    }
+    received += count;
+  }
+
+  for (uint32_t i = 0; i < PRODUCERS_NUM; i++) {
+    thread_handle_join(threads[i], NULL);
+    TEST_ASSERT_EQUAL_UINT32(ELEMENTS_NUM, next[i]);
+  }
+  TEST_ASSERT_EQUAL_INT(0, ring_buffer_size(&ring));
+  ring_buffer_destroy(&ring);
+}
+
+static void *wake_later(ring_buffer_t *const ring) {
+  sleep_ms(20);
+  ring_buffer_wake(ring);
+
+  return NULL;
+}
+
+void test_wait_wake(void) {
+  ring_buffer_t ring;
+  thread_handle_t thread;
+  element_t element = {.producer = 0, .index = 42};
+
+  TEST_ASSERT(ring_buffer_init(&ring, sizeof(element_t), 4, RING_BUFFER_MULTI_PRODUCER) == RC_OK);
+
+  // Doesn't sleep on a non empty ring
+  TEST_ASSERT(ring_buffer_push(&ring, &element) == RC_OK);
+  ring_buffer_wait(&ring);
+  TEST_ASSERT_EQUAL_INT(1, ring_buffer_pop(&ring, &element, 1));
+
+  // Woken without any element
+  thread_handle_create(&thread, (thread_routine_t)wake_later, &ring);
+  ring_buffer_wait(&ring);
+  thread_handle_join(thread, NULL);
+  TEST_ASSERT_EQUAL_INT(0, ring_buffer_size(&ring));
+
+  ring_buffer_destroy(&ring);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_init);
+  RUN_TEST(test_full_and_wrap);
+  RUN_TEST(test_reserve_commit);
+  RUN_TEST(test_consumed);
+  RUN_TEST(test_multi_producer);
+  RUN_TEST(test_wait_wake);
+
+  return UNITY_END();
+}
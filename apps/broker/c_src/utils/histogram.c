@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#ifdef _WIN32
+#include <intrin.h>
+#define CLZLL(x) __lzcnt64(x)
+#else
+#define CLZLL(x) __builtin_clzll(x)
+#endif
+
+#include "utils/histogram.h"
+
+// log2 of HISTOGRAM_SUB_BUCKETS
+#define HISTOGRAM_SUB_BITS 3
+
+/*
+ * Private functions
+ */
+
+static inline size_t bucket_of(uint64_t const value) {
+  unsigned msb = 0;
+
+  if (value < HISTOGRAM_EXACT_MAX) {
+    return value;
+  }
+  msb = 63 - CLZLL(value);
+
+  return HISTOGRAM_EXACT_MAX + (msb - 4) * HISTOGRAM_SUB_BUCKETS +
+         ((value >> (msb - HISTOGRAM_SUB_BITS)) & (HISTOGRAM_SUB_BUCKETS - 1));
+}
+
+static inline uint64_t bucket_upper_bound(size_t const bucket) {
+  unsigned msb = 0;
+  uint64_t sub = 0;
+
+  if (bucket < HISTOGRAM_EXACT_MAX) {
+    return bucket;
+  }
+  msb = (bucket - HISTOGRAM_EXACT_MAX) / HISTOGRAM_SUB_BUCKETS + 4;
+  sub = (bucket - HISTOGRAM_EXACT_MAX) % HISTOGRAM_SUB_BUCKETS;
+
+  return ((HISTOGRAM_SUB_BUCKETS + sub + 1) << (msb - HISTOGRAM_SUB_BITS)) - 1;
+}
+
+static inline void store_max(atomic_uint_fast64_t *const max, uint64_t const value) {
+  uint_fast64_t current = atomic_load_explicit(max, memory_order_relaxed);
+
+  while (value > current &&
+         !atomic_compare_exchange_weak_explicit(max, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+  }
+}
+
+/*
+ * Public functions
+ */
+
+void histogram_reset(histogram_t *const histogram) {
+  for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    atomic_init(&histogram->buckets[i], 0);
+  }
+  atomic_init(&histogram->count, 0);
+  atomic_init(&histogram->sum, 0);
+  atomic_init(&histogram->max, 0);
+}
+
+void histogram_record(histogram_t *const histogram, uint64_t const value) {
+  atomic_fetch_add_explicit(&histogram->buckets[bucket_of(value)], 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&histogram->sum, value, memory_order_relaxed);
+  store_max(&histogram->max, value);
+}
+
+void histogram_merge(histogram_t *const histogram, histogram_t const *const other) {
+  for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    atomic_fetch_add_explicit(&histogram->buckets[i], atomic_load_explicit(&other->buckets[i], memory_order_relaxed),
+                              memory_order_relaxed);
+  }
+  atomic_fetch_add_explicit(&histogram->count, histogram_count(other), memory_order_relaxed);
+  atomic_fetch_add_explicit(&histogram->sum, atomic_load_explicit(&other->sum, memory_order_relaxed),
+                            memory_order_relaxed);
+  store_max(&histogram->max, histogram_max(other));
+}
+
+uint64_t histogram_percentile(histogram_t const *const histogram, double const percentile) {
+  uint64_t const count = histogram_count(histogram);
+  uint64_t const max = histogram_max(histogram);
+  uint64_t rank = 0, seen = 0, bound = 0;
+
+  if (count == 0) {
+    return 0;
+  }
+
+  // Rank of the value in [1, count]
+  rank = (uint64_t)(percentile / 100.0 * count + 0.5);
+  rank = rank == 0 ? 1 : (rank > count ? count : rank);
+  for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+    if ((seen += atomic_load_explicit(&histogram->buckets[i], memory_order_relaxed)) >= rank) {
+      bound = bucket_upper_bound(i);
+      return bound < max ? bound : max;
+    }
+  }
+
+  // Buckets updated while reading
+  return max;
+}
+
+double histogram_mean(histogram_t const *const histogram) {
+  uint64_t const count = histogram_count(histogram);
+
+  return count == 0 ? 0 : (double)atomic_load_explicit(&histogram->sum, memory_order_relaxed) / count;
+}
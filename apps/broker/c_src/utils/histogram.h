@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+/**
+ * @ingroup utils
+ *
+ * @{
+ *
+ * @file
+ * @brief A fixed size log-linear histogram of integer values, e.g. latencies in microseconds.
+ *
+ * Values below HISTOGRAM_EXACT_MAX have their own bucket, larger ones share a power of 2 between
+ * HISTOGRAM_SUB_BUCKETS buckets, so that percentiles are off by less than 12.5% whatever the magnitude. Recording is
+ * wait-free: counters are relaxed atomics meant for a single writer, any thread may read them.
+ */
+#ifndef __UTILS_HISTOGRAM_H__
+#define __UTILS_HISTOGRAM_H__
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HISTOGRAM_EXACT_MAX 16
+#define HISTOGRAM_SUB_BUCKETS 8
+#define HISTOGRAM_BUCKETS (HISTOGRAM_EXACT_MAX + (64 - 4) * HISTOGRAM_SUB_BUCKETS)
+
+typedef struct histogram_s {
+  atomic_uint_fast64_t buckets[HISTOGRAM_BUCKETS];
+  atomic_uint_fast64_t count;
+  atomic_uint_fast64_t sum;
+  atomic_uint_fast64_t max;
+} histogram_t;
+
+/**
+ * @brief Empties a histogram.
+ *
+ * @param[out] histogram The histogram.
+ */
+void histogram_reset(histogram_t *const histogram);
+
+/**
+ * @brief Counts a value in a histogram.
+ *
+ * @param[in, out] histogram The histogram.
+ * @param[in] value The value.
+ */
+void histogram_record(histogram_t *const histogram, uint64_t const value);
+
+/**
+ * @brief Adds the values of a histogram to another one, e.g. to aggregate per thread histograms.
+ *
+ * @param[in, out] histogram The histogram added to.
+ * @param[in] other The histogram added.
+ */
+void histogram_merge(histogram_t *const histogram, histogram_t const *const other);
+
+/**
+ * @brief Gives a percentile of the values of a histogram, as the upper bound of its bucket.
+ *
+ * @param[in] histogram The histogram.
+ * @param[in] percentile The percentile, in [0, 100].
+ * @return The value, 0 for an empty histogram.
+ */
+uint64_t histogram_percentile(histogram_t const *const histogram, double const percentile);
+
+/**
+ * @brief Gives the mean of the values of a histogram.
+ *
+ * @param[in] histogram The histogram.
+ * @return The mean, 0 for an empty histogram.
+ */
+double histogram_mean(histogram_t const *const histogram);
+
+static inline uint64_t histogram_count(histogram_t const *const histogram) {
+  return atomic_load_explicit(&histogram->count, memory_order_relaxed);
+}
+
+static inline uint64_t histogram_max(histogram_t const *const histogram) {
+  return atomic_load_explicit(&histogram->max, memory_order_relaxed);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // __UTILS_HISTOGRAM_H__
+
+/** @} */
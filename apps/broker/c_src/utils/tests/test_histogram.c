@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019 IOTA Stiftung
+ * https://github.com/iotaledger/entangled
+ *
+ * Refer to the LICENSE file for licensing information
+ */
+
+#include <unity/unity.h>
+
+#include "utils/histogram.h"
+
+static histogram_t histogram;
+
+void setUp(void) { histogram_reset(&histogram); }
+
+void tearDown(void) {}
+
+void test_empty(void) {
+  TEST_ASSERT_EQUAL_UINT64(0, histogram_count(&histogram));
+  TEST_ASSERT_EQUAL_UINT64(0, histogram_percentile(&histogram, 50));
+  TEST_ASSERT_EQUAL_UINT64(0, histogram_max(&histogram));
+  TEST_ASSERT_EQUAL_DOUBLE(0, histogram_mean(&histogram));
+}
+
+void test_exact_values(void) {
+  for (uint64_t i = 1; i <= 10; i++) {
+    histogram_record(&histogram, i);
+  }
+
+  TEST_ASSERT_EQUAL_UINT64(10, histogram_count(&histogram));
+  TEST_ASSERT_EQUAL_UINT64(1, histogram_percentile(&histogram, 0));
+  TEST_ASSERT_EQUAL_UINT64(5, histogram_percentile(&histogram, 50));
+  TEST_ASSERT_EQUAL_UINT64(9, histogram_percentile(&histogram, 90));
+  TEST_ASSERT_EQUAL_UINT64(10, histogram_percentile(&histogram, 100));
+  TEST_ASSERT_EQUAL_UINT64(10, histogram_max(&histogram));
+  TEST_ASSERT_EQUAL_DOUBLE(5.5, histogram_mean(&histogram));
+}
+
+void test_relative_error(void) {
+  uint64_t percentile = 0;
+
+  for (uint64_t value = 1; value < (1ULL << 40); value = value * 3 + 1) {
+    histogram_reset(&histogram);
+    histogram_record(&histogram, value);
+    histogram_record(&histogram, UINT64_MAX);
+
+    percentile = histogram_percentile(&histogram, 50);
+    TEST_ASSERT(percentile >= value);
+    TEST_ASSERT(percentile - value <= value / 8);
+  }
+  TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, histogram_percentile(&histogram, 100));
+}
+
+void test_merge(void) {
+  histogram_t other;
+
+  histogram_reset(&other);
+  for (uint64_t i = 0; i < 99; i++) {
+    histogram_record(&histogram, 100);
+  }
+  histogram_record(&other, 100000);
+
+  histogram_merge(&histogram, &other);
+  TEST_ASSERT_EQUAL_UINT64(100, histogram_count(&histogram));
+  TEST_ASSERT_EQUAL_UINT64(100000, histogram_max(&histogram));
+  TEST_ASSERT(histogram_percentile(&histogram, 99) <= 100 + 100 / 8);
+  TEST_ASSERT_EQUAL_UINT64(100000, histogram_percentile(&histogram, 100));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+
+  RUN_TEST(test_empty);
+  RUN_TEST(test_exact_values);
+  RUN_TEST(test_relative_error);
+  RUN_TEST(test_merge);
+
+  return UNITY_END();
+}
@@ -36,6 +36,28 @@ uint64_t current_timestamp_ms() {
 #endif
 }
 
+uint64_t monotonic_timestamp_us() {
+#ifdef _WIN32
+  LARGE_INTEGER counter, frequency;
+
+  QueryPerformanceCounter(&counter);
+  QueryPerformanceFrequency(&frequency);
+
+  return counter.QuadPart / frequency.QuadPart * 1000000ULL +
+         counter.QuadPart % frequency.QuadPart * 1000000ULL / frequency.QuadPart;
+#elif _POSIX_C_SOURCE >= 199309L
+  struct timespec ts = {0, 0};
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000ULL;
+#else
+  struct timeval tv = {0, 0};
+
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec * 1000000ULL + tv.tv_usec;
+#endif
+}
+
 void sleep_ms(uint64_t milliseconds) {
 #ifdef _WIN32
   Sleep(milliseconds);
@@ -48,3 +70,16 @@ void sleep_ms(uint64_t milliseconds) {
   usleep(milliseconds * 1000);
 #endif
 }
+
+void sleep_us(uint64_t microseconds) {
+#ifdef _WIN32
+  Sleep((microseconds + 999) / 1000);
+#elif _POSIX_C_SOURCE >= 199309L
+  struct timespec ts;
+  ts.tv_sec = microseconds / 1000000;
+  ts.tv_nsec = (microseconds % 1000000) * 1000;
+  nanosleep(&ts, NULL);
+#else
+  usleep(microseconds);
+#endif
+}
@@ -15,7 +15,10 @@ extern "C" {
 #endif
 
 uint64_t current_timestamp_ms();
+// Microseconds from an arbitrary point, not affected by changes of the system time
+uint64_t monotonic_timestamp_us();
 void sleep_ms(uint64_t milliseconds);
+void sleep_us(uint64_t microseconds);
 
 #ifdef __cplusplus
 }
@@ -26,6 +26,12 @@ config :broker,
   __RETERIES_RECOLLECTOR__: 5, # recollector will attempt to query transaction from backup_nodes up to,
   __MAX_TIME_RECOLLECTOR__: 5.5, # curl's max_time param in seconds each getTrytes retry will get this max_time.
   __MAX_DEMAND__: 64,
+  # scheduling policy of the hashing/bundle nifs:
+  # :normal(normal schedulers), :dirty(dirty cpu schedulers), :yield(timeslice-aware rescheduling)
+  __NIF_SCHEDULING__: :dirty,
+  # native threads validating the bundles signatures, shared by all the bundle validators
+  # (nil => one per online scheduler)
+  __NIF_BUNDLE_THREADS__: nil,
   __TX_TTL__: 10000, # Time to live ms (10 seconds)
   __BUNDLE_TTL__: 10000, # ms (10 seconds)
   __TRANSACTION_PARTITIONS_PER_TOPIC__: 2, # concurrent transactions validators/collector per topic(tx_trytes, sn_trytes)
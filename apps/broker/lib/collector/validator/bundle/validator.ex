@@ -21,26 +21,21 @@ defmodule Broker.Collector.BundleValidator do
     {:noreply, [], state}
   end
 
-  defp process_bundles([bundle | rest]) do
-    process_bundle(bundle)
-    process_bundles(rest)
-  end
-
-  defp process_bundles([]) do
-    :ok
-  end
-
-  defp process_bundle(bundle) do
+  defp process_bundles(bundles) do
+    # order the txs of each bundle by current_index
+    reversed_bundles = Enum.map(bundles, &Enum.reverse/1)
     # create bundle_trytes from :trytes key inside each tx in bundle
-    reversed_bundle = Enum.reverse(bundle)
-    bundle_trytes =
-      for %{trytes: trytes} <- reversed_bundle, into: "", do: trytes
-    # bundle length
-    bundle_length = length(bundle)
-    if Nifs.validate_bundle(bundle_length, bundle_trytes) do
+    bundles_trytes =
+      for bundle <- reversed_bundles do
+        for %{trytes: trytes} <- bundle, into: "", do: trytes
+      end
+    # validate all the bundles in one go, their signatures are checked in parallel
+    statuses = Nifs.validate_bundles(bundles_trytes)
+    for {bundle, true} <- Enum.zip(reversed_bundles, statuses) do
       # insert bundle by spawn genserver inserter
-      Inserter.start_link(reversed_bundle)
+      Inserter.start_link(bundle)
     end
+    :ok
   end
 
   # generate the validator name by topic name
@@ -1,8 +1,13 @@
 defmodule Nifs do
   @on_load :init
 
+  # scheduling policy of the cpu heavy nifs (:normal | :dirty | :yield)
+  # and number of native threads validating the bundles signatures
   def init do
-    :ok = :erlang.load_nif(Application.app_dir(:broker) <> "/priv/nifs", 0)
+    scheduling = Application.get_env(:broker, :__NIF_SCHEDULING__) || :dirty
+    bundle_threads = Application.get_env(:broker, :__NIF_BUNDLE_THREADS__) || System.schedulers_online()
+    load_info = %{scheduling: scheduling, bundle_threads: bundle_threads}
+    :ok = :erlang.load_nif(Application.app_dir(:broker) <> "/priv/nifs", load_info)
   end
 
   def curl_p_init() do
@@ -23,8 +28,47 @@ defmodule Nifs do
   def get_status(_,_,_) do
     exit(:nif_library_not_loaded)
   end
+  def hash_and_verify(_,_) do
+    exit(:nif_library_not_loaded)
+  end
   def validate_bundle(_,_) do
     exit(:nif_library_not_loaded)
   end
+  def validate_bundles(_) do
+    exit(:nif_library_not_loaded)
+  end
+  # counters of the native per thread contexts and pooled resource states:
+  # %{contexts, context_calls, context_bytes, bundle_scratch_grows,
+  #   curl_states, curl_in_use, curl_reuses,
+  #   hash_job_states, hash_job_in_use, hash_job_reuses}
+  def context_stats() do
+    exit(:nif_library_not_loaded)
+  end
+  # decodes 2673 tx trytes into the tuple of its fields, in serialized order:
+  # {signature, address, value, obsolete_tag, timestamp, current_index, last_index,
+  #  bundle, trunk, branch, tag, atime, alower, aupper, nonce}
+  # value is nil when it doesn't fit an int64 (malformed tx)
+  def decode_transaction(_) do
+    exit(:nif_library_not_loaded)
+  end
+  # list form of decode_transaction/1
+  def decode_transactions(_) do
+    exit(:nif_library_not_loaded)
+  end
+  # maps a historical dmp file: {:ok, reader} | {:error, retcode}
+  def dmp_open(_) do
+    exit(:nif_library_not_loaded)
+  end
+  # takes the next chunk of whole bundles from the reader, starting a new chunk from
+  # max_txs transactions on: {chunk, txs_count} | :eof | {:error, retcode}
+  def dmp_next(_,_) do
+    exit(:nif_library_not_loaded)
+  end
+  # parses a chunk and verifies the hashes of its transactions, by bundle:
+  # [{valid?, [{hash, trytes, fields, snapshot_index}]}]
+  # fields as decode_transaction/1, snapshot_index is nil when the lines have none
+  def dmp_decode(_) do
+    exit(:nif_library_not_loaded)
+  end
 
 end
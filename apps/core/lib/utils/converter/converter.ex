@@ -1,7 +1,8 @@
 defmodule Core.Utils.Converter do
 
   @moduledoc """
-    Pure elixir trytes/trits/integer converter.
+    Trytes/trits/integer converter, the transactions fields are decoded
+    by the broker codec nif when it's loaded and in pure elixir otherwise.
   """
   alias Core.Utils.Struct.Transaction
 
@@ -99,27 +100,86 @@ defmodule Core.Utils.Converter do
     acc
   end
 
+  @doc """
+    decode the 2673 trytes of a transaction into the tuple of its fields, in serialized order:
+    {signature, address, value, obsolete_tag, timestamp, current_index, last_index,
+    bundle_hash, trunk, branch, tag, atime, alower, aupper, nonce}.
+    the broker codec nif decodes them in one call when it's loaded, otherwise
+    they are decoded in pure elixir.
+  """
+  @spec decode_trytes(binary) :: tuple
+  def decode_trytes(trytes) do
+    if codec?() do
+      apply(Nifs, :decode_transaction, [trytes])
+      |> exact_value(trytes)
+    else
+      elixir_decode_trytes(trytes)
+    end
+  end
+
+  @doc """
+    batch form of decode_trytes/1, one nif call for the whole list.
+  """
+  @spec decode_trytes_list(list) :: list
+  def decode_trytes_list(trytes_list) do
+    if codec?() do
+      apply(Nifs, :decode_transactions, [trytes_list])
+      |> exact_values(trytes_list, [])
+    else
+      Enum.map(trytes_list, &elixir_decode_trytes/1)
+    end
+  end
+
+  # the codec nif is part of the broker app, it's used only when it got loaded.
+  defp codec?() do
+    Code.ensure_loaded?(Nifs) and function_exported?(Nifs, :decode_transaction, 1)
+  end
+
+  # the nif returns a nil value when it doesn't fit an int64 (malformed tx),
+  # so we decode it as arbitrary precision integer like elixir_decode_trytes/1.
+  defp exact_value(fields, trytes) do
+    case elem(fields, 2) do
+      nil ->
+        <<_::2268-bytes, value::27-bytes, _::binary>> = trytes
+        put_elem(fields, 2, trytes_to_integer(value))
+      _ ->
+        fields
+    end
+  end
+
+  defp exact_values([fields | rest], [trytes | trytes_list], acc) do
+    exact_values(rest, trytes_list, [exact_value(fields, trytes) | acc])
+  end
+
+  defp exact_values([], [], acc) do
+    Enum.reverse(acc)
+  end
+
+  defp elixir_decode_trytes(trytes) do
+    <<signature::2187-bytes,address::81-bytes,value::27-bytes,
+    obsolete_tag::27-bytes,timestamp::9-bytes,current_index::9-bytes,
+    last_index::9-bytes,bundle_hash::81-bytes, trunk::81-bytes,
+    branch::81-bytes,tag::27-bytes, atime::9-bytes, alower::9-bytes,
+    aupper::9-bytes, nonce::27-bytes>> = trytes
+    {signature, address, trytes_to_integer(value), obsolete_tag,
+      trytes_to_integer(timestamp), trytes_to_integer(current_index),
+      trytes_to_integer(last_index), bundle_hash, trunk, branch, tag,
+      trytes_to_integer(atime), trytes_to_integer(alower),
+      trytes_to_integer(aupper), nonce}
+  end
+
   @doc """
     convert dmp file line to tx_object.
   """
   @spec line_to_tx_object(binary) :: Transaction.t
   def line_to_tx_object(line) do
     # pattern matching
-    <<hash::81-bytes,_,signature::2187-bytes,address::81-bytes,value::27-bytes,
-    obsolete_tag::27-bytes,timestamp::9-bytes,current_index::9-bytes,
-    last_index::9-bytes,bundle_hash::81-bytes, trunk::81-bytes,
-    branch::81-bytes,tag::27-bytes, atime::9-bytes, alower::9-bytes,
-    aupper::9-bytes, nonce::27-bytes,_,snapshot_index::binary>> = line
-    # - First we convert some columns to varinteger form.
-    last_index = trytes_to_integer(last_index)
-    current_index = trytes_to_integer(current_index)
-    value = trytes_to_integer(value)
-    timestamp = trytes_to_integer(timestamp)
-    atime = trytes_to_integer(atime)
-    alower = trytes_to_integer(alower)
-    aupper = trytes_to_integer(aupper)
+    <<hash::81-bytes,_,trytes::2673-bytes,_,snapshot_index::binary>> = line
     snapshot_index = String.to_integer(String.trim(snapshot_index, "\n"))
-    # - Put transaction line in map.
+    # - Decode the fields and put transaction line in map.
+    {signature, address, value, obsolete_tag, timestamp, current_index,
+      last_index, bundle_hash, trunk, branch, tag, atime, alower, aupper,
+      nonce} = decode_trytes(trytes)
     Transaction.create(signature, address,value, obsolete_tag,timestamp,
       current_index,last_index,bundle_hash,trunk,branch,tag,atime,
       alower,aupper,nonce,hash,snapshot_index)
@@ -131,19 +191,8 @@ defmodule Core.Utils.Converter do
   @spec line_81_to_tx_object(binary,binary) :: Transaction.t
   def line_81_to_tx_object(line,snapshot_index) do
     # pattern matching
-    <<hash::81-bytes,_,signature::2187-bytes,address::81-bytes,value::27-bytes,
-    obsolete_tag::27-bytes,timestamp::9-bytes,current_index::9-bytes,
-    last_index::9-bytes,bundle_hash::81-bytes, trunk::81-bytes,
-    branch::81-bytes, nonce::81-bytes,_>> = line
-    # - First we convert some columns to varinteger form.
-    last_index = trytes_to_integer(last_index)
-    current_index = trytes_to_integer(current_index)
-    value = trytes_to_integer(value)
-    timestamp = trytes_to_integer(timestamp)
-    # - Put transaction line in map.
-    Transaction.create(signature, address,value, obsolete_tag,timestamp,
-      current_index,last_index,bundle_hash,trunk,branch,nil,nil,
-      nil,nil,nonce,hash,snapshot_index)
+    <<hash::81-bytes,_,trytes::2673-bytes,_>> = line
+    line_81_trytes_to_tx_object(hash, trytes, snapshot_index)
   end
 
   @doc """
@@ -152,40 +201,69 @@ defmodule Core.Utils.Converter do
   @spec line_81_to_tx_object(binary) :: Transaction.t
   def line_81_to_tx_object(line) do
     # pattern matching
-    <<hash::81-bytes,_,signature::2187-bytes,address::81-bytes,value::27-bytes,
-    obsolete_tag::27-bytes,timestamp::9-bytes,current_index::9-bytes,
-    last_index::9-bytes,bundle_hash::81-bytes, trunk::81-bytes,
-    branch::81-bytes, nonce::81-bytes,_,snapshot_index::binary>> = line
-    # - First we convert some columns to varinteger form.
-    last_index = trytes_to_integer(last_index)
-    current_index = trytes_to_integer(current_index)
-    value = trytes_to_integer(value)
-    timestamp = trytes_to_integer(timestamp)
+    <<hash::81-bytes,_,trytes::2673-bytes,_,snapshot_index::binary>> = line
     snapshot_index = String.to_integer(String.trim(snapshot_index, "\n"))
-    # - Put transaction line in map.
+    line_81_trytes_to_tx_object(hash, trytes, snapshot_index)
+  end
+
+  defp line_81_trytes_to_tx_object(hash, trytes, snapshot_index) do
+    line_81_fields_to_tx_object(decode_trytes(trytes), hash, trytes, snapshot_index)
+  end
+
+  # the 81-trytes nonce takes the place of tag, attachment timestamps and nonce,
+  # so only the fields before it are used.
+  defp line_81_fields_to_tx_object(fields, hash, trytes, snapshot_index) do
+    {signature, address, value, obsolete_tag, timestamp, current_index,
+      last_index, bundle_hash, trunk, branch, _, _, _, _, _} = fields
+    <<_::2592-bytes, nonce::81-bytes>> = trytes
     Transaction.create(signature, address,value, obsolete_tag,timestamp,
       current_index,last_index,bundle_hash,trunk,branch,nil,nil,
       nil,nil,nonce,hash,snapshot_index)
   end
 
+  @doc """
+    convert a row {hash, trytes, fields, snapshot_index} of the native dmp
+    importer (Nifs.dmp_decode/1) to tx_object, the nonce is 27 or 81 trytes.
+  """
+  @spec dmp_row_to_tx_object(tuple, 27 | 81) :: Transaction.t
+  def dmp_row_to_tx_object({hash, trytes, fields, snapshot_index}, 27) do
+    {signature, address, value, obsolete_tag, timestamp, current_index,
+      last_index, bundle_hash, trunk, branch, tag, atime, alower, aupper,
+      nonce} = exact_value(fields, trytes)
+    Transaction.create(signature, address,value, obsolete_tag,timestamp,
+      current_index,last_index,bundle_hash,trunk,branch,tag,atime,
+      alower,aupper,nonce,hash,snapshot_index)
+  end
+
+  def dmp_row_to_tx_object({hash, trytes, fields, snapshot_index}, 81) do
+    line_81_fields_to_tx_object(exact_value(fields, trytes), hash, trytes, snapshot_index)
+  end
+
   @doc """
     Convert trytes to tx-object
   """
   @spec trytes_to_tx_object(binary, binary, integer) :: Transaction.t
   def trytes_to_tx_object(hash, trytes, snapshot_index) do
-    <<signature::2187-bytes,address::81-bytes,value::27-bytes,
-    obsolete_tag::27-bytes,timestamp::9-bytes,current_index::9-bytes,
-    last_index::9-bytes,bundle_hash::81-bytes, trunk::81-bytes,
-    branch::81-bytes,tag::27-bytes, atime::9-bytes, alower::9-bytes,
-    aupper::9-bytes, nonce::27-bytes>> = trytes
-    # - First we convert some columns to varinteger form.
-    last_index = trytes_to_integer(last_index)
-    current_index = trytes_to_integer(current_index)
-    value = trytes_to_integer(value)
-    timestamp = trytes_to_integer(timestamp)
-    atime = trytes_to_integer(atime)
-    alower = trytes_to_integer(alower)
-    aupper = trytes_to_integer(aupper)
+    fields_to_tx_object(decode_trytes(trytes), hash, trytes, snapshot_index)
+  end
+
+  @doc """
+    Convert a list of {hash, trytes} to tx-objects, decoded in one batch.
+  """
+  @spec trytes_to_tx_objects(list, integer) :: list
+  def trytes_to_tx_objects(hashes_trytes, snapshot_index) do
+    trytes_list = for {_, trytes} <- hashes_trytes, do: trytes
+    decode_trytes_list(trytes_list)
+    |> Enum.zip(hashes_trytes)
+    |> Enum.map(fn {fields, {hash, trytes}} ->
+      fields_to_tx_object(fields, hash, trytes, snapshot_index)
+    end)
+  end
+
+  defp fields_to_tx_object(fields, hash, trytes, snapshot_index) do
+    {signature, address, value, obsolete_tag, timestamp, current_index,
+      last_index, bundle_hash, trunk, branch, tag, atime, alower, aupper,
+      nonce} = fields
     # - Put transaction line in map.
     Transaction.create(signature, address,value, obsolete_tag,timestamp,
       current_index,last_index,bundle_hash,trunk,branch,tag,atime,
@@ -5,21 +5,30 @@ defmodule Core.Utils.Importer do
   alias Core.Utils.Converter
   alias Core.Utils.Importer.{Worker27,Worker81}
   @max Application.get_env(:core, :max_import_concurrent) || 1000
+  @start_delay Application.get_env(:core, :import_start_delay) || 60000
+  # transactions per chunk of the native importer
+  @chunk_txs Application.get_env(:core, :import_chunk_txs) || 2048
 
   def start_link(_args) do
-    Logger.info("the importer will start after 1 minute")
-    GenServer.start_link(__MODULE__,%{dmps: [], max: @max, pending: 0, total: 0},name: :importer)
+    Logger.info("the importer will start after #{div(@start_delay, 1000)} seconds")
+    GenServer.start_link(__MODULE__,%{dmps: [], max: @max, pending: 0, total: 0, decoding: 0},name: :importer)
   end
 
   def init(state) do
-    Process.sleep(60000)
+    # the delay doesn't block the supervisor anymore
+    Process.send_after(self(), :start, @start_delay)
+    # number of chunks decoded concurrently by the native importer
+    decoders = Application.get_env(:core, :import_decoders) || System.schedulers_online()
+    {:ok, Map.put(state, :decoders, decoders)}
+  end
+
+  def handle_info(:start, state) do
     dmps = File.read!("./historical/dmps.txt")
     |> String.split("\n", trim: true)
-    Logger.info("Importer started")
+    Logger.info("Importer started#{if native?(), do: " (native)", else: ""}")
     Process.send_after(self(), :monitor, 300000)
     send(self(), :import)
-    state = Map.put(state, :dmps, dmps)
-    {:ok, state}
+    {:noreply, Map.put(state, :dmps, dmps)}
   end
 
   def handle_info(:ready?, state) do
@@ -92,6 +101,27 @@ defmodule Core.Utils.Importer do
     {:noreply, state}
   end
 
+  def handle_info({:fetch_native_27, _}, state) do
+    {:noreply, fetch_native(:fetch_native_27, state)}
+  end
+
+  def handle_info({:fetch_native_81, _}, state) do
+    {:noreply, fetch_native(:fetch_native_81, state)}
+  end
+
+  def handle_info({:decoded, nonce, result}, %{pending: pending, decoding: decoding} = state) do
+    bundles =
+      case result do
+        {:ok, bundles} ->
+          process_native_bundles(bundles, nonce)
+        {:error, reason} ->
+          Logger.error("Failed to decode a chunk of #{hd(state[:dmps])}.dmp: #{inspect reason}")
+          0
+      end
+    state = process_more?(%{state | pending: pending+bundles, decoding: decoding-1})
+    {:noreply, state}
+  end
+
   def handle_info(:monitor, %{total: t, dmps: []}= state) do
     Logger.info("Done: total #{t} bundles")
     {:noreply, state}
@@ -116,9 +146,23 @@ defmodule Core.Utils.Importer do
     Map.put(Map.put(state, :file, bundles), :current?, :fetch_bundle_81_from_list)
   end
 
+  # process the ordered and vaild dmps with the native importer (broker nifs),
+  # it maps the dmp and parses/verifies chunks of bundles on dirty schedulers.
+  defp import_dmp(snapshot_index,state) do
+    if native?() do
+      Logger.info("Importing #{snapshot_index} file")
+      path = "./historical/data/#{snapshot_index}.dmp"
+      {:ok, reader} = apply(Nifs, :dmp_open, [path])
+      current? = if snapshot_index < 242662, do: :fetch_native_81, else: :fetch_native_27
+      Map.put(Map.put(state, :file, reader), :current?, current?)
+    else
+      import_dmp_stream(snapshot_index,state)
+    end
+  end
+
   # process the ordered and vaild dmps.
   # note: the nonce is 81-trytes version
-  defp import_dmp(snapshot_index,state) when snapshot_index < 242662 do
+  defp import_dmp_stream(snapshot_index,state) when snapshot_index < 242662 do
     # process the file now
     Logger.info("Importing #{snapshot_index} file")
     # first we open the dmp
@@ -128,7 +172,7 @@ defmodule Core.Utils.Importer do
 
   # process the ordered and vaild dmps.
   # note: the nonce is 27-trytes version
-  defp import_dmp(snapshot_index,state) when snapshot_index >= 242662 do
+  defp import_dmp_stream(snapshot_index,state) when snapshot_index >= 242662 do
     # process the file now
     Logger.info("Importing #{snapshot_index} file")
     # first we open the dmp
@@ -203,8 +247,8 @@ defmodule Core.Utils.Importer do
     end
   end
 
-  def process_more?(%{pending: pending, current?: true} = state) do
-    if pending != 0 do
+  def process_more?(%{pending: pending, decoding: decoding, current?: true} = state) do
+    if pending != 0 or decoding != 0 do
       # we still have more pending bundles, so we should wait and return state
       state
     else
@@ -223,7 +267,8 @@ defmodule Core.Utils.Importer do
   end
 
   def process_dmp?(%{dmps: [dmp | rest] = dmps} = state) when length(dmps) > 1 do
-    if String.to_integer(dmp) > 18675 do
+    # the native reader is unmapped once garbage collected
+    if String.to_integer(dmp) > 18675 and is_pid(state[:file]) do
       File.close(state[:file])
     end
     Logger.info("Imported #{dmp}")
@@ -249,4 +294,55 @@ defmodule Core.Utils.Importer do
   def process_bundle_81(bundle) do
     Worker81.start_link(Enum.reverse(bundle))
   end
+
+  # the native importer is part of the broker app, it's used only when it got loaded.
+  defp native?() do
+    Code.ensure_loaded?(Nifs) and function_exported?(Nifs, :dmp_open, 1)
+  end
+
+  # takes the next chunk of the dmp while the decoders and the bundles window
+  # allow it, and decodes it in a task. it's called again after each chunk is
+  # taken, decoded and whenever a bundle is inserted.
+  defp fetch_native(current?, %{current?: current?, file: reader, max: max, pending: pending,
+    decoding: decoding, decoders: decoders} = state) when decoding < decoders and pending < max do
+    case apply(Nifs, :dmp_next, [reader, @chunk_txs]) do
+      {chunk, _txs_count} ->
+        importer = self()
+        nonce = if current? == :fetch_native_81, do: 81, else: 27
+        Task.start(fn ->
+          result =
+            try do
+              {:ok, apply(Nifs, :dmp_decode, [chunk])}
+            rescue
+              e -> {:error, e}
+            end
+          send(importer, {:decoded, nonce, result})
+        end)
+        send(self(), {current?, false})
+        %{state | decoding: decoding+1}
+      :eof ->
+        process_more?(%{state | current?: true})
+      {:error, retcode} ->
+        Logger.error("Failed to read #{hd(state[:dmps])}.dmp, retcode: #{retcode}")
+        process_more?(%{state | current?: true})
+    end
+  end
+
+  defp fetch_native(_, state) do
+    state
+  end
+
+  # starts a worker per bundle, the bundles with invalid transaction hashes are
+  # skipped. returns the number of started workers.
+  defp process_native_bundles(bundles, nonce) do
+    Enum.reduce(bundles, 0, fn
+      {true, rows}, acc ->
+        bundle = Enum.map(rows, &Converter.dmp_row_to_tx_object(&1, nonce))
+        if nonce == 27, do: Worker27.start_link(bundle), else: Worker81.start_link(bundle)
+        acc+1
+      {false, [{hash, _, _, _} | _]}, acc ->
+        Logger.warn("Skipped a bundle with invalid transaction hashes, first tx: #{hash}")
+        acc
+    end)
+  end
 end